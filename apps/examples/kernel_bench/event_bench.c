@@ -0,0 +1,227 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Event notification benchmark
+ *
+ * The benchmark notifies a thread of higher priority EVENT_NWAKES times,
+ * which wakes up at once and waits again before the next notification:
+ *
+ * - signal: pthread_kill() of a signal the thread takes by sigwaitinfo().
+ *   Each one takes a pending signal structure and goes through the
+ *   signal dispatch.
+ * - eventfd: eventfd_write() of a flag the thread waits for by
+ *   eventfd_read(), which only sets the flag and posts a semaphore.
+ * - poll: the same, but the thread waits by poll() first, as a loop
+ *   watching other descriptors too does.
+ *
+ * Each result is the time of a notification, the switch to the thread,
+ * its wait and the switch back.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <unistd.h>
+#include <signal.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+
+#include "kernel_bench.h"
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+#define EVENT_NWAKES 2000
+#define EVENT_SIGNO  SIGUSR2
+#define EVENT_FLAG   (1 << 0)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum event_method_e {
+	EVENT_SIGNAL,
+	EVENT_EVENTFD,
+#ifndef CONFIG_DISABLE_POLL
+	EVENT_POLL,
+#endif
+	EVENT_NMETHODS
+};
+
+struct event_bench_s {
+	enum event_method_e method;
+	int fd;
+	int errors;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const char *g_event_names[EVENT_NMETHODS] = {
+	"signal",
+	"eventfd",
+#ifndef CONFIG_DISABLE_POLL
+	"poll",
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static FAR void *event_waiter(FAR void *arg)
+{
+	FAR struct event_bench_s *bench = (FAR struct event_bench_s *)arg;
+	struct siginfo info;
+#ifndef CONFIG_DISABLE_POLL
+	struct pollfd fds;
+#endif
+	eventfd_t value;
+	sigset_t set;
+	int i;
+
+	/* The signal is only taken by sigwaitinfo() */
+
+	sigemptyset(&set);
+	sigaddset(&set, EVENT_SIGNO);
+	pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+	for (i = 0; i < EVENT_NWAKES; i++) {
+		switch (bench->method) {
+		case EVENT_SIGNAL:
+			if (sigwaitinfo(&set, &info) != EVENT_SIGNO) {
+				bench->errors++;
+			}
+			break;
+
+#ifndef CONFIG_DISABLE_POLL
+		case EVENT_POLL:
+			fds.fd = bench->fd;
+			fds.events = POLLIN;
+			fds.revents = 0;
+			if (poll(&fds, 1, -1) != 1) {
+				bench->errors++;
+			}
+			/* Then read the flags */
+#endif
+
+		case EVENT_EVENTFD:
+			if (eventfd_read(bench->fd, &value) != OK || value != EVENT_FLAG) {
+				bench->errors++;
+			}
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+/* Return the ns per notification, or 0 on a failure */
+
+static unsigned long event_run(enum event_method_e method)
+{
+	struct event_bench_s bench;
+	pthread_t waiter;
+	unsigned long start;
+	unsigned long elapsed;
+	int i;
+
+	bench.method = method;
+	bench.errors = 0;
+	bench.fd = -1;
+
+	if (method != EVENT_SIGNAL) {
+		bench.fd = eventfd(0, 0);
+		if (bench.fd < 0) {
+			printf("eventfd failed\n");
+			return 0;
+		}
+	}
+
+	/* The waiter runs until it waits, before each notification */
+
+	if (kbench_thread(&waiter, KBENCH_PRIO_HIGH + 1, event_waiter, &bench) != 0) {
+		if (bench.fd >= 0) {
+			close(bench.fd);
+		}
+		return 0;
+	}
+
+	start = kbench_usec();
+	for (i = 0; i < EVENT_NWAKES; i++) {
+		if (method == EVENT_SIGNAL) {
+			if (pthread_kill(waiter, EVENT_SIGNO) != 0) {
+				bench.errors++;
+			}
+		} else if (eventfd_write(bench.fd, EVENT_FLAG) != OK) {
+			bench.errors++;
+		}
+	}
+	elapsed = kbench_usec() - start;
+
+	if (bench.errors) {
+		/* The waiter may wait for notifications which never come */
+
+		pthread_cancel(waiter);
+	}
+	pthread_join(waiter, NULL);
+
+	if (bench.fd >= 0) {
+		close(bench.fd);
+	}
+
+	if (bench.errors) {
+		printf("%s: %d errors\n", g_event_names[method], bench.errors);
+		return 0;
+	}
+	return (unsigned long)((unsigned long long)elapsed * 1000 / EVENT_NWAKES);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int kbench_event(void)
+{
+	unsigned long ns;
+	int method;
+
+	printf("%d notifications of a thread waiting, ns per notification:\n", EVENT_NWAKES);
+	printf("%10s %10s\n", "", "wake_ns");
+
+	for (method = 0; method < EVENT_NMETHODS; method++) {
+		ns = event_run((enum event_method_e)method);
+		if (ns == 0) {
+			return -1;
+		}
+		printf("%10s %10lu\n", g_event_names[method], ns);
+	}
+
+	return 0;
+}
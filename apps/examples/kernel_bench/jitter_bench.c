@@ -0,0 +1,202 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Timer jitter benchmark
+ *
+ * How late the benchmark wakes up for a time which isn't a whole number of
+ * ticks:
+ *
+ * - nanosleep: a sleep of JITTER_PERIOD, measured from before the call.
+ * - timer: a periodic POSIX timer of period JITTER_PERIOD, whose signal the
+ *   benchmark waits for. Each wake-up is measured from the start of the
+ *   timer plus a whole number of periods, so that the errors don't add up.
+ *
+ * With the ticks, a wake-up is rounded up to a tick and may be a tick late.
+ * With CONFIG_HRTIMER, it is late by the latency of the timer interrupt.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <signal.h>
+#include <time.h>
+
+#include "kernel_bench.h"
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+/* Wake-ups timed, and the time between them in microseconds */
+
+#define JITTER_WAKEUPS 200
+#define JITTER_PERIOD  1500
+
+#define JITTER_SIGNO   SIGUSR1
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct jitter_s {
+	unsigned long min;
+	unsigned long max;
+	unsigned long long sum;
+	int count;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void jitter_init(FAR struct jitter_s *jitter)
+{
+	jitter->min = (unsigned long)-1;
+	jitter->max = 0;
+	jitter->sum = 0;
+	jitter->count = 0;
+}
+
+/* Add a wake-up at now for the time expected, in microseconds */
+
+static void jitter_add(FAR struct jitter_s *jitter, unsigned long expected, unsigned long now)
+{
+	unsigned long late = (long)(now - expected) > 0 ? now - expected : 0;
+
+	if (late < jitter->min) {
+		jitter->min = late;
+	}
+	if (late > jitter->max) {
+		jitter->max = late;
+	}
+	jitter->sum += late;
+	jitter->count++;
+}
+
+static void jitter_print(FAR const char *name, FAR struct jitter_s *jitter)
+{
+	printf("%10s %10lu %10lu %10lu\n", name, jitter->min, (unsigned long)(jitter->sum / jitter->count), jitter->max);
+}
+
+static int bench_nanosleep(FAR struct jitter_s *jitter)
+{
+	struct timespec ts;
+	unsigned long start;
+	int i;
+
+	ts.tv_sec = 0;
+	ts.tv_nsec = JITTER_PERIOD * 1000;
+
+	for (i = 0; i < JITTER_WAKEUPS; i++) {
+		start = kbench_usec();
+		if (nanosleep(&ts, NULL) != 0) {
+			printf("nanosleep failed\n");
+			return -1;
+		}
+		jitter_add(jitter, start + JITTER_PERIOD, kbench_usec());
+	}
+	return 0;
+}
+
+#ifndef CONFIG_DISABLE_POSIX_TIMERS
+static int bench_timer(FAR struct jitter_s *jitter)
+{
+	struct sigevent sev;
+	struct itimerspec its;
+	struct siginfo info;
+	timer_t timer;
+	sigset_t set;
+	sigset_t oset;
+	unsigned long start;
+	int ret = 0;
+	int i;
+
+	/* The signal is only taken by sigwaitinfo() */
+
+	sigemptyset(&set);
+	sigaddset(&set, JITTER_SIGNO);
+	sigprocmask(SIG_BLOCK, &set, &oset);
+
+	sev.sigev_notify = SIGEV_SIGNAL;
+	sev.sigev_signo = JITTER_SIGNO;
+	sev.sigev_value.sival_ptr = NULL;
+	if (timer_create(CLOCK_REALTIME, &sev, &timer) != 0) {
+		printf("timer_create failed\n");
+		sigprocmask(SIG_SETMASK, &oset, NULL);
+		return -1;
+	}
+
+	its.it_value.tv_sec = 0;
+	its.it_value.tv_nsec = JITTER_PERIOD * 1000;
+	its.it_interval = its.it_value;
+
+	start = kbench_usec();
+	timer_settime(timer, 0, &its, NULL);
+
+	for (i = 1; i <= JITTER_WAKEUPS; i++) {
+		if (sigwaitinfo(&set, &info) != JITTER_SIGNO) {
+			printf("sigwaitinfo failed\n");
+			ret = -1;
+			break;
+		}
+		jitter_add(jitter, start + i * JITTER_PERIOD, kbench_usec());
+	}
+
+	timer_delete(timer);
+	sigprocmask(SIG_SETMASK, &oset, NULL);
+	return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int kbench_jitter(void)
+{
+	struct jitter_s jitter;
+
+#ifdef CONFIG_HRTIMER
+	printf("timing: hrtimer\n");
+#else
+	printf("timing: ticks of %d us\n", CONFIG_USEC_PER_TICK);
+#endif
+	printf("%d wake-ups %d us apart, late by (us):\n", JITTER_WAKEUPS, JITTER_PERIOD);
+	printf("%10s %10s %10s %10s\n", "", "min", "mean", "max");
+
+	jitter_init(&jitter);
+	if (bench_nanosleep(&jitter) != 0) {
+		return -1;
+	}
+	jitter_print("nanosleep", &jitter);
+
+#ifndef CONFIG_DISABLE_POSIX_TIMERS
+	jitter_init(&jitter);
+	if (bench_timer(&jitter) != 0) {
+		return -1;
+	}
+	jitter_print("timer", &jitter);
+#endif
+
+	return 0;
+}
@@ -0,0 +1,90 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_EXAMPLES_KERNEL_BENCH_KERNEL_BENCH_H
+#define __APPS_EXAMPLES_KERNEL_BENCH_KERNEL_BENCH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <pthread.h>
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_EXAMPLES_KERNEL_BENCH_NTASKS
+#define KBENCH_NTASKS CONFIG_EXAMPLES_KERNEL_BENCH_NTASKS
+#else
+#define KBENCH_NTASKS 32
+#endif
+
+#ifdef CONFIG_EXAMPLES_KERNEL_BENCH_NTIMERS
+#define KBENCH_NTIMERS CONFIG_EXAMPLES_KERNEL_BENCH_NTIMERS
+#else
+#define KBENCH_NTIMERS 1024
+#endif
+
+#ifdef CONFIG_EXAMPLES_KERNEL_BENCH_STACKSIZE
+#define KBENCH_STACKSIZE CONFIG_EXAMPLES_KERNEL_BENCH_STACKSIZE
+#else
+#define KBENCH_STACKSIZE 2048
+#endif
+
+/* The benchmark runs at KBENCH_PRIO_HIGH, and the threads it measures at
+ * KBENCH_PRIO_LOW unless said otherwise, so that they only run once it
+ * waits for them.
+ */
+
+#define KBENCH_PRIO_HIGH 200
+#define KBENCH_PRIO_LOW  150
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* Time in microseconds, from an arbitrary start */
+
+unsigned long kbench_usec(void);
+
+/* Create a SCHED_FIFO thread of the given priority */
+
+int kbench_thread(FAR pthread_t *thread, int priority, pthread_startroutine_t entry, FAR void *arg);
+
+/* The benchmarks */
+
+int kbench_sched(void);
+int kbench_lock(void);
+int kbench_task(void);
+#ifndef CONFIG_DISABLE_POSIX_TIMERS
+int kbench_wdog(void);
+#endif
+#ifndef CONFIG_DISABLE_SIGNALS
+int kbench_jitter(void);
+#endif
+#ifndef CONFIG_DISABLE_MQUEUE
+int kbench_mqueue(void);
+#endif
+#if defined(CONFIG_EVENT_FD) && !defined(CONFIG_DISABLE_SIGNALS)
+int kbench_event(void);
+#endif
+
+#endif							/* __APPS_EXAMPLES_KERNEL_BENCH_KERNEL_BENCH_H */
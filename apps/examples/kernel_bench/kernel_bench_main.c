@@ -0,0 +1,138 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <sched.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "kernel_bench.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct kbench_s {
+	FAR const char *name;
+	int (*run)(void);
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct kbench_s g_benchs[] = {
+	{"sched", kbench_sched},
+	{"lock", kbench_lock},
+	{"task", kbench_task},
+#ifndef CONFIG_DISABLE_POSIX_TIMERS
+	{"wdog", kbench_wdog},
+#endif
+#ifndef CONFIG_DISABLE_SIGNALS
+	{"jitter", kbench_jitter},
+#endif
+#ifndef CONFIG_DISABLE_MQUEUE
+	{"mqueue", kbench_mqueue},
+#endif
+#if defined(CONFIG_EVENT_FD) && !defined(CONFIG_DISABLE_SIGNALS)
+	{"event", kbench_event},
+#endif
+};
+
+#define NBENCHS (sizeof(g_benchs) / sizeof(g_benchs[0]))
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+unsigned long kbench_usec(void)
+{
+	struct timespec ts;
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+	clock_gettime(CLOCK_REALTIME, &ts);
+#endif
+	return (unsigned long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+int kbench_thread(FAR pthread_t *thread, int priority, pthread_startroutine_t entry, FAR void *arg)
+{
+	pthread_attr_t attr;
+	struct sched_param param;
+	int ret;
+
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, KBENCH_STACKSIZE);
+	pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+	pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+	param.sched_priority = priority;
+	pthread_attr_setschedparam(&attr, &param);
+
+	ret = pthread_create(thread, &attr, entry, arg);
+	pthread_attr_destroy(&attr);
+	if (ret != 0) {
+		printf("kernel_bench: pthread_create failed: %d\n", ret);
+	}
+	return ret;
+}
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int kernel_bench_main(int argc, char *argv[])
+#endif
+{
+	struct sched_param param;
+	int failed = 0;
+	int i;
+	int j;
+
+	/* The threads being measured only run when the benchmark waits */
+
+	param.sched_priority = KBENCH_PRIO_HIGH;
+	if (sched_setscheduler(0, SCHED_FIFO, &param) != 0) {
+		printf("kernel_bench: sched_setscheduler failed\n");
+		return 1;
+	}
+
+	for (i = 0; i < NBENCHS; i++) {
+		if (argc > 1) {
+			for (j = 1; j < argc && strcmp(argv[j], g_benchs[i].name) != 0; j++) ;
+			if (j == argc) {
+				continue;
+			}
+		}
+
+		printf("\n%s\n", g_benchs[i].name);
+		if (g_benchs[i].run() != 0) {
+			printf("%s: FAILED\n", g_benchs[i].name);
+			failed++;
+		}
+	}
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,275 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Lock benchmark
+ *
+ * Semaphores used as locks and mutexes, each one measured:
+ *
+ * - lock: a lock and an unlock with nothing else taking the lock. With
+ *   CONFIG_SEM_FASTPATH in the protected build, a semaphore without
+ *   priority inheritance is taken and given without a system call.
+ * - contended: a thread of KBENCH_PRIO_LOW takes the lock and wakes the
+ *   benchmark, which then waits for the lock until the thread unlocks it.
+ *   That is the system calls blocking and waking up, and the boost of the
+ *   thread by priority inheritance.
+ * - boosted: how many times the thread was seen running at the priority
+ *   of the benchmark while it waited, which priority inheritance must do
+ *   every time for the locks which have it.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <pthread.h>
+
+#include <tinyara/semaphore.h>
+
+#include "kernel_bench.h"
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+/* Uncontended locks and contended ones timed per lock */
+
+#define LOCK_OPS    20000
+#define LOCK_CYCLES 2000
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct lock_s {
+	FAR const char *name;
+	CODE int (*lock)(FAR void *obj);
+	CODE int (*unlock)(FAR void *obj);
+	FAR void *obj;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static sem_t g_sem;
+#ifdef CONFIG_PRIORITY_INHERITANCE
+static sem_t g_sem_nopi;
+#endif
+static pthread_mutex_t g_mutex;
+
+/* Signals between the benchmark and the thread, without priority
+ * inheritance
+ */
+
+static sem_t g_go;
+static sem_t g_held;
+static volatile bool g_stop;
+static int g_boosted;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int sem_lock(FAR void *obj)
+{
+	return sem_wait((FAR sem_t *)obj);
+}
+
+static int sem_unlock(FAR void *obj)
+{
+	return sem_post((FAR sem_t *)obj);
+}
+
+static int mutex_lock(FAR void *obj)
+{
+	return pthread_mutex_lock((FAR pthread_mutex_t *)obj);
+}
+
+static int mutex_unlock(FAR void *obj)
+{
+	return pthread_mutex_unlock((FAR pthread_mutex_t *)obj);
+}
+
+/* Take the lock whenever the benchmark asks, and release it once the
+ * benchmark waits for it.
+ */
+
+static pthread_addr_t lock_thread(pthread_addr_t arg)
+{
+	FAR struct lock_s *lock = (FAR struct lock_s *)arg;
+	struct sched_param param;
+
+	for (;;) {
+		sem_wait(&g_go);
+		if (g_stop) {
+			break;
+		}
+
+		/* The benchmark runs as soon as it is posted, and is back once
+		 * it waits for the lock.
+		 */
+
+		lock->lock(lock->obj);
+		sem_post(&g_held);
+
+		if (sched_getparam(0, &param) == 0 && param.sched_priority == KBENCH_PRIO_HIGH) {
+			g_boosted++;
+		}
+		lock->unlock(lock->obj);
+	}
+	return NULL;
+}
+
+/* Nanoseconds per lock and unlock with no contention */
+
+static unsigned long bench_lock(FAR struct lock_s *lock)
+{
+	unsigned long start;
+	int i;
+
+	start = kbench_usec();
+	for (i = 0; i < LOCK_OPS; i++) {
+		lock->lock(lock->obj);
+		lock->unlock(lock->obj);
+	}
+	return (unsigned long)((unsigned long long)(kbench_usec() - start) * 1000 / LOCK_OPS);
+}
+
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+/* Whether a mutex nobody else wants is locked without the system call, by
+ * the owner word of the fast path being in the mutex
+ */
+
+static bool mutex_fastpath(void)
+{
+	bool fast;
+
+	pthread_mutex_lock(&g_mutex);
+	fast = g_mutex.pid >= 0 && (g_mutex.pid & _PTHREAD_MPID_FAST) != 0;
+	pthread_mutex_unlock(&g_mutex);
+	return fast;
+}
+#endif
+
+/* Nanoseconds per contended lock, handed over by a lower priority thread */
+
+static int bench_contended(FAR struct lock_s *lock, FAR unsigned long *ns)
+{
+	pthread_t thread;
+	unsigned long start;
+	int i;
+
+	g_stop = false;
+	g_boosted = 0;
+	if (kbench_thread(&thread, KBENCH_PRIO_LOW, lock_thread, lock) != 0) {
+		return -1;
+	}
+
+	start = kbench_usec();
+	for (i = 0; i < LOCK_CYCLES; i++) {
+		sem_post(&g_go);
+		sem_wait(&g_held);
+		lock->lock(lock->obj);
+		lock->unlock(lock->obj);
+	}
+	*ns = (unsigned long)((unsigned long long)(kbench_usec() - start) * 1000 / LOCK_CYCLES);
+
+	g_stop = true;
+	sem_post(&g_go);
+	pthread_join(thread, NULL);
+	return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int kbench_lock(void)
+{
+	struct lock_s locks[] = {
+		{"sem", sem_lock, sem_unlock, &g_sem},
+#ifdef CONFIG_PRIORITY_INHERITANCE
+		{"sem_nopi", sem_lock, sem_unlock, &g_sem_nopi},
+#endif
+		{"mutex", mutex_lock, mutex_unlock, &g_mutex},
+	};
+	unsigned long lock_ns;
+	unsigned long contended_ns;
+	int ret = 0;
+	int i;
+
+	sem_init(&g_sem, 0, 1);
+#ifdef CONFIG_PRIORITY_INHERITANCE
+	sem_init(&g_sem_nopi, 0, 1);
+#endif
+	pthread_mutex_init(&g_mutex, NULL);
+	sem_init(&g_go, 0, 0);
+	sem_init(&g_held, 0, 0);
+#ifdef CONFIG_PRIORITY_INHERITANCE
+	sem_setprotocol(&g_sem_nopi, SEM_PRIO_NONE);
+	sem_setprotocol(&g_go, SEM_PRIO_NONE);
+	sem_setprotocol(&g_held, SEM_PRIO_NONE);
+#endif
+
+#ifdef CONFIG_SEM_FASTPATH
+	printf("semaphores: fast path\n");
+#else
+	printf("semaphores: system calls\n");
+#endif
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+	if (mutex_fastpath()) {
+		printf("mutexes: fast path\n");
+	} else {
+		printf("mutexes: system calls, the owner word is not published\n");
+	}
+#else
+	printf("mutexes: system calls\n");
+#endif
+#ifdef CONFIG_PRIORITY_INHERITANCE
+	printf("priority inheritance: sem, mutex\n");
+#else
+	printf("priority inheritance: none\n");
+#endif
+	printf("%10s %10s %12s %10s\n", "", "lock_ns", "contended_ns", "boosted");
+
+	for (i = 0; i < sizeof(locks) / sizeof(locks[0]); i++) {
+		lock_ns = bench_lock(&locks[i]);
+		if (bench_contended(&locks[i], &contended_ns) != 0) {
+			printf("cannot create a thread\n");
+			ret = -1;
+			break;
+		}
+		printf("%10s %10lu %12lu %5d/%d\n", locks[i].name, lock_ns, contended_ns, g_boosted, LOCK_CYCLES);
+	}
+
+	sem_destroy(&g_held);
+	sem_destroy(&g_go);
+	pthread_mutex_destroy(&g_mutex);
+#ifdef CONFIG_PRIORITY_INHERITANCE
+	sem_destroy(&g_sem_nopi);
+#endif
+	sem_destroy(&g_sem);
+	return ret;
+}
@@ -0,0 +1,255 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Message queue benchmark
+ *
+ * A producer thread sends MQUEUE_NMSGS messages of each size to a consumer
+ * thread of the same priority through a queue of MQUEUE_DEPTH messages:
+ *
+ * - copy: mq_send() and mq_receive(), which copy the message into the
+ *   queue and out of it.
+ * - zerocopy: with CONFIG_MQ_ZEROCOPY, mq_sendbuf() of a buffer from the
+ *   heap and mq_receivebuf(), after which the consumer frees it. Only the
+ *   address of the buffer is queued, the malloc() and free() are the cost
+ *   of passing its ownership.
+ *
+ * Messages larger than CONFIG_MQ_MAXMSGSIZE are only sent with
+ * CONFIG_MQ_MSGPOOL, which allocates the messages of each queue at
+ * mq_open() of the size of the queue.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <pthread.h>
+
+#include "kernel_bench.h"
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+#define MQUEUE_NAME    "/kbench_mq"
+#define MQUEUE_NMSGS   2000
+#define MQUEUE_DEPTH   8
+
+/* The message sizes, up to 4096 bytes with the pools */
+
+#define MQUEUE_MINSIZE 16
+#ifdef CONFIG_MQ_MSGPOOL
+#define MQUEUE_MAXSIZE 4096
+#else
+#define MQUEUE_MAXSIZE CONFIG_MQ_MAXMSGSIZE
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct mqueue_bench_s {
+	mqd_t mqd;
+	size_t msgsize;
+	bool zerocopy;
+	int errors;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static FAR void *mqueue_producer(FAR void *arg)
+{
+	FAR struct mqueue_bench_s *bench = (FAR struct mqueue_bench_s *)arg;
+	FAR char *msg = NULL;
+	int i;
+
+	if (!bench->zerocopy) {
+		msg = (FAR char *)calloc(1, bench->msgsize);
+		if (!msg) {
+			bench->errors++;
+			return NULL;
+		}
+	}
+
+	for (i = 0; i < MQUEUE_NMSGS; i++) {
+#ifdef CONFIG_MQ_ZEROCOPY
+		if (bench->zerocopy) {
+			msg = (FAR char *)malloc(bench->msgsize);
+			if (!msg || mq_sendbuf(bench->mqd, msg, bench->msgsize, 0) != 0) {
+				free(msg);
+				bench->errors++;
+			}
+			continue;
+		}
+#endif
+		if (mq_send(bench->mqd, msg, bench->msgsize, 0) != 0) {
+			bench->errors++;
+		}
+	}
+
+	if (!bench->zerocopy) {
+		free(msg);
+	}
+	return NULL;
+}
+
+static FAR void *mqueue_consumer(FAR void *arg)
+{
+	FAR struct mqueue_bench_s *bench = (FAR struct mqueue_bench_s *)arg;
+	FAR char *msg = NULL;
+	int i;
+
+	if (!bench->zerocopy) {
+		msg = (FAR char *)malloc(bench->msgsize);
+		if (!msg) {
+			bench->errors++;
+			return NULL;
+		}
+	}
+
+	for (i = 0; i < MQUEUE_NMSGS; i++) {
+#ifdef CONFIG_MQ_ZEROCOPY
+		if (bench->zerocopy) {
+			if (mq_receivebuf(bench->mqd, (FAR void **)&msg, NULL) != (ssize_t)bench->msgsize) {
+				bench->errors++;
+				break;
+			}
+			free(msg);
+			continue;
+		}
+#endif
+		if (mq_receive(bench->mqd, msg, bench->msgsize, NULL) != (ssize_t)bench->msgsize) {
+			bench->errors++;
+			break;
+		}
+	}
+
+	if (!bench->zerocopy) {
+		free(msg);
+	}
+	return NULL;
+}
+
+/* Send the messages of a size through a new queue, return the ns per
+ * message or 0 on a failure.
+ */
+
+static unsigned long mqueue_run(size_t msgsize, bool zerocopy)
+{
+	struct mqueue_bench_s bench;
+	struct mq_attr attr;
+	pthread_t producer;
+	pthread_t consumer;
+	unsigned long start;
+	unsigned long elapsed;
+
+	attr.mq_maxmsg = MQUEUE_DEPTH;
+	attr.mq_msgsize = msgsize;
+	attr.mq_flags = 0;
+#ifdef CONFIG_MQ_ZEROCOPY
+	if (zerocopy) {
+		attr.mq_flags = MQ_ZEROCOPY;
+	}
+#endif
+
+	bench.mqd = mq_open(MQUEUE_NAME, O_RDWR | O_CREAT, 0666, &attr);
+	if (bench.mqd == (mqd_t)ERROR) {
+		printf("mq_open of %u bytes failed\n", (unsigned)msgsize);
+		return 0;
+	}
+	bench.msgsize = msgsize;
+	bench.zerocopy = zerocopy;
+	bench.errors = 0;
+
+	start = kbench_usec();
+	if (kbench_thread(&consumer, KBENCH_PRIO_LOW, mqueue_consumer, &bench) != 0) {
+		bench.errors++;
+	} else {
+		if (kbench_thread(&producer, KBENCH_PRIO_LOW, mqueue_producer, &bench) != 0) {
+			/* The consumer waits for messages which never come */
+
+			pthread_cancel(consumer);
+			bench.errors++;
+		} else {
+			pthread_join(producer, NULL);
+		}
+		pthread_join(consumer, NULL);
+	}
+	elapsed = kbench_usec() - start;
+
+	mq_close(bench.mqd);
+	mq_unlink(MQUEUE_NAME);
+
+	if (bench.errors) {
+		printf("%u bytes: %d errors\n", (unsigned)msgsize, bench.errors);
+		return 0;
+	}
+	return (unsigned long)((unsigned long long)elapsed * 1000 / MQUEUE_NMSGS);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int kbench_mqueue(void)
+{
+	unsigned long copy_ns;
+	size_t msgsize;
+#ifdef CONFIG_MQ_ZEROCOPY
+	unsigned long zerocopy_ns;
+#endif
+
+#ifdef CONFIG_MQ_MSGPOOL
+	printf("messages: pool of each queue\n");
+#else
+	printf("messages: shared, of %d bytes\n", CONFIG_MQ_MAXMSGSIZE);
+#endif
+	printf("%d messages through a queue of %d, ns per message:\n", MQUEUE_NMSGS, MQUEUE_DEPTH);
+#ifdef CONFIG_MQ_ZEROCOPY
+	printf("%8s %10s %10s %10s\n", "bytes", "copy_ns", "MB/s", "zerocopy_ns");
+#else
+	printf("%8s %10s %10s\n", "bytes", "copy_ns", "MB/s");
+#endif
+
+	for (msgsize = MQUEUE_MINSIZE; msgsize <= MQUEUE_MAXSIZE; msgsize *= 4) {
+		copy_ns = mqueue_run(msgsize, false);
+		if (copy_ns == 0) {
+			return -1;
+		}
+#ifdef CONFIG_MQ_ZEROCOPY
+		zerocopy_ns = mqueue_run(msgsize, true);
+		if (zerocopy_ns == 0) {
+			return -1;
+		}
+		printf("%8u %10lu %10lu %10lu\n", (unsigned)msgsize, copy_ns, (unsigned long)(msgsize * 1000 / copy_ns), zerocopy_ns);
+#else
+		printf("%8u %10lu %10lu\n", (unsigned)msgsize, copy_ns, (unsigned long)(msgsize * 1000 / copy_ns));
+#endif
+	}
+
+	return 0;
+}
@@ -0,0 +1,202 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Scheduler benchmark
+ *
+ * Both measurements put N threads of the same priority in the ready-to-run
+ * list, where a thread made ready goes after the others:
+ *
+ * - yield: the threads call sched_yield() in turn. A switch removes the
+ *   running thread from the list and adds it back behind the others.
+ * - wake: the benchmark posts the semaphores of the threads, each of which
+ *   posts back and waits again. A post adds a thread behind the ones
+ *   already woken.
+ *
+ * The list is updated with interrupts disabled, so how the time per
+ * operation grows with N is how the interrupt-disabled time grows.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <pthread.h>
+
+#include "kernel_bench.h"
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+/* Operations timed per number of threads */
+
+#define SCHED_OPS 20000
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static sem_t g_done;
+static sem_t g_wake[KBENCH_NTASKS];
+static volatile bool g_stop;
+static int g_rounds;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static pthread_addr_t yield_thread(pthread_addr_t arg)
+{
+	int i;
+
+	for (i = 0; i < g_rounds; i++) {
+		sched_yield();
+	}
+	sem_post(&g_done);
+	return NULL;
+}
+
+static pthread_addr_t wake_thread(pthread_addr_t arg)
+{
+	FAR sem_t *sem = (FAR sem_t *)arg;
+
+	for (;;) {
+		sem_wait(sem);
+		if (g_stop) {
+			break;
+		}
+		sem_post(&g_done);
+	}
+	return NULL;
+}
+
+/* Nanoseconds per sched_yield() among ntasks threads */
+
+static int bench_yield(int ntasks, FAR unsigned long *ns)
+{
+	pthread_t threads[KBENCH_NTASKS];
+	unsigned long start;
+	int created;
+	int i;
+
+	g_rounds = SCHED_OPS / ntasks;
+	for (created = 0; created < ntasks; created++) {
+		if (kbench_thread(&threads[created], KBENCH_PRIO_LOW, yield_thread, NULL) != 0) {
+			break;
+		}
+	}
+
+	/* The threads start once we wait */
+
+	start = kbench_usec();
+	for (i = 0; i < created; i++) {
+		sem_wait(&g_done);
+	}
+	*ns = (unsigned long)((unsigned long long)(kbench_usec() - start) * 1000 / (g_rounds * ntasks));
+
+	for (i = 0; i < created; i++) {
+		pthread_join(threads[i], NULL);
+	}
+	return created == ntasks ? 0 : -1;
+}
+
+/* Nanoseconds per wake-up of one of ntasks threads */
+
+static int bench_wake(int ntasks, FAR unsigned long *ns)
+{
+	pthread_t threads[KBENCH_NTASKS];
+	unsigned long start;
+	int created;
+	int round;
+	int i;
+
+	g_stop = false;
+	g_rounds = SCHED_OPS / ntasks;
+	for (created = 0; created < ntasks; created++) {
+		sem_init(&g_wake[created], 0, 0);
+		if (kbench_thread(&threads[created], KBENCH_PRIO_LOW, wake_thread, &g_wake[created]) != 0) {
+			sem_destroy(&g_wake[created]);
+			break;
+		}
+	}
+
+	/* One round untimed, for the threads to block on their semaphores */
+
+	start = 0;
+	for (round = 0; round <= g_rounds && created == ntasks; round++) {
+		if (round == 1) {
+			start = kbench_usec();
+		}
+		for (i = 0; i < ntasks; i++) {
+			sem_post(&g_wake[i]);
+		}
+		for (i = 0; i < ntasks; i++) {
+			sem_wait(&g_done);
+		}
+	}
+	if (start != 0) {
+		*ns = (unsigned long)((unsigned long long)(kbench_usec() - start) * 1000 / (g_rounds * ntasks));
+	}
+
+	g_stop = true;
+	for (i = 0; i < created; i++) {
+		sem_post(&g_wake[i]);
+		pthread_join(threads[i], NULL);
+		sem_destroy(&g_wake[i]);
+	}
+	return created == ntasks ? 0 : -1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int kbench_sched(void)
+{
+	unsigned long yield_ns;
+	unsigned long wake_ns;
+	int ntasks;
+
+	sem_init(&g_done, 0, 0);
+
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+	printf("ready-to-run list: bitmap index\n");
+#else
+	printf("ready-to-run list: linear search\n");
+#endif
+	printf("%8s %10s %10s\n", "tasks", "yield_ns", "wake_ns");
+
+	for (ntasks = 2; ntasks <= KBENCH_NTASKS; ntasks *= 2) {
+		if (bench_yield(ntasks, &yield_ns) != 0 || bench_wake(ntasks, &wake_ns) != 0) {
+			printf("cannot create %d threads\n", ntasks);
+			sem_destroy(&g_done);
+			return -1;
+		}
+		printf("%8d %10lu %10lu\n", ntasks, yield_ns, wake_ns);
+	}
+
+	sem_destroy(&g_done);
+	return 0;
+}
@@ -0,0 +1,224 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Task creation benchmark
+ *
+ * - cycle: TASK_NCYCLES pthread_create() and pthread_join() of a thread of
+ *   lower priority which returns at once, and with CONFIG_SCHED_WAITPID as
+ *   many task_create() and waitpid() of a task, for a few stack sizes.
+ *   Without CONFIG_TASK_POOL, or with a stack larger than its classes, each
+ *   cycle allocates and frees the TCB and the stack in the heap.
+ * - fragmentation: TASK_NFRAG threads of varied stacks are created, and
+ *   before each is joined a small block is allocated and kept, as a server
+ *   allocating for each connection does. A stack from the heap is freed
+ *   around the blocks kept, which splits the free memory. The largest free
+ *   chunk is reported against all the free memory, before and after.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <pthread.h>
+#ifdef CONFIG_SCHED_WAITPID
+#include <sys/wait.h>
+#endif
+
+#include "kernel_bench.h"
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+#define TASK_NCYCLES 500
+#define TASK_NFRAG   64
+#define TASK_BLOCK   64
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const int g_task_stacks[] = { 1024, 2048, 4096, 8192 };
+
+#define TASK_NSTACKS (sizeof(g_task_stacks) / sizeof(g_task_stacks[0]))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static FAR void *task_thread(FAR void *arg)
+{
+	return NULL;
+}
+
+static int task_create_thread(FAR pthread_t *thread, int stack_size)
+{
+	pthread_attr_t attr;
+	struct sched_param param;
+	int ret;
+
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, stack_size);
+	pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+	pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+	param.sched_priority = KBENCH_PRIO_LOW;
+	pthread_attr_setschedparam(&attr, &param);
+
+	ret = pthread_create(thread, &attr, task_thread, NULL);
+	pthread_attr_destroy(&attr);
+	return ret;
+}
+
+/* Return the ns per cycle, or 0 on a failure */
+
+static unsigned long task_pthread_cycle(int stack_size)
+{
+	pthread_t thread;
+	unsigned long start;
+	int i;
+
+	start = kbench_usec();
+	for (i = 0; i < TASK_NCYCLES; i++) {
+		if (task_create_thread(&thread, stack_size) != 0) {
+			printf("pthread_create failed\n");
+			return 0;
+		}
+		pthread_join(thread, NULL);
+	}
+	return (unsigned long)((unsigned long long)(kbench_usec() - start) * 1000 / TASK_NCYCLES);
+}
+
+#ifdef CONFIG_SCHED_WAITPID
+static int task_main(int argc, FAR char *argv[])
+{
+	return 0;
+}
+
+static unsigned long task_task_cycle(int stack_size)
+{
+	unsigned long start;
+	int status;
+	pid_t pid;
+	int i;
+
+	start = kbench_usec();
+	for (i = 0; i < TASK_NCYCLES; i++) {
+		pid = task_create("kbench_task", KBENCH_PRIO_LOW, stack_size, task_main, NULL);
+		if (pid < 0) {
+			printf("task_create failed\n");
+			return 0;
+		}
+		waitpid(pid, &status, 0);
+	}
+	return (unsigned long)((unsigned long long)(kbench_usec() - start) * 1000 / TASK_NCYCLES);
+}
+#endif
+
+static void task_print_heap(FAR const char *name)
+{
+	struct mallinfo info;
+
+#ifdef CONFIG_CAN_PASS_STRUCTS
+	info = mallinfo();
+#else
+	(void)mallinfo(&info);
+#endif
+
+	printf("%10s %10d %10d %10d %10d\n", name, info.fordblks, info.ordblks, info.mxordblk, info.fordblks ? 100 - (int)((long long)info.mxordblk * 100 / info.fordblks) : 0);
+}
+
+static int task_fragment(void)
+{
+	FAR void *blocks[TASK_NFRAG];
+	pthread_t thread;
+	int ret = 0;
+	int n;
+	int i;
+
+	printf("%d threads of varied stacks, a block of %d bytes kept for each:\n", TASK_NFRAG, TASK_BLOCK);
+	printf("%10s %10s %10s %10s %10s\n", "", "free", "chunks", "largest", "frag_%");
+	task_print_heap("before");
+
+	for (n = 0; n < TASK_NFRAG; n++) {
+		if (task_create_thread(&thread, g_task_stacks[n % (TASK_NSTACKS - 1)]) != 0) {
+			printf("pthread_create failed\n");
+			ret = -1;
+			break;
+		}
+		blocks[n] = malloc(TASK_BLOCK);
+		pthread_join(thread, NULL);
+		if (!blocks[n]) {
+			printf("malloc failed\n");
+			ret = -1;
+			break;
+		}
+	}
+
+	if (ret == 0) {
+		task_print_heap("after");
+	}
+
+	for (i = 0; i < n; i++) {
+		free(blocks[i]);
+	}
+	return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int kbench_task(void)
+{
+	unsigned long pthread_ns;
+	unsigned long task_ns = 0;
+	int i;
+
+#ifdef CONFIG_TASK_POOL
+	printf("TCBs and stacks: pool of %dx%d %dx%d %dx%d, then heap\n",
+		   CONFIG_TASK_POOL_SMALL_NSLOTS, CONFIG_TASK_POOL_SMALL_STACKSIZE,
+		   CONFIG_TASK_POOL_MEDIUM_NSLOTS, CONFIG_TASK_POOL_MEDIUM_STACKSIZE,
+		   CONFIG_TASK_POOL_LARGE_NSLOTS, CONFIG_TASK_POOL_LARGE_STACKSIZE);
+#else
+	printf("TCBs and stacks: heap\n");
+#endif
+	printf("%d create/join cycles, ns per cycle:\n", TASK_NCYCLES);
+	printf("%10s %10s %10s\n", "stack", "pthread_ns", "task_ns");
+
+	for (i = 0; i < TASK_NSTACKS; i++) {
+		pthread_ns = task_pthread_cycle(g_task_stacks[i]);
+		if (pthread_ns == 0) {
+			return -1;
+		}
+#ifdef CONFIG_SCHED_WAITPID
+		task_ns = task_task_cycle(g_task_stacks[i]);
+		if (task_ns == 0) {
+			return -1;
+		}
+#endif
+		printf("%10d %10lu %10lu\n", g_task_stacks[i], pthread_ns, task_ns);
+	}
+
+	return task_fragment();
+}
@@ -0,0 +1,285 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Watchdog benchmark
+ *
+ * N POSIX timers, each of which is a watchdog, are armed with random
+ * expirations between one and a hundred seconds, so that none expires
+ * during the benchmark:
+ *
+ * - arm: timer_settime() of a disarmed timer, which starts its watchdog.
+ * - rearm: timer_settime() of an armed timer, which cancels its watchdog
+ *   and starts it again.
+ * - cancel: timer_settime() of a zero time, which cancels the watchdog.
+ *
+ * The active watchdogs are updated with interrupts disabled, but the time
+ * of a timer_settime() also counts its system call and its work outside of
+ * that section, so it only approximates how the interrupt-disabled time
+ * grows with N.  With CONFIG_SCHED_STATS_IRQOFF, each round runs in its own
+ * thread, whose longest interrupt-disabled section is then read from
+ * /proc/<pid>/schedstat.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+#include "kernel_bench.h"
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+/* The smallest number of timers */
+
+#define WDOG_MINTIMERS 64
+
+/* The expirations, in milliseconds */
+
+#define WDOG_MINMSEC 1000
+#define WDOG_MAXMSEC 100000
+
+/* The interrupt-disabled sections are measured by the scheduling
+ * statistics of the thread, read from procfs
+ */
+
+#if defined(CONFIG_SCHED_STATS_IRQOFF) && defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_PROCESS)
+#define WDOG_IRQOFF 1
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A round of the benchmark, for a number of timers */
+
+struct wdog_round_s {
+	FAR timer_t *timers;
+	int ntimers;
+	unsigned long arm_ns;
+	unsigned long rearm_ns;
+	unsigned long cancel_ns;
+	sem_t done;					/* Posted by the thread once it is measured */
+	sem_t release;				/* Posted to let the thread exit */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint32_t g_seed = 1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* A small LCG, for the same expirations in every run */
+
+static uint32_t wdog_random(void)
+{
+	g_seed = g_seed * 1103515245 + 12345;
+	return g_seed >> 8;
+}
+
+static void wdog_timespec(FAR struct itimerspec *its, uint32_t msec)
+{
+	its->it_interval.tv_sec = 0;
+	its->it_interval.tv_nsec = 0;
+	its->it_value.tv_sec = msec / 1000;
+	its->it_value.tv_nsec = (msec % 1000) * 1000000;
+}
+
+/* Arm all the timers with random expirations */
+
+static unsigned long wdog_arm(FAR timer_t *timers, int ntimers)
+{
+	struct itimerspec its;
+	unsigned long start;
+	int i;
+
+	start = kbench_usec();
+	for (i = 0; i < ntimers; i++) {
+		wdog_timespec(&its, WDOG_MINMSEC + wdog_random() % (WDOG_MAXMSEC - WDOG_MINMSEC));
+		timer_settime(timers[i], 0, &its, NULL);
+	}
+	return (unsigned long)((unsigned long long)(kbench_usec() - start) * 1000 / ntimers);
+}
+
+/* Disarm all the timers in a random order */
+
+static unsigned long wdog_cancel(FAR timer_t *timers, int ntimers)
+{
+	struct itimerspec its;
+	unsigned long start;
+	timer_t timer;
+	int i;
+	int j;
+
+	for (i = ntimers - 1; i > 0; i--) {
+		j = wdog_random() % (i + 1);
+		timer = timers[i];
+		timers[i] = timers[j];
+		timers[j] = timer;
+	}
+
+	wdog_timespec(&its, 0);
+	start = kbench_usec();
+	for (i = 0; i < ntimers; i++) {
+		timer_settime(timers[i], 0, &its, NULL);
+	}
+	return (unsigned long)((unsigned long long)(kbench_usec() - start) * 1000 / ntimers);
+}
+
+/* The thread of a round, which stays until its statistics are read */
+
+static pthread_addr_t wdog_thread(pthread_addr_t arg)
+{
+	FAR struct wdog_round_s *round = (FAR struct wdog_round_s *)arg;
+
+	round->arm_ns = wdog_arm(round->timers, round->ntimers);
+	round->rearm_ns = wdog_arm(round->timers, round->ntimers);
+	round->cancel_ns = wdog_cancel(round->timers, round->ntimers);
+
+	sem_post(&round->done);
+	while (sem_wait(&round->release) != 0) ;
+	return NULL;
+}
+
+#ifdef WDOG_IRQOFF
+/* The longest interrupt-disabled section of a thread, in microseconds */
+
+static long wdog_irqoff(pthread_t thread)
+{
+	char path[32];
+	char line[64];
+	unsigned long usec;
+	long ret = -1;
+	FILE *stream;
+
+	snprintf(path, sizeof(path), "/proc/%d/schedstat", (int)thread);
+	stream = fopen(path, "r");
+	if (!stream) {
+		return -1;
+	}
+
+	while (fgets(line, sizeof(line), stream)) {
+		if (sscanf(line, "MaxIrqOff: %lu", &usec) == 1) {
+			ret = (long)usec;
+			break;
+		}
+	}
+
+	fclose(stream);
+	return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int kbench_wdog(void)
+{
+	struct wdog_round_s round;
+	FAR timer_t *timers;
+	struct sigevent sev;
+	pthread_t thread;
+	long irqoff = -1;
+	int created;
+	int ntimers;
+	int ret = 0;
+	int i;
+
+	timers = (FAR timer_t *)malloc(KBENCH_NTIMERS * sizeof(timer_t));
+	if (!timers) {
+		printf("cannot allocate %d timers\n", KBENCH_NTIMERS);
+		return -1;
+	}
+
+	/* No notification is sent, none of the timers expires anyway */
+
+	sev.sigev_notify = SIGEV_NONE;
+	sev.sigev_signo = SIGALRM;
+	sev.sigev_value.sival_ptr = NULL;
+
+	for (created = 0; created < KBENCH_NTIMERS; created++) {
+		if (timer_create(CLOCK_REALTIME, &sev, &timers[created]) != 0) {
+			printf("cannot create %d timers\n", KBENCH_NTIMERS);
+			ret = -1;
+			goto errout;
+		}
+	}
+
+#if defined(CONFIG_HRTIMER)
+	printf("active timers: hrtimer list\n");
+#elif defined(CONFIG_WDOG_TIMER_WHEEL)
+	printf("active watchdogs: timer wheel\n");
+#else
+	printf("active watchdogs: delta list\n");
+#endif
+#ifndef WDOG_IRQOFF
+	printf("irqoff_us: not measured, needs CONFIG_SCHED_STATS_IRQOFF and procfs\n");
+#endif
+	printf("%8s %10s %10s %10s %10s\n", "timers", "arm_ns", "rearm_ns", "cancel_ns", "irqoff_us");
+
+	round.timers = timers;
+	sem_init(&round.done, 0, 0);
+	sem_init(&round.release, 0, 0);
+
+	for (ntimers = WDOG_MINTIMERS; ntimers <= KBENCH_NTIMERS; ntimers *= 2) {
+		round.ntimers = ntimers;
+		if (kbench_thread(&thread, KBENCH_PRIO_LOW, wdog_thread, &round) != 0) {
+			ret = -1;
+			break;
+		}
+
+		while (sem_wait(&round.done) != 0) ;
+#ifdef WDOG_IRQOFF
+		irqoff = wdog_irqoff(thread);
+#endif
+		sem_post(&round.release);
+		pthread_join(thread, NULL);
+
+		if (irqoff < 0) {
+			printf("%8d %10lu %10lu %10lu %10s\n", ntimers, round.arm_ns, round.rearm_ns, round.cancel_ns, "-");
+		} else {
+			printf("%8d %10lu %10lu %10lu %10ld\n", ntimers, round.arm_ns, round.rearm_ns, round.cancel_ns, irqoff);
+		}
+	}
+
+	sem_destroy(&round.done);
+	sem_destroy(&round.release);
+
+errout:
+	for (i = 0; i < created; i++) {
+		timer_delete(timers[i]);
+	}
+	free(timers);
+	return ret;
+}
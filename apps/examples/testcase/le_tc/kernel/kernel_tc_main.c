@@ -73,6 +73,10 @@ int tc_kernel_main(int argc, char *argv[])
 	errno_main();
 #endif
 
+#ifdef CONFIG_TC_KERNEL_EVENTFD
+	eventfd_main();
+#endif
+
 #ifdef CONFIG_TC_KERNEL_GROUP
 #if (!defined CONFIG_SCHED_HAVE_PARENT) || (!defined CONFIG_SCHED_CHILD_STATUS)
 #error CONFIG_SCHED_HAVE_PARENT and CONFIG_SCHED_CHILD_STATUS are needed for testing GROUP TC
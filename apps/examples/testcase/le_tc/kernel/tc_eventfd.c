@@ -0,0 +1,264 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file tc_eventfd.c
+
+/// @brief Test Case Example for Event Flags File Descriptor API
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <tinyara/clock.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/eventfd.h>
+#include "tc_internal.h"
+
+#define EFD_FLAG_A          (1 << 0)
+#define EFD_FLAG_B          (1 << 1)
+#define EFD_FLAG_C          (1 << 5)
+#define EFD_TIMEOUT_MS      100
+#define EFD_SETTER_DELAY    (20 * USEC_PER_MSEC)
+#define EFD_PATH            "/dev/tc_eventfd"
+
+static volatile int g_efd_nset;
+
+static int efd_elapsed_ms(FAR const struct timespec *start)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_REALTIME, &now);
+	return (now.tv_sec - start->tv_sec) * MSEC_PER_SEC + (now.tv_nsec - start->tv_nsec) / NSEC_PER_MSEC;
+}
+
+static pthread_addr_t efd_setter(pthread_addr_t arg)
+{
+	int fd = (int)arg;
+
+	/* Set the flags one after the other, counting the ones set */
+
+	usleep(EFD_SETTER_DELAY);
+	g_efd_nset = 1;
+	eventfd_write(fd, EFD_FLAG_A);
+
+	usleep(EFD_SETTER_DELAY);
+	g_efd_nset = 2;
+	eventfd_write(fd, EFD_FLAG_B);
+
+	return NULL;
+}
+
+/**
+* @fn                   :tc_eventfd_wait_timeout
+* @brief                :Waits for flags which are not all set
+* @Scenario             :Without waiting, reading and waiting for flags not set fail at once.
+*                        Waiting for all of two flags, only one of them set, times out after
+*                        the timeout.
+* API's covered         :eventfd, eventfd_write, eventfd_read, eventfd_wait
+* Preconditions         :none
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_eventfd_wait_timeout(void)
+{
+	struct timespec start;
+	eventfd_t value;
+	int elapsed;
+	int ret_chk;
+	int fd;
+
+	fd = eventfd(0, EFD_NONBLOCK);
+	TC_ASSERT_GEQ("eventfd", fd, 0);
+
+	ret_chk = eventfd_read(fd, &value);
+	TC_ASSERT_EQ_CLEANUP("eventfd_read", ret_chk, ERROR, close(fd));
+	TC_ASSERT_EQ_CLEANUP("eventfd_read", errno, EAGAIN, close(fd));
+
+	ret_chk = eventfd_wait(fd, EFD_FLAG_A, EFD_WAIT_ANY, 0, NULL);
+	TC_ASSERT_EQ_CLEANUP("eventfd_wait", ret_chk, ERROR, close(fd));
+	TC_ASSERT_EQ_CLEANUP("eventfd_wait", errno, ETIMEDOUT, close(fd));
+
+	ret_chk = eventfd_wait(fd, 0, EFD_WAIT_ANY, 0, NULL);
+	TC_ASSERT_EQ_CLEANUP("eventfd_wait", ret_chk, ERROR, close(fd));
+	TC_ASSERT_EQ_CLEANUP("eventfd_wait", errno, EINVAL, close(fd));
+
+	ret_chk = eventfd_write(fd, EFD_FLAG_A);
+	TC_ASSERT_EQ_CLEANUP("eventfd_write", ret_chk, OK, close(fd));
+
+	/* The wait ends when the time is over, give or take a tick */
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	ret_chk = eventfd_wait(fd, EFD_FLAG_A | EFD_FLAG_B, EFD_WAIT_ALL, EFD_TIMEOUT_MS, &value);
+	elapsed = efd_elapsed_ms(&start);
+	TC_ASSERT_EQ_CLEANUP("eventfd_wait", ret_chk, ERROR, close(fd));
+	TC_ASSERT_EQ_CLEANUP("eventfd_wait", errno, ETIMEDOUT, close(fd));
+	TC_ASSERT_GEQ_CLEANUP("eventfd_wait", elapsed, EFD_TIMEOUT_MS - MSEC_PER_TICK, close(fd));
+
+	/* The flag set is left as it was */
+
+	ret_chk = eventfd_wait(fd, EFD_FLAG_A, EFD_WAIT_ANY, 0, &value);
+	TC_ASSERT_EQ_CLEANUP("eventfd_wait", ret_chk, OK, close(fd));
+	TC_ASSERT_EQ_CLEANUP("eventfd_wait", value, EFD_FLAG_A, close(fd));
+
+	close(fd);
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @fn                   :tc_eventfd_wait_all
+* @brief                :Waits for all of two flags set by another thread
+* @Scenario             :A thread sets two flags one after the other. Waiting for all of them
+*                        ends once the second one is set, without clearing them.
+* API's covered         :eventfd, eventfd_write, eventfd_wait
+* Preconditions         :none
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_eventfd_wait_all(void)
+{
+	pthread_t thread;
+	eventfd_t value;
+	int ret_chk;
+	int fd;
+
+	fd = eventfd(EFD_FLAG_C, 0);
+	TC_ASSERT_GEQ("eventfd", fd, 0);
+
+	g_efd_nset = 0;
+	ret_chk = pthread_create(&thread, NULL, efd_setter, (pthread_addr_t)fd);
+	TC_ASSERT_EQ_CLEANUP("pthread_create", ret_chk, OK, close(fd));
+
+	ret_chk = eventfd_wait(fd, EFD_FLAG_A | EFD_FLAG_B, EFD_WAIT_ALL, -1, &value);
+	pthread_join(thread, NULL);
+	TC_ASSERT_EQ_CLEANUP("eventfd_wait", ret_chk, OK, close(fd));
+	TC_ASSERT_EQ_CLEANUP("eventfd_wait", g_efd_nset, 2, close(fd));
+	TC_ASSERT_EQ_CLEANUP("eventfd_wait", value, EFD_FLAG_A | EFD_FLAG_B | EFD_FLAG_C, close(fd));
+
+	ret_chk = eventfd_wait(fd, EFD_FLAG_A | EFD_FLAG_B, EFD_WAIT_ALL, 0, &value);
+	TC_ASSERT_EQ_CLEANUP("eventfd_wait", ret_chk, OK, close(fd));
+
+	close(fd);
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @fn                   :tc_eventfd_clear
+* @brief                :Clears the flags waited for
+* @Scenario             :Waiting for a flag with EFD_CLEAR clears it and no other, read() then
+*                        returns and clears all the others, and eventfd_clear() clears flags
+*                        without waiting.
+* API's covered         :eventfd, eventfd_read, eventfd_wait, eventfd_clear
+* Preconditions         :none
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_eventfd_clear(void)
+{
+	eventfd_t value;
+	int ret_chk;
+	int fd;
+
+	fd = eventfd(EFD_FLAG_A | EFD_FLAG_B | EFD_FLAG_C, EFD_NONBLOCK);
+	TC_ASSERT_GEQ("eventfd", fd, 0);
+
+	ret_chk = eventfd_wait(fd, EFD_FLAG_A, EFD_WAIT_ANY | EFD_CLEAR, 0, &value);
+	TC_ASSERT_EQ_CLEANUP("eventfd_wait", ret_chk, OK, close(fd));
+	TC_ASSERT_EQ_CLEANUP("eventfd_wait", value, EFD_FLAG_A | EFD_FLAG_B | EFD_FLAG_C, close(fd));
+
+	ret_chk = eventfd_wait(fd, EFD_FLAG_A, EFD_WAIT_ANY, 0, NULL);
+	TC_ASSERT_EQ_CLEANUP("eventfd_wait", ret_chk, ERROR, close(fd));
+	TC_ASSERT_EQ_CLEANUP("eventfd_wait", errno, ETIMEDOUT, close(fd));
+
+	ret_chk = eventfd_clear(fd, EFD_FLAG_C);
+	TC_ASSERT_EQ_CLEANUP("eventfd_clear", ret_chk, OK, close(fd));
+
+	ret_chk = eventfd_read(fd, &value);
+	TC_ASSERT_EQ_CLEANUP("eventfd_read", ret_chk, OK, close(fd));
+	TC_ASSERT_EQ_CLEANUP("eventfd_read", value, EFD_FLAG_B, close(fd));
+
+	ret_chk = eventfd_read(fd, &value);
+	TC_ASSERT_EQ_CLEANUP("eventfd_read", ret_chk, ERROR, close(fd));
+	TC_ASSERT_EQ_CLEANUP("eventfd_read", errno, EAGAIN, close(fd));
+
+	close(fd);
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @fn                   :tc_eventfd_mkeventfd
+* @brief                :Sets named flags through another descriptor
+* @Scenario             :Flags set through one descriptor of named flags are read through
+*                        another one. The flags live until they are unlinked and closed.
+* API's covered         :mkeventfd, open, eventfd_write, eventfd_read, unlink
+* Preconditions         :none
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_eventfd_mkeventfd(void)
+{
+	eventfd_t value;
+	int ret_chk;
+	int rfd;
+	int wfd;
+
+	ret_chk = mkeventfd(EFD_PATH, 0666);
+	TC_ASSERT_EQ("mkeventfd", ret_chk, OK);
+
+	rfd = open(EFD_PATH, O_RDONLY | O_NONBLOCK);
+	TC_ASSERT_GEQ_CLEANUP("open", rfd, 0, unlink(EFD_PATH));
+	wfd = open(EFD_PATH, O_WRONLY);
+	TC_ASSERT_GEQ_CLEANUP("open", wfd, 0, close(rfd); unlink(EFD_PATH));
+
+	ret_chk = eventfd_write(wfd, EFD_FLAG_B);
+	close(wfd);
+	TC_ASSERT_EQ_CLEANUP("eventfd_write", ret_chk, OK, close(rfd); unlink(EFD_PATH));
+
+	/* Unlinked flags are still there for the descriptors open */
+
+	ret_chk = unlink(EFD_PATH);
+	TC_ASSERT_EQ_CLEANUP("unlink", ret_chk, OK, close(rfd));
+
+	ret_chk = eventfd_read(rfd, &value);
+	TC_ASSERT_EQ_CLEANUP("eventfd_read", ret_chk, OK, close(rfd));
+	TC_ASSERT_EQ_CLEANUP("eventfd_read", value, EFD_FLAG_B, close(rfd));
+	close(rfd);
+
+	ret_chk = open(EFD_PATH, O_RDONLY);
+	TC_ASSERT_EQ_CLEANUP("open", ret_chk, ERROR, close(ret_chk));
+
+	TC_SUCCESS_RESULT();
+}
+
+/****************************************************************************
+ * Name: eventfd
+ ****************************************************************************/
+
+int eventfd_main(void)
+{
+	tc_eventfd_wait_timeout();
+	tc_eventfd_wait_all();
+	tc_eventfd_clear();
+	tc_eventfd_mkeventfd();
+
+	return 0;
+}
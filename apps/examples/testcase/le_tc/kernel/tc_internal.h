@@ -60,6 +60,7 @@
 int clock_main(void);
 int environ_main(void);
 int errno_main(void);
+int eventfd_main(void);
 int group_main(void);
 int libc_fixedmath_main(void);
 int libc_inttypes_main(void);
@@ -66,6 +66,10 @@
 #include <signal.h>
 #endif
 #include <fcntl.h>
+#ifdef CONFIG_MQ_MSGPOOL
+#include <stdlib.h>
+#include <mqueue.h>
+#endif
 #include "tc_internal.h"
 
 /**************************************************************************
@@ -94,6 +98,21 @@
 
 #define HALF_SECOND_USEC_USEC   500000L
 
+#ifdef CONFIG_MQ_MSGPOOL
+/* A message larger than CONFIG_MQ_MAXMSGSIZE, which a queue with its own
+ * pool allows
+ */
+
+#define TEST_POOL_NMSGS     4
+#define TEST_POOL_MSGSIZE   (CONFIG_MQ_MAXMSGSIZE + 100)
+#define TEST_POOL_MAXSIZE   65535
+#endif
+
+#ifdef CONFIG_MQ_ZEROCOPY
+#define TEST_ZC_NMSGS       3
+#define TEST_ZC_MSGSIZE     64
+#endif
+
 #ifdef CONFIG_EXAMPLES_OSTEST_STACKSIZE
 #define STACKSIZE CONFIG_EXAMPLES_OSTEST_STACKSIZE
 #else
@@ -758,6 +777,207 @@ static void tc_mqueue_mq_unlink(void)
 	TC_SUCCESS_RESULT();
 }
 
+#ifdef CONFIG_MQ_MSGPOOL
+/**
+* @fn                   :tc_mqueue_mq_msgpool
+* @brief                :Sends and receives messages of a queue with its own pool of messages
+* @Scenario             :A queue of messages larger than CONFIG_MQ_MAXMSGSIZE takes mq_maxmsg
+*                        of them, then is full; they are received in order and intact. A
+*                        message size above 65535 bytes is refused.
+* API's covered         :mq_open, mq_send, mq_receive, mq_close, mq_unlink
+* Preconditions         :CONFIG_MQ_MSGPOOL
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_mqueue_mq_msgpool(void)
+{
+	struct mq_attr attr;
+	mqd_t mqdes;
+	char *msg;
+	int ret_chk;
+	int i;
+
+	msg = (char *)malloc(TEST_POOL_MSGSIZE);
+	TC_ASSERT_NEQ("malloc", msg, NULL);
+
+	attr.mq_maxmsg = TEST_POOL_NMSGS;
+	attr.mq_msgsize = TEST_POOL_MSGSIZE;
+	attr.mq_flags = 0;
+
+	mqdes = mq_open("mqpool", O_RDWR | O_CREAT | O_NONBLOCK, 0666, &attr);
+	TC_ASSERT_NEQ_CLEANUP("mq_open", mqdes, (mqd_t)ERROR, free(msg));
+
+	for (i = 0; i < TEST_POOL_NMSGS; i++) {
+		memset(msg, 'a' + i, TEST_POOL_MSGSIZE);
+		ret_chk = mq_send(mqdes, msg, TEST_POOL_MSGSIZE, 1);
+		TC_ASSERT_EQ_CLEANUP("mq_send", ret_chk, OK, goto cleanup);
+	}
+
+	/* The pool has no more messages, and the heap isn't used */
+
+	ret_chk = mq_send(mqdes, msg, TEST_POOL_MSGSIZE, 1);
+	TC_ASSERT_EQ_CLEANUP("mq_send", ret_chk, ERROR, goto cleanup);
+	TC_ASSERT_EQ_CLEANUP("mq_send", errno, EAGAIN, goto cleanup);
+
+	for (i = 0; i < TEST_POOL_NMSGS; i++) {
+		ret_chk = mq_receive(mqdes, msg, TEST_POOL_MSGSIZE, NULL);
+		TC_ASSERT_EQ_CLEANUP("mq_receive", ret_chk, TEST_POOL_MSGSIZE, goto cleanup);
+		TC_ASSERT_EQ_CLEANUP("mq_receive", msg[0], 'a' + i, goto cleanup);
+		TC_ASSERT_EQ_CLEANUP("mq_receive", msg[TEST_POOL_MSGSIZE - 1], 'a' + i, goto cleanup);
+	}
+
+	mq_close(mqdes);
+	mq_unlink("mqpool");
+
+	attr.mq_msgsize = TEST_POOL_MAXSIZE + 1;
+	mqdes = mq_open("mqpool", O_RDWR | O_CREAT, 0666, &attr);
+	TC_ASSERT_EQ_CLEANUP("mq_open", mqdes, (mqd_t)ERROR, mq_close(mqdes); mq_unlink("mqpool"); free(msg));
+
+	free(msg);
+	TC_SUCCESS_RESULT();
+	return;
+
+cleanup:
+	mq_close(mqdes);
+	mq_unlink("mqpool");
+	free(msg);
+}
+#endif
+
+#ifdef CONFIG_MQ_ZEROCOPY
+/**
+* @fn                   :tc_mqueue_mq_sendbuf_receivebuf
+* @brief                :Passes buffers through a zero-copy queue
+* @Scenario             :Buffers sent with mq_sendbuf() come back from mq_receivebuf() by
+*                        priority then in order, with the same address and length. mq_send()
+*                        and mq_receive() refuse the queue, and a full queue, a buffer too
+*                        large or one outside the heap are refused. Buffers still queued when
+*                        the queue is destroyed are freed.
+* API's covered         :mq_sendbuf, mq_receivebuf
+* Preconditions         :CONFIG_MQ_ZEROCOPY
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_mqueue_mq_sendbuf_receivebuf(void)
+{
+#ifndef CONFIG_BUILD_PROTECTED
+	static char static_buf[TEST_ZC_MSGSIZE];
+#endif
+	static const int prio[TEST_ZC_NMSGS] = { 1, 2, 1 };
+	static const int order[TEST_ZC_NMSGS] = { 1, 0, 2 };
+	char *buf[TEST_ZC_NMSGS] = { NULL };
+	struct mq_attr attr;
+	struct mallinfo before;
+	struct mallinfo after;
+	char msg[TEST_ZC_MSGSIZE];
+	void *rcvbuf;
+	mqd_t mqdes;
+	ssize_t len;
+	int rcvprio;
+	int ret_chk;
+	int i;
+
+	attr.mq_maxmsg = TEST_ZC_NMSGS;
+	attr.mq_msgsize = TEST_ZC_MSGSIZE;
+	attr.mq_flags = MQ_ZEROCOPY;
+
+	mqdes = mq_open("mqzc", O_RDWR | O_CREAT | O_NONBLOCK, 0666, &attr);
+	TC_ASSERT_NEQ("mq_open", mqdes, (mqd_t)ERROR);
+
+	/* The messages of a zero-copy queue are only buffers */
+
+	ret_chk = mq_send(mqdes, msg, sizeof(msg), 1);
+	TC_ASSERT_EQ_CLEANUP("mq_send", ret_chk, ERROR, goto cleanup);
+	TC_ASSERT_EQ_CLEANUP("mq_send", errno, EINVAL, goto cleanup);
+	ret_chk = mq_receive(mqdes, msg, sizeof(msg), NULL);
+	TC_ASSERT_EQ_CLEANUP("mq_receive", ret_chk, ERROR, goto cleanup);
+	TC_ASSERT_EQ_CLEANUP("mq_receive", errno, EINVAL, goto cleanup);
+
+	for (i = 0; i < TEST_ZC_NMSGS; i++) {
+		buf[i] = (char *)malloc(TEST_ZC_MSGSIZE);
+		TC_ASSERT_NEQ_CLEANUP("malloc", buf[i], NULL, goto cleanup);
+	}
+
+	ret_chk = mq_sendbuf(mqdes, buf[0], TEST_ZC_MSGSIZE + 1, 1);
+	TC_ASSERT_EQ_CLEANUP("mq_sendbuf", ret_chk, ERROR, goto cleanup);
+	TC_ASSERT_EQ_CLEANUP("mq_sendbuf", errno, EMSGSIZE, goto cleanup);
+#ifndef CONFIG_BUILD_PROTECTED
+	ret_chk = mq_sendbuf(mqdes, static_buf, TEST_ZC_MSGSIZE, 1);
+	TC_ASSERT_EQ_CLEANUP("mq_sendbuf", ret_chk, ERROR, goto cleanup);
+	TC_ASSERT_EQ_CLEANUP("mq_sendbuf", errno, EFAULT, goto cleanup);
+#endif
+
+	for (i = 0; i < TEST_ZC_NMSGS; i++) {
+		ret_chk = mq_sendbuf(mqdes, buf[i], TEST_ZC_MSGSIZE - i, prio[i]);
+		TC_ASSERT_EQ_CLEANUP("mq_sendbuf", ret_chk, OK, goto cleanup);
+	}
+
+	ret_chk = mq_sendbuf(mqdes, msg, TEST_ZC_MSGSIZE, 1);
+	TC_ASSERT_EQ_CLEANUP("mq_sendbuf", ret_chk, ERROR, goto cleanup_sent);
+	TC_ASSERT_EQ_CLEANUP("mq_sendbuf", errno, EAGAIN, goto cleanup_sent);
+
+	/* The receiver gets the buffers themselves, and owns them */
+
+	for (i = 0; i < TEST_ZC_NMSGS; i++) {
+		len = mq_receivebuf(mqdes, &rcvbuf, &rcvprio);
+		TC_ASSERT_EQ_CLEANUP("mq_receivebuf", len, TEST_ZC_MSGSIZE - order[i], goto cleanup_sent);
+		TC_ASSERT_EQ_CLEANUP("mq_receivebuf", rcvbuf, buf[order[i]], goto cleanup_sent);
+		TC_ASSERT_EQ_CLEANUP("mq_receivebuf", rcvprio, prio[order[i]], goto cleanup_sent);
+		free(rcvbuf);
+		buf[order[i]] = NULL;
+	}
+
+	len = mq_receivebuf(mqdes, &rcvbuf, NULL);
+	TC_ASSERT_EQ_CLEANUP("mq_receivebuf", len, ERROR, goto cleanup);
+	TC_ASSERT_EQ_CLEANUP("mq_receivebuf", errno, EAGAIN, goto cleanup);
+
+	mq_close(mqdes);
+	mq_unlink("mqzc");
+
+	/* The buffers nobody received are freed with the queue */
+
+#ifdef CONFIG_CAN_PASS_STRUCTS
+	before = mallinfo();
+#else
+	mallinfo(&before);
+#endif
+	mqdes = mq_open("mqzc", O_RDWR | O_CREAT | O_NONBLOCK, 0666, &attr);
+	TC_ASSERT_NEQ("mq_open", mqdes, (mqd_t)ERROR);
+	for (i = 0; i < TEST_ZC_NMSGS; i++) {
+		buf[i] = (char *)malloc(TEST_ZC_MSGSIZE);
+		TC_ASSERT_NEQ_CLEANUP("malloc", buf[i], NULL, goto cleanup);
+		ret_chk = mq_sendbuf(mqdes, buf[i], TEST_ZC_MSGSIZE, 1);
+		TC_ASSERT_EQ_CLEANUP("mq_sendbuf", ret_chk, OK, goto cleanup);
+		buf[i] = NULL;
+	}
+	mq_close(mqdes);
+	mq_unlink("mqzc");
+#ifdef CONFIG_CAN_PASS_STRUCTS
+	after = mallinfo();
+#else
+	mallinfo(&after);
+#endif
+	TC_ASSERT_EQ("mq_unlink", after.uordblks, before.uordblks);
+
+	TC_SUCCESS_RESULT();
+	return;
+
+cleanup_sent:
+	/* The queue owns the buffers sent */
+
+	for (i = 0; i < TEST_ZC_NMSGS; i++) {
+		buf[i] = NULL;
+	}
+
+cleanup:
+	mq_close(mqdes);
+	mq_unlink("mqzc");
+	for (i = 0; i < TEST_ZC_NMSGS; i++) {
+		free(buf[i]);
+	}
+}
+#endif
+
 /**
 * @fn                   :tc_mqueue_mq_timedsend_timedreceive_failurechecks
 * @description          :Function for tc_mqueue_mq_timedsend_timedreceive corner case checks
@@ -865,6 +1085,12 @@ int mqueue_main(void)
 	tc_mqueue_mq_timedsend_timedreceive();
 	tc_mqueue_mq_timedsend_timedreceive_failurechecks();
 	tc_mqueue_mq_unlink();
+#ifdef CONFIG_MQ_MSGPOOL
+	tc_mqueue_mq_msgpool();
+#endif
+#ifdef CONFIG_MQ_ZEROCOPY
+	tc_mqueue_mq_sendbuf_receivebuf();
+#endif
 
 	return 0;
 }
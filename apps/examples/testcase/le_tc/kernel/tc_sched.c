@@ -28,6 +28,8 @@
 #include <stdlib.h>
 #include <sched.h>
 #include <pthread.h>
+#include <semaphore.h>
+#include <unistd.h>
 #include <errno.h>
 #include <sys/wait.h>
 #include <sys/types.h>
@@ -47,12 +49,80 @@
 #define PID_IDLE        0
 #define TASK_CANCEL_INVALID  -1
 
+/* The threads of tc_sched_readytorun_order, of the priorities of
+ * g_rtr_prio, run between RTR_PRIO_LOW and RTR_PRIO_HIGH
+ */
+
+#define RTR_NTHREADS    6
+#define RTR_NROUNDS     3
+#define RTR_PRIO_LOW    100
+#define RTR_PRIO_HIGH   200
+#define RTR_WAIT_USEC   10000
+
 pthread_t thread1, thread2;
 
 pid_t g_task_pid;
 bool g_callback = false;
 bool g_pthread_callback = true;
 
+static const int g_rtr_prio[RTR_NTHREADS] = { 110, 130, 110, 150, 130, 110 };
+static sem_t g_rtr_sem[RTR_NTHREADS];
+static volatile int g_rtr_order[RTR_NTHREADS];
+static volatile int g_rtr_nran;
+
+/**
+* @fn                   :rtr_thread
+* @description          :Function for tc_sched_readytorun_order, records when it runs
+* @return               :void*
+*/
+static void *rtr_thread(void *param)
+{
+	int index = (int)param;
+	int round;
+
+	for (round = 0; round < RTR_NROUNDS; round++) {
+		if (round > 0) {
+			while (sem_wait(&g_rtr_sem[index]) != OK) ;
+		}
+		g_rtr_order[g_rtr_nran++] = index;
+	}
+
+	return NULL;
+}
+
+/**
+* @fn                   :rtr_check
+* @description          :Whether the threads ran by priority, then in the order they were made ready
+* @return               :bool
+*/
+static bool rtr_check(const int *ready)
+{
+	int expected[RTR_NTHREADS];
+	int n = 0;
+	int prio;
+	int i;
+
+	for (prio = RTR_PRIO_HIGH; prio > RTR_PRIO_LOW; prio--) {
+		for (i = 0; i < RTR_NTHREADS; i++) {
+			if (g_rtr_prio[ready[i]] == prio) {
+				expected[n++] = ready[i];
+			}
+		}
+	}
+
+	if (g_rtr_nran != RTR_NTHREADS || n != RTR_NTHREADS) {
+		return false;
+	}
+
+	for (i = 0; i < RTR_NTHREADS; i++) {
+		if (g_rtr_order[i] != expected[i]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
 /**
 * @fn                   :sched_foreach_callback
 * @description          :Function for tc_sched_sched_foreach
@@ -528,6 +598,109 @@ static void tc_sched_sched_lockcount(void)
 	TC_SUCCESS_RESULT();
 }
 
+/**
+* @fn                   :tc_sched_readytorun_order
+* @brief                :Threads run by priority, then in the order they are made ready
+* @scenario             :Threads of mixed priorities are made ready by their creation, then
+*                        by semaphores posted in another order, both while a thread of higher
+*                        priority runs and, through the pending list, while a thread of lower
+*                        priority holds the scheduler lock. Each time, they run from the
+*                        highest priority to the lowest, and in the order they were made
+*                        ready for the same priority.
+* API's covered         :pthread_create, sem_post, sched_lock, sched_unlock
+* Preconditions         :none
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_sched_readytorun_order(void)
+{
+	static const int created[RTR_NTHREADS] = { 0, 1, 2, 3, 4, 5 };
+	static const int posted[RTR_NTHREADS] = { 5, 0, 3, 1, 4, 2 };
+	static const int pending[RTR_NTHREADS] = { 2, 4, 0, 5, 3, 1 };
+	pthread_t thread[RTR_NTHREADS];
+	struct sched_param saved;
+	struct sched_param param;
+	pthread_attr_t attr;
+	bool ordered[3] = { false, false, false };
+	int policy;
+	int ret_chk;
+	int i;
+
+	ret_chk = sched_getparam(0, &saved);
+	TC_ASSERT_EQ("sched_getparam", ret_chk, OK);
+	policy = sched_getscheduler(0);
+
+	param.sched_priority = RTR_PRIO_HIGH;
+	ret_chk = sched_setparam(0, &param);
+	TC_ASSERT_EQ("sched_setparam", ret_chk, OK);
+
+	pthread_attr_init(&attr);
+	pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+	pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+
+	/* Created one after the other, below the priority of this thread */
+
+	g_rtr_nran = 0;
+	for (i = 0; i < RTR_NTHREADS; i++) {
+		sem_init(&g_rtr_sem[i], 0, 0);
+		param.sched_priority = g_rtr_prio[i];
+		pthread_attr_setschedparam(&attr, &param);
+		ret_chk = pthread_create(&thread[i], &attr, rtr_thread, (void *)created[i]);
+		if (ret_chk != OK) {
+			break;
+		}
+	}
+	pthread_attr_destroy(&attr);
+
+	if (i < RTR_NTHREADS) {
+		while (i-- > 0) {
+			pthread_cancel(thread[i]);
+			pthread_join(thread[i], NULL);
+		}
+		sched_setparam(0, &saved);
+		TC_ASSERT_EQ("pthread_create", ret_chk, OK);
+	}
+
+	usleep(RTR_WAIT_USEC);
+	ordered[0] = rtr_check(created);
+
+	/* Woken up in another order, still below this thread */
+
+	g_rtr_nran = 0;
+	for (i = 0; i < RTR_NTHREADS; i++) {
+		sem_post(&g_rtr_sem[posted[i]]);
+	}
+	usleep(RTR_WAIT_USEC);
+	ordered[1] = rtr_check(posted);
+
+	/* Woken up above this thread while it holds the lock, so they all wait
+	 * in the pending list until it unlocks
+	 */
+
+	param.sched_priority = RTR_PRIO_LOW;
+	sched_setparam(0, &param);
+
+	g_rtr_nran = 0;
+	sched_lock();
+	for (i = 0; i < RTR_NTHREADS; i++) {
+		sem_post(&g_rtr_sem[pending[i]]);
+	}
+	sched_unlock();
+	ordered[2] = rtr_check(pending);
+
+	for (i = 0; i < RTR_NTHREADS; i++) {
+		pthread_join(thread[i], NULL);
+		sem_destroy(&g_rtr_sem[i]);
+	}
+	sched_setscheduler(0, policy, &saved);
+
+	TC_ASSERT_EQ("pthread_create", ordered[0], true);
+	TC_ASSERT_EQ("sem_post", ordered[1], true);
+	TC_ASSERT_EQ("sched_unlock", ordered[2], true);
+
+	TC_SUCCESS_RESULT();
+}
+
 #if CONFIG_NFILE_STREAMS > 0
 /**
 * @fn                   :tc_sched_sched_getstreams
@@ -695,6 +868,7 @@ int sched_main(void)
 	tc_sched_sched_self();
 	tc_sched_sched_foreach();
 	tc_sched_sched_lockcount();
+	tc_sched_readytorun_order();
 #if CONFIG_NFILE_STREAMS > 0
 	tc_sched_sched_getstreams();
 #endif
@@ -32,6 +32,13 @@
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
+#ifdef CONFIG_TASK_POOL
+#include <stdbool.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/ioctl.h>
+#include <tinyara/testcase_drv.h>
+#endif
 #include "tc_internal.h"
 
 #define TEST_STRING     "test"
@@ -44,7 +51,26 @@
 #define PR_INVALID      -1
 #define PID_INVALID     -1
 
+#ifdef CONFIG_TASK_POOL
+#define POOL_NCLASSES   3
+#define POOL_NSLOTS     (CONFIG_TASK_POOL_SMALL_NSLOTS + CONFIG_TASK_POOL_MEDIUM_NSLOTS + CONFIG_TASK_POOL_LARGE_NSLOTS)
+#define POOL_HUGE_STACK (16 * 1024 * 1024)
+#endif
+
 static int g_callback;
+#ifdef CONFIG_TASK_POOL
+static const size_t g_pool_stacksize[POOL_NCLASSES] = {
+	CONFIG_TASK_POOL_SMALL_STACKSIZE,
+	CONFIG_TASK_POOL_MEDIUM_STACKSIZE,
+	CONFIG_TASK_POOL_LARGE_STACKSIZE
+};
+static const int g_pool_nslots[POOL_NCLASSES] = {
+	CONFIG_TASK_POOL_SMALL_NSLOTS,
+	CONFIG_TASK_POOL_MEDIUM_NSLOTS,
+	CONFIG_TASK_POOL_LARGE_NSLOTS
+};
+static sem_t g_pool_sem;
+#endif
 #ifndef CONFIG_BUILD_PROTECTED
 static volatile int task_cnt;
 static volatile pid_t ppid;
@@ -170,6 +196,145 @@ static int getpid_task(int argc, char *argv[])
 	return OK;
 }
 
+#ifdef CONFIG_TASK_POOL
+/**
+* @fn                   :pool_thread
+* @brief                :utility function for tc_task_pool, keeps its TCB until g_pool_sem is posted
+* @return               :pthread_addr_t
+*/
+static pthread_addr_t pool_thread(pthread_addr_t arg)
+{
+	sem_wait(&g_pool_sem);
+	return NULL;
+}
+
+/**
+* @fn                   :pool_round
+* @brief                :utility function for tc_task_pool, creates nthreads threads of stacksize
+*                        running at once, then waits until their TCBs are released
+* @return               :the number of threads which got a TCB of the pool, or ERROR if one of
+*                        them couldn't be created; *last tells whether the last one did
+*/
+static int pool_round(size_t stacksize, int nthreads, bool *last)
+{
+	pthread_t threads[POOL_NSLOTS + 1];
+	pthread_attr_t attr;
+	int fd = tc_get_drvfd();
+	int member = 0;
+	int npooled = 0;
+	int ncreated;
+	int i;
+
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, stacksize);
+	for (ncreated = 0; ncreated < nthreads; ncreated++) {
+		if (pthread_create(&threads[ncreated], &attr, pool_thread, NULL) != OK) {
+			break;
+		}
+		member = ioctl(fd, TESTIOC_TASK_POOL_MEMBER, threads[ncreated]);
+		if (member > 0) {
+			npooled++;
+		}
+	}
+	*last = (member > 0);
+
+	for (i = 0; i < ncreated; i++) {
+		sem_post(&g_pool_sem);
+	}
+	for (i = 0; i < ncreated; i++) {
+		pthread_join(threads[i], NULL);
+		while (ioctl(fd, TESTIOC_IS_ALIVE_THREAD, threads[i]) == OK) {
+			usleep(USEC_10);
+		}
+	}
+
+	return ncreated == nthreads ? npooled : ERROR;
+}
+
+/**
+* @fn                   :tc_task_pool
+* @brief                :Creates threads from the pool of TCBs and stacks of CONFIG_TASK_POOL
+* @Scenario             :For the stack size of each class, creates one thread more than the slots
+*                        of the classes large enough: some take slots, the last one takes a TCB
+*                        and a stack of the heap, and all slots are back once they exit. A stack no
+*                        class holds fails to be allocated with ENOMEM, and the TCBs of the pool
+*                        released by failing pthread_create() and task_create() go back to the pool.
+* API's covered         :pthread_create, task_create
+* Preconditions         :none
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_task_pool(void)
+{
+	pthread_attr_t attr;
+	pthread_t thread;
+	bool last;
+	int capacity;
+	int npooled;
+	int nref;
+	int ret_chk;
+	int i;
+	int j;
+
+	sem_init(&g_pool_sem, 0, 0);
+
+	nref = pool_round(CONFIG_TASK_POOL_SMALL_STACKSIZE, POOL_NSLOTS + 1, &last);
+	TC_ASSERT_GT_CLEANUP("pthread_create", nref, 0, sem_destroy(&g_pool_sem));
+
+	for (i = 0; i < POOL_NCLASSES; i++) {
+		if (g_pool_nslots[i] == 0) {
+			continue;
+		}
+
+		capacity = 0;
+		for (j = 0; j < POOL_NCLASSES; j++) {
+			if (g_pool_stacksize[j] >= g_pool_stacksize[i]) {
+				capacity += g_pool_nslots[j];
+			}
+		}
+
+		/* The classes large enough are exhausted, then the heap is used */
+
+		npooled = pool_round(g_pool_stacksize[i], capacity + 1, &last);
+		TC_ASSERT_GT_CLEANUP("pthread_create", npooled, 0, sem_destroy(&g_pool_sem));
+		TC_ASSERT_LEQ_CLEANUP("pthread_create", npooled, capacity, sem_destroy(&g_pool_sem));
+		TC_ASSERT_EQ_CLEANUP("pthread_create", last, false, sem_destroy(&g_pool_sem));
+
+		/* The threads which exited gave their slots back */
+
+		ret_chk = pool_round(g_pool_stacksize[i], capacity + 1, &last);
+		TC_ASSERT_EQ_CLEANUP("pthread_create", ret_chk, npooled, sem_destroy(&g_pool_sem));
+	}
+
+	/* up_create_stack() fails for a stack of the heap too large */
+
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, POOL_HUGE_STACK);
+	ret_chk = pthread_create(&thread, &attr, pool_thread, NULL);
+	TC_ASSERT_EQ_CLEANUP("pthread_create", ret_chk, ENOMEM, sem_destroy(&g_pool_sem));
+
+	/* A TCB of the pool is released by sched_releasetcb() on an invalid priority */
+
+	pthread_attr_setstacksize(&attr, CONFIG_TASK_POOL_SMALL_STACKSIZE);
+	attr.inheritsched = PTHREAD_EXPLICIT_SCHED;
+	attr.priority = SCHED_PRIORITY_MAX + 1;
+	ret_chk = pthread_create(&thread, &attr, pool_thread, NULL);
+	TC_ASSERT_EQ_CLEANUP("pthread_create", ret_chk, EINVAL, sem_destroy(&g_pool_sem));
+
+	ret_chk = task_create("tc_pool", SCHED_PRIORITY_MAX + 1, CONFIG_TASK_POOL_SMALL_STACKSIZE, getpid_task, (char * const *)NULL);
+	TC_ASSERT_EQ_CLEANUP("task_create", ret_chk, ERROR, sem_destroy(&g_pool_sem));
+	TC_ASSERT_EQ_CLEANUP("task_create", get_errno(), EINVAL, sem_destroy(&g_pool_sem));
+
+	/* None of the failures kept a slot */
+
+	ret_chk = pool_round(CONFIG_TASK_POOL_SMALL_STACKSIZE, POOL_NSLOTS + 1, &last);
+	TC_ASSERT_EQ_CLEANUP("pthread_create", ret_chk, nref, sem_destroy(&g_pool_sem));
+
+	sem_destroy(&g_pool_sem);
+	TC_SUCCESS_RESULT();
+}
+#endif
+
 /**
 * @fn                   :tc_task_task_create
 * @brief                :Creates a task with the arguments provided like taskname,Priority,stacksize and function name
@@ -429,6 +594,9 @@ int task_main(void)
 	tc_task_task_create();
 	tc_task_task_delete();
 	tc_task_task_restart();
+#ifdef CONFIG_TASK_POOL
+	tc_task_pool();
+#endif
 
 	return 0;
 }
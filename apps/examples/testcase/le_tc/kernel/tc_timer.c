@@ -23,11 +23,28 @@
 #include <errno.h>
 #include <sys/ioctl.h>
 #include <tinyara/testcase_drv.h>
+#include <string.h>
+#include <tinyara/clock.h>
+#ifdef CONFIG_HRTIMER
+#include <tinyara/hrtimer.h>
+#endif
 #include "../../os/kernel/timer/timer.h"
 #include "tc_internal.h"
 
 #define USECINT 10000000
 
+/* The levels of the watchdog timer wheel begin at 64 and 4096 ticks; the
+ * second one is only tested when it takes a few seconds at most.
+ */
+
+#define WDOG_LEVEL1 64
+#define WDOG_LEVEL2 4096
+#if USEC_PER_TICK <= 1000
+#define WDOG_LEVEL2_TEST WDOG_LEVEL2
+#else
+#define WDOG_LEVEL2_TEST 0
+#endif
+
 int sig_no = SIGRTMIN;
 extern volatile sq_queue_t g_freetimers;
 extern volatile sq_queue_t g_alloctimers;
@@ -91,7 +108,11 @@ static void tc_timer_timer_create_delete(void)
 	TC_ASSERT_EQ_CLEANUP("timer_create", st_ret_prt->pt_signo, st_sigevent.sigev_signo, timer_delete(timer_id));
 	TC_ASSERT_EQ_CLEANUP("timer_create", st_ret_prt->pt_crefs, 1, timer_delete(timer_id));
 	TC_ASSERT_EQ_CLEANUP("timer_create", st_ret_prt->pt_owner, getpid(), timer_delete(timer_id));
+#ifdef CONFIG_HRTIMER
+	TC_ASSERT_EQ_CLEANUP("timer_create", st_ret_prt->pt_interval, 0, timer_delete(timer_id));
+#else
 	TC_ASSERT_EQ_CLEANUP("timer_create", st_ret_prt->pt_delay, 0, timer_delete(timer_id));
+#endif
 
 	st_timer_spec_val.it_value.tv_sec = 1;
 	st_timer_spec_val.it_value.tv_nsec = 0;
@@ -113,7 +134,11 @@ static void tc_timer_timer_create_delete(void)
 	TC_ASSERT_EQ_CLEANUP("timer_create", st_ret_prt->pt_value.sival_ptr, st_ret_prt, timer_delete(gtimer_id));
 	TC_ASSERT_EQ_CLEANUP("timer_create", st_ret_prt->pt_crefs, 1, timer_delete(gtimer_id));
 	TC_ASSERT_EQ_CLEANUP("timer_create", st_ret_prt->pt_owner, getpid(), timer_delete(gtimer_id));
+#ifdef CONFIG_HRTIMER
+	TC_ASSERT_EQ_CLEANUP("timer_create", st_ret_prt->pt_interval, 0, timer_delete(gtimer_id));
+#else
 	TC_ASSERT_EQ_CLEANUP("timer_create", st_ret_prt->pt_delay, 0, timer_delete(gtimer_id));
+#endif
 
 	ret_chk = timer_delete(gtimer_id);
 	TC_ASSERT_NEQ("timer_delete", ret_chk, ERROR);
@@ -331,6 +356,122 @@ static void tc_timer_timer_initialize(void)
 	TC_SUCCESS_RESULT();
 }
 
+/**
+* @fn                   :tc_timer_wdog_expiry
+* @brief                :Expiration of watchdogs across the levels of the timer wheel
+* @Scenario             :Watchdogs started in the same tick, on either side of the
+*                        boundaries between the levels of the timer wheel, are called in
+*                        the tick of their expiration once cascaded to the lowest level.
+*                        Cancelling one of them leaves the others to expire.
+* API's covered         :wd_start, wd_cancel
+* Preconditions         :none
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_timer_wdog_expiry(void)
+{
+	static const int32_t delays[TESTIOC_WDOG_NWDOGS] = {
+		1, WDOG_LEVEL1 - 1, WDOG_LEVEL1, WDOG_LEVEL1 + 1, 2 * WDOG_LEVEL1 - 1, 2 * WDOG_LEVEL1, 2 * WDOG_LEVEL1 + 1, WDOG_LEVEL2_TEST
+	};
+	struct testioc_wdog_s test;
+	int ret_chk;
+	int i;
+
+	memset(&test, 0, sizeof(test));
+	memcpy(test.delay, delays, sizeof(delays));
+	test.cancel = -1;
+
+	ret_chk = ioctl(tc_get_drvfd(), TESTIOC_WDOG_EXPIRY, (unsigned long)&test);
+	TC_ASSERT_EQ("ioctl", ret_chk, OK);
+	for (i = 0; i < TESTIOC_WDOG_NWDOGS; i++) {
+		if (delays[i] == 0) {
+			continue;
+		}
+		TC_ASSERT_EQ("wd_start", test.called[i], true);
+		TC_ASSERT_GEQ("wd_start", test.late[i], 0);
+		TC_ASSERT_LEQ("wd_start", test.late[i], 1);
+	}
+
+	/* Cancel a watchdog sharing the slot of higher levels with others */
+
+	memset(&test, 0, sizeof(test));
+	test.delay[0] = WDOG_LEVEL1;
+	test.delay[1] = WDOG_LEVEL1 + 1;
+	test.delay[2] = WDOG_LEVEL1 + 2;
+	test.cancel = 1;
+
+	ret_chk = ioctl(tc_get_drvfd(), TESTIOC_WDOG_EXPIRY, (unsigned long)&test);
+	TC_ASSERT_EQ("ioctl", ret_chk, OK);
+	TC_ASSERT_EQ("wd_cancel", test.called[0], true);
+	TC_ASSERT_EQ("wd_cancel", test.called[1], false);
+	TC_ASSERT_EQ("wd_cancel", test.called[2], true);
+	TC_ASSERT_LEQ("wd_cancel", test.late[0], 1);
+	TC_ASSERT_LEQ("wd_cancel", test.late[2], 1);
+
+	TC_SUCCESS_RESULT();
+}
+
+#ifdef CONFIG_HRTIMER
+/**
+* @fn                   :tc_timer_hrtimer_expiry
+* @brief                :Expiration of high resolution timers
+* @Scenario             :Timers started out of order are called in the order of their
+*                        expirations, never before them, and from the timer interrupt
+*                        within a tick of them. A cancelled timer is never called, and
+*                        the others still are. With HPWORK, a timer can also be called
+*                        from the HPWORK thread.
+* API's covered         :hrtimer_start, hrtimer_cancel, hrtimer_gettime
+* Preconditions         :CONFIG_HRTIMER
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_timer_hrtimer_expiry(void)
+{
+	struct testioc_hrtimer_s test;
+	int ret_chk;
+	int i;
+
+	memset(&test, 0, sizeof(test));
+	test.delay[0] = 3 * NSEC_PER_MSEC;
+	test.delay[1] = 1 * NSEC_PER_MSEC + 500 * NSEC_PER_USEC;
+	test.delay[2] = 2 * NSEC_PER_MSEC;
+
+	ret_chk = ioctl(tc_get_drvfd(), TESTIOC_HRTIMER_EXPIRY, (unsigned long)&test);
+	TC_ASSERT_EQ("ioctl", ret_chk, OK);
+	TC_ASSERT_EQ("hrtimer_start", test.seq[0], 2);
+	TC_ASSERT_EQ("hrtimer_start", test.seq[1], 0);
+	TC_ASSERT_EQ("hrtimer_start", test.seq[2], 1);
+	for (i = 0; i < TESTIOC_HRTIMER_NTIMERS; i++) {
+		TC_ASSERT_GEQ("hrtimer_start", test.late[i], 0);
+		TC_ASSERT_LT("hrtimer_start", test.late[i], NSEC_PER_TICK);
+	}
+
+	memset(&test, 0, sizeof(test));
+	test.delay[0] = 1 * NSEC_PER_MSEC;
+	test.delay[1] = 2 * NSEC_PER_MSEC;
+	test.cancel = true;
+
+	ret_chk = ioctl(tc_get_drvfd(), TESTIOC_HRTIMER_EXPIRY, (unsigned long)&test);
+	TC_ASSERT_EQ("ioctl", ret_chk, OK);
+	TC_ASSERT_EQ("hrtimer_cancel", test.seq[0], -1);
+	TC_ASSERT_EQ("hrtimer_cancel", test.seq[1], 0);
+	TC_ASSERT_GEQ("hrtimer_cancel", test.late[1], 0);
+
+#ifdef CONFIG_SCHED_HPWORK
+	memset(&test, 0, sizeof(test));
+	test.delay[0] = 1 * NSEC_PER_MSEC;
+	test.flags = HRTIMER_THREAD;
+
+	ret_chk = ioctl(tc_get_drvfd(), TESTIOC_HRTIMER_EXPIRY, (unsigned long)&test);
+	TC_ASSERT_EQ("ioctl", ret_chk, OK);
+	TC_ASSERT_EQ("hrtimer_start", test.seq[0], 0);
+	TC_ASSERT_GEQ("hrtimer_start", test.late[0], 0);
+#endif
+
+	TC_SUCCESS_RESULT();
+}
+#endif
+
 /****************************************************************************
  * Name: timer
  ****************************************************************************/
@@ -343,6 +484,10 @@ int timer_main(void)
 #endif                     /* CONFIG_DISABLE_POSIX_TIMERS */
 	tc_timer_timer_set_get_time();
 	tc_timer_timer_initialize();
+	tc_timer_wdog_expiry();
+#ifdef CONFIG_HRTIMER
+	tc_timer_hrtimer_expiry();
+#endif
 
 	return 0;
 }
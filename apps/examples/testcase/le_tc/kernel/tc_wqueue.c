@@ -27,6 +27,9 @@
 #include <tinyara/clock.h>
 #include <tinyara/wqueue.h>
 #include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
 #include <sys/types.h>
 #include "tc_internal.h"
 
@@ -35,11 +38,25 @@
 **************************************************************************/
 #if defined(CONFIG_SCHED_WORKQUEUE) || defined(CONFIG_LIB_USRWORK)
 
+/* The pool is only reached by the low priority work queued in the flat
+ * build; the other builds redirect LPWORK to the user-mode queue.
+ */
+
+#if defined(CONFIG_SCHED_WORKPOOL) && defined(CONFIG_BUILD_FLAT)
+#define WQ_POOL_NWORKS 3
+#define WQ_POOL_DELAY  MSEC2TICK(50)
+#define WQ_POOL_WAIT   (2 * WQ_POOL_DELAY * USEC_PER_TICK)
+#endif
+
 /**************************************************************************
 * Private Variables
 **************************************************************************/
 
 static clock_t start_time;
+#if defined(CONFIG_SCHED_WORKPOOL) && defined(CONFIG_BUILD_FLAT)
+static struct work_s g_pool_work[WQ_POOL_NWORKS];
+static volatile uint32_t g_pool_ran;
+#endif
 
 /**************************************************************************
 * Private Functions
@@ -64,6 +81,13 @@ static void wq_test3(void *arg)
 	cur_time = clock();
 	printf("workqueue_test 3 : test 3 requested delay is (%u) ticks, executed delay is (%llu) ticks.\n", (uint32_t)arg, (uint64_t)cur_time - (uint64_t)start_time);
 }
+
+#if defined(CONFIG_SCHED_WORKPOOL) && defined(CONFIG_BUILD_FLAT)
+static void wq_pool_work(void *arg)
+{
+	g_pool_ran |= (uint32_t)arg;
+}
+#endif
 /**************************************************************************
 * Public Functions
 **************************************************************************/
@@ -108,6 +132,66 @@ cleanup:
 	TC_SUCCESS_RESULT();
 }
 #endif
+
+#if defined(CONFIG_SCHED_WORKPOOL) && defined(CONFIG_BUILD_FLAT)
+/**
+* @fn                   :tc_wqueue_workpool_cancel
+* @brief                :Cancels delayed work of the low priority work pool
+* @Scenario             :A delayed work which is cancelled never runs, and can be queued again
+*                        and then runs once. Among delayed works with the same delay, only the
+*                        cancelled one does not run. Cancelling a work not queued, or queueing
+*                        one already queued, fails.
+* API's covered         :work_queue, work_cancel
+* Preconditions         :CONFIG_SCHED_WORKPOOL
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_wqueue_workpool_cancel(void)
+{
+	int result;
+	int i;
+
+	memset(g_pool_work, 0, sizeof(g_pool_work));
+	g_pool_ran = 0;
+
+	result = work_queue(LPWORK, &g_pool_work[0], wq_pool_work, (void *)(1 << 0), WQ_POOL_DELAY);
+	TC_ASSERT_EQ("work_queue", result, OK);
+	result = work_queue(LPWORK, &g_pool_work[0], wq_pool_work, (void *)(1 << 0), WQ_POOL_DELAY);
+	TC_ASSERT_EQ_CLEANUP("work_queue", result, -EALREADY, work_cancel(LPWORK, &g_pool_work[0]));
+	result = work_cancel(LPWORK, &g_pool_work[0]);
+	TC_ASSERT_EQ("work_cancel", result, OK);
+	result = work_cancel(LPWORK, &g_pool_work[0]);
+	TC_ASSERT_EQ("work_cancel", result, -ENOENT);
+
+	usleep(WQ_POOL_WAIT);
+	TC_ASSERT_EQ("work_cancel", g_pool_ran, 0);
+
+	/* The cancelled work is free to be queued again */
+
+	result = work_queue(LPWORK, &g_pool_work[0], wq_pool_work, (void *)(1 << 0), WQ_POOL_DELAY);
+	TC_ASSERT_EQ("work_queue", result, OK);
+	usleep(WQ_POOL_WAIT);
+	TC_ASSERT_EQ("work_queue", g_pool_ran, 1 << 0);
+	result = work_cancel(LPWORK, &g_pool_work[0]);
+	TC_ASSERT_EQ("work_cancel", result, -ENOENT);
+
+	/* Cancel the work in the middle of others with the same delay */
+
+	g_pool_ran = 0;
+	for (i = 0; i < WQ_POOL_NWORKS; i++) {
+		result = work_queue(LPWORK, &g_pool_work[i], wq_pool_work, (void *)(1 << i), WQ_POOL_DELAY);
+		TC_ASSERT_EQ("work_queue", result, OK);
+	}
+
+	result = work_cancel(LPWORK, &g_pool_work[1]);
+	TC_ASSERT_EQ("work_cancel", result, OK);
+	usleep(WQ_POOL_WAIT);
+	TC_ASSERT_EQ("work_cancel", g_pool_ran, (1 << 0) | (1 << 2));
+
+	TC_SUCCESS_RESULT();
+}
+#endif
+
 /****************************************************************************
  * Name: mqueue
  ****************************************************************************/
@@ -115,6 +199,9 @@ int wqueue_main(void)
 {
 #if defined(CONFIG_SCHED_HPWORK) || defined(CONFIG_SCHED_LPWORK)
 	tc_wqueue_work_queue_cancel();
+#endif
+#if defined(CONFIG_SCHED_WORKPOOL) && defined(CONFIG_BUILD_FLAT)
+	tc_wqueue_workpool_cancel();
 #endif
 	return 0;
 }
@@ -24,6 +24,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <semaphore.h>
+#include <pthread.h>
 #include <arastorage/arastorage.h>
 #include <tinyara/fs/fs_utils.h>
 #include "tc_common.h"
@@ -44,6 +45,10 @@
 #define DATA_SET_NUM    10
 #define DATA_SET_MULTIPLIER 80
 
+/* First ids of the tuples inserted by transactions */
+#define TRANSACTION_ID  2000
+#define BATCH_ID        3000
+
 /****************************************************************************
  *  Global Variables
  ****************************************************************************/
@@ -87,6 +92,43 @@ static void check_query_result(char * query)
 	g_cursor = NULL;
 }
 
+/* Number of tuples selected by a query, INVALID_CURSOR_VALUE if it fails */
+static tuple_id_t get_query_count(char *query)
+{
+	db_cursor_t *cursor;
+	tuple_id_t count;
+
+	cursor = db_query(query);
+	if (cursor == NULL) {
+		return INVALID_CURSOR_VALUE;
+	}
+	count = cursor_get_count(cursor);
+	db_cursor_free(cursor);
+	return count;
+}
+
+/* Binds the tuples of RELATION_NAME2 inserted by db_exec_prepared_rows() */
+static db_result_t bind_transaction_row(db_stmt_t *stmt, int row, void *arg)
+{
+	db_result_t res;
+
+	res = db_bind_int(stmt, 1, *(int *)arg + row);
+	if (DB_ERROR(res)) {
+		return res;
+	}
+	return db_bind_long(stmt, 2, g_arastorage_data_set[row % DATA_SET_NUM].long_value);
+}
+
+static void *transaction_insert_thread(void *arg)
+{
+	char query[QUERY_LENGTH];
+
+	snprintf(query, QUERY_LENGTH, "INSERT (%d, %ld) INTO %s;", BATCH_ID + DATA_SET_NUM,
+			 g_arastorage_data_set[0].long_value, RELATION_NAME2);
+	*(db_result_t *)arg = db_exec(query);
+	return NULL;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -422,6 +464,13 @@ static void utc_arastorage_db_query_p(void)
 	snprintf(query, QUERY_LENGTH, "SELECT MIN(id) FROM %s;", RELATION_NAME2);
 	check_query_result(query);
 
+	/* Aggregation operations over the range of bplus-tree index */
+	snprintf(query, QUERY_LENGTH, "SELECT MAX(date) FROM %s WHERE date >= 2000 AND date <= 8000;", RELATION_NAME2);
+	check_query_result(query);
+
+	snprintf(query, QUERY_LENGTH, "SELECT COUNT(date) FROM %s WHERE date >= 2000 AND date <= 8000;", RELATION_NAME2);
+	check_query_result(query);
+
 	/* Remove operation */
 	snprintf(query, QUERY_LENGTH, "REMOVE FROM %s WHERE date > 2000 AND date < 8000;", RELATION_NAME2);
 	check_query_result(query);
@@ -464,6 +513,260 @@ static void utc_arastorage_db_query_n(void)
 	TC_SUCCESS_RESULT();
 }
 
+/**
+* @testcase         utc_arastorage_db_prepare_p
+* @brief            Execute prepared statements with bound parameters
+* @scenario         Insert tuples and select them again with statements parsed once
+* @apicovered       db_prepare, db_bind_int, db_bind_long, db_exec_prepared, db_query_prepared, db_finalize
+* @precondition     utc_arastorage_db_exec_p should be passed
+* @postcondition    none
+*/
+static void utc_arastorage_db_prepare_p(void)
+{
+	db_result_t res;
+	db_stmt_t *stmt;
+	char query[QUERY_LENGTH];
+	int i;
+
+	snprintf(query, QUERY_LENGTH, "INSERT (?, ?) INTO %s;", RELATION_NAME2);
+	stmt = db_prepare(query);
+	TC_ASSERT_NEQ("db_prepare", stmt, NULL);
+
+	for (i = 0; i < DATA_SET_NUM; i++) {
+		res = db_bind_int(stmt, 1, 1000 + i);
+		TC_ASSERT_EQ_CLEANUP("db_bind_int", DB_SUCCESS(res), true, db_finalize(stmt));
+		res = db_bind_long(stmt, 2, g_arastorage_data_set[i].long_value);
+		TC_ASSERT_EQ_CLEANUP("db_bind_long", DB_SUCCESS(res), true, db_finalize(stmt));
+		res = db_exec_prepared(stmt);
+		TC_ASSERT_EQ_CLEANUP("db_exec_prepared", DB_SUCCESS(res), true, db_finalize(stmt));
+	}
+
+	res = db_finalize(stmt);
+	TC_ASSERT_EQ("db_finalize", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "SELECT %s, %s FROM %s WHERE %s >= ? AND %s < ?;", g_attribute_set[0],
+			 g_attribute_set[1], RELATION_NAME2, g_attribute_set[0], g_attribute_set[0]);
+	stmt = db_prepare(query);
+	TC_ASSERT_NEQ("db_prepare", stmt, NULL);
+
+	/* The same statement is executed again with other values */
+	for (i = 0; i < DATA_SET_NUM; i += 5) {
+		db_bind_int(stmt, 1, 1000 + i);
+		db_bind_int(stmt, 2, 1000 + i + 5);
+		g_cursor = db_query_prepared(stmt);
+		TC_ASSERT_NEQ_CLEANUP("db_query_prepared", g_cursor, NULL, db_finalize(stmt));
+		TC_ASSERT_EQ_CLEANUP("cursor_get_count", cursor_get_count(g_cursor), 5, db_cursor_free(g_cursor); db_finalize(stmt));
+
+		res = db_cursor_free(g_cursor);
+		TC_ASSERT_EQ_CLEANUP("db_cursor_free", DB_SUCCESS(res), true, db_finalize(stmt));
+		g_cursor = NULL;
+	}
+
+	res = db_finalize(stmt);
+	TC_ASSERT_EQ("db_finalize", DB_SUCCESS(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_rollback_p
+* @brief            Roll back a transaction of inserts
+* @scenario         Insert tuples in a transaction, roll it back and select them by a scan and by an index
+* @apicovered       db_begin, db_exec, db_rollback
+* @precondition     utc_arastorage_db_prepare_p should be passed
+* @postcondition    none
+*/
+static void utc_arastorage_db_rollback_p(void)
+{
+	db_result_t res;
+	char query[QUERY_LENGTH];
+	int i;
+
+	res = db_begin();
+	TC_ASSERT_EQ("db_begin", DB_SUCCESS(res), true);
+
+	/* The dates of the tuples of utc_arastorage_db_prepare_p, with other ids */
+	for (i = 0; i < DATA_SET_NUM; i++) {
+		snprintf(query, QUERY_LENGTH, "INSERT (%d, %ld) INTO %s;", TRANSACTION_ID + i,
+				 g_arastorage_data_set[i].long_value, RELATION_NAME2);
+		res = db_exec(query);
+		TC_ASSERT_EQ_CLEANUP("db_exec", DB_SUCCESS(res), true, db_rollback());
+	}
+
+	res = db_rollback();
+	TC_ASSERT_EQ("db_rollback", DB_SUCCESS(res), true);
+
+	/* Scan */
+	snprintf(query, QUERY_LENGTH, "SELECT %s, %s FROM %s WHERE %s >= 1000;", g_attribute_set[0],
+			 g_attribute_set[1], RELATION_NAME2, g_attribute_set[0]);
+	TC_ASSERT_EQ("cursor_get_count", get_query_count(query), DATA_SET_NUM);
+
+	/* Search of the bplustree index */
+	snprintf(query, QUERY_LENGTH, "SELECT %s, %s FROM %s WHERE %s >= %ld;", g_attribute_set[0],
+			 g_attribute_set[1], RELATION_NAME2, g_attribute_set[1], g_arastorage_data_set[0].long_value);
+	TC_ASSERT_EQ("cursor_get_count", get_query_count(query), DATA_SET_NUM);
+
+	snprintf(query, QUERY_LENGTH, "SELECT %s, %s FROM %s WHERE %s = %ld;", g_attribute_set[0],
+			 g_attribute_set[1], RELATION_NAME2, g_attribute_set[1], g_arastorage_data_set[0].long_value);
+	TC_ASSERT_EQ("cursor_get_count", get_query_count(query), 1);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_commit_p
+* @brief            Commit transactions of inserts
+* @scenario         Insert tuples in a transaction and by a batch, and select them by a scan and by an index
+* @apicovered       db_begin, db_exec_prepared_rows, db_commit
+* @precondition     utc_arastorage_db_rollback_p should be passed
+* @postcondition    none
+*/
+static void utc_arastorage_db_commit_p(void)
+{
+	db_result_t res;
+	db_stmt_t *stmt;
+	char query[QUERY_LENGTH];
+	char scan_query[QUERY_LENGTH];
+	int id;
+
+	snprintf(scan_query, QUERY_LENGTH, "SELECT %s, %s FROM %s WHERE %s >= 1000;", g_attribute_set[0],
+			 g_attribute_set[1], RELATION_NAME2, g_attribute_set[0]);
+
+	snprintf(query, QUERY_LENGTH, "INSERT (?, ?) INTO %s;", RELATION_NAME2);
+	stmt = db_prepare(query);
+	TC_ASSERT_NEQ("db_prepare", stmt, NULL);
+
+	res = db_begin();
+	TC_ASSERT_EQ_CLEANUP("db_begin", DB_SUCCESS(res), true, db_finalize(stmt));
+
+	/* The rows join the open transaction */
+	id = TRANSACTION_ID;
+	res = db_exec_prepared_rows(stmt, DATA_SET_NUM, bind_transaction_row, &id);
+	TC_ASSERT_EQ_CLEANUP("db_exec_prepared_rows", DB_SUCCESS(res), true, db_rollback(); db_finalize(stmt));
+
+	/* and stay invisible until it is committed */
+	TC_ASSERT_EQ_CLEANUP("cursor_get_count", get_query_count(scan_query), DATA_SET_NUM, db_rollback(); db_finalize(stmt));
+
+	res = db_commit();
+	TC_ASSERT_EQ_CLEANUP("db_commit", DB_SUCCESS(res), true, db_finalize(stmt));
+	TC_ASSERT_EQ_CLEANUP("cursor_get_count", get_query_count(scan_query), 2 * DATA_SET_NUM, db_finalize(stmt));
+
+	/* Without a transaction, the batch is committed by itself */
+	id = BATCH_ID;
+	res = db_exec_prepared_rows(stmt, DATA_SET_NUM, bind_transaction_row, &id);
+	TC_ASSERT_EQ_CLEANUP("db_exec_prepared_rows", DB_SUCCESS(res), true, db_finalize(stmt));
+
+	res = db_finalize(stmt);
+	TC_ASSERT_EQ("db_finalize", DB_SUCCESS(res), true);
+
+	TC_ASSERT_EQ("cursor_get_count", get_query_count(scan_query), 3 * DATA_SET_NUM);
+
+	/* Search of the bplustree index */
+	snprintf(query, QUERY_LENGTH, "SELECT %s, %s FROM %s WHERE %s >= %ld;", g_attribute_set[0],
+			 g_attribute_set[1], RELATION_NAME2, g_attribute_set[1], g_arastorage_data_set[0].long_value);
+	TC_ASSERT_EQ("cursor_get_count", get_query_count(query), 3 * DATA_SET_NUM);
+
+	snprintf(query, QUERY_LENGTH, "SELECT %s, %s FROM %s WHERE %s = %ld;", g_attribute_set[0],
+			 g_attribute_set[1], RELATION_NAME2, g_attribute_set[1], g_arastorage_data_set[0].long_value);
+	TC_ASSERT_EQ("cursor_get_count", get_query_count(query), 3);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_prepare_n
+* @brief            Prepare and execute statements with invalid arguments
+* @scenario         Use NULL statement, invalid parameter index and unbound parameters
+* @apicovered       db_prepare, db_bind_int, db_bind_string, db_exec_prepared, db_query_prepared, db_finalize
+* @precondition     none
+* @postcondition    none
+*/
+static void utc_arastorage_db_prepare_n(void)
+{
+	db_result_t res;
+	db_stmt_t *stmt;
+	char query[QUERY_LENGTH];
+
+	stmt = db_prepare(NULL);
+	TC_ASSERT_EQ("db_prepare", stmt, NULL);
+
+	res = db_bind_int(NULL, 1, 0);
+	TC_ASSERT_EQ("db_bind_int", DB_ERROR(res), true);
+
+	res = db_exec_prepared(NULL);
+	TC_ASSERT_EQ("db_exec_prepared", DB_ERROR(res), true);
+
+	g_cursor = db_query_prepared(NULL);
+	TC_ASSERT_EQ("db_query_prepared", g_cursor, NULL);
+
+	res = db_finalize(NULL);
+	TC_ASSERT_EQ("db_finalize", DB_ERROR(res), true);
+
+	/* Parameters are accepted by prepared statements only */
+	snprintf(query, QUERY_LENGTH, "SELECT %s FROM %s WHERE %s > ?;", g_attribute_set[0], RELATION_NAME2, g_attribute_set[0]);
+	g_cursor = db_query(query);
+	TC_ASSERT_EQ("db_query", g_cursor, NULL);
+
+	stmt = db_prepare(query);
+	TC_ASSERT_NEQ("db_prepare", stmt, NULL);
+
+	res = db_bind_int(stmt, 2, 0);
+	TC_ASSERT_EQ_CLEANUP("db_bind_int", DB_ERROR(res), true, db_finalize(stmt));
+
+	res = db_bind_string(stmt, 1, "apple");
+	TC_ASSERT_EQ_CLEANUP("db_bind_string", DB_ERROR(res), true, db_finalize(stmt));
+
+	g_cursor = db_query_prepared(stmt);
+	TC_ASSERT_EQ_CLEANUP("db_query_prepared", g_cursor, NULL, db_finalize(stmt));
+
+	res = db_finalize(stmt);
+	TC_ASSERT_EQ("db_finalize", DB_SUCCESS(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_begin_n
+* @brief            Use transactions in invalid states
+* @scenario         End a transaction which hasn't begun, begin it twice and insert from another thread meanwhile
+* @apicovered       db_begin, db_commit, db_rollback, db_exec, db_exec_prepared_rows
+* @precondition     utc_arastorage_db_exec_p should be passed
+* @postcondition    none
+*/
+static void utc_arastorage_db_begin_n(void)
+{
+	db_result_t res;
+	db_result_t thread_res;
+	pthread_t tid;
+	int id = BATCH_ID;
+
+	res = db_commit();
+	TC_ASSERT_EQ("db_commit", DB_ERROR(res), true);
+
+	res = db_rollback();
+	TC_ASSERT_EQ("db_rollback", DB_ERROR(res), true);
+
+	res = db_exec_prepared_rows(NULL, DATA_SET_NUM, bind_transaction_row, &id);
+	TC_ASSERT_EQ("db_exec_prepared_rows", DB_ERROR(res), true);
+
+	res = db_begin();
+	TC_ASSERT_EQ("db_begin", DB_SUCCESS(res), true);
+
+	res = db_begin();
+	TC_ASSERT_EQ_CLEANUP("db_begin", res, DB_BUSY_ERROR, db_rollback());
+
+	/* Other threads can't insert until the transaction ends */
+	thread_res = DB_OK;
+	TC_ASSERT_EQ_CLEANUP("pthread_create", pthread_create(&tid, NULL, transaction_insert_thread, &thread_res), 0, db_rollback());
+	pthread_join(tid, NULL);
+	TC_ASSERT_EQ_CLEANUP("db_exec", thread_res, DB_BUSY_ERROR, db_rollback());
+
+	res = db_rollback();
+	TC_ASSERT_EQ("db_rollback", DB_SUCCESS(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
 /**
 * @testcase         utc_arastorage_db_get_result_message_p
 * @brief            Get database result message
@@ -1550,6 +1853,9 @@ int utc_arastorage_main(int argc, char *argv[])
 #endif
 	utc_arastorage_cursor_get_string_value_p();
 	utc_arastorage_db_cursor_free_p();
+	utc_arastorage_db_prepare_p();
+	utc_arastorage_db_rollback_p();
+	utc_arastorage_db_commit_p();
 	utc_arastorage_db_deinit_p();
 
 	db_init();
@@ -1557,6 +1863,8 @@ int utc_arastorage_main(int argc, char *argv[])
 	/* Negative TCs */
 	utc_arastorage_db_exec_n();
 	utc_arastorage_db_query_n();
+	utc_arastorage_db_prepare_n();
+	utc_arastorage_db_begin_n();
 	utc_arastorage_db_get_result_message_n();
 	utc_arastorage_db_print_header_n();
 	utc_arastorage_db_print_tuple_n();
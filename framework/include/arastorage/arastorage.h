@@ -172,6 +172,9 @@ typedef struct _db_handle_s db_handle_t;
 struct _db_cursor_s;
 typedef struct _db_cursor_s db_cursor_t;
 
+struct _db_stmt_s;
+typedef struct _db_stmt_s db_stmt_t;
+
 typedef int db_storage_id_t;
 
 typedef uint32_t cursor_row_t;
@@ -180,13 +183,14 @@ typedef uint32_t tuple_id_t;
 
 typedef uint8_t attribute_id_t;
 
+/* Binds the values of a row of db_exec_prepared_rows() */
+typedef db_result_t (*db_bind_row_t)(db_stmt_t *stmt, int row, void *arg);
+
 /****************************************************************************
 * Public Variables
 ****************************************************************************/
 typedef int (*db_output_function_t)(const char *, ...);
 
-static db_output_function_t output = printf;
-
 /****************************************************************************
 * Global Function Prototypes
 ****************************************************************************/
@@ -211,6 +215,57 @@ db_result_t db_init(void);
 */
 db_result_t db_deinit(void);
 
+/**
+* @brief write the buffered tuples and index changes to storage
+*
+* @details @b #include <arastorage/arastorage.h>
+* Inserted tuples and changed index nodes are kept in RAM and written in
+* batches. This writes all of them, e.g. before the power may be lost.
+* @param none
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v3.0
+*/
+db_result_t db_flush(void);
+
+/**
+* @brief begin a transaction of inserts
+*
+* @details @b #include <arastorage/arastorage.h>
+* Rows inserted by the calling thread until db_commit() or db_rollback() are
+* kept in RAM, and queries don't see them before the commit. Only one
+* transaction is open at a time, inserts of other threads fail with
+* DB_BUSY_ERROR meanwhile. A transaction holds at most
+* CONFIG_ARASTORAGE_TRANSACTION_ROWS rows.
+* @param none
+* @return On success, DB_OK is returned. If a transaction is already open, DB_BUSY_ERROR is returned.
+* @since TizenRT v3.0
+*/
+db_result_t db_begin(void);
+
+/**
+* @brief write all rows of the transaction and update the indexes
+*
+* @details @b #include <arastorage/arastorage.h>
+* The rows of each relation are written with a single write and their keys
+* are inserted into the indexes in sorted order. Either all rows are stored
+* or none of them, also when the power is lost during the commit: the next
+* db_init() then undoes the rows which were written.
+* @param none
+* @return On success, DB_OK is returned. On failure, a negative value is returned and the transaction is rolled back.
+* @since TizenRT v3.0
+*/
+db_result_t db_commit(void);
+
+/**
+* @brief drop all rows of the transaction
+*
+* @details @b #include <arastorage/arastorage.h>
+* @param none
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v3.0
+*/
+db_result_t db_rollback(void);
+
 /**
 * @brief create or remove relations, attributes and indexes in arastorage
 *
@@ -232,6 +287,103 @@ db_result_t db_exec(char *format);
 */
 db_cursor_t *db_query(char *format);
 
+/**
+* @brief parse a query sentence once, to execute it many times
+*
+* @details @b #include <arastorage/arastorage.h>
+* Values of an INSERT and operands of a WHERE condition may be given as '?'
+* parameters, which are bound before each execution. The relation of an
+* INSERT or SELECT stays loaded until the statement is finalized, so neither
+* the relation nor its tuples can be removed in the meantime.
+* @param[in] format query sentence
+* @return On success, a pointer to db_stmt_t is returned. On failure, a NULL is returned.
+* @since TizenRT v3.0
+*/
+db_stmt_t *db_prepare(char *format);
+
+/**
+* @brief bind an integer to a parameter of a prepared statement
+*
+* @details @b #include <arastorage/arastorage.h>
+* @param[in] stmt a pointer to statement
+* @param[in] index position of the parameter in the sentence, starting from 1
+* @param[in] value value of the parameter
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v3.0
+*/
+db_result_t db_bind_int(db_stmt_t *stmt, int index, int value);
+
+/**
+* @brief bind a long integer to a parameter of a prepared statement
+*
+* @details @b #include <arastorage/arastorage.h>
+* @param[in] stmt a pointer to statement
+* @param[in] index position of the parameter in the sentence, starting from 1
+* @param[in] value value of the parameter
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v3.0
+*/
+db_result_t db_bind_long(db_stmt_t *stmt, int index, long value);
+
+/**
+* @brief bind a string to a value parameter of a prepared INSERT
+*
+* @details @b #include <arastorage/arastorage.h>
+* @param[in] stmt a pointer to statement
+* @param[in] index position of the parameter in the sentence, starting from 1
+* @param[in] value value of the parameter, it is copied
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v3.0
+*/
+db_result_t db_bind_string(db_stmt_t *stmt, int index, char *value);
+
+/**
+* @brief execute a prepared statement of db_exec type with the bound values
+*
+* @details @b #include <arastorage/arastorage.h>
+* @param[in] stmt a pointer to statement
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v3.0
+*/
+db_result_t db_exec_prepared(db_stmt_t *stmt);
+
+/**
+* @brief execute a prepared INSERT for many rows
+*
+* @details @b #include <arastorage/arastorage.h>
+* For each row, bind is called to bind the values of the row and the
+* statement is executed. The rows join the open transaction, or else are
+* inserted by a transaction of their own, so that either all of them are
+* stored or none.
+* @param[in] stmt a pointer to statement
+* @param[in] nrows number of rows
+* @param[in] bind function binding the values of a row, given its position starting from 0
+* @param[in] arg argument given to bind
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v3.0
+*/
+db_result_t db_exec_prepared_rows(db_stmt_t *stmt, int nrows, db_bind_row_t bind, void *arg);
+
+/**
+* @brief execute a prepared query with the bound values
+*
+* @details @b #include <arastorage/arastorage.h>
+* @param[in] stmt a pointer to statement
+* @return On success, a pointer to db_cursor_t is returned. On failure, a NULL is returned.
+* @since TizenRT v3.0
+*/
+db_cursor_t *db_query_prepared(db_stmt_t *stmt);
+
+/**
+* @brief free a prepared statement, it must be called before db_deinit
+*
+* @details @b #include <arastorage/arastorage.h>
+* @param[in] stmt a pointer to statement
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v3.0
+*/
+db_result_t db_finalize(db_stmt_t *stmt);
+
 /**
 * @brief free allocated cursor data, it should be called before application terminated
 *
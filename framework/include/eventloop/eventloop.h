@@ -27,6 +27,7 @@
 #ifndef __EVENTLOOP_H__
 #define __EVENTLOOP_H__
 
+#include <tinyara/config.h>
 #include <libtuv/uv.h>
 #include <stdbool.h>
 
@@ -90,8 +91,14 @@ typedef uv_loop_t el_loop_t;
 
 /**
  * @brief EventLoop Event structure
+ * @details With CONFIG_EVENT_FD, events are delivered through event flags file descriptors
+ * polled by the loop, otherwise through signals.
  */
+#ifdef CONFIG_EVENT_FD
+typedef uv_poll_t el_event_t;
+#else
 typedef uv_signal_t el_event_t;
+#endif
 
 /**
  * @brief EventLoop Timeout Callback
@@ -30,8 +30,12 @@
 #define __MEDIA_FILEINPUTDATASOURCE_H
 
 #include <media/InputDataSource.h>
+#include <time.h>
+#include <mutex>
 
 namespace media {
+struct frame_index_s;
+
 namespace stream {
 /**
  * @class
@@ -104,10 +108,37 @@ public:
 	 * @since TizenRT v2.0
 	 */
 	ssize_t read(unsigned char *buf, size_t size) override;
+	/**
+	 * @brief Move the read position to the frame at or before the given time
+	 * @details @b #include <media/FileInputDataSource.h>
+	 * Frames are indexed while the file is read, the index is extended by
+	 * parsing frame headers only when seeking beyond the part read so far.
+	 * param[in] msec time in milliseconds from the beginning
+	 * @return True is Success, False is Fail
+	 * @since TizenRT v2.1 PRE
+	 */
+	bool seekTo(unsigned int msec) override;
+	/**
+	 * @brief Gets the duration of the file
+	 * @details @b #include <media/FileInputDataSource.h>
+	 * @return The duration in milliseconds, -1 if unknown
+	 * @since TizenRT v2.1 PRE
+	 */
+	int getDuration() override;
 
 private:
+	void openIndex();
+	void saveIndex();
+	void closeIndex();
+
 	std::string mDataPath;
 	FILE *mFp;
+	struct frame_index_s *mIndex;
+	/* Guards mIndex, fed by the input worker while getDuration() may run on the player worker */
+	std::mutex mIndexMutex;
+	size_t mReadOffset;
+	size_t mFileSize;
+	time_t mMtime;
 };
 } // namespace stream
 } // namespace media
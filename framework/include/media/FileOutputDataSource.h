@@ -30,6 +30,11 @@
 #define __MEDIA_FILEOUTPUTDATASOURCE_H
 
 #include <media/OutputDataSource.h>
+#include <media/BufferObserverInterface.h>
+#include <pthread.h>
+#include <mutex>
+#include <atomic>
+#include <string>
 
 namespace media {
 namespace stream {
@@ -39,7 +44,7 @@ namespace stream {
  * @details @b #include <media/FileOutputDataSource.h>
  * @since TizenRT v2.0
  */
-class FileOutputDataSource : public OutputDataSource
+class FileOutputDataSource : public OutputDataSource, public BufferObserverInterface
 {
 public:
 	/**
@@ -109,6 +114,8 @@ public:
 	/**
 	 * @brief Write the file
 	 * @details @b #include <media/FileOutputDataSource.h>
+	 * Data is queued and written to the file by a writer thread in
+	 * sector aligned chunks. Blocks only while the queue is full.
 	 * param[in] buf poiter to a buffer
 	 * param[in] size Number of size to write
 	 * @return Data size written to buf.
@@ -116,9 +123,61 @@ public:
 	 */
 	ssize_t write(unsigned char *buf, size_t size) override;
 
+	/**
+	 * @brief Statistics of the write queue
+	 * @details @b #include <media/FileOutputDataSource.h>
+	 * @since TizenRT v2.0
+	 */
+	struct Statistics {
+		size_t bufferSize;           /* size of the write queue in bytes */
+		size_t bufferLevel;          /* bytes currently queued */
+		size_t highWaterMark;        /* highest queue level since open() */
+		unsigned int overrunCount;   /* number of times write() blocked on a full queue */
+		unsigned int flushCount;     /* number of chunks written to the file */
+		unsigned int maxFlushLatency; /* longest single file write, in microseconds */
+		unsigned int avgFlushLatency; /* average file write, in microseconds */
+	};
+	/**
+	 * @brief Get the current write queue statistics
+	 * @details @b #include <media/FileOutputDataSource.h>
+	 * @return snapshot of queue level and flush latency
+	 * @since TizenRT v2.0
+	 */
+	Statistics getStatistics();
+
+public:
+	/**
+	 * BufferObserverInterface
+	 */
+	void onBufferOverrun() override;
+	void onBufferUnderrun() override;
+	void onBufferUpdated(ssize_t change, size_t current) override;
+
+private:
+	static void *writerMain(void *arg);
+	bool startWriter();
+	void stopWriter();
+	bool flushChunk(unsigned char *chunk, size_t size);
+
 private:
 	std::string mDataPath;
 	FILE* mFp;
+	/* Write queue, drained by the writer thread */
+	std::shared_ptr<StreamBuffer> mStreamBuffer;
+	std::shared_ptr<StreamBufferReader> mBufferReader;
+	std::shared_ptr<StreamBufferWriter> mBufferWriter;
+	pthread_t mWriter;
+	bool mIsWriterAlive;
+	std::atomic<bool> mIsWriteFailed;
+	/* File offset of the next flush, chunks are aligned to it */
+	size_t mFileOffset;
+	std::mutex mStatsMutex;
+	std::atomic<size_t> mBufferLevel;
+	std::atomic<size_t> mHighWaterMark;
+	std::atomic<unsigned int> mOverrunCount;
+	unsigned int mFlushCount;
+	unsigned int mMaxFlushLatency;
+	unsigned long long mTotalFlushLatency;
 };
 } // namespace stream
 } // namespace media
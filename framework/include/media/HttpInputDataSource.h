@@ -37,6 +37,8 @@
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
+#include <chrono>
 #include <string>
 
 namespace media {
@@ -119,6 +121,46 @@ public:
 	 * @since TizenRT v2.0
 	 */
 	ssize_t read(unsigned char *buf, size_t size) override;
+	/**
+	 * @brief Move the read position to the given byte offset of the stream
+	 * @details @b #include <media/HttpInputDataSource.h>
+	 * If the offset is already in the download buffer, buffered data is skipped.
+	 * Otherwise the transfer is restarted with an HTTP Range request at the offset.
+	 * param[in] offset byte offset from the start of the resource
+	 * @return True is Success, False is Fail (e.g. live stream without length)
+	 * @since TizenRT v2.0
+	 */
+	bool seek(size_t offset);
+	/**
+	 * @brief Get the total length of the resource
+	 * @details @b #include <media/HttpInputDataSource.h>
+	 * @return length in bytes, or -1 if the server did not report it
+	 * @since TizenRT v2.0
+	 */
+	ssize_t getContentLength();
+
+	/**
+	 * @brief Buffering statistics of the http source
+	 * @details @b #include <media/HttpInputDataSource.h>
+	 * @since TizenRT v2.0
+	 */
+	struct Statistics {
+		size_t bufferSize;           /* size of the download buffer in bytes */
+		size_t bufferLevel;          /* bytes currently buffered */
+		size_t prefetchDepth;        /* level refilled before reading resumes after an underrun */
+		unsigned int rebufferCount;  /* number of times read() stalled on an empty buffer */
+		unsigned int resumeCount;    /* number of transfers resumed after an error */
+		size_t downloadRate;         /* smoothed download throughput, bytes per second */
+		size_t consumeRate;          /* smoothed decoder consumption, bytes per second */
+		size_t position;             /* byte offset of the next read */
+	};
+	/**
+	 * @brief Get the current buffering statistics
+	 * @details @b #include <media/HttpInputDataSource.h>
+	 * @return snapshot of buffer level and rebuffer metrics
+	 * @since TizenRT v2.0
+	 */
+	Statistics getStatistics();
 
 public:
 	/**
@@ -132,8 +174,12 @@ private:
 	static size_t HeaderCallback(char *data, size_t size, size_t nmemb, void *userp);
 	static size_t WriteCallback(char *data, size_t size, size_t nmemb, void *userp);
 	static void *workerMain(void *arg);
+	bool startTransfer(size_t offset);
+	void updatePrefetchDepth();
 
 private:
+	using Clock = std::chrono::steady_clock;
+
 	std::string mContentType;
 	std::string mUrl;
 	pthread_t mThread;
@@ -141,6 +187,33 @@ private:
 	std::condition_variable mCondv;
 	bool mIsHeaderReceived;
 	bool mIsDataReceived;
+	std::atomic<bool> mIsStopped;
+	std::atomic<bool> mSeekPending;
+	bool mIsWorkerParked;
+	bool mIsSeekRefill;
+	std::atomic<bool> mIsDownloadDone;
+	size_t mSeekOffset;
+	/* Range support and length reported by the server */
+	std::atomic<bool> mIsRangeSupported;
+	std::atomic<ssize_t> mContentLength;
+	/* Offset requested by the current transfer and bytes to drop if the server ignored it */
+	size_t mRequestOffset;
+	size_t mSkipBytes;
+	/* Absolute stream offsets of the next byte written into / read from the buffer */
+	std::atomic<size_t> mWriteOffset;
+	std::atomic<size_t> mReadOffset;
+	std::atomic<size_t> mBufferLevel;
+	std::atomic<size_t> mPrefetchDepth;
+	std::atomic<bool> mIsRebuffering;
+	unsigned int mRebufferCount;
+	unsigned int mResumeCount;
+	/* Throughput estimation, bytes per second */
+	size_t mDownloadRate;
+	size_t mConsumeRate;
+	size_t mDownloadBytes;
+	size_t mConsumeBytes;
+	Clock::time_point mDownloadMark;
+	Clock::time_point mConsumeMark;
 	std::shared_ptr<HttpStream> mHttpStream;
 	std::shared_ptr<StreamBuffer> mStreamBuffer;
 	std::shared_ptr<StreamBufferReader> mBufferReader;
@@ -76,6 +76,23 @@ public:
 	 * @since TizenRT v2.0
 	 */
 	virtual ssize_t read(unsigned char *buf, size_t size) = 0;
+
+	/**
+	 * @brief Move the read position to the frame at or before the given time
+	 * @details @b #include <media/InputDataSource.h>
+	 * param[in] msec time in milliseconds from the beginning
+	 * @return True is Success, False if the source can't seek
+	 * @since TizenRT v2.1 PRE
+	 */
+	virtual bool seekTo(unsigned int msec) { return false; }
+
+	/**
+	 * @brief Gets the duration of the stream
+	 * @details @b #include <media/InputDataSource.h>
+	 * @return The duration in milliseconds, -1 if unknown
+	 * @since TizenRT v2.1 PRE
+	 */
+	virtual int getDuration() { return -1; }
 };
 
 } // namespace stream
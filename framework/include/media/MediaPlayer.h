@@ -187,6 +187,29 @@ public:
 	 */
 	player_result_t setVolume(uint8_t);
 
+	/**
+	 * @brief Move the playback position
+	 * @details @b #include <media/MediaPlayer.h>
+	 * This function is a synchronous API.
+	 * Playback continues from the start of the frame at or before the given time.
+	 * Only supported by data sources that can be repositioned, e.g. local MP3, AAC and Opus files.
+	 * @param[in] msec The position to move to, in milliseconds from the beginning
+	 * @return PLAYER_ERROR_INVALID_OPERATION if the data source can't seek
+	 * @since TizenRT v2.1 PRE
+	 */
+	player_result_t seekTo(unsigned int msec);
+
+	/**
+	 * @brief Get the duration of the content
+	 * @details @b #include <media/MediaPlayer.h>
+	 * This function is a synchronous API.
+	 * The first call may have to parse the whole file, if its index isn't cached yet.
+	 * @param[out] msec The duration in milliseconds
+	 * @return PLAYER_ERROR_INVALID_OPERATION if the duration is unknown
+	 * @since TizenRT v2.1 PRE
+	 */
+	player_result_t getDuration(unsigned int *msec);
+
 	/**
 	 * @brief Set the DataSource of input data
 	 * @details @b #include <media/MediaPlayer.h>
@@ -126,6 +126,9 @@
 #define AQL_SET_CONDITION(adt, cond)    ((adt)->lvm_instance = (cond))
 #define AQL_ADD_VALUE(adt, domain, value)                               \
 	aql_add_value((adt), (domain), (value))
+#define AQL_ADD_PARAMETER(adt, type, index)                             \
+	aql_add_parameter((adt), (type), (index))
+#define AQL_PARAMETER_COUNT(adt)        ((adt)->parameter_count)
 
 /****************************************************************************
 * Public Type Definitions
@@ -193,6 +196,9 @@ enum token_e {
 
 	ATTRIBUTE,
 	BPLUSTREE,					/* 48 */
+	HASH,
+
+	PARAMETER,
 
 	INTEGER_VALUE = 251,
 	FLOAT_VALUE = 252,
@@ -233,6 +239,20 @@ struct aql_attribute_s {
 };
 typedef struct aql_attribute_s aql_attribute_t;
 
+/* Where the value bound to a '?' parameter of a prepared query goes. */
+enum aql_parameter_type_e {
+	AQL_PARAMETER_VALUE = 0,		/* values[index] of an INSERT */
+	AQL_PARAMETER_CONDITION = 1		/* LVM parameter index of the WHERE clause */
+};
+typedef enum aql_parameter_type_e aql_parameter_type_t;
+
+struct aql_parameter_s {
+	uint8_t type;
+	uint8_t index;
+	uint8_t bound;
+};
+typedef struct aql_parameter_s aql_parameter_t;
+
 struct aql_adt_s {
 	char relations[AQL_RELATION_LIMIT][RELATION_NAME_LENGTH + 1];
 	aql_attribute_t attributes[AQL_ATTRIBUTE_LIMIT];
@@ -244,10 +264,18 @@ struct aql_adt_s {
 	uint8_t value_count;
 	uint32_t optype;
 	uint8_t flags;
+	uint8_t parameter_count;
+	aql_parameter_t parameters[AQL_PARAMETER_LIMIT];
 	void *lvm_instance;
 };
 typedef struct aql_adt_s aql_adt_t;
 
+/* A query parsed once by db_prepare() and executed with bound values. */
+struct _db_stmt_s {
+	aql_adt_t adt;
+	relation_t *rel;			/* loaded while the statement lives */
+};
+
 /****************************************************************************
 * Global Function Prototypes
 ****************************************************************************/
@@ -255,10 +283,16 @@ int lexer_start(lexer_t *, char *, token_t *, value_t *);
 int lexer_next(lexer_t *);
 void lexer_rewind(lexer_t *);
 
+db_result_t aql_init_handle(db_handle_t **handle);
+db_result_t aql_deinit_handle(db_handle_t **handle);
+void aql_lock(void);
+void aql_unlock(void);
+
 void aql_clear(aql_adt_t *adt);
 void aql_add_relation(aql_adt_t *adt, char *rel);
 aql_status_t aql_parse(aql_adt_t *adt, char *query_string);
 db_result_t aql_add_attribute(aql_adt_t *adt, char *name, domain_t domain, unsigned element_size, int processed_only);
 db_result_t aql_add_value(aql_adt_t *adt, domain_t domain, void *value);
+db_result_t aql_add_parameter(aql_adt_t *adt, aql_parameter_type_t type, uint8_t index);
 
 #endif							/* !AQL_H */
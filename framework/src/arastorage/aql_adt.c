@@ -85,6 +85,7 @@ void aql_clear(aql_adt_t *adt)
 	adt->attribute_count = 0;
 	adt->value_count = 0;
 	adt->flags = 0;
+	adt->parameter_count = 0;
 	memset(adt->aggregators, 0, sizeof(adt->aggregators));
 }
 
@@ -93,7 +94,7 @@ void aql_add_relation(aql_adt_t *adt, char *rel)
 	if (adt->relation_count < AQL_RELATION_LIMIT - 1) {
 		int len;
 		len = strlen(rel) + 1;
-		snprintf(adt->relations[adt->relation_count++], len, "%s\0", rel);
+		snprintf(adt->relations[adt->relation_count++], len, "%s", rel);
 	}
 }
 
@@ -160,3 +161,19 @@ db_result_t aql_add_value(aql_adt_t *adt, domain_t domain, void *value_ptr)
 
 	return DB_OK;
 }
+
+db_result_t aql_add_parameter(aql_adt_t *adt, aql_parameter_type_t type, uint8_t index)
+{
+	aql_parameter_t *param;
+
+	if (adt->parameter_count == AQL_PARAMETER_LIMIT) {
+		return DB_LIMIT_ERROR;
+	}
+
+	param = &adt->parameters[adt->parameter_count++];
+	param->type = type;
+	param->index = index;
+	param->bound = 0;
+
+	return DB_OK;
+}
@@ -59,19 +59,40 @@
  ****************************************************************************/
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <pthread.h>
 
 #include "db_debug.h"
 #include "storage.h"
 #include "relation.h"
 #include "result.h"
 #include "aql.h"
+#include "lvm.h"
+#include "transaction.h"
+
+/****************************************************************************
+* Private Variables
+****************************************************************************/
+/* Serializes the statements of all tasks, see aql_query() for the reads
+   which go on without it. */
+static pthread_mutex_t g_aql_lock = PTHREAD_MUTEX_INITIALIZER;
 
 /****************************************************************************
 * Private Functions
 ****************************************************************************/
+void aql_lock(void)
+{
+	pthread_mutex_lock(&g_aql_lock);
+}
+
+void aql_unlock(void)
+{
+	pthread_mutex_unlock(&g_aql_lock);
+}
+
 db_result_t aql_init_handle(db_handle_t **handle)
 {
 	*handle = NULL;
@@ -91,6 +112,8 @@ db_result_t aql_deinit_handle(db_handle_t **handle)
 		return DB_ARGUMENT_ERROR;
 	}
 	res = DB_OK;
+	/* An index search may be stopped before its end */
+	index_release_iterator(&(*handle)->index_iterator);
 	if ((*handle)->rel != NULL) {
 		res = relation_release((*handle)->rel);
 		if (DB_ERROR(res)) {
@@ -146,30 +169,55 @@ relation_t *aql_get_relation(aql_adt_t *adt)
 	return relation_load(adt->relations[first_rel_arg]);
 }
 
-db_result_t db_exec(char *format)
+static bool aql_is_bound(aql_adt_t *adt)
+{
+	int i;
+
+	for (i = 0; i < AQL_PARAMETER_COUNT(adt); i++) {
+		if (!adt->parameters[i].bound) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void aql_free_values(aql_adt_t *adt)
+{
+	int i;
+
+	for (i = 0; i < adt->value_count; i++) {
+		if (adt->values[i].domain == DOMAIN_STRING && VALUE_STRING(&adt->values[i]) != NULL) {
+			free(VALUE_STRING(&adt->values[i]));
+			VALUE_STRING(&adt->values[i]) = NULL;
+		}
+	}
+}
+
+static aql_parameter_t *aql_get_parameter(db_stmt_t *stmt, int index)
+{
+	if (stmt == NULL || index < 1 || index > AQL_PARAMETER_COUNT(&stmt->adt)) {
+		return NULL;
+	}
+	return &stmt->adt.parameters[index - 1];
+}
+
+static db_result_t aql_exec(aql_adt_t *adt)
 {
 	db_result_t res;
-	aql_adt_t adt;
 	relation_t *rel = NULL;
 	aql_attribute_t *attr;
 	attribute_t *relattr = NULL;
 	uint32_t optype;
-	res = aql_get_parse_result(format, &adt);
-
-	if (DB_ERROR(res)) {
-		DB_LOG_E("DB : Parsing Error in db_create : %d\n", res);
-		return DB_PARSING_ERROR;
-	}
 
-	optype = AQL_GET_OP_TYPE(AQL_GET_TYPE(&adt));
+	optype = AQL_GET_OP_TYPE(AQL_GET_TYPE(adt));
 	if (optype == AQL_OP_TYPE_QUERY) {
 		DB_LOG_E("DB : AQL OP TYPE Error \n");
 		return DB_ARGUMENT_ERROR;
 	}
 
-	optype = AQL_GET_EXEC_TYPE(AQL_GET_TYPE(&adt));
+	optype = AQL_GET_EXEC_TYPE(AQL_GET_TYPE(adt));
 	if (optype != AQL_TYPE_CREATE_RELATION) {
-		rel = aql_get_relation(&adt);
+		rel = aql_get_relation(adt);
 		if (rel == NULL) {
 			DB_LOG_E("DB : get relation Failed\n");
 			return DB_RELATIONAL_ERROR;
@@ -180,27 +228,27 @@ db_result_t db_exec(char *format)
 
 	switch (optype) {
 	case AQL_TYPE_CREATE_ATTRIBUTE:
-		attr = &(adt.attributes[0]);
+		attr = &(adt->attributes[0]);
 		if (relation_attribute_add(rel, DB_STORAGE, attr->name, attr->domain, attr->element_size) != NULL) {
 			res = DB_OK;
 		}
 		break;
 	case AQL_TYPE_CREATE_INDEX:
-		relattr = relation_attribute_get(rel, adt.attributes[0].name);
+		relattr = relation_attribute_get(rel, adt->attributes[0].name);
 		if (relattr == NULL) {
 			res = DB_NAME_ERROR;
 			break;
 		}
-		res = index_create(AQL_GET_INDEX_TYPE(&adt), rel, relattr);
+		res = index_create(AQL_GET_INDEX_TYPE(adt), rel, relattr);
 		break;
 	case AQL_TYPE_CREATE_RELATION:
-		if (relation_create(adt.relations[0], DB_STORAGE) != NULL) {
+		if (relation_create(adt->relations[0], DB_STORAGE) != NULL) {
 			res = DB_OK;
 		}
 		break;
 	case AQL_TYPE_INSERT:
 		if (relation_cardinality(rel) < DB_TUPLE_LIMIT) {
-			res = relation_insert(rel, adt.values);
+			res = relation_insert(rel, adt->values);
 			if (DB_SUCCESS(res)) {
 				res = DB_OK;
 			}
@@ -209,10 +257,10 @@ db_result_t db_exec(char *format)
 		}
 		break;
 	case AQL_TYPE_REMOVE_ATTRIBUTE:
-		res = relation_attribute_remove(rel, adt.attributes[0].name);
+		res = relation_attribute_remove(rel, adt->attributes[0].name);
 		break;
 	case AQL_TYPE_REMOVE_INDEX:
-		relattr = relation_attribute_get(rel, adt.attributes[0].name);
+		relattr = relation_attribute_get(rel, adt->attributes[0].name);
 		if (relattr != NULL) {
 			index_load(rel, relattr);
 			if (relattr->index != NULL) {
@@ -226,6 +274,10 @@ db_result_t db_exec(char *format)
 		break;
 	case AQL_TYPE_REMOVE_RELATION:
 		res = relation_remove(rel, 1);
+		if (res != DB_BUSY_ERROR) {
+			/* The relation is freed along with its files. */
+			rel = NULL;
+		}
 		break;
 	default:
 		break;
@@ -236,9 +288,8 @@ db_result_t db_exec(char *format)
 	return res;
 }
 
-db_cursor_t *db_query(char *format)
+static db_cursor_t *aql_query(aql_adt_t *adt)
 {
-	aql_adt_t adt;
 	relation_t *rel;
 	uint32_t optype;
 	db_handle_t *handler;
@@ -248,34 +299,36 @@ db_cursor_t *db_query(char *format)
 	handler = NULL;
 	cursor = NULL;
 
-	if (DB_ERROR(aql_get_parse_result(format, &adt))) {
-		DB_LOG_E("DB : Parsing Error in db_create : %d\n");
-		return NULL;
-	}
-	optype = AQL_GET_OP_TYPE(AQL_GET_TYPE(&adt));
+	optype = AQL_GET_OP_TYPE(AQL_GET_TYPE(adt));
 	if (optype != AQL_OP_TYPE_QUERY) {
 		DB_LOG_E("DB : AQL OP TYPE Error \n");
 		return NULL;
 	}
-#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
-	if (DB_SUCCESS(storage_flush_insert_buffer())) {
-		DB_LOG_D("DB : flush insert buffer!!\n");
+	if (DB_SUCCESS(storage_cache_flush())) {
+		DB_LOG_D("DB : flush page cache!!\n");
 	}
-#endif
 
-	rel = aql_get_relation(&adt);
+	rel = aql_get_relation(adt);
 	if (rel == NULL) {
+		free(adt->lvm_instance);
+		AQL_SET_CONDITION(adt, NULL);
 		return NULL;
 	}
 
-	optype = AQL_GET_EXEC_TYPE(AQL_GET_TYPE(&adt));
+	optype = AQL_GET_EXEC_TYPE(AQL_GET_TYPE(adt));
 	switch (optype) {
 	case AQL_TYPE_REMOVE_TUPLES:
+		/* The relation is replaced by the remaining tuples, which can't
+		   be done under other queries or prepared statements using it. */
+		if (rel->references > 1) {
+			DB_LOG_E("DB: Relation %s is busy\n", rel->name);
+			goto errout;
+		}
 		/* Overwrite the attribute array with a full copy of the original
 		   relation's attributes. */
-		adt.attribute_count = 0;
+		adt->attribute_count = 0;
 		for (attr_ptr = list_head(rel->attributes); attr_ptr != NULL; attr_ptr = attr_ptr->next) {
-			AQL_ADD_ATTRIBUTE(&adt, attr_ptr->name, DOMAIN_UNSPECIFIED, 0);
+			AQL_ADD_ATTRIBUTE(adt, attr_ptr->name, DOMAIN_UNSPECIFIED, 0);
 		}
 	/* FALLTHROUGH */
 	case AQL_TYPE_SELECT:
@@ -283,11 +336,20 @@ db_cursor_t *db_query(char *format)
 			DB_LOG_E("DB: Init handle failed\n");
 			goto errout;
 		}
-		if (DB_ERROR(relation_select(&handler, rel, &adt))) {
+		if (DB_ERROR(relation_select(&handler, rel, adt))) {
 			DB_LOG_E("DB: Failed relation_select\n");
 			goto errout;
 		}
-		cursor = relation_process_result(handler);
+		if (optype == AQL_TYPE_SELECT && !(AQL_GET_FLAGS(adt) & AQL_FLAG_ASSIGN)) {
+			/* A selection only reads the relation, the rows and the index
+			   keys it may return were fixed by relation_select(). Other
+			   statements go on while its tuples are processed. */
+			aql_unlock();
+			cursor = relation_process_result(handler);
+			aql_lock();
+		} else {
+			cursor = relation_process_result(handler);
+		}
 		if (cursor == NULL) {
 			DB_LOG_E("DB: Failed to process cursor tuples\n");
 			goto errout;
@@ -299,21 +361,308 @@ db_cursor_t *db_query(char *format)
 		break;
 	}
 
-	if (rel != NULL) {
-		if (handler == NULL || !(handler->flags & DB_HANDLE_FLAG_PROCESSING)) {
-			relation_release(rel);
-		}
+	if (cursor != NULL && cursor->handle != NULL) {
+		/* The cursor processes the query from now on and releases the handle. */
+		return cursor;
+	}
+
+	/* Once given to the handle, the relation is released along with it.
+	   Releasing it twice would close the tuple file of other users. */
+	if (rel != NULL && (handler == NULL || handler->rel != rel)) {
+		relation_release(rel);
 	}
 	aql_deinit_handle(&handler);
 
 	return cursor;
 
 errout:
-	if (rel != NULL) {
+	if (rel != NULL && (handler == NULL || handler->rel != rel)) {
 		relation_release(rel);
 	}
 
+	if (handler == NULL) {
+		/* The condition wasn't given to a handle yet. */
+		free(adt->lvm_instance);
+		AQL_SET_CONDITION(adt, NULL);
+	}
 	aql_deinit_handle(&handler);
 
 	return NULL;
 }
+
+db_result_t db_exec(char *format)
+{
+	db_result_t res;
+	aql_adt_t adt;
+
+	aql_lock();
+	res = aql_get_parse_result(format, &adt);
+	if (DB_ERROR(res)) {
+		aql_unlock();
+		DB_LOG_E("DB : Parsing Error in db_create : %d\n", res);
+		return DB_PARSING_ERROR;
+	}
+
+	if (AQL_PARAMETER_COUNT(&adt) > 0) {
+		DB_LOG_E("DB : Parameters can be used only with db_prepare\n");
+		res = DB_ARGUMENT_ERROR;
+	} else {
+		res = aql_exec(&adt);
+	}
+	aql_free_values(&adt);
+	aql_unlock();
+
+	return res;
+}
+
+db_cursor_t *db_query(char *format)
+{
+	aql_adt_t adt;
+	db_cursor_t *cursor;
+
+	aql_lock();
+	if (DB_ERROR(aql_get_parse_result(format, &adt))) {
+		aql_unlock();
+		DB_LOG_E("DB : Parsing Error in db_query\n");
+		return NULL;
+	}
+
+	if (AQL_PARAMETER_COUNT(&adt) > 0) {
+		aql_unlock();
+		DB_LOG_E("DB : Parameters can be used only with db_prepare\n");
+		free(adt.lvm_instance);
+		return NULL;
+	}
+
+	cursor = aql_query(&adt);
+	aql_unlock();
+
+	return cursor;
+}
+
+db_stmt_t *db_prepare(char *format)
+{
+	db_stmt_t *stmt;
+	uint32_t optype;
+
+	stmt = (db_stmt_t *)malloc(sizeof(db_stmt_t));
+	if (stmt == NULL) {
+		DB_LOG_E("DB : Failed to malloc statement\n");
+		return NULL;
+	}
+	memset(stmt, 0, sizeof(db_stmt_t));
+
+	aql_lock();
+	if (DB_ERROR(aql_get_parse_result(format, &stmt->adt))) {
+		aql_unlock();
+		DB_LOG_E("DB : Parsing Error in db_prepare\n");
+		db_finalize(stmt);
+		return NULL;
+	}
+
+	/* Keep the relation of inserts and selects loaded, so that executions
+	   neither look it up in storage nor reopen its tuple file. */
+	optype = AQL_GET_EXEC_TYPE(AQL_GET_TYPE(&stmt->adt));
+	if (optype == AQL_TYPE_INSERT || optype == AQL_TYPE_SELECT) {
+		stmt->rel = aql_get_relation(&stmt->adt);
+		if (stmt->rel == NULL) {
+			aql_unlock();
+			DB_LOG_E("DB : get relation Failed\n");
+			db_finalize(stmt);
+			return NULL;
+		}
+	}
+	aql_unlock();
+
+	return stmt;
+}
+
+db_result_t db_bind_long(db_stmt_t *stmt, int index, long value)
+{
+	aql_parameter_t *param;
+	attribute_value_t *attr_value;
+	operand_value_t operand;
+
+	param = aql_get_parameter(stmt, index);
+	if (param == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	if (param->type == AQL_PARAMETER_VALUE) {
+		attr_value = &stmt->adt.values[param->index];
+		if (attr_value->domain == DOMAIN_STRING) {
+			free(VALUE_STRING(attr_value));
+		}
+		/* Integers are given to relation_insert() as the parser gives them. */
+		attr_value->domain = DOMAIN_INT;
+		VALUE_LONG(attr_value) = value;
+	} else {
+		operand.l = value;
+		if (LVM_ERROR(lvm_set_parameter_value((lvm_instance_t *)stmt->adt.lvm_instance, param->index, operand))) {
+			return DB_ARGUMENT_ERROR;
+		}
+	}
+	param->bound = 1;
+
+	return DB_OK;
+}
+
+db_result_t db_bind_int(db_stmt_t *stmt, int index, int value)
+{
+	return db_bind_long(stmt, index, (long)value);
+}
+
+db_result_t db_bind_string(db_stmt_t *stmt, int index, char *value)
+{
+	aql_parameter_t *param;
+	attribute_value_t *attr_value;
+	unsigned char *str;
+	size_t length;
+
+	param = aql_get_parameter(stmt, index);
+	if (param == NULL || value == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	/* Conditions are evaluated on integers only. */
+	if (param->type != AQL_PARAMETER_VALUE) {
+		return DB_TYPE_ERROR;
+	}
+
+	length = strlen(value);
+	if (length >= DB_MAX_ELEMENT_SIZE) {
+		return DB_LIMIT_ERROR;
+	}
+	str = (unsigned char *)malloc(length + 1);
+	if (str == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+	memcpy(str, value, length + 1);
+
+	attr_value = &stmt->adt.values[param->index];
+	if (attr_value->domain == DOMAIN_STRING) {
+		free(VALUE_STRING(attr_value));
+	}
+	attr_value->domain = DOMAIN_STRING;
+	VALUE_STRING(attr_value) = str;
+	param->bound = 1;
+
+	return DB_OK;
+}
+
+db_result_t db_exec_prepared(db_stmt_t *stmt)
+{
+	db_result_t res;
+
+	if (stmt == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	if (!aql_is_bound(&stmt->adt)) {
+		DB_LOG_E("DB : Not all parameters are bound\n");
+		return DB_ARGUMENT_ERROR;
+	}
+
+	aql_lock();
+	res = aql_exec(&stmt->adt);
+	aql_unlock();
+
+	return res;
+}
+
+db_result_t db_exec_prepared_rows(db_stmt_t *stmt, int nrows, db_bind_row_t bind, void *arg)
+{
+	db_result_t res;
+	bool implicit;
+	int row;
+
+	if (stmt == NULL || bind == NULL || nrows < 0) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	if (AQL_GET_EXEC_TYPE(AQL_GET_TYPE(&stmt->adt)) != AQL_TYPE_INSERT) {
+		DB_LOG_E("DB : Only inserts are executed for many rows\n");
+		return DB_ARGUMENT_ERROR;
+	}
+
+	implicit = !transaction_is_active();
+	if (implicit) {
+		res = db_begin();
+		if (DB_ERROR(res)) {
+			return res;
+		}
+	}
+
+	res = DB_OK;
+	for (row = 0; row < nrows && DB_SUCCESS(res); row++) {
+		res = bind(stmt, row, arg);
+		if (DB_SUCCESS(res)) {
+			res = db_exec_prepared(stmt);
+		}
+	}
+
+	if (implicit) {
+		if (DB_SUCCESS(res)) {
+			res = db_commit();
+		} else {
+			db_rollback();
+		}
+	}
+	return res;
+}
+
+db_cursor_t *db_query_prepared(db_stmt_t *stmt)
+{
+	aql_adt_t adt;
+	lvm_instance_t *lvm;
+	db_cursor_t *cursor;
+
+	if (stmt == NULL) {
+		return NULL;
+	}
+
+	if (!aql_is_bound(&stmt->adt)) {
+		DB_LOG_E("DB : Not all parameters are bound\n");
+		return NULL;
+	}
+
+	/* A query owns its condition until the cursor is freed, so it runs on
+	   a copy and the statement can be executed again right away. */
+	memcpy(&adt, &stmt->adt, sizeof(adt));
+	if (stmt->adt.lvm_instance != NULL) {
+		lvm = (lvm_instance_t *)malloc(sizeof(lvm_instance_t));
+		if (lvm == NULL) {
+			DB_LOG_E("DB : Failed to malloc lvm instance\n");
+			return NULL;
+		}
+		lvm_clone(lvm, (lvm_instance_t *)stmt->adt.lvm_instance);
+		AQL_SET_CONDITION(&adt, lvm);
+	}
+
+	aql_lock();
+	cursor = aql_query(&adt);
+	aql_unlock();
+
+	return cursor;
+}
+
+db_result_t db_finalize(db_stmt_t *stmt)
+{
+	db_result_t res;
+
+	if (stmt == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	res = DB_OK;
+	if (stmt->rel != NULL) {
+		aql_lock();
+		res = relation_release(stmt->rel);
+		aql_unlock();
+	}
+	aql_free_values(&stmt->adt);
+	free(stmt->adt.lvm_instance);
+	free(stmt);
+
+	return res;
+}
@@ -252,6 +252,8 @@ PARSER(relations)
 
 PARSER(values)
 {
+	long placeholder;
+
 	/* Parse comma-separated attribute values. */
 	NEXT;
 	switch (TOKEN) {
@@ -261,6 +263,14 @@ PARSER(values)
 	case INTEGER_VALUE:
 		AQL_ADD_VALUE(adt, DOMAIN_INT, VALUE);
 		break;
+	case PARAMETER:
+		/* The value is replaced when the prepared query is bound. */
+		if (DB_ERROR(AQL_ADD_PARAMETER(adt, AQL_PARAMETER_VALUE, adt->value_count))) {
+			RETURN(SYNTAX_ERROR);
+		}
+		placeholder = 0;
+		AQL_ADD_VALUE(adt, DOMAIN_INT, &placeholder);
+		break;
 	default:
 		RETURN(SYNTAX_ERROR);
 	}
@@ -278,6 +288,7 @@ PARSER(values)
 PARSER(operand)
 {
 	lvm_instance_t *p;
+	uint8_t id;
 
 	p = adt->lvm_instance;
 
@@ -290,6 +301,9 @@ PARSER(operand)
 		AQL_ADD_PROCESSING_ATTRIBUTE(adt, VALUE);
 		break;
 	case STRING_VALUE:
+		if (LVM_ERROR(lvm_set_string(p, VALUE))) {
+			RETURN(SYNTAX_ERROR);
+		}
 		break;
 	case FLOAT_VALUE:
 		break;
@@ -298,6 +312,12 @@ PARSER(operand)
 			RETURN(SYNTAX_ERROR);
 		}
 		break;
+	case PARAMETER:
+		id = AQL_PARAMETER_COUNT(adt);
+		if (DB_ERROR(AQL_ADD_PARAMETER(adt, AQL_PARAMETER_CONDITION, id)) || LVM_ERROR(lvm_set_parameter(p, id))) {
+			RETURN(SYNTAX_ERROR);
+		}
+		break;
 	default:
 		RETURN(SYNTAX_ERROR);
 	}
@@ -701,6 +721,7 @@ PARSER_TOKEN(index_type)
 	switch (TOKEN) {
 	case INLINE:
 	case BPLUSTREE:
+	case HASH:
 		return TOKEN;
 	default:
 		return NONE;
@@ -738,6 +759,9 @@ PARSER(create_index)
 	case BPLUSTREE:
 		type = INDEX_BPLUSTREE;
 		break;
+	case HASH:
+		type = INDEX_HASH;
+		break;
 	default:
 		RETURN(SYNTAX_ERROR);
 	}
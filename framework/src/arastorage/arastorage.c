@@ -65,8 +65,14 @@
 #include "db_debug.h"
 #include "result.h"
 #include "aql.h"
+#include "transaction.h"
 #include <arastorage/arastorage.h>
 
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+static db_output_function_t output = printf;
+
 /****************************************************************************
 * Public Functions
 ****************************************************************************/
@@ -81,25 +87,39 @@ db_result_t db_init(void)
 	if (res != DB_OK) {
 		return res;
 	}
-#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
-	res = storage_write_buffer_init();
+	res = storage_cache_init();
+	if (res != DB_OK) {
+		return res;
+	}
+	/* Undo a commit which was interrupted, e.g. by a power loss. */
+	res = transaction_recover();
 	if (res != DB_OK) {
 		return res;
 	}
-#endif
 	return res;
 }
 
 db_result_t db_deinit()
 {
-#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
-	storage_write_buffer_deinit();
-#endif
+	transaction_deinit();
+	storage_cache_deinit();
 	relation_deinit();
 	index_deinit();
 	return DB_OK;
 }
 
+db_result_t db_flush(void)
+{
+	db_result_t res;
+	aql_lock();
+	res = storage_cache_flush();
+	if (DB_SUCCESS(res)) {
+		res = index_flush();
+	}
+	aql_unlock();
+	return res;
+}
+
 void db_set_output_function(db_output_function_t f)
 {
 	output = f;
@@ -166,7 +186,13 @@ db_result_t db_print_header(db_cursor_t *cursor)
 
 db_result_t db_cursor_free(db_cursor_t *cursor)
 {
-	return cursor_deinit(cursor);
+	db_result_t res;
+
+	/* The query may still hold the relation */
+	aql_lock();
+	res = cursor_deinit(cursor);
+	aql_unlock();
+	return res;
 }
 
 
@@ -71,6 +71,8 @@
 #define ATTRIBUTE_FLAG_INVALID          0x2
 #define ATTRIBUTE_FLAG_PRIMARY_KEY      0x4
 #define ATTRIBUTE_FLAG_UNIQUE           0x8
+/* No index record is stored for the attribute, don't look it up again. */
+#define ATTRIBUTE_FLAG_NO_INDEX         0x10
 
 /****************************************************************************
 * Public Type Definitions
@@ -0,0 +1,795 @@
+/******************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/*
+ * Host benchmark of ARAStorage at growing relation sizes.
+ *
+ * Fills a relation shaped like a sensor history table, (id, key with a
+ * bplustree index, value), through a prepared INSERT and times scans,
+ * range and point searches with and without the index, and aggregates.
+ * The rows and aggregates of every query are checked against the data,
+ * so that a run is also a regression test of the storage engine.
+ * cursor_heap is the heap held by the cursor after walking all of its
+ * rows, which depends on how fragmented the result is, not on the size
+ * of the relation. The *_io fields count the bytes of the file I/O and
+ * the bytes of the SmartFS sectors it would read and write, see
+ * host/flash_io.h.
+ * With -b the index is created after the inserts, by bulk loading the
+ * sorted keys, and index_ms is the time of CREATE INDEX. -t selects the
+ * type of the index. With -T the rows are inserted by transactions of the
+ * given number of rows, see db_exec_prepared_rows().
+ * With -c the index search is also repeated while another thread keeps
+ * inserting rows, and the latencies are compared to the ones of an idle
+ * database.
+ * With -v nothing is timed: the same rows are put in a relation indexed
+ * row by row and in one indexed by a bulk load, and equality, range and
+ * MAX searches must return the same rows from both.
+ */
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <malloc.h>
+#include <time.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include <arastorage/arastorage.h>
+
+#include "flash_io.h"
+
+#define MAX_SIZES       8
+#define VALUE_PERIOD    1000
+#define LATENCY_QUERIES 200
+#define LATENCY_QUERY   5       /* index_1pct */
+
+enum aggregate_e {
+	AGG_NONE,
+	AGG_SUM_V,
+	AGG_MAX_K,
+	AGG_COUNT,
+};
+
+struct query_s {
+	const char *name;
+	const char *format;     /* %d is replaced by the number of rows / 100 */
+	int max_rows;           /* stop walking the cursor after this many rows, 0 for all */
+	int (*match)(int id, int nrows);        /* rows selected by the query, NULL for all */
+	enum aggregate_e aggregate;             /* a single row aggregating the selected ones */
+};
+
+static int value_of(int id);
+static int key_of(int id, int nrows);
+
+static int match_v_10pct(int id, int nrows)
+{
+	return value_of(id) < 100;
+}
+
+static int match_id_1pct(int id, int nrows)
+{
+	return id < nrows / 100;
+}
+
+static int match_id_eq(int id, int nrows)
+{
+	return id == nrows / 100;
+}
+
+static int match_k_1pct(int id, int nrows)
+{
+	return key_of(id, nrows) < nrows / 100;
+}
+
+static int match_k_eq(int id, int nrows)
+{
+	return key_of(id, nrows) == nrows / 100;
+}
+
+static const struct query_s g_queries[] = {
+	{ "scan", "SELECT id, v FROM sensor;", 0, NULL, AGG_NONE },
+	{ "scan_first10", "SELECT id, v FROM sensor;", 10, NULL, AGG_NONE },
+	{ "filter_10pct", "SELECT id, v FROM sensor WHERE v < 100;", 0, match_v_10pct, AGG_NONE },
+	{ "filter_1pct", "SELECT id, v FROM sensor WHERE id < %d;", 0, match_id_1pct, AGG_NONE },
+	{ "filter_eq", "SELECT id, v FROM sensor WHERE id = %d;", 0, match_id_eq, AGG_NONE },
+	{ "index_1pct", "SELECT id, k FROM sensor WHERE k < %d;", 0, match_k_1pct, AGG_NONE },
+	{ "index_eq", "SELECT id, k FROM sensor WHERE k = %d;", 0, match_k_eq, AGG_NONE },
+	{ "agg_sum", "SELECT SUM(v) FROM sensor;", 0, NULL, AGG_SUM_V },
+	{ "agg_max", "SELECT MAX(k) FROM sensor;", 0, NULL, AGG_MAX_K },
+	{ "agg_count_1pct", "SELECT COUNT(k) FROM sensor WHERE k < %d;", 0, match_k_1pct, AGG_COUNT },
+};
+
+#define NQUERIES (sizeof(g_queries) / sizeof(g_queries[0]))
+
+struct query_result_s {
+	double ms;
+	long rows;
+	double value;           /* of an aggregate */
+	long cursor_heap;
+	struct flash_io_stats_s io;
+};
+
+struct latency_s {
+	double p50_ms;
+	double p99_ms;
+	double max_ms;
+};
+
+struct result_s {
+	int nrows;
+	double insert_ms;
+	double index_ms;
+	struct flash_io_stats_s insert_io;
+	struct flash_io_stats_s index_io;
+	struct query_result_s queries[NQUERIES];
+	struct latency_s idle;
+	struct latency_s loaded;
+	double loaded_insert_rows_per_s;
+};
+
+static int g_bulk;
+static int g_batch_rows;
+static int g_concurrent;
+static int g_compare;
+static const char *g_index_type = "BPLUSTREE";
+
+static double wall_ms(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static long heap_in_use(void)
+{
+	struct mallinfo2 mi = mallinfo2();
+	return (long)mi.uordblks;
+}
+
+static int clean_dir(const char *path)
+{
+	char file[PATH_MAX];
+	struct dirent *entry;
+	DIR *dir;
+
+	mkdir(path, 0755);
+	dir = opendir(path);
+	if (dir == NULL) {
+		perror(path);
+		return -1;
+	}
+	while ((entry = readdir(dir)) != NULL) {
+		if (entry->d_name[0] == '.') {
+			continue;
+		}
+		snprintf(file, sizeof(file), "%s%s", path, entry->d_name);
+		unlink(file);
+	}
+	closedir(dir);
+	return 0;
+}
+
+static int exec(const char *query)
+{
+	if (DB_ERROR(db_exec((char *)query))) {
+		fprintf(stderr, "failed: %s\n", query);
+		return -1;
+	}
+	return 0;
+}
+
+/* k is a permutation of id, so the index returns tuples out of storage order */
+static int key_of(int id, int nrows)
+{
+	return (int)(((long long)id * 7919) % nrows);
+}
+
+static int value_of(int id)
+{
+	return (id * 7) % VALUE_PERIOD;
+}
+
+struct batch_s {
+	int first;
+	int nrows;
+};
+
+static db_result_t bind_row(db_stmt_t *stmt, int row, void *arg)
+{
+	struct batch_s *batch = arg;
+	int id = batch->first + row;
+
+	if (DB_ERROR(db_bind_int(stmt, 1, id)) || DB_ERROR(db_bind_int(stmt, 2, key_of(id, batch->nrows)))) {
+		return DB_ARGUMENT_ERROR;
+	}
+	return db_bind_int(stmt, 3, value_of(id));
+}
+
+static int fill(int nrows, struct result_s *res)
+{
+	char create_index[64];
+	struct batch_s batch;
+	db_stmt_t *stmt;
+	double start;
+	int count;
+	int i;
+
+	snprintf(create_index, sizeof(create_index), "CREATE INDEX sensor.k TYPE %s;", g_index_type);
+	if (exec("CREATE RELATION sensor;") || exec("CREATE ATTRIBUTE id DOMAIN int IN sensor;") ||
+		exec("CREATE ATTRIBUTE k DOMAIN int IN sensor;") || exec("CREATE ATTRIBUTE v DOMAIN int IN sensor;") ||
+		(!g_bulk && exec(create_index))) {
+		return -1;
+	}
+
+	stmt = db_prepare("INSERT (?, ?, ?) INTO sensor;");
+	if (stmt == NULL) {
+		fprintf(stderr, "failed to prepare the insert\n");
+		return -1;
+	}
+
+	flash_io_get_stats(&res->insert_io, true);
+	start = wall_ms();
+	batch.nrows = nrows;
+	for (i = 0; i < nrows; i += count) {
+		batch.first = i;
+		if (g_batch_rows > 0) {
+			count = nrows - i < g_batch_rows ? nrows - i : g_batch_rows;
+			if (DB_ERROR(db_exec_prepared_rows(stmt, count, bind_row, &batch))) {
+				fprintf(stderr, "insert of rows %d..%d failed\n", i, i + count - 1);
+				db_finalize(stmt);
+				return -1;
+			}
+		} else {
+			count = 1;
+			if (DB_ERROR(bind_row(stmt, 0, &batch)) || DB_ERROR(db_exec_prepared(stmt))) {
+				fprintf(stderr, "insert of row %d failed\n", i);
+				db_finalize(stmt);
+				return -1;
+			}
+		}
+	}
+	db_flush();
+	res->insert_ms = wall_ms() - start;
+	flash_io_get_stats(&res->insert_io, true);
+	db_finalize(stmt);
+
+	if (g_bulk) {
+		start = wall_ms();
+		if (exec(create_index)) {
+			return -1;
+		}
+		db_flush();
+		res->index_ms = wall_ms() - start;
+		flash_io_get_stats(&res->index_io, true);
+	}
+	return 0;
+}
+
+static int run_query(const struct query_s *query, int nrows, struct query_result_s *res)
+{
+	char text[128];
+	db_cursor_t *cursor;
+	long heap;
+	double start;
+
+	snprintf(text, sizeof(text), query->format, nrows / 100);
+	memset(res, 0, sizeof(*res));
+
+	flash_io_get_stats(&res->io, true);
+	heap = heap_in_use();
+	start = wall_ms();
+	cursor = db_query(text);
+	if (cursor == NULL) {
+		fprintf(stderr, "failed: %s\n", text);
+		return -1;
+	}
+	if (DB_SUCCESS(cursor_move_first(cursor))) {
+		do {
+			if (query->aggregate != AGG_NONE) {
+				res->value = cursor_get_double_value(cursor, 0);
+			} else {
+				cursor_get_int_value(cursor, 0);
+			}
+			res->rows++;
+		} while ((query->max_rows == 0 || res->rows < query->max_rows) && DB_SUCCESS(cursor_move_next(cursor)));
+	}
+	res->ms = wall_ms() - start;
+	res->cursor_heap = heap_in_use() - heap;
+	flash_io_get_stats(&res->io, true);
+
+	db_cursor_free(cursor);
+	return 0;
+}
+
+/* Compare the result of a query with the one computed from the rows */
+static int check_query(const struct query_s *query, int nrows, const struct query_result_s *res)
+{
+	long rows = 0;
+	double value = 0;
+	int id;
+
+	for (id = 0; id < nrows; id++) {
+		if (query->match != NULL && !query->match(id, nrows)) {
+			continue;
+		}
+		rows++;
+		if (query->aggregate == AGG_SUM_V) {
+			value += value_of(id);
+		} else if (query->aggregate == AGG_MAX_K && key_of(id, nrows) > value) {
+			value = key_of(id, nrows);
+		}
+	}
+	if (query->aggregate == AGG_COUNT) {
+		value = rows;
+	}
+	if (query->aggregate != AGG_NONE) {
+		rows = 1;
+	} else if (query->max_rows > 0 && rows > query->max_rows) {
+		rows = query->max_rows;
+	}
+
+	if (res->rows != rows || res->value != value) {
+		fprintf(stderr, "%s of %d rows: got %ld rows (value %.0f), expected %ld rows (value %.0f)\n",
+				query->name, nrows, res->rows, res->value, rows, value);
+		return -1;
+	}
+	return 0;
+}
+
+struct writer_s {
+	pthread_t thread;
+	int nrows;
+	volatile int inserted;
+	volatile int done;
+	volatile int stop;
+	int failed;
+	double ms;
+};
+
+/* Append up to nrows rows until stopped, repeating the ids and keys of the relation */
+static void *writer_main(void *arg)
+{
+	struct writer_s *writer = arg;
+	struct batch_s batch;
+	db_stmt_t *stmt;
+	double start;
+	int count;
+
+	stmt = db_prepare("INSERT (?, ?, ?) INTO sensor;");
+	if (stmt == NULL) {
+		fprintf(stderr, "failed to prepare the insert\n");
+		writer->failed = 1;
+		writer->done = 1;
+		return NULL;
+	}
+
+	start = wall_ms();
+	batch.nrows = writer->nrows;
+	while (!writer->stop && writer->inserted < writer->nrows) {
+		batch.first = writer->inserted;
+		if (g_batch_rows > 0) {
+			count = writer->nrows - batch.first < g_batch_rows ? writer->nrows - batch.first : g_batch_rows;
+			if (DB_ERROR(db_exec_prepared_rows(stmt, count, bind_row, &batch))) {
+				fprintf(stderr, "insert of rows %d..%d failed\n", batch.first, batch.first + count - 1);
+				writer->failed = 1;
+				break;
+			}
+		} else {
+			count = 1;
+			if (DB_ERROR(bind_row(stmt, 0, &batch)) || DB_ERROR(db_exec_prepared(stmt))) {
+				fprintf(stderr, "insert of row %d failed\n", batch.first);
+				writer->failed = 1;
+				break;
+			}
+		}
+		writer->inserted += count;
+	}
+	writer->ms = wall_ms() - start;
+	db_finalize(stmt);
+	writer->done = 1;
+	return NULL;
+}
+
+static int compare_ms(const void *a, const void *b)
+{
+	double x = *(const double *)a;
+	double y = *(const double *)b;
+
+	return (x > y) - (x < y);
+}
+
+static int measure_latency(int nrows, struct latency_s *res)
+{
+	struct query_result_s query;
+	double ms[LATENCY_QUERIES];
+	int i;
+
+	for (i = 0; i < LATENCY_QUERIES; i++) {
+		if (run_query(&g_queries[LATENCY_QUERY], nrows, &query)) {
+			return -1;
+		}
+		ms[i] = query.ms;
+	}
+
+	qsort(ms, LATENCY_QUERIES, sizeof(double), compare_ms);
+	res->p50_ms = ms[LATENCY_QUERIES / 2];
+	res->p99_ms = ms[LATENCY_QUERIES * 99 / 100];
+	res->max_ms = ms[LATENCY_QUERIES - 1];
+	return 0;
+}
+
+/*
+ * Time the index search on its own, then while a writer appends to the
+ * relation. The search returns the rows which were there when it started,
+ * without waiting for the inserts in between.
+ */
+static int run_concurrent(int nrows, struct result_s *res)
+{
+	struct writer_s writer;
+	int ret;
+
+	if (measure_latency(nrows, &res->idle)) {
+		return -1;
+	}
+
+	memset(&writer, 0, sizeof(writer));
+	writer.nrows = nrows;
+	if (pthread_create(&writer.thread, NULL, writer_main, &writer) != 0) {
+		return -1;
+	}
+	while (writer.inserted == 0 && !writer.done) {
+		usleep(100);
+	}
+	ret = measure_latency(nrows, &res->loaded);
+	writer.stop = 1;
+	pthread_join(writer.thread, NULL);
+
+	if (writer.failed) {
+		return -1;
+	}
+	res->loaded_insert_rows_per_s = writer.inserted * 1e3 / writer.ms;
+	return ret;
+}
+
+static int run(int nrows, struct result_s *res)
+{
+	unsigned i;
+	int ret = -1;
+
+	memset(res, 0, sizeof(*res));
+	res->nrows = nrows;
+
+	if (clean_dir(DBDIR) || DB_ERROR(db_init())) {
+		return -1;
+	}
+	if (fill(nrows, res) == 0) {
+		for (i = 0; i < NQUERIES; i++) {
+			if (run_query(&g_queries[i], nrows, &res->queries[i]) || check_query(&g_queries[i], nrows, &res->queries[i])) {
+				break;
+			}
+		}
+		ret = i == NQUERIES ? 0 : -1;
+		if (ret == 0 && g_concurrent) {
+			ret = run_concurrent(nrows, res);
+		}
+	}
+	db_deinit();
+
+	return ret;
+}
+
+/* Fills a relation like sensor, indexing it before the inserts or by a bulk load after them */
+static int fill_relation(const char *name, int nrows, int bulk)
+{
+	char text[128];
+	struct batch_s batch;
+	db_stmt_t *stmt;
+	int ret = 0;
+	int i;
+
+	snprintf(text, sizeof(text), "CREATE RELATION %s;", name);
+	if (exec(text)) {
+		return -1;
+	}
+	snprintf(text, sizeof(text), "CREATE ATTRIBUTE id DOMAIN int IN %s;", name);
+	if (exec(text)) {
+		return -1;
+	}
+	snprintf(text, sizeof(text), "CREATE ATTRIBUTE k DOMAIN int IN %s;", name);
+	if (exec(text)) {
+		return -1;
+	}
+	snprintf(text, sizeof(text), "CREATE ATTRIBUTE v DOMAIN int IN %s;", name);
+	if (exec(text)) {
+		return -1;
+	}
+	snprintf(text, sizeof(text), "CREATE INDEX %s.k TYPE BPLUSTREE;", name);
+	if (!bulk && exec(text)) {
+		return -1;
+	}
+
+	snprintf(text, sizeof(text), "INSERT (?, ?, ?) INTO %s;", name);
+	stmt = db_prepare(text);
+	if (stmt == NULL) {
+		fprintf(stderr, "failed to prepare the insert into %s\n", name);
+		return -1;
+	}
+	batch.nrows = nrows;
+	for (i = 0; i < nrows && ret == 0; i++) {
+		batch.first = i;
+		if (DB_ERROR(bind_row(stmt, 0, &batch)) || DB_ERROR(db_exec_prepared(stmt))) {
+			fprintf(stderr, "insert of row %d into %s failed\n", i, name);
+			ret = -1;
+		}
+	}
+	db_finalize(stmt);
+
+	snprintf(text, sizeof(text), "CREATE INDEX %s.k TYPE BPLUSTREE;", name);
+	if (ret == 0 && bulk && exec(text)) {
+		ret = -1;
+	}
+	db_flush();
+	return ret;
+}
+
+static int compare_int(const void *a, const void *b)
+{
+	int x = *(const int *)a;
+	int y = *(const int *)b;
+
+	return (x > y) - (x < y);
+}
+
+/* The ids of the rows of a query in ascending order, or the value of an aggregate as the only row */
+static int collect(const char *format, const char *name, int a, int b, int *rows, int max_rows)
+{
+	char text[128];
+	db_cursor_t *cursor;
+	int count = 0;
+
+	snprintf(text, sizeof(text), format, name, a, b);
+	cursor = db_query(text);
+	if (cursor == NULL) {
+		fprintf(stderr, "failed: %s\n", text);
+		return -1;
+	}
+	if (DB_SUCCESS(cursor_move_first(cursor))) {
+		do {
+			if (count == max_rows) {
+				fprintf(stderr, "%s: more than %d rows\n", text, max_rows);
+				db_cursor_free(cursor);
+				return -1;
+			}
+			if (cursor_get_attr_type(cursor, 0) == DOMAIN_DOUBLE) {
+				rows[count++] = (int)cursor_get_double_value(cursor, 0);
+			} else {
+				rows[count++] = cursor_get_int_value(cursor, 0);
+			}
+		} while (DB_SUCCESS(cursor_move_next(cursor)));
+	}
+	db_cursor_free(cursor);
+
+	qsort(rows, count, sizeof(int), compare_int);
+	return count;
+}
+
+/* Runs a query on both relations, failing if they don't return the same rows */
+static int compare_query(const char *format, int a, int b, int *rows, int *bulk_rows, int nrows)
+{
+	char text[128];
+	int count;
+	int bulk_count;
+
+	count = collect(format, "sensor", a, b, rows, nrows);
+	bulk_count = collect(format, "bulk", a, b, bulk_rows, nrows);
+	if (count < 0 || bulk_count < 0) {
+		return -1;
+	}
+	if (count != bulk_count || memcmp(rows, bulk_rows, count * sizeof(int)) != 0) {
+		snprintf(text, sizeof(text), format, "bulk", a, b);
+		fprintf(stderr, "%s of %d rows: got %d rows (first %d), row by row index got %d rows (first %d)\n",
+				text, nrows, bulk_count, bulk_count > 0 ? bulk_rows[0] : -1, count, count > 0 ? rows[0] : -1);
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * Compare the searches of an index built by a bulk load with the ones of
+ * an index built row by row, over the same rows. The keys of the
+ * equality searches are spread over the whole range, so that they fall in
+ * every part of the tree.
+ */
+static int run_compare(int nrows)
+{
+	int *rows;
+	int *bulk_rows;
+	int nqueries = 0;
+	int ret = -1;
+	int i;
+
+	if (clean_dir(DBDIR) || DB_ERROR(db_init())) {
+		return -1;
+	}
+	rows = malloc(nrows * sizeof(int));
+	bulk_rows = malloc(nrows * sizeof(int));
+	if (rows == NULL || bulk_rows == NULL || fill_relation("sensor", nrows, 0) || fill_relation("bulk", nrows, 1)) {
+		goto out;
+	}
+
+	for (i = 0; i <= 64; i++, nqueries++) {
+		if (compare_query("SELECT id, k FROM %s WHERE k = %d;", (int)((long long)(nrows - 1) * i / 64), 0, rows, bulk_rows, nrows)) {
+			goto out;
+		}
+	}
+	if (compare_query("SELECT id, k FROM %s WHERE k < %d;", nrows / 100, 0, rows, bulk_rows, nrows) ||
+		compare_query("SELECT id, k FROM %s WHERE k > %d;", nrows - nrows / 100 - 1, 0, rows, bulk_rows, nrows) ||
+		compare_query("SELECT id, k FROM %s WHERE k > %d AND k < %d;", nrows / 2 - nrows / 200, nrows / 2 + nrows / 200, rows, bulk_rows, nrows) ||
+		compare_query("SELECT id, k FROM %s WHERE k >= %d;", 0, 0, rows, bulk_rows, nrows) ||
+		compare_query("SELECT MAX(k) FROM %s;", 0, 0, rows, bulk_rows, nrows) ||
+		compare_query("SELECT MIN(k) FROM %s;", 0, 0, rows, bulk_rows, nrows) ||
+		compare_query("SELECT MAX(k) FROM %s WHERE k < %d;", nrows / 2, 0, rows, bulk_rows, nrows)) {
+		goto out;
+	}
+	nqueries += 7;
+	printf("%d rows: the bulk loaded and the row by row index agree on %d searches\n", nrows, nqueries);
+	ret = 0;
+
+out:
+	free(rows);
+	free(bulk_rows);
+	db_deinit();
+	return ret;
+}
+
+static void print_io(FILE *out, const struct flash_io_stats_s *io)
+{
+	fprintf(out, "{\"read_bytes\": %llu, \"write_bytes\": %llu, \"flash_read_bytes\": %llu, \"flash_write_bytes\": %llu}",
+			io->read_bytes, io->write_bytes, io->flash_read_bytes, io->flash_write_bytes);
+}
+
+static void print_result(FILE *out, const struct result_s *res, int last)
+{
+	unsigned i;
+
+	fprintf(out, "    {\"rows\": %d, \"batch_rows\": %d, \"insert_ms\": %.3f, \"insert_rows_per_s\": %.0f, \"index_ms\": %.3f,\n",
+			res->nrows, g_batch_rows, res->insert_ms, res->nrows * 1e3 / res->insert_ms, res->index_ms);
+	fprintf(out, "     \"insert_io\": ");
+	print_io(out, &res->insert_io);
+	fprintf(out, ",\n     \"index_io\": ");
+	print_io(out, &res->index_io);
+	fprintf(out, ",\n     \"queries\": [\n");
+	for (i = 0; i < NQUERIES; i++) {
+		const struct query_result_s *q = &res->queries[i];
+		fprintf(out, "      {\"query\": \"%s\", \"ms\": %.3f, \"rows\": %ld, \"cursor_heap\": %ld, \"io\": ",
+				g_queries[i].name, q->ms, q->rows, q->cursor_heap);
+		print_io(out, &q->io);
+		fprintf(out, "}%s\n", i == NQUERIES - 1 ? "" : ",");
+	}
+	fprintf(out, "    ]");
+	if (g_concurrent) {
+		fprintf(out, ",\n     \"read_latency\": {\"query\": \"%s\", \"insert_rows_per_s\": %.0f,\n", g_queries[LATENCY_QUERY].name, res->loaded_insert_rows_per_s);
+		fprintf(out, "      \"idle\": {\"p50_ms\": %.3f, \"p99_ms\": %.3f, \"max_ms\": %.3f},\n", res->idle.p50_ms, res->idle.p99_ms, res->idle.max_ms);
+		fprintf(out, "      \"under_insert\": {\"p50_ms\": %.3f, \"p99_ms\": %.3f, \"max_ms\": %.3f}}", res->loaded.p50_ms, res->loaded.p99_ms, res->loaded.max_ms);
+	}
+	fprintf(out, "}%s\n", last ? "" : ",");
+}
+
+static void usage(const char *prog)
+{
+	fprintf(stderr, "Usage: %s [-b] [-c] [-v] [-t bplustree|hash] [-T batch_rows] [-n rows[,rows...]] [-o result.json]\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+	struct result_s results[MAX_SIZES];
+	int sizes[MAX_SIZES] = { 1000, 10000, 65536 };
+	int nsizes = 3;
+	const char *outfile = NULL;
+	FILE *out = stdout;
+	char *tok;
+	int opt;
+	int i;
+
+	while ((opt = getopt(argc, argv, "bcvt:T:n:o:h")) != -1) {
+		switch (opt) {
+		case 'b':
+			g_bulk = 1;
+			break;
+		case 'c':
+			g_concurrent = 1;
+			break;
+		case 'v':
+			g_compare = 1;
+			break;
+		case 't':
+			if (strcasecmp(optarg, "bplustree") == 0) {
+				g_index_type = "BPLUSTREE";
+			} else if (strcasecmp(optarg, "hash") == 0) {
+				g_index_type = "HASH";
+			} else {
+				usage(argv[0]);
+				return 1;
+			}
+			break;
+		case 'T':
+			g_batch_rows = atoi(optarg);
+			break;
+		case 'n':
+			nsizes = 0;
+			for (tok = strtok(optarg, ","); tok != NULL && nsizes < MAX_SIZES; tok = strtok(NULL, ",")) {
+				sizes[nsizes++] = atoi(tok);
+			}
+			break;
+		case 'o':
+			outfile = optarg;
+			break;
+		default:
+			usage(argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	for (i = 0; i < nsizes; i++) {
+		if (sizes[i] < 100) {
+			usage(argv[0]);
+			return 1;
+		}
+		if (g_compare) {
+			if (run_compare(sizes[i])) {
+				fprintf(stderr, "comparison of %d rows failed\n", sizes[i]);
+				return 1;
+			}
+			continue;
+		}
+		if (run(sizes[i], &results[i])) {
+			fprintf(stderr, "benchmark of %d rows failed\n", sizes[i]);
+			return 1;
+		}
+	}
+
+	if (g_compare) {
+		return 0;
+	}
+
+	if (outfile) {
+		out = fopen(outfile, "w");
+		if (out == NULL) {
+			perror(outfile);
+			return 1;
+		}
+	}
+
+	fprintf(out, "{\n  \"benchmark\": \"arastorage_scale\",\n  \"results\": [\n");
+	for (i = 0; i < nsizes; i++) {
+		print_result(out, &results[i], i == nsizes - 1);
+	}
+	fprintf(out, "  ]\n}\n");
+
+	if (out != stdout) {
+		fclose(out);
+	}
+	return 0;
+}
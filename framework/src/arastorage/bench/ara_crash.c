@@ -0,0 +1,309 @@
+/******************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/*
+ * Host test of the recovery of interrupted commits of ARAStorage.
+ *
+ * A child process fills a relation (id, key with an index) with BASE_ROWS
+ * rows, then commits COMMIT_ROWS rows more in one transaction and is
+ * stopped at the nth write() of the commit, see flash_io_crash_at(). The
+ * write is either stored whole or torn. Another child then opens the
+ * database, which undoes the interrupted commit, and checks that the
+ * relation holds the base rows only, or all of them if the commit
+ * completed, both through a scan and through the index, and that it takes
+ * a new row. n runs from the first write of the commit until the commit
+ * completes before reaching it.
+ */
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include <arastorage/arastorage.h>
+
+#include "flash_io.h"
+
+#define BASE_ROWS   100
+#define COMMIT_ROWS 300
+#define NROWS       (BASE_ROWS + COMMIT_ROWS)
+#define MAX_WRITES  100000
+
+static const char *g_index_type = "BPLUSTREE";
+
+static int clean_dir(const char *path)
+{
+	char file[PATH_MAX];
+	struct dirent *entry;
+	DIR *dir;
+
+	mkdir(path, 0755);
+	dir = opendir(path);
+	if (dir == NULL) {
+		perror(path);
+		return -1;
+	}
+	while ((entry = readdir(dir)) != NULL) {
+		if (entry->d_name[0] == '.') {
+			continue;
+		}
+		snprintf(file, sizeof(file), "%s%s", path, entry->d_name);
+		unlink(file);
+	}
+	closedir(dir);
+	return 0;
+}
+
+static int exec(const char *query)
+{
+	if (DB_ERROR(db_exec((char *)query))) {
+		fprintf(stderr, "failed: %s\n", query);
+		return -1;
+	}
+	return 0;
+}
+
+/* k is a permutation of id, of the rows and of the one inserted after the recovery */
+static int key_of(int id)
+{
+	return (int)(((long long)id * 7919) % (NROWS + 1));
+}
+
+static db_result_t bind_row(db_stmt_t *stmt, int row, void *arg)
+{
+	int id = *(int *)arg + row;
+
+	if (DB_ERROR(db_bind_int(stmt, 1, id))) {
+		return DB_ARGUMENT_ERROR;
+	}
+	return db_bind_int(stmt, 2, key_of(id));
+}
+
+/* Rows returned by a query, -1 if it fails */
+static int count_rows(const char *query)
+{
+	db_cursor_t *cursor;
+	int rows = 0;
+
+	cursor = db_query((char *)query);
+	if (cursor == NULL) {
+		return -1;
+	}
+	if (DB_SUCCESS(cursor_move_first(cursor))) {
+		do {
+			rows++;
+		} while (DB_SUCCESS(cursor_move_next(cursor)));
+	}
+	db_cursor_free(cursor);
+	return rows;
+}
+
+/* Fill the base rows, then commit the others crashing at the nth write */
+static int commit_child(unsigned long nth, bool torn)
+{
+	char create_index[64];
+	db_stmt_t *stmt;
+	int first;
+
+	snprintf(create_index, sizeof(create_index), "CREATE INDEX sensor.k TYPE %s;", g_index_type);
+	if (clean_dir(DBDIR) || DB_ERROR(db_init())) {
+		return 2;
+	}
+	if (exec("CREATE RELATION sensor;") || exec("CREATE ATTRIBUTE id DOMAIN int IN sensor;") ||
+		exec("CREATE ATTRIBUTE k DOMAIN int IN sensor;") || exec(create_index)) {
+		return 2;
+	}
+
+	stmt = db_prepare("INSERT (?, ?) INTO sensor;");
+	if (stmt == NULL) {
+		fprintf(stderr, "failed to prepare the insert\n");
+		return 2;
+	}
+	first = 0;
+	if (DB_ERROR(db_exec_prepared_rows(stmt, BASE_ROWS, bind_row, &first))) {
+		fprintf(stderr, "insert of the base rows failed\n");
+		return 2;
+	}
+
+	flash_io_crash_at(nth, torn);
+	first = BASE_ROWS;
+	if (DB_ERROR(db_exec_prepared_rows(stmt, COMMIT_ROWS, bind_row, &first))) {
+		fprintf(stderr, "commit failed without crashing\n");
+		return 2;
+	}
+	return 0;
+}
+
+/* Open the database after the commit child and check its rows */
+static int verify_child(int nrows)
+{
+	char query[64];
+	db_stmt_t *stmt;
+	int first;
+	int rows;
+	int id;
+
+	if (DB_ERROR(db_init())) {
+		fprintf(stderr, "db_init failed\n");
+		return 1;
+	}
+
+	rows = count_rows("SELECT id, k FROM sensor;");
+	if (rows != nrows) {
+		fprintf(stderr, "scan: got %d rows, expected %d\n", rows, nrows);
+		return 1;
+	}
+	snprintf(query, sizeof(query), "SELECT id, k FROM sensor WHERE k < %d;", NROWS + 1);
+	rows = count_rows(query);
+	if (rows != nrows) {
+		fprintf(stderr, "index range: got %d rows, expected %d\n", rows, nrows);
+		return 1;
+	}
+
+	/* A bplustree search matching no key fails, it counts as no row. */
+	for (id = 0; id < NROWS; id++) {
+		snprintf(query, sizeof(query), "SELECT id, k FROM sensor WHERE k = %d;", key_of(id));
+		rows = count_rows(query);
+		if (id < nrows ? rows != 1 : rows > 0) {
+			fprintf(stderr, "index: got %d rows of id %d, expected %d\n", rows, id, id < nrows);
+			return 1;
+		}
+	}
+
+	/* The relation takes rows again, after the ones it kept */
+	stmt = db_prepare("INSERT (?, ?) INTO sensor;");
+	first = NROWS;
+	if (stmt == NULL || DB_ERROR(db_exec_prepared_rows(stmt, 1, bind_row, &first))) {
+		fprintf(stderr, "insert after the recovery failed\n");
+		return 1;
+	}
+	db_finalize(stmt);
+	rows = count_rows("SELECT id, k FROM sensor;");
+	snprintf(query, sizeof(query), "SELECT id, k FROM sensor WHERE k = %d;", key_of(NROWS));
+	if (rows != nrows + 1 || count_rows(query) != 1) {
+		fprintf(stderr, "insert after the recovery: got %d rows, expected %d\n", rows, nrows + 1);
+		return 1;
+	}
+
+	db_deinit();
+	return 0;
+}
+
+/* Exit status of a child running fn(), -1 if it was killed */
+static int run_child(int (*fn)(unsigned long, bool), unsigned long nth, bool torn)
+{
+	pid_t pid;
+	int status;
+
+	fflush(stdout);
+	fflush(stderr);
+	pid = fork();
+	if (pid < 0) {
+		perror("fork");
+		return -1;
+	}
+	if (pid == 0) {
+		_exit(fn(nth, torn));
+	}
+	if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status)) {
+		return -1;
+	}
+	return WEXITSTATUS(status);
+}
+
+static int verify_base(unsigned long nth, bool torn)
+{
+	return verify_child(BASE_ROWS);
+}
+
+static int verify_all(unsigned long nth, bool torn)
+{
+	return verify_child(NROWS);
+}
+
+/* Crash the commit at each of its writes in turn, 0 if every crash is undone */
+static int run(bool torn)
+{
+	unsigned long nth;
+	int status;
+
+	for (nth = 1; nth < MAX_WRITES; nth++) {
+		status = run_child(commit_child, nth, torn);
+		if (status == 0) {
+			if (run_child(verify_all, 0, false) != 0) {
+				fprintf(stderr, "completed commit isn't intact\n");
+				return -1;
+			}
+			printf("%s, %s writes: the commit has %lu writes, each crash was undone\n",
+				   g_index_type, torn ? "torn" : "whole", nth - 1);
+			return 0;
+		}
+		if (status != FLASH_IO_CRASH_EXIT) {
+			fprintf(stderr, "commit child failed at write %lu\n", nth);
+			return -1;
+		}
+		if (run_child(verify_base, 0, false) != 0) {
+			fprintf(stderr, "crash at the %s write %lu of the commit isn't undone\n", torn ? "torn" : "whole", nth);
+			return -1;
+		}
+	}
+
+	fprintf(stderr, "the commit didn't complete in %d writes\n", MAX_WRITES);
+	return -1;
+}
+
+static void usage(const char *prog)
+{
+	fprintf(stderr, "Usage: %s [-t bplustree|hash]\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+	int opt;
+
+	while ((opt = getopt(argc, argv, "t:h")) != -1) {
+		switch (opt) {
+		case 't':
+			if (strcasecmp(optarg, "bplustree") == 0) {
+				g_index_type = "BPLUSTREE";
+			} else if (strcasecmp(optarg, "hash") == 0) {
+				g_index_type = "HASH";
+			} else {
+				usage(argv[0]);
+				return 1;
+			}
+			break;
+		default:
+			usage(argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	if (run(false) || run(true)) {
+		return 1;
+	}
+	return 0;
+}
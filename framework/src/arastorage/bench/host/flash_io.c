@@ -0,0 +1,135 @@
+/******************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/*
+ * Counting read() and write() of ARAStorage, see flash_io.h.
+ */
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <string.h>
+
+#include "flash_io.h"
+
+static struct flash_io_stats_s g_stats;
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static unsigned long g_crash_at;	/* write() to crash at, 0 for none */
+static unsigned long g_crash_writes;	/* write() calls since armed */
+static bool g_crash_torn;
+
+/* Bytes of the sectors spanned by length bytes at offset */
+static unsigned long long flash_bytes(off_t offset, size_t length)
+{
+	off_t first;
+	off_t last;
+
+	if (length == 0) {
+		return 0;
+	}
+	first = offset / FLASH_SECTOR_DATA;
+	last = (offset + length - 1) / FLASH_SECTOR_DATA;
+	return (unsigned long long)(last - first + 1) * CONFIG_MTD_SMART_SECTOR_SIZE;
+}
+
+/* Where the next write() of fd lands */
+static off_t write_offset(int fd)
+{
+	struct stat st;
+	int flags;
+
+	flags = fcntl(fd, F_GETFL);
+	if (flags != -1 && (flags & O_APPEND) && fstat(fd, &st) == 0) {
+		return st.st_size;
+	}
+	return lseek(fd, 0, SEEK_CUR);
+}
+
+ssize_t flash_read(int fd, void *buffer, size_t length)
+{
+	off_t offset;
+	ssize_t r;
+
+	offset = lseek(fd, 0, SEEK_CUR);
+	r = read(fd, buffer, length);
+
+	pthread_mutex_lock(&g_lock);
+	g_stats.reads++;
+	if (r > 0) {
+		g_stats.read_bytes += r;
+		g_stats.flash_read_bytes += flash_bytes(offset, r);
+	}
+	pthread_mutex_unlock(&g_lock);
+	return r;
+}
+
+ssize_t flash_write(int fd, const void *buffer, size_t length)
+{
+	off_t offset;
+	ssize_t r;
+	bool crash;
+
+	pthread_mutex_lock(&g_lock);
+	crash = g_crash_at != 0 && ++g_crash_writes == g_crash_at;
+	pthread_mutex_unlock(&g_lock);
+	if (crash) {
+		/* A torn write stores the first half of its bytes */
+		r = write(fd, buffer, g_crash_torn ? length / 2 : length);
+		_exit(FLASH_IO_CRASH_EXIT);
+	}
+
+	offset = write_offset(fd);
+	r = write(fd, buffer, length);
+
+	pthread_mutex_lock(&g_lock);
+	g_stats.writes++;
+	if (r > 0) {
+		g_stats.write_bytes += r;
+		g_stats.flash_write_bytes += flash_bytes(offset, r);
+	}
+	pthread_mutex_unlock(&g_lock);
+	return r;
+}
+
+int flash_stat(const char *path, struct stat *buf)
+{
+	if (stat(path, buf) != 0) {
+		return -1;
+	}
+	buf->st_blksize = CONFIG_MTD_SMART_SECTOR_SIZE - FLASH_SECTOR_HEADER;
+	return 0;
+}
+
+void flash_io_get_stats(struct flash_io_stats_s *stats, bool reset)
+{
+	pthread_mutex_lock(&g_lock);
+	*stats = g_stats;
+	if (reset) {
+		memset(&g_stats, 0, sizeof(g_stats));
+	}
+	pthread_mutex_unlock(&g_lock);
+}
+
+void flash_io_crash_at(unsigned long nth, bool torn)
+{
+	pthread_mutex_lock(&g_lock);
+	g_crash_at = nth;
+	g_crash_writes = 0;
+	g_crash_torn = torn;
+	pthread_mutex_unlock(&g_lock);
+}
@@ -0,0 +1,80 @@
+/******************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/*
+ * Accounting of the file I/O of ARAStorage on the host, as it would reach
+ * the flash under SmartFS. storage_abstraction.c is built with
+ * FLASH_IO_WRAP, which maps its read(), write() and stat() to the ones
+ * below, see Makefile.host.
+ *
+ * SmartFS reads and writes whole sectors, and a write relocates every
+ * sector it touches. A sector holds CONFIG_MTD_SMART_SECTOR_SIZE bytes
+ * minus the sector and chain headers of file data, so the flash bytes of
+ * a call are the sectors its file range spans times the sector size.
+ * flash_stat() reports the block size SmartFS does, which the page cache
+ * of the tuple files uses as its page size.
+ *
+ * flash_io_crash_at() makes a later write() the last one of the process,
+ * like a power loss: the process exits with FLASH_IO_CRASH_EXIT after
+ * storing the whole write, or only half of it if it is torn.
+ */
+
+#ifndef __ARASTORAGE_BENCH_HOST_FLASH_IO_H
+#define __ARASTORAGE_BENCH_HOST_FLASH_IO_H
+
+#include <stdbool.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifndef CONFIG_MTD_SMART_SECTOR_SIZE
+#define CONFIG_MTD_SMART_SECTOR_SIZE 1024
+#endif
+
+/* struct smart_sect_header_s and struct smartfs_chain_header_s */
+#define FLASH_SECTOR_HEADER 5
+#define FLASH_CHAIN_HEADER  5
+#define FLASH_SECTOR_DATA   (CONFIG_MTD_SMART_SECTOR_SIZE - FLASH_SECTOR_HEADER - FLASH_CHAIN_HEADER)
+
+/* Exit status of a process stopped by flash_io_crash_at() */
+#define FLASH_IO_CRASH_EXIT 99
+
+struct flash_io_stats_s {
+	unsigned long reads;				/* read() calls */
+	unsigned long writes;				/* write() calls */
+	unsigned long long read_bytes;		/* bytes returned by read() */
+	unsigned long long write_bytes;		/* bytes given to write() */
+	unsigned long long flash_read_bytes;	/* sectors read, in bytes */
+	unsigned long long flash_write_bytes;	/* sectors written, in bytes */
+};
+
+ssize_t flash_read(int fd, void *buffer, size_t length);
+ssize_t flash_write(int fd, const void *buffer, size_t length);
+int flash_stat(const char *path, struct stat *buf);
+void flash_io_get_stats(struct flash_io_stats_s *stats, bool reset);
+
+/* Exit at the nth write() from now on, 0 disarms */
+void flash_io_crash_at(unsigned long nth, bool torn);
+
+#ifdef FLASH_IO_WRAP
+#define read flash_read
+#define write flash_write
+#define stat(path, buf) flash_stat(path, buf)
+#endif
+
+#endif /* __ARASTORAGE_BENCH_HOST_FLASH_IO_H */
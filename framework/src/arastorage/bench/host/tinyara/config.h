@@ -0,0 +1,68 @@
+/******************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/*
+ * Host replacement of the generated <tinyara/config.h> with the Kconfig
+ * defaults of ARAStorage that have no fallback in the sources. Pass
+ * -DCONFIG_... to override them.
+ */
+
+#ifndef __ARASTORAGE_BENCH_HOST_TINYARA_CONFIG_H
+#define __ARASTORAGE_BENCH_HOST_TINYARA_CONFIG_H
+
+/* Pulled in by the TizenRT headers, but not by the host ones */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <sys/types.h>
+
+#define CONFIG_ARASTORAGE 1
+#define CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER 1
+#define CONFIG_ARASTORAGE_ENABLE_VACUUM 1
+
+/* The host has <float.h>, for cursor_get_double_value() */
+#define CONFIG_ARCH_FLOAT_H 1
+
+#ifndef CONFIG_NODE_LIMIT
+#define CONFIG_NODE_LIMIT 2048
+#endif
+#ifndef CONFIG_BUCKETS_LIMIT
+#define CONFIG_BUCKETS_LIMIT 4096
+#endif
+#ifndef CONFIG_BRANCH_FACTOR
+#define CONFIG_BRANCH_FACTOR 5
+#endif
+#ifndef CONFIG_DB_TUPLES_LIMIT
+#define CONFIG_DB_TUPLES_LIMIT 65536
+#endif
+
+/* From TizenRT's <sys/types.h> */
+#ifndef TRUE
+#define TRUE 1
+#define FALSE 0
+#endif
+#ifndef OK
+#define OK 0
+#endif
+
+/* From TizenRT's <fcntl.h> */
+#define O_WROK O_WRONLY
+
+#endif /* __ARASTORAGE_BENCH_HOST_TINYARA_CONFIG_H */
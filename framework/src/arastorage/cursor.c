@@ -28,6 +28,66 @@
 #include "db_debug.h"
 #include "storage.h"
 #include "relation.h"
+#include "aql.h"
+
+/****************************************************************************
+* Private Functions
+****************************************************************************/
+
+/*
+ * Process tuples of the query until the (row_id)th row of the result is
+ * known or all tuples are processed. INVALID_TUPLE processes all of them.
+ */
+static db_result_t cursor_fetch(db_cursor_t *cursor, tuple_id_t row_id)
+{
+	db_result_t res;
+
+	while (cursor->handle != NULL && (row_id == INVALID_TUPLE || cursor->cursor_rows <= row_id)) {
+		res = relation_process(&cursor->handle, cursor);
+		if (DB_ERROR(res)) {
+			DB_LOG_E("DB: Failed to process tuples : %d\n", res);
+			aql_lock();
+			aql_deinit_handle(&cursor->handle);
+			aql_unlock();
+			return res;
+		}
+		if (res == DB_FINISHED) {
+			DB_LOG_V("DB: Processing tuples is done!\n");
+			aql_lock();
+			aql_deinit_handle(&cursor->handle);
+			aql_unlock();
+		}
+	}
+
+	return DB_OK;
+}
+
+/*
+ * Insert a range of one tuple at pos, growing the range array if needed.
+ */
+static db_result_t cursor_range_insert(db_cursor_t *cursor, uint32_t pos, tuple_id_t tuple_id)
+{
+	cursor_range_t *ranges;
+	uint32_t size;
+
+	if (cursor->range_count == cursor->range_size) {
+		size = cursor->range_size > 0 ? cursor->range_size * 2 : DB_CURSOR_RANGE_INIT;
+		ranges = (cursor_range_t *)realloc(cursor->ranges, size * sizeof(cursor_range_t));
+		if (ranges == NULL) {
+			DB_LOG_E("DB: Failed to allocate cursor ranges\n");
+			return DB_ALLOCATION_ERROR;
+		}
+		cursor->ranges = ranges;
+		cursor->range_size = size;
+	}
+
+	memmove(&cursor->ranges[pos + 1], &cursor->ranges[pos], (cursor->range_count - pos) * sizeof(cursor_range_t));
+	cursor->ranges[pos].start = tuple_id;
+	cursor->ranges[pos].count = 1;
+	cursor->range_count++;
+
+	return DB_OK;
+}
 
 /****************************************************************************
 * Public Functions
@@ -36,35 +96,46 @@
 /* Update current cursor id and storage id. */
 db_result_t cursor_move_to(db_cursor_t *cursor, tuple_id_t row_id)
 {
+	uint32_t r;
+	tuple_id_t first;
+
+	if (cursor == NULL || DB_ERROR(cursor_fetch(cursor, row_id))) {
+		return DB_CURSOR_ERROR;
+	}
+
 	if (IS_EMPTY_CURSOR(cursor)) {
 		DB_LOG_E("Empty Cursor\n");
 		return DB_CURSOR_ERROR;
 	}
 
-	if (row_id >= DB_CURSOR_RESULT_ENTRY || row_id >= cursor->cursor_rows) {
+	if (row_id >= cursor->cursor_rows) {
 		DB_LOG_E("invalid row id\n");
 		return DB_CURSOR_ERROR;
 	}
 
-	int i, index, pos;
-	int cnt = 0;
-
-	/* search (row_id)th set tuple id */
-	for (i = 0; i < cursor->total_rows; i++) {
-		index = GET_INDEX(i);
-		pos = GET_POS(i);
-
-		if (BIT_CHECK(cursor->row_arr[index], pos)) {
-			if (cnt == row_id) {
-				cursor->current_cursor_row = row_id;
-				cursor->current_storage_row = i;
-				DB_LOG_D("set current cursor id = %d, storage id = %d\n", cursor->current_cursor_row, cursor->current_storage_row);
-				return DB_OK;
-			}
-			cnt++;
-		}
+	/* Walk the ranges from the one of the current row, so that moving to
+	   the next or previous row doesn't depend on the size of the result. */
+	r = cursor->current_range;
+	first = cursor->range_first_row;
+	if (r >= cursor->range_count) {
+		r = 0;
+		first = 0;
+	}
+	while (row_id < first) {
+		r--;
+		first -= cursor->ranges[r].count;
+	}
+	while (row_id - first >= cursor->ranges[r].count) {
+		first += cursor->ranges[r].count;
+		r++;
 	}
-	return DB_CURSOR_ERROR;
+
+	cursor->current_range = r;
+	cursor->range_first_row = first;
+	cursor->current_cursor_row = row_id;
+	cursor->current_storage_row = cursor->ranges[r].start + (row_id - first);
+	DB_LOG_D("set current cursor id = %d, storage id = %d\n", cursor->current_cursor_row, cursor->current_storage_row);
+	return DB_OK;
 }
 
 /* Search the first set tuple id and update storage id corresponding it. */
@@ -76,7 +147,7 @@ db_result_t cursor_move_first(db_cursor_t *cursor)
 /* Search the last set tuple id and update storage id corresponding it. */
 db_result_t cursor_move_last(db_cursor_t *cursor)
 {
-	if (!cursor) {
+	if (!cursor || DB_ERROR(cursor_fetch(cursor, INVALID_TUPLE))) {
 		return DB_CURSOR_ERROR;
 	}
 
@@ -115,9 +186,7 @@ cursor_row_t cursor_get_row(db_cursor_t *cursor)
 /* Check whether cursor is pointing the first row*/
 bool cursor_is_first_row(db_cursor_t *cursor)
 {
-	int i, index, pos;
-
-	if (cursor == NULL) {
+	if (cursor == NULL || cursor->range_count == 0) {
 		return false;
 	}
 	//check whether pointing cursor id is correct
@@ -125,63 +194,90 @@ bool cursor_is_first_row(db_cursor_t *cursor)
 		return false;
 	}
 	//check whether pointing storage row id is true
-	for (i = 0; i < cursor->total_rows; i++) {
-		index = GET_INDEX(i);
-		pos = GET_POS(i);
-
-		if (BIT_CHECK(cursor->row_arr[index], pos)) {
-			if (i == cursor->current_storage_row) {
-				return true;
-			}
-			return false;
-		}
-	}
-	return false;
+	return cursor->current_storage_row == cursor->ranges[0].start;
 }
 
 /* Check whether cursor is pointing the last row*/
 bool cursor_is_last_row(db_cursor_t *cursor)
 {
-	if (cursor == NULL) {
+	cursor_range_t *last;
+
+	if (cursor == NULL || DB_ERROR(cursor_fetch(cursor, cursor->current_cursor_row + 1))) {
 		return false;
 	}
 	//check whether pointing cursor id is correct
-	if (cursor->current_cursor_row != cursor->cursor_rows - 1) {
+	if (cursor->range_count == 0 || cursor->current_cursor_row != cursor->cursor_rows - 1) {
 		return false;
 	}
 	//check whether pointing storage row id is true
-	int i, index, pos;
-
-	for (i = cursor->total_rows - 1; i >= 0; i--) {
-		index = GET_INDEX(i);
-		pos = GET_POS(i);
-
-		if (BIT_CHECK(cursor->row_arr[index], pos)) {
-			if (i == cursor->current_storage_row) {
-				return true;
-			}
-			return false;
-		}
-	}
-	return false;
+	last = &cursor->ranges[cursor->range_count - 1];
+	return cursor->current_storage_row == last->start + last->count - 1;
 }
 
 db_result_t cursor_data_add(db_cursor_t *cursor, tuple_id_t tuple_id)
 {
+	cursor_range_t *last;
+	cursor_range_t *prev;
+	uint32_t low;
+	uint32_t high;
+	uint32_t mid;
+
 	if (cursor == NULL) {
 		DB_LOG_E("cursor is null\n");
 		return DB_CURSOR_ERROR;
 	}
 
-	if (tuple_id >= DB_CURSOR_RESULT_ENTRY || tuple_id >= cursor->total_rows) {
+	if (tuple_id >= cursor->total_rows) {
 		DB_LOG_E("invalid tuple id error\n");
 		return DB_CURSOR_ERROR;
 	}
 
-	int index = GET_INDEX(tuple_id);
-	int pos = GET_POS(tuple_id);
+	/* Scans add tuples in storage order, extending or appending the last range. */
+	last = cursor->range_count > 0 ? &cursor->ranges[cursor->range_count - 1] : NULL;
+	if (last != NULL && tuple_id == last->start + last->count) {
+		last->count++;
+	} else if (last == NULL || tuple_id > last->start + last->count) {
+		if (DB_ERROR(cursor_range_insert(cursor, cursor->range_count, tuple_id))) {
+			return DB_ALLOCATION_ERROR;
+		}
+	} else {
+		/* Index searches add them in key order, find the first range after the tuple */
+		low = 0;
+		high = cursor->range_count;
+		while (low < high) {
+			mid = low + (high - low) / 2;
+			if (cursor->ranges[mid].start <= tuple_id) {
+				low = mid + 1;
+			} else {
+				high = mid;
+			}
+		}
 
-	BIT_SET(cursor->row_arr[index], pos);
+		prev = low > 0 ? &cursor->ranges[low - 1] : NULL;
+		if (prev != NULL && tuple_id < prev->start + prev->count) {
+			DB_LOG_D("tuple id %d is already in the cursor\n", tuple_id);
+			return DB_OK;
+		}
+
+		if (prev != NULL && tuple_id == prev->start + prev->count) {
+			prev->count++;
+			if (tuple_id + 1 == cursor->ranges[low].start) {
+				/* The tuple fills the gap between two ranges */
+				prev->count += cursor->ranges[low].count;
+				memmove(&cursor->ranges[low], &cursor->ranges[low + 1], (cursor->range_count - low - 1) * sizeof(cursor_range_t));
+				cursor->range_count--;
+			}
+		} else if (tuple_id + 1 == cursor->ranges[low].start) {
+			cursor->ranges[low].start--;
+			cursor->ranges[low].count++;
+		} else if (DB_ERROR(cursor_range_insert(cursor, low, tuple_id))) {
+			return DB_ALLOCATION_ERROR;
+		}
+
+		/* The rows after the tuple have moved, start walking from the first range */
+		cursor->current_range = 0;
+		cursor->range_first_row = 0;
+	}
 	cursor->cursor_rows++;
 
 	DB_LOG_D("cursor data added successfully : id %d, cardinality %d\n", tuple_id, cursor->cursor_rows);
@@ -192,6 +288,10 @@ db_result_t cursor_data_add(db_cursor_t *cursor, tuple_id_t tuple_id)
 /* Get the number of tuples in a cursor */
 cursor_row_t cursor_get_count(db_cursor_t *cursor)
 {
+	if (cursor == NULL || DB_ERROR(cursor_fetch(cursor, INVALID_TUPLE))) {
+		return INVALID_CURSOR_VALUE;
+	}
+
 	if (IS_EMPTY_CURSOR(cursor)) {
 		return INVALID_CURSOR_VALUE;
 	}
@@ -248,7 +348,6 @@ attribute_id_t cursor_get_attr_index(db_cursor_t *cursor, const char *attr_name)
 
 db_result_t cursor_get_value_storage(attribute_value_t *value, db_cursor_t *cursor, unsigned col)
 {
-	int fd, offset;
 	attribute_t attr;
 	unsigned char *buf;
 
@@ -274,14 +373,10 @@ db_result_t cursor_get_value_storage(attribute_value_t *value, db_cursor_t *curs
 		buf += cursor->attr_map[col].offset;
 	} else {
 		/* Otherwise, Read tuple value from storage. */
-		offset = cursor->current_storage_row * cursor->storage_row_length + cursor->attr_map[col].offset;
-		fd = storage_open(cursor->name, O_RDONLY);
-		if (fd < 0) {
-			DB_LOG_E("failed to open storage %s\n", cursor->name);
+		if (storage_cache_read(cursor->name, INVALID_STORAGE_ID, cursor->storage_row_length, cursor->current_storage_row, cursor->attr_map[col].offset, attr.element_size, buf) != DB_OK) {
+			DB_LOG_E("failed to read storage %s\n", cursor->name);
 			return DB_CURSOR_ERROR;
 		}
-		storage_read_from(fd, buf, offset, attr.element_size);
-		storage_close(fd);
 	}
 
 	return db_phy_to_value(value, &attr, buf);
@@ -407,31 +502,26 @@ void cursor_clean_data(db_cursor_t *cursor)
 	cursor->total_rows = 0;
 	cursor->attribute_count = 0;
 	cursor->storage_row_length = 0;
-	if (cursor->row_arr != NULL) {
-		free(cursor->row_arr);
-	}
-	cursor->row_arr = NULL;
+	if (cursor->ranges != NULL) {
+		free(cursor->ranges);
+	}
+	cursor->ranges = NULL;
+	cursor->range_count = 0;
+	cursor->range_size = 0;
+	cursor->current_range = 0;
+	cursor->range_first_row = 0;
 }
 
 db_result_t cursor_init(db_cursor_t **cursor, relation_t *rel)
 {
-	int arr_size;
 	if (*cursor == NULL) {
 		return DB_CURSOR_ERROR;
 	}
 
 	cursor_clean_data(*cursor);
 
-	arr_size = GET_CURSOR_DATA_ARR_SIZE(rel->cardinality);
-	if (arr_size > DB_CURSOR_LIMIT) {
-		return DB_CURSOR_ERROR;
-	}
-
-	(*cursor)->row_arr = (uint32_t *)malloc(sizeof(uint32_t) * arr_size);
-	if ((*cursor)->row_arr == NULL) {
-		return DB_CURSOR_ERROR;
-	}
-	memset((*cursor)->row_arr, 0, arr_size * sizeof(uint32_t));
+	/* Ranges are allocated when rows are added, so an empty or contiguous
+	   result takes the same memory whatever the size of the relation. */
 	(*cursor)->total_rows = rel->cardinality;
 
 	(*cursor)->storage_row_length = rel->row_length;
@@ -446,9 +536,12 @@ db_result_t cursor_deinit(db_cursor_t *cursor)
 	if (cursor == NULL) {
 		return DB_CURSOR_ERROR;
 	}
-	if (cursor->row_arr) {
-		free(cursor->row_arr);
-		cursor->row_arr = NULL;
+	if (cursor->handle != NULL) {
+		aql_deinit_handle(&cursor->handle);
+	}
+	if (cursor->ranges) {
+		free(cursor->ranges);
+		cursor->ranges = NULL;
 	}
 	free(cursor);
 	return DB_OK;
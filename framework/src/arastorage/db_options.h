@@ -127,6 +127,11 @@
 #define AQL_ATTRIBUTE_LIMIT             9
 #endif							/* AQL_ATTRIBUTE_LIMIT */
 
+/* The maximum number of '?' parameters in a prepared query. */
+#ifndef AQL_PARAMETER_LIMIT
+#define AQL_PARAMETER_LIMIT             8
+#endif							/* AQL_PARAMETER_LIMIT */
+
 /*----------------------------------------------------------------------------*/
 
 /*
@@ -165,18 +170,28 @@
 
 /* The maximum number of tuples in a relation. */
 #ifndef DB_TUPLE_LIMIT
-#define DB_TUPLE_LIMIT          1000
+#ifdef CONFIG_DB_TUPLES_LIMIT
+#define DB_TUPLE_LIMIT          CONFIG_DB_TUPLES_LIMIT
+#else
+#define DB_TUPLE_LIMIT          65536
+#endif
 #endif							/* DB_TUPLE_LIMIT */
 
-/* The number of int array in a cursor. */
-#ifndef DB_CURSOR_LIMIT
-#define DB_CURSOR_LIMIT          ((DB_TUPLE_LIMIT / (sizeof(uint32_t)*8)) + 1)
-#endif							/* DB_CURSOR_LIMIT */
+/* The maximum number of rows inserted by a transaction, kept in RAM
+   until it is committed. */
+#ifndef DB_TRANSACTION_ROWS
+#ifdef CONFIG_ARASTORAGE_TRANSACTION_ROWS
+#define DB_TRANSACTION_ROWS     CONFIG_ARASTORAGE_TRANSACTION_ROWS
+#else
+#define DB_TRANSACTION_ROWS     1024
+#endif
+#endif							/* DB_TRANSACTION_ROWS */
 
-/* The maximum number of tuples in a cursor. */
-#ifndef DB_CURSOR_RESULT_ENTRY
-#define DB_CURSOR_RESULT_ENTRY          ((DB_CURSOR_LIMIT) * (sizeof(uint32_t)*8))
-#endif							/* DB_CURSOR_RESULT_ENTRY */
+/* The number of ranges first allocated for the rows of a cursor, doubled
+   when they are used up. */
+#ifndef DB_CURSOR_RANGE_INIT
+#define DB_CURSOR_RANGE_INIT          8
+#endif							/* DB_CURSOR_RANGE_INIT */
 
 /* The name of the intermediate "result" relation file, which is used
    for presenting the result of a query to a user. */
@@ -205,8 +220,18 @@
 
 #define BUCKET_FILE_LENGTH 15
 
+#define HASH_FILE_NAME "hash"
+
+#define HASH_FILE_LENGTH 15
+
+#define OVERFLOW_FILE_NAME "hovf"
+
+#define OVERFLOW_FILE_LENGTH 15
+
 #define TEMP_FILE_SUFFIX ".tmp"
 
+#define UNDO_LOG_NAME "undo"
+
 #define TEMP_FILE_SUFFIX_LENGTH 4
 /*----------------------------------------------------------------------------*/
 
@@ -221,7 +246,26 @@
 #define DB_HEAP_INDEX_LIMIT             1
 #endif							/* DB_HEAP_INDEX_LIMIT */
 
-/* The maximum number of buckets cached in the MaxHeap index. */
+/* The bytes of RAM used by a bplustree index to cache its buckets. */
+#ifndef DB_HEAP_CACHE_SIZE
+#ifdef CONFIG_ARASTORAGE_BPTREE_BUCKET_CACHE_SIZE
+#define DB_HEAP_CACHE_SIZE              CONFIG_ARASTORAGE_BPTREE_BUCKET_CACHE_SIZE
+#else
+#define DB_HEAP_CACHE_SIZE              4096
+#endif
+#endif							/* DB_HEAP_CACHE_SIZE */
+
+/* The bytes of RAM used by a bplustree index to cache its nodes. */
+#ifndef DB_TREE_CACHE_SIZE
+#ifdef CONFIG_ARASTORAGE_BPTREE_NODE_CACHE_SIZE
+#define DB_TREE_CACHE_SIZE              CONFIG_ARASTORAGE_BPTREE_NODE_CACHE_SIZE
+#else
+#define DB_TREE_CACHE_SIZE              1024
+#endif
+#endif							/* DB_TREE_CACHE_SIZE */
+
+/* The minimum number of buckets and nodes cached whatever the sizes above,
+   splits and merges lock several entries at once. */
 #ifndef DB_HEAP_CACHE_LIMIT
 #define DB_HEAP_CACHE_LIMIT             6
 #endif							/* DB_HEAP_CACHE_LIMIT */
@@ -230,6 +274,35 @@
 #define DB_TREE_CACHE_LIMIT             10
 #endif
 
+/* The bytes of RAM used to sort the keys of a relation which already has
+   tuples when a bplustree index is created on it. More keys are sorted in
+   runs, which are merged through temporary files. */
+#ifndef DB_INDEX_SORT_SIZE
+#ifdef CONFIG_ARASTORAGE_BPTREE_SORT_BUFFER_SIZE
+#define DB_INDEX_SORT_SIZE              CONFIG_ARASTORAGE_BPTREE_SORT_BUFFER_SIZE
+#else
+#define DB_INDEX_SORT_SIZE              4096
+#endif
+#endif							/* DB_INDEX_SORT_SIZE */
+
+/* The bytes of a page of a hash index, holding keys of the same bucket. */
+#ifndef DB_HASH_PAGE_SIZE
+#ifdef CONFIG_ARASTORAGE_HASH_PAGE_SIZE
+#define DB_HASH_PAGE_SIZE               CONFIG_ARASTORAGE_HASH_PAGE_SIZE
+#else
+#define DB_HASH_PAGE_SIZE               256
+#endif
+#endif							/* DB_HASH_PAGE_SIZE */
+
+/* The number of pages of a hash index cached in RAM, at least 4. */
+#ifndef DB_HASH_CACHE_PAGES
+#ifdef CONFIG_ARASTORAGE_HASH_CACHE_PAGES
+#define DB_HASH_CACHE_PAGES             CONFIG_ARASTORAGE_HASH_CACHE_PAGES
+#else
+#define DB_HASH_CACHE_PAGES             4
+#endif
+#endif							/* DB_HASH_CACHE_PAGES */
+
 #ifdef DB_WIP
 #undef DB_WIP						/* DB WORK IN PROGRESS */
 #endif
@@ -249,6 +322,16 @@
 #define LVM_MAX_VARIABLE_ID             AQL_ATTRIBUTE_LIMIT - 1
 #endif							/* LVM_MAX_VARIABLE_ID */
 
+/* The maximum number of parameters bound into a condition. */
+#ifndef LVM_MAX_PARAMETER_ID
+#define LVM_MAX_PARAMETER_ID            AQL_PARAMETER_LIMIT
+#endif							/* LVM_MAX_PARAMETER_ID */
+
+/* The bytes of the string constants of a condition, with their terminators. */
+#ifndef LVM_STRING_SIZE
+#define LVM_STRING_SIZE                 64
+#endif							/* LVM_STRING_SIZE */
+
 /* Specify whether floats should be used or not inside the LVM. */
 #ifndef LVM_USE_FLOATS
 #define LVM_USE_FLOATS                  DB_FEATURE_FLOATS
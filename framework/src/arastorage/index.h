@@ -68,6 +68,8 @@
 #define INDEX_API_INLINE        0x04
 #define INDEX_API_COMPLETE      0x08
 #define INDEX_API_RANGE_QUERIES 0x10
+#define INDEX_API_BULK_LOAD     0x20	/* create() indexes the tuples the relation already has */
+#define INDEX_API_STRING_KEYS   0x40	/* string attributes can be indexed */
 
 /****************************************************************************
 * Public Type Definitions
@@ -77,7 +79,8 @@ struct index_api_s;
 enum index_e {
 	INDEX_NONE = 0,
 	INDEX_INLINE = 1,
-	INDEX_BPLUSTREE = 2
+	INDEX_BPLUSTREE = 2,
+	INDEX_HASH = 3
 };
 typedef enum index_e index_type_t;
 
@@ -108,6 +111,8 @@ struct index_iterator_s {
 	attribute_value_t max_value;
 	tuple_id_t next_item_no;
 	tuple_id_t found_items;
+	tuple_id_t rows;			/* tuples of the relation when the search started */
+	void *state;				/* search state of the index, freed by index_release_iterator() */
 };
 typedef struct index_iterator_s index_iterator_t;
 
@@ -121,6 +126,9 @@ struct index_api_s {
 	db_result_t(*insert)(index_t *, attribute_value_t *, tuple_id_t);
 	db_result_t(*delete)(index_t *, attribute_value_t *);
 	tuple_id_t(*get_next)(index_iterator_t *, uint8_t);
+	db_result_t(*flush)(index_t *);
+	/* Find the smallest or the largest key in a range without reading tuples, NULL if unsupported */
+	db_result_t(*get_edge)(index_t *, long, long, uint8_t, long *);
 };
 
 typedef struct index_api_s index_api_t;
@@ -130,6 +138,7 @@ typedef struct index_api_s index_api_t;
 ****************************************************************************/
 extern index_api_t index_inline;
 extern index_api_t index_bplustree;
+extern index_api_t index_hash;
 
 /****************************************************************************
  * Internal function prototypes
@@ -143,6 +152,9 @@ db_result_t index_insert(index_t *, attribute_value_t *, tuple_id_t);
 db_result_t index_delete(index_t *, attribute_value_t *);
 db_result_t index_get_iterator(index_iterator_t *, index_t *, attribute_value_t *, attribute_value_t *);
 tuple_id_t index_get_next(index_iterator_t *, uint8_t);
+void index_release_iterator(index_iterator_t *);
+db_result_t index_get_edge(index_t *, long, long, uint8_t, long *);
+db_result_t index_flush(void);
 int index_exists(attribute_t *);
 db_result_t index_deinit(void);
 #endif							/* !INDEX_H */
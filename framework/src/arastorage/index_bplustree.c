@@ -71,6 +71,11 @@
 #define DB_TUPLES_LIMIT CONFIG_DB_TUPLES_LIMIT
 #define PG_SIZE        1*sizeof(struct key_value_pair)
 #define BUCKET_SIZE      48
+#define INIT_CHUNK_SIZE  1024	/* Bytes written at once when the index files are created or flushed */
+#define BULK_FILL        (BUCKET_SIZE * 3 / 4)	/* Keys put in a bucket by a bulk load, the rest is left for inserts */
+#define BULK_LEVELS      16
+#define BULK_MIN_BLOCK   32	/* Minimum number of keys read at once from each run merged */
+#define BULK_FANIN       16	/* Maximum number of runs merged at once */
 #define NODE_DEPTH      2
 #define LEAF_NODES      pow(BRANCH_FACTOR, NODE_DEPTH)
 #define EMPTY_NODE(node)        (node)->val[BRANCH_FACTOR-1] == 0
@@ -79,7 +84,16 @@
 #define NODE_STATE_VALID 1
 #define NODE_STATE_LOCK 2
 #define NODE_STATE_DIRTY 4
-#define ROOT_NODE_PARENT 255
+#define ROOT_NODE_PARENT 0xffff
+
+/* Buckets are at least half full after a split, and nodes point to at least 3 children */
+#define KEYS_BUCKETS ((DB_TUPLES_LIMIT + BUCKET_SIZE / 2 - 1) / (BUCKET_SIZE / 2))
+#if CONFIG_BUCKETS_LIMIT - 1 < KEYS_BUCKETS
+#warning "CONFIG_BUCKETS_LIMIT is too small for the keys of CONFIG_DB_TUPLES_LIMIT tuples"
+#endif
+#if CONFIG_NODE_LIMIT < KEYS_BUCKETS / 2
+#warning "CONFIG_NODE_LIMIT is too small for the keys of CONFIG_DB_TUPLES_LIMIT tuples"
+#endif
 
 /* The total number of states possible of a node */
 #define NODE_STATES 255
@@ -124,12 +138,17 @@
 		cache_type->in_cache.tail->prev = node; \
 	} while (0)
 
+#define CACHE_OF(tree, type) ((type) == NODE ? (tree)->node_cache : (tree)->buck_cache)
+#define CACHE_LOCK_OF(tree, type) ((type) == NODE ? &(tree)->node_cache_lock : &(tree)->buck_cache_lock)
+#define CACHE_DATA(cache, node) ((void *)((cache)->data + (size_t)(node)->pos * (cache)->entry_size))
+#define CACHE_SLOT(cache, id) (&(cache)->slots[(id) & (cache)->mask])
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 struct key_value_pair_s {
 	int key;
-	uint16_t value;
+	tuple_id_t value;
 };
 typedef struct key_value_pair_s pair_t;
 
@@ -150,8 +169,9 @@ typedef struct bucket_s bucket_t;
 struct qnode_s {
 	struct qnode_s *next;
 	struct qnode_s *prev;
-	uint8_t id;
-	uint8_t pos;
+	struct qnode_s *hash_next;	/* Next valid entry in the same hash slot */
+	uint16_t id;
+	uint16_t pos;
 	uint8_t node_state;
 };
 
@@ -162,29 +182,24 @@ struct queue_s {
 };
 typedef struct queue_s queue_t;
 
-/* A Bucket Cache Entry */
-struct bucket_cache_s {
-	bucket_t bucket;
-};
-
-/* A Tree Cache Entry */
-struct tree_cache_s {
-	tree_node_t node;
-};
-
-/* Bucket Cache Structure */
-typedef struct {
-	struct bucket_cache_s cache_t[DB_HEAP_CACHE_LIMIT];
-	queue_t in_cache;
-	uint8_t num;
-} bucket_cache_t;
-
-/* Tree Cache Structure */
+/* Node or Bucket Cache Structure
+ * The entries are kept in the in_cache queue from the least to the most
+ * recently used, and the valid ones are also hashed by id so that they are
+ * found without walking the queue. All of it is allocated at once, the
+ * number of entries is given by the bytes of RAM the cache may use.
+ */
 typedef struct {
-	struct tree_cache_s cache_t[DB_TREE_CACHE_LIMIT];
 	queue_t in_cache;
-	uint8_t num;
-} tree_cache_t;
+	qnode_t ends[2];	/* head and tail of in_cache */
+	qnode_t *entries;	/* The entry at pos i holds the data at pos i */
+	qnode_t **slots;	/* Hash slots, each one a list of valid entries */
+	qnode_t **dirty;	/* Used to sort the dirty entries when flushing */
+	uint8_t *data;
+	size_t entry_size;
+	uint16_t limit;		/* Number of entries */
+	uint16_t num;		/* Number of entries used so far */
+	uint16_t mask;		/* Number of hash slots - 1 */
+} lru_cache_t;
 
 typedef enum {
 	NODE = 0,
@@ -234,14 +249,14 @@ typedef enum tree_result_e tree_result_t;
 struct tree_s {
 	db_storage_id_t tree_storage;	/* The fd to tree storage file */
 	db_storage_id_t bucket_storage;	/* The fd to bucket storage file */
-	uint8_t off_nodes, off_buckets;	/*  Maintaining number of nodes and buckets used by the index structure */
-	uint8_t root;				/*   The node id of the root of the bplus-tree */
+	uint16_t off_nodes, off_buckets;	/*  Maintaining number of nodes and buckets used by the index structure */
+	uint16_t root;				/*   The node id of the root of the bplus-tree */
 	uint8_t lock_buckets[CONFIG_BUCKETS_LIMIT];	/* The structure to prevent to tasks to simultaneously edit same buckets  */
-	uint16_t inserted;			/*  Count of total number of tuples inserted  */
-	uint16_t deleted;			/*    Count of total number of tuples deleted  */
+	tuple_id_t inserted;			/*  Count of total number of tuples inserted  */
+	tuple_id_t deleted;			/*    Count of total number of tuples deleted  */
 	uint8_t levels;				/*  The depth of the bplus-tree including the buckets  */
-	tree_cache_t *node_cache;	/*  Structure to maintain node cache  */
-	bucket_cache_t *buck_cache;	/*   Structure to maintain bucket cache  */
+	lru_cache_t *node_cache;	/*  Structure to maintain node cache  */
+	lru_cache_t *buck_cache;	/*   Structure to maintain bucket cache  */
 	pthread_mutex_t node_cache_lock;	/*  Maintains concurrency control over Node Cache  */
 	pthread_mutex_t buck_cache_lock;	/*  Maintains concurrency control over Bucket Cache  */
 	pthread_mutex_t bucket_lock;	/*  Maintains serialisability over in RAM Tree Structure  */
@@ -249,6 +264,12 @@ struct tree_s {
 };
 typedef struct tree_s tree_t;
 
+/* State of a search, see get_next */
+struct tree_search_s {
+	bucket_t bucket;			/* copy of the bucket being read */
+	uint8_t slot;				/* next pair of the bucket to compare */
+};
+
 /****************************************************************************
  * Private variables
  ****************************************************************************/
@@ -262,18 +283,21 @@ static tree_node_t *tree_read(tree_t *, int);
 static int tree_write(tree_t *, int, tree_node_t *);
 static tree_result_t tree_insert(tree_t *, int);
 static pair_t *tree_find(tree_t *, int key);
-tree_result_t insert_item_btree(tree_t *, int, int);
+tree_result_t insert_item_btree(tree_t *, int, tuple_id_t);
 
 static bucket_t *bucket_read(tree_t *, int);
 static int bucket_write(tree_t *, int, bucket_t *);
-static bsplit_status_t bucket_split(tree_t *, int, int, pair_t *);
+static bsplit_status_t bucket_split(tree_t *, int, tuple_id_t, pair_t *);
 static cache_result_t cache_bucket_append(tree_t *, int, pair_t *);
-static cache_result_t cache_write_bucket(tree_t *, int, bucket_t *);
 
+static lru_cache_t *cache_create(size_t, size_t, uint16_t);
+static void *cache_read(tree_t *, cache_type_t, int);
+static cache_result_t cache_write(tree_t *, cache_type_t, int, void *);
+static db_result_t cache_flush(tree_t *, cache_type_t);
 static cache_result_t modify_cache(tree_t *, int, cache_type_t, op_type_t);
-static cache_result_t cache_write_node(tree_t *, int, tree_node_t *);
 static cache_result_t cache_replace_node(tree_t *, int, tree_node_t *);
 static db_result_t delete_item_btree(index_t *index, int value);
+static db_result_t bulk_load(tree_t *, index_t *, tuple_id_t);
 
 static db_result_t create(index_t *);
 static db_result_t destroy(index_t *);
@@ -282,6 +306,9 @@ static db_result_t release(index_t *);
 static db_result_t insert(index_t *, attribute_value_t *, tuple_id_t);
 static db_result_t delete(index_t *, attribute_value_t *);
 static tuple_id_t get_next(index_iterator_t *, uint8_t);
+static tuple_id_t get_next_remove(index_iterator_t *);
+static db_result_t flush(index_t *);
+static db_result_t get_edge(index_t *, long, long, uint8_t, long *);
 
 #ifdef DB_WIP
 static db_result_t vacuum(tree_t *, relation_t *);
@@ -290,19 +317,21 @@ static db_result_t vacuum(tree_t *, relation_t *);
 * Private Functions
 ****************************************************************************/
 #ifdef CONFIG_ARASTORAGE_ENABLE_FLUSHING
-static int db_flush(tree_t *, relation_t *);
+static int purge_old_tuples(tree_t *, relation_t *);
 #endif
 
 index_api_t index_bplustree = {
 	INDEX_BPLUSTREE,
-	INDEX_API_EXTERNAL | INDEX_API_RANGE_QUERIES,
+	INDEX_API_EXTERNAL | INDEX_API_RANGE_QUERIES | INDEX_API_BULK_LOAD,
 	create,
 	destroy,
 	load,
 	release,
 	insert,
 	delete,
-	get_next
+	get_next,
+	flush,
+	get_edge
 };
 
 /****************************************************************************
@@ -344,13 +373,16 @@ static db_result_t create(index_t *index)
 	/* Files storing tree and bucket data */
 	char tree_filename[DB_MAX_FILENAME_LENGTH];
 	char bucket_filename[DB_MAX_FILENAME_LENGTH];
-	tree_node_t *tree_node;
+	void *chunk;
 	size_t tree_node_size = 0;
 	bucket_t *buck;
 	size_t buck_size = 0;
+	size_t written;
+	size_t size;
 	int offset = 0;
 	db_result_t result;
-	uint8_t success = 0;
+	db_storage_id_t fd;
+	tuple_id_t cardinality;
 	int curtime;
 
 	curtime = time(NULL);
@@ -364,7 +396,13 @@ static db_result_t create(index_t *index)
 	}
 
 	/* Generating the file to store the tree structure */
-	snprintf(tree_filename, HEAP_FILE_LENGTH, "%s.%x\0", HEAP_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+	snprintf(tree_filename, HEAP_FILE_LENGTH, "%s.%x", HEAP_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+	/* The seed is the time, so an index created in the same second would get the files of another one */
+	while ((fd = storage_open(tree_filename, O_RDWR)) >= 0) {
+		DB_LOG_D("DB: tree file = %s already exist, try another\n", tree_filename);
+		storage_close(fd);
+		snprintf(tree_filename, HEAP_FILE_LENGTH, "%s.%x", HEAP_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+	}
 
 	result = storage_generate_file(tree_filename);
 	if (result == DB_INDEX_ERROR) {
@@ -378,7 +416,12 @@ static db_result_t create(index_t *index)
 	DB_LOG_D("DB: Generated the tree file \"%s\" using %u bytes of space\n", index->descriptor_file, tree_node_size);
 
 	/* Generating bucket file to store <key, tuple_id> pair */
-	snprintf(bucket_filename, BUCKET_FILE_LENGTH, "%s.%x\0", BUCKET_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+	snprintf(bucket_filename, BUCKET_FILE_LENGTH, "%s.%x", BUCKET_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+	while ((fd = storage_open(bucket_filename, O_RDWR)) >= 0) {
+		DB_LOG_D("DB: bucket file = %s already exist, try another\n", bucket_filename);
+		storage_close(fd);
+		snprintf(bucket_filename, BUCKET_FILE_LENGTH, "%s.%x", BUCKET_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+	}
 
 	result = storage_generate_file(bucket_filename);
 	if (result == DB_INDEX_ERROR) {
@@ -414,20 +457,25 @@ static db_result_t create(index_t *index)
 	storage_write_to(tree->tree_storage, bucket_filename, offset, sizeof(bucket_filename));
 	offset += sizeof(bucket_filename);
 	base_offset = offset;
-	tree_node = bptree_malloc(tree_node_size);
-	if (tree_node) {
-		storage_write_to(tree->tree_storage, tree_node, offset, tree_node_size);
-		free(tree_node);
-	}
-
-	buck = bptree_malloc(buck_size);
-	if (buck) {
-		buck[0].next_free_slot = 0;
-		buck[0].info[0] = CONFIG_BUCKETS_LIMIT - 1;
-		buck[0].info[1] = KEY_MAX;
-		buck[0].info[2] = 0;
-		storage_write_to(tree->bucket_storage, buck, 0, buck_size);
-		free(buck);
+	/* Zero both files in chunks, the limits may be far larger than the RAM */
+	chunk = bptree_malloc(max(INIT_CHUNK_SIZE, sizeof(bucket_t)));
+	if (chunk) {
+		for (written = 0; written < tree_node_size; written += size) {
+			size = min(tree_node_size - written, (size_t)INIT_CHUNK_SIZE);
+			storage_write_to(tree->tree_storage, chunk, offset + written, size);
+		}
+
+		buck = (bucket_t *)chunk;
+		buck->info[0] = CONFIG_BUCKETS_LIMIT - 1;
+		buck->info[1] = KEY_MAX;
+		buck->info[2] = 0;
+		storage_write_to(tree->bucket_storage, buck, 0, sizeof(bucket_t));
+		memset(chunk, 0, sizeof(bucket_t));
+		for (written = sizeof(bucket_t); written < buck_size; written += size) {
+			size = min(buck_size - written, (size_t)INIT_CHUNK_SIZE);
+			storage_write_to(tree->bucket_storage, chunk, written, size);
+		}
+		free(chunk);
 	}
 	
 	/* One is the root node and one is the bucket layer */
@@ -437,76 +485,18 @@ static db_result_t create(index_t *index)
 	/* Initialize the tree metadata. */
 	memset(&tree->lock_buckets, 0, sizeof(tree->lock_buckets));
 
-	/* Allocating node cache and initialising it */
-	tree->node_cache = bptree_malloc(sizeof(tree_cache_t));
-	if (tree->node_cache != NULL) {
-		success |= 1;
-		qnode_t *head = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-		if (head != NULL) {
-			success |= 2;
-			tree->node_cache->in_cache.head = head;
-			qnode_t *end = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-			if (end != NULL) {
-				success |= 4;
-				head->prev = NULL;
-				end->next = NULL;
-				head->next = end;
-				end->prev = head;
-				tree->node_cache->in_cache.tail = end;
-				tree->node_cache->num = 0;
-			}
-		}
-	}
-	if (success != 7) {
-		DB_LOG_E("FAILED TO ALLOCATE NODE CACHE\n");
+	/* Allocating node and bucket caches */
+	tree->node_cache = cache_create(sizeof(tree_node_t), DB_TREE_CACHE_SIZE, DB_TREE_CACHE_LIMIT);
+	tree->buck_cache = cache_create(sizeof(bucket_t), DB_HEAP_CACHE_SIZE, DB_HEAP_CACHE_LIMIT);
+	if (tree->node_cache == NULL || tree->buck_cache == NULL) {
+		DB_LOG_E("FAILED TO ALLOCATE NODE OR BUCKET CACHE\n");
 		result = DB_ALLOCATION_ERROR;
+		storage_close(tree->bucket_storage);
+		storage_close(tree->tree_storage);
 		storage_remove(tree_filename);
 		storage_remove(bucket_filename);
-		if (success & 1) {
-			if (success & 2) {
-				free(tree->node_cache->in_cache.head);
-			}
-			free(tree->node_cache);
-		}
-		free(tree);
-		return result;
-	}
-
-	/* Allocating bucket cache and initialising it */
-	tree->buck_cache = bptree_malloc(sizeof(bucket_cache_t));
-	success = 0;
-	if (tree->buck_cache != NULL) {
-		success |= 1;
-		qnode_t *head = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-		if (head != NULL) {
-			success |= 2;
-			tree->buck_cache->in_cache.head = head;
-			qnode_t *end = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-			if (end != NULL) {
-				success |= 4;
-				head->prev = NULL;
-				end->next = NULL;
-				head->next = end;
-				end->prev = head;
-				tree->buck_cache->in_cache.tail = end;
-				tree->buck_cache->num = 0;
-			}
-		}
-	}
-	if (success != 7) {
-		DB_LOG_E("FAILED TO ALLOCATE BUCKET CACHE\n");
-		result = DB_ALLOCATION_ERROR;
-		free(tree->node_cache->in_cache.tail);
-		free(tree->node_cache->in_cache.head);
 		free(tree->node_cache);
-		storage_remove(tree_filename);
-		storage_remove(bucket_filename);
-		if (success & 1) {
-			if (success & 2) {
-				free(tree->buck_cache->in_cache.head);
-			}
-			free(tree->buck_cache);
-		}
+		free(tree->buck_cache);
 		free(tree);
 		return result;
 	}
@@ -522,8 +512,20 @@ static db_result_t create(index_t *index)
 
 	tree->off_nodes = tree->off_buckets = 0;
 
-	/* Inserting first value to initialise the tree data structure */
-	if (tree_insert(tree, KEY_MAX) != TREE_OK) {
+	cardinality = relation_cardinality(index->rel);
+	if (cardinality > 0 && cardinality != INVALID_TUPLE) {
+		/* Building the tree from the sorted keys of the tuples the relation already has */
+		result = bulk_load(tree, index, cardinality);
+		if (DB_ERROR(result)) {
+			DB_LOG_E("DB: Failed to index the %lu tuples of %s\n", (unsigned long)cardinality, index->rel->name);
+			release(index);
+			index->opaque_data = NULL;
+			storage_remove(tree_filename);
+			storage_remove(bucket_filename);
+			return result;
+		}
+	} else if (tree_insert(tree, KEY_MAX) != TREE_OK) {
+		/* Inserting first value to initialise the tree data structure */
 		result = DB_STORAGE_ERROR;
 		return result;
 	}
@@ -562,8 +564,6 @@ static db_result_t load(index_t *index)
 	tree_t *tree;
 	db_storage_id_t fd;
 	char bucket_file[DB_MAX_FILENAME_LENGTH];
-	db_result_t result;
-	uint8_t success = 0;
 
 	index->opaque_data = tree = bptree_malloc(sizeof(tree_t));
 	if (tree == NULL) {
@@ -592,74 +592,22 @@ static db_result_t load(index_t *index)
 	}
 	storage_close(fd);
 
-	tree->node_cache = bptree_malloc(sizeof(tree_cache_t));
-	if (tree->node_cache != NULL) {
-		success |= 1;
-		qnode_t *head = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-		if (head != NULL) {
-			success |= 2;
-			tree->node_cache->in_cache.head = head;
-			qnode_t *end = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-			if (end != NULL) {
-				success |= 4;
-				head->prev = NULL;
-				end->next = NULL;
-				head->next = end;
-				end->prev = head;
-				tree->node_cache->in_cache.tail = end;
-				tree->node_cache->num = 0;
-			}
-		}
-	}
-	if (success != 7) {
-		DB_LOG_E("FAILED TO ALLOCATE NODE CACHE\n");
-		result = DB_ALLOCATION_ERROR;
-		if (success & 1) {
-			if (success & 2) {
-				free(tree->node_cache->in_cache.head);
-			}
-			free(tree->node_cache);
-		}
-		free(tree);
-		return result;
-	}
-
-	/* Allocating bucket cache and initialising it  */
-	tree->buck_cache = bptree_malloc(sizeof(bucket_cache_t));
-	success = 0;
-	if (tree->buck_cache != NULL) {
-		success |= 1;
-		qnode_t *head = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-		if (head != NULL) {
-			success |= 2;
-			tree->buck_cache->in_cache.head = head;
-			qnode_t *end = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-			if (end != NULL) {
-				success |= 4;
-				head->prev = NULL;
-				end->next = NULL;
-				head->next = end;
-				end->prev = head;
-				tree->buck_cache->in_cache.tail = end;
-				tree->buck_cache->num = 0;
-			}
-		}
-	}
-	if (success != 7) {
-		DB_LOG_E("FAILED TO ALLOCATE BUCKET CACHE\n");
-		result = DB_ALLOCATION_ERROR;
-		free(tree->node_cache->in_cache.tail);
-		free(tree->node_cache->in_cache.head);
+	/* The pointers, locks and bucket locks saved with the tree are stale */
+	tree->node_cache = cache_create(sizeof(tree_node_t), DB_TREE_CACHE_SIZE, DB_TREE_CACHE_LIMIT);
+	tree->buck_cache = cache_create(sizeof(bucket_t), DB_HEAP_CACHE_SIZE, DB_HEAP_CACHE_LIMIT);
+	if (tree->node_cache == NULL || tree->buck_cache == NULL) {
+		DB_LOG_E("FAILED TO ALLOCATE NODE OR BUCKET CACHE\n");
 		free(tree->node_cache);
-		if (success & 1) {
-			if (success & 2) {
-				free(tree->buck_cache->in_cache.head);
-			}
-			free(tree->buck_cache);
-		}
+		free(tree->buck_cache);
 		free(tree);
-		return result;
+		index->opaque_data = NULL;
+		return DB_ALLOCATION_ERROR;
 	}
+	memset(&tree->lock_buckets, 0, sizeof(tree->lock_buckets));
+	pthread_mutex_init(&(tree->node_cache_lock), NULL);
+	pthread_mutex_init(&(tree->bucket_lock), NULL);
+	pthread_mutex_init(&(tree->buck_cache_lock), NULL);
+	rw_init(&(tree->tree_lock));
 
 	base_offset = sizeof(tree_t) + sizeof(bucket_file);
 	tree->tree_storage = storage_open(index->descriptor_file, O_RDWR);
@@ -674,7 +622,7 @@ static db_result_t load(index_t *index)
 static db_result_t release(index_t *index)
 {
 	tree_t *tree;
-	qnode_t *tmp_node;
+	db_result_t result;
 
 	tree = index->opaque_data;
 	if (tree == NULL) {
@@ -683,45 +631,40 @@ static db_result_t release(index_t *index)
 	if (tree->node_cache == NULL || tree->buck_cache == NULL) {
 		return DB_ALLOCATION_ERROR;
 	}
-	if ((tree->node_cache->in_cache.tail == NULL) || (tree->node_cache->in_cache.head == NULL)) {
-		return DB_ALLOCATION_ERROR;
-	}
-	if ((tree->buck_cache->in_cache.tail == NULL) || (tree->buck_cache->in_cache.head == NULL)) {
-		return DB_ALLOCATION_ERROR;
-	}
-	storage_write_to(tree->tree_storage, tree, 0, sizeof(tree_t));
-	/* Bucket Cache being flushed */
-	tmp_node = tree->buck_cache->in_cache.head->next;
-	free(tmp_node->prev);
-	while (tmp_node != tree->buck_cache->in_cache.tail) {
-		if ((tmp_node->node_state & NODE_STATE_DIRTY) && (tmp_node->node_state & NODE_STATE_VALID)) {
-			bucket_write(tree, tmp_node->id, &(tree->buck_cache->cache_t[tmp_node->pos].bucket));
-		}
-		tmp_node = tmp_node->next;
-		if (tmp_node->prev) {
-			free(tmp_node->prev);
-		}
-	}
-	free(tree->buck_cache->in_cache.tail);
-	tmp_node = tree->node_cache->in_cache.head->next;
-	free(tmp_node->prev);
-	while (tmp_node != tree->node_cache->in_cache.tail) {
-		if ((tmp_node->node_state & NODE_STATE_DIRTY) && (tmp_node->node_state & NODE_STATE_VALID)) {
-			tree_write(tree, tmp_node->id, &(tree->node_cache->cache_t[tmp_node->pos].node));
-		}
-		tmp_node = tmp_node->next;
-		if (tmp_node->prev) {
-			free(tmp_node->prev);
-		}
-	}
-	free(tree->node_cache->in_cache.tail);
+	result = flush(index);
 	storage_close(tree->bucket_storage);
 	storage_close(tree->tree_storage);
 
 	free(tree->node_cache);
 	free(tree->buck_cache);
 	free(tree);
-	return DB_OK;
+	return result;
+}
+
+/****************************************************************************
+ * Name: flush
+ *
+ * Description: Writes the changed buckets and nodes kept in the caches,
+ *              then the tree structure pointing to them
+ *
+ ****************************************************************************/
+static db_result_t flush(index_t *index)
+{
+	tree_t *tree;
+	db_result_t result;
+
+	tree = index->opaque_data;
+	if (tree == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+	result = cache_flush(tree, BUCKET);
+	if (DB_SUCCESS(result)) {
+		result = cache_flush(tree, NODE);
+	}
+	if (DB_SUCCESS(result)) {
+		result = storage_write_to(tree->tree_storage, tree, 0, sizeof(tree_t));
+	}
+	return result;
 }
 
 /****************************************************************************
@@ -742,11 +685,11 @@ static db_result_t insert(index_t *index, attribute_value_t *key, tuple_id_t val
 
 #ifdef CONFIG_ARASTORAGE_ENABLE_FLUSHING
 	if ((tree->inserted) >= DB_TUPLES_LIMIT) {
-		db_flush(tree, index->rel);
+		purge_old_tuples(tree, index->rel);
 		value = value - DB_TUPLES_LIMIT / 2;
 	}
 #endif
-	if (insert_item_btree(tree, (int)long_key, (int)value) == TREE_INSERT_FAIL) {
+	if (insert_item_btree(tree, (int)long_key, value) == TREE_INSERT_FAIL) {
 		DB_LOG_E("DB: Failed to insert key %ld into a bplus-tree index\n", long_key);
 		return DB_INDEX_ERROR;
 	}
@@ -757,27 +700,7 @@ static db_result_t insert(index_t *index, attribute_value_t *key, tuple_id_t val
 	 *	and write back is preferred.
 	 ***************************************************************************************/
 #ifdef DB_WIP
-	qnode_t *tmp_node;
-	storage_write_to(tree->tree_storage, tree, 0, sizeof(tree_t));
-
-	/* Bucket Cache being flushed */
-
-	tmp_node = tree->buck_cache->in_cache.head->next;
-	while (tmp_node != tree->buck_cache->in_cache.tail) {
-		if ((tmp_node->node_state & NODE_STATE_DIRTY) && (tmp_node->node_state & NODE_STATE_VALID)) {
-			bucket_write(tree, tmp_node->id, &(tree->buck_cache->cache_t[tmp_node->pos].bucket));
-			UNSET_NODE_STATE(tmp_node, NODE_STATE_DIRTY);
-		}
-		tmp_node = tmp_node->next;
-	}
-	tmp_node = tree->node_cache->in_cache.head->next;
-	while (tmp_node != tree->node_cache->in_cache.tail) {
-		if ((tmp_node->node_state & NODE_STATE_DIRTY) && (tmp_node->node_state & NODE_STATE_VALID)) {
-			tree_write(tree, tmp_node->id, &(tree->node_cache->cache_t[tmp_node->pos].node));
-			UNSET_NODE_STATE(tmp_node, NODE_STATE_DIRTY);
-		}
-		tmp_node = tmp_node->next;
-	}
+	flush(index);
 #endif
 	return DB_OK;
 }
@@ -810,16 +733,207 @@ static uint16_t next_bucket(tree_t *tree, bucket_t *bucket)
 	return next_bucket;
 }
 
+/****************************************************************************
+ * Name: lock_bucket
+ *
+ * Description: Waits until no other task edits or reads a bucket and locks
+ *              it. Writers lock the bucket they insert into in tree_find().
+ *
+ ****************************************************************************/
+static void lock_bucket(tree_t *tree, uint16_t bucket_id)
+{
+	pthread_mutex_lock(&(tree->bucket_lock));
+	while (tree->lock_buckets[bucket_id] == 1) {
+		pthread_mutex_unlock(&(tree->bucket_lock));
+		DB_LOG_D("BUCKET ALREADY LOCKED SPINNING\n");
+		pthread_mutex_lock(&(tree->bucket_lock));
+	}
+	tree->lock_buckets[bucket_id] = 1;
+	pthread_mutex_unlock(&(tree->bucket_lock));
+}
+
+static void unlock_bucket(tree_t *tree, uint16_t bucket_id)
+{
+	pthread_mutex_lock(&(tree->bucket_lock));
+	tree->lock_buckets[bucket_id] = 0;
+	pthread_mutex_unlock(&(tree->bucket_lock));
+}
+
+/****************************************************************************
+ * Name: bucket_copy
+ *
+ * Description: Copies a bucket as it is between two edits, so that it can
+ *              be read while writers change the bucket in the cache.
+ *
+ ****************************************************************************/
+static bool bucket_copy(tree_t *tree, uint16_t bucket_id, bucket_t *copy)
+{
+	bucket_t *bucket;
+
+	lock_bucket(tree, bucket_id);
+	bucket = bucket_read(tree, bucket_id);
+	if (bucket != NULL) {
+		memcpy(copy, bucket, sizeof(bucket_t));
+		modify_cache(tree, bucket_id, BUCKET, UNLOCK);
+	}
+	unlock_bucket(tree, bucket_id);
+
+	return bucket != NULL;
+}
+
+/****************************************************************************
+ * Name: tree_find_bucket
+ *
+ * Description: Returns the id of the bucket which holds a key, or -1 when a
+ *              node is being read by another task and the search has to be
+ *              tried again. Unlike tree_find(), the bucket isn't locked.
+ *
+ ****************************************************************************/
+static int tree_find_bucket(tree_t *tree, int key)
+{
+	tree_node_t *node;
+	uint16_t id;
+	uint16_t child;
+	bool is_leaf;
+	int j;
+
+	/* Splits change the nodes from the top down, the read lock keeps them
+	   out while the path is followed */
+	rw_lock_read(&(tree->tree_lock));
+	id = tree->root;
+	do {
+		node = tree_read(tree, id);
+		if (node == NULL) {
+			rw_unlock_read(&(tree->tree_lock));
+			return -1;
+		}
+		for (j = 0; j < node->val[BRANCH_FACTOR - 1] && node->val[j] <= key; j++) {
+		}
+		child = node->id[j];
+		is_leaf = node->is_leaf;
+		modify_cache(tree, id, NODE, UNLOCK);
+		id = child;
+	} while (!is_leaf);
+	rw_unlock_read(&(tree->tree_lock));
+
+	return id;
+}
+
+/****************************************************************************
+ * Name: search_key
+ *
+ * Description: Returns a bound of a search as a key. The bounds are longs,
+ *              which are wider than the int keys on 64-bit hosts, e.g. the
+ *              DB_LONG_MIN of a search without a lower bound.
+ *
+ ****************************************************************************/
+static int search_key(attribute_value_t *value)
+{
+	long key;
+
+	key = db_value_to_long(value);
+	if (key < INT_MIN) {
+		return INT_MIN;
+	} else if (key > INT_MAX) {
+		return INT_MAX;
+	}
+	return (int)key;
+}
+
 /****************************************************************************
  * Name: get_next
  *
- * Description: Returns the tuple id of the next valid tuple for the case of
- *              select and remove queries
+ * Description: Returns the tuple id of the next key in the range of a
+ *              select query.
+ *
+ *              The buckets are read from copies, so inserts go on while the
+ *              search runs. A bucket split keeps the lower keys in the bucket
+ *              and chains the upper ones right after it, so following the
+ *              chain from a copy taken before or after the split finds every
+ *              key the search started with. Keys inserted in the meantime
+ *              may be found too, index_get_next() skips their tuples.
  *
  ****************************************************************************/
 static tuple_id_t get_next(index_iterator_t *iterator, uint8_t matched_condition)
 {
+	struct tree_search_s *search;
+	tree_t *tree;
+	pair_t *pair;
+	uint16_t next;
+	int bucket_id;
+	int key_max;
+	int key_min;
+
+	if (matched_condition == FALSE) {
+		return get_next_remove(iterator);
+	}
+
+	key_min = search_key(&iterator->min_value);
+	key_max = search_key(&iterator->max_value);
+	tree = (tree_t *)iterator->index->opaque_data;
+	search = (struct tree_search_s *)iterator->state;
+
+	if (search == NULL) {
+		if (iterator->next_item_no != 0 || iterator->found_items != 0) {
+			/* The search is over */
+			return INVALID_TUPLE;
+		}
+		search = bptree_malloc(sizeof(struct tree_search_s));
+		if (search == NULL) {
+			return INVALID_TUPLE;
+		}
+		/* A split may leave keys equal to a separator left of it, so the
+		   search starts from the bucket before the separator of key_min */
+		while ((bucket_id = tree_find_bucket(tree, key_min > INT_MIN ? key_min - 1 : key_min)) < 0) {
+			DB_LOG_D("NODE ALREADY LOCKED IN GET NEXT SPINNING\n");
+		}
+		if (!bucket_copy(tree, bucket_id, &search->bucket)) {
+			free(search);
+			return INVALID_TUPLE;
+		}
+		search->slot = 0;
+		iterator->state = search;
+	}
+
+	while (true) {
+		while (search->slot < search->bucket.next_free_slot) {
+			pair = &search->bucket.pairs[search->slot++];
+			if (key_min <= pair->key && pair->key <= key_max) {
+				iterator->found_items++;
+				iterator->next_item_no = iterator->found_items;
+				return pair->value;
+			}
+		}
 
+		next = next_bucket(tree, &search->bucket);
+		if (next == (uint16_t)-1 || !bucket_copy(tree, next, &search->bucket) || search->bucket.info[1] > key_max) {
+			break;
+		}
+		search->slot = 0;
+	}
+
+	if (iterator->found_items == 0) {
+		iterator->next_item_no = 0;
+	} else {
+		iterator->next_item_no = 1;
+	}
+	free(search);
+	iterator->state = NULL;
+
+	return INVALID_TUPLE;
+}
+
+/****************************************************************************
+ * Name: get_next_remove
+ *
+ * Description: Returns the tuple id of the next key in the range and
+ *              removes the key from its bucket. The buckets are edited in
+ *              the cache, so the tree is write locked until the iteration
+ *              ends.
+ *
+ ****************************************************************************/
+static tuple_id_t get_next_remove(index_iterator_t *iterator)
+{
 	/* This cache holds a pointer to a bucket in the main cache and other
 	 * information required to iterate over the bucket
 	 */
@@ -836,15 +950,17 @@ static tuple_id_t get_next(index_iterator_t *iterator, uint8_t matched_condition
 	int key_max;
 	int key_min;
 	tree_t *tree;
-	key_min = *(int *)&iterator->min_value;
-	key_max = *(int *)&iterator->max_value;
+	key_min = search_key(&iterator->min_value);
+	key_max = search_key(&iterator->max_value);
 	tree = (tree_t *)iterator->index->opaque_data;
 
 	/* To initialize the iterator_cache */
 	if (iterator->next_item_no == 0) {	/* removed the condition of iterator inequality */
 		if (iterator->found_items == 0) {
 			rw_lock_write(&(tree->tree_lock));
-			pair_t *path = tree_find(tree, key_min);
+			/* A split may leave keys equal to a separator left of it, so the
+			   iteration starts from the bucket before the separator of key_min */
+			pair_t *path = tree_find(tree, key_min > INT_MIN ? key_min - 1 : key_min);
 			if (path == NULL) {
 				return INVALID_TUPLE;
 			}
@@ -866,49 +982,38 @@ static tuple_id_t get_next(index_iterator_t *iterator, uint8_t matched_condition
 			iterator->found_items++;
 			iterator->next_item_no = iterator->found_items;
 
-			/* matched condition is FALSE when the query is for remove tuples */
-			if (matched_condition == FALSE) {
-				tuple_id_t tmp = cache.bucket->pairs[i].value;
-				if (cache.end > (i + 1)) {
-					cache.bucket->pairs[i] = cache.bucket->pairs[cache.end - 1];
-
-					/* Start Bucket chaining */
-					int iter = 0;
-					uint16_t new_min = cache.bucket->info[1];
-					uint16_t new_max = cache.bucket->info[2];
-					for (; iter < cache.bucket->next_free_slot - 1; iter++) {
-						new_min = min(cache.bucket->pairs[iter].key, new_min);
-						new_max = max(cache.bucket->pairs[iter].key, new_max);
-					}
-					cache.bucket->info[1] = new_min;
-					cache.bucket->info[2] = new_max;
-					/* End of Bucket chaining */
+			tuple_id_t tmp = cache.bucket->pairs[i].value;
+			if (cache.end > (i + 1)) {
+				cache.bucket->pairs[i] = cache.bucket->pairs[cache.end - 1];
+
+				/* Start Bucket chaining */
+				int iter = 0;
+				uint16_t new_min = cache.bucket->info[1];
+				uint16_t new_max = cache.bucket->info[2];
+				for (; iter < cache.bucket->next_free_slot - 1; iter++) {
+					new_min = min(cache.bucket->pairs[iter].key, new_min);
+					new_max = max(cache.bucket->pairs[iter].key, new_max);
 				}
-
-				cache.bucket->next_free_slot--;
-				tree->deleted++;
-				cache.end--;
-				cache.start = i;
-				return tmp;
-			} else {
-				cache.start = i + 1;
+				cache.bucket->info[1] = new_min;
+				cache.bucket->info[2] = new_max;
+				/* End of Bucket chaining */
 			}
-			return cache.bucket->pairs[i].value;
+
+			cache.bucket->next_free_slot--;
+			tree->deleted++;
+			cache.end--;
+			cache.start = i;
+			return tmp;
 		}
 	}
 
-	/* case when delete query comes */
-	if (matched_condition == FALSE) {
-		modify_cache(tree, cache.bucket_id, BUCKET, INVALIDATE);
-		cache_write_bucket(tree, cache.bucket_id, cache.bucket);
+	modify_cache(tree, cache.bucket_id, BUCKET, INVALIDATE);
+	cache_write(tree, BUCKET, cache.bucket_id, cache.bucket);
 #ifdef DB_WIP
-		if ((int)((double)(tree->deleted) * 100 / tree->inserted) >= VACUUM_THRESHOLD) {
-			vacuum(tree, iterator->index->rel);
-		}
-#endif
-	} else {
-		modify_cache(tree, cache.bucket_id, BUCKET, UNLOCK);
+	if ((int)((double)(tree->deleted) * 100 / tree->inserted) >= VACUUM_THRESHOLD) {
+		vacuum(tree, iterator->index->rel);
 	}
+#endif
 	pthread_mutex_lock(&(tree->bucket_lock));
 	tree->lock_buckets[cache.bucket_id] = 0;
 	cache.bucket_id = next_bucket(tree, cache.bucket);
@@ -952,7 +1057,133 @@ static tuple_id_t get_next(index_iterator_t *iterator, uint8_t matched_condition
 	cache.end = cache.bucket->next_free_slot;
 
 	iterator->next_item_no = 1;
-	return get_next(iterator, matched_condition);
+	return get_next_remove(iterator);
+}
+
+/****************************************************************************
+ * Name: bucket_edge
+ *
+ * Description: Finds the smallest or the largest key of a bucket which is
+ *              in the range [min, max]. The keys of a bucket are unsorted,
+ *              so all of them are compared.
+ *
+ ****************************************************************************/
+static bool bucket_edge(tree_t *tree, uint16_t bucket_id, int min, int max, uint8_t largest, int *key)
+{
+	bucket_t *bucket;
+	bool found;
+	int i;
+
+	lock_bucket(tree, bucket_id);
+
+	found = false;
+	bucket = bucket_read(tree, bucket_id);
+	if (bucket != NULL) {
+		for (i = 0; i < bucket->next_free_slot; i++) {
+			if (bucket->pairs[i].key < min || bucket->pairs[i].key > max) {
+				continue;
+			}
+			if (!found || (largest ? bucket->pairs[i].key > *key : bucket->pairs[i].key < *key)) {
+				*key = bucket->pairs[i].key;
+				found = true;
+			}
+		}
+		modify_cache(tree, bucket_id, BUCKET, UNLOCK);
+	}
+	unlock_bucket(tree, bucket_id);
+
+	return found;
+}
+
+/****************************************************************************
+ * Name: edge_search
+ *
+ * Description: Descends from a node into the children which may hold keys
+ *              of the range [min, max], in ascending order for the smallest
+ *              key and in descending order for the largest one, and stops
+ *              at the first bucket that has a key in the range.
+ *
+ ****************************************************************************/
+static db_result_t edge_search(tree_t *tree, uint16_t id, int min, int max, uint8_t largest, int *key)
+{
+	tree_node_t node;
+	tree_node_t *cached;
+	db_result_t result;
+	int first;
+	int last;
+	int count;
+	int j;
+
+	cached = tree_read(tree, id);
+	if (cached == NULL) {
+		return DB_STORAGE_ERROR;
+	}
+	memcpy(&node, cached, sizeof(node));
+	modify_cache(tree, id, NODE, UNLOCK);
+
+	/* Child j holds the keys smaller than val[j], the last one the rest.
+	   A split may leave keys equal to val[j] left of it, so the child of
+	   the separator equal to min is searched too. */
+	count = node.val[BRANCH_FACTOR - 1];
+	first = 0;
+	while (first < count && node.val[first] < min) {
+		first++;
+	}
+	last = first;
+	while (last < count && node.val[last] <= max) {
+		last++;
+	}
+
+	for (j = largest ? last : first; j >= first && j <= last; j += largest ? -1 : 1) {
+		if (node.is_leaf) {
+			if (bucket_edge(tree, node.id[j], min, max, largest, key)) {
+				return DB_OK;
+			}
+			continue;
+		}
+		result = edge_search(tree, node.id[j], min, max, largest, key);
+		if (result != DB_FINISHED) {
+			return result;
+		}
+	}
+
+	return DB_FINISHED;
+}
+
+/****************************************************************************
+ * Name: get_edge
+ *
+ * Description: Returns the smallest or the largest key in the range
+ *              [min, max] by a descent of the tree, so MIN() and MAX() of an
+ *              indexed attribute need neither an iteration nor tuple reads.
+ *
+ ****************************************************************************/
+static db_result_t get_edge(index_t *index, long min, long max, uint8_t largest, long *key)
+{
+	tree_t *tree;
+	db_result_t result;
+	int edge;
+
+	tree = (tree_t *)index->opaque_data;
+	if (tree == NULL) {
+		return DB_INDEX_ERROR;
+	}
+
+	/* Keys are ints, while an open end of a range is a long */
+	min = min < INT_MIN ? INT_MIN : min;
+	max = max > INT_MAX ? INT_MAX : max;
+	if (min > max) {
+		return DB_FINISHED;
+	}
+
+	rw_lock_write(&(tree->tree_lock));
+	result = edge_search(tree, tree->root, (int)min, (int)max, largest, &edge);
+	rw_unlock_write(&(tree->tree_lock));
+
+	if (result == DB_OK) {
+		*key = edge;
+	}
+	return result;
 }
 
 
@@ -989,7 +1220,7 @@ static db_result_t vacuum(tree_t *tree, relation_t *rel)
 	offset += sizeof(rel->name);
 
 	/* Generate new tuple file */
-	snprintf(tuple_path, TUPLE_NAME_LENGTH, "%s.%x\0", TUPLE_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+	snprintf(tuple_path, TUPLE_NAME_LENGTH, "%s.%x", TUPLE_FILE_NAME, (unsigned)(random_rand() & 0xffff));
 	result = storage_generate_file(tuple_path);
 	if (result == DB_STORAGE_ERROR) {
 		storage_close(fd);
@@ -1036,118 +1267,289 @@ static db_result_t vacuum(tree_t *tree, relation_t *rel)
 	tree->inserted -= tree->deleted;
 	tree->deleted = 0;
 
+	storage_cache_invalidate(old_rel.tuple_filename);
 	storage_remove(old_rel.tuple_filename);
 	return DB_OK;
 }
 #endif
 
 /****************************************************************************
- * Name: modify_cache
+ * Name: cache_create
  *
- * Description: Modifying the cache entries to mark the entry dirty,
- *              invalid or unlocking it
+ * Description: Allocates a node or bucket cache using about size bytes of
+ *              RAM for the entries, but with at least min_entries of them
  *
  ****************************************************************************/
-static cache_result_t modify_cache(tree_t *tree, int id, cache_type_t cache, op_type_t op)
+static lru_cache_t *cache_create(size_t entry_size, size_t size, uint16_t min_entries)
 {
-	qnode_t *temp;
-	qnode_t *end;
-	if (cache == NODE) {
-		pthread_mutex_lock(&(tree->node_cache_lock));
-		temp = tree->node_cache->in_cache.tail->prev;
-		end = tree->node_cache->in_cache.head;
-	} else {
-		pthread_mutex_lock(&(tree->buck_cache_lock));
-		temp = tree->buck_cache->in_cache.tail->prev;
-		end = tree->buck_cache->in_cache.head;
-	}
-	while (temp != end) {
-		if ((temp->id == id) && (temp->node_state & NODE_STATE_VALID)) {
-			if (op == UNLOCK) {
-				UNSET_NODE_STATE(temp, NODE_STATE_LOCK);
-			} else if (op == DIRTY) {
-				SET_NODE_STATE(temp, NODE_STATE_DIRTY);
-			} else {
-				UNSET_NODE_STATE(temp, NODE_STATE_VALID | NODE_STATE_DIRTY | NODE_STATE_LOCK);
-				REMOVE_ENTRY(temp);
-				if (cache == NODE) {
-					PLACE_AT_HEAD(temp, tree->node_cache);
-				} else {
-					PLACE_AT_HEAD(temp, tree->buck_cache);
-				}
-			}
+	lru_cache_t *cache;
+	size_t limit;
+	size_t slots;
+
+	limit = min(max(size / entry_size, (size_t)min_entries), (size_t)UINT16_MAX);
+	for (slots = 1; slots < limit; slots <<= 1) ;
+
+	cache = bptree_malloc(sizeof(lru_cache_t) + limit * sizeof(qnode_t) + (slots + limit) * sizeof(qnode_t *) + limit * entry_size);
+	if (cache == NULL) {
+		return NULL;
+	}
+	cache->entries = (qnode_t *)(cache + 1);
+	cache->slots = (qnode_t **)(cache->entries + limit);
+	cache->dirty = cache->slots + slots;
+	cache->data = (uint8_t *)(cache->dirty + limit);
+	cache->entry_size = entry_size;
+	cache->limit = limit;
+	cache->mask = slots - 1;
+	cache->num = 0;
+
+	cache->in_cache.head = &cache->ends[0];
+	cache->in_cache.tail = &cache->ends[1];
+	cache->in_cache.head->prev = NULL;
+	cache->in_cache.head->next = cache->in_cache.tail;
+	cache->in_cache.tail->prev = cache->in_cache.head;
+	cache->in_cache.tail->next = NULL;
+
+	return cache;
+}
+
+/****************************************************************************
+ * Name: cache_find
+ *
+ * Description: Returns the valid entry of a cache holding the given id
+ *
+ ****************************************************************************/
+static qnode_t *cache_find(lru_cache_t *cache, int id)
+{
+	qnode_t *entry;
+
+	for (entry = *CACHE_SLOT(cache, id); entry != NULL; entry = entry->hash_next) {
+		if (entry->id == (uint16_t)id) {
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+static void cache_hash(lru_cache_t *cache, qnode_t *entry)
+{
+	qnode_t **slot = CACHE_SLOT(cache, entry->id);
+
+	entry->hash_next = *slot;
+	*slot = entry;
+}
+
+static void cache_unhash(lru_cache_t *cache, qnode_t *entry)
+{
+	qnode_t **link;
+
+	for (link = CACHE_SLOT(cache, entry->id); *link != NULL; link = &(*link)->hash_next) {
+		if (*link == entry) {
+			*link = entry->hash_next;
 			break;
 		}
-		temp = temp->prev;
 	}
+	entry->hash_next = NULL;
+}
+
+/****************************************************************************
+ * Name: cache_store
+ *
+ * Description: Writes count entries of a cache with consecutive ids,
+ *              starting at id, to the tree or bucket file
+ *
+ ****************************************************************************/
+static db_result_t cache_store(tree_t *tree, cache_type_t type, int id, void *data, int count)
+{
+	db_storage_id_t fd;
+	unsigned long offset;
+	size_t size;
+
+	if (type == NODE) {
+		fd = tree->tree_storage;
+		size = sizeof(tree_node_t);
+		offset = base_offset + (unsigned long)id * size;
+	} else {
+		fd = tree->bucket_storage;
+		size = sizeof(bucket_t);
+		offset = (unsigned long)id * size;
+	}
+	if (DB_ERROR(storage_write_to(fd, data, offset, size * count))) {
+		DB_LOG_E("%s WRITE FAILED AT ID %d\n", type == NODE ? "TREE" : "BUCKET", id);
+		return DB_STORAGE_ERROR;
+	}
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: cache_get_entry
+ *
+ * Description: Returns an unused entry of a cache, or evicts the least
+ *              recently used entry which isn't locked, writing it to flash
+ *              when it was changed. The entry is out of the queue and has no
+ *              state. Must be called with the lock of the cache held.
+ *
+ ****************************************************************************/
+static qnode_t *cache_get_entry(tree_t *tree, cache_type_t type)
+{
+	lru_cache_t *cache = CACHE_OF(tree, type);
+	qnode_t *entry;
+
+	if (cache->num < cache->limit) {
+		entry = &cache->entries[cache->num];
+		entry->pos = cache->num++;
+		return entry;
+	}
+
+	/* Invalidated entries are at the head, they are taken first */
+	entry = cache->in_cache.head->next;
+	while ((entry->node_state & NODE_STATE_LOCK) && entry != cache->in_cache.tail) {
+		entry = entry->next;
+	}
+	if (entry == cache->in_cache.tail) {
+		DB_LOG_E("NO SLOT AVAILABLE IN %s CACHE\n", type == NODE ? "NODE" : "BUCKET");
+		return NULL;
+	}
+	if (entry->node_state & NODE_STATE_VALID) {
+		if (entry->node_state & NODE_STATE_DIRTY) {
+			cache_store(tree, type, entry->id, CACHE_DATA(cache, entry), 1);
+		}
+		cache_unhash(cache, entry);
+	}
+	entry->node_state = 0;
+	REMOVE_ENTRY(entry);
+	return entry;
+}
+
+/****************************************************************************
+ * Name: cache_read
+ *
+ * Description: Returns the locked cache entry of a node or bucket, reading
+ *              it from flash when it isn't cached. NULL is returned when the
+ *              entry is already locked or no entry can be evicted.
+ *
+ ****************************************************************************/
+static void *cache_read(tree_t *tree, cache_type_t type, int id)
+{
+	lru_cache_t *cache = CACHE_OF(tree, type);
+	pthread_mutex_t *lock = CACHE_LOCK_OF(tree, type);
+	qnode_t *entry;
+	db_result_t result;
+
+	pthread_mutex_lock(lock);
+
+	entry = cache_find(cache, id);
+	if (entry != NULL) {
+		if (entry->node_state & NODE_STATE_LOCK) {
+			pthread_mutex_unlock(lock);
+			return NULL;
+		}
+		SET_NODE_STATE(entry, NODE_STATE_LOCK);
+		REMOVE_ENTRY(entry);
+		PLACE_AT_TAIL(entry, cache);
+		pthread_mutex_unlock(lock);
+		return CACHE_DATA(cache, entry);
+	}
+
+	entry = cache_get_entry(tree, type);
+	if (entry == NULL) {
+		pthread_mutex_unlock(lock);
+		return NULL;
+	}
+
+	/* Reading from flash */
+	if (type == NODE) {
+		result = storage_read_from(tree->tree_storage, CACHE_DATA(cache, entry), base_offset + (unsigned long)id * sizeof(tree_node_t), sizeof(tree_node_t));
+	} else {
+		result = storage_read_from(tree->bucket_storage, CACHE_DATA(cache, entry), (unsigned long)id * sizeof(bucket_t), sizeof(bucket_t));
+	}
+	if (DB_ERROR(result)) {
+		DB_LOG_E("PANIC %s READ FAILED AT ID %d\n", type == NODE ? "TREE" : "BUCKET", id);
+		PLACE_AT_HEAD(entry, cache);
+		pthread_mutex_unlock(lock);
+		return NULL;
+	}
+
+	entry->id = id;
+	SET_NODE_STATE(entry, NODE_STATE_LOCK | NODE_STATE_VALID);
+	cache_hash(cache, entry);
+	PLACE_AT_TAIL(entry, cache);
+
+	pthread_mutex_unlock(lock);
+	return CACHE_DATA(cache, entry);
+}
+
+/****************************************************************************
+ * Name: cache_write
+ *
+ * Description: Routine enabling to put a new cache entry in Node or Bucket
+ *              Cache. Required when new nodes and buckets are generated
+ *              resulting from splits
+ *
+ ****************************************************************************/
+static cache_result_t cache_write(tree_t *tree, cache_type_t type, int id, void *data)
+{
+	lru_cache_t *cache = CACHE_OF(tree, type);
+	pthread_mutex_t *lock = CACHE_LOCK_OF(tree, type);
+	qnode_t *entry;
 
-	if (cache == NODE) {
-		pthread_mutex_unlock(&(tree->node_cache_lock));
+	pthread_mutex_lock(lock);
+
+	entry = cache_find(cache, id);
+	if (entry != NULL) {
+		REMOVE_ENTRY(entry);
 	} else {
-		pthread_mutex_unlock(&(tree->buck_cache_lock));
+		entry = cache_get_entry(tree, type);
+		if (entry == NULL) {
+			pthread_mutex_unlock(lock);
+			return CACHE_FULL;
+		}
+		entry->id = id;
+		cache_hash(cache, entry);
 	}
+	PLACE_AT_TAIL(entry, cache);
+	entry->node_state = NODE_STATE_VALID | NODE_STATE_DIRTY;
 
-	if (temp == end) {
-		DB_LOG_E("PANIC CACHE OPERATION FOR A NON EXISTENT ENTRY\n");
-		return CACHE_NOT_EXIST;
-	}
+	/* data may be the invalidated entry which was just taken */
+	memmove(CACHE_DATA(cache, entry), data, cache->entry_size);
+
+	pthread_mutex_unlock(lock);
 
 	return CACHE_OK;
 }
 
 /****************************************************************************
- * Name: cache_write_node
+ * Name: modify_cache
  *
- * Description: Routine enabling to put a new cache entry in Node Cache.
- *              Required when new nodes are generated resulting from splits
+ * Description: Modifying the cache entries to mark the entry dirty,
+ *              invalid or unlocking it
  *
  ****************************************************************************/
-static cache_result_t cache_write_node(tree_t *tree, int id, tree_node_t *node)
+static cache_result_t modify_cache(tree_t *tree, int id, cache_type_t cache, op_type_t op)
 {
-	pthread_mutex_lock(&(tree->node_cache_lock));
+	lru_cache_t *entries = CACHE_OF(tree, cache);
+	pthread_mutex_t *lock = CACHE_LOCK_OF(tree, cache);
+	qnode_t *temp;
 
-	qnode_t *new_node = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-	if (new_node == NULL) {
-		DB_LOG_E("Failed allocation of node\n");
-		pthread_mutex_unlock(&(tree->node_cache_lock));
-		return CACHE_ALLOCATION_ERROR;
+	pthread_mutex_lock(lock);
+	temp = cache_find(entries, id);
+	if (temp == NULL) {
+		pthread_mutex_unlock(lock);
+		DB_LOG_E("PANIC CACHE OPERATION FOR A NON EXISTENT ENTRY\n");
+		return CACHE_NOT_EXIST;
 	}
 
-	if (tree->node_cache->num < DB_TREE_CACHE_LIMIT) {
-		new_node->pos = tree->node_cache->num++;
+	if (op == UNLOCK) {
+		UNSET_NODE_STATE(temp, NODE_STATE_LOCK);
+	} else if (op == DIRTY) {
+		SET_NODE_STATE(temp, NODE_STATE_DIRTY);
 	} else {
-		qnode_t *iter_node;
-		iter_node = tree->node_cache->in_cache.head->next;
-		while ((iter_node->node_state & NODE_STATE_LOCK) && iter_node != tree->node_cache->in_cache.tail) {
-			iter_node = iter_node->next;
-		}
-		if (iter_node == tree->node_cache->in_cache.tail) {
-			free(new_node);
-			DB_LOG_E("NO SLOT AVAIABLE IN CACHE\n");
-			pthread_mutex_unlock(&(tree->node_cache_lock));
-			return CACHE_FULL;
-		}
-		if ((iter_node->node_state & NODE_STATE_DIRTY) && (iter_node->node_state & NODE_STATE_DIRTY)) {
-			tree_write(tree, iter_node->id, &(tree->node_cache->cache_t[iter_node->pos].node));
-		}
-		new_node->pos = iter_node->pos;
-		/* iter_node is the node which has to be evicted from cache.
-		 * It is removed the queue maintaining the LRU status.
-		 */
-		REMOVE_ENTRY(iter_node);
-		free(iter_node);
+		UNSET_NODE_STATE(temp, NODE_STATE_VALID | NODE_STATE_DIRTY | NODE_STATE_LOCK);
+		cache_unhash(entries, temp);
+		REMOVE_ENTRY(temp);
+		PLACE_AT_HEAD(temp, entries);
 	}
 
-	PLACE_AT_TAIL(new_node, tree->node_cache);
-	new_node->id = id;
-	UNSET_NODE_STATE(new_node, NODE_STATE_LOCK);
-	SET_NODE_STATE(new_node, NODE_STATE_VALID);
-	SET_NODE_STATE(new_node, NODE_STATE_DIRTY);
-
-	memcpy(&(tree->node_cache->cache_t[new_node->pos].node), node, sizeof(tree_node_t));
-
-	pthread_mutex_unlock(&(tree->node_cache_lock));
-
+	pthread_mutex_unlock(lock);
 	return CACHE_OK;
 }
 
@@ -1160,15 +1562,12 @@ static cache_result_t cache_write_node(tree_t *tree, int id, tree_node_t *node)
  ****************************************************************************/
 static cache_result_t cache_replace_node(tree_t *tree, int id, tree_node_t *node)
 {
-	pthread_mutex_lock(&(tree->node_cache_lock));
-
 	qnode_t *replace_node;
-	replace_node = tree->node_cache->in_cache.head->next;
 
-	while ((replace_node->id != id) && (replace_node != tree->node_cache->in_cache.tail)) {
-		replace_node = replace_node->next;
-	}
-	if (replace_node == tree->node_cache->in_cache.tail || !(replace_node->node_state & NODE_STATE_LOCK)) {
+	pthread_mutex_lock(&(tree->node_cache_lock));
+
+	replace_node = cache_find(tree->node_cache, id);
+	if (replace_node == NULL || !(replace_node->node_state & NODE_STATE_LOCK)) {
 		DB_LOG_E("PANIC REPLACE FOR NON_EXISTENT OR NON_LOCKED ENTRY\n");
 		pthread_mutex_unlock(&(tree->node_cache_lock));
 		return CACHE_NOT_EXIST;
@@ -1176,62 +1575,77 @@ static cache_result_t cache_replace_node(tree_t *tree, int id, tree_node_t *node
 	UNSET_NODE_STATE(replace_node, NODE_STATE_LOCK);
 	SET_NODE_STATE(replace_node, NODE_STATE_VALID | NODE_STATE_DIRTY);
 
-	memcpy(&(tree->node_cache->cache_t[replace_node->pos].node), node, sizeof(tree_node_t));
+	memcpy(CACHE_DATA(tree->node_cache, replace_node), node, sizeof(tree_node_t));
 
 	pthread_mutex_unlock(&(tree->node_cache_lock));
 
 	return CACHE_OK;
 }
 
+static int compare_entry_id(const void *p1, const void *p2)
+{
+	return (int)(*(qnode_t **)p1)->id - (int)(*(qnode_t **)p2)->id;
+}
+
 /****************************************************************************
- * Name: cache_write_bucket
+ * Name: cache_flush
  *
- * Description: Routine enabling to put a new cache entry in Bucket Cache.
- *              Required when new buckets are generated resulting from splits.
+ * Description: Writes all the changed entries of a cache which aren't being
+ *              edited. They are written in order of id, and entries with
+ *              consecutive ids are written at once, so that many changes
+ *              kept in the cache become a few sequential flash writes.
  *
  ****************************************************************************/
-static cache_result_t cache_write_bucket(tree_t *tree, int id, bucket_t *bucket)
+static db_result_t cache_flush(tree_t *tree, cache_type_t type)
 {
-	pthread_mutex_lock(&(tree->buck_cache_lock));
-
-	qnode_t *new_node = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-	if (new_node == NULL) {
-		pthread_mutex_unlock(&(tree->buck_cache_lock));
-		return CACHE_ALLOCATION_ERROR;
-	}
+	lru_cache_t *cache = CACHE_OF(tree, type);
+	pthread_mutex_t *lock = CACHE_LOCK_OF(tree, type);
+	qnode_t *entry;
+	uint8_t *chunk;
+	size_t chunk_entries;
+	db_result_t result = DB_OK;
+	int count = 0;
+	int run;
+	int i;
+	int j;
 
-	if (tree->buck_cache->num < DB_HEAP_CACHE_LIMIT) {
-		new_node->pos = tree->buck_cache->num++;
-	} else {
-		qnode_t *iter_node;
-		iter_node = tree->buck_cache->in_cache.head->next;
-		while ((iter_node->node_state & NODE_STATE_LOCK) && (iter_node != tree->buck_cache->in_cache.tail)) {
-			iter_node = iter_node->next;
-		}
-		if (iter_node == tree->buck_cache->in_cache.tail) {
-			free(new_node);
-			DB_LOG_E("NO SLOT AVAILABLE IN CACHE bucket\n");
-			pthread_mutex_unlock(&(tree->buck_cache_lock));
-			return CACHE_FULL;
-		}
+	pthread_mutex_lock(lock);
 
-		if ((iter_node->node_state & NODE_STATE_DIRTY) && (iter_node->node_state & NODE_STATE_VALID)) {
-			bucket_write(tree, iter_node->id, &(tree->buck_cache->cache_t[iter_node->pos].bucket));
+	for (entry = cache->in_cache.head->next; entry != cache->in_cache.tail; entry = entry->next) {
+		if ((entry->node_state & (NODE_STATE_VALID | NODE_STATE_DIRTY | NODE_STATE_LOCK)) == (NODE_STATE_VALID | NODE_STATE_DIRTY)) {
+			cache->dirty[count++] = entry;
 		}
-		new_node->pos = iter_node->pos;
-		REMOVE_ENTRY(iter_node);
-		free(iter_node);
 	}
-	PLACE_AT_TAIL(new_node, tree->buck_cache);
-	new_node->id = id;
-	UNSET_NODE_STATE(new_node, NODE_STATE_LOCK);
-	SET_NODE_STATE(new_node, NODE_STATE_DIRTY | NODE_STATE_VALID);
+	qsort(cache->dirty, count, sizeof(qnode_t *), compare_entry_id);
 
-	memcpy(&(tree->buck_cache->cache_t[new_node->pos].bucket), bucket, sizeof(bucket_t));
+	chunk_entries = INIT_CHUNK_SIZE / cache->entry_size;
+	chunk = NULL;
+	if (chunk_entries > 1 && count > 1) {
+		chunk = malloc(chunk_entries * cache->entry_size);
+	}
 
-	pthread_mutex_unlock(&(tree->buck_cache_lock));
+	for (i = 0; i < count; i += run) {
+		entry = cache->dirty[i];
+		run = 1;
+		if (chunk != NULL) {
+			memcpy(chunk, CACHE_DATA(cache, entry), cache->entry_size);
+			while (i + run < count && run < chunk_entries && cache->dirty[i + run]->id == entry->id + run) {
+				memcpy(chunk + run * cache->entry_size, CACHE_DATA(cache, cache->dirty[i + run]), cache->entry_size);
+				run++;
+			}
+		}
+		if (DB_ERROR(cache_store(tree, type, entry->id, run > 1 ? chunk : CACHE_DATA(cache, entry), run))) {
+			result = DB_STORAGE_ERROR;
+			continue;
+		}
+		for (j = i; j < i + run; j++) {
+			UNSET_NODE_STATE(cache->dirty[j], NODE_STATE_DIRTY);
+		}
+	}
+	free(chunk);
 
-	return CACHE_OK;
+	pthread_mutex_unlock(lock);
+	return result;
 }
 
 /****************************************************************************
@@ -1254,74 +1668,9 @@ static int transform_key(int key)
  *              from cache, in case the cache is full
  *
  ****************************************************************************/
-static tree_node_t *tree_read(tree_t *tree, int bucket_id)
+static tree_node_t *tree_read(tree_t *tree, int node_id)
 {
-	pthread_mutex_lock(&(tree->node_cache_lock));
-
-	bool found = false;
-	qnode_t *iter = (tree->node_cache->in_cache.tail)->prev;
-
-	while (iter != (tree->node_cache->in_cache.head)) {
-		if (bucket_id == iter->id && (iter->node_state & NODE_STATE_VALID)) {
-			found = true;
-			break;
-		}
-		iter = iter->prev;
-	}
-	if (found) {
-		/* Case when node is found in the cache */
-		if (iter->node_state & NODE_STATE_LOCK) {
-			pthread_mutex_unlock(&(tree->node_cache_lock));
-			return NULL;
-		}
-		SET_NODE_STATE(iter, NODE_STATE_LOCK);
-		REMOVE_ENTRY(iter);
-		PLACE_AT_TAIL(iter, tree->node_cache);
-		pthread_mutex_unlock(&(tree->node_cache_lock));
-		return &(tree->node_cache->cache_t[iter->pos].node);
-	} else {
-		qnode_t *new_node = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-		if (new_node == NULL) {
-			pthread_mutex_unlock(&(tree->node_cache_lock));
-			return NULL;
-		}
-		if (tree->node_cache->num < DB_TREE_CACHE_LIMIT) {
-			new_node->pos = tree->node_cache->num++;
-		} else {
-			/* Case when the least recently used node needs to be evicted to make place for new node */
-			qnode_t *replace_node = tree->node_cache->in_cache.head->next;
-			while ((replace_node->node_state & NODE_STATE_LOCK) && replace_node != tree->node_cache->in_cache.tail) {
-				replace_node = replace_node->next;
-			}
-			if (replace_node == tree->node_cache->in_cache.tail) {
-				free(new_node);
-				pthread_mutex_unlock(&(tree->node_cache_lock));
-				return NULL;
-			}
-			if ((replace_node->node_state & NODE_STATE_DIRTY) && (replace_node->node_state & NODE_STATE_VALID)) {
-				tree_write(tree, replace_node->id, &(tree->node_cache->cache_t[replace_node->pos].node));
-			}
-			new_node->pos = replace_node->pos;
-			REMOVE_ENTRY(replace_node);
-			free(replace_node);
-		}
-		/* Adjusting the pointers */
-		PLACE_AT_TAIL(new_node, tree->node_cache);
-		new_node->id = bucket_id;
-		SET_NODE_STATE(new_node, NODE_STATE_LOCK | NODE_STATE_VALID | NODE_STATE_DIRTY);
-
-		/* Reading from flash */
-		if (DB_ERROR(storage_read_from(tree->tree_storage, &(tree->node_cache->cache_t[new_node->pos].node), base_offset + (unsigned long)bucket_id * sizeof(tree_node_t), sizeof(tree_node_t)))) {
-			DB_LOG_E("PANIC TREE READ FAILED AT NODE ID %d\n", new_node->id);
-			UNSET_NODE_STATE(new_node, NODE_STATE_LOCK | NODE_STATE_VALID);
-			pthread_mutex_unlock(&(tree->node_cache_lock));
-			return NULL;
-		}
-
-		pthread_mutex_unlock(&(tree->node_cache_lock));
-
-		return &(tree->node_cache->cache_t[new_node->pos].node);
-	}
+	return (tree_node_t *)cache_read(tree, NODE, node_id);
 }
 
 /****************************************************************************
@@ -1399,7 +1748,7 @@ static tree_result_t tree_insert(tree_t *tree, int max)
 static pair_t *tree_find(tree_t *tree, int key)
 {
 	int hashed_key;
-	uint8_t id;
+	uint16_t id;
 	tree_node_t *node;
 	int index;
 	hashed_key = transform_key(key);
@@ -1529,73 +1878,7 @@ void tree_print(tree_t *tree, int id)
  ****************************************************************************/
 static bucket_t *bucket_read(tree_t *tree, int bucket_id)
 {
-	pthread_mutex_lock(&(tree->buck_cache_lock));
-
-	bool found = false;
-	qnode_t *iter = (tree->buck_cache->in_cache.tail)->prev;
-
-	while (iter != (tree->buck_cache->in_cache.head)) {
-		if (bucket_id == iter->id && (iter->node_state & NODE_STATE_VALID)) {
-			found = true;
-			break;
-		}
-		iter = iter->prev;
-	}
-	if (found) {
-		/* If the bucket is found in the cache */
-		if (iter->node_state & NODE_STATE_LOCK) {
-			pthread_mutex_unlock(&(tree->buck_cache_lock));
-			return NULL;
-		}
-		SET_NODE_STATE(iter, NODE_STATE_LOCK);
-		REMOVE_ENTRY(iter);
-		PLACE_AT_TAIL(iter, tree->buck_cache);
-		pthread_mutex_unlock(&(tree->buck_cache_lock));
-		return &(tree->buck_cache->cache_t[iter->pos].bucket);
-	} else {
-		/* Bucket has to be read from flash into the cache */
-		qnode_t *new_node = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-		if (new_node == NULL) {
-			pthread_mutex_unlock(&(tree->buck_cache_lock));
-			return NULL;
-		}
-		if (tree->buck_cache->num < DB_HEAP_CACHE_LIMIT) {
-			new_node->pos = tree->buck_cache->num++;
-		} else {
-			/* Cache doesn't have enough space and the least recently used bucket needs to be evicted */
-			qnode_t *replace_node = tree->buck_cache->in_cache.head->next;
-			while ((replace_node->node_state & NODE_STATE_LOCK) && (replace_node != tree->buck_cache->in_cache.tail)) {
-				replace_node = replace_node->next;
-			}
-			if (replace_node == tree->buck_cache->in_cache.tail) {
-				free(new_node);
-				pthread_mutex_unlock(&(tree->buck_cache_lock));
-				return NULL;
-			}
-			if ((replace_node->node_state & NODE_STATE_DIRTY) && (replace_node->node_state & NODE_STATE_VALID)) {
-				bucket_write(tree, replace_node->id, &(tree->buck_cache->cache_t[replace_node->pos].bucket));
-			}
-			new_node->pos = replace_node->pos;
-			REMOVE_ENTRY(replace_node);
-			free(replace_node);
-		}
-
-		/* Adjust the pointers */
-		PLACE_AT_TAIL(new_node, tree->buck_cache);
-		new_node->id = bucket_id;
-		SET_NODE_STATE(new_node, NODE_STATE_LOCK | NODE_STATE_VALID);
-		UNSET_NODE_STATE(new_node, NODE_STATE_DIRTY);
-
-		/* Read from flash */
-		if (DB_ERROR(storage_read_from(tree->bucket_storage, (void *)&(tree->buck_cache->cache_t[new_node->pos].bucket), (unsigned long)bucket_id * sizeof(bucket_t), sizeof(bucket_t)))) {
-			DB_LOG_E("PANIC BUCKET READ FAILED AT ID %d\n", bucket_id);
-			UNSET_NODE_STATE(new_node, (NODE_STATE_LOCK | NODE_STATE_VALID));
-			pthread_mutex_unlock(&(tree->buck_cache_lock));
-			return NULL;
-		}
-		pthread_mutex_unlock(&(tree->buck_cache_lock));
-		return &(tree->buck_cache->cache_t[new_node->pos].bucket);
-	}
+	return (bucket_t *)cache_read(tree, BUCKET, bucket_id);
 }
 
 /****************************************************************************
@@ -1657,8 +1940,8 @@ static tsplit_status_t tree_split(tree_t *tree, int key, int id, pair_t *path, i
 	int i, j;
 	if (path[level].key == ROOT_NODE_PARENT) {
 		/* Case when root has split and new root node requires to be created */
-		uint8_t root = tree->root;
-		uint8_t new_root = tree->off_nodes++;
+		uint16_t root = tree->root;
+		uint16_t new_root = tree->off_nodes++;
 		if (tree->off_nodes > CONFIG_NODE_LIMIT) {
 			tree->off_nodes--;
 			return TSPLIT_FAIL;
@@ -1668,7 +1951,7 @@ static tsplit_status_t tree_split(tree_t *tree, int key, int id, pair_t *path, i
 		node.id[1] = id;
 		node.val[BRANCH_FACTOR - 1] = 1;
 		node.is_leaf = 0;
-		while (cache_write_node(tree, new_root, &node) != CACHE_OK) ;
+		while (cache_write(tree, NODE, new_root, &node) != CACHE_OK) ;
 		tree->root = new_root;
 		tree->levels++;
 		return TSPLIT_OK;
@@ -1756,7 +2039,7 @@ static tsplit_status_t tree_split(tree_t *tree, int key, int id, pair_t *path, i
 
 			/* Replace the left node and write the right node in the cache */
 			cache_replace_node(tree, path[level].key, &node);
-			cache_write_node(tree, nid, &node1);
+			cache_write(tree, NODE, nid, &node1);
 		} else {
 			modify_cache(tree, path[level].key, NODE, UNLOCK);
 			tree->off_nodes--;
@@ -1773,7 +2056,7 @@ static tsplit_status_t tree_split(tree_t *tree, int key, int id, pair_t *path, i
  *              the insertion process of an index entry
  *
  ****************************************************************************/
-static bsplit_status_t bucket_split(tree_t *tree, int key, int value, pair_t *path)
+static bsplit_status_t bucket_split(tree_t *tree, int key, tuple_id_t value, pair_t *path)
 {
 	int median;
 	bucket_t *bucket;
@@ -1833,8 +2116,8 @@ static bsplit_status_t bucket_split(tree_t *tree, int key, int value, pair_t *pa
 		/* End of Bucket chaining */
 
 		modify_cache(tree, bucket_id, BUCKET, INVALIDATE);
-		cache_write_bucket(tree, bucket_id, &b1);
-		cache_write_bucket(tree, b_id, &b2);
+		cache_write(tree, BUCKET, bucket_id, &b1);
+		cache_write(tree, BUCKET, b_id, &b2);
 	} else {
 		tree->off_buckets--;
 		modify_cache(tree, bucket_id, BUCKET, UNLOCK);
@@ -1849,7 +2132,7 @@ static bsplit_status_t bucket_split(tree_t *tree, int key, int value, pair_t *pa
  *              routines defined above.
  *
  ****************************************************************************/
-tree_result_t insert_item_btree(tree_t *tree, int key, int value)
+tree_result_t insert_item_btree(tree_t *tree, int key, tuple_id_t value)
 {
 	int bucket_id;
 	pair_t *path;
@@ -1928,15 +2211,461 @@ retry:
 	return TREE_OK;
 }
 
+/****************************************************************************
+ * Name: bulk loading
+ *
+ * Description: An index created on a relation which already has tuples is
+ *              built bottom-up from its keys in sorted order, instead of
+ *              inserting them one by one. Buckets are filled one after the
+ *              other, and the nodes of each level are written once as soon
+ *              as they have all their children, so each bucket and node is
+ *              written exactly once and in order of id.
+ *              Keys are sorted in a buffer of DB_INDEX_SORT_SIZE bytes. When
+ *              there are more, the sorted runs are written to a temporary
+ *              file and merged, up to BULK_FANIN of them at once.
+ *
+ ****************************************************************************/
+
+/* The children of the nodes of a level which aren't written yet */
+struct bulk_level_s {
+	uint16_t id[2 * BRANCH_FACTOR];
+	int key[2 * BRANCH_FACTOR];	/* smallest key under each child */
+	uint8_t count;
+};
+
+struct bulk_loader_s {
+	tree_t *tree;
+	bucket_t bucket;	/* The bucket being filled */
+	uint16_t bucket_id;
+	struct bulk_level_s level[BULK_LEVELS];
+};
+typedef struct bulk_loader_s bulk_loader_t;
+
+/* A sorted run of pairs in a temporary file */
+struct bulk_run_s {
+	uint32_t start;
+	uint32_t count;
+};
+
+/* A run being merged, with the part of it read in a block of the buffer */
+struct bulk_input_s {
+	pair_t *block;
+	uint32_t next;
+	uint32_t left;
+	uint32_t head;
+	uint32_t count;
+};
+
+static db_result_t bulk_add_child(bulk_loader_t *, int, uint16_t, int);
+
+static int compare_pair(const void *p1, const void *p2)
+{
+	const pair_t *a = p1;
+	const pair_t *b = p2;
+
+	if (a->key != b->key) {
+		return a->key < b->key ? -1 : 1;
+	}
+	if (a->value != b->value) {
+		return a->value < b->value ? -1 : 1;
+	}
+	return 0;
+}
+
+/* Writes a node with the first count children of a level, and adds it to the level above */
+static db_result_t bulk_write_node(bulk_loader_t *loader, int lvl, int count)
+{
+	tree_t *tree = loader->tree;
+	struct bulk_level_s *level = &loader->level[lvl];
+	tree_node_t node;
+	uint16_t id;
+	int i;
+
+	if (tree->off_nodes >= CONFIG_NODE_LIMIT) {
+		DB_LOG_E("TREE FULL !");
+		return DB_INDEX_ERROR;
+	}
+	id = tree->off_nodes++;
+
+	memset(&node, 0, sizeof(node));
+	for (i = 0; i < count; i++) {
+		node.id[i] = level->id[i];
+		if (i > 0) {
+			node.val[i - 1] = level->key[i];
+		}
+	}
+	node.val[BRANCH_FACTOR - 1] = count - 1;
+	node.is_leaf = (lvl == 0);
+	if (!tree_write(tree, id, &node)) {
+		return DB_STORAGE_ERROR;
+	}
+
+	i = level->key[0];
+	level->count -= count;
+	memmove(level->id, level->id + count, level->count * sizeof(level->id[0]));
+	memmove(level->key, level->key + count, level->count * sizeof(level->key[0]));
+
+	return bulk_add_child(loader, lvl + 1, id, i);
+}
+
+static db_result_t bulk_add_child(bulk_loader_t *loader, int lvl, uint16_t id, int key)
+{
+	struct bulk_level_s *level;
+	db_result_t result;
+
+	if (lvl >= BULK_LEVELS) {
+		return DB_INDEX_ERROR;
+	}
+	level = &loader->level[lvl];
+
+	/* A full node is kept until the next one is started, so that the
+	 * children of the last two nodes of the level can be shared evenly
+	 */
+	if (level->count == 2 * BRANCH_FACTOR) {
+		result = bulk_write_node(loader, lvl, BRANCH_FACTOR);
+		if (DB_ERROR(result)) {
+			return result;
+		}
+	}
+	level->id[level->count] = id;
+	level->key[level->count] = key;
+	level->count++;
+
+	return DB_OK;
+}
+
+/* Writes the bucket being filled and adds it to the leaves */
+static db_result_t bulk_write_bucket(bulk_loader_t *loader, uint16_t next)
+{
+	bucket_t *bucket = &loader->bucket;
+
+	bucket->info[0] = next;
+	if (bucket->next_free_slot > 0) {
+		bucket->info[1] = bucket->pairs[0].key;
+		bucket->info[2] = bucket->pairs[bucket->next_free_slot - 1].key;
+	} else {
+		bucket->info[1] = KEY_MAX;
+		bucket->info[2] = 0;
+	}
+	if (!bucket_write(loader->tree, loader->bucket_id, bucket)) {
+		return DB_STORAGE_ERROR;
+	}
+	if (loader->bucket_id == CONFIG_BUCKETS_LIMIT - 1) {
+		return DB_OK;
+	}
+	return bulk_add_child(loader, 0, loader->bucket_id, bucket->info[1]);
+}
+
+static db_result_t bulk_add(bulk_loader_t *loader, pair_t *pair)
+{
+	tree_t *tree = loader->tree;
+	bucket_t *bucket = &loader->bucket;
+	uint8_t used = bucket->next_free_slot;
+	db_result_t result;
+
+	if (loader->bucket_id != CONFIG_BUCKETS_LIMIT - 1) {
+		if (pair->key == KEY_MAX) {
+			/* Like tree_insert, keys from KEY_MAX go to the last child of the tree */
+			result = bulk_write_bucket(loader, CONFIG_BUCKETS_LIMIT - 1);
+			if (DB_ERROR(result)) {
+				return result;
+			}
+			memset(bucket, 0, sizeof(bucket_t));
+			loader->bucket_id = CONFIG_BUCKETS_LIMIT - 1;
+			result = bulk_add_child(loader, 0, loader->bucket_id, KEY_MAX);
+			if (DB_ERROR(result)) {
+				return result;
+			}
+		} else if (used == BUCKET_SIZE || (used >= BULK_FILL && pair->key != bucket->pairs[used - 1].key)) {
+			/* Equal keys are kept in the same bucket, as long as it has room */
+			if (tree->off_buckets >= CONFIG_BUCKETS_LIMIT - 1) {
+				DB_LOG_E("TREE FULL !");
+				return DB_INDEX_ERROR;
+			}
+			result = bulk_write_bucket(loader, tree->off_buckets);
+			if (DB_ERROR(result)) {
+				return result;
+			}
+			memset(bucket, 0, sizeof(bucket_t));
+			loader->bucket_id = tree->off_buckets++;
+		}
+	} else if (used == BUCKET_SIZE) {
+		DB_LOG_E("TREE FULL !");
+		return DB_INDEX_ERROR;
+	}
+
+	bucket->pairs[bucket->next_free_slot++] = *pair;
+	tree->inserted++;
+	return DB_OK;
+}
+
+/* Writes the last bucket and the nodes left, the single node of the top level is the root */
+static db_result_t bulk_finish(bulk_loader_t *loader)
+{
+	tree_t *tree = loader->tree;
+	struct bulk_level_s *level;
+	db_result_t result;
+	int lvl;
+
+	if (loader->bucket_id != CONFIG_BUCKETS_LIMIT - 1) {
+		result = bulk_write_bucket(loader, CONFIG_BUCKETS_LIMIT - 1);
+		if (DB_SUCCESS(result)) {
+			result = bulk_add_child(loader, 0, CONFIG_BUCKETS_LIMIT - 1, KEY_MAX);
+		}
+	} else {
+		result = bulk_write_bucket(loader, CONFIG_BUCKETS_LIMIT - 1);
+	}
+	if (DB_ERROR(result)) {
+		return result;
+	}
+
+	for (lvl = 0; lvl < BULK_LEVELS; lvl++) {
+		level = &loader->level[lvl];
+		if (lvl > 0 && level->count == 1) {
+			tree->root = level->id[0];
+			tree->levels = lvl + 1;
+			return DB_OK;
+		}
+		if (level->count > BRANCH_FACTOR) {
+			result = bulk_write_node(loader, lvl, level->count / 2);
+			if (DB_ERROR(result)) {
+				return result;
+			}
+		}
+		result = bulk_write_node(loader, lvl, level->count);
+		if (DB_ERROR(result)) {
+			return result;
+		}
+	}
+	return DB_INDEX_ERROR;
+}
+
+static db_result_t bulk_fill_input(db_storage_id_t fd, struct bulk_input_s *input, uint32_t block_size)
+{
+	uint32_t count = min(input->left, block_size);
+
+	if (DB_ERROR(storage_read_from(fd, input->block, (unsigned long)input->next * sizeof(pair_t), count * sizeof(pair_t)))) {
+		return DB_STORAGE_ERROR;
+	}
+	input->next += count;
+	input->left -= count;
+	input->head = 0;
+	input->count = count;
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: bulk_merge
+ *
+ * Description: Merges up to BULK_FANIN sorted runs of the src file, into
+ *              one run at the start offset of the dst file, or into the
+ *              tree when dst is negative. The buffer is split in blocks,
+ *              one per run and one for the output.
+ *
+ ****************************************************************************/
+static db_result_t bulk_merge(db_storage_id_t src, struct bulk_run_s *runs, int nruns, pair_t *buf, uint32_t size, db_storage_id_t dst, uint32_t start, bulk_loader_t *loader)
+{
+	struct bulk_input_s input[BULK_FANIN];
+	pair_t *out;
+	uint32_t block_size;
+	uint32_t used = 0;
+	int best;
+	int i;
+
+	block_size = size / (nruns + (dst >= 0));
+	out = buf + nruns * block_size;
+	for (i = 0; i < nruns; i++) {
+		input[i].block = buf + i * block_size;
+		input[i].next = runs[i].start;
+		input[i].left = runs[i].count;
+		if (DB_ERROR(bulk_fill_input(src, &input[i], block_size))) {
+			return DB_STORAGE_ERROR;
+		}
+	}
+
+	while (true) {
+		best = -1;
+		for (i = 0; i < nruns; i++) {
+			if (input[i].head < input[i].count && (best < 0 || compare_pair(&input[i].block[input[i].head], &input[best].block[input[best].head]) < 0)) {
+				best = i;
+			}
+		}
+		if (best < 0) {
+			break;
+		}
+
+		if (dst < 0) {
+			if (DB_ERROR(bulk_add(loader, &input[best].block[input[best].head]))) {
+				return DB_INDEX_ERROR;
+			}
+		} else {
+			out[used++] = input[best].block[input[best].head];
+			if (used == block_size) {
+				if (DB_ERROR(storage_write_to(dst, out, (unsigned long)start * sizeof(pair_t), used * sizeof(pair_t)))) {
+					return DB_STORAGE_ERROR;
+				}
+				start += used;
+				used = 0;
+			}
+		}
+
+		if (++input[best].head == input[best].count && input[best].left > 0) {
+			if (DB_ERROR(bulk_fill_input(src, &input[best], block_size))) {
+				return DB_STORAGE_ERROR;
+			}
+		}
+	}
+
+	if (used > 0 && DB_ERROR(storage_write_to(dst, out, (unsigned long)start * sizeof(pair_t), used * sizeof(pair_t)))) {
+		return DB_STORAGE_ERROR;
+	}
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: bulk_load
+ *
+ * Description: Builds the tree from the keys of the first cardinality
+ *              tuples of the relation of the index
+ *
+ ****************************************************************************/
+static db_result_t bulk_load(tree_t *tree, index_t *index, tuple_id_t cardinality)
+{
+	relation_t *rel = index->rel;
+	char run_file[2][DB_MAX_FILENAME_LENGTH];
+	db_storage_id_t fd[2] = { -1, -1 };
+	struct bulk_run_s *runs = NULL;
+	bulk_loader_t *loader;
+	attribute_value_t value;
+	storage_row_t row;
+	pair_t *buf;
+	db_result_t result = DB_OK;
+	tuple_id_t tuple_id;
+	uint32_t size;
+	uint32_t count = 0;
+	uint32_t total = 0;
+	int nruns = 0;
+	int fanin;
+	int merged;
+	int i;
+
+	size = max((uint32_t)(DB_INDEX_SORT_SIZE / sizeof(pair_t)), (uint32_t)(4 * BULK_MIN_BLOCK));
+	fanin = min(max((int)(size / BULK_MIN_BLOCK) - 1, 2), BULK_FANIN);
+
+	buf = malloc(size * sizeof(pair_t));
+	loader = bptree_malloc(sizeof(bulk_loader_t));
+	row = malloc(rel->row_length + 1);
+	if (buf == NULL || loader == NULL || row == NULL) {
+		result = DB_ALLOCATION_ERROR;
+		goto errout;
+	}
+	loader->tree = tree;
+	loader->bucket_id = tree->off_buckets++;
+
+	/* Reading the keys, sorted runs of them are written when they don't fit */
+	storage_cache_hint_sequential(rel->tuple_filename, rel->row_length, 0);
+	for (tuple_id = 0; tuple_id < cardinality; tuple_id++) {
+		result = storage_get_row(rel, &tuple_id, row);
+		if (DB_SUCCESS(result)) {
+			result = relation_get_value(rel, index->attr, row, &value);
+		}
+		if (DB_ERROR(result)) {
+			DB_LOG_E("DB: Failed to get a row in relation %s!\n", rel->name);
+			goto errout;
+		}
+		buf[count].key = transform_key((int)db_value_to_long(&value));
+		buf[count].value = tuple_id;
+		count++;
+
+		if (count == size && tuple_id + 1 < cardinality) {
+			if (runs == NULL) {
+				runs = malloc(((cardinality + size - 1) / size) * sizeof(struct bulk_run_s));
+				for (i = 0; i < 2 && runs != NULL; i++) {
+					snprintf(run_file[i], DB_MAX_FILENAME_LENGTH, "%.*s%s%d", HEAP_FILE_LENGTH - 1, index->descriptor_file, TEMP_FILE_SUFFIX, i);
+					if (DB_SUCCESS(storage_generate_file(run_file[i]))) {
+						fd[i] = storage_open(run_file[i], O_RDWR);
+					}
+				}
+				if (runs == NULL || fd[0] < 0 || fd[1] < 0) {
+					result = DB_STORAGE_ERROR;
+					goto errout;
+				}
+			}
+			qsort(buf, count, sizeof(pair_t), compare_pair);
+			result = storage_write_to(fd[0], buf, (unsigned long)total * sizeof(pair_t), count * sizeof(pair_t));
+			if (DB_ERROR(result)) {
+				goto errout;
+			}
+			runs[nruns].start = total;
+			runs[nruns].count = count;
+			nruns++;
+			total += count;
+			count = 0;
+		}
+	}
+	qsort(buf, count, sizeof(pair_t), compare_pair);
+
+	if (nruns == 0) {
+		for (i = 0; i < count && DB_SUCCESS(result); i++) {
+			result = bulk_add(loader, &buf[i]);
+		}
+	} else {
+		result = storage_write_to(fd[0], buf, (unsigned long)total * sizeof(pair_t), count * sizeof(pair_t));
+		runs[nruns].start = total;
+		runs[nruns].count = count;
+		nruns++;
+
+		/* Each pass merges groups of runs from one file into the other */
+		while (DB_SUCCESS(result) && nruns > fanin) {
+			total = 0;
+			for (i = 0, merged = 0; i < nruns && DB_SUCCESS(result); i += fanin, merged++) {
+				count = min(fanin, nruns - i);
+				result = bulk_merge(fd[0], runs + i, count, buf, size, fd[1], total, NULL);
+				runs[merged].start = total;
+				runs[merged].count = runs[i].count;
+				while (--count > 0) {
+					runs[merged].count += runs[i + count].count;
+				}
+				total += runs[merged].count;
+			}
+			nruns = merged;
+			i = fd[0];
+			fd[0] = fd[1];
+			fd[1] = i;
+		}
+		if (DB_SUCCESS(result)) {
+			result = bulk_merge(fd[0], runs, nruns, buf, size, -1, 0, loader);
+		}
+	}
+	if (DB_SUCCESS(result)) {
+		result = bulk_finish(loader);
+	}
+
+	DB_LOG_D("DB: Bulk loaded %lu keys in %d buckets and %d nodes\n", (unsigned long)cardinality, tree->off_buckets, tree->off_nodes);
+
+errout:
+	for (i = 0; i < 2; i++) {
+		if (fd[i] >= 0) {
+			storage_close(fd[i]);
+			storage_remove(run_file[i]);
+		}
+	}
+	free(runs);
+	free(row);
+	free(loader);
+	free(buf);
+	return result;
+}
+
 #ifdef CONFIG_ARASTORAGE_ENABLE_FLUSHING
 /****************************************************************************
- * Name: db_flush
+ * Name: purge_old_tuples
  *
  * Description: Removes the old tuples from storage in case the tuple
  *              storage limit is reached
  *
  ****************************************************************************/
-static int db_flush(tree_t *tree, relation_t *rel)
+static int purge_old_tuples(tree_t *tree, relation_t *rel)
 {
 	DB_LOG_D("Started flushing the database. Deleted till now: %d\n", tree->deleted);
 	char tuple_path[TUPLE_NAME_LENGTH];
@@ -1958,7 +2687,7 @@ static int db_flush(tree_t *tree, relation_t *rel)
 	offset += sizeof(rel->name);
 
 	/* Create a new tuple file */
-	snprintf(tuple_path, TUPLE_NAME_LENGTH, "%s.%x\0", TUPLE_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+	snprintf(tuple_path, TUPLE_NAME_LENGTH, "%s.%x", TUPLE_FILE_NAME, (unsigned)(random_rand() & 0xffff));
 	result = storage_generate_file(tuple_path);
 	if (result == DB_STORAGE_ERROR) {
 		storage_close(fd);
@@ -2031,6 +2760,7 @@ static int db_flush(tree_t *tree, relation_t *rel)
 	free(temp);
 	tree->inserted -= tree->deleted;
 	tree->deleted = 0;
+	storage_cache_invalidate(old_rel.tuple_filename);
 	storage_remove(old_rel.tuple_filename);
 	DB_LOG_D("Flushed the database.\n");
 	return DB_OK;
@@ -2124,6 +2854,9 @@ static void tree_node_update_keys(tree_t *tree, pair_t *path, int rm_val, int le
 		tree_node_update_keys(tree, path, rm_val, level-1, range_min);
 	}
 
+	if (bFound) {
+		modify_cache(tree, node_id, NODE, DIRTY);
+	}
 	modify_cache(tree, node_id, NODE, UNLOCK);
 	return;
 }
@@ -2150,6 +2883,7 @@ static void bucket_update_keys(tree_t *tree, pair_t *path, int bucket_id, int rm
 			first_bucket = bucket_read(tree, bucket_id);
 			n->val[i] = first_bucket->info[1];
 			modify_cache(tree, bucket_id, BUCKET, UNLOCK);
+			modify_cache(tree, node_id, NODE, DIRTY);
 			bLeaf = true;
 			DB_LOG_D("bucket_update_keys, value %d , node_id %d\n", rm_val, node_id);
 			break;
@@ -2204,7 +2938,10 @@ static int bucket_request_sibling(tree_t *tree, pair_t *path, bucket_t *bucket)
 
 				n->val[index - 1] = share_key;
 
+				modify_cache(tree, path[tree->levels].key, BUCKET, DIRTY);
+				modify_cache(tree, node_id, NODE, DIRTY);
 				modify_cache(tree, node_id, NODE, UNLOCK);
+				modify_cache(tree, n->id[index - 1], BUCKET, DIRTY);
 				modify_cache(tree, n->id[index - 1], BUCKET, UNLOCK);
 				return 0;
 			}
@@ -2230,7 +2967,10 @@ static int bucket_request_sibling(tree_t *tree, pair_t *path, bucket_t *bucket)
 
 				n->val[index] = right_bucket->info[1];
 
+				modify_cache(tree, path[tree->levels].key, BUCKET, DIRTY);
+				modify_cache(tree, node_id, NODE, DIRTY);
 				modify_cache(tree, node_id, NODE, UNLOCK);
+				modify_cache(tree, n->id[index + 1], BUCKET, DIRTY);
 				modify_cache(tree, n->id[index + 1], BUCKET, UNLOCK);
 				return 0;
 			}
@@ -2251,6 +2991,7 @@ static void bucket_update_next(tree_t *tree, int bucket_id, int next_id)
 	if (bucket) {
 		bucket->info[0] = next_id;
 		DB_LOG_D("set bucket %d next id %d\n", bucket_id, next_id);
+		modify_cache(tree, bucket_id, BUCKET, DIRTY);
 	}
 	modify_cache(tree, bucket_id, BUCKET, UNLOCK);
 }
@@ -2334,6 +3075,9 @@ static int tree_rebuild_node(tree_t *tree, pair_t *path, int level)
 			pn->val[index - 1] = lsbn->val[sb_key_num - 1];			
 			lsbn->val[BRANCH_FACTOR - 1] = sb_key_num - 1;
 
+			modify_cache(tree, node_id, NODE, DIRTY);
+			modify_cache(tree, pnode_id, NODE, DIRTY);
+			modify_cache(tree, lsb_id, NODE, DIRTY);
 			modify_cache(tree, node_id, NODE, UNLOCK);
 			modify_cache(tree, pnode_id, NODE, UNLOCK);
 			modify_cache(tree, lsb_id, NODE, UNLOCK);
@@ -2364,6 +3108,9 @@ static int tree_rebuild_node(tree_t *tree, pair_t *path, int level)
 			}
 			rsbn->val[BRANCH_FACTOR - 1] = sb_key_num - 1;
 
+			modify_cache(tree, node_id, NODE, DIRTY);
+			modify_cache(tree, pnode_id, NODE, DIRTY);
+			modify_cache(tree, rsb_id, NODE, DIRTY);
 			modify_cache(tree, node_id, NODE, UNLOCK);
 			modify_cache(tree, pnode_id, NODE, UNLOCK);
 			modify_cache(tree, rsb_id, NODE, UNLOCK);
@@ -2404,6 +3151,9 @@ static int tree_rebuild_node(tree_t *tree, pair_t *path, int level)
 			rsbn->val[BRANCH_FACTOR - 1] = sb_key_num + key_num;
 		}
 
+		modify_cache(tree, bmerge_left ? lsb_id : rsb_id, NODE, DIRTY);
+		modify_cache(tree, pnode_id, NODE, DIRTY);
+
 		//release current node
 		modify_cache(tree, node_id, NODE, INVALIDATE);
 		tree->off_nodes--;
@@ -2478,6 +3228,7 @@ static int bucket_merge_sibling(tree_t *tree, pair_t *path, bucket_t *bucket, in
 			
 			//update bucket list
 			modify_cache(tree, path[tree->levels].key, BUCKET, INVALIDATE);
+			modify_cache(tree, sibling_id, BUCKET, DIRTY);
 			modify_cache(tree, sibling_id, BUCKET, UNLOCK);
 
 			//update parent tree node
@@ -2488,6 +3239,7 @@ static int bucket_merge_sibling(tree_t *tree, pair_t *path, bucket_t *bucket, in
 				n->id[i] = n->id[i + 1];
 			}
 			n->val[BRANCH_FACTOR - 1] = (--key_num);
+			modify_cache(tree, node_id, NODE, DIRTY);
 			modify_cache(tree, node_id, NODE, UNLOCK);
 
 			bucket_update_keys(tree, path, sibling_id, rm_val);
@@ -2513,6 +3265,7 @@ static int bucket_merge_sibling(tree_t *tree, pair_t *path, bucket_t *bucket, in
 			}
 			//update bucket list
 			modify_cache(tree, path[tree->levels].key, BUCKET, INVALIDATE);
+			modify_cache(tree, sibling_id, BUCKET, DIRTY);
 			modify_cache(tree, sibling_id, BUCKET, UNLOCK);
 
 			//update parent tree node
@@ -2522,6 +3275,7 @@ static int bucket_merge_sibling(tree_t *tree, pair_t *path, bucket_t *bucket, in
 				n->id[i] = n->id[i + 1];
 			}
 			n->val[BRANCH_FACTOR - 1] = (--key_num);
+			modify_cache(tree, node_id, NODE, DIRTY);
 			modify_cache(tree, node_id, NODE, UNLOCK);
 
 			bucket_update_keys(tree, path, sibling_id, rm_val);
@@ -2563,6 +3317,7 @@ static db_result_t delete_item_btree(index_t *index, int value)
 	tmp_bucket = bucket_read(tree, bucket_id);
 	bucket_remove_pair(tmp_bucket, value, &rm_value, 0);
 	free(rm_value);
+	modify_cache(tree, bucket_id, BUCKET, DIRTY);
 	modify_cache(tree, bucket_id, BUCKET, UNLOCK);
 	tree->inserted--;
 
@@ -0,0 +1,879 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/**
+ * \file
+ *      A linear hash index for equality searches of number and string
+ *      attributes.
+ *
+ *      Keys are stored with their tuple id in the pages of buckets. The
+ *      first page of every bucket is in the descriptor file, after the
+ *      header, and pages which don't fit there are chained to it in the
+ *      overflow file. When the table is 3/4 full, the bucket at the split
+ *      pointer is split in two, so the table grows by one bucket at a time
+ *      and a search reads one page in the common case.
+ *
+ *      Range searches are only emulated by the index manager for narrow
+ *      ranges of numbers, by searching every value of the range.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <pthread.h>
+
+#include "index.h"
+#include "result.h"
+#include "storage.h"
+#include "random.h"
+#include "db_options.h"
+#include "db_debug.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+#define HASH_PAGE_SIZE    DB_HASH_PAGE_SIZE
+#define HASH_CACHE_PAGES  (DB_HASH_CACHE_PAGES < 4 ? 4 : DB_HASH_CACHE_PAGES)
+#define HASH_NO_PAGE      0xffffffffU
+#define HASH_OVERFLOW     0x80000000U	/* Pages with this bit in their id are in the overflow file */
+#define HASH_FILL(slots)  ((slots) / 4 * 3)	/* Keys above which a bucket is split */
+
+#define PAGE_ENTRY(hash, page, i) ((page)->entries + (size_t)(i) * (hash)->entry_size)
+#define ENTRY_KEY(entry) ((entry) + sizeof(tuple_id_t))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+/* Written at the start of the descriptor file */
+struct hash_header_s {
+	char overflow_file[DB_MAX_FILENAME_LENGTH];
+	uint32_t keys;				/* keys in the index */
+	uint32_t split;				/* next bucket to split */
+	uint32_t overflow_pages;	/* pages in the overflow file */
+	uint32_t free_page;			/* first page of the free list of the overflow file */
+	uint16_t key_size;			/* bytes of a key, the element size for strings */
+	uint8_t level;				/* the table has (1 << level) + split buckets */
+	uint8_t domain;
+};
+typedef struct hash_header_s hash_header_t;
+
+struct hash_page_s {
+	uint32_t next;				/* overflow page chained after this one, HASH_NO_PAGE for none */
+	uint16_t count;				/* entries in the page */
+	uint16_t reserved;
+	uint8_t entries[HASH_PAGE_SIZE - 8];	/* tuple id and key of every entry */
+};
+typedef struct hash_page_s hash_page_t;
+
+struct hash_cache_entry_s {
+	uint32_t id;
+	uint32_t used;				/* clock of the last use, the least recently used page is evicted */
+	uint8_t dirty;
+	hash_page_t page;
+};
+
+struct hash_s {
+	hash_header_t header;
+	db_storage_id_t bucket_storage;
+	db_storage_id_t overflow_storage;
+	uint16_t entry_size;
+	uint16_t page_entries;
+	uint32_t clock;
+	pthread_mutex_t lock;
+	struct hash_cache_entry_s cache[HASH_CACHE_PAGES];
+};
+typedef struct hash_s hash_t;
+
+/* State of the search done by get_next */
+struct hash_search_s {
+	uint32_t page;
+	uint16_t slot;
+	uint8_t level;				/* size of the table when page was found */
+	uint32_t split;
+	uint32_t found;				/* entries of the key returned so far */
+	long value;					/* number searched for */
+	long max_value;				/* last number of an emulated range search */
+	uint8_t key[DB_MAX_ELEMENT_SIZE];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+static db_result_t create(index_t *);
+static db_result_t destroy(index_t *);
+static db_result_t load(index_t *);
+static db_result_t release(index_t *);
+static db_result_t insert(index_t *, attribute_value_t *, tuple_id_t);
+static db_result_t delete(index_t *, attribute_value_t *);
+static tuple_id_t get_next(index_iterator_t *, uint8_t);
+static db_result_t flush(index_t *);
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+index_api_t index_hash = {
+	INDEX_HASH,
+	INDEX_API_EXTERNAL | INDEX_API_STRING_KEYS,
+	create,
+	destroy,
+	load,
+	release,
+	insert,
+	delete,
+	get_next,
+	flush,
+	NULL
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+static void number_key(hash_t *hash, long value, uint8_t *key)
+{
+	int32_t number;
+
+	/* Keep the value the row has, ints are stored in 16 bits */
+	if (hash->header.domain == DOMAIN_INT) {
+		number = (uint16_t)value;
+	} else {
+		number = (int32_t)value;
+	}
+	memcpy(key, &number, sizeof(number));
+}
+
+static void make_key(hash_t *hash, attribute_value_t *value, uint8_t *key)
+{
+	if (hash->header.domain == DOMAIN_STRING) {
+		/* Strings are cut and padded to the size they have in the row */
+		memset(key, 0, hash->header.key_size);
+		strncpy((char *)key, (char *)VALUE_STRING(value), hash->header.key_size - 1);
+	} else {
+		number_key(hash, db_value_to_long(value), key);
+	}
+}
+
+static uint32_t hash_key(hash_t *hash, const uint8_t *key)
+{
+	uint32_t h;
+	int i;
+
+	/* FNV-1a, then mixed so that the low bits used for buckets depend on all bits */
+	h = 2166136261U;
+	for (i = 0; i < hash->header.key_size; i++) {
+		h = (h ^ key[i]) * 16777619U;
+	}
+	h ^= h >> 16;
+	h *= 0x85ebca6bU;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35U;
+	h ^= h >> 16;
+
+	return h;
+}
+
+static uint32_t bucket_of(hash_t *hash, uint32_t h)
+{
+	uint32_t bucket;
+
+	bucket = h & ((1U << hash->header.level) - 1);
+	if (bucket < hash->header.split) {
+		/* Already split in this round, the next level tells which half */
+		bucket = h & ((2U << hash->header.level) - 1);
+	}
+	return bucket;
+}
+
+static db_result_t page_write(hash_t *hash, struct hash_cache_entry_s *entry)
+{
+	db_result_t result;
+
+	if (entry->id & HASH_OVERFLOW) {
+		result = storage_write_to(hash->overflow_storage, &entry->page, (unsigned long)(entry->id & ~HASH_OVERFLOW) * HASH_PAGE_SIZE, HASH_PAGE_SIZE);
+	} else {
+		result = storage_write_to(hash->bucket_storage, &entry->page, sizeof(hash_header_t) + (unsigned long)entry->id * HASH_PAGE_SIZE, HASH_PAGE_SIZE);
+	}
+	if (DB_SUCCESS(result)) {
+		entry->dirty = 0;
+	}
+	return result;
+}
+
+/****************************************************************************
+ * Name: page_get
+ *
+ * Description: Returns the cache entry of a page, reading it unless the
+ *              page is new. The entry is valid until the next call.
+ *
+ ****************************************************************************/
+static struct hash_cache_entry_s *page_get(hash_t *hash, uint32_t id, int is_new)
+{
+	struct hash_cache_entry_s *entry;
+	struct hash_cache_entry_s *victim;
+	db_result_t result;
+	int i;
+
+	victim = NULL;
+	for (i = 0; i < HASH_CACHE_PAGES; i++) {
+		entry = &hash->cache[i];
+		if (entry->id == id) {
+			entry->used = ++hash->clock;
+			return entry;
+		}
+		if (victim == NULL || (victim->id != HASH_NO_PAGE && (entry->id == HASH_NO_PAGE || entry->used < victim->used))) {
+			victim = entry;
+		}
+	}
+
+	if (victim->id != HASH_NO_PAGE && victim->dirty && DB_ERROR(page_write(hash, victim))) {
+		DB_LOG_E("DB: Failed to write back page %x of a hash index\n", victim->id);
+		return NULL;
+	}
+	victim->id = HASH_NO_PAGE;
+
+	if (is_new) {
+		memset(&victim->page, 0, sizeof(victim->page));
+		victim->page.next = HASH_NO_PAGE;
+	} else {
+		if (id & HASH_OVERFLOW) {
+			result = storage_read_from(hash->overflow_storage, &victim->page, (unsigned long)(id & ~HASH_OVERFLOW) * HASH_PAGE_SIZE, HASH_PAGE_SIZE);
+		} else {
+			result = storage_read_from(hash->bucket_storage, &victim->page, sizeof(hash_header_t) + (unsigned long)id * HASH_PAGE_SIZE, HASH_PAGE_SIZE);
+		}
+		if (DB_ERROR(result)) {
+			DB_LOG_E("DB: Failed to read page %x of a hash index\n", id);
+			return NULL;
+		}
+	}
+	victim->id = id;
+	victim->dirty = 0;
+	victim->used = ++hash->clock;
+
+	return victim;
+}
+
+/* Adds a page at the end of a file; it is written at once so files only grow at their end */
+static struct hash_cache_entry_s *page_append(hash_t *hash, uint32_t id)
+{
+	struct hash_cache_entry_s *entry;
+
+	entry = page_get(hash, id, 1);
+	if (entry == NULL || DB_ERROR(page_write(hash, entry))) {
+		return NULL;
+	}
+	return entry;
+}
+
+static uint32_t overflow_alloc(hash_t *hash)
+{
+	struct hash_cache_entry_s *entry;
+	uint32_t id;
+
+	id = hash->header.free_page;
+	if (id != HASH_NO_PAGE) {
+		entry = page_get(hash, id, 0);
+		if (entry == NULL) {
+			return HASH_NO_PAGE;
+		}
+		hash->header.free_page = entry->page.next;
+		entry->page.next = HASH_NO_PAGE;
+		entry->page.count = 0;
+		entry->dirty = 1;
+		return id;
+	}
+
+	id = HASH_OVERFLOW | hash->header.overflow_pages;
+	if (page_append(hash, id) == NULL) {
+		return HASH_NO_PAGE;
+	}
+	hash->header.overflow_pages++;
+	return id;
+}
+
+static db_result_t overflow_free(hash_t *hash, uint32_t id)
+{
+	struct hash_cache_entry_s *entry;
+
+	entry = page_get(hash, id, 0);
+	if (entry == NULL) {
+		return DB_STORAGE_ERROR;
+	}
+	entry->page.count = 0;
+	entry->page.next = hash->header.free_page;
+	entry->dirty = 1;
+	hash->header.free_page = id;
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: chain_append
+ *
+ * Description: Adds an entry to the first page with room from *tail on,
+ *              chaining an overflow page to the chain when all are full.
+ *              *tail is updated to the page the entry was put in.
+ *
+ ****************************************************************************/
+static db_result_t chain_append(hash_t *hash, uint32_t *tail, const uint8_t *data)
+{
+	struct hash_cache_entry_s *entry;
+	uint32_t id;
+
+	entry = page_get(hash, *tail, 0);
+	if (entry == NULL) {
+		return DB_STORAGE_ERROR;
+	}
+	while (entry->page.count == hash->page_entries) {
+		id = entry->page.next;
+		if (id == HASH_NO_PAGE) {
+			id = overflow_alloc(hash);
+			if (id == HASH_NO_PAGE) {
+				return DB_STORAGE_ERROR;
+			}
+			/* Allocating may have evicted the tail */
+			entry = page_get(hash, *tail, 0);
+			if (entry == NULL) {
+				return DB_STORAGE_ERROR;
+			}
+			entry->page.next = id;
+			entry->dirty = 1;
+		}
+		*tail = id;
+		entry = page_get(hash, id, 0);
+		if (entry == NULL) {
+			return DB_STORAGE_ERROR;
+		}
+	}
+	memcpy(PAGE_ENTRY(hash, &entry->page, entry->page.count), data, hash->entry_size);
+	entry->page.count++;
+	entry->dirty = 1;
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: split
+ *
+ * Description: Splits the bucket at the split pointer. Its entries either
+ *              stay, compacted into the first pages of its chain, or move
+ *              to a new bucket at the end of the table. Pages of the chain
+ *              left empty go to the free list.
+ *
+ ****************************************************************************/
+static db_result_t split(hash_t *hash)
+{
+	struct hash_cache_entry_s *entry;
+	hash_page_t *src;
+	uint32_t *chain;
+	uint32_t *grown;
+	uint32_t length;
+	uint32_t size;
+	uint32_t old_bucket;
+	uint32_t new_bucket;
+	uint32_t old_tail;
+	uint32_t new_tail;
+	uint32_t mask;
+	uint32_t id;
+	uint32_t r;
+	uint16_t i;
+	db_result_t result;
+
+	old_bucket = hash->header.split;
+	new_bucket = old_bucket + (1U << hash->header.level);
+	mask = (2U << hash->header.level) - 1;
+
+	src = (hash_page_t *)malloc(sizeof(hash_page_t));
+	size = 4;
+	chain = (uint32_t *)malloc(size * sizeof(uint32_t));
+	if (src == NULL || chain == NULL) {
+		free(src);
+		free(chain);
+		return DB_ALLOCATION_ERROR;
+	}
+
+	/* Pages of the chain, filled again in the same order */
+	result = DB_STORAGE_ERROR;
+	length = 0;
+	for (id = old_bucket; id != HASH_NO_PAGE; id = entry->page.next) {
+		if (length == size) {
+			size *= 2;
+			grown = (uint32_t *)realloc(chain, size * sizeof(uint32_t));
+			if (grown == NULL) {
+				result = DB_ALLOCATION_ERROR;
+				goto errout;
+			}
+			chain = grown;
+		}
+		chain[length++] = id;
+		entry = page_get(hash, id, 0);
+		if (entry == NULL) {
+			goto errout;
+		}
+	}
+
+	if (page_append(hash, new_bucket) == NULL) {
+		goto errout;
+	}
+	new_tail = new_bucket;
+
+	/* Entries which stay are never more than the entries read, so the
+	   pages are read before they are filled again. */
+	old_tail = old_bucket;
+	for (r = 0; r < length; r++) {
+		entry = page_get(hash, chain[r], 0);
+		if (entry == NULL) {
+			goto errout;
+		}
+		memcpy(src, &entry->page, sizeof(hash_page_t));
+		entry->page.count = 0;
+		entry->dirty = 1;
+
+		for (i = 0; i < src->count; i++) {
+			uint8_t *data = PAGE_ENTRY(hash, src, i);
+
+			if ((hash_key(hash, ENTRY_KEY(data)) & mask) == new_bucket) {
+				result = chain_append(hash, &new_tail, data);
+			} else {
+				result = chain_append(hash, &old_tail, data);
+			}
+			if (DB_ERROR(result)) {
+				goto errout;
+			}
+		}
+	}
+	result = DB_STORAGE_ERROR;
+
+	/* Cut the chain after its last page in use */
+	entry = page_get(hash, old_tail, 0);
+	if (entry == NULL) {
+		goto errout;
+	}
+	entry->page.next = HASH_NO_PAGE;
+	entry->dirty = 1;
+	for (r = 0; chain[r] != old_tail; r++) {
+	}
+	for (r++; r < length; r++) {
+		if (DB_ERROR(overflow_free(hash, chain[r]))) {
+			goto errout;
+		}
+	}
+
+	hash->header.split++;
+	if (hash->header.split == (1U << hash->header.level)) {
+		hash->header.level++;
+		hash->header.split = 0;
+	}
+	result = DB_OK;
+
+errout:
+	free(chain);
+	free(src);
+	return result;
+}
+
+static db_result_t open_files(index_t *index, hash_t *hash)
+{
+	int i;
+
+	hash->entry_size = sizeof(tuple_id_t) + hash->header.key_size;
+	hash->page_entries = sizeof(((hash_page_t *)0)->entries) / hash->entry_size;
+	if (hash->page_entries < 2) {
+		DB_LOG_E("DB: Keys of %u bytes are too long for hash pages of %d bytes\n", hash->header.key_size, HASH_PAGE_SIZE);
+		return DB_LIMIT_ERROR;
+	}
+
+	for (i = 0; i < HASH_CACHE_PAGES; i++) {
+		hash->cache[i].id = HASH_NO_PAGE;
+		hash->cache[i].dirty = 0;
+	}
+	hash->clock = 0;
+	pthread_mutex_init(&hash->lock, NULL);
+
+	hash->bucket_storage = storage_open(index->descriptor_file, O_RDWR);
+	if (hash->bucket_storage < 0) {
+		return DB_STORAGE_ERROR;
+	}
+	hash->overflow_storage = storage_open(hash->header.overflow_file, O_RDWR);
+	if (hash->overflow_storage < 0) {
+		storage_close(hash->bucket_storage);
+		return DB_STORAGE_ERROR;
+	}
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: create
+ *
+ * Description: Creates the descriptor file with the header and one empty
+ *              bucket, and an empty overflow file.
+ *
+ ****************************************************************************/
+static db_result_t create(index_t *index)
+{
+	char filename[DB_MAX_FILENAME_LENGTH];
+	hash_t *hash;
+	db_result_t result;
+
+	hash = (hash_t *)malloc(sizeof(hash_t));
+	if (hash == NULL) {
+		DB_LOG_E("DB: Failed to allocate a hash index\n");
+		return DB_ALLOCATION_ERROR;
+	}
+	memset(&hash->header, 0, sizeof(hash->header));
+
+	snprintf(filename, HASH_FILE_LENGTH, "%s.%x", HASH_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+	snprintf(hash->header.overflow_file, OVERFLOW_FILE_LENGTH, "%s.%x", OVERFLOW_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+	if (DB_ERROR(storage_generate_file(filename))) {
+		free(hash);
+		return DB_STORAGE_ERROR;
+	}
+	if (DB_ERROR(storage_generate_file(hash->header.overflow_file))) {
+		storage_remove(filename);
+		free(hash);
+		return DB_STORAGE_ERROR;
+	}
+	memcpy(index->descriptor_file, filename, sizeof(index->descriptor_file));
+
+	hash->header.domain = index->attr->domain;
+	hash->header.key_size = index->attr->domain == DOMAIN_STRING ? index->attr->element_size : sizeof(int32_t);
+	hash->header.free_page = HASH_NO_PAGE;
+
+	result = open_files(index, hash);
+	if (DB_SUCCESS(result)) {
+		result = storage_write_to(hash->bucket_storage, &hash->header, 0, sizeof(hash->header));
+		if (DB_SUCCESS(result) && page_append(hash, 0) == NULL) {
+			result = DB_STORAGE_ERROR;
+		}
+		if (DB_ERROR(result)) {
+			storage_close(hash->overflow_storage);
+			storage_close(hash->bucket_storage);
+		}
+	}
+	if (DB_ERROR(result)) {
+		storage_remove(filename);
+		storage_remove(hash->header.overflow_file);
+		index->descriptor_file[0] = '\0';
+		free(hash);
+		return result;
+	}
+
+	index->opaque_data = hash;
+	DB_LOG_D("DB: Created a hash index in %s and %s\n", filename, hash->header.overflow_file);
+	return DB_OK;
+}
+
+static db_result_t destroy(index_t *index)
+{
+	char overflow_file[DB_MAX_FILENAME_LENGTH];
+	hash_t *hash;
+
+	hash = (hash_t *)index->opaque_data;
+	if (hash == NULL) {
+		return DB_INDEX_ERROR;
+	}
+	memcpy(overflow_file, hash->header.overflow_file, sizeof(overflow_file));
+	release(index);
+	index->opaque_data = NULL;
+
+	return storage_remove(overflow_file);
+}
+
+static db_result_t load(index_t *index)
+{
+	hash_t *hash;
+	db_storage_id_t fd;
+	db_result_t result;
+
+	hash = (hash_t *)malloc(sizeof(hash_t));
+	if (hash == NULL) {
+		DB_LOG_E("DB: Failed to allocate a hash index while loading\n");
+		return DB_ALLOCATION_ERROR;
+	}
+
+	fd = storage_open(index->descriptor_file, O_RDONLY);
+	if (fd < 0) {
+		free(hash);
+		return DB_STORAGE_ERROR;
+	}
+	result = storage_read_from(fd, &hash->header, 0, sizeof(hash->header));
+	storage_close(fd);
+	if (DB_SUCCESS(result)) {
+		result = open_files(index, hash);
+	}
+	if (DB_ERROR(result)) {
+		DB_LOG_E("DB: Failed to load the hash index %s\n", index->descriptor_file);
+		free(hash);
+		return result;
+	}
+
+	index->opaque_data = hash;
+	DB_LOG_D("DB: Loaded a hash index of %lu keys in %lu buckets\n", (unsigned long)hash->header.keys, (1UL << hash->header.level) + hash->header.split);
+	return DB_OK;
+}
+
+static db_result_t release(index_t *index)
+{
+	hash_t *hash;
+	db_result_t result;
+
+	hash = (hash_t *)index->opaque_data;
+	if (hash == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+	result = flush(index);
+	storage_close(hash->overflow_storage);
+	storage_close(hash->bucket_storage);
+	pthread_mutex_destroy(&hash->lock);
+	free(hash);
+
+	return result;
+}
+
+/****************************************************************************
+ * Name: flush
+ *
+ * Description: Writes the changed pages kept in the cache, then the header
+ *
+ ****************************************************************************/
+static db_result_t flush(index_t *index)
+{
+	hash_t *hash;
+	db_result_t result;
+	int i;
+
+	hash = (hash_t *)index->opaque_data;
+	if (hash == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+
+	result = DB_OK;
+	pthread_mutex_lock(&hash->lock);
+	for (i = 0; i < HASH_CACHE_PAGES && DB_SUCCESS(result); i++) {
+		if (hash->cache[i].id != HASH_NO_PAGE && hash->cache[i].dirty) {
+			result = page_write(hash, &hash->cache[i]);
+		}
+	}
+	if (DB_SUCCESS(result)) {
+		result = storage_write_to(hash->bucket_storage, &hash->header, 0, sizeof(hash->header));
+	}
+	pthread_mutex_unlock(&hash->lock);
+
+	return result;
+}
+
+static db_result_t insert(index_t *index, attribute_value_t *value, tuple_id_t tuple_id)
+{
+	struct hash_cache_entry_s *entry;
+	hash_t *hash;
+	uint8_t data[sizeof(tuple_id_t) + DB_MAX_ELEMENT_SIZE];
+	uint32_t buckets;
+	uint32_t tail;
+	db_result_t result;
+
+	hash = (hash_t *)index->opaque_data;
+	memcpy(data, &tuple_id, sizeof(tuple_id));
+	make_key(hash, value, ENTRY_KEY(data));
+
+	pthread_mutex_lock(&hash->lock);
+	/* Entries are kept in the order they are inserted, see delete() */
+	result = DB_OK;
+	for (tail = bucket_of(hash, hash_key(hash, ENTRY_KEY(data))); ; tail = entry->page.next) {
+		entry = page_get(hash, tail, 0);
+		if (entry == NULL) {
+			result = DB_STORAGE_ERROR;
+			break;
+		}
+		if (entry->page.next == HASH_NO_PAGE) {
+			break;
+		}
+	}
+	if (DB_SUCCESS(result)) {
+		result = chain_append(hash, &tail, data);
+	}
+	if (DB_SUCCESS(result)) {
+		hash->header.keys++;
+		buckets = (1U << hash->header.level) + hash->header.split;
+		if (hash->header.keys > HASH_FILL(buckets * hash->page_entries)) {
+			result = split(hash);
+		}
+	}
+	pthread_mutex_unlock(&hash->lock);
+
+	if (DB_ERROR(result)) {
+		DB_LOG_E("DB: Failed to insert tuple %lu into a hash index\n", (unsigned long)tuple_id);
+	}
+	return result;
+}
+
+/****************************************************************************
+ * Name: delete
+ *
+ * Description: Removes the oldest entry of the key. When a relation is
+ *              rewritten, the entries of its rows are removed and inserted
+ *              again in the order of the rows, so this keeps the tuple ids
+ *              of duplicate keys right. Pages left empty stay in the chain
+ *              until the bucket is split.
+ *
+ ****************************************************************************/
+static db_result_t delete(index_t *index, attribute_value_t *value)
+{
+	struct hash_cache_entry_s *entry;
+	hash_t *hash;
+	uint8_t key[DB_MAX_ELEMENT_SIZE];
+	uint8_t *data;
+	uint32_t id;
+	uint16_t i;
+	db_result_t result;
+
+	hash = (hash_t *)index->opaque_data;
+	make_key(hash, value, key);
+
+	result = DB_INDEX_ERROR;
+	pthread_mutex_lock(&hash->lock);
+	for (id = bucket_of(hash, hash_key(hash, key)); id != HASH_NO_PAGE; id = entry->page.next) {
+		entry = page_get(hash, id, 0);
+		if (entry == NULL) {
+			result = DB_STORAGE_ERROR;
+			break;
+		}
+		for (i = 0; i < entry->page.count; i++) {
+			data = PAGE_ENTRY(hash, &entry->page, i);
+			if (memcmp(ENTRY_KEY(data), key, hash->header.key_size) == 0) {
+				entry->page.count--;
+				memmove(data, data + hash->entry_size, (size_t)(entry->page.count - i) * hash->entry_size);
+				entry->dirty = 1;
+				hash->header.keys--;
+				result = DB_OK;
+				break;
+			}
+		}
+		if (result != DB_INDEX_ERROR) {
+			break;
+		}
+	}
+	pthread_mutex_unlock(&hash->lock);
+
+	return result;
+}
+
+/****************************************************************************
+ * Name: get_next
+ *
+ * Description: Returns the tuple id of the next entry of the searched key.
+ *              A range of numbers is searched one value after the other.
+ *              Removals scan the relation, so matched_condition is unused.
+ *
+ *              Inserts may go on between two calls. They append entries to
+ *              the chain of the key, while a split rewrites the chain in the
+ *              same order. After a split the chain is searched again from
+ *              its start, skipping the entries of the key already returned.
+ *
+ ****************************************************************************/
+static tuple_id_t get_next(index_iterator_t *iterator, uint8_t matched_condition)
+{
+	struct hash_search_s *search;
+	struct hash_cache_entry_s *entry;
+	hash_t *hash;
+	uint8_t *data;
+	tuple_id_t tuple_id;
+	uint32_t skip;
+
+	hash = (hash_t *)iterator->index->opaque_data;
+	search = (struct hash_search_s *)iterator->state;
+
+	if (search == NULL) {
+		if (iterator->next_item_no != 0) {
+			/* The search is over */
+			return INVALID_TUPLE;
+		}
+		search = (struct hash_search_s *)malloc(sizeof(struct hash_search_s));
+		if (search == NULL) {
+			return INVALID_TUPLE;
+		}
+		if (hash->header.domain == DOMAIN_STRING) {
+			make_key(hash, &iterator->min_value, search->key);
+			search->value = search->max_value = 0;
+		} else {
+			search->value = db_value_to_long(&iterator->min_value);
+			search->max_value = db_value_to_long(&iterator->max_value);
+			number_key(hash, search->value, search->key);
+		}
+		search->page = HASH_NO_PAGE;
+		search->found = 0;
+		iterator->state = search;
+		/* The search is done, even if it finds no tuple */
+		iterator->next_item_no = 1;
+	}
+
+	pthread_mutex_lock(&hash->lock);
+	skip = 0;
+	if (search->page == HASH_NO_PAGE || search->level != hash->header.level || search->split != hash->header.split) {
+		/* The first call, or a split rewrote the chain since the last one */
+		search->page = bucket_of(hash, hash_key(hash, search->key));
+		search->slot = 0;
+		search->level = hash->header.level;
+		search->split = hash->header.split;
+		skip = search->found;
+	}
+
+	tuple_id = INVALID_TUPLE;
+	while (tuple_id == INVALID_TUPLE) {
+		if (search->page == HASH_NO_PAGE) {
+			if (search->value >= search->max_value) {
+				break;
+			}
+			number_key(hash, ++search->value, search->key);
+			search->page = bucket_of(hash, hash_key(hash, search->key));
+			search->slot = 0;
+			search->found = 0;
+			skip = 0;
+		}
+
+		entry = page_get(hash, search->page, 0);
+		if (entry == NULL) {
+			iterator->next_item_no = 0;
+			break;
+		}
+		while (search->slot < entry->page.count) {
+			data = PAGE_ENTRY(hash, &entry->page, search->slot++);
+			if (memcmp(ENTRY_KEY(data), search->key, hash->header.key_size) == 0) {
+				if (skip > 0) {
+					skip--;
+					continue;
+				}
+				memcpy(&tuple_id, data, sizeof(tuple_id));
+				search->found++;
+				iterator->found_items++;
+				break;
+			}
+		}
+		if (tuple_id == INVALID_TUPLE) {
+			search->page = entry->page.next;
+			search->slot = 0;
+		}
+	}
+	pthread_mutex_unlock(&hash->lock);
+
+	if (tuple_id == INVALID_TUPLE) {
+		free(search);
+		iterator->state = NULL;
+	}
+	return tuple_id;
+}
@@ -72,7 +72,8 @@
 * Private Types
 ****************************************************************************/
 static index_api_t *index_components[] = { &index_inline,
-										   &index_bplustree
+										   &index_bplustree,
+										   &index_hash
 										 };
 
 pthread_attr_t g_attr;
@@ -142,17 +143,22 @@ db_result_t index_create(index_type_t index_type, relation_t *rel, attribute_t *
 		return DB_INDEX_ERROR;
 	}
 
-	if (attr->domain != DOMAIN_INT && attr->domain != DOMAIN_LONG) {
-		DB_LOG_E("DB: Cannot create an index for a non-number attribute!\n");
-		return DB_INDEX_ERROR;
-	}
-
 	api = find_index_api(index_type);
 	if (api == NULL) {
 		DB_LOG_E("DB: No API for index type %d\n", (int)index_type);
 		return DB_INDEX_ERROR;
 	}
 
+	if (attr->domain == DOMAIN_STRING && !(api->flags & INDEX_API_STRING_KEYS)) {
+		DB_LOG_E("DB: Index type %d cannot index the string attribute %s\n", (int)index_type, attr->name);
+		return DB_INDEX_ERROR;
+	}
+
+	if (attr->domain != DOMAIN_INT && attr->domain != DOMAIN_LONG && attr->domain != DOMAIN_STRING) {
+		DB_LOG_E("DB: Cannot create an index for an attribute which is neither a number nor a string!\n");
+		return DB_INDEX_ERROR;
+	}
+
 	index = malloc(sizeof(index_t));
 	if (index == NULL) {
 		DB_LOG_E("DB: Failed to allocate an index\n");
@@ -175,6 +181,7 @@ db_result_t index_create(index_type_t index_type, relation_t *rel, attribute_t *
 	}
 
 	attr->index = index;
+	attr->flags &= ~ATTRIBUTE_FLAG_NO_INDEX;
 	list_push(indices, index);
 
 	if (DB_ERROR(storage_put_index(index))) {
@@ -183,7 +190,7 @@ db_result_t index_create(index_type_t index_type, relation_t *rel, attribute_t *
 		return DB_INDEX_ERROR;
 	}
 
-	if (!(api->flags & INDEX_API_INLINE) && cardinality > 0) {
+	if (!(api->flags & (INDEX_API_INLINE | INDEX_API_BULK_LOAD)) && cardinality > 0) {
 		DB_LOG_D("DB: Created an index for an old relation; issuing a load request\n");
 		if (DB_ERROR(db_indexing(rel))) {
 			index_destroy(index);
@@ -228,6 +235,7 @@ db_result_t index_load(relation_t *rel, attribute_t *attr)
 {
 	index_t *index;
 	index_api_t *api;
+	db_result_t result;
 
 	DB_LOG_D("DB: Attempting to load an index over %s.%s\n", rel->name, attr->name);
 
@@ -248,6 +256,9 @@ db_result_t index_load(relation_t *rel, attribute_t *attr)
 	}
 
 	if (!found) {
+		if (attr->flags & ATTRIBUTE_FLAG_NO_INDEX) {
+			return DB_INDEX_ERROR;
+		}
 
 		index = malloc(sizeof(index_t));
 		if (index == NULL) {
@@ -255,8 +266,14 @@ db_result_t index_load(relation_t *rel, attribute_t *attr)
 			return DB_ALLOCATION_ERROR;
 		}
 
-		if (DB_ERROR(storage_get_index(index, rel, attr))) {
-			DB_LOG_E("DB: Failed load an index descriptor from storage\n");
+		result = storage_get_index(index, rel, attr);
+		if (DB_ERROR(result)) {
+			DB_LOG_D("DB: Failed load an index descriptor from storage\n");
+			if (result == DB_STORAGE_ERROR) {
+				/* Inserts and selects try to load the index of every attribute,
+				   remember that there is none instead of reading storage again. */
+				attr->flags |= ATTRIBUTE_FLAG_NO_INDEX;
+			}
 			free(index);
 			return DB_INDEX_ERROR;
 		}
@@ -316,6 +333,22 @@ db_result_t index_delete(index_t *index, attribute_value_t *value)
 	return index->api->delete(index, value);
 }
 
+db_result_t index_flush(void)
+{
+	index_t *index;
+	db_result_t result;
+
+	result = DB_OK;
+	for (index = list_head(indices); index != NULL; index = index->next) {
+		if (index->api->flush != NULL && DB_ERROR(index->api->flush(index))) {
+			DB_LOG_E("DB: Failed to flush the index of %s.%s\n", index->rel->name, index->attr->name);
+			result = DB_INDEX_ERROR;
+		}
+	}
+
+	return result;
+}
+
 db_result_t index_get_iterator(index_iterator_t *iterator, index_t *index, attribute_value_t *min_value, attribute_value_t *max_value)
 {
 	tuple_id_t cardinality;
@@ -366,6 +399,11 @@ db_result_t index_get_iterator(index_iterator_t *iterator, index_t *index, attri
 	iterator->min_value = *min_value;
 	iterator->max_value = *max_value;
 	iterator->next_item_no = 0;
+	iterator->found_items = 0;
+	/* The search is a snapshot of the relation as it is now. Writers may
+	   add keys while it runs, their tuples are appended after these rows. */
+	iterator->rows = cardinality;
+	iterator->state = NULL;
 
 	DB_LOG_D("DB: Acquired an index iterator for %s.%s over the range (%ld,%ld)\n", index->rel->name, index->attr->name, min_value->u.long_value, max_value->u.long_value);
 
@@ -374,6 +412,7 @@ db_result_t index_get_iterator(index_iterator_t *iterator, index_t *index, attri
 
 tuple_id_t index_get_next(index_iterator_t *iterator, uint8_t matched_condition)
 {
+	tuple_id_t tuple_id;
 	long min;
 	long max;
 
@@ -391,11 +430,42 @@ tuple_id_t index_get_next(index_iterator_t *iterator, uint8_t matched_condition)
 			 * whose values are unique, and we already found one item.
 			 */
 			DB_LOG_E("DB: Equivalence search finished\n");
+			index_release_iterator(iterator);
 			return INVALID_TUPLE;
 		}
 	}
 
-	return iterator->index->api->get_next(iterator, matched_condition);
+	do {
+		tuple_id = iterator->index->api->get_next(iterator, matched_condition);
+	} while (matched_condition && tuple_id != INVALID_TUPLE && tuple_id >= iterator->rows);
+
+	return tuple_id;
+}
+
+/* index_release_iterator: Free the state of a search which was stopped
+   before the index returned its last tuple. */
+void index_release_iterator(index_iterator_t *iterator)
+{
+	if (iterator->state != NULL) {
+		free(iterator->state);
+		iterator->state = NULL;
+	}
+}
+
+/* index_get_edge: Get the smallest key, or the largest one if largest is
+   set, of the range [min, max] from the index alone. DB_FINISHED is
+   returned if no key is in the range. */
+db_result_t index_get_edge(index_t *index, long min, long max, uint8_t largest, long *key)
+{
+	if (index->api->get_edge == NULL) {
+		return DB_IMPLEMENTATION_ERROR;
+	}
+
+	if (index->state != INDEX_READY) {
+		return DB_INDEX_ERROR;
+	}
+
+	return index->api->get_edge(index, min, max, largest, key);
 }
 
 /****************************************************************************
@@ -451,9 +521,7 @@ db_result_t db_indexing(relation_t *rel)
 		DB_LOG_E("DB: Failed to allocate row\n");
 		return DB_ALLOCATION_ERROR;
 	}
-#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
-	storage_flush_insert_buffer();
-#endif
+	storage_cache_flush();
 	DB_LOG_D("DB: Loading the index for %s.%s...\n", index->rel->name, index->attr->name);
 
 	offset  = 0;
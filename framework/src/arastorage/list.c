@@ -71,7 +71,9 @@
 * Public Type Definitions
 ****************************************************************************/
 
+#ifndef NULL
 #define NULL 0
+#endif
 
 struct list {
 	struct list *next;
@@ -113,6 +113,12 @@ static void get_operand(lvm_instance_t *p, operand_t *operand)
 {
 	memcpy(operand, &p->code[p->ip], sizeof(*operand));
 	p->ip += sizeof(*operand);
+
+	/* A bound parameter is a constant for both execution and derivation. */
+	if (operand->type == LVM_PARAMETER && operand->value.id < LVM_MAX_PARAMETER_ID) {
+		operand->type = LVM_LONG;
+		operand->value = p->parameters[operand->value.id];
+	}
 }
 
 static node_type_t get_type(lvm_instance_t *p)
@@ -142,6 +148,22 @@ static long operand_to_long(lvm_instance_t *p, operand_t *operand)
 	}
 }
 
+/* The string an operand refers to, or NULL if it isn't a string. */
+static const char *operand_to_string(lvm_instance_t *p, operand_t *operand)
+{
+	switch (operand->type) {
+	case LVM_STRING:
+		return p->strings + operand->value.l;
+	case LVM_VARIABLE:
+		if (operand->value.id < LVM_MAX_VARIABLE_ID && p->variables[operand->value.id].type == LVM_STRING) {
+			return p->variables[operand->value.id].value.s;
+		}
+		return NULL;
+	default:
+		return NULL;
+	}
+}
+
 static lvm_status_t eval_expr(lvm_instance_t *p, operator_t op, operand_t *result)
 {
 	int i;
@@ -168,6 +190,9 @@ static lvm_status_t eval_expr(lvm_instance_t *p, operator_t op, operand_t *resul
 		default:
 			return SEMANTIC_ERROR;
 		}
+		if (operand_to_string(p, &operand[i]) != NULL) {
+			return TYPE_ERROR;
+		}
 		value[i] = operand_to_long(p, &operand[i]);
 	}
 
@@ -202,6 +227,7 @@ static int eval_logic(lvm_instance_t *p, operator_t *op)
 	int i;
 	int r;
 	operand_t operand;
+	const char *string[2];
 	long result[2];
 	node_type_t type;
 	operator_t *operator;
@@ -248,9 +274,19 @@ static int eval_logic(lvm_instance_t *p, operator_t *op)
 		default:
 			return SEMANTIC_ERROR;
 		}
+		string[i] = operand_to_string(p, &operand);
 		result[i] = operand_to_long(p, &operand);
 	}
 
+	if (string[0] != NULL || string[1] != NULL) {
+		/* Strings are only compared with strings, in the order of strcmp() */
+		if (string[0] == NULL || string[1] == NULL) {
+			return TYPE_ERROR;
+		}
+		result[0] = strcmp(string[0], string[1]);
+		result[1] = 0;
+	}
+
 	l1 = result[0];
 	l2 = result[1];
 	DB_LOG_D("Result1: %ld\nResult2: %ld\n", l1, l2);
@@ -283,6 +319,14 @@ void lvm_reset(lvm_instance_t *p)
 	memset(p->code, 0, sizeof(p->code));
 	memset(p->variables, 0, sizeof(p->variables));
 	memset(p->derivations, 0, sizeof(p->derivations));
+	memset(p->parameters, 0, sizeof(p->parameters));
+	memset(p->strings, 0, sizeof(p->strings));
+	p->strings_end = 0;
+}
+
+void lvm_clone(lvm_instance_t *dst, lvm_instance_t *src)
+{
+	memcpy(dst, src, sizeof(*dst));
 }
 
 lvm_ip_t lvm_jump_to_operand(lvm_instance_t *p)
@@ -432,12 +476,22 @@ lvm_status_t lvm_set_operand(lvm_instance_t *p, operand_t *op)
 lvm_status_t lvm_set_operand_value(lvm_instance_t *p, attribute_t *attr, unsigned char *value)
 {
 	operand_value_t operand_value;
+	variable_id_t id;
+
+	memset(&operand_value, 0, sizeof(operand_value));
 
 	/* Update the internal state of the PLE. */
 	if (attr->domain == DOMAIN_INT) {
 		operand_value.l = value[0] << 8 | value[1];
 	} else if (attr->domain == DOMAIN_LONG) {
 		operand_value.l = (uint32_t)value[0] << 24 | (uint32_t)value[1] << 16 | (uint32_t)value[2] << 8 | value[3];
+	} else if (attr->domain == DOMAIN_STRING) {
+		/* The string is compared where it is, in the row being processed. */
+		id = lookup(p, attr->name);
+		if (id < LVM_MAX_VARIABLE_ID) {
+			p->variables[id].type = LVM_STRING;
+		}
+		operand_value.s = (const char *)value;
 	}
 
 	return lvm_set_variable_value(p, attr->name, operand_value);
@@ -453,6 +507,27 @@ lvm_status_t lvm_set_long(lvm_instance_t *p, long l)
 	return lvm_set_operand(p, &op);
 }
 
+lvm_status_t lvm_set_string(lvm_instance_t *p, const char *s)
+{
+	operand_t op;
+	size_t length;
+
+	/* The code only has the offset of the string, which stays valid when
+	   the instance is cloned. */
+	length = strlen(s) + 1;
+	if (p->strings_end + length > sizeof(p->strings)) {
+		DB_LOG_E("lvm_set_string failed because of overflow\n");
+		return STACK_OVERFLOW;
+	}
+	memcpy(&p->strings[p->strings_end], s, length);
+
+	op.type = LVM_STRING;
+	op.value.l = p->strings_end;
+	p->strings_end += length;
+
+	return lvm_set_operand(p, &op);
+}
+
 lvm_status_t lvm_register_variable(lvm_instance_t *p, char *name, operand_type_t type)
 {
 	variable_id_t id;
@@ -502,6 +577,29 @@ lvm_status_t lvm_set_variable(lvm_instance_t *p, char *name)
 	return lvm_set_operand(p, &op);
 }
 
+lvm_status_t lvm_set_parameter(lvm_instance_t *p, variable_id_t id)
+{
+	operand_t op;
+
+	if (id >= LVM_MAX_PARAMETER_ID) {
+		return VARIABLE_LIMIT_REACHED;
+	}
+
+	op.type = LVM_PARAMETER;
+	op.value.id = id;
+
+	return lvm_set_operand(p, &op);
+}
+
+lvm_status_t lvm_set_parameter_value(lvm_instance_t *p, variable_id_t id, operand_value_t value)
+{
+	if (id >= LVM_MAX_PARAMETER_ID) {
+		return INVALID_IDENTIFIER;
+	}
+	p->parameters[id] = value;
+	return LVM_TRUE;
+}
+
 static void create_intersection(derivation_t *result, derivation_t *d1, derivation_t *d2)
 {
 	int i;
@@ -512,9 +610,15 @@ static void create_intersection(derivation_t *result, derivation_t *d1, derivati
 		} else if (d1[i].derived && !d2[i].derived) {
 			result[i].min.l = d1[i].min.l;
 			result[i].max.l = d1[i].max.l;
+			result[i].string = d1[i].string;
 		} else if (!d1[i].derived && d2[i].derived) {
 			result[i].min.l = d2[i].min.l;
 			result[i].max.l = d2[i].max.l;
+			result[i].string = d2[i].string;
+		} else if (d1[i].string || d2[i].string) {
+			/* Strings have no range, search for one of them and let
+			   the condition check the other. */
+			result[i] = d1[i].string ? d1[i] : d2[i];
 		} else {
 			/* Both derivations have been made; create an
 			   intersection of the ranges. */
@@ -545,9 +649,20 @@ static void create_union(derivation_t *result, derivation_t *d1, derivation_t *d
 		} else if (d1[i].derived && !d2[i].derived) {
 			result[i].min.l = d1[i].min.l;
 			result[i].max.l = d1[i].max.l;
+			result[i].string = d1[i].string;
 		} else if (!d1[i].derived && d2[i].derived) {
 			result[i].min.l = d2[i].min.l;
 			result[i].max.l = d2[i].max.l;
+			result[i].string = d2[i].string;
+		} else if (d1[i].string || d2[i].string) {
+			/* Two strings can't be searched at once, unless they are
+			   the same constant. */
+			if (d1[i].string && d2[i].string && d1[i].min.l == d2[i].min.l) {
+				result[i] = d1[i];
+			} else {
+				result[i].derived = 0;
+			}
+			continue;
 		} else {
 			/* Both derivations have been made; create a
 			   union of the ranges. */
@@ -649,7 +764,20 @@ static int derive_relation(lvm_instance_t *p, derivation_t *local_derivations)
 	DB_LOG_D("variable id %d, value %ld\n", variable_id, *(long *)value);
 
 	derivation = local_derivations + variable_id;
+	if (operand[0].type == LVM_STRING || operand[1].type == LVM_STRING) {
+		/* Strings can only be searched for by equality. */
+		if (*operator != LVM_EQ || (operand[0].type != LVM_VARIABLE && operand[1].type != LVM_VARIABLE)) {
+			return DERIVATION_ERROR;
+		}
+		derivation->min = *value;
+		derivation->max = *value;
+		derivation->string = 1;
+		derivation->derived = 1;
+		return LVM_TRUE;
+	}
+
 	/* Default values. */
+	derivation->string = 0;
 	derivation->max.l = DB_LONG_MAX;
 	derivation->min.l = DB_LONG_MIN;
 
@@ -691,7 +819,7 @@ lvm_status_t lvm_get_derived_range(lvm_instance_t *p, char *name, operand_value_
 
 	for (i = 0; i < LVM_MAX_VARIABLE_ID; i++) {
 		if (strcmp(name, p->variables[i].name) == 0) {
-			if (p->derivations[i].derived) {
+			if (p->derivations[i].derived && !p->derivations[i].string) {
 				*min = p->derivations[i].min;
 				*max = p->derivations[i].max;
 				return LVM_TRUE;
@@ -702,6 +830,87 @@ lvm_status_t lvm_get_derived_range(lvm_instance_t *p, char *name, operand_value_
 	return INVALID_IDENTIFIER;
 }
 
+/* Whether the condition is nothing but comparisons of the variable with
+   constants joined by AND, i.e. whether its derived range is exact. */
+static int is_exact_range(lvm_instance_t *p, variable_id_t id)
+{
+	operator_t *operator;
+	operand_t operand[2];
+	int i;
+
+	get_type(p);
+	operator = get_operator(p);
+
+	if (IS_CONNECTIVE(*operator)) {
+		if (*operator != LVM_AND) {
+			return 0;
+		}
+		return is_exact_range(p, id) && is_exact_range(p, id);
+	}
+
+	for (i = 0; i < 2; i++) {
+		if (get_type(p) != LVM_OPERAND) {
+			return 0;
+		}
+		get_operand(p, &operand[i]);
+	}
+
+	if (operand[0].type != LVM_VARIABLE || operand[0].value.id != id || operand[1].type != LVM_LONG) {
+		return 0;
+	}
+
+	switch (*operator) {
+	case LVM_EQ:
+	case LVM_GE:
+	case LVM_GEQ:
+	case LVM_LE:
+	case LVM_LEQ:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+/* lvm_get_exact_range: Get the derived range of a variable, if and only if
+   the condition holds exactly for the values in the range. */
+lvm_status_t lvm_get_exact_range(lvm_instance_t *p, char *name, operand_value_t *min, operand_value_t *max)
+{
+	variable_id_t id;
+	lvm_ip_t ip;
+	int exact;
+
+	id = lookup(p, name);
+	if (id >= LVM_MAX_VARIABLE_ID || p->variables[id].name[0] == '\0') {
+		return INVALID_IDENTIFIER;
+	}
+
+	ip = p->ip;
+	p->ip = 0;
+	exact = is_exact_range(p, id);
+	p->ip = ip;
+	if (!exact) {
+		return DERIVATION_ERROR;
+	}
+
+	return lvm_get_derived_range(p, name, min, max);
+}
+
+lvm_status_t lvm_get_derived_string(lvm_instance_t *p, char *name, const char **value)
+{
+	int i;
+
+	for (i = 0; i < LVM_MAX_VARIABLE_ID; i++) {
+		if (strcmp(name, p->variables[i].name) == 0) {
+			if (p->derivations[i].derived && p->derivations[i].string) {
+				*value = p->strings + p->derivations[i].min.l;
+				return LVM_TRUE;
+			}
+			return DERIVATION_ERROR;
+		}
+	}
+	return INVALID_IDENTIFIER;
+}
+
 #if DEBUG
 static lvm_ip_t print_operator(lvm_instance_t *p, lvm_ip_t index)
 {
@@ -756,6 +965,12 @@ static lvm_ip_t print_operand(lvm_instance_t *p, lvm_ip_t index)
 	case LVM_LONG:
 		DB_LOG_D("long:%ld ", operand.value.l);
 		break;
+	case LVM_PARAMETER:
+		DB_LOG_D("param(%d) ", operand.value.id);
+		break;
+	case LVM_STRING:
+		DB_LOG_D("string:'%s' ", p->strings + operand.value.l);
+		break;
 	default:
 		DB_LOG_D("?? ");
 		break;
@@ -118,7 +118,9 @@ typedef enum lvm_operator_e operator_t;
 enum operand_type_e {
 	LVM_VARIABLE,
 	LVM_FLOAT,
-	LVM_LONG
+	LVM_LONG,
+	LVM_PARAMETER,
+	LVM_STRING
 };
 typedef enum operand_type_e operand_type_t;
 
@@ -129,6 +131,7 @@ union operand_value_u {
 	float f;
 #endif
 	variable_id_t id;
+	const char *s;
 };
 typedef union operand_value_u operand_value_t;
 
@@ -149,6 +152,7 @@ struct derivation_s {
 	operand_value_t max;
 	operand_value_t min;
 	uint8_t derived;
+	uint8_t string;		/* equal to the string constant at offset min.l */
 };
 typedef struct derivation_s derivation_t;
 
@@ -156,6 +160,9 @@ struct lvm_instance_s {
 	unsigned char code[DB_VM_BYTECODE_SIZE];
 	variable_t variables[LVM_MAX_VARIABLE_ID];
 	derivation_t derivations[LVM_MAX_VARIABLE_ID];
+	operand_value_t parameters[LVM_MAX_PARAMETER_ID];
+	char strings[LVM_STRING_SIZE];
+	lvm_ip_t strings_end;
 	lvm_ip_t end;
 	lvm_ip_t ip;
 	unsigned error;
@@ -169,6 +176,8 @@ void lvm_reset(lvm_instance_t *p);
 void lvm_clone(lvm_instance_t *dst, lvm_instance_t *src);
 lvm_status_t lvm_derive(lvm_instance_t *p);
 lvm_status_t lvm_get_derived_range(lvm_instance_t *p, char *name, operand_value_t *min, operand_value_t *max);
+lvm_status_t lvm_get_exact_range(lvm_instance_t *p, char *name, operand_value_t *min, operand_value_t *max);
+lvm_status_t lvm_get_derived_string(lvm_instance_t *p, char *name, const char **value);
 void lvm_print_derivations(lvm_instance_t *p);
 lvm_status_t lvm_execute(lvm_instance_t *p);
 lvm_status_t lvm_register_variable(lvm_instance_t *p, char *name, operand_type_t type);
@@ -182,6 +191,9 @@ lvm_status_t lvm_set_relation(lvm_instance_t *p, operator_t op);
 lvm_status_t lvm_set_operand(lvm_instance_t *p, operand_t *op);
 lvm_status_t lvm_set_operand_value(lvm_instance_t *p, attribute_t *attr, unsigned char *value);
 lvm_status_t lvm_set_long(lvm_instance_t *p, long l);
+lvm_status_t lvm_set_string(lvm_instance_t *p, const char *s);
 lvm_status_t lvm_set_variable(lvm_instance_t *p, char *name);
 lvm_status_t lvm_set_variable_value(lvm_instance_t *p, char *name, operand_value_t value);
+lvm_status_t lvm_set_parameter(lvm_instance_t *p, variable_id_t id);
+lvm_status_t lvm_set_parameter_value(lvm_instance_t *p, variable_id_t id, operand_value_t value);
 #endif							/* LVM_H */
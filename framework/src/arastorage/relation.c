@@ -68,6 +68,7 @@
 #include "list.h"
 #include "aql.h"
 #include "relation.h"
+#include "transaction.h"
 
 /****************************************************************************
 * Global Function Prototypes
@@ -272,10 +273,35 @@ db_result_t relation_release(relation_t *rel)
 		if (DB_ERROR(res)) {
 			return res;
 		}
+		/* Result relations of queries live only as long as their query. */
+		if (rel->dir == DB_MEMORY) {
+			relation_free(rel);
+		}
 	}
 	return DB_OK;
 }
 
+/*
+ * Allocate the relation describing the rows of a query result. Its rows are
+ * never stored, the cursor reads them from the queried relation, so it is
+ * private to the query and isn't kept in the relation list.
+ */
+static relation_t *relation_create_result(void)
+{
+	relation_t *rel;
+
+	rel = relation_allocate();
+	if (rel == NULL) {
+		return NULL;
+	}
+
+	strncpy(rel->name, RESULT_RELATION, sizeof(rel->name) - 1);
+	rel->dir = DB_MEMORY;
+	rel->cardinality = 0;
+	rel->references = 1;
+	return rel;
+}
+
 relation_t *relation_create(char *name, db_direction_t dir)
 {
 	relation_t *rel;
@@ -426,12 +452,10 @@ db_result_t relation_remove_tuple(relation_t *rel, int remove_tuples)
 		return DB_OK;
 	}
 
-#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
-	/* Flush insert buffer to make sure of writing tuples before removing relation */
-	if (DB_SUCCESS(storage_flush_insert_buffer())) {
-		DB_LOG_D("DB : flush insert buffer!!\n");
+	/* Flush the page cache to make sure of writing tuples before removing relation */
+	if (DB_SUCCESS(storage_cache_flush())) {
+		DB_LOG_D("DB : flush page cache!!\n");
 	}
-#endif
 
 	result = storage_drop_relation(rel, remove_tuples);
 	relation_free(rel);
@@ -449,12 +473,10 @@ db_result_t relation_remove_index(relation_t *rel, int remove_tuples)
 		return DB_OK;
 	}
 
-#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
-	/* Flush insert buffer to make sure of writing tuples before removing relation */
-	if (DB_SUCCESS(storage_flush_insert_buffer())) {
-		DB_LOG_D("DB : flush insert buffer!!\n");
+	/* Flush the page cache to make sure of writing tuples before removing relation */
+	if (DB_SUCCESS(storage_cache_flush())) {
+		DB_LOG_D("DB : flush page cache!!\n");
 	}
-#endif
 	attr = list_head(rel->attributes);
 
 	while (attr != NULL) {
@@ -472,7 +494,7 @@ db_result_t relation_remove_index(relation_t *rel, int remove_tuples)
 	if (filename == NULL) {
 		return DB_STORAGE_ERROR;
 	}
-	snprintf(filename, len, "%s%s\0", rel->name, INDEX_NAME_SUFFIX);
+	snprintf(filename, len, "%s%s", rel->name, INDEX_NAME_SUFFIX);
 	result = storage_remove(filename);
 	free(filename);
 	if (DB_ERROR(result)) {
@@ -515,8 +537,10 @@ db_result_t relation_insert(relation_t *rel, attribute_value_t *values)
 	unsigned char *ptr;
 	attribute_value_t *value;
 	db_result_t result;
+	bool in_transaction;
 
 	value = values;
+	in_transaction = transaction_is_active();
 
 	DB_LOG_D("DB: Relation %s has a record size of %u bytes\n", rel->name, (unsigned)rel->row_length);
 	ptr = record;
@@ -563,12 +587,13 @@ db_result_t relation_insert(relation_t *rel, attribute_value_t *values)
 			DB_LOG_V(", ");
 		}
 #endif              /* DEBUG */
-		if (attr->index == NULL) {
-			index_load(rel, attr);
-		}
 		ptr += attr->element_size;
-		if (attr->index != NULL) {
-			if (DB_ERROR(index_insert(attr->index, value, rel->next_row))) {
+		/* Rows of a transaction are indexed when it is committed. */
+		if (!in_transaction) {
+			if (attr->index == NULL) {
+				index_load(rel, attr);
+			}
+			if (attr->index != NULL && DB_ERROR(index_insert(attr->index, value, rel->next_row))) {
 				return DB_INDEX_ERROR;
 			}
 		}
@@ -578,16 +603,18 @@ db_result_t relation_insert(relation_t *rel, attribute_value_t *values)
 
 	DB_LOG_V(")\n");
 
+	if (in_transaction) {
+		return transaction_insert(rel, record);
+	}
 	return storage_put_row(rel, record, FALSE);
 }
 
 /*
  * Update aggregation value whenever each tuple is read.
  */
-static db_result_t aggregate(attribute_t *attr, attribute_value_t *value, tuple_id_t count)
+static db_result_t aggregate(attribute_t *attr, attribute_value_t *value)
 {
 	long long_value;
-	double sum_value;
 
 	switch (value->domain) {
 	case DOMAIN_INT:
@@ -600,21 +627,14 @@ static db_result_t aggregate(attribute_t *attr, attribute_value_t *value, tuple_
 		return DB_TYPE_ERROR;
 	}
 
-	sum_value = 0;
 	switch (attr->aggregator) {
 	case AQL_COUNT:
 		attr->aggregation_value++;
 		break;
 	case AQL_SUM:
-		attr->aggregation_value += (double)long_value;
-		break;
 	case AQL_MEAN:
-		if (count == 1) {
-			attr->aggregation_value = (double)long_value;
-		} else {
-			sum_value = (double) (attr->aggregation_value * (count - 1));
-			attr->aggregation_value = (double) ((sum_value + long_value) / count);
-		}
+		/* The mean is the sum divided by the count when the result is generated */
+		attr->aggregation_value += (double)long_value;
 		break;
 	case AQL_MAX:
 		if (long_value > attr->aggregation_value) {
@@ -686,21 +706,38 @@ static void select_index(db_handle_t **handle)
 	operand_value_t max;
 	attribute_value_t av_min;
 	attribute_value_t av_max;
-	long range;
+	const char *string;
+	unsigned long range;
 	unsigned long min_range;
 	index = NULL;
 	min_range = ULONG_MAX;
 
 	/* Find all indexed and derived attributes, and select the index of
-	   the attribute with the smallest range. */
+	   the attribute with the smallest range. Equality is searched with an
+	   index which only looks up keys, e.g. a hash index, if there is one. */
 	attr = list_head((*handle)->rel->attributes);
 	while (attr != NULL) {
-		if (attr->index != NULL && !LVM_ERROR(lvm_get_derived_range((*handle)->lvm_instance, attr->name, &min, &max))) {
+		if (attr->index == NULL) {
+			attr = attr->next;
+			continue;
+		}
+		if (attr->domain == DOMAIN_STRING) {
+			if (!LVM_ERROR(lvm_get_derived_string((*handle)->lvm_instance, attr->name, &string))) {
+				DB_LOG_D("DB: The search for attribute \"%s\" is an equality\n", attr->name);
+				if (min_range > 0 || !(((index_t *)attr->index)->api->flags & INDEX_API_RANGE_QUERIES)) {
+					min_range = 0;
+					index = attr->index;
+					av_min.domain = av_max.domain = DOMAIN_STRING;
+					VALUE_STRING(&av_min) = VALUE_STRING(&av_max) = (unsigned char *)string;
+				}
+			}
+		} else if (!LVM_ERROR(lvm_get_derived_range((*handle)->lvm_instance, attr->name, &min, &max))) {
 			range = (unsigned long)max.l - (unsigned long)min.l;
-			DB_LOG_D("DB: The search range for attribute \"%s\" comprises %ld values\n", attr->name, range + 1);
-			if (range <= min_range) {
+			DB_LOG_D("DB: The search range for attribute \"%s\" comprises %lu values\n", attr->name, range + 1);
+			if (index == NULL || range < min_range || (range == 0 && !(((index_t *)attr->index)->api->flags & INDEX_API_RANGE_QUERIES))) {
+				min_range = range;
 				index = attr->index;
-				av_min.domain = av_max.domain = DOMAIN_INT;
+				av_min.domain = av_max.domain = DOMAIN_LONG;
 				VALUE_LONG(&av_min) = min.l;
 				VALUE_LONG(&av_max) = max.l;
 			}
@@ -718,27 +755,118 @@ static void select_index(db_handle_t **handle)
 	}
 }
 
-static void relation_index_clear(relation_t *rel)
+/*
+ * Aggregates are answered by the indexes alone, without reading tuples, if
+ * the condition is a range of one indexed attribute and each aggregate is
+ * a COUNT, or the MIN or MAX of an attribute whose index finds the smallest
+ * and largest keys in a range.
+ */
+static void select_index_aggregate(db_handle_t **handle)
 {
-	char *filename;
-	attribute_t *attr_ptr;
-	int len;
+	source_dest_map_t *attr_map_ptr;
+	source_dest_map_t *attr_map_end;
+	attribute_t *range_attr;
+	index_t *index;
+	operand_value_t min;
+	operand_value_t max;
 
-	len = strlen(rel->name) + strlen(INDEX_NAME_SUFFIX) + 1;
-	filename = (char *)malloc(sizeof(char) * len);
-	if (filename == NULL) {
-		return;
-	}
-	snprintf(filename, len, "%s%s\0", rel->name, INDEX_NAME_SUFFIX);
-	storage_remove(filename);
-	attr_ptr = list_head(rel->attributes);
-	while (attr_ptr != NULL) {
-		if (attr_ptr->index != NULL) {
-			attr_ptr->index = NULL;
+	range_attr = NULL;
+	if ((*handle)->lvm_instance != NULL) {
+		if (!((*handle)->flags & DB_HANDLE_FLAG_SEARCH_INDEX)) {
+			return;
+		}
+		range_attr = (*handle)->index_iterator.index->attr;
+		if (range_attr->domain == DOMAIN_STRING || LVM_ERROR(lvm_get_exact_range((*handle)->lvm_instance, range_attr->name, &min, &max))) {
+			return;
 		}
-		attr_ptr = attr_ptr->next;
 	}
-	free(filename);
+
+	attr_map_end = (*handle)->attr_map + (*handle)->result_rel->attribute_count;
+	for (attr_map_ptr = (*handle)->attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
+		switch (attr_map_ptr->to_attr->aggregator) {
+		case AQL_COUNT:
+			break;
+		case AQL_MIN:
+		case AQL_MAX:
+			index = attr_map_ptr->from_attr->index;
+			if (index == NULL || index->api->get_edge == NULL) {
+				return;
+			}
+			if (range_attr != NULL && attr_map_ptr->from_attr != range_attr) {
+				return;
+			}
+			break;
+		default:
+			return;
+		}
+	}
+
+	DB_LOG_D("DB: The aggregates are answered by the indexes\n");
+	(*handle)->flags |= DB_HANDLE_FLAG_INDEX_AGGREGATE;
+}
+
+/* Count the tuples of the result by the index iterator, or by the
+   cardinality of the relation if there is no condition. */
+static tuple_id_t index_aggregate_count(db_handle_t **handle)
+{
+	tuple_id_t count;
+
+	if (!((*handle)->flags & DB_HANDLE_FLAG_SEARCH_INDEX)) {
+		return relation_cardinality((*handle)->rel);
+	}
+
+	count = 0;
+	while (index_get_next(&((*handle)->index_iterator), TRUE) != INVALID_TUPLE) {
+		count++;
+	}
+	return count;
+}
+
+static db_result_t index_aggregate(db_handle_t **handle)
+{
+	source_dest_map_t *attr_map_ptr;
+	source_dest_map_t *attr_map_end;
+	attribute_t *result_attr;
+	db_result_t result;
+	tuple_id_t count;
+	long min;
+	long max;
+	long key;
+
+	if ((*handle)->flags & DB_HANDLE_FLAG_SEARCH_INDEX) {
+		min = db_value_to_long(&((*handle)->index_iterator.min_value));
+		max = db_value_to_long(&((*handle)->index_iterator.max_value));
+	} else {
+		min = DB_LONG_MIN;
+		max = DB_LONG_MAX;
+	}
+
+	count = INVALID_TUPLE;
+	attr_map_end = (*handle)->attr_map + (*handle)->result_rel->attribute_count;
+	for (attr_map_ptr = (*handle)->attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
+		result_attr = attr_map_ptr->to_attr;
+		if (result_attr->aggregator == AQL_COUNT) {
+			if (count == INVALID_TUPLE) {
+				count = index_aggregate_count(handle);
+				if (count == INVALID_TUPLE) {
+					return DB_STORAGE_ERROR;
+				}
+			}
+			result_attr->aggregation_value = (double)count;
+			continue;
+		}
+
+		/* MIN or MAX; an empty range keeps the initial value as a scan does */
+		result = index_get_edge(attr_map_ptr->from_attr->index, min, max, result_attr->aggregator == AQL_MAX, &key);
+		if (DB_ERROR(result)) {
+			return result;
+		}
+		if (result == DB_OK) {
+			result_attr->aggregation_value = (double)key;
+		}
+	}
+
+	return DB_OK;
 }
 
 static void relation_delete_index_item(db_handle_t **handle, unsigned char *row_ptr, int update_index)
@@ -802,6 +930,10 @@ static db_result_t generate_selection_result(db_handle_t **handle, relation_t *r
 		}
 	}
 
+	if ((*handle)->adt_flags & AQL_FLAG_AGGREGATE) {
+		select_index_aggregate(handle);
+	}
+
 	(*handle)->tuple = (tuple_t)malloc(sizeof(char) * result_rel->row_length + 1);
 	if ((*handle)->tuple == NULL) {
 		DB_LOG_E("DB: Failed to malloc tuple row\n");
@@ -849,7 +981,6 @@ db_result_t relation_process_select(db_handle_t **handle, db_cursor_t *cursor)
 	source_dest_map_t *attr_map_ptr, *attr_map_end;
 	attribute_t *result_attr, *from_attr;
 	unsigned char *from_ptr, *to_ptr;
-	char aggr_buf[8];
 	attribute_value_t value;
 	storage_row_t row = NULL;
 	tuple_t result_row;
@@ -865,6 +996,15 @@ db_result_t relation_process_select(db_handle_t **handle, db_cursor_t *cursor)
 	attribute_count = (*handle)->result_rel->attribute_count;
 	attr_map_end = (*handle)->attr_map + attribute_count;
 
+	if ((*handle)->flags & DB_HANDLE_FLAG_INDEX_AGGREGATE) {
+		result = index_aggregate(handle);
+		if (DB_ERROR(result)) {
+			return result;
+		}
+		result = DB_FINISHED;
+		goto processing_aggregation;
+	}
+
 	if ((*handle)->flags & DB_HANDLE_FLAG_SEARCH_INDEX) {
 		(*handle)->tuple_id = index_get_next(&((*handle)->index_iterator), TRUE);
 		if ((*handle)->tuple_id == INVALID_TUPLE) {
@@ -880,6 +1020,18 @@ db_result_t relation_process_select(db_handle_t **handle, db_cursor_t *cursor)
 		}
 	} else {
 		(*handle)->tuple_id++;
+		if ((*handle)->tuple_id == 0) {
+			/* A full scan starts, let the page cache read the tuple file ahead */
+			storage_cache_hint_sequential((*handle)->rel->tuple_filename, (*handle)->rel->row_length, 0);
+		}
+		/* Rows inserted after the query started aren't part of the result */
+		if ((*handle)->tuple_id >= cursor->total_rows) {
+			if ((*handle)->adt_flags & AQL_FLAG_AGGREGATE) {
+				result = DB_FINISHED;
+				goto processing_aggregation;
+			}
+			return DB_FINISHED;
+		}
 	}
 
 	row = (storage_row_t)malloc(sizeof(char) * (*handle)->rel->row_length + 1);
@@ -909,7 +1061,7 @@ db_result_t relation_process_select(db_handle_t **handle, db_cursor_t *cursor)
 		from_ptr = row + attr_map_ptr->from_offset;
 		from_attr = attr_map_ptr->from_attr;
 
-		if (from_attr->domain == DOMAIN_INT || from_attr->domain == DOMAIN_LONG) {
+		if ((*handle)->lvm_instance != NULL && (from_attr->domain == DOMAIN_INT || from_attr->domain == DOMAIN_LONG || from_attr->domain == DOMAIN_STRING)) {
 			lvm_set_operand_value((*handle)->lvm_instance, from_attr, from_ptr);
 		}
 
@@ -937,16 +1089,26 @@ db_result_t relation_process_select(db_handle_t **handle, db_cursor_t *cursor)
 					goto errout;
 				}
 
-				result = aggregate(attr_map_ptr->to_attr, &value, (*handle)->current_row);
+				result = aggregate(attr_map_ptr->to_attr, &value);
 				if (DB_ERROR(result)) {
 					goto errout;
 				}
 			}
 		} else {
+			if ((*handle)->adt_flags & AQL_FLAG_ASSIGN) {
+				/* Keep a copy of the result in the assigned relation */
+				result = storage_put_row((*handle)->result_rel, result_row, TRUE);
+				if (DB_ERROR(result)) {
+					DB_LOG_E("DB: Failed to store a row in the result relation!\n");
+					goto errout;
+				}
+			}
 			result = cursor_data_add(cursor, (*handle)->tuple_id);
 			if (DB_ERROR(result)) {
 				goto errout;
 			}
+			free(row);
+			return DB_GOT_ROW;
 		}
 	}
 
@@ -961,13 +1123,15 @@ processing_aggregation:
 		result_attr = attr_map_ptr->to_attr;
 		to_ptr = result_row + attr_map_ptr->to_offset;
 
-		snprintf(aggr_buf, sizeof(aggr_buf), "%f", result_attr->aggregation_value);
-		from_ptr = (unsigned char *)aggr_buf;
-		memcpy(to_ptr, from_ptr, sizeof(aggr_buf));
+		if (result_attr->aggregator == AQL_MEAN && (*handle)->current_row > 0) {
+			result_attr->aggregation_value /= (*handle)->current_row;
+		}
+		/* Stored as is, a text of sizeof(double) bytes would cut it short */
+		memcpy(to_ptr, &result_attr->aggregation_value, sizeof(double));
 	}
 
 	/* Copy aggregated result to tuple in cursor */
-	memcpy(cursor->tuple, result_row, sizeof(cursor->tuple));
+	memcpy(cursor->tuple, result_row, (*handle)->result_rel->row_length);
 
 	(*handle)->current_row = 0;
 	(*handle)->adt_flags &= ~AQL_FLAG_AGGREGATE; /* Stop the aggregation. */
@@ -1014,6 +1178,9 @@ db_result_t relation_process_remove(db_handle_t **handle, db_cursor_t *cursor)
 
 	/* Search all tuples sequentially without index. */
 	(*handle)->tuple_id++;
+	if ((*handle)->tuple_id == 0) {
+		storage_cache_hint_sequential((*handle)->rel->tuple_filename, (*handle)->rel->row_length, 0);
+	}
 
 	row = (storage_row_t)malloc(sizeof(char) * (*handle)->rel->row_length + 1);
 	if (row == NULL) {
@@ -1036,7 +1203,7 @@ db_result_t relation_process_remove(db_handle_t **handle, db_cursor_t *cursor)
 		from_ptr = row + attr_map_ptr->from_offset;
 		from_attr = attr_map_ptr->from_attr;
 
-		if (from_attr->domain == DOMAIN_INT || from_attr->domain == DOMAIN_LONG) {
+		if (from_attr->domain == DOMAIN_INT || from_attr->domain == DOMAIN_LONG || from_attr->domain == DOMAIN_STRING) {
 			lvm_set_operand_value((*handle)->lvm_instance, from_attr, from_ptr);
 		}
 
@@ -1108,9 +1275,10 @@ end_removal:
 	return DB_FINISHED;
 
 errout:
-#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
-	storage_write_buffer_clean();
-#endif
+	/* Drop the rows of the unfinished result relation */
+	if ((*handle)->result_rel != NULL) {
+		storage_cache_invalidate((*handle)->result_rel->tuple_filename);
+	}
 
 	if (row != NULL) {
 		free(row);
@@ -1139,6 +1307,15 @@ db_cursor_t *relation_process_result(db_handle_t *handler)
 			cursor_deinit(cursor);
 			return NULL;
 		}
+
+		/* Tuples of a plain sequential scan are processed when the cursor
+		   moves to them. Aggregates, index searches, which return tuples
+		   out of storage order, and results assigned to a relation are
+		   processed at once. */
+		if (!(handler->adt_flags & (AQL_FLAG_ASSIGN | AQL_FLAG_AGGREGATE)) && !(handler->flags & DB_HANDLE_FLAG_SEARCH_INDEX)) {
+			cursor->handle = handler;
+			return cursor;
+		}
 	}
 
 	res = DB_ARGUMENT_ERROR;
@@ -1184,18 +1361,18 @@ db_result_t relation_select(db_handle_t **handle, relation_t *rel, void *adt_ptr
 	(*handle)->lvm_instance = (lvm_instance_t *)adt->lvm_instance;
 
 	if (AQL_GET_FLAGS(adt) & AQL_FLAG_ASSIGN) {
+		/* The result is stored in the given relation */
 		name = adt->relations[0];
 		dir = DB_STORAGE;
+		res_rel = relation_load(name);
+		relation_remove(res_rel, 1);
+		relation_create(name, dir);
+		(*handle)->result_rel = relation_load(name);
 	} else {
-		name = RESULT_RELATION;
 		dir = DB_MEMORY;
+		(*handle)->result_rel = relation_create_result();
 	}
 
-	res_rel = relation_load(name);
-	relation_remove(res_rel, 1);
-	relation_create(name, dir);
-	(*handle)->result_rel = relation_load(name);
-
 	if ((*handle)->result_rel == NULL) {
 		DB_LOG_E("DB: Failed to load a relation for the query result\n");
 		return DB_ALLOCATION_ERROR;
@@ -1207,6 +1384,7 @@ db_result_t relation_select(db_handle_t **handle, relation_t *rel, void *adt_ptr
 			if (attr_ptr->flags & ATTRIBUTE_FLAG_INVALID) {
 				DB_LOG_E("DB: Failed to add a result attribute\n");
 				relation_release((*handle)->result_rel);
+				(*handle)->result_rel = NULL;
 				return DB_ALLOCATION_ERROR;
 			} else {
 				index_load(rel, attr_ptr);
@@ -1216,6 +1394,7 @@ db_result_t relation_select(db_handle_t **handle, relation_t *rel, void *adt_ptr
 			if (attr == NULL) {
 				DB_LOG_E("DB: Failed to add a result attribute\n");
 				relation_release((*handle)->result_rel);
+				(*handle)->result_rel = NULL;
 				return DB_ALLOCATION_ERROR;
 			}
 			attr_ptr = attr_ptr->next;
@@ -1239,6 +1418,7 @@ db_result_t relation_select(db_handle_t **handle, relation_t *rel, void *adt_ptr
 			if (attr == NULL) {
 				DB_LOG_E("DB: Failed to add a result attribute\n");
 				relation_release((*handle)->result_rel);
+				(*handle)->result_rel = NULL;
 				return DB_ALLOCATION_ERROR;
 			}
 			attr->aggregator = adt->aggregators[i];
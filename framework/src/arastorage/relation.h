@@ -69,27 +69,6 @@
 * Pre-processor Definitions
 ****************************************************************************/
 
-/* This decides index in int array */
-#define GET_INDEX(a) ((a) / (sizeof(uint32_t) * 8))
-
-/* This decides index in a int value of array */
-#define GET_POS(a) ((a) % (sizeof(uint32_t) * 8))
-
-/* This decides int array size to present all tuples in relation */
-#define GET_CURSOR_DATA_ARR_SIZE(a) (((a) / (sizeof(uint32_t) * 8)) + 1)
-
-/* Set a bit to 1 */
-#define BIT_SET(a, b) ((a) |= (1u << (b)))
-
-/* Clear a bit to 0 */
-#define BIT_CLEAR(a, b) ((a) &= ~(1u << (b)))
-
-/* Reverse a bit */
-#define BIT_FLIP(a, b) ((a) ^= (1u << (b)))
-
-/* Check a bit whether 1 or 0 */
-#define BIT_CHECK(a, b) ((a) & (1u << (b)))
-
 /* Check cursor is empty or not */
 #define IS_EMPTY_CURSOR(a) ((a) == NULL || (a)->total_rows <= 0 || (a)->cursor_rows <= 0)
 
@@ -97,7 +76,7 @@
 #define IS_INVALID_CURSOR_ROW(a) ((a) == NULL || ((a)->current_cursor_row >= (a)->cursor_rows))
 
 /* check current storage row is valid or invalid*/
-#define IS_INVALID_STORAGE_ROW(a) ((a) == NULL || ((a)->current_storage_row >= (a)->total_rows) || (a)->current_storage_row >= DB_CURSOR_RESULT_ENTRY)
+#define IS_INVALID_STORAGE_ROW(a) ((a) == NULL || ((a)->current_storage_row >= (a)->total_rows))
 
 #define RELATION_HAS_TUPLES(rel) ((rel)->tuple_storage >= 0)
 
@@ -150,6 +129,13 @@ struct cursor_data_map_s {
 };
 typedef struct cursor_data_map_s cursor_data_map_t;
 
+/* Consecutive tuple ids in the result of a cursor */
+struct cursor_range_s {
+	tuple_id_t start;
+	tuple_id_t count;
+};
+typedef struct cursor_range_s cursor_range_t;
+
 /* A structure for cursor in SELECT operation */
 struct _db_cursor_s {
 	tuple_id_t current_cursor_row;
@@ -158,7 +144,12 @@ struct _db_cursor_s {
 	tuple_id_t total_rows;
 	attribute_id_t attribute_count;
 	size_t storage_row_length;
-	uint32_t *row_arr;
+	cursor_range_t *ranges;		/* tuple ids of the rows in ascending order */
+	uint32_t range_count;
+	uint32_t range_size;		/* number of ranges allocated */
+	uint32_t current_range;		/* range of current_storage_row */
+	tuple_id_t range_first_row;	/* cursor row of the first tuple in current_range */
+	db_handle_t *handle;		/* query producing the rows, NULL when all rows are known */
 	unsigned char tuple[DB_MAX_ELEMENT_SIZE + 1];
 	char name[TUPLE_NAME_LENGTH + 1];
 	char rel_name[RELATION_NAME_LENGTH + 1];
@@ -178,6 +169,7 @@ db_result_t cursor_deinit(db_cursor_t *cursor);
 /* API for relations. */
 db_result_t relation_init(void);
 db_result_t relation_deinit(void);
+db_result_t relation_process(db_handle_t **, db_cursor_t *);
 db_result_t relation_process_remove(db_handle_t **, db_cursor_t *);
 db_result_t relation_process_select(db_handle_t **, db_cursor_t *);
 db_cursor_t *relation_process_result(db_handle_t *);
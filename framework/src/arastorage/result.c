@@ -125,7 +125,7 @@ db_result_t db_phy_to_value(attribute_value_t *value, attribute_t *attr, unsigne
 		DB_LOG_V("DB: %s = %ld\n", attr->name, long_value);
 		break;
 	case DOMAIN_DOUBLE:
-		double_value = atof((char *)ptr);
+		memcpy(&double_value, ptr, sizeof(double_value));
 		VALUE_DOUBLE(value) = double_value;
 		DB_LOG_V("DB: %s = %.5f\n", attr->name, double_value);
 		break;
@@ -145,7 +145,7 @@ db_result_t db_value_to_phy(unsigned char *ptr, attribute_t *attr, attribute_val
 
 	switch (attr->domain) {
 	case DOMAIN_STRING:
-		memcpy(ptr, VALUE_STRING(value), attr->element_size);
+		strncpy((char *)ptr, (char *)VALUE_STRING(value), attr->element_size);
 		ptr[attr->element_size - 1] = '\0';
 		break;
 	case DOMAIN_INT:
@@ -71,6 +71,7 @@
 #define DB_HANDLE_FLAG_INDEX_STEP       0x01
 #define DB_HANDLE_FLAG_SEARCH_INDEX     0x02
 #define DB_HANDLE_FLAG_PROCESSING       0x04
+#define DB_HANDLE_FLAG_INDEX_AGGREGATE  0x08
 #define DB_HANDLE_FLAG_INVALID          0x00
 
 /****************************************************************************
@@ -115,6 +116,8 @@ struct _db_handle_s {
 db_result_t db_get_value(attribute_value_t *value, db_handle_t *handle, unsigned col);
 db_result_t db_phy_to_value(attribute_value_t *value, attribute_t *attr, unsigned char *ptr);
 db_result_t db_value_to_phy(unsigned char *ptr, attribute_t *attr, attribute_value_t *value);
+db_result_t cursor_get_value_storage(attribute_value_t *value, db_cursor_t *cursor, unsigned col);
+db_result_t cursor_data_set(db_cursor_t *cursor, source_dest_map_t *attr_map, attribute_id_t attribute_count);
 
 #endif              /* !RESULT_H */
 long db_value_to_long(attribute_value_t *value);
@@ -57,7 +57,7 @@ void rw_unlock_read(struct rw_lock_s *rwLock)
 	// The last reader will signal that there are no readers,
 	// allowing any waiting writers to proceed
 	if (rwLock->readers == 0) {
-		pthread_cond_signal(&rwLock->noReaders);
+		pthread_cond_broadcast(&rwLock->noReaders);
 	}
 	pthread_mutex_unlock(&rwLock->mutex);
 }
@@ -100,13 +100,13 @@ void rw_unlock_write(struct rw_lock_s *rwLock)
 	rwLock->writerActive = false;
 	rwLock->writers--;
 	// If there are other writers waiting, let the next one take a turn.
-	// Otherwise, signal that there are no more writers, allowing any waiting readers
+	// Otherwise, signal that there are no more writers, allowing all waiting readers
 	// to proceed.
 	if (rwLock->writers > 0) {
 		pthread_cond_signal(&rwLock->noActiveWriter);
 	} else {					/* rwLock->writers == 0 */
 
-		pthread_cond_signal(&rwLock->noWriters);
+		pthread_cond_broadcast(&rwLock->noWriters);
 	}
 	pthread_mutex_unlock(&rwLock->mutex);
 }
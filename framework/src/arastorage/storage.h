@@ -65,18 +65,18 @@
 /****************************************************************************
 * Public Type Definitions
 ****************************************************************************/
-#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
-struct insert_buffer_s {
-	char file_name[DB_MAX_FILENAME_LENGTH];	/* name of tuple file */
-	unsigned char *buffer;		/* write buffer */
-	int data_size;				/* size of data in buffer */
-};
-
-struct insert_buffer_s g_storage_write_buffer;
-#endif
-
 typedef unsigned char *storage_row_t;
 
+/* Counters of the page cache for tuple files */
+struct storage_cache_stats_s {
+	uint32_t hits;				/* rows found in a cached page */
+	uint32_t misses;			/* page loads */
+	uint32_t reads;				/* read calls on tuple files */
+	uint32_t read_bytes;
+	uint32_t writes;			/* write calls on tuple files */
+	uint32_t write_bytes;
+};
+
 /****************************************************************************
 * Global Function Prototypes
 ****************************************************************************/
@@ -102,12 +102,16 @@ db_result_t storage_get_row_amount(relation_t *, tuple_id_t *);
 db_result_t storage_read_from(db_storage_id_t, void *, unsigned long, unsigned);
 db_result_t storage_write_to(db_storage_id_t, void *, unsigned long, unsigned);
 
-#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
-db_result_t storage_write_buffer_init(void);
-void storage_write_buffer_deinit(void);
-db_result_t storage_flush_insert_buffer(void);
-void storage_write_buffer_clean(void);
-#endif
+db_result_t storage_cache_init(void);
+void storage_cache_deinit(void);
+db_result_t storage_cache_read(char *, db_storage_id_t, unsigned, tuple_id_t, unsigned, unsigned, void *);
+db_result_t storage_cache_append(char *, db_storage_id_t, unsigned, storage_row_t);
+db_result_t storage_cache_row_amount(char *, db_storage_id_t, unsigned, tuple_id_t *);
+db_result_t storage_cache_write(char *, db_storage_id_t, unsigned long, void *, unsigned);
+void storage_cache_hint_sequential(char *, unsigned, tuple_id_t);
+db_result_t storage_cache_flush(void);
+void storage_cache_invalidate(char *);
+void storage_cache_get_stats(struct storage_cache_stats_s *, bool);
 
 db_storage_id_t storage_open(const char *, int);
 db_storage_id_t storage_close(db_storage_id_t);
@@ -116,8 +120,7 @@ db_result_t storage_rename(const char *, const char *);
 off_t storage_seek(db_storage_id_t, unsigned long, int);
 ssize_t storage_read(db_storage_id_t, void *, unsigned);
 ssize_t storage_write(db_storage_id_t, void *, unsigned);
-#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
+db_result_t storage_sync(db_storage_id_t);
 ssize_t storage_get_availbyte_size(void);
-#endif
 
 #endif							/* STORAGE_H */
@@ -23,9 +23,7 @@
 #include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
-#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
 #include <sys/stat.h>
-#endif
 #include "db_debug.h"
 #include "storage.h"
 
@@ -43,11 +41,15 @@ db_storage_id_t storage_open(const char *filename, int oflag)
 {
 	db_storage_id_t fd;
 	char *rel_path;
-	rel_path = (char *)malloc(sizeof(char) * (strlen(CONFIG_MOUNT_POINT) + strlen(filename) + 1));
+	size_t len;
+
+	/* The whole path, a name truncated with the mount point could open another file */
+	len = strlen(CONFIG_MOUNT_POINT) + strlen(filename) + 1;
+	rel_path = (char *)malloc(sizeof(char) * len);
 	if (rel_path == NULL) {
 		return INVALID_STORAGE_ID;
 	}
-	snprintf(rel_path, DB_MAX_FILENAME_LENGTH, "%s%s\0", CONFIG_MOUNT_POINT, filename);
+	snprintf(rel_path, len, "%s%s", CONFIG_MOUNT_POINT, filename);
 	fd = open(rel_path, oflag);
 	free(rel_path);
 	return fd;
@@ -64,11 +66,14 @@ db_result_t storage_remove(const char *filename)
 {
 	char *rel_path;
 	int res = DB_STORAGE_ERROR;
-	rel_path = (char *)malloc(sizeof(char) * (strlen(CONFIG_MOUNT_POINT) + strlen(filename) + 1));
+	size_t len;
+
+	len = strlen(CONFIG_MOUNT_POINT) + strlen(filename) + 1;
+	rel_path = (char *)malloc(sizeof(char) * len);
 	if (rel_path == NULL) {
 		return DB_STORAGE_ERROR;
 	}
-	snprintf(rel_path, DB_MAX_FILENAME_LENGTH, "%s%s\0", CONFIG_MOUNT_POINT, filename);
+	snprintf(rel_path, len, "%s%s", CONFIG_MOUNT_POINT, filename);
 	if (unlink(rel_path) == OK) {
 		res = DB_OK;
 	}
@@ -82,19 +87,24 @@ db_result_t storage_rename(const char *old_name, const char *new_name)
 	char *old_path;
 	char *new_path;
 	int res = DB_STORAGE_ERROR;
-	old_path = (char *)malloc(sizeof(char) * (strlen(CONFIG_MOUNT_POINT) + strlen(old_name) + 1));
+	size_t old_len;
+	size_t new_len;
+
+	old_len = strlen(CONFIG_MOUNT_POINT) + strlen(old_name) + 1;
+	old_path = (char *)malloc(sizeof(char) * old_len);
 	if (old_path == NULL) {
 		return DB_STORAGE_ERROR;
 	}
 
-	new_path = (char *)malloc(sizeof(char) * (strlen(CONFIG_MOUNT_POINT) + strlen(new_name) + 1));
+	new_len = strlen(CONFIG_MOUNT_POINT) + strlen(new_name) + 1;
+	new_path = (char *)malloc(sizeof(char) * new_len);
 	if (new_path == NULL) {
 		free(old_path);
 		return DB_STORAGE_ERROR;
 	}
 
-	snprintf(old_path, DB_MAX_FILENAME_LENGTH, "%s%s\0", CONFIG_MOUNT_POINT, old_name);
-	snprintf(new_path, DB_MAX_FILENAME_LENGTH, "%s%s\0", CONFIG_MOUNT_POINT, new_name);
+	snprintf(old_path, old_len, "%s%s", CONFIG_MOUNT_POINT, old_name);
+	snprintf(new_path, new_len, "%s%s", CONFIG_MOUNT_POINT, new_name);
 
 	if (rename(old_path, new_path) == OK) {
 		res = DB_OK;
@@ -104,6 +114,15 @@ db_result_t storage_rename(const char *old_name, const char *new_name)
 	return res;
 }
 
+/* It mapped with fsync function in specific file system */
+db_result_t storage_sync(db_storage_id_t fd)
+{
+	if (fsync(fd) != OK) {
+		return DB_STORAGE_ERROR;
+	}
+	return DB_OK;
+}
+
 /* It mapped with seek function in specific file system */
 off_t storage_seek(db_storage_id_t fd, unsigned long offset, int whence)
 {
@@ -122,7 +141,7 @@ ssize_t storage_write(db_storage_id_t fd, void *buffer, unsigned length)
 	return write(fd, buffer, length);
 }
 
-#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
+/* Block size of the file system, used as the page size of the tuple cache */
 ssize_t storage_get_availbyte_size(void)
 {
 	struct stat st;
@@ -131,4 +150,3 @@ ssize_t storage_get_availbyte_size(void)
 	}
 	return st.st_blksize;
 }
-#endif
@@ -0,0 +1,620 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/**
+ * \file
+ *      Page cache for tuple files.
+ *
+ *      Tuple files are append-only: rows are only added at the end, and a
+ *      file is only ever truncated by re-creating it. Every page therefore
+ *      holds a run of rows which never changes once it is in the file, and
+ *      the only page of a file which can still grow is its last one.
+ *
+ *      Appended rows are kept in the last page of the file and written out
+ *      when the page fills up, when the page is evicted, or on
+ *      storage_cache_flush(). This replaces the former single insert buffer.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "db_options.h"
+#include "db_debug.h"
+#include "storage.h"
+
+/****************************************************************************
+* Pre-processor Definitions
+****************************************************************************/
+#ifndef CONFIG_ARASTORAGE_PAGE_CACHE_PAGES
+#define CONFIG_ARASTORAGE_PAGE_CACHE_PAGES 4
+#endif
+
+#ifndef CONFIG_ARASTORAGE_PAGE_CACHE_READAHEAD
+#define CONFIG_ARASTORAGE_PAGE_CACHE_READAHEAD 2
+#endif
+
+#define STORAGE_CACHE_PAGES CONFIG_ARASTORAGE_PAGE_CACHE_PAGES
+
+/* Page size used when the file system doesn't report its block size */
+#define STORAGE_PAGE_SIZE_DEFAULT 512
+
+#define PAGE_IS_FREE(page) ((page)->file_name[0] == '\0')
+#define PAGE_IS_DIRTY(page) ((page)->flushed_rows < (page)->nrows)
+
+/****************************************************************************
+* Private Types
+****************************************************************************/
+struct storage_page_s {
+	char file_name[TUPLE_NAME_LENGTH + 1];	/* tuple file, empty if the page is free */
+	unsigned row_length;
+	tuple_id_t first_row;		/* first row of the page, a multiple of rows per page */
+	uint16_t nrows;				/* valid rows in the page */
+	uint16_t flushed_rows;		/* rows already stored in the file */
+	uint8_t ref;				/* referenced since the clock hand passed */
+	unsigned char *data;
+};
+
+struct storage_cache_s {
+	pthread_mutex_t lock;
+	struct storage_page_s pages[STORAGE_CACHE_PAGES];
+	unsigned char *frames;		/* data of all pages, page_size bytes each */
+	unsigned page_size;
+	int hand;					/* clock hand for eviction */
+
+	/* The page expected next from a sequential scan */
+	char seq_file[TUPLE_NAME_LENGTH + 1];
+	tuple_id_t seq_page;
+
+	struct storage_cache_stats_s stats;
+};
+
+/****************************************************************************
+* Private Variables
+****************************************************************************/
+static struct storage_cache_s g_storage_cache;
+
+/****************************************************************************
+* Private Functions
+****************************************************************************/
+static unsigned cache_rows_per_page(unsigned row_length)
+{
+	return g_storage_cache.page_size / row_length;
+}
+
+static void cache_page_release(struct storage_page_s *page)
+{
+	page->file_name[0] = '\0';
+	page->nrows = 0;
+	page->flushed_rows = 0;
+	page->ref = 0;
+}
+
+static struct storage_page_s *cache_find(const char *file_name, tuple_id_t first_row)
+{
+	int i;
+	struct storage_page_s *page;
+
+	for (i = 0; i < STORAGE_CACHE_PAGES; i++) {
+		page = &g_storage_cache.pages[i];
+		if (!PAGE_IS_FREE(page) && page->first_row == first_row && strncmp(page->file_name, file_name, TUPLE_NAME_LENGTH) == 0) {
+			return page;
+		}
+	}
+	return NULL;
+}
+
+static ssize_t cache_read_file(const char *file_name, db_storage_id_t fd, void *buffer, unsigned long offset, unsigned length)
+{
+	ssize_t r;
+	ssize_t total;
+	db_storage_id_t own_fd = INVALID_STORAGE_ID;
+
+	if (fd < 0) {
+		own_fd = fd = storage_open(file_name, O_RDONLY);
+		if (fd < 0) {
+			DB_LOG_E("DB: Failed to open %s\n", file_name);
+			return -1;
+		}
+	}
+
+	total = -1;
+	if (storage_seek(fd, offset, SEEK_SET) != (off_t)-1) {
+		for (total = 0; total < length; total += r) {
+			r = storage_read(fd, (unsigned char *)buffer + total, length - total);
+			g_storage_cache.stats.reads++;
+			if (r < 0) {
+				total = -1;
+				break;
+			} else if (r == 0) {
+				break;
+			}
+		}
+	}
+
+	if (total > 0) {
+		g_storage_cache.stats.read_bytes += total;
+	}
+	if (own_fd >= 0) {
+		storage_close(own_fd);
+	}
+	return total;
+}
+
+/* Append the rows of the page which aren't in the file yet. */
+static db_result_t cache_flush_page(struct storage_page_s *page, db_storage_id_t fd)
+{
+	ssize_t r;
+	unsigned length;
+	db_storage_id_t own_fd = INVALID_STORAGE_ID;
+
+	if (!PAGE_IS_DIRTY(page)) {
+		return DB_OK;
+	}
+
+	if (fd < 0) {
+		own_fd = fd = storage_open(page->file_name, O_APPEND | O_RDWR);
+		if (fd < 0) {
+			DB_LOG_E("DB: Failed to open %s\n", page->file_name);
+			return DB_STORAGE_ERROR;
+		}
+	}
+
+	/* The file may be opened without O_APPEND, so write at the end of the stored rows */
+	length = (page->nrows - page->flushed_rows) * page->row_length;
+	r = -1;
+	if (storage_seek(fd, (unsigned long)(page->first_row + page->flushed_rows) * page->row_length, SEEK_SET) != (off_t)-1) {
+		r = storage_write(fd, page->data + page->flushed_rows * page->row_length, length);
+	}
+	g_storage_cache.stats.writes++;
+	if (own_fd >= 0) {
+		storage_close(own_fd);
+	}
+	if (r != length) {
+		DB_LOG_E("DB: Failed to store %u bytes in %s\n", length, page->file_name);
+		return DB_STORAGE_ERROR;
+	}
+
+	g_storage_cache.stats.write_bytes += length;
+	page->flushed_rows = page->nrows;
+	DB_LOG_D("DB: Stored %u bytes in %s\n", length, page->file_name);
+	return DB_OK;
+}
+
+/*
+ * Pick n consecutive pages to be reused, writing out their rows if needed.
+ * A single page is chosen by the clock algorithm, a run for a read-ahead
+ * is simply taken at the clock hand as the pages of a scan are cold anyway.
+ */
+static struct storage_page_s *cache_evict(int n)
+{
+	int start;
+	int i;
+	struct storage_page_s *page;
+
+	if (n == 1) {
+		while (1) {
+			page = &g_storage_cache.pages[g_storage_cache.hand];
+			g_storage_cache.hand = (g_storage_cache.hand + 1) % STORAGE_CACHE_PAGES;
+			if (PAGE_IS_FREE(page) || !page->ref) {
+				break;
+			}
+			page->ref = 0;
+		}
+		start = page - g_storage_cache.pages;
+	} else {
+		start = g_storage_cache.hand;
+		if (start + n > STORAGE_CACHE_PAGES) {
+			start = 0;
+		}
+		g_storage_cache.hand = (start + n) % STORAGE_CACHE_PAGES;
+	}
+
+	for (i = start; i < start + n; i++) {
+		page = &g_storage_cache.pages[i];
+		if (!PAGE_IS_FREE(page)) {
+			if (DB_ERROR(cache_flush_page(page, INVALID_STORAGE_ID))) {
+				return NULL;
+			}
+			cache_page_release(page);
+		}
+	}
+
+	return &g_storage_cache.pages[start];
+}
+
+/*
+ * Read the page starting at first_row, together with the following pages
+ * when a sequential scan reached it. Returns NULL if the page has no rows.
+ */
+static struct storage_page_s *cache_load(const char *file_name, db_storage_id_t fd, unsigned row_length, tuple_id_t first_row)
+{
+	struct storage_page_s *run;
+	struct storage_page_s *page;
+	unsigned rpp;
+	unsigned page_bytes;
+	unsigned rows;
+	ssize_t r;
+	tuple_id_t page_no;
+	int n;
+	int i;
+
+	rpp = cache_rows_per_page(row_length);
+	page_bytes = rpp * row_length;
+	page_no = first_row / rpp;
+
+	n = 1;
+	if (page_no == g_storage_cache.seq_page && strncmp(g_storage_cache.seq_file, file_name, TUPLE_NAME_LENGTH) == 0) {
+		/* Leave at least half of the cache to other files */
+		n = CONFIG_ARASTORAGE_PAGE_CACHE_READAHEAD;
+		if (n > STORAGE_CACHE_PAGES / 2) {
+			n = STORAGE_CACHE_PAGES / 2;
+		}
+		/* Stop at a page which is already cached, the last page may hold unwritten rows */
+		for (i = 1; i < n; i++) {
+			if (cache_find(file_name, first_row + i * rpp) != NULL) {
+				break;
+			}
+		}
+		n = (i > 0) ? i : 1;
+	}
+
+	run = cache_evict(n);
+	if (run == NULL) {
+		return NULL;
+	}
+
+	g_storage_cache.stats.misses++;
+	r = cache_read_file(file_name, fd, run->data, (unsigned long)page_no * page_bytes, n * page_bytes);
+	if (r < 0) {
+		return NULL;
+	}
+
+	/* Rows were read back to back, move them to the start of each page. */
+	rows = r / row_length;
+	for (i = n - 1; i >= 0; i--) {
+		page = run + i;
+		if (rows <= i * rpp) {
+			continue;
+		}
+		if (i > 0) {
+			memmove(page->data, run->data + i * page_bytes, page_bytes);
+		}
+		strncpy(page->file_name, file_name, TUPLE_NAME_LENGTH);
+		page->file_name[TUPLE_NAME_LENGTH] = '\0';
+		page->row_length = row_length;
+		page->first_row = first_row + i * rpp;
+		page->nrows = (rows - i * rpp < rpp) ? rows - i * rpp : rpp;
+		page->flushed_rows = page->nrows;
+		/* Read-ahead pages haven't been used yet, they go first */
+		page->ref = 0;
+	}
+
+	strncpy(g_storage_cache.seq_file, file_name, TUPLE_NAME_LENGTH);
+	g_storage_cache.seq_page = page_no + n;
+
+	return PAGE_IS_FREE(run) ? NULL : run;
+}
+
+/* Find the last page of a file, which is the only one that can be partly filled. */
+static struct storage_page_s *cache_find_last(const char *file_name, unsigned rpp)
+{
+	int i;
+	struct storage_page_s *page;
+
+	for (i = 0; i < STORAGE_CACHE_PAGES; i++) {
+		page = &g_storage_cache.pages[i];
+		if (!PAGE_IS_FREE(page) && page->nrows < rpp && strncmp(page->file_name, file_name, TUPLE_NAME_LENGTH) == 0) {
+			return page;
+		}
+	}
+	return NULL;
+}
+
+/* Forget the cached pages of a file, called with the cache lock held. */
+static void cache_invalidate(const char *file_name)
+{
+	int i;
+	struct storage_page_s *page;
+
+	for (i = 0; i < STORAGE_CACHE_PAGES; i++) {
+		page = &g_storage_cache.pages[i];
+		if (!PAGE_IS_FREE(page) && strncmp(page->file_name, file_name, TUPLE_NAME_LENGTH) == 0) {
+			cache_page_release(page);
+		}
+	}
+	if (strncmp(g_storage_cache.seq_file, file_name, TUPLE_NAME_LENGTH) == 0) {
+		g_storage_cache.seq_file[0] = '\0';
+	}
+}
+
+/****************************************************************************
+* Public Functions
+****************************************************************************/
+db_result_t storage_cache_init(void)
+{
+	int i;
+	ssize_t size;
+
+	if (g_storage_cache.frames != NULL) {
+		return DB_OK;
+	}
+
+	/* One page per file system block, so that a page is read or written at once */
+	size = storage_get_availbyte_size();
+	if (size <= 0) {
+		size = STORAGE_PAGE_SIZE_DEFAULT;
+	}
+
+	g_storage_cache.frames = (unsigned char *)malloc(size * STORAGE_CACHE_PAGES);
+	if (g_storage_cache.frames == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+
+	pthread_mutex_init(&g_storage_cache.lock, NULL);
+	g_storage_cache.page_size = size;
+	g_storage_cache.hand = 0;
+	g_storage_cache.seq_file[0] = '\0';
+	memset(&g_storage_cache.stats, 0, sizeof(g_storage_cache.stats));
+	for (i = 0; i < STORAGE_CACHE_PAGES; i++) {
+		cache_page_release(&g_storage_cache.pages[i]);
+		g_storage_cache.pages[i].data = g_storage_cache.frames + i * size;
+	}
+
+	DB_LOG_D("DB: Page cache of %d pages, %d bytes each\n", STORAGE_CACHE_PAGES, size);
+	return DB_OK;
+}
+
+void storage_cache_deinit(void)
+{
+	if (g_storage_cache.frames == NULL) {
+		return;
+	}
+
+	storage_cache_flush();
+	DB_LOG_D("DB: Page cache hits %u misses %u, read %u times (%u bytes), written %u times (%u bytes)\n",
+		g_storage_cache.stats.hits, g_storage_cache.stats.misses, g_storage_cache.stats.reads,
+		g_storage_cache.stats.read_bytes, g_storage_cache.stats.writes, g_storage_cache.stats.write_bytes);
+
+	free(g_storage_cache.frames);
+	g_storage_cache.frames = NULL;
+	pthread_mutex_destroy(&g_storage_cache.lock);
+}
+
+db_result_t storage_cache_read(char *file_name, db_storage_id_t fd, unsigned row_length, tuple_id_t tuple_id, unsigned offset, unsigned length, void *buffer)
+{
+	struct storage_page_s *page;
+	unsigned rpp;
+	ssize_t r;
+	db_result_t result;
+
+	if (g_storage_cache.frames == NULL || offset + length > row_length) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	rpp = cache_rows_per_page(row_length);
+	pthread_mutex_lock(&g_storage_cache.lock);
+	if (rpp == 0) {
+		/* A row larger than a page isn't cached */
+		r = cache_read_file(file_name, fd, buffer, (unsigned long)tuple_id * row_length + offset, length);
+		pthread_mutex_unlock(&g_storage_cache.lock);
+		return (r < 0) ? DB_STORAGE_ERROR : ((r < length) ? DB_FINISHED : DB_OK);
+	}
+
+	page = cache_find(file_name, tuple_id - tuple_id % rpp);
+	if (page != NULL) {
+		g_storage_cache.stats.hits++;
+		page->ref = 1;
+	} else {
+		page = cache_load(file_name, fd, row_length, tuple_id - tuple_id % rpp);
+	}
+
+	if (page == NULL || tuple_id >= page->first_row + page->nrows) {
+		result = DB_FINISHED;
+	} else {
+		memcpy(buffer, page->data + (tuple_id - page->first_row) * row_length + offset, length);
+		result = DB_OK;
+	}
+
+	pthread_mutex_unlock(&g_storage_cache.lock);
+	return result;
+}
+
+db_result_t storage_cache_append(char *file_name, db_storage_id_t fd, unsigned row_length, storage_row_t row)
+{
+	struct storage_page_s *page;
+	unsigned rpp;
+	off_t offset;
+	tuple_id_t nrows;
+	db_result_t result;
+
+	if (g_storage_cache.frames == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	rpp = cache_rows_per_page(row_length);
+	pthread_mutex_lock(&g_storage_cache.lock);
+	if (rpp == 0) {
+		result = DB_OK;
+		if (storage_seek(fd, 0, SEEK_END) == (off_t)-1 || storage_write(fd, row, row_length) != row_length) {
+			result = DB_STORAGE_ERROR;
+		}
+		goto out;
+	}
+
+	page = cache_find_last(file_name, rpp);
+	if (page == NULL) {
+		/* All cached pages of the file are full, so the file holds all of its rows. */
+		offset = storage_seek(fd, 0, SEEK_END);
+		if (offset == (off_t)-1) {
+			result = DB_STORAGE_ERROR;
+			goto out;
+		}
+		nrows = offset / row_length;
+		if (nrows % rpp == 0) {
+			page = cache_evict(1);
+			if (page == NULL) {
+				result = DB_STORAGE_ERROR;
+				goto out;
+			}
+			strncpy(page->file_name, file_name, TUPLE_NAME_LENGTH);
+			page->file_name[TUPLE_NAME_LENGTH] = '\0';
+			page->row_length = row_length;
+			page->first_row = nrows;
+		} else {
+			/* The last page is partly in the file */
+			page = cache_load(file_name, fd, row_length, nrows - nrows % rpp);
+			if (page == NULL) {
+				result = DB_STORAGE_ERROR;
+				goto out;
+			}
+		}
+	}
+
+	memcpy(page->data + page->nrows * row_length, row, row_length);
+	page->nrows++;
+	page->ref = 1;
+
+	result = DB_OK;
+#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
+	/* Write full pages at once */
+	if (page->nrows == rpp) {
+		result = cache_flush_page(page, fd);
+	}
+#else
+	result = cache_flush_page(page, fd);
+#endif
+	if (DB_ERROR(result)) {
+		/* Forget the row, so that it isn't written later on */
+		page->nrows--;
+	}
+
+out:
+	pthread_mutex_unlock(&g_storage_cache.lock);
+	return result;
+}
+
+/*
+ * Count the rows of a tuple file, including the ones not written yet. The
+ * position of a tuple file descriptor is shared by all users of the
+ * relation, so it is only moved under the cache lock.
+ */
+db_result_t storage_cache_row_amount(char *file_name, db_storage_id_t fd, unsigned row_length, tuple_id_t *amount)
+{
+	int i;
+	off_t offset;
+	struct storage_page_s *page;
+
+	pthread_mutex_lock(&g_storage_cache.lock);
+	offset = storage_seek(fd, 0, SEEK_END);
+	if (offset == (off_t)-1) {
+		pthread_mutex_unlock(&g_storage_cache.lock);
+		return DB_STORAGE_ERROR;
+	}
+
+	*amount = (tuple_id_t)(offset / row_length);
+	for (i = 0; i < STORAGE_CACHE_PAGES; i++) {
+		page = &g_storage_cache.pages[i];
+		if (PAGE_IS_DIRTY(page) && strncmp(page->file_name, file_name, TUPLE_NAME_LENGTH) == 0) {
+			*amount += page->nrows - page->flushed_rows;
+		}
+	}
+	pthread_mutex_unlock(&g_storage_cache.lock);
+
+	return DB_OK;
+}
+
+/*
+ * Write rows to a tuple file without caching them, e.g. a committed batch.
+ * The cached pages of the file are dropped, one of them may have been the
+ * former last page.
+ */
+db_result_t storage_cache_write(char *file_name, db_storage_id_t fd, unsigned long offset, void *data, unsigned length)
+{
+	db_result_t result;
+
+	pthread_mutex_lock(&g_storage_cache.lock);
+	result = storage_write_to(fd, data, offset, length);
+	cache_invalidate(file_name);
+	pthread_mutex_unlock(&g_storage_cache.lock);
+
+	return result;
+}
+
+void storage_cache_hint_sequential(char *file_name, unsigned row_length, tuple_id_t tuple_id)
+{
+	unsigned rpp;
+
+	rpp = cache_rows_per_page(row_length);
+	if (rpp == 0) {
+		return;
+	}
+
+	pthread_mutex_lock(&g_storage_cache.lock);
+	strncpy(g_storage_cache.seq_file, file_name, TUPLE_NAME_LENGTH);
+	g_storage_cache.seq_file[TUPLE_NAME_LENGTH] = '\0';
+	g_storage_cache.seq_page = tuple_id / rpp;
+	pthread_mutex_unlock(&g_storage_cache.lock);
+}
+
+db_result_t storage_cache_flush(void)
+{
+	int i;
+	db_result_t result = DB_OK;
+
+	if (g_storage_cache.frames == NULL) {
+		return DB_OK;
+	}
+
+	pthread_mutex_lock(&g_storage_cache.lock);
+	for (i = 0; i < STORAGE_CACHE_PAGES; i++) {
+		if (PAGE_IS_DIRTY(&g_storage_cache.pages[i]) && DB_ERROR(cache_flush_page(&g_storage_cache.pages[i], INVALID_STORAGE_ID))) {
+			result = DB_STORAGE_ERROR;
+		}
+	}
+	pthread_mutex_unlock(&g_storage_cache.lock);
+
+	return result;
+}
+
+void storage_cache_invalidate(char *file_name)
+{
+	if (g_storage_cache.frames == NULL) {
+		return;
+	}
+
+	pthread_mutex_lock(&g_storage_cache.lock);
+	cache_invalidate(file_name);
+	pthread_mutex_unlock(&g_storage_cache.lock);
+}
+
+void storage_cache_get_stats(struct storage_cache_stats_s *stats, bool reset)
+{
+	pthread_mutex_lock(&g_storage_cache.lock);
+	*stats = g_storage_cache.stats;
+	if (reset) {
+		memset(&g_storage_cache.stats, 0, sizeof(g_storage_cache.stats));
+	}
+	pthread_mutex_unlock(&g_storage_cache.lock);
+}
@@ -86,50 +86,6 @@ struct index_record_s {
 /****************************************************************************
 * Public Functions
 ****************************************************************************/
-#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
-
-/****************************************************************************
- * Name: storage_get_write_buffer_size
- *
- * Desciption: This function is called only when init write buffer for insertion.
- *   To initialize size of buffer correctly, it checked file system's available bytes.
- *
- ****************************************************************************/
-ssize_t storage_get_write_buffer_size(void)
-{
-	return storage_get_availbyte_size();
-}
-
-void storage_write_buffer_clean(void)
-{
-	memset(g_storage_write_buffer.file_name, 0, sizeof(g_storage_write_buffer.file_name));
-	memset(g_storage_write_buffer.buffer, 0, sizeof(g_storage_write_buffer.buffer));
-	g_storage_write_buffer.data_size = 0;
-}
-
-db_result_t storage_write_buffer_init()
-{
-	ssize_t size;
-	size = storage_get_write_buffer_size();
-
-	if (size > sizeof(g_storage_write_buffer.buffer)) {
-		g_storage_write_buffer.buffer = (unsigned char *)malloc(size * sizeof(unsigned char));
-	}
-	if (g_storage_write_buffer.buffer == NULL) {
-		return DB_STORAGE_ERROR;
-	}
-	storage_write_buffer_clean();
-	return DB_OK;
-}
-
-void storage_write_buffer_deinit()
-{
-	if (g_storage_write_buffer.buffer != NULL) {
-		free(g_storage_write_buffer.buffer);
-		g_storage_write_buffer.buffer = NULL;
-	}
-}
-#endif
 db_result_t storage_generate_file(char *filename)
 {
 	int fd;
@@ -139,11 +95,18 @@ db_result_t storage_generate_file(char *filename)
 		return DB_STORAGE_ERROR;
 	}
 	storage_close(fd);
+	/* The file is empty now, drop any cached rows of a former file with this name */
+	storage_cache_invalidate(filename);
 	return DB_OK;
 }
 
 db_result_t storage_load(relation_t *rel)
 {
+	/* Every user of a loaded relation shares its tuple file. */
+	if (RELATION_HAS_TUPLES(rel)) {
+		return DB_OK;
+	}
+
 	rel->tuple_storage = storage_open(rel->tuple_filename, O_APPEND | O_RDWR);
 	if (rel->tuple_storage < 0) {
 		DB_LOG_E("DB: Failed to open the tuple file\n");
@@ -231,12 +194,12 @@ db_result_t storage_put_relation(relation_t *rel)
 	}
 
 	if (rel->tuple_filename[0] == '\0') {
-		snprintf(tuple_path, TUPLE_NAME_LENGTH, "%s.%x\0", TUPLE_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+		snprintf(tuple_path, TUPLE_NAME_LENGTH, "%s.%x", TUPLE_FILE_NAME, (unsigned)(random_rand() & 0xffff));
 		int nfd;
 		while ((nfd = storage_open(tuple_path, O_RDWR)) > 0) {
 			DB_LOG_D("DB: tuplefile = %s already exist, try another\n", tuple_path);
 			storage_close(nfd);
-			snprintf(tuple_path, TUPLE_NAME_LENGTH, "%s.%x\0", TUPLE_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+			snprintf(tuple_path, TUPLE_NAME_LENGTH, "%s.%x", TUPLE_FILE_NAME, (unsigned)(random_rand() & 0xffff));
 		}
 		
 		result = storage_generate_file(tuple_path);
@@ -292,6 +255,7 @@ db_result_t storage_drop_relation(relation_t *rel, int remove_tuples)
 	DB_LOG_D("Unlink rel = %s, tuple = %s\n", rel->name, rel->tuple_filename);
 	if (remove_tuples && RELATION_HAS_TUPLES(rel)) {
 		storage_close(rel->tuple_storage);
+		storage_cache_invalidate(rel->tuple_filename);
 		if (DB_ERROR(storage_remove(rel->tuple_filename))) {
 			DB_LOG_D("Failed to remove tuple file : %s\n", rel->tuple_filename);
 			return DB_STORAGE_ERROR;
@@ -332,7 +296,7 @@ db_result_t storage_get_index(index_t *index, relation_t *rel, attribute_t *attr
 	if (filename == NULL) {
 		return DB_ALLOCATION_ERROR;
 	}
-	snprintf(filename, len, "%s%s\0", rel->name, INDEX_NAME_SUFFIX);
+	snprintf(filename, len, "%s%s", rel->name, INDEX_NAME_SUFFIX);
 	fd = storage_open(filename, O_RDONLY);
 	if (fd < 0) {
 		free(filename);
@@ -371,7 +335,7 @@ db_result_t storage_put_index(index_t *index)
 	if (filename == NULL) {
 		return DB_ALLOCATION_ERROR;
 	}
-	snprintf(filename, len, "%s%s\0", index->rel->name, INDEX_NAME_SUFFIX);
+	snprintf(filename, len, "%s%s", index->rel->name, INDEX_NAME_SUFFIX);
 	fd = storage_open(filename, O_WROK | O_APPEND | O_CREAT);
 	if (fd < 0) {
 		free(filename);
@@ -412,7 +376,7 @@ db_result_t storage_remove_index(relation_t *rel, attribute_t *attr)
 	if (filename == NULL) {
 		return DB_STORAGE_ERROR;
 	}
-	snprintf(filename, len, "%s%s\0", rel->name, INDEX_NAME_SUFFIX);
+	snprintf(filename, len, "%s%s", rel->name, INDEX_NAME_SUFFIX);
 	fd = storage_open(filename, O_RDONLY);
 	if (fd < 0) {
 		free(filename);
@@ -441,7 +405,7 @@ db_result_t storage_remove_index(relation_t *rel, attribute_t *attr)
 			storage_close(fd);
 			return DB_STORAGE_ERROR;
 		}
-		snprintf(new_filename, len, "%s%s%s\0", rel->name, INDEX_NAME_SUFFIX, TEMP_FILE_SUFFIX);
+		snprintf(new_filename, len, "%s%s%s", rel->name, INDEX_NAME_SUFFIX, TEMP_FILE_SUFFIX);
 		res = storage_generate_file(new_filename);
 		if (DB_ERROR(res)) {
 			free(filename);
@@ -498,37 +462,18 @@ db_result_t storage_remove_index(relation_t *rel, attribute_t *attr)
 
 db_result_t storage_get_row(relation_t *rel, tuple_id_t *tuple_id, storage_row_t row)
 {
-	ssize_t r;
-	tuple_id_t nrows;
-
-	if (DB_ERROR(storage_get_row_amount(rel, &nrows))) {
-		return DB_STORAGE_ERROR;
-	}
-
-	if (*tuple_id >= nrows) {
-		DB_LOG_E("DB : tuple_id : %d nrows : %d\n", *tuple_id, nrows);
-		return DB_FINISHED;
-	}
-
-	if (storage_seek(rel->tuple_storage, *tuple_id * rel->row_length, SEEK_SET) == (off_t)-1) {
-		return DB_STORAGE_ERROR;
-	}
-
-	r = storage_read(rel->tuple_storage, row, rel->row_length);
-	DB_LOG_V("read row = %s, r = %d\n", row, r);
+	db_result_t result;
 
-	if (r == 0) {
-		DB_LOG_E("%DB : read 0 bytes\n");
+	result = storage_cache_read(rel->tuple_filename, rel->tuple_storage, rel->row_length, *tuple_id, 0, rel->row_length, row);
+	if (result == DB_FINISHED) {
+		DB_LOG_D("DB : tuple_id : %d is beyond the last row\n", *tuple_id);
 		return DB_FINISHED;
-	} else if (r < 0) {
+	} else if (DB_ERROR(result)) {
 		DB_LOG_E("DB: Reading failed on fd %d\n", rel->tuple_storage);
 		return DB_STORAGE_ERROR;
-	} else if (r < rel->row_length) {
-		DB_LOG_E("DB: Incomplete record: %d < %d\n", r, rel->row_length);
-		return DB_STORAGE_ERROR;
 	}
 
-	DB_LOG_D("DB: Read %d bytes from relation %s\n", rel->row_length, rel->name);
+	DB_LOG_V("DB: Read %d bytes from relation %s\n", rel->row_length, rel->name);
 	return DB_OK;
 }
 
@@ -552,69 +497,23 @@ db_result_t storage_put_row(relation_t *rel, storage_row_t row, uint8_t flag)
 
 db_result_t storage_write_row(db_storage_id_t fd, storage_row_t row, unsigned length, char *filename)
 {
-#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
-	if (strncmp(g_storage_write_buffer.file_name, filename, TUPLE_NAME_LENGTH) != 0) {
-		storage_flush_insert_buffer();
-	}
-	if ((g_storage_write_buffer.data_size + length) >= storage_get_write_buffer_size()) {
-		storage_flush_insert_buffer();
-	}
-	memcpy(g_storage_write_buffer.buffer + g_storage_write_buffer.data_size, row, length);
-	g_storage_write_buffer.data_size += length;
-	memcpy(g_storage_write_buffer.file_name, filename, strlen(filename) + 1);
-#else
-	if (storage_write(fd, row, length) < 0) {
+	/* Rows are kept in the last page of the file, see storage_cache.c */
+	if (DB_ERROR(storage_cache_append(filename, fd, length, row))) {
 		DB_LOG_D("DB: Failed to store %u bytes\n", length);
 		return DB_STORAGE_ERROR;
 	}
-	DB_LOG_D("DB: Stored a of %d bytes\n", length);
-#endif
+	DB_LOG_V("DB: Stored a of %d bytes\n", length);
 
 	return DB_OK;
 }
 
-#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
-db_result_t storage_flush_insert_buffer()
-{
-	ssize_t r;
-	int fd;
-
-	if (g_storage_write_buffer.data_size <= 0) {
-		/* There is no data to flush, return here */
-		return DB_OK;
-	}
-
-	fd = storage_open(g_storage_write_buffer.file_name, O_APPEND | O_RDWR);
-	if (fd < 0) {
-		DB_LOG_D("Failed to open %s\n", g_storage_write_buffer.file_name);
-		return DB_STORAGE_ERROR;
-	}
-
-	r = storage_write(fd, g_storage_write_buffer.buffer, g_storage_write_buffer.data_size);
-	if (r < 0) {
-		storage_close(fd);
-		return DB_STORAGE_ERROR;
-	}
-	DB_LOG_D("DB : Stored buffer(%d bytes) in storage\n", g_storage_write_buffer.data_size);
-	storage_close(fd);
-	storage_write_buffer_clean();
-	return DB_OK;
-}
-#endif
 db_result_t storage_get_row_amount(relation_t *rel, tuple_id_t *amount)
 {
-	off_t offset;
-
 	if (rel->row_length == 0) {
 		*amount = 0;
-	} else {
-		offset = storage_seek(rel->tuple_storage, 0, SEEK_END);
-		if (offset == (off_t)-1) {
-			return DB_STORAGE_ERROR;
-		}
-		*amount = (tuple_id_t)(offset / rel->row_length);
+		return DB_OK;
 	}
-	return DB_OK;
+	return storage_cache_row_amount(rel->tuple_filename, rel->tuple_storage, rel->row_length, amount);
 }
 
 db_result_t storage_read_from(db_storage_id_t fd, void *buffer, unsigned long offset, unsigned length)
@@ -0,0 +1,676 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/**
+ * \file
+ *      Transactions of inserts.
+ *
+ *      Rows inserted between db_begin() and db_commit() are kept in RAM, in
+ *      one batch per relation, and are neither visible to queries nor
+ *      indexed until the commit. The commit appends every batch to its
+ *      tuple file with a single write, then inserts the keys of the batch
+ *      into each index of the relation in key order.
+ *
+ *      Tuple files are append-only and can't be truncated in place, so the
+ *      commit is made atomic by an undo log holding the number of rows of
+ *      every tuple file before the commit. The log is written before the
+ *      first row and removed after the last index insert. If a commit is
+ *      interrupted, transaction_recover() cuts the tuple files back to
+ *      their former length by copying them, and rebuilds their indexes.
+ *      A log which isn't complete was written before any row, it is just
+ *      removed.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "db_options.h"
+#include "db_debug.h"
+#include "index.h"
+#include "result.h"
+#include "storage.h"
+#include "aql.h"
+#include "transaction.h"
+
+/****************************************************************************
+* Pre-processor Definitions
+****************************************************************************/
+#define UNDO_LOG_MAGIC 0x41524155	/* "ARAU" */
+
+/* Rows first allocated for the batch of a relation, doubled when it is full */
+#define TRANSACTION_BATCH_INIT 16
+
+/* Bytes copied at once when a tuple file is cut back by the recovery */
+#define UNDO_COPY_SIZE 512
+
+/****************************************************************************
+* Private Types
+****************************************************************************/
+/* Rows inserted into a relation by the transaction */
+struct transaction_batch_s {
+	struct transaction_batch_s *next;
+	relation_t *rel;			/* loaded while the transaction lives */
+	tuple_id_t first_row;		/* tuple id of the first row, set by the commit */
+	tuple_id_t nrows;
+	tuple_id_t size;			/* rows allocated */
+	unsigned char *data;
+};
+
+struct transaction_s {
+	pthread_mutex_t lock;
+	pthread_t owner;			/* thread which called db_begin() */
+	bool active;
+	tuple_id_t nrows;			/* rows of all batches */
+};
+
+/* A relation of the undo log */
+struct undo_record_s {
+	char relation_name[RELATION_NAME_LENGTH + 1];
+	char tuple_filename[TUPLE_NAME_LENGTH + 1];
+	uint32_t rows;				/* rows of the tuple file before the commit */
+	uint32_t row_length;
+};
+
+struct undo_header_s {
+	uint32_t magic;
+	uint32_t count;				/* records following the header */
+	uint32_t checksum;			/* of the records */
+};
+
+/* Rows of a batch being sorted by the key of an attribute */
+struct transaction_sort_s {
+	unsigned char *data;
+	size_t row_length;
+	unsigned offset;
+	attribute_t *attr;
+};
+
+/****************************************************************************
+* Private Variables
+****************************************************************************/
+static struct transaction_s g_transaction = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+/* qsort() has no context argument, commits are serialized by the owner */
+static struct transaction_sort_s g_sort;
+
+LIST(batches);
+
+/****************************************************************************
+* Private Functions
+****************************************************************************/
+static db_result_t transaction_check_owner(void)
+{
+	db_result_t res = DB_OK;
+
+	pthread_mutex_lock(&g_transaction.lock);
+	if (!g_transaction.active) {
+		DB_LOG_E("DB: No transaction has begun\n");
+		res = DB_ARGUMENT_ERROR;
+	} else if (!pthread_equal(g_transaction.owner, pthread_self())) {
+		DB_LOG_E("DB: The transaction belongs to another thread\n");
+		res = DB_BUSY_ERROR;
+	}
+	pthread_mutex_unlock(&g_transaction.lock);
+	return res;
+}
+
+static struct transaction_batch_s *transaction_get_batch(relation_t *rel)
+{
+	struct transaction_batch_s *batch;
+
+	for (batch = list_head(batches); batch != NULL; batch = batch->next) {
+		if (batch->rel == rel) {
+			return batch;
+		}
+	}
+
+	batch = malloc(sizeof(struct transaction_batch_s));
+	if (batch == NULL) {
+		return NULL;
+	}
+	memset(batch, 0, sizeof(struct transaction_batch_s));
+
+	/* Hold the relation, so that it can't be removed before the commit. */
+	batch->rel = relation_load(rel->name);
+	if (batch->rel == NULL) {
+		free(batch);
+		return NULL;
+	}
+	list_add(batches, batch);
+	return batch;
+}
+
+static void transaction_end(void)
+{
+	struct transaction_batch_s *batch;
+
+	while ((batch = list_pop(batches)) != NULL) {
+		relation_release(batch->rel);
+		free(batch->data);
+		free(batch);
+	}
+
+	pthread_mutex_lock(&g_transaction.lock);
+	g_transaction.active = false;
+	g_transaction.nrows = 0;
+	pthread_mutex_unlock(&g_transaction.lock);
+}
+
+static uint32_t undo_checksum(unsigned char *data, size_t length)
+{
+	uint32_t sum = 5381;
+
+	while (length-- > 0) {
+		sum = ((sum << 5) + sum) + *data++;
+	}
+	return sum;
+}
+
+static db_result_t undo_write(void)
+{
+	struct transaction_batch_s *batch;
+	struct undo_header_s *header;
+	struct undo_record_s *record;
+	db_storage_id_t fd;
+	unsigned count;
+	size_t length;
+	ssize_t r;
+
+	count = list_length(batches);
+	length = sizeof(struct undo_header_s) + count * sizeof(struct undo_record_s);
+	header = malloc(length);
+	if (header == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+	memset(header, 0, length);
+
+	record = (struct undo_record_s *)(header + 1);
+	for (batch = list_head(batches); batch != NULL; batch = batch->next, record++) {
+		memcpy(record->relation_name, batch->rel->name, sizeof(record->relation_name));
+		memcpy(record->tuple_filename, batch->rel->tuple_filename, sizeof(record->tuple_filename));
+		record->rows = batch->first_row;
+		record->row_length = batch->rel->row_length;
+	}
+	header->magic = UNDO_LOG_MAGIC;
+	header->count = count;
+	header->checksum = undo_checksum((unsigned char *)(header + 1), count * sizeof(struct undo_record_s));
+
+	fd = storage_open(UNDO_LOG_NAME, O_WROK | O_CREAT | O_TRUNC);
+	if (fd < 0) {
+		free(header);
+		return DB_STORAGE_ERROR;
+	}
+	r = storage_write(fd, header, length);
+	if (r != length || DB_ERROR(storage_sync(fd))) {
+		DB_LOG_E("DB: Failed to write the undo log\n");
+		storage_close(fd);
+		storage_remove(UNDO_LOG_NAME);
+		free(header);
+		return DB_STORAGE_ERROR;
+	}
+	storage_close(fd);
+	free(header);
+	return DB_OK;
+}
+
+/* Cut a tuple file back to the rows it had before the interrupted commit */
+static db_result_t undo_tuples(struct undo_record_s *record)
+{
+	char tmp_filename[TUPLE_NAME_LENGTH + TEMP_FILE_SUFFIX_LENGTH + 1];
+	unsigned char *buf;
+	db_storage_id_t fd;
+	db_storage_id_t fd_tmp;
+	unsigned long length;
+	unsigned long copied;
+	unsigned chunk;
+	off_t size;
+	db_result_t res;
+
+	snprintf(tmp_filename, sizeof(tmp_filename), "%s%s", record->tuple_filename, TEMP_FILE_SUFFIX);
+	length = (unsigned long)record->rows * record->row_length;
+
+	fd = storage_open(record->tuple_filename, O_RDONLY);
+	if (fd < 0) {
+		/* Interrupted between removing the tuple file and renaming its copy */
+		return storage_rename(tmp_filename, record->tuple_filename);
+	}
+
+	size = storage_seek(fd, 0, SEEK_END);
+	if (size == (off_t)-1) {
+		storage_close(fd);
+		return DB_STORAGE_ERROR;
+	}
+	if ((unsigned long)size <= length) {
+		storage_close(fd);
+		return DB_OK;
+	}
+
+	buf = malloc(UNDO_COPY_SIZE);
+	if (buf == NULL) {
+		storage_close(fd);
+		return DB_ALLOCATION_ERROR;
+	}
+
+	res = storage_generate_file(tmp_filename);
+	if (DB_ERROR(res)) {
+		goto errout;
+	}
+	fd_tmp = storage_open(tmp_filename, O_WROK | O_APPEND);
+	if (fd_tmp < 0) {
+		res = DB_STORAGE_ERROR;
+		goto errout;
+	}
+
+	for (copied = 0; copied < length; copied += chunk) {
+		chunk = length - copied < UNDO_COPY_SIZE ? length - copied : UNDO_COPY_SIZE;
+		if (DB_ERROR(storage_read_from(fd, buf, copied, chunk)) || storage_write(fd_tmp, buf, chunk) != chunk) {
+			res = DB_STORAGE_ERROR;
+			break;
+		}
+	}
+	if (DB_SUCCESS(res)) {
+		res = storage_sync(fd_tmp);
+	}
+	storage_close(fd_tmp);
+	storage_close(fd);
+	free(buf);
+
+	if (DB_ERROR(res)) {
+		storage_remove(tmp_filename);
+		return res;
+	}
+
+	res = storage_remove(record->tuple_filename);
+	if (DB_ERROR(res)) {
+		storage_remove(tmp_filename);
+		return res;
+	}
+	return storage_rename(tmp_filename, record->tuple_filename);
+
+errout:
+	storage_close(fd);
+	free(buf);
+	return res;
+}
+
+/* Rebuild the indexes of a relation, they may hold keys of the undone rows */
+static db_result_t undo_indexes(struct undo_record_s *record)
+{
+	relation_t *rel;
+	attribute_t *attr;
+	index_type_t type;
+	db_result_t res;
+
+	rel = relation_load(record->relation_name);
+	if (rel == NULL) {
+		return DB_RELATIONAL_ERROR;
+	}
+	rel->cardinality = INVALID_TUPLE;
+	rel->cardinality = relation_cardinality(rel);
+	rel->next_row = rel->cardinality;
+
+	res = DB_OK;
+	for (attr = list_head(rel->attributes); attr != NULL; attr = attr->next) {
+		if (attr->index == NULL) {
+			index_load(rel, attr);
+		}
+		if (attr->index == NULL) {
+			continue;
+		}
+		type = ((index_t *)attr->index)->type;
+		DB_LOG_D("DB: Rebuild the index of %s.%s\n", rel->name, attr->name);
+		if (DB_ERROR(index_destroy(attr->index)) || DB_ERROR(index_create(type, rel, attr))) {
+			DB_LOG_E("DB: Failed to rebuild the index of %s.%s\n", rel->name, attr->name);
+			res = DB_INDEX_ERROR;
+		}
+	}
+
+	relation_release(rel);
+	return res;
+}
+
+static int compare_keys(const void *a, const void *b)
+{
+	tuple_id_t row_a = *(const tuple_id_t *)a;
+	tuple_id_t row_b = *(const tuple_id_t *)b;
+	attribute_value_t value_a;
+	attribute_value_t value_b;
+	long long_a;
+	long long_b;
+	int cmp;
+
+	db_phy_to_value(&value_a, g_sort.attr, g_sort.data + row_a * g_sort.row_length + g_sort.offset);
+	db_phy_to_value(&value_b, g_sort.attr, g_sort.data + row_b * g_sort.row_length + g_sort.offset);
+
+	if (g_sort.attr->domain == DOMAIN_STRING) {
+		cmp = strcmp((char *)VALUE_STRING(&value_a), (char *)VALUE_STRING(&value_b));
+	} else {
+		long_a = db_value_to_long(&value_a);
+		long_b = db_value_to_long(&value_b);
+		cmp = (long_a > long_b) - (long_a < long_b);
+	}
+
+	/* Equal keys keep the order they were inserted in. */
+	if (cmp == 0) {
+		cmp = (row_a > row_b) - (row_a < row_b);
+	}
+	return cmp;
+}
+
+/* Insert the keys of a batch into the indexes of its relation, in key order */
+static db_result_t batch_index(struct transaction_batch_s *batch)
+{
+	relation_t *rel = batch->rel;
+	attribute_t *attr;
+	attribute_value_t value;
+	tuple_id_t *order;
+	tuple_id_t i;
+	unsigned offset;
+
+	order = NULL;
+	offset = 0;
+	for (attr = list_head(rel->attributes); attr != NULL; offset += attr->element_size, attr = attr->next) {
+		if (attr->flags & ATTRIBUTE_FLAG_INVALID) {
+			continue;
+		}
+		if (attr->index == NULL) {
+			index_load(rel, attr);
+		}
+		if (attr->index == NULL) {
+			continue;
+		}
+
+		if (order == NULL) {
+			order = malloc(batch->nrows * sizeof(tuple_id_t));
+			if (order == NULL) {
+				return DB_ALLOCATION_ERROR;
+			}
+		}
+		for (i = 0; i < batch->nrows; i++) {
+			order[i] = i;
+		}
+		g_sort.data = batch->data;
+		g_sort.row_length = rel->row_length;
+		g_sort.offset = offset;
+		g_sort.attr = attr;
+		qsort(order, batch->nrows, sizeof(tuple_id_t), compare_keys);
+
+		for (i = 0; i < batch->nrows; i++) {
+			db_phy_to_value(&value, attr, batch->data + order[i] * rel->row_length + offset);
+			if (DB_ERROR(index_insert(attr->index, &value, batch->first_row + order[i]))) {
+				free(order);
+				return DB_INDEX_ERROR;
+			}
+		}
+	}
+
+	free(order);
+	return DB_OK;
+}
+
+/* Append a batch to its tuple file with a single write */
+static db_result_t batch_store(struct transaction_batch_s *batch)
+{
+	relation_t *rel = batch->rel;
+	unsigned length;
+
+	length = batch->nrows * rel->row_length;
+	if (DB_ERROR(storage_cache_write(rel->tuple_filename, rel->tuple_storage, (unsigned long)batch->first_row * rel->row_length, batch->data, length)) || DB_ERROR(storage_sync(rel->tuple_storage))) {
+		DB_LOG_E("DB: Failed to store %u rows of %s\n", batch->nrows, rel->name);
+		return DB_STORAGE_ERROR;
+	}
+	rel->cardinality = batch->first_row + batch->nrows;
+	rel->next_row = rel->cardinality;
+	return DB_OK;
+}
+
+/* Undo a commit which failed after the undo log was written */
+static void transaction_undo(void)
+{
+	struct transaction_batch_s *batch;
+
+	for (batch = list_head(batches); batch != NULL; batch = batch->next) {
+		storage_cache_invalidate(batch->rel->tuple_filename);
+		storage_unload(batch->rel);
+	}
+
+	if (DB_ERROR(transaction_recover())) {
+		DB_LOG_E("DB: Failed to undo the commit, retried by db_init()\n");
+	}
+
+	for (batch = list_head(batches); batch != NULL; batch = batch->next) {
+		if (DB_ERROR(storage_load(batch->rel))) {
+			DB_LOG_E("DB: Failed to reopen the tuple file of %s\n", batch->rel->name);
+		}
+	}
+}
+
+static db_result_t transaction_apply(void)
+{
+	struct transaction_batch_s *batch;
+	db_result_t res;
+
+	/* The tuple files must hold all of their rows before the log records
+	   their length. */
+	res = storage_cache_flush();
+	if (DB_ERROR(res)) {
+		return res;
+	}
+	for (batch = list_head(batches); batch != NULL; batch = batch->next) {
+		if (DB_ERROR(storage_get_row_amount(batch->rel, &batch->first_row))) {
+			return DB_STORAGE_ERROR;
+		}
+	}
+
+	res = undo_write();
+	if (DB_ERROR(res)) {
+		return res;
+	}
+
+	for (batch = list_head(batches); batch != NULL && DB_SUCCESS(res); batch = batch->next) {
+		res = batch_store(batch);
+	}
+	for (batch = list_head(batches); batch != NULL && DB_SUCCESS(res); batch = batch->next) {
+		res = batch_index(batch);
+	}
+	if (DB_SUCCESS(res)) {
+		res = index_flush();
+	}
+	if (DB_ERROR(res)) {
+		transaction_undo();
+		return res;
+	}
+
+	return storage_remove(UNDO_LOG_NAME);
+}
+
+/****************************************************************************
+* Public Functions
+****************************************************************************/
+bool transaction_is_active(void)
+{
+	bool active;
+
+	pthread_mutex_lock(&g_transaction.lock);
+	active = g_transaction.active;
+	pthread_mutex_unlock(&g_transaction.lock);
+	return active;
+}
+
+db_result_t transaction_insert(relation_t *rel, storage_row_t row)
+{
+	struct transaction_batch_s *batch;
+	tuple_id_t cardinality;
+	unsigned char *data;
+	tuple_id_t size;
+	db_result_t res;
+
+	res = transaction_check_owner();
+	if (DB_ERROR(res)) {
+		return res;
+	}
+
+	if (g_transaction.nrows >= DB_TRANSACTION_ROWS) {
+		DB_LOG_E("DB: A transaction holds at most %d rows\n", DB_TRANSACTION_ROWS);
+		return DB_LIMIT_ERROR;
+	}
+
+	batch = transaction_get_batch(rel);
+	if (batch == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+
+	cardinality = relation_cardinality(rel);
+	if (cardinality == INVALID_TUPLE) {
+		return DB_STORAGE_ERROR;
+	}
+	if (cardinality + batch->nrows >= DB_TUPLE_LIMIT) {
+		return DB_LIMIT_ERROR;
+	}
+
+	if (batch->nrows == batch->size) {
+		size = batch->size == 0 ? TRANSACTION_BATCH_INIT : batch->size * 2;
+		if (size > DB_TRANSACTION_ROWS) {
+			size = DB_TRANSACTION_ROWS;
+		}
+		data = realloc(batch->data, size * rel->row_length);
+		if (data == NULL) {
+			return DB_ALLOCATION_ERROR;
+		}
+		batch->data = data;
+		batch->size = size;
+	}
+
+	memcpy(batch->data + batch->nrows * rel->row_length, row, rel->row_length);
+	batch->nrows++;
+	g_transaction.nrows++;
+	return DB_OK;
+}
+
+db_result_t transaction_recover(void)
+{
+	struct undo_header_s header;
+	struct undo_record_s *records;
+	db_storage_id_t fd;
+	size_t length;
+	db_result_t res;
+	uint32_t i;
+
+	fd = storage_open(UNDO_LOG_NAME, O_RDONLY);
+	if (fd < 0) {
+		return DB_OK;
+	}
+
+	records = NULL;
+	length = 0;
+	if (storage_read(fd, &header, sizeof(header)) == sizeof(header) && header.magic == UNDO_LOG_MAGIC && header.count > 0 && header.count <= DB_TRANSACTION_ROWS) {
+		length = header.count * sizeof(struct undo_record_s);
+		records = malloc(length);
+		if (records == NULL) {
+			storage_close(fd);
+			return DB_ALLOCATION_ERROR;
+		}
+		if (storage_read(fd, records, length) != length || undo_checksum((unsigned char *)records, length) != header.checksum) {
+			/* The log was interrupted, no row was written yet. */
+			free(records);
+			records = NULL;
+		}
+	}
+	storage_close(fd);
+
+	res = DB_OK;
+	if (records != NULL) {
+		for (i = 0; i < header.count && DB_SUCCESS(res); i++) {
+			DB_LOG_D("DB: Undo the commit into %s, %u rows\n", records[i].relation_name, records[i].rows);
+			res = undo_tuples(&records[i]);
+			if (DB_SUCCESS(res)) {
+				res = undo_indexes(&records[i]);
+			}
+		}
+		free(records);
+		if (DB_ERROR(res)) {
+			DB_LOG_E("DB: Failed to undo an interrupted commit\n");
+			return res;
+		}
+	}
+
+	return storage_remove(UNDO_LOG_NAME);
+}
+
+void transaction_deinit(void)
+{
+	if (transaction_is_active()) {
+		transaction_end();
+	}
+}
+
+db_result_t db_begin(void)
+{
+	db_result_t res = DB_OK;
+
+	pthread_mutex_lock(&g_transaction.lock);
+	if (g_transaction.active) {
+		res = DB_BUSY_ERROR;
+	} else {
+		g_transaction.active = true;
+		g_transaction.owner = pthread_self();
+		g_transaction.nrows = 0;
+	}
+	pthread_mutex_unlock(&g_transaction.lock);
+	return res;
+}
+
+db_result_t db_commit(void)
+{
+	db_result_t res;
+
+	res = transaction_check_owner();
+	if (DB_ERROR(res)) {
+		return res;
+	}
+
+	if (list_head(batches) != NULL) {
+		aql_lock();
+		res = transaction_apply();
+		aql_unlock();
+	}
+	transaction_end();
+	return res;
+}
+
+db_result_t db_rollback(void)
+{
+	db_result_t res;
+
+	res = transaction_check_owner();
+	if (DB_ERROR(res)) {
+		return res;
+	}
+
+	transaction_end();
+	return DB_OK;
+}
@@ -0,0 +1,42 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/**
+ * \file
+ *      Transactions of inserts.
+ */
+
+#ifndef TRANSACTION_H
+#define TRANSACTION_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <stdbool.h>
+#include <arastorage/arastorage.h>
+#include "storage.h"
+
+/****************************************************************************
+* Global Function Prototypes
+****************************************************************************/
+bool transaction_is_active(void);
+db_result_t transaction_insert(relation_t *, storage_row_t);
+db_result_t transaction_recover(void);
+void transaction_deinit(void);
+
+#endif							/* TRANSACTION_H */
@@ -25,6 +25,11 @@
 #include <unistd.h>
 #include <string.h>
 #include <sys/types.h>
+#ifdef CONFIG_EVENT_FD
+#include <stdio.h>
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#endif
 #include <libtuv/uv.h>
 #include <libtuv/uv__types.h>
 #include <eventloop/eventloop.h>
@@ -56,11 +61,81 @@ struct event_data_s {
 	event_callback func;
 	void *cb_data;
 	void *event_data;
+#ifdef CONFIG_EVENT_FD
+	int devno;
+	int fd;
+#endif
 };
 typedef struct event_data_s event_data_t;
 
 sq_queue_t g_event_list;  // list node type : event_group_t
 
+#ifdef CONFIG_EVENT_FD
+/* Each event handler polls its own event flags, which the senders open by
+ * path to set them.
+ */
+#define EVENT_FD_PATH      "/dev/el_event%d"
+#define EVENT_FD_PATHLEN   24
+#define EVENT_FD_RECEIVED  1
+
+static int g_event_devno;
+
+static void eventloop_event_path(char *path, int devno)
+{
+	snprintf(path, EVENT_FD_PATHLEN, EVENT_FD_PATH, devno);
+}
+
+static int eventloop_open_event_fd(event_data_t *data)
+{
+	char path[EVENT_FD_PATHLEN];
+
+	data->devno = g_event_devno++;
+	eventloop_event_path(path, data->devno);
+	if (mkeventfd(path, 0666) != OK) {
+		eldbg("Failed to create event flags %s, errno %d\n", path, errno);
+		return ERROR;
+	}
+
+	data->fd = open(path, O_RDONLY);
+	if (data->fd < 0) {
+		eldbg("Failed to open event flags %s, errno %d\n", path, errno);
+		unlink(path);
+		return ERROR;
+	}
+
+	return OK;
+}
+
+static void eventloop_close_event_fd(event_data_t *data)
+{
+	char path[EVENT_FD_PATHLEN];
+
+	close(data->fd);
+	eventloop_event_path(path, data->devno);
+	unlink(path);
+}
+
+/* Wake up the loop of the handler, nothing is allocated */
+
+static int eventloop_notify_event_fd(event_data_t *data)
+{
+	char path[EVENT_FD_PATHLEN];
+	int ret;
+	int fd;
+
+	eventloop_event_path(path, data->devno);
+	fd = open(path, O_WRONLY);
+	if (fd < 0) {
+		return ERROR;
+	}
+
+	ret = eventfd_write(fd, EVENT_FD_RECEIVED);
+	close(fd);
+
+	return ret;
+}
+#endif
+
 static event_group_t *get_event_group(int type)
 {
 	event_group_t *ptr;
@@ -178,6 +253,9 @@ void eventloop_unregister_event_cb(el_event_t *handle)
 				if (data->event_data != NULL) {
 					EL_FREE(data->event_data);
 				}
+#ifdef CONFIG_EVENT_FD
+				eventloop_close_event_fd(data);
+#endif
 				EL_FREE(data);
 				EL_FREE(handle);
 				EL_FREE(ptr);
@@ -226,6 +304,25 @@ static void event_callback_func(el_event_t *event, int signum)
 	return;
 }
 
+#ifdef CONFIG_EVENT_FD
+static void event_poll_cb(uv_poll_t *handle, int status, int events)
+{
+	eventfd_t value;
+
+	if (status < 0 || (events & UV_READABLE) == 0) {
+		return;
+	}
+
+	/* Clear the flags, the descriptor doesn't block */
+
+	if (eventfd_read(((event_data_t *)handle->data)->fd, &value) != OK) {
+		return;
+	}
+
+	event_callback_func(handle, SIGEL_EVENT);
+}
+#endif
+
 static int eventloop_send_event_sig(int type, void *event_data, int data_size)
 {
 	event_group_t *event_group;
@@ -252,10 +349,17 @@ static int eventloop_send_event_sig(int type, void *event_data, int data_size)
 				}
 				memcpy(cb_data->event_data, event_data, data_size);
 			}
+#ifdef CONFIG_EVENT_FD
+			/* Set the event flags of the handler */
+			int ret = eventloop_notify_event_fd(cb_data);
+			if (ret < 0) {
+				eldbg("eventfd_write failed %d \n", errno);
+#else
 			/* Send signal to task which registered event */
 			int ret = kill(cb_data->pid, SIGEL_EVENT);
 			if (ret < 0) {
 				eldbg("kill failed %d \n", errno);
+#endif
 				if (cb_data->event_data != NULL) {
 					EL_FREE(cb_data->event_data);
 					cb_data->event_data = NULL;
@@ -307,6 +411,26 @@ el_event_t *eventloop_add_event_handler(int type, event_callback func, void *dat
 	event_cb->event_data = NULL;
 	handle->data = (void *)event_cb;
 
+#ifdef CONFIG_EVENT_FD
+	ret = eventloop_open_event_fd(event_cb);
+	if (ret != OK) {
+		goto errout;
+	}
+
+	ret = uv_poll_init(loop, handle, event_cb->fd);
+	if (ret != 0) {
+		eldbg("Failed to initialize event\n");
+		eventloop_close_event_fd(event_cb);
+		goto errout;
+	}
+
+	ret = uv_poll_start(handle, UV_READABLE, event_poll_cb);
+	if (ret != 0) {
+		eldbg("Failed to initialize event\n");
+		eventloop_close_event_fd(event_cb);
+		goto errout;
+	}
+#else
 	ret = uv_signal_init(loop, handle);
 	if (ret != 0) {
 		eldbg("Failed to initialize event\n");
@@ -318,12 +442,16 @@ el_event_t *eventloop_add_event_handler(int type, event_callback func, void *dat
 		eldbg("Failed to initialize event\n");
 		goto errout;
 	}
+#endif
 
 	/* Add event handle to a list of handles */
 	ret = eventloop_register_event_cb(handle);
 	if (ret != OK) {
 		eldbg("Failed to register signal for event\n");
 		uv_close((uv_handle_t *)handle, NULL);
+#ifdef CONFIG_EVENT_FD
+		eventloop_close_event_fd(event_cb);
+#endif
 		goto errout;
 	}
 	elvdbg("created event handle %p, type = %d\n", handle, type);
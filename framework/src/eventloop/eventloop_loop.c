@@ -108,6 +108,12 @@ static void eventloop_close_handle(uv_handle_t *handle, void *data)
 	case UV_SIGNAL:
 		uv_close(handle, (uv_close_cb)eventloop_unregister_event_cb);
 		break;
+#ifdef CONFIG_EVENT_FD
+	case UV_POLL:
+		/* The event handlers watch their eventfd */
+		uv_close(handle, (uv_close_cb)eventloop_unregister_event_cb);
+		break;
+#endif
 	case UV_ASYNC:
 		uv_close(handle, (uv_close_cb)eventloop_unregister_thread_safe_cb);
 		break;
@@ -165,6 +165,25 @@ size_t Decoder::getAvailSpace()
 #endif
 }
 
+/**
+ * @brief   Drop buffered input and decoder state, e.g. after the input is repositioned.
+ *          Coding format and configuration are kept, so decoding resumes at the next frame pushed.
+ * @return  true on success, otherwise false.
+ */
+bool Decoder::reset()
+{
+#ifdef CONFIG_AUDIO_CODEC
+	if (audio_decoder_reset(&mDecoder) != AUDIO_DECODER_OK) {
+		meddbg("%s[line : %d] Fail : audio_decoder_reset is failed\n", __func__, __LINE__);
+		return false;
+	}
+
+	return true;
+#else
+	return false;
+#endif
+}
+
 #ifdef CONFIG_AUDIO_CODEC
 bool Decoder::mConfig(int audioType)
 {
@@ -42,6 +42,7 @@ public:
 	bool getFrame(unsigned char *buf, size_t *size, unsigned int *sampleRate, unsigned short *channels);
 	bool empty();
 	size_t getAvailSpace();
+	bool reset();
 
 private:
 #ifdef CONFIG_AUDIO_CODEC
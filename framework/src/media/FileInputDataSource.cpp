@@ -18,10 +18,17 @@
 
 #include <tinyara/config.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <sys/stat.h>
 #include <debug.h>
+#include <utility>
 
 #include <media/FileInputDataSource.h>
 #include "utils/MediaUtils.h"
+#include "streaming/frame_index.h"
+
+/* Suffix of the frame index cache written next to the file */
+#define FRAME_INDEX_CACHE_SUFFIX ".idx"
 
 namespace media {
 namespace stream {
@@ -29,21 +36,33 @@ namespace stream {
 FileInputDataSource::FileInputDataSource() :
 	InputDataSource(),
 	mDataPath(""),
-	mFp(nullptr)
+	mFp(nullptr),
+	mIndex(nullptr),
+	mReadOffset(0),
+	mFileSize(0),
+	mMtime(0)
 {
 }
 
 FileInputDataSource::FileInputDataSource(const std::string &dataPath) :
 	InputDataSource(),
 	mDataPath(dataPath),
-	mFp(nullptr)
+	mFp(nullptr),
+	mIndex(nullptr),
+	mReadOffset(0),
+	mFileSize(0),
+	mMtime(0)
 {
 }
 
 FileInputDataSource::FileInputDataSource(const FileInputDataSource &source) :
 	InputDataSource(source),
 	mDataPath(source.mDataPath),
-	mFp(source.mFp)
+	mFp(source.mFp),
+	mIndex(nullptr),
+	mReadOffset(source.mReadOffset),
+	mFileSize(source.mFileSize),
+	mMtime(source.mMtime)
 {
 }
 
@@ -96,6 +115,7 @@ bool FileInputDataSource::open()
 			break;
 		}
 
+		openIndex();
 		return true;
 	}
 
@@ -106,6 +126,7 @@ bool FileInputDataSource::open()
 bool FileInputDataSource::close()
 {
 	bool ret = true;
+	closeIndex();
 	if (mFp) {
 		if (fclose(mFp) == OK) {
 			mFp = nullptr;
@@ -148,6 +169,11 @@ ssize_t FileInputDataSource::read(unsigned char *buf, size_t size)
 		/* If file position reaches end of file, it's a normal case, we returns 0 */
 		if (feof(mFp)) {
 			medvdbg("eof!!!\n");
+			std::lock_guard<std::mutex> lock(mIndexMutex);
+			if (mIndex && !mIndex->complete) {
+				frame_index_eof(mIndex);
+				saveIndex();
+			}
 			return 0;
 		}
 
@@ -155,9 +181,150 @@ ssize_t FileInputDataSource::read(unsigned char *buf, size_t size)
 		return EOF;
 	}
 
+	{
+		std::lock_guard<std::mutex> lock(mIndexMutex);
+		if (mIndex) {
+			frame_index_feed(mIndex, mReadOffset, buf, rlen);
+		}
+	}
+	mReadOffset += rlen;
+
 	return rlen;
 }
 
+bool FileInputDataSource::seekTo(unsigned int msec)
+{
+	/* The input worker is stopped while seeking, the lock is for getDuration() */
+	std::lock_guard<std::mutex> lock(mIndexMutex);
+
+	if (!isPrepared() || !mIndex) {
+		meddbg("%s[line : %d] Fail : seek is not supported\n", __func__, __LINE__);
+		return false;
+	}
+
+	frame_index_entry_t entry;
+	if (!frame_index_lookup(mIndex, msec, &entry)) {
+		/* Beyond the part read so far, hop over the frame headers up to msec */
+		if (!frame_index_scan(mIndex, mFp, msec)) {
+			meddbg("%s[line : %d] Fail : %u ms is out of range, indexed %u ms\n", __func__, __LINE__, msec, frame_index_get_msec(mIndex));
+			return false;
+		}
+		saveIndex();
+
+		if (!frame_index_lookup(mIndex, msec, &entry)) {
+			return false;
+		}
+	}
+
+	if (fseek(mFp, entry.offset, SEEK_SET) != OK) {
+		meddbg("%s[line : %d] Fail : fseek errno : %d\n", __func__, __LINE__, errno);
+		return false;
+	}
+
+	clearerr(mFp);
+	mReadOffset = entry.offset;
+	medvdbg("seek to %u ms, frame at %u ms offset %u\n", msec, entry.msec, entry.offset);
+	return true;
+}
+
+int FileInputDataSource::getDuration()
+{
+	std::unique_lock<std::mutex> lock(mIndexMutex);
+
+	if (!isPrepared() || !mIndex) {
+		return -1;
+	}
+
+	if (mIndex->complete) {
+		return (int)frame_index_get_msec(mIndex);
+	}
+
+	int audioType = mIndex->audio_type;
+	lock.unlock();
+
+	/* The input worker may be reading mFp and feeding mIndex during playback.
+	 * Hop over the frame headers of a file and an index of our own instead,
+	 * and take the index in place of mIndex if it is complete.
+	 */
+	FILE *fp = fopen(mDataPath.c_str(), "rb");
+	if (!fp) {
+		meddbg("%s[line : %d] Fail : file open errno : %d\n", __func__, __LINE__, errno);
+		return -1;
+	}
+
+	frame_index_t *index = new frame_index_t;
+	if (frame_index_init(index, audioType) != AUDIO_DECODER_OK) {
+		delete index;
+		fclose(fp);
+		return -1;
+	}
+	frame_index_scan(index, fp, UINT32_MAX);
+	fclose(fp);
+
+	int duration = -1;
+	lock.lock();
+	if (mIndex && index->complete) {
+		if (!mIndex->complete) {
+			std::swap(mIndex, index);
+			saveIndex();
+		}
+		duration = (int)frame_index_get_msec(mIndex);
+	}
+	lock.unlock();
+
+	frame_index_finish(index);
+	delete index;
+	return duration;
+}
+
+void FileInputDataSource::openIndex()
+{
+	struct stat st;
+
+	mReadOffset = (size_t)ftell(mFp);
+	if (stat(mDataPath.c_str(), &st) != OK) {
+		return;
+	}
+	mFileSize = (size_t)st.st_size;
+	mMtime = st.st_mtime;
+
+	mIndex = new frame_index_t;
+	if (frame_index_init(mIndex, getAudioType()) != AUDIO_DECODER_OK) {
+		/* Format can't be indexed */
+		delete mIndex;
+		mIndex = nullptr;
+		return;
+	}
+
+#ifdef CONFIG_FILE_DATASOURCE_FRAME_INDEX_CACHE
+	std::string cachePath = mDataPath + FRAME_INDEX_CACHE_SUFFIX;
+	frame_index_load(mIndex, cachePath.c_str(), mFileSize, mMtime);
+#endif
+}
+
+void FileInputDataSource::saveIndex()
+{
+#ifdef CONFIG_FILE_DATASOURCE_FRAME_INDEX_CACHE
+	if (mIndex && mIndex->complete) {
+		std::string cachePath = mDataPath + FRAME_INDEX_CACHE_SUFFIX;
+		struct stat st;
+		/* Written once, an existing cache was either loaded or is stale and replaced here */
+		if (stat(cachePath.c_str(), &st) != OK || st.st_mtime < mMtime) {
+			frame_index_save(mIndex, cachePath.c_str(), mFileSize, mMtime);
+		}
+	}
+#endif
+}
+
+void FileInputDataSource::closeIndex()
+{
+	if (mIndex) {
+		frame_index_finish(mIndex);
+		delete mIndex;
+		mIndex = nullptr;
+	}
+}
+
 FileInputDataSource::~FileInputDataSource()
 {
 	if (isPrepared()) {
@@ -19,12 +19,15 @@
 #include <tinyara/config.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 #include <debug.h>
 #include <media/FileOutputDataSource.h>
 #include "utils/MediaUtils.h"
 #include "Encoder.h"
+#include "MediaRecorderImpl.h"
 #include "StreamBuffer.h"
 #include "StreamBufferReader.h"
+#include "StreamBufferWriter.h"
 
 #ifndef CONFIG_FILE_DATASOURCE_STREAM_BUFFER_SIZE
 #define CONFIG_FILE_DATASOURCE_STREAM_BUFFER_SIZE 4096
@@ -34,21 +37,33 @@
 #define CONFIG_FILE_DATASOURCE_STREAM_BUFFER_THRESHOLD 2048
 #endif
 
+#ifndef CONFIG_FILE_OUTPUT_DATASOURCE_ALIGN
+#define CONFIG_FILE_OUTPUT_DATASOURCE_ALIGN 512
+#endif
+
+#ifndef CONFIG_OUTPUT_DATASOURCE_STACKSIZE
+#define CONFIG_OUTPUT_DATASOURCE_STACKSIZE 4096
+#endif
+
 namespace media {
 namespace stream {
 
 FileOutputDataSource::FileOutputDataSource(const std::string& dataPath)
-	: OutputDataSource(), mDataPath(dataPath), mFp(nullptr)
+	: OutputDataSource(), mDataPath(dataPath), mFp(nullptr), mWriter(0), mIsWriterAlive(false), mIsWriteFailed(false),
+	mFileOffset(0), mBufferLevel(0), mHighWaterMark(0), mOverrunCount(0), mFlushCount(0), mMaxFlushLatency(0), mTotalFlushLatency(0)
 {
 }
 
 FileOutputDataSource::FileOutputDataSource(unsigned int channels, unsigned int sampleRate, audio_format_type_t pcmFormat, const std::string& dataPath)
-	: OutputDataSource(channels, sampleRate, pcmFormat), mDataPath(dataPath), mFp(nullptr)
+	: OutputDataSource(channels, sampleRate, pcmFormat), mDataPath(dataPath), mFp(nullptr), mWriter(0), mIsWriterAlive(false), mIsWriteFailed(false),
+	mFileOffset(0), mBufferLevel(0), mHighWaterMark(0), mOverrunCount(0), mFlushCount(0), mMaxFlushLatency(0), mTotalFlushLatency(0)
 {
 }
 
+/* The copy shares the file but not the write queue, it writes synchronously */
 FileOutputDataSource::FileOutputDataSource(const FileOutputDataSource& source) :
-	OutputDataSource(source), mDataPath(source.mDataPath), mFp(source.mFp)
+	OutputDataSource(source), mDataPath(source.mDataPath), mFp(source.mFp), mWriter(0), mIsWriterAlive(false), mIsWriteFailed(false),
+	mFileOffset(0), mBufferLevel(0), mHighWaterMark(0), mOverrunCount(0), mFlushCount(0), mMaxFlushLatency(0), mTotalFlushLatency(0)
 {
 }
 
@@ -67,6 +82,9 @@ bool FileOutputDataSource::open()
 			return false;
 		}
 
+		/* The writer thread does the buffering, let chunks go to the file system as they are */
+		setvbuf(mFp, NULL, _IONBF, 0);
+
 		setAudioType(utils::getAudioTypeFromPath(mDataPath));
 		switch (getAudioType()) {
 		case AUDIO_TYPE_WAVE:
@@ -84,6 +102,12 @@ bool FileOutputDataSource::open()
 			/* Don't set any encoder for unsupported formats */
 			break;
 		}
+
+		long offset = ftell(mFp);
+		mFileOffset = offset > 0 ? (size_t)offset : 0;
+		if (!startWriter()) {
+			meddbg("writer start failed, write synchronously\n");
+		}
 	} else {
 		medvdbg("file already exists\n");
 		/** return true if mFp is not null, because it means it using now */
@@ -93,6 +117,9 @@ bool FileOutputDataSource::open()
 
 bool FileOutputDataSource::close()
 {
+	/* Drain the write queue before the header is updated */
+	stopWriter();
+
 	switch (getAudioType()) {
 		case AUDIO_TYPE_WAVE: {
 			fflush(mFp);
@@ -148,7 +175,183 @@ ssize_t FileOutputDataSource::write(unsigned char *buf, size_t size)
 		return EOF;
 	}
 
-	return fwrite(buf, sizeof(unsigned char), size, mFp);
+	if (!mIsWriterAlive) {
+		return fwrite(buf, sizeof(unsigned char), size, mFp);
+	}
+
+	if (mIsWriteFailed) {
+		return EOF;
+	}
+
+	/* Blocks while the queue is full, the observer reports the overrun */
+	size_t written = mBufferWriter->write(buf, size);
+	if (written < size && mIsWriteFailed) {
+		return EOF;
+	}
+
+	return (ssize_t)written;
+}
+
+bool FileOutputDataSource::startWriter()
+{
+	if (!mStreamBuffer) {
+		size_t align = CONFIG_FILE_OUTPUT_DATASOURCE_ALIGN;
+		/* Flush whole aligned chunks, and leave room to queue data while one is written */
+		size_t threshold = CONFIG_FILE_DATASOURCE_STREAM_BUFFER_THRESHOLD / align * align;
+		if (threshold == 0) {
+			threshold = align;
+		}
+
+		auto streamBuffer = StreamBuffer::Builder()
+								.setBufferSize(CONFIG_FILE_DATASOURCE_STREAM_BUFFER_SIZE)
+								.setThreshold(threshold)
+								.build();
+		if (!streamBuffer) {
+			meddbg("streamBuffer is nullptr!\n");
+			return false;
+		}
+
+		mStreamBuffer = streamBuffer;
+		mStreamBuffer->setObserver(this);
+		mBufferReader = std::make_shared<StreamBufferReader>(mStreamBuffer);
+		mBufferWriter = std::make_shared<StreamBufferWriter>(mStreamBuffer);
+	}
+
+	mStreamBuffer->reset();
+	mIsWriteFailed = false;
+	mBufferLevel = 0;
+	mHighWaterMark = 0;
+	mOverrunCount = 0;
+	{
+		std::lock_guard<std::mutex> lock(mStatsMutex);
+		mFlushCount = 0;
+		mMaxFlushLatency = 0;
+		mTotalFlushLatency = 0;
+	}
+
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, CONFIG_OUTPUT_DATASOURCE_STACKSIZE);
+	int ret = pthread_create(&mWriter, &attr, static_cast<pthread_startroutine_t>(FileOutputDataSource::writerMain), this);
+	if (ret != OK) {
+		meddbg("Fail to create FileWriter thread, return value : %d\n", ret);
+		return false;
+	}
+	pthread_setname_np(mWriter, "FileWriter");
+
+	mIsWriterAlive = true;
+	return true;
+}
+
+void FileOutputDataSource::stopWriter()
+{
+	if (!mIsWriterAlive) {
+		return;
+	}
+
+	// Writer flushes what is left and exits at the end of stream
+	mBufferWriter->setEndOfStream();
+	pthread_join(mWriter, NULL);
+	mIsWriterAlive = false;
+
+	auto stats = getStatistics();
+	medvdbg("high water %u/%u, overrun %u, flush %u, latency avg %uus max %uus\n",
+		stats.highWaterMark, stats.bufferSize, stats.overrunCount, stats.flushCount,
+		stats.avgFlushLatency, stats.maxFlushLatency);
+}
+
+bool FileOutputDataSource::flushChunk(unsigned char *chunk, size_t size)
+{
+	struct timespec begin;
+	struct timespec end;
+
+	clock_gettime(CLOCK_MONOTONIC, &begin);
+	size_t written = fwrite(chunk, sizeof(unsigned char), size, mFp);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	unsigned int latency = (unsigned int)((end.tv_sec - begin.tv_sec) * 1000000 + (end.tv_nsec - begin.tv_nsec) / 1000);
+	{
+		std::lock_guard<std::mutex> lock(mStatsMutex);
+		mFlushCount++;
+		mTotalFlushLatency += latency;
+		if (latency > mMaxFlushLatency) {
+			mMaxFlushLatency = latency;
+		}
+	}
+
+	mFileOffset += written;
+	if (written != size) {
+		meddbg("fwrite failed, size : %u, written : %u, errno : %d\n", size, written, errno);
+		return false;
+	}
+
+	return true;
+}
+
+void *FileOutputDataSource::writerMain(void *arg)
+{
+	auto source = static_cast<FileOutputDataSource *>(arg);
+	size_t chunkSize = source->mStreamBuffer->getThreshold();
+	auto chunk = new unsigned char[chunkSize];
+
+	while (1) {
+		// Only the first chunk is shortened, to bring the file offset to an aligned boundary
+		size_t size = chunkSize - source->mFileOffset % CONFIG_FILE_OUTPUT_DATASOURCE_ALIGN;
+
+		// Waits for a full chunk, or returns what is left at the end of stream
+		size_t len = source->mBufferReader->read(chunk, size);
+		if (len > 0 && !source->flushChunk(chunk, len)) {
+			source->mIsWriteFailed = true;
+			// Release a write() blocked on the full queue
+			source->mBufferWriter->setEndOfStream();
+			break;
+		}
+
+		if (len < size) {
+			break;
+		}
+	}
+
+	delete[] chunk;
+	medvdbg("FileWriter exit\n");
+	return NULL;
+}
+
+FileOutputDataSource::Statistics FileOutputDataSource::getStatistics()
+{
+	Statistics stats;
+	std::lock_guard<std::mutex> lock(mStatsMutex);
+	stats.bufferSize = mStreamBuffer ? mStreamBuffer->getBufferSize() : 0;
+	stats.bufferLevel = mBufferLevel;
+	stats.highWaterMark = mHighWaterMark;
+	stats.overrunCount = mOverrunCount;
+	stats.flushCount = mFlushCount;
+	stats.maxFlushLatency = mMaxFlushLatency;
+	stats.avgFlushLatency = mFlushCount ? (unsigned int)(mTotalFlushLatency / mFlushCount) : 0;
+	return stats;
+}
+
+void FileOutputDataSource::onBufferOverrun()
+{
+	// Called with the stream buffer locked, write() is about to wait for the writer thread
+	mOverrunCount++;
+	auto mr = getRecorder();
+	if (mr) {
+		mr->notifyObserver(RECORDER_OBSERVER_COMMAND_BUFFER_OVERRUN);
+	}
+}
+
+void FileOutputDataSource::onBufferUnderrun()
+{
+	// The writer thread waiting for a full chunk is the normal state of a file sink
+}
+
+void FileOutputDataSource::onBufferUpdated(ssize_t change, size_t current)
+{
+	mBufferLevel = current;
+	if (current > mHighWaterMark) {
+		mHighWaterMark = current;
+	}
 }
 
 FileOutputDataSource::~FileOutputDataSource()
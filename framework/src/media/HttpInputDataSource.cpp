@@ -23,7 +23,9 @@
 #include <debug.h>
 #include <unistd.h>
 #include <assert.h>
+#include <strings.h>
 #include <media/HttpInputDataSource.h>
+#include <algorithm>
 #include <chrono>
 
 #include "utils/MediaUtils.h"
@@ -45,24 +47,74 @@
 #define CONFIG_HTTPSOURCE_DOWNLOAD_STACKSIZE 8192
 #endif
 
+#ifndef CONFIG_HTTPSOURCE_RETRY_COUNT
+#define CONFIG_HTTPSOURCE_RETRY_COUNT 3
+#endif
+
+#ifndef CONFIG_HTTPSOURCE_PREFETCH_TIME_MS
+#define CONFIG_HTTPSOURCE_PREFETCH_TIME_MS 500
+#endif
+
+#ifndef CONFIG_HTTPSOURCE_LOW_SPEED_TIMEOUT
+#define CONFIG_HTTPSOURCE_LOW_SPEED_TIMEOUT 5
+#endif
+
 namespace media {
 namespace stream {
 
-// Content-Type tag
+// Response header tags
 static const std::string TAG_CONTENT_TYPE = "Content-Type:";
+static const std::string TAG_CONTENT_LENGTH = "Content-Length:";
+static const std::string TAG_CONTENT_RANGE = "Content-Range:";
+static const std::string TAG_ACCEPT_RANGES = "Accept-Ranges:";
+static const std::string TAG_HTTP_STATUS = "HTTP/";
+
+static const long HTTP_STATUS_OK = 200;
+static const long HTTP_STATUS_PARTIAL_CONTENT = 206;
 
 static const std::chrono::seconds WAIT_HEADER_TIMEOUT = std::chrono::seconds(3);
 static const std::chrono::seconds WAIT_DATA_TIMEOUT = std::chrono::seconds(3);
+static const std::chrono::milliseconds RETRY_INTERVAL = std::chrono::milliseconds(500);
+// Throughput is sampled over windows of this length
+static const std::chrono::milliseconds RATE_WINDOW = std::chrono::milliseconds(500);
+
+static bool startsWithTag(const std::string &header, const std::string &tag)
+{
+	// HTTP header names are case-insensitive
+	return strncasecmp(header.c_str(), tag.c_str(), tag.length()) == 0;
+}
+
+/* Folds the bytes counted since mark into a smoothed bytes-per-second rate */
+template <typename TimePoint>
+static bool accumulateRate(size_t &rate, size_t &bytes, TimePoint &mark)
+{
+	auto now = TimePoint::clock::now();
+	auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - mark);
+	if (elapsed < RATE_WINDOW) {
+		return false;
+	}
+
+	size_t sample = (size_t)((uint64_t)bytes * 1000 / elapsed.count());
+	rate = (rate == 0) ? sample : (rate * 3 + sample) / 4;
+	bytes = 0;
+	mark = now;
+	return true;
+}
 
 HttpInputDataSource::HttpInputDataSource(const std::string &url)
-	: InputDataSource(), mUrl(url), mThread((pthread_t)0)
+	: InputDataSource(), mUrl(url), mThread((pthread_t)0), mIsHeaderReceived(false), mIsDataReceived(false),
+	mIsStopped(false), mSeekPending(false), mIsWorkerParked(false), mIsSeekRefill(false), mIsDownloadDone(false),
+	mSeekOffset(0), mIsRangeSupported(false), mContentLength(-1), mRequestOffset(0), mSkipBytes(0),
+	mWriteOffset(0), mReadOffset(0), mBufferLevel(0), mPrefetchDepth(0), mIsRebuffering(false),
+	mRebufferCount(0), mResumeCount(0), mDownloadRate(0), mConsumeRate(0), mDownloadBytes(0), mConsumeBytes(0)
 {
 	medvdbg("url: %s\n", mUrl.c_str());
 }
 
 HttpInputDataSource::HttpInputDataSource(const HttpInputDataSource &source)
-	: InputDataSource(source), mUrl(source.mUrl), mThread((pthread_t)0)
+	: HttpInputDataSource(source.mUrl)
 {
+	InputDataSource::operator=(source);
 }
 
 HttpInputDataSource &HttpInputDataSource::operator=(const HttpInputDataSource &source)
@@ -107,6 +159,25 @@ bool HttpInputDataSource::open()
 	std::unique_lock<std::mutex> lock(mMutex);
 	mIsHeaderReceived = false;
 	mIsDataReceived = false;
+	mIsStopped = false;
+	mSeekPending = false;
+	mIsWorkerParked = false;
+	mIsSeekRefill = false;
+	mIsDownloadDone = false;
+	mIsRangeSupported = false;
+	mContentLength = -1;
+	mWriteOffset = 0;
+	mReadOffset = 0;
+	mBufferLevel = 0;
+	mPrefetchDepth = mStreamBuffer->getThreshold();
+	mIsRebuffering = false;
+	mRebufferCount = 0;
+	mResumeCount = 0;
+	mDownloadRate = 0;
+	mConsumeRate = 0;
+	mDownloadBytes = 0;
+	mConsumeBytes = 0;
+	mDownloadMark = mConsumeMark = Clock::now();
 
 	pthread_attr_t attr;
 	pthread_attr_init(&attr);
@@ -140,6 +211,8 @@ bool HttpInputDataSource::open()
 			mBufferWriter->setEndOfStream();
 			return false;
 		}
+		// Don't hold mMutex while accessing the stream buffer, see onBufferUpdated()
+		lock.unlock();
 
 		size_t templen = mBufferReader->sizeOfData();
 		unsigned char *tempbuf = new unsigned char[templen];
@@ -182,6 +255,12 @@ bool HttpInputDataSource::open()
 bool HttpInputDataSource::close()
 {
 	medvdbg("HttpInputDataSource::close enter\n");
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mIsStopped = true;
+		mCondv.notify_all();
+	}
+
 	if (mBufferWriter) {
 		mBufferWriter->setEndOfStream();
 	}
@@ -217,15 +296,139 @@ ssize_t HttpInputDataSource::read(unsigned char *buf, size_t size)
 		return EOF;
 	}
 
-	size_t rlen = 0;
-	if (mBufferReader) {
-		rlen = mBufferReader->read(buf, size);
+	if (mBufferReader->sizeOfData() < size && !mBufferReader->isEndOfStream()) {
+		/*
+		 * Underrun: wait until the buffer is refilled up to the prefetch depth
+		 * instead of handing out data in small pieces as soon as it arrives.
+		 */
+		std::unique_lock<std::mutex> lock(mMutex);
+		if (!mIsSeekRefill) {
+			mRebufferCount++;
+			mPrefetchDepth = std::min(mPrefetchDepth * 2, mStreamBuffer->getBufferSize());
+			medvdbg("rebuffering, count %u depth %u\n", mRebufferCount, (size_t)mPrefetchDepth);
+		}
+		mIsRebuffering = true;
+		mCondv.wait(lock, [=] { return mBufferLevel >= mPrefetchDepth || mIsDownloadDone || mIsStopped; });
+		mIsRebuffering = false;
+		mIsSeekRefill = false;
+		// Time spent waiting for the network isn't consumption
+		mConsumeBytes = 0;
+		mConsumeMark = Clock::now();
+	}
+
+	size_t rlen = mBufferReader->read(buf, size);
+	mReadOffset += rlen;
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mConsumeBytes += rlen;
+		if (accumulateRate(mConsumeRate, mConsumeBytes, mConsumeMark)) {
+			updatePrefetchDepth();
+		}
 	}
 
 	medvdbg("read size: %d\n", rlen);
 	return rlen;
 }
 
+bool HttpInputDataSource::seek(size_t offset)
+{
+	if (!isPrepared()) {
+		meddbg("[line:%d] Fail : HttpInputDataSource is not prepared\n", __LINE__);
+		return false;
+	}
+
+	size_t position = mReadOffset;
+	if (offset >= position && offset - position < mBufferReader->sizeOfData()) {
+		// Target is already downloaded, just drop the data in front of it
+		mBufferReader->read(nullptr, offset - position, false);
+		mReadOffset = offset;
+		return true;
+	}
+
+	ssize_t length = mContentLength;
+	if (length < 0 || offset >= (size_t)length) {
+		meddbg("seek to %u failed, content length %d\n", offset, length);
+		return false;
+	}
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	mSeekOffset = offset;
+	mSeekPending = true;
+	mCondv.notify_all();
+	lock.unlock();
+
+	// Abort the running transfer, this also wakes a writer blocked on a full buffer
+	mBufferWriter->setEndOfStream();
+
+	lock.lock();
+	mCondv.wait(lock, [=] { return mIsWorkerParked || mIsStopped; });
+	if (mIsStopped) {
+		return false;
+	}
+	lock.unlock();
+
+	// No transfer is running now, flush the buffer (this also clears end-of-stream)
+	{
+		std::lock_guard<std::mutex> streamLock(mStreamBuffer->getMutex());
+		mStreamBuffer->reset();
+	}
+
+	lock.lock();
+	mWriteOffset = offset;
+	mReadOffset = offset;
+	mBufferLevel = 0;
+	mIsDownloadDone = false;
+	mIsSeekRefill = true;
+	mSeekPending = false;
+	mCondv.notify_all();
+	medvdbg("seek to %u, range request %s\n", offset, mIsRangeSupported ? "Y" : "N");
+	return true;
+}
+
+ssize_t HttpInputDataSource::getContentLength()
+{
+	return mContentLength;
+}
+
+HttpInputDataSource::Statistics HttpInputDataSource::getStatistics()
+{
+	Statistics stats;
+	std::lock_guard<std::mutex> lock(mMutex);
+	stats.bufferSize = mStreamBuffer ? mStreamBuffer->getBufferSize() : 0;
+	stats.bufferLevel = mBufferLevel;
+	stats.prefetchDepth = mPrefetchDepth;
+	stats.rebufferCount = mRebufferCount;
+	stats.resumeCount = mResumeCount;
+	stats.downloadRate = mDownloadRate;
+	stats.consumeRate = mConsumeRate;
+	stats.position = mReadOffset;
+	return stats;
+}
+
+void HttpInputDataSource::updatePrefetchDepth()
+{
+	// Called with mMutex held
+	if (mConsumeRate == 0) {
+		return;
+	}
+
+	size_t minDepth = mStreamBuffer->getThreshold();
+	size_t maxDepth = mStreamBuffer->getBufferSize();
+	size_t depth;
+
+	if ((uint64_t)mDownloadRate * 10 < (uint64_t)mConsumeRate * 9) {
+		// Network can't keep up with the decoder, buffer as much as possible before resuming
+		depth = maxDepth;
+	} else {
+		// Cover CONFIG_HTTPSOURCE_PREFETCH_TIME_MS of playback, and back off slowly after rebuffering
+		depth = (size_t)((uint64_t)mConsumeRate * CONFIG_HTTPSOURCE_PREFETCH_TIME_MS / 1000);
+		depth = std::max(depth, mPrefetchDepth * 3 / 4);
+	}
+
+	mPrefetchDepth = std::min(std::max(depth, minDepth), maxDepth);
+}
+
 void HttpInputDataSource::onBufferOverrun()
 {
 }
@@ -236,6 +439,12 @@ void HttpInputDataSource::onBufferUnderrun()
 
 void HttpInputDataSource::onBufferUpdated(ssize_t change, size_t current)
 {
+	mBufferLevel = current;
+	if (mIsRebuffering && current >= mPrefetchDepth) {
+		std::lock_guard<std::mutex> lock(mMutex);
+		mCondv.notify_all();
+	}
+
 	if (!mIsDataReceived) {
 		if (current >= mStreamBuffer->getThreshold()) {
 			medvdbg("Enough data received!\n");
@@ -249,7 +458,7 @@ void HttpInputDataSource::onBufferUpdated(ssize_t change, size_t current)
 size_t HttpInputDataSource::HeaderCallback(char *data, size_t size, size_t nmemb, void *userp)
 {
 	auto source = static_cast<HttpInputDataSource *>(userp);
-	if (source->mBufferReader->isEndOfStream()) {
+	if (source->mIsStopped || source->mSeekPending || source->mBufferReader->isEndOfStream()) {
 		medwdbg("end-of-stream:true\n");
 		return 0;
 	}
@@ -257,7 +466,31 @@ size_t HttpInputDataSource::HeaderCallback(char *data, size_t size, size_t nmemb
 	size_t totalsize = size * nmemb;
 	std::string header(data, totalsize);
 	medvdbg("%s\n", header.c_str());
-	if (header.find(TAG_CONTENT_TYPE) != std::string::npos) {
+	if (startsWithTag(header, TAG_HTTP_STATUS)) {
+		size_t pos = header.find(' ');
+		long status = (pos == std::string::npos) ? 0 : strtol(header.c_str() + pos + 1, NULL, 10);
+		if (status == HTTP_STATUS_PARTIAL_CONTENT) {
+			source->mIsRangeSupported = true;
+			source->mSkipBytes = 0;
+		} else if (status == HTTP_STATUS_OK && source->mRequestOffset > 0) {
+			// Range was ignored, the body starts from the beginning of the resource
+			source->mIsRangeSupported = false;
+			source->mSkipBytes = source->mRequestOffset;
+		}
+	} else if (startsWithTag(header, TAG_ACCEPT_RANGES)) {
+		source->mIsRangeSupported = (header.find("bytes", TAG_ACCEPT_RANGES.length()) != std::string::npos);
+	} else if (startsWithTag(header, TAG_CONTENT_RANGE)) {
+		// Content-Range: bytes <first>-<last>/<total>
+		size_t pos = header.find('/');
+		if (pos != std::string::npos && isdigit((unsigned char)header[pos + 1])) {
+			source->mContentLength = (ssize_t)strtol(header.c_str() + pos + 1, NULL, 10);
+		}
+	} else if (startsWithTag(header, TAG_CONTENT_LENGTH)) {
+		// Only a full response tells the length of the whole resource
+		if (source->mRequestOffset == 0 || source->mSkipBytes > 0) {
+			source->mContentLength = (ssize_t)strtol(header.c_str() + TAG_CONTENT_LENGTH.length(), NULL, 10);
+		}
+	} else if (startsWithTag(header, TAG_CONTENT_TYPE)) {
 		source->mContentType = header.substr(TAG_CONTENT_TYPE.length());
 		if (!source->mIsHeaderReceived) {
 			std::lock_guard<std::mutex> lock(source->mMutex);
@@ -272,8 +505,51 @@ size_t HttpInputDataSource::HeaderCallback(char *data, size_t size, size_t nmemb
 size_t HttpInputDataSource::WriteCallback(char *data, size_t size, size_t nmemb, void *userp)
 {
 	auto source = static_cast<HttpInputDataSource *>(userp);
+	if (source->mIsStopped || source->mSeekPending) {
+		// Abort the transfer
+		return 0;
+	}
+
 	size_t totalsize = size * nmemb;
-	return source->mBufferWriter->write((unsigned char *)data, totalsize);
+	unsigned char *ptr = (unsigned char *)data;
+	size_t len = totalsize;
+
+	if (source->mSkipBytes > 0) {
+		// Server ignored the Range request, drop data in front of the requested offset
+		size_t skip = std::min(source->mSkipBytes, len);
+		source->mSkipBytes -= skip;
+		ptr += skip;
+		len -= skip;
+		if (len == 0) {
+			return totalsize;
+		}
+	}
+
+	size_t written = source->mBufferWriter->write(ptr, len);
+	source->mWriteOffset += written;
+
+	{
+		std::lock_guard<std::mutex> lock(source->mMutex);
+		source->mDownloadBytes += written;
+		if (accumulateRate(source->mDownloadRate, source->mDownloadBytes, source->mDownloadMark)) {
+			source->updatePrefetchDepth();
+		}
+	}
+
+	// A short count makes curl abort the transfer
+	return (totalsize - len) + written;
+}
+
+bool HttpInputDataSource::startTransfer(size_t offset)
+{
+	mRequestOffset = offset;
+	mSkipBytes = 0;
+
+	if (!mHttpStream->setRange(offset)) {
+		return false;
+	}
+
+	return mHttpStream->download(mUrl);
 }
 
 void *HttpInputDataSource::workerMain(void *arg)
@@ -284,10 +560,69 @@ void *HttpInputDataSource::workerMain(void *arg)
 	//mHttpStream->addHeader("Icy-MetaData:1"); // not support now
 	source->mHttpStream->setHeaderCallback(HeaderCallback, arg);
 	source->mHttpStream->setWriteCallback(WriteCallback, arg);
-	if (!source->mHttpStream->download(source->mUrl)) {
-		medwdbg("download failed or terminated!\n");
-		// TODO: send network error code to upper layer later
+	// Detect a stalled connection, so that the transfer can be resumed
+	source->mHttpStream->setLowSpeedLimit(1, CONFIG_HTTPSOURCE_LOW_SPEED_TIMEOUT);
+
+	size_t offset = 0;
+	int retry = 0;
+
+	std::unique_lock<std::mutex> lock(source->mMutex);
+	while (!source->mIsStopped) {
+		if (source->mSeekPending) {
+			// Park until seek() has flushed the buffer, then restart from the new offset
+			source->mIsWorkerParked = true;
+			source->mCondv.notify_all();
+			source->mCondv.wait(lock, [=] { return !source->mSeekPending || source->mIsStopped; });
+			source->mIsWorkerParked = false;
+			offset = source->mSeekOffset;
+			retry = 0;
+			continue;
+		}
+
+		size_t written = source->mWriteOffset;
+		lock.unlock();
+		bool done = source->startTransfer(offset);
+		lock.lock();
+
+		if (source->mIsStopped || source->mSeekPending) {
+			continue;
+		}
+
+		ssize_t length = source->mContentLength;
+		bool complete = done && (length < 0 || source->mWriteOffset >= (size_t)length);
+		if (!complete && source->mWriteOffset > written) {
+			// Transfer made progress before it dropped
+			retry = 0;
+		}
+
+		if (complete || retry >= CONFIG_HTTPSOURCE_RETRY_COUNT) {
+			if (!complete) {
+				medwdbg("download failed or terminated!\n");
+				// TODO: send network error code to upper layer later
+			}
+			source->mIsDownloadDone = true;
+			source->mCondv.notify_all();
+			lock.unlock();
+			source->mBufferWriter->setEndOfStream();
+			lock.lock();
+			// Stay alive, a seek may restart the transfer
+			source->mCondv.wait(lock, [=] { return source->mSeekPending || source->mIsStopped; });
+			continue;
+		}
+
+		retry++;
+		source->mResumeCount++;
+		medwdbg("transfer dropped at %u, retry %d\n", (size_t)source->mWriteOffset, retry);
+		source->mCondv.wait_for(lock, RETRY_INTERVAL * retry, [=] { return source->mSeekPending || source->mIsStopped; });
+
+		if (length < 0 && !source->mIsRangeSupported) {
+			// Live stream, just reconnect
+			offset = 0;
+		} else {
+			offset = source->mWriteOffset;
+		}
 	}
+	lock.unlock();
 
 	source->mBufferWriter->setEndOfStream();
 	medvdbg("download thread exit!\n");
@@ -18,6 +18,7 @@
 
 #include <curl/curl.h>
 #include <curl/easy.h>
+#include <stdio.h>
 #include <debug.h>
 
 #include "HttpStream.h"
@@ -88,6 +89,27 @@ bool HttpStream::setReadCallback(CallbackFunc callback, void *userdata)
 	return true;
 }
 
+bool HttpStream::setRange(size_t offset)
+{
+	if (offset == 0) {
+		SET_OPTION(mCurl, CURLOPT_RANGE, (char *)NULL);
+		return true;
+	}
+
+	char range[24];
+	snprintf(range, sizeof(range), "%lu-", (unsigned long)offset);
+	/* libcurl copies the string, so a local buffer is fine here */
+	SET_OPTION(mCurl, CURLOPT_RANGE, range);
+	return true;
+}
+
+bool HttpStream::setLowSpeedLimit(long bytesPerSec, long seconds)
+{
+	SET_OPTION(mCurl, CURLOPT_LOW_SPEED_LIMIT, bytesPerSec);
+	SET_OPTION(mCurl, CURLOPT_LOW_SPEED_TIME, seconds);
+	return true;
+}
+
 bool HttpStream::init()
 {
 	if (mInitializeCount == 0) {
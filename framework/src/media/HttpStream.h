@@ -65,6 +65,18 @@ public:
 	 */
 	bool setReadCallback(CallbackFunc callback, void *userdata);
 
+	/*
+	 * Requests the resource starting from the given byte offset (HTTP Range).
+	 * Offset 0 clears the range and requests the whole resource.
+	 */
+	bool setRange(size_t offset);
+
+	/*
+	 * Aborts the transfer if it stays below bytesPerSec for the given seconds,
+	 * so that a stalled connection is reported instead of blocking forever.
+	 */
+	bool setLowSpeedLimit(long bytesPerSec, long seconds);
+
 	/*
 	 * Sets the callback for uploading local data
 	 */
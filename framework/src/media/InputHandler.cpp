@@ -144,6 +144,26 @@ bool InputHandler::stop()
 	return true;
 }
 
+bool InputHandler::seekTo(unsigned int msec)
+{
+	if (!mInputDataSource->isPrepared()) {
+		return false;
+	}
+
+	// Worker must not read while the source is repositioned
+	destroyWorker();
+
+	bool ret = mInputDataSource->seekTo(msec);
+	if (ret && mDecoder) {
+		// Drop the data of the old position buffered in the decoder
+		ret = mDecoder->reset();
+	}
+
+	// Stream buffer is emptied when the worker is created again
+	createWorker();
+	return ret;
+}
+
 void InputHandler::createWorker()
 {
 	medvdbg("InputHandler::createWorker()\n");
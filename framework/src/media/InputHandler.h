@@ -53,6 +53,7 @@ public:
 	ssize_t read(unsigned char *buf, size_t size);
 	bool start();
 	bool stop();
+	bool seekTo(unsigned int msec);
 	void createWorker();
 	void destroyWorker();
 	static void *workerMain(void *arg);
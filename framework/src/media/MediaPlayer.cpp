@@ -82,6 +82,16 @@ player_result_t MediaPlayer::setVolume(uint8_t vol)
 	return mPMpImpl->setVolume(vol);
 }
 
+player_result_t MediaPlayer::seekTo(unsigned int msec)
+{
+	return mPMpImpl->seekTo(msec);
+}
+
+player_result_t MediaPlayer::getDuration(unsigned int *msec)
+{
+	return mPMpImpl->getDuration(msec);
+}
+
 player_result_t MediaPlayer::setDataSource(std::unique_ptr<stream::InputDataSource> source)
 {
 	return mPMpImpl->setDataSource(std::move(source));
@@ -518,6 +518,94 @@ void MediaPlayerImpl::setPlayerVolume(uint8_t vol, player_result_t &ret)
 	return notifySync();
 }
 
+player_result_t MediaPlayerImpl::seekTo(unsigned int msec)
+{
+	player_result_t ret = PLAYER_OK;
+
+	std::unique_lock<std::mutex> lock(mCmdMtx);
+	medvdbg("MediaPlayer seekTo %u\n", msec);
+
+	PlayerWorker &mpw = PlayerWorker::getWorker();
+	if (!mpw.isAlive()) {
+		meddbg("PlayerWorker is not alive\n");
+		return PLAYER_ERROR_NOT_ALIVE;
+	}
+
+	mpw.enQueue(&MediaPlayerImpl::seekPlayer, shared_from_this(), msec, std::ref(ret));
+	mSyncCv.wait(lock);
+
+	return ret;
+}
+
+void MediaPlayerImpl::seekPlayer(unsigned int msec, player_result_t &ret)
+{
+	LOG_STATE_INFO(mCurState);
+
+	if (mCurState != PLAYER_STATE_READY && mCurState != PLAYER_STATE_PLAYING && mCurState != PLAYER_STATE_PAUSED) {
+		meddbg("%s Fail : invalid state\n", __func__);
+		LOG_STATE_DEBUG(mCurState);
+		ret = PLAYER_ERROR_INVALID_STATE;
+		return notifySync();
+	}
+
+	/* Runs on the worker thread, so playback() doesn't read while the input is repositioned */
+	if (!mInputHandler.seekTo(msec)) {
+		meddbg("MediaPlayer seekTo %u failed\n", msec);
+		ret = PLAYER_ERROR_INVALID_OPERATION;
+		return notifySync();
+	}
+
+	ret = PLAYER_OK;
+	return notifySync();
+}
+
+player_result_t MediaPlayerImpl::getDuration(unsigned int *msec)
+{
+	player_result_t ret = PLAYER_OK;
+
+	std::unique_lock<std::mutex> lock(mCmdMtx);
+	medvdbg("MediaPlayer getDuration\n");
+
+	if (msec == nullptr) {
+		meddbg("The given argument is invalid.\n");
+		return PLAYER_ERROR_INVALID_PARAMETER;
+	}
+
+	PlayerWorker &mpw = PlayerWorker::getWorker();
+	if (!mpw.isAlive()) {
+		meddbg("PlayerWorker is not alive\n");
+		return PLAYER_ERROR_NOT_ALIVE;
+	}
+
+	mpw.enQueue(&MediaPlayerImpl::getPlayerDuration, shared_from_this(), msec, std::ref(ret));
+	mSyncCv.wait(lock);
+
+	return ret;
+}
+
+void MediaPlayerImpl::getPlayerDuration(unsigned int *msec, player_result_t &ret)
+{
+	medvdbg("MediaPlayer Worker : getDuration\n");
+
+	if (mCurState != PLAYER_STATE_READY && mCurState != PLAYER_STATE_PLAYING && mCurState != PLAYER_STATE_PAUSED) {
+		meddbg("%s Fail : invalid state\n", __func__);
+		LOG_STATE_DEBUG(mCurState);
+		ret = PLAYER_ERROR_INVALID_STATE;
+		return notifySync();
+	}
+
+	int duration = mInputHandler.getInputDataSource()->getDuration();
+	if (duration < 0) {
+		meddbg("duration of the data source is unknown\n");
+		ret = PLAYER_ERROR_INVALID_OPERATION;
+		return notifySync();
+	}
+
+	*msec = (unsigned int)duration;
+	ret = PLAYER_OK;
+	return notifySync();
+}
+
 player_result_t MediaPlayerImpl::setDataSource(std::unique_ptr<stream::InputDataSource> source)
 {
 	player_result_t ret = PLAYER_OK;
@@ -0,0 +1,612 @@
+/******************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/*
+ * Host benchmark of the media codec wrappers.
+ *
+ * Every corpus signal is encoded with opus_frameEncode() and the packets are
+ * decoded again with opus_frameDecode(), for several sample rates, frame sizes
+ * and complexities. Each pass runs in its own thread on a painted stack, so
+ * that CPU time, peak heap (libopus is built with USE_SHAREDPTR, so its scratch
+ * memory comes from operator new like on the target) and peak stack can be
+ * reported per pass. Results are written as JSON.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <string>
+
+#include "../codecs/opus_encoder_api.h"
+#include "../codecs/opus_decoder_api.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BENCH_STACK_SIZE        (256 * 1024)
+#define BENCH_STACK_PAINT       0xa5
+#define BENCH_DEFAULT_DURATION  10
+
+// Opus packet header used by the wrappers: 4 bytes syncword + 4 bytes packet length
+#define OPUS_PACKET_HEADER_LEN  8
+#define OPUS_MAX_PAYLOAD        1500
+// 120ms of 48kHz stereo is the largest frame the decoder can return
+#define OPUS_MAX_FRAME_SAMPLES  (48000 * 120 / 1000 * 2)
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/****************************************************************************
+ * Heap accounting
+ ****************************************************************************/
+
+static size_t g_heap_current;
+static size_t g_heap_peak;
+
+static void *bench_alloc(size_t size)
+{
+	std::max_align_t *p = (std::max_align_t *)malloc(size + sizeof(std::max_align_t));
+	if (p == NULL) {
+		throw std::bad_alloc();
+	}
+
+	*(size_t *)p = size;
+	g_heap_current += size;
+	if (g_heap_current > g_heap_peak) {
+		g_heap_peak = g_heap_current;
+	}
+	return p + 1;
+}
+
+static void bench_free(void *ptr)
+{
+	if (ptr == NULL) {
+		return;
+	}
+
+	std::max_align_t *p = (std::max_align_t *)ptr - 1;
+	g_heap_current -= *(size_t *)p;
+	free(p);
+}
+
+void *operator new(size_t size)
+{
+	return bench_alloc(size);
+}
+
+void *operator new[](size_t size)
+{
+	return bench_alloc(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+	bench_free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+	bench_free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+	bench_free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+	bench_free(ptr);
+}
+
+/****************************************************************************
+ * Corpus
+ ****************************************************************************/
+
+struct bench_signal {
+	std::string name;
+	int sample_rate;
+	int channels;
+	std::vector<int16_t> pcm;
+};
+
+static uint32_t g_seed = 0x12345678;
+
+static float noise(void)
+{
+	// xorshift32, reproducible across runs and hosts
+	g_seed ^= g_seed << 13;
+	g_seed ^= g_seed >> 17;
+	g_seed ^= g_seed << 5;
+	return (float)(int32_t)g_seed / 2147483648.0f;
+}
+
+static int16_t clip16(float v)
+{
+	if (v > 32767.0f) {
+		return 32767;
+	}
+	if (v < -32768.0f) {
+		return -32768;
+	}
+	return (int16_t)v;
+}
+
+/* Voiced harmonics with pitch vibrato and a syllable-rate envelope, plus breath noise */
+static float gen_speech(int n, int rate, float *phase)
+{
+	float t = (float)n / rate;
+	float f0 = 120.0f + 20.0f * sinf(2 * M_PI * 0.7f * t);
+	float env = 0.5f + 0.5f * sinf(2 * M_PI * 4.0f * t);
+	float v = 0.0f;
+
+	*phase += 2 * M_PI * f0 / rate;
+	for (int h = 1; h <= 20 && h * f0 < rate / 2; h++) {
+		v += sinf(h * *phase) / h;
+	}
+	return (env * env * 6000.0f * v) + 300.0f * noise();
+}
+
+/* A three-note chord with decaying overtones, retriggered every half second */
+static float gen_music(int n, int rate, float *phase)
+{
+	static const float notes[] = { 261.63f, 329.63f, 392.00f };
+	float t = (float)n / rate;
+	float env = expf(-3.0f * fmodf(t, 0.5f));
+	float v = 0.0f;
+
+	(void)phase;
+	for (unsigned i = 0; i < sizeof(notes) / sizeof(notes[0]); i++) {
+		for (int h = 1; h <= 6 && h * notes[i] < rate / 2; h++) {
+			v += sinf(2 * M_PI * h * notes[i] * t) / (h * h);
+		}
+	}
+	return env * 7000.0f * v + 50.0f * noise();
+}
+
+static float gen_noise(int n, int rate, float *phase)
+{
+	(void)n;
+	(void)rate;
+	(void)phase;
+	return 8000.0f * noise();
+}
+
+static void make_signal(bench_signal &sig, float (*gen)(int, int, float *), int seconds)
+{
+	int frames = sig.sample_rate * seconds;
+	float phase = 0.0f;
+
+	sig.pcm.resize((size_t)frames * sig.channels);
+	for (int n = 0; n < frames; n++) {
+		float v = gen(n, sig.sample_rate, &phase);
+		for (int ch = 0; ch < sig.channels; ch++) {
+			// Slightly different channels, so that stereo coding has work to do
+			sig.pcm[(size_t)n * sig.channels + ch] = clip16(ch ? 0.8f * v + 200.0f * noise() : v);
+		}
+	}
+}
+
+static uint32_t le_num(const uint8_t *p, int bytes)
+{
+	uint32_t v = 0;
+	for (int i = bytes - 1; i >= 0; i--) {
+		v = (v << 8) | p[i];
+	}
+	return v;
+}
+
+/* Loads a 16-bit PCM WAV file as an additional test vector */
+static bool load_wav(const char *path, bench_signal &sig)
+{
+	FILE *fp = fopen(path, "rb");
+	if (fp == NULL) {
+		fprintf(stderr, "cannot open %s\n", path);
+		return false;
+	}
+
+	uint8_t hdr[12];
+	uint8_t chunk[8];
+	bool found_fmt = false;
+	bool ret = false;
+
+	if (fread(hdr, 1, 12, fp) != 12 || memcmp(hdr, "RIFF", 4) || memcmp(hdr + 8, "WAVE", 4)) {
+		fprintf(stderr, "%s is not a WAV file\n", path);
+		goto out;
+	}
+
+	while (fread(chunk, 1, 8, fp) == 8) {
+		uint32_t size = le_num(chunk + 4, 4);
+		if (!memcmp(chunk, "fmt ", 4)) {
+			uint8_t fmt[16];
+			if (size < 16 || fread(fmt, 1, 16, fp) != 16) {
+				goto out;
+			}
+			if (le_num(fmt, 2) != 1 || le_num(fmt + 14, 2) != 16) {
+				fprintf(stderr, "%s: only 16-bit PCM is supported\n", path);
+				goto out;
+			}
+			sig.channels = le_num(fmt + 2, 2);
+			sig.sample_rate = le_num(fmt + 4, 4);
+			fseek(fp, size - 16 + (size & 1), SEEK_CUR);
+			found_fmt = true;
+		} else if (!memcmp(chunk, "data", 4) && found_fmt) {
+			sig.pcm.resize(size / 2);
+			size_t n = fread(sig.pcm.data(), 2, sig.pcm.size(), fp);
+			sig.pcm.resize(n - n % sig.channels);
+			ret = sig.channels >= 1 && sig.channels <= 2;
+			break;
+		} else {
+			fseek(fp, size + (size & 1), SEEK_CUR);
+		}
+	}
+
+	sig.name = path;
+out:
+	fclose(fp);
+	return ret;
+}
+
+/****************************************************************************
+ * Measurement
+ ****************************************************************************/
+
+struct bench_case {
+	const bench_signal *sig;
+	int frame_ms;
+	int complexity;
+	int bitrate;
+	/* encoded packets, each one prefixed by the wrapper's packet header */
+	std::vector<uint8_t> stream;
+	std::vector<uint32_t> lengths;
+	int error;
+};
+
+struct bench_result {
+	double cpu_ms;
+	size_t peak_heap;
+	size_t peak_stack;
+};
+
+static double thread_cpu_ms(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+struct bench_job {
+	void *(*entry)(bench_case *c, double *cpu_ms);
+	bench_case *c;
+	double cpu_ms;
+};
+
+static void *bench_thread(void *arg)
+{
+	bench_job *job = (bench_job *)arg;
+	return job->entry(job->c, &job->cpu_ms);
+}
+
+static size_t g_stack_baseline;
+
+/* Runs entry on a painted stack and reports CPU time, peak heap and stack high-water mark */
+static int run_measured(void *(*entry)(bench_case *, double *), bench_case *c, bench_result *res)
+{
+	uint8_t *stack;
+	pthread_attr_t attr;
+	pthread_t tid;
+	bench_job job = { entry, c, 0.0 };
+
+	if (posix_memalign((void **)&stack, 4096, BENCH_STACK_SIZE) != 0) {
+		return -1;
+	}
+	memset(stack, BENCH_STACK_PAINT, BENCH_STACK_SIZE);
+
+	pthread_attr_init(&attr);
+	pthread_attr_setstack(&attr, stack, BENCH_STACK_SIZE);
+
+	size_t heap_base = g_heap_current;
+	g_heap_peak = g_heap_current;
+
+	if (pthread_create(&tid, &attr, bench_thread, &job) != 0) {
+		free(stack);
+		return -1;
+	}
+	pthread_join(tid, NULL);
+	pthread_attr_destroy(&attr);
+
+	// Stack grows down, so the untouched paint is at the low addresses
+	size_t untouched = 0;
+	while (untouched < BENCH_STACK_SIZE && stack[untouched] == BENCH_STACK_PAINT) {
+		untouched++;
+	}
+	free(stack);
+
+	res->cpu_ms = job.cpu_ms;
+	res->peak_heap = g_heap_peak - heap_base;
+	res->peak_stack = BENCH_STACK_SIZE - untouched;
+	if (res->peak_stack > g_stack_baseline) {
+		res->peak_stack -= g_stack_baseline;
+	}
+	return 0;
+}
+
+static void *empty_entry(bench_case *c, double *cpu_ms)
+{
+	(void)c;
+	*cpu_ms = 0.0;
+	return NULL;
+}
+
+static void *encode_entry(bench_case *c, double *cpu_ms)
+{
+	const bench_signal *sig = c->sig;
+	int frame_samples = sig->sample_rate * c->frame_ms / 1000;
+	size_t frame_len = (size_t)frame_samples * sig->channels;
+	uint8_t *mem = new uint8_t[opus_encoderMemRequirements()];
+	uint8_t *out = new uint8_t[OPUS_PACKET_HEADER_LEN + OPUS_MAX_PAYLOAD];
+	opus_enc_external_t ext;
+
+	memset(&ext, 0, sizeof(ext));
+	ext.applicationMode = (sig->name == "speech") ? OPUS_APPLICATION_VOIP : OPUS_APPLICATION_AUDIO;
+	ext.frameSizeMS = c->frame_ms;
+	ext.bitrate = c->bitrate;
+	ext.bandWidth = OPUS_AUTO;
+	ext.complexity = c->complexity;
+	ext.inputChannels = sig->channels;
+	ext.inputSampleRate = sig->sample_rate;
+	ext.pOutputBuffer = out;
+	ext.outputBufferMaxLength = OPUS_MAX_PAYLOAD;
+	ext.inputBufferMaxLength = frame_len * sizeof(int16_t);
+	ext.inputBufferCurrentLength = frame_len * sizeof(int16_t);
+
+	c->stream.clear();
+	c->lengths.clear();
+	c->error = opus_initEncoder(&ext, mem);
+
+	double start = thread_cpu_ms();
+	for (size_t pos = 0; c->error == OPUS_OK && pos + frame_len <= sig->pcm.size(); pos += frame_len) {
+		ext.pInputBuffer = (int16_t *)&sig->pcm[pos];
+		c->error = opus_frameEncode(&ext, mem);
+		// Keeping the packets is bookkeeping, not codec cost
+		double pause = thread_cpu_ms();
+		c->stream.insert(c->stream.end(), out, out + ext.outputDataSize);
+		c->lengths.push_back(ext.outputDataSize);
+		start += thread_cpu_ms() - pause;
+	}
+	*cpu_ms = thread_cpu_ms() - start;
+
+	opus_uninitEncoder(mem);
+	delete[] out;
+	delete[] mem;
+	return NULL;
+}
+
+static void *decode_entry(bench_case *c, double *cpu_ms)
+{
+	const bench_signal *sig = c->sig;
+	uint8_t *mem = new uint8_t[opus_decoderMemRequirements()];
+	int16_t *pcm = new int16_t[OPUS_MAX_FRAME_SAMPLES];
+	opus_dec_external_t ext;
+
+	memset(&ext, 0, sizeof(ext));
+	ext.desiredChannels = sig->channels;
+	ext.desiredSampleRate = sig->sample_rate;
+	ext.pOutputBuffer = pcm;
+	ext.outputBufferMaxLength = OPUS_MAX_FRAME_SAMPLES * sizeof(int16_t);
+
+	c->error = opus_initDecoder(&ext, mem);
+
+	double start = thread_cpu_ms();
+	size_t pos = 0;
+	for (size_t i = 0; c->error == OPUS_OK && i < c->lengths.size(); i++) {
+		ext.pInputBuffer = &c->stream[pos];
+		ext.inputBufferMaxLength = c->lengths[i];
+		ext.inputBufferCurrentLength = c->lengths[i];
+		c->error = opus_frameDecode(&ext, mem);
+		pos += c->lengths[i];
+	}
+	*cpu_ms = thread_cpu_ms() - start;
+
+	opus_uninitDecoder(mem);
+	delete[] pcm;
+	delete[] mem;
+	return NULL;
+}
+
+/****************************************************************************
+ * Main
+ ****************************************************************************/
+
+static void print_result(FILE *out, bool *first, const char *op, const bench_case *c, const bench_result *r)
+{
+	const bench_signal *sig = c->sig;
+	double audio_ms = (double)sig->pcm.size() / sig->channels * 1000.0 / sig->sample_rate;
+	double kbps = 0.0;
+
+	if (audio_ms > 0.0) {
+		kbps = (double)(c->stream.size() - c->lengths.size() * OPUS_PACKET_HEADER_LEN) * 8.0 / audio_ms;
+	}
+
+	fprintf(out, "%s\n    {\"codec\": \"opus\", \"op\": \"%s\", \"signal\": \"%s\", "
+			"\"sample_rate\": %d, \"channels\": %d, \"frame_ms\": %d, \"complexity\": %d, "
+			"\"bitrate\": %d, \"actual_kbps\": %.1f, \"audio_ms\": %.0f, \"cpu_ms\": %.3f, "
+			"\"realtime_factor\": %.5f, \"peak_heap\": %u, \"peak_stack\": %u, \"error\": %d}",
+			*first ? "" : ",", op, sig->name.c_str(), sig->sample_rate, sig->channels,
+			c->frame_ms, c->complexity, c->bitrate, kbps, audio_ms, r->cpu_ms,
+			audio_ms > 0.0 ? r->cpu_ms / audio_ms : 0.0,
+			(unsigned)r->peak_heap, (unsigned)r->peak_stack, c->error);
+	*first = false;
+}
+
+static void show_usage(const char *prog)
+{
+	fprintf(stderr, "Usage: %s [-d seconds] [-f frame_ms,...] [-c complexity,...] [-i file.wav]... [-o result.json]\n", prog);
+	fprintf(stderr, "  -d  length of the synthetic test vectors (default %d)\n", BENCH_DEFAULT_DURATION);
+	fprintf(stderr, "  -f  frame sizes in ms (default 10,20,40,60)\n");
+	fprintf(stderr, "  -c  encoder complexities (default 0,5,10)\n");
+	fprintf(stderr, "  -i  add a 16-bit PCM WAV file to the corpus\n");
+	fprintf(stderr, "  -o  write JSON to a file instead of stdout\n");
+}
+
+static std::vector<int> parse_list(const char *arg)
+{
+	std::vector<int> list;
+	char *end;
+
+	do {
+		list.push_back((int)strtol(arg, &end, 10));
+		arg = end + 1;
+	} while (*end == ',');
+
+	return list;
+}
+
+int main(int argc, char **argv)
+{
+	int seconds = BENCH_DEFAULT_DURATION;
+	std::vector<int> frame_sizes = { 10, 20, 40, 60 };
+	std::vector<int> complexities = { 0, 5, 10 };
+	std::vector<const char *> wav_files;
+	const char *out_path = NULL;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "d:f:c:i:o:h")) != -1) {
+		switch (opt) {
+		case 'd':
+			seconds = atoi(optarg);
+			break;
+		case 'f':
+			frame_sizes = parse_list(optarg);
+			break;
+		case 'c':
+			complexities = parse_list(optarg);
+			break;
+		case 'i':
+			wav_files.push_back(optarg);
+			break;
+		case 'o':
+			out_path = optarg;
+			break;
+		default:
+			show_usage(argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	/* Voice capture format and music playback format, as used by MediaRecorder/MediaPlayer */
+	static const struct {
+		const char *name;
+		float (*gen)(int, int, float *);
+		int sample_rate;
+		int channels;
+		int bitrate;
+	} synthetic[] = {
+		{ "speech", gen_speech, 16000, 1, 24000 },
+		{ "music", gen_music, 48000, 2, 96000 },
+		{ "noise", gen_noise, 16000, 1, 24000 },
+		{ "noise", gen_noise, 48000, 2, 96000 },
+	};
+
+	std::vector<bench_signal> corpus;
+	std::vector<int> bitrates;
+	for (auto &s : synthetic) {
+		bench_signal sig;
+		sig.name = s.name;
+		sig.sample_rate = s.sample_rate;
+		sig.channels = s.channels;
+		make_signal(sig, s.gen, seconds);
+		corpus.push_back(std::move(sig));
+		bitrates.push_back(s.bitrate);
+	}
+	for (auto path : wav_files) {
+		bench_signal sig;
+		if (!load_wav(path, sig)) {
+			return 1;
+		}
+		bitrates.push_back(sig.channels == 2 ? 96000 : 24000);
+		corpus.push_back(std::move(sig));
+	}
+
+	FILE *out = stdout;
+	if (out_path && (out = fopen(out_path, "w")) == NULL) {
+		fprintf(stderr, "cannot create %s\n", out_path);
+		return 1;
+	}
+
+	bench_case empty;
+	bench_result res;
+	g_stack_baseline = 0;
+	run_measured(empty_entry, &empty, &res);
+	g_stack_baseline = res.peak_stack;
+
+	fprintf(out, "{\n  \"benchmark\": \"media_codec\",\n  \"stack_baseline\": %u,\n"
+			"  \"encoder_state\": %u,\n  \"decoder_state\": %u,\n  \"results\": [",
+			(unsigned)g_stack_baseline, (unsigned)opus_encoderMemRequirements(),
+			(unsigned)opus_decoderMemRequirements());
+
+	bool first = true;
+	int failures = 0;
+	for (size_t i = 0; i < corpus.size(); i++) {
+		for (int frame_ms : frame_sizes) {
+			for (int complexity : complexities) {
+				bench_case c;
+				c.sig = &corpus[i];
+				c.frame_ms = frame_ms;
+				c.complexity = complexity;
+				c.bitrate = bitrates[i];
+				c.error = 0;
+
+				// Reserve the packet store up front, so that it doesn't count as codec heap
+				size_t frames = corpus[i].pcm.size() / corpus[i].channels * frame_ms / 1000 + 1;
+				c.stream.reserve(frames * (OPUS_PACKET_HEADER_LEN + OPUS_MAX_PAYLOAD));
+				c.lengths.reserve(frames);
+
+				if (run_measured(encode_entry, &c, &res) != 0) {
+					return 1;
+				}
+				print_result(out, &first, "encode", &c, &res);
+				failures += (c.error != OPUS_OK);
+
+				if (run_measured(decode_entry, &c, &res) != 0) {
+					return 1;
+				}
+				print_result(out, &first, "decode", &c, &res);
+				failures += (c.error != OPUS_OK);
+			}
+		}
+	}
+
+	fprintf(out, "\n  ]\n}\n");
+	if (out != stdout) {
+		fclose(out);
+	}
+
+	return failures ? 1 : 0;
+}
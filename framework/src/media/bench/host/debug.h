@@ -0,0 +1,34 @@
+/******************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/*
+ * Host replacement of <debug.h> for building the media codec wrappers
+ * outside of TizenRT. Only errors are printed, so that logging doesn't
+ * disturb the measurements.
+ */
+
+#ifndef __MEDIA_BENCH_HOST_DEBUG_H
+#define __MEDIA_BENCH_HOST_DEBUG_H
+
+#include <stdio.h>
+
+#define meddbg(format, ...)    fprintf(stderr, format, ##__VA_ARGS__)
+#define medwdbg(format, ...)
+#define medvdbg(format, ...)
+
+#endif /* __MEDIA_BENCH_HOST_DEBUG_H */
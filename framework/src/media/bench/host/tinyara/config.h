@@ -0,0 +1,27 @@
+/******************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/*
+ * Host replacement of the generated <tinyara/config.h>. Sources fall back
+ * to their built-in defaults, pass -DCONFIG_... to override them.
+ */
+
+#ifndef __MEDIA_BENCH_HOST_TINYARA_CONFIG_H
+#define __MEDIA_BENCH_HOST_TINYARA_CONFIG_H
+
+#endif /* __MEDIA_BENCH_HOST_TINYARA_CONFIG_H */
@@ -0,0 +1,303 @@
+/******************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/*
+ * Host benchmark of the software end point detection front end.
+ *
+ * Runs the same synthetic recording through the speex preprocessor on
+ * every frame (the old SoftwareEndPointDetector) and through the shared
+ * feature extractor, which with CONFIG_MEDIA_VOICE_FEATURE_GATE only
+ * updates the noise estimate of the preprocessor while the energy/ZCR gate
+ * is closed (voice/SoftwareEndPointDetector.cpp).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "speex/speex_preprocess.h"
+#include "voice_features.h"
+
+#ifndef CONFIG_VOICE_SOFTWARE_EPD_FRAMESIZE
+#define CONFIG_VOICE_SOFTWARE_EPD_FRAMESIZE 256
+#endif
+
+#define SAMPRATE        16000
+#define EPD_FRAME       CONFIG_VOICE_SOFTWARE_EPD_FRAMESIZE
+/* MediaRecorder delivers audio in chunks of this many samples */
+#define CHUNK           1024
+
+struct gate_s {
+	uint32_t open_until;
+	int gated;
+};
+
+struct result_s {
+	double cpu_ms;
+	long frames;
+	long preprocessed;
+	long speech_frames;
+	long endpoints;
+};
+
+static double cpu_ms(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+	return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static uint32_t g_rand = 0x12345678;
+
+static int16_t noise(int amplitude)
+{
+	g_rand = g_rand * 1664525 + 1013904223;
+	return (int16_t)(((int32_t)(g_rand >> 16) - 32768) * amplitude / 32768);
+}
+
+/*
+ * Alternating 1.5s of background noise and 1s of voiced "speech" (harmonics
+ * of a gliding pitch under a syllable envelope), the typical duty cycle of
+ * a device waiting for a command.
+ */
+static int16_t *make_signal(int seconds, int noise_level)
+{
+	int n = seconds * SAMPRATE;
+	int16_t *x = (int16_t *)malloc(n * sizeof(int16_t));
+	double phase = 0.0;
+	int i;
+
+	if (x == NULL) {
+		return NULL;
+	}
+
+	for (i = 0; i < n; i++) {
+		double t = (double)(i % (SAMPRATE * 5 / 2)) / SAMPRATE;
+		double v = noise(noise_level);
+		if (t >= 1.5) {
+			double f0 = 120.0 + 40.0 * sin(2.0 * M_PI * 0.7 * t);
+			double env = 0.5 - 0.5 * cos(2.0 * M_PI * 4.0 * (t - 1.5));
+			int h;
+			phase += 2.0 * M_PI * f0 / SAMPRATE;
+			for (h = 1; h <= 8; h++) {
+				v += env * 6000.0 / h * sin(h * phase);
+			}
+		}
+		if (v > 32767) {
+			v = 32767;
+		} else if (v < -32768) {
+			v = -32768;
+		}
+		x[i] = (int16_t)v;
+	}
+
+	return x;
+}
+
+static SpeexPreprocessState *epd_init(void)
+{
+	SpeexPreprocessState *st = speex_preprocess_state_init(EPD_FRAME, SAMPRATE);
+	int adjust;
+
+	/* as in SoftwareEndPointDetector::init() */
+	adjust = 99;
+	speex_preprocess_ctl(st, SPEEX_PREPROCESS_SET_PROB_START, &adjust);
+	adjust = 80;
+	speex_preprocess_ctl(st, SPEEX_PREPROCESS_SET_PROB_CONTINUE, &adjust);
+	return st;
+}
+
+static void on_features(const voice_features_t *feat, void *arg)
+{
+	struct gate_s *gate = (struct gate_s *)arg;
+
+	gate->gated = 1;
+	if (feat->is_voice) {
+		gate->open_until = feat->position;
+	}
+}
+
+static void run(const int16_t *signal, int nsamples, int use_gate, struct result_s *res)
+{
+	SpeexPreprocessState *st = epd_init();
+	voice_feature_extractor_t ext;
+	struct gate_s gate = { 0, 0 };
+	int16_t frame[EPD_FRAME];
+	uint32_t position = 0;
+	int vad = 0;
+	int prev;
+	int off;
+	double start;
+
+	memset(res, 0, sizeof(*res));
+	if (use_gate && !voice_features_init(&ext, SAMPRATE, CONFIG_MEDIA_VOICE_FEATURE_FRAMESIZE, CONFIG_MEDIA_VOICE_FEATURE_HOPSIZE)) {
+		fprintf(stderr, "voice_features_init failed\n");
+		exit(1);
+	}
+
+	start = cpu_ms();
+	for (off = 0; off + CHUNK <= nsamples; off += CHUNK) {
+		const int16_t *chunk = &signal[off];
+		int i;
+
+		if (use_gate) {
+			voice_features_process(&ext, chunk, CHUNK, on_features, &gate);
+		}
+
+		for (i = 0; i + EPD_FRAME <= CHUNK; i += EPD_FRAME) {
+			uint32_t frame_end = position + i + EPD_FRAME;
+
+			res->frames++;
+			prev = vad;
+			/* speex works in place, keep the input intact for the next pass */
+			memcpy(frame, &chunk[i], sizeof(frame));
+			if (gate.gated && (int32_t)(frame_end - gate.open_until) > EPD_FRAME) {
+				/* As CONFIG_MEDIA_VOICE_FEATURE_GATE: only the noise estimate */
+				speex_preprocess_estimate_update(st, frame);
+				vad = 0;
+			} else {
+				vad = speex_preprocess_run(st, frame);
+				res->preprocessed++;
+			}
+			res->speech_frames += vad;
+			if (prev == 1 && vad == 0) {
+				res->endpoints++;
+			}
+		}
+		position += CHUNK;
+	}
+	res->cpu_ms = cpu_ms() - start;
+
+	if (use_gate) {
+		voice_features_deinit(&ext);
+	}
+	speex_preprocess_state_destroy(st);
+}
+
+static double kernel_ns_per_sample(const int16_t *signal, int nsamples, int rounds)
+{
+	volatile uint64_t sink = 0;
+	double start = cpu_ms();
+	int r;
+	int off;
+
+	for (r = 0; r < rounds; r++) {
+		for (off = 0; off + EPD_FRAME <= nsamples; off += EPD_FRAME) {
+			sink += voice_sum_squares(&signal[off], EPD_FRAME);
+			sink += voice_zero_crossings(&signal[off], EPD_FRAME);
+		}
+	}
+	(void)sink;
+
+	return (cpu_ms() - start) * 1e6 / ((double)rounds * nsamples);
+}
+
+static void print_result(FILE *out, const char *name, const struct result_s *res, double audio_s, double mhz, int last)
+{
+	fprintf(out, "    {\"pipeline\": \"%s\", \"cpu_ms\": %.3f, \"realtime_factor\": %.6f, "
+			"\"mcycles_per_audio_s\": %.3f, \"frames\": %ld, \"preprocessed\": %ld, "
+			"\"speech_frames\": %ld, \"endpoints\": %ld}%s\n",
+			name, res->cpu_ms, res->cpu_ms / 1e3 / audio_s,
+			res->cpu_ms * 1e3 * mhz / 1e6 / audio_s, res->frames, res->preprocessed,
+			res->speech_frames, res->endpoints, last ? "" : ",");
+}
+
+static void usage(const char *prog)
+{
+	fprintf(stderr, "Usage: %s [-d seconds] [-n noise_level] [-m cpu_mhz] [-o result.json]\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+	struct result_s every;
+	struct result_s gated;
+	const char *outfile = NULL;
+	FILE *out = stdout;
+	int seconds = 30;
+	int noise_level = 300;
+	double mhz = 1000.0;
+	int16_t *signal;
+	int nsamples;
+	double audio_s;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "d:n:m:o:h")) != -1) {
+		switch (opt) {
+		case 'd':
+			seconds = atoi(optarg);
+			break;
+		case 'n':
+			noise_level = atoi(optarg);
+			break;
+		case 'm':
+			mhz = atof(optarg);
+			break;
+		case 'o':
+			outfile = optarg;
+			break;
+		default:
+			usage(argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	if (seconds <= 0 || mhz <= 0) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	signal = make_signal(seconds, noise_level);
+	if (signal == NULL) {
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+	nsamples = seconds * SAMPRATE / CHUNK * CHUNK;
+	audio_s = (double)nsamples / SAMPRATE;
+
+	run(signal, nsamples, 0, &every);
+	run(signal, nsamples, 1, &gated);
+
+	if (outfile) {
+		out = fopen(outfile, "w");
+		if (out == NULL) {
+			perror(outfile);
+			free(signal);
+			return 1;
+		}
+	}
+
+	fprintf(out, "{\n  \"benchmark\": \"media_voice_epd\",\n  \"audio_s\": %.3f,\n  \"noise_level\": %d,\n"
+			"  \"cpu_mhz\": %.1f,\n  \"feature_framesize\": %d,\n  \"feature_hopsize\": %d,\n"
+			"  \"mel_bands\": %d,\n  \"kernel_ns_per_sample\": %.4f,\n  \"results\": [\n",
+			audio_s, noise_level, mhz, CONFIG_MEDIA_VOICE_FEATURE_FRAMESIZE,
+			CONFIG_MEDIA_VOICE_FEATURE_HOPSIZE, VOICE_FEATURE_MEL_BANDS,
+			kernel_ns_per_sample(signal, nsamples, 20));
+	print_result(out, "preprocess_every_frame", &every, audio_s, mhz, 0);
+	print_result(out, "feature_gated", &gated, audio_s, mhz, 1);
+	fprintf(out, "  ]\n}\n");
+
+	if (out != stdout) {
+		fclose(out);
+	}
+	free(signal);
+	return 0;
+}
@@ -60,6 +60,15 @@ namespace media {
 // AAC ADTS Frame size value stores in 13 bits started at the 31th bit from header
 #define AAC_ADTS_FRAME_GETSIZE(buf) ((buf[3] & 0x03) << 11 | buf[4] << 3 | buf[5] >> 5)
 
+// AAC ADTS sampling frequency index, 4 bits started at the 18th bit from header
+#define AAC_ADTS_FRAME_GET_SR_IDX(buf) (((buf[2]) >> 2) & 0xf)
+
+// AAC ADTS number of raw data blocks in frame minus one, last 2 bits of the 7th byte
+#define AAC_ADTS_FRAME_GET_BLOCKS(buf) (((buf[6]) & 0x3) + 1)
+
+// Samples per AAC raw data block
+#define AAC_SAMPLES_PER_BLOCK 1024
+
 // Read bytes each time from stream each time, while frame resyn.
 #define FRAME_RESYNC_READ_BYTES      (1024)
 // Max bytes could be read from stream in total, while frame resyn.
@@ -115,6 +124,9 @@ namespace media {
 #define OPUS_PACKET_SYNC_VERIFY(buf) (strncmp((const char *)buf, "Opus", 4) == 0)
 #define OPUS_PACKET_GETSIZE(buf) (OPUS_PACKET_HEADER_LEN + _u32_at(buf+4))
 
+// Opus always codes at 48kHz, frame durations are given in 48kHz samples.
+#define OPUS_SAMPLE_RATE 48000
+
 #define BYTES_PER_SAMPLE sizeof(signed short)
 
 /****************************************************************************
@@ -163,6 +175,11 @@ static const int kSamplingRateV2_5[] = {
 	11025, 12000, 8000
 };
 
+// AAC ADTS sampling frequency index table
+static const int kSamplingRateAac[] = {
+	96000, 88200, 64000, 48000, 44100, 32000, 24000, 22050, 16000, 12000, 11025, 8000, 7350
+};
+
 // Bit Rate (in kbps) tables
 // V1 - MPEG 1, V2 - MPEG 2 and MPEG 2.5
 // L1 - Layer 1, L2 - Layer 2, L3 - Layer 3
@@ -195,7 +212,7 @@ static uint32_t _u32_at(const uint8_t *ptr)
 	return ptr[0] << 24 | ptr[1] << 16 | ptr[2] << 8 | ptr[3];
 }
 
-static bool _parse_header(uint32_t header, size_t *frame_size)
+static bool _parse_header(uint32_t header, size_t *frame_size, unsigned int *frame_samples = NULL, unsigned int *frame_rate = NULL)
 {
 	*frame_size = 0;
 
@@ -225,6 +242,20 @@ static bool _parse_header(uint32_t header, size_t *frame_size)
 
 	unsigned padding = MP3_FRAME_GET_PADDING(header);
 
+	if (frame_samples != NULL) {
+		if (layer == MPEG_LAYER_1) {
+			*frame_samples = 384;
+		} else if (layer == MPEG_LAYER_3 && version != MPEG_VERSION_1) {
+			*frame_samples = 576;
+		} else {
+			*frame_samples = 1152;
+		}
+	}
+
+	if (frame_rate != NULL) {
+		*frame_rate = sampling_rate;
+	}
+
 	if (layer == MPEG_LAYER_1) {
 		int bitrate = (version == MPEG_VERSION_1)
 					  ? kBitrateV1L1[bitrate_index - 1]
@@ -772,6 +803,45 @@ bool opus_check_type(rbstream_p rbsp)
 }
 #endif
 
+#ifdef CONFIG_CODEC_LIBOPUS
+// Number of 48kHz samples in an Opus packet, from its TOC byte (RFC 6716, section 3.1).
+static unsigned int opus_packet_samples(const uint8_t *packet, size_t len)
+{
+	static const unsigned int kSilkDuration[] = { 480, 960, 1920, 2880 };
+	static const unsigned int kHybridDuration[] = { 480, 960 };
+	static const unsigned int kCeltDuration[] = { 120, 240, 480, 960 };
+
+	RETURN_VAL_IF_FAIL((len >= 1), 0);
+
+	unsigned int config = packet[0] >> 3;
+	unsigned int duration;
+	if (config < 12) {
+		duration = kSilkDuration[config & 0x3];
+	} else if (config < 16) {
+		duration = kHybridDuration[config & 0x1];
+	} else {
+		duration = kCeltDuration[config & 0x3];
+	}
+
+	unsigned int frames;
+	switch (packet[0] & 0x3) {
+	case 0:
+		frames = 1;
+		break;
+	case 1:
+	case 2:
+		frames = 2;
+		break;
+	default:
+		RETURN_VAL_IF_FAIL((len >= 2), 0);
+		frames = packet[1] & 0x3f;
+		break;
+	}
+
+	return frames * duration;
+}
+#endif
+
 int _get_audio_type(rbstream_p rbsp)
 {
 	if (mp3_check_type(rbsp)) {
@@ -957,6 +1027,87 @@ static size_t _input_callback(void *data, rbstream_p rbsp)
  * Public Functions
  ****************************************************************************/
 
+bool audio_decoder_parse_frame(int audio_type, const uint8_t *buf, size_t len, size_t *frame_size, unsigned int *frame_samples, unsigned int *frame_rate)
+{
+	switch (audio_type) {
+	case AUDIO_TYPE_MP3:
+		RETURN_VAL_IF_FAIL((len >= U32_LEN_IN_BYTES), false);
+		return _parse_header(_u32_at(buf), frame_size, frame_samples, frame_rate);
+
+	case AUDIO_TYPE_AAC: {
+		RETURN_VAL_IF_FAIL((len >= AAC_ADTS_FRAME_HEADER_LEN), false);
+		RETURN_VAL_IF_FAIL(AAC_ADTS_SYNC_VERIFY(buf), false);
+
+		unsigned int sr_idx = AAC_ADTS_FRAME_GET_SR_IDX(buf);
+		RETURN_VAL_IF_FAIL((sr_idx < sizeof(kSamplingRateAac) / sizeof(kSamplingRateAac[0])), false);
+
+		*frame_size = AAC_ADTS_FRAME_GETSIZE(buf);
+		RETURN_VAL_IF_FAIL((*frame_size >= AAC_ADTS_FRAME_HEADER_LEN - 2), false);
+		*frame_samples = AAC_ADTS_FRAME_GET_BLOCKS(buf) * AAC_SAMPLES_PER_BLOCK;
+		*frame_rate = kSamplingRateAac[sr_idx];
+		return true;
+	}
+
+#ifdef CONFIG_CODEC_LIBOPUS
+	case AUDIO_TYPE_OPUS:
+		RETURN_VAL_IF_FAIL((len > OPUS_PACKET_HEADER_LEN), false);
+		RETURN_VAL_IF_FAIL(OPUS_PACKET_SYNC_VERIFY(buf), false);
+
+		*frame_size = OPUS_PACKET_GETSIZE(buf);
+		*frame_samples = opus_packet_samples(buf + OPUS_PACKET_HEADER_LEN, len - OPUS_PACKET_HEADER_LEN);
+		*frame_rate = OPUS_SAMPLE_RATE;
+		return (*frame_samples != 0);
+#endif
+
+	default:
+		return false;
+	}
+}
+
+int audio_decoder_reset(audio_decoder_p decoder)
+{
+	assert(decoder != NULL);
+
+	priv_data_p priv = (priv_data_p) decoder->priv_data;
+	RETURN_VAL_IF_FAIL((priv != NULL), AUDIO_DECODER_ERROR);
+
+	// Drop buffered data, the stream restarts at offset 0 from the new position
+	rbs_close(decoder->rbsp);
+	rb_reset(&decoder->ringbuffer);
+	decoder->rbsp = rbs_open(&decoder->ringbuffer, _input_callback, (void *)decoder);
+	RETURN_VAL_IF_FAIL((decoder->rbsp != NULL), AUDIO_DECODER_ERROR);
+	rbs_ctrl(decoder->rbsp, OPTION_ALLOW_TO_DEQUEUE, 1);
+
+	// Keep mFixedHeader, so that MP3 frames are still matched against the first header
+	priv->mCurrentPos = 0;
+	memset(&(priv->pcm), 0, sizeof(pcm_data_t));
+
+	RETURN_VAL_IF_FAIL((decoder->dec_mem != NULL), AUDIO_DECODER_OK);
+
+	// Forget the state of the previous frames
+	switch (decoder->audio_type) {
+	case AUDIO_TYPE_MP3:
+		pvmp3_resetDecoder(decoder->dec_mem);
+		pvmp3_InitDecoder((tPVMP3DecoderExternal *) decoder->dec_ext, decoder->dec_mem);
+		break;
+
+	case AUDIO_TYPE_AAC:
+		PVMP4AudioDecoderResetBuffer(decoder->dec_mem);
+		break;
+
+#ifdef CONFIG_CODEC_LIBOPUS
+	case AUDIO_TYPE_OPUS:
+		RETURN_VAL_IF_FAIL((opus_initDecoder((opus_dec_external_t *) decoder->dec_ext, decoder->dec_mem) == OPUS_OK), AUDIO_DECODER_ERROR);
+		break;
+#endif
+
+	default:
+		break;
+	}
+
+	return AUDIO_DECODER_OK;
+}
+
 // check if the given auido type is supportted or not
 bool audio_decoder_check_audio_type(int audio_type)
 {
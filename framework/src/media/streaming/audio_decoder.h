@@ -32,6 +32,9 @@
 #define AUDIO_DECODER_OK 0
 #define AUDIO_DECODER_ERROR -1
 
+/* Bytes needed by audio_decoder_parse_frame() to parse any supported frame header */
+#define AUDIO_DECODER_FRAME_HEADER_LEN 10
+
 namespace media {
 
 struct audio_decoder_s;
@@ -73,6 +76,29 @@ struct audio_decoder_s {
 	void *priv_data;            /* pointer to private data */
 };
 
+/**
+ * @brief  Parse the frame header at the beginning of the given buffer.
+ *         Supports MP3, AAC ADTS and the Opus packet format of the media framework.
+ *
+ * @param  audio_type : audio type of the stream, see enum audio_type_e
+ * @param  buf : Pointer to the frame header, at least AUDIO_DECODER_FRAME_HEADER_LEN bytes
+ * @param  len : Number of valid bytes in buf
+ * @param  frame_size : Output, frame size in bytes including the header
+ * @param  frame_samples : Output, number of samples per channel in the frame
+ * @param  frame_rate : Output, sample rate that frame_samples refers to
+ * @return true if buf starts with a valid frame header, otherwise, return false.
+ */
+bool audio_decoder_parse_frame(int audio_type, const uint8_t *buf, size_t len, size_t *frame_size, unsigned int *frame_samples, unsigned int *frame_rate);
+
+/**
+ * @brief  Drop all buffered data and decoder state, for restarting at another position.
+ *         Data pushed afterwards must start at a frame boundary.
+ *
+ * @param  decoder : Pointer to decoder object
+ * @return 0 on success, otherwise, return -1.
+ */
+int audio_decoder_reset(audio_decoder_p decoder);
+
 /**
  * @brief  stream decoder initialize.
  *
@@ -0,0 +1,379 @@
+/******************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <tinyara/config.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+#include <algorithm>
+#include "frame_index.h"
+#include "../utils/internal_defs.h"
+
+#ifndef CONFIG_MEDIA_FRAME_INDEX_INTERVAL_MS
+#define CONFIG_MEDIA_FRAME_INDEX_INTERVAL_MS 500
+#endif
+
+#ifndef CONFIG_MEDIA_FRAME_INDEX_MAX_ENTRIES
+#define CONFIG_MEDIA_FRAME_INDEX_MAX_ENTRIES 512
+#endif
+
+namespace media {
+
+#define FRAME_INDEX_HEADER_LEN AUDIO_DECODER_FRAME_HEADER_LEN
+
+// Entries allocated at first, grown by doubling up to the maximum
+#define FRAME_INDEX_INITIAL_ENTRIES 32
+
+// ID3v2 tag header len, and tag size in syncsafe integer, 6th~9th bytes in header
+#define ID3V2_HEADER_LEN 10
+#define ID3V2_GETSIZE(buf)  (((buf[6] & 0x7f) << 21) \
+							| ((buf[7] & 0x7f) << 14) \
+							| ((buf[8] & 0x7f) << 7) \
+							| ((buf[9] & 0x7f)))
+
+// Cache file layout: header followed by 'count' entries
+#define FRAME_INDEX_CACHE_MAGIC "FIDX"
+#define FRAME_INDEX_CACHE_VERSION 1
+
+struct frame_index_cache_s {
+	char magic[4];
+	uint32_t version;
+	int32_t audio_type;
+	uint32_t file_size;
+	int64_t mtime;
+	uint32_t interval;
+	uint32_t rate;
+	uint64_t samples;
+	uint32_t count;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static bool _is_covered(frame_index_p index, uint32_t msec)
+{
+	if (index->count == 0) {
+		return false;
+	}
+
+	return index->complete || msec < frame_index_get_msec(index);
+}
+
+static void _add_entry(frame_index_p index, uint32_t msec, size_t offset)
+{
+	if (index->count > 0 && msec < index->entries[index->count - 1].msec + index->interval) {
+		return;
+	}
+
+	if (index->count == index->capacity) {
+		if (index->capacity < CONFIG_MEDIA_FRAME_INDEX_MAX_ENTRIES) {
+			unsigned int capacity = std::min(std::max(index->capacity * 2, (unsigned int)FRAME_INDEX_INITIAL_ENTRIES), (unsigned int)CONFIG_MEDIA_FRAME_INDEX_MAX_ENTRIES);
+			frame_index_entry_t *entries = (frame_index_entry_t *)realloc(index->entries, capacity * sizeof(frame_index_entry_t));
+			if (entries != NULL) {
+				index->entries = entries;
+				index->capacity = capacity;
+			}
+		}
+
+		if (index->count == index->capacity) {
+			// Full, halve the resolution
+			unsigned int i;
+			for (i = 0; 2 * i < index->count; i++) {
+				index->entries[i] = index->entries[2 * i];
+			}
+			index->count = i;
+			index->interval *= 2;
+			medvdbg("[%s] interval %u ms\n", __FUNCTION__, index->interval);
+
+			if (msec < index->entries[index->count - 1].msec + index->interval) {
+				return;
+			}
+		}
+	}
+
+	index->entries[index->count].msec = msec;
+	index->entries[index->count].offset = (uint32_t)offset;
+	index->count++;
+}
+
+// Parse the header at index->next, buf holds FRAME_INDEX_HEADER_LEN bytes.
+static void _parse(frame_index_p index, const uint8_t *buf)
+{
+	if (index->probing_tag) {
+		if (memcmp("ID3", buf, 3) == 0) {
+			index->next += ID3V2_HEADER_LEN + ID3V2_GETSIZE(buf);
+			return;
+		}
+		index->probing_tag = false;
+	}
+
+	size_t frame_size = 0;
+	unsigned int samples = 0;
+	unsigned int rate = 0;
+	if (!audio_decoder_parse_frame(index->audio_type, buf, FRAME_INDEX_HEADER_LEN, &frame_size, &samples, &rate)
+		|| frame_size == 0 || (index->rate != 0 && rate != index->rate)) {
+		if (memcmp("TAG", buf, 3) == 0) {
+			// ID3v1 tag, the last 128 bytes of a MP3 file
+			index->complete = true;
+			return;
+		}
+
+		meddbg("[%s] lost sync at %u, indexed %u ms\n", __FUNCTION__, index->next, frame_index_get_msec(index));
+		index->broken = true;
+		return;
+	}
+
+	if ((uint64_t)index->next > UINT32_MAX) {
+		index->broken = true;
+		return;
+	}
+
+	index->rate = rate;
+	_add_entry(index, frame_index_get_msec(index), index->next);
+	index->samples += samples;
+	index->next += frame_size;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int frame_index_init(frame_index_p index, int audio_type)
+{
+	assert(index != NULL);
+
+	memset(index, 0, sizeof(frame_index_t));
+
+	switch (audio_type) {
+	case AUDIO_TYPE_MP3:
+	case AUDIO_TYPE_AAC:
+#ifdef CONFIG_CODEC_LIBOPUS
+	case AUDIO_TYPE_OPUS:
+#endif
+		break;
+	default:
+		return AUDIO_DECODER_ERROR;
+	}
+
+	index->audio_type = audio_type;
+	index->interval = CONFIG_MEDIA_FRAME_INDEX_INTERVAL_MS;
+	index->probing_tag = true;
+	return AUDIO_DECODER_OK;
+}
+
+void frame_index_finish(frame_index_p index)
+{
+	assert(index != NULL);
+
+	free(index->entries);
+	index->entries = NULL;
+	index->count = 0;
+	index->capacity = 0;
+}
+
+void frame_index_feed(frame_index_p index, size_t offset, const uint8_t *data, size_t len)
+{
+	size_t end = offset + len;
+	uint8_t header[FRAME_INDEX_HEADER_LEN];
+
+	while (!index->complete && !index->broken && index->next < end) {
+		if (index->next >= offset) {
+			size_t avail = end - index->next;
+			if (avail < FRAME_INDEX_HEADER_LEN) {
+				// Header continues in the next chunk
+				memcpy(index->carry, data + (index->next - offset), avail);
+				index->carry_offset = index->next;
+				index->carry_len = avail;
+				return;
+			}
+
+			_parse(index, data + (index->next - offset));
+			continue;
+		}
+
+		// Header started in the previous chunk, join them if this one follows it
+		if (index->carry_len == 0 || index->carry_offset != index->next || index->carry_offset + index->carry_len != offset) {
+			return;
+		}
+
+		size_t need = FRAME_INDEX_HEADER_LEN - index->carry_len;
+		if (len < need) {
+			memcpy(index->carry + index->carry_len, data, len);
+			index->carry_len += len;
+			return;
+		}
+
+		memcpy(header, index->carry, index->carry_len);
+		memcpy(header + index->carry_len, data, need);
+		index->carry_len = 0;
+		_parse(index, header);
+	}
+}
+
+void frame_index_eof(frame_index_p index)
+{
+	if (index->complete || index->broken) {
+		return;
+	}
+
+	if (index->carry_len > 0 && index->carry_offset == index->next) {
+		// A last frame shorter than the header length
+		uint8_t header[FRAME_INDEX_HEADER_LEN];
+		memset(header, 0, sizeof(header));
+		memcpy(header, index->carry, index->carry_len);
+		index->carry_len = 0;
+		_parse(index, header);
+	}
+
+	index->complete = !index->broken;
+	medvdbg("[%s] complete %d, %u entries, %u ms\n", __FUNCTION__, index->complete, index->count, frame_index_get_msec(index));
+}
+
+bool frame_index_scan(frame_index_p index, FILE *fp, uint32_t msec)
+{
+	uint8_t header[FRAME_INDEX_HEADER_LEN];
+
+	long saved = ftell(fp);
+	RETURN_VAL_IF_FAIL((saved >= 0), false);
+
+	// Frames are parsed from the file directly, a pending carry is stale now
+	index->carry_len = 0;
+
+	while (!index->complete && !index->broken && !_is_covered(index, msec)) {
+		if (fseek(fp, index->next, SEEK_SET) != 0) {
+			break;
+		}
+
+		size_t n = fread(header, 1, sizeof(header), fp);
+		if (n < sizeof(header)) {
+			if (n > 0) {
+				memcpy(index->carry, header, n);
+				index->carry_offset = index->next;
+				index->carry_len = n;
+			}
+			frame_index_eof(index);
+			break;
+		}
+
+		_parse(index, header);
+	}
+
+	if (fseek(fp, saved, SEEK_SET) != 0) {
+		meddbg("[%s] file seek failed errno : %d\n", __FUNCTION__, errno);
+		return false;
+	}
+
+	return _is_covered(index, msec);
+}
+
+bool frame_index_lookup(frame_index_p index, uint32_t msec, frame_index_entry_t *entry)
+{
+	RETURN_VAL_IF_FAIL(_is_covered(index, msec), false);
+
+	// First entry after msec, the one before it starts at or before msec
+	frame_index_entry_t *it = std::upper_bound(index->entries, index->entries + index->count, msec,
+		[](uint32_t value, const frame_index_entry_t &e) { return value < e.msec; });
+	assert(it != index->entries);
+
+	*entry = *(it - 1);
+	return true;
+}
+
+uint32_t frame_index_get_msec(frame_index_p index)
+{
+	if (index->rate == 0) {
+		return 0;
+	}
+
+	return (uint32_t)(index->samples * 1000 / index->rate);
+}
+
+bool frame_index_load(frame_index_p index, const char *path, size_t file_size, time_t mtime)
+{
+	struct frame_index_cache_s cache;
+	bool ret = false;
+
+	FILE *fp = fopen(path, "rb");
+	RETURN_VAL_IF_FAIL((fp != NULL), false);
+
+	if (fread(&cache, sizeof(cache), 1, fp) == 1 && memcmp(cache.magic, FRAME_INDEX_CACHE_MAGIC, sizeof(cache.magic)) == 0
+		&& cache.version == FRAME_INDEX_CACHE_VERSION && cache.audio_type == index->audio_type
+		&& cache.file_size == file_size && cache.mtime == (int64_t)mtime && cache.rate != 0
+		&& cache.count > 0 && cache.count <= CONFIG_MEDIA_FRAME_INDEX_MAX_ENTRIES) {
+		frame_index_entry_t *entries = (frame_index_entry_t *)malloc(cache.count * sizeof(frame_index_entry_t));
+		if (entries != NULL && fread(entries, sizeof(frame_index_entry_t), cache.count, fp) == cache.count) {
+			free(index->entries);
+			index->entries = entries;
+			index->count = cache.count;
+			index->capacity = cache.count;
+			index->interval = cache.interval;
+			index->rate = cache.rate;
+			index->samples = cache.samples;
+			index->next = file_size;
+			index->probing_tag = false;
+			index->complete = true;
+			index->broken = false;
+			index->carry_len = 0;
+			ret = true;
+		} else {
+			free(entries);
+		}
+	}
+
+	fclose(fp);
+	medvdbg("[%s] %s %s\n", __FUNCTION__, path, ret ? "loaded" : "not usable");
+	return ret;
+}
+
+bool frame_index_save(frame_index_p index, const char *path, size_t file_size, time_t mtime)
+{
+	struct frame_index_cache_s cache;
+
+	RETURN_VAL_IF_FAIL((index->complete && index->count > 0), false);
+
+	memcpy(cache.magic, FRAME_INDEX_CACHE_MAGIC, sizeof(cache.magic));
+	cache.version = FRAME_INDEX_CACHE_VERSION;
+	cache.audio_type = index->audio_type;
+	cache.file_size = file_size;
+	cache.mtime = (int64_t)mtime;
+	cache.interval = index->interval;
+	cache.rate = index->rate;
+	cache.samples = index->samples;
+	cache.count = index->count;
+
+	FILE *fp = fopen(path, "wb");
+	RETURN_VAL_IF_FAIL((fp != NULL), false);
+
+	bool ret = (fwrite(&cache, sizeof(cache), 1, fp) == 1)
+			   && (fwrite(index->entries, sizeof(frame_index_entry_t), index->count, fp) == index->count);
+	if (fclose(fp) != OK) {
+		ret = false;
+	}
+
+	if (!ret) {
+		meddbg("[%s] write %s failed errno : %d\n", __FUNCTION__, path, errno);
+		remove(path);
+	}
+
+	return ret;
+}
+
+} // namespace media
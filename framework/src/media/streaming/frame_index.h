@@ -0,0 +1,146 @@
+/******************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#ifndef STREAMING_FRAME_INDEX_H
+#define STREAMING_FRAME_INDEX_H
+
+#include <tinyara/config.h>
+#include <sys/types.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include "audio_decoder.h"
+
+namespace media {
+
+/**
+ * @struct  frame_index_entry_s
+ * @brief   Start of the first frame at or after the given time.
+ */
+struct frame_index_entry_s {
+	uint32_t msec;              /* presentation time of the frame in milliseconds */
+	uint32_t offset;            /* byte offset of the frame header in the file */
+};
+
+typedef struct frame_index_entry_s frame_index_entry_t;
+
+/**
+ * @struct  frame_index_s
+ * @brief   Sparse time to byte offset map of a compressed audio file.
+ *          Entries are added while frames are parsed in file order, either
+ *          from data read for playback or by hopping from header to header.
+ *          When the table is full, every other entry is dropped and the
+ *          interval is doubled, so memory stays bounded for any file length.
+ */
+struct frame_index_s {
+	int audio_type;             /* MP3, AAC or Opus, see enum audio_type_e */
+	frame_index_entry_t *entries;
+	unsigned int count;         /* number of entries in use */
+	unsigned int capacity;      /* number of entries allocated */
+	unsigned int interval;      /* minimum time between entries in milliseconds */
+
+	size_t next;                /* offset of the next frame header to parse */
+	uint64_t samples;           /* samples of all frames before next */
+	unsigned int rate;          /* sample rate of the frames */
+	bool probing_tag;           /* still at the start of a MP3 file, skipping ID3v2 tags */
+	bool complete;              /* all frames up to the end of file are indexed */
+	bool broken;                /* lost sync, no frames after next can be indexed */
+
+	/* frame header split between two fed chunks */
+	uint8_t carry[AUDIO_DECODER_FRAME_HEADER_LEN];
+	size_t carry_offset;
+	size_t carry_len;
+};
+
+typedef struct frame_index_s frame_index_t;
+typedef struct frame_index_s *frame_index_p;
+
+/**
+ * @brief  Initialize an empty frame index.
+ *
+ * @param  index : Pointer to index object
+ * @param  audio_type : audio type of the file, only MP3, AAC and Opus can be indexed
+ * @return 0 on success, otherwise, return -1.
+ */
+int frame_index_init(frame_index_p index, int audio_type);
+
+/**
+ * @brief  Release the memory of the index.
+ */
+void frame_index_finish(frame_index_p index);
+
+/**
+ * @brief  Parse frames in data read from the file.
+ *         Data must be fed in file order, chunks that aren't contiguous with the
+ *         already parsed part (e.g. after a seek) are ignored.
+ *
+ * @param  index : Pointer to index object
+ * @param  offset : file offset of data
+ * @param  data : Pointer to the data read
+ * @param  len : Number of bytes read
+ */
+void frame_index_feed(frame_index_p index, size_t offset, const uint8_t *data, size_t len);
+
+/**
+ * @brief  Mark the end of file, completing the index unless sync was lost.
+ */
+void frame_index_eof(frame_index_p index);
+
+/**
+ * @brief  Extend the index by reading frame headers only, until the given time or the end of file.
+ *         The file position is restored afterwards.
+ *
+ * @param  index : Pointer to index object
+ * @param  fp : file being indexed
+ * @param  msec : time to index up to, UINT32_MAX for the whole file
+ * @return true if msec is covered by the index afterwards, otherwise, return false.
+ */
+bool frame_index_scan(frame_index_p index, FILE *fp, uint32_t msec);
+
+/**
+ * @brief  Find the last indexed frame starting at or before the given time, O(log n).
+ *
+ * @param  index : Pointer to index object
+ * @param  msec : time to look up
+ * @param  entry : Output, offset and time of the frame found
+ * @return true if msec is covered by the index, otherwise, return false.
+ */
+bool frame_index_lookup(frame_index_p index, uint32_t msec, frame_index_entry_t *entry);
+
+/**
+ * @brief  Time covered by the index, which is the duration when the index is complete.
+ */
+uint32_t frame_index_get_msec(frame_index_p index);
+
+/**
+ * @brief  Load the index from a cache file, written for the same file size and modification time.
+ *
+ * @return true if a matching cache was loaded, otherwise, return false.
+ */
+bool frame_index_load(frame_index_p index, const char *path, size_t file_size, time_t mtime);
+
+/**
+ * @brief  Save a complete index to a cache file.
+ *
+ * @return true on success, otherwise, return false.
+ */
+bool frame_index_save(frame_index_p index, const char *path, size_t file_size, time_t mtime);
+
+} // namespace media
+
+#endif /* STREAMING_FRAME_INDEX_H */
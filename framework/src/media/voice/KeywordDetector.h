@@ -22,6 +22,8 @@
 
 #include <media/voice/SpeechDetector.h>
 
+#include "voice_features.h"
+
 namespace media {
 namespace voice {
 
@@ -31,6 +33,19 @@ public:
 	virtual bool init(uint32_t samprate, uint8_t channels) = 0;
 	virtual void deinit() = 0;
 	virtual bool startKeywordDetect(int timeout) = 0;
+	/**
+	 * Features of the next samples, computed once by SpeechDetector and
+	 * shared by the detectors. Delivered before the samples themselves.
+	 */
+	virtual void onFeatures(const voice_features_t *feat) {}
+	/**
+	 * Whether onFeatures() uses the features. SpeechDetector only runs the
+	 * feature extractor while a detector does.
+	 */
+	virtual bool usesFeatures() const
+	{
+		return false;
+	}
 };
 
 } // namespace voice
@@ -24,7 +24,10 @@ namespace voice {
 SoftwareEndPointDetector::SoftwareEndPointDetector() :
 	mState(nullptr),
 	mPreviousVAD(0),
-	mVAD(0)
+	mVAD(0),
+	mPosition(0),
+	mGateOpenUntil(0),
+	mIsGated(false)
 {
 	sem_init(&mSem, 0, 0);
 }
@@ -48,6 +51,9 @@ bool SoftwareEndPointDetector::init(uint32_t samprate, uint8_t channels)
 	adjust = 80;
 	speex_preprocess_ctl(mState, SPEEX_PREPROCESS_SET_PROB_CONTINUE, &adjust);
 
+	mPosition = 0;
+	mGateOpenUntil = 0;
+	mIsGated = false;
 	return true;
 }
 
@@ -77,11 +83,45 @@ bool SoftwareEndPointDetector::waitEndPoint(int timeout)
 	return ret == 0 ? true : false;
 }
 
+/* Only the voice gate reads the features */
+bool SoftwareEndPointDetector::usesFeatures() const
+{
+#ifdef CONFIG_MEDIA_VOICE_FEATURE_GATE
+	return true;
+#else
+	return false;
+#endif
+}
+
+void SoftwareEndPointDetector::onFeatures(const voice_features_t *feat)
+{
+	mIsGated = true;
+	if (feat->is_voice) {
+		mGateOpenUntil = feat->position;
+	}
+}
+
 bool SoftwareEndPointDetector::detectEndPoint(short *sample, int numSample)
 {
+#ifdef CONFIG_MEDIA_VOICE_FEATURE_GATE
+	uint32_t start = mPosition;
+#endif
+	mPosition += numSample;
+
 	for (short *ptr = sample; ptr <= sample + numSample - CONFIG_VOICE_SOFTWARE_EPD_FRAMESIZE; ptr += CONFIG_VOICE_SOFTWARE_EPD_FRAMESIZE) {
 		mPreviousVAD = mVAD;
-		mVAD = speex_preprocess_run(mState, ptr);	// vad : 0 (no speech) or 1 (speech)
+#ifdef CONFIG_MEDIA_VOICE_FEATURE_GATE
+		uint32_t frameEnd = start + (ptr - sample) + CONFIG_VOICE_SOFTWARE_EPD_FRAMESIZE;
+
+		if (mIsGated && (int32_t)(frameEnd - mGateOpenUntil) > CONFIG_VOICE_SOFTWARE_EPD_FRAMESIZE) {
+			/* No voice energy around this frame, only keep the noise estimate of speex up to date */
+			speex_preprocess_estimate_update(mState, ptr);
+			mVAD = 0;
+		} else
+#endif
+		{
+			mVAD = speex_preprocess_run(mState, ptr);	// vad : 0 (no speech) or 1 (speech)
+		}
 
 		if (mPreviousVAD == 1 && mVAD == 0) {
 			int semVal;
@@ -49,11 +49,18 @@ public:
 	bool startEndPointDetect(int timeout) override;
 	bool detectEndPoint(short *sample, int numSample) override;
 	bool waitEndPoint(int timeout) override;
+	void onFeatures(const voice_features_t *feat) override;
+	bool usesFeatures() const override;
 
 private:
 	SpeexPreprocessState *mState;
 	int mPreviousVAD;
 	int mVAD;
+	/* Samples passed to detectEndPoint() so far */
+	uint32_t mPosition;
+	/* Stream position up to which the energy/ZCR gate saw voice */
+	uint32_t mGateOpenUntil;
+	bool mIsGated;
 	sem_t mSem;
 };
 
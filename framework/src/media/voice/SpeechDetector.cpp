@@ -24,6 +24,7 @@
 #include "SoftwareEndPointDetector.h"
 #include "HardwareKeywordDetector.h"
 #include "HardwareEndPointDetector.h"
+#include "voice_features.h"
 
 #include "../audio/audio_manager.h"
 
@@ -37,7 +38,7 @@ namespace voice {
 class SpeechDetectorImpl : public SpeechDetector
 {
 public:
-	SpeechDetectorImpl() = default;
+	SpeechDetectorImpl() : mKeywordUsesFeatures(false), mEndPointUsesFeatures(false), mFeatureUsers(0) {}
 	bool initKeywordDetect(uint32_t samprate, uint8_t channels) override;
 	bool initEndPointDetect(uint32_t samprate, uint8_t channels) override;
 	bool deinitKeywordDetect() override;
@@ -48,8 +49,17 @@ public:
 	bool waitEndPoint(int timeout) override;
 
 private:
+	bool initFeatures(uint32_t samprate);
+	void deinitFeatures();
+	static void onFeatures(const voice_features_t *feat, void *arg);
+
 	std::shared_ptr<KeywordDetector> mKeywordDetector;
 	std::shared_ptr<EndPointDetector> mEndPointDetector;
+	/* Shared by the software detectors, so that each frame is analyzed once */
+	voice_feature_extractor_t mFeatures;
+	bool mKeywordUsesFeatures;
+	bool mEndPointUsesFeatures;
+	int mFeatureUsers;
 };
 
 SpeechDetector *SpeechDetector::instance()
@@ -81,6 +91,12 @@ bool SpeechDetectorImpl::initKeywordDetect(uint32_t samprate, uint8_t channels)
 	} else {
 		medvdbg("Not found H/W speech detector. Use Software\n");
 		mKeywordDetector = std::make_shared<SoftwareKeywordDetector>();
+		if (mKeywordDetector->usesFeatures() && !mKeywordUsesFeatures) {
+			if (!initFeatures(samprate)) {
+				return false;
+			}
+			mKeywordUsesFeatures = true;
+		}
 	}
 
 	return mKeywordDetector->init(samprate, channels);
@@ -108,15 +124,59 @@ bool SpeechDetectorImpl::initEndPointDetect(uint32_t samprate, uint8_t channels)
 		mEndPointDetector = std::make_shared<HardwareEndPointDetector>(0, 0, sd_card, sd_device);
 	} else {
 		mEndPointDetector = std::make_shared<SoftwareEndPointDetector>();
+		if (mEndPointDetector->usesFeatures() && !mEndPointUsesFeatures) {
+			if (!initFeatures(samprate)) {
+				return false;
+			}
+			mEndPointUsesFeatures = true;
+		}
 	}
 
 	return mEndPointDetector->init(samprate, channels);
 }
 
+bool SpeechDetectorImpl::initFeatures(uint32_t samprate)
+{
+	if (mFeatureUsers++ > 0) {
+		voice_features_reset(&mFeatures);
+		return true;
+	}
+
+	if (!voice_features_init(&mFeatures, samprate, CONFIG_MEDIA_VOICE_FEATURE_FRAMESIZE, CONFIG_MEDIA_VOICE_FEATURE_HOPSIZE)) {
+		meddbg("voice feature extractor init failed\n");
+		mFeatureUsers--;
+		return false;
+	}
+
+	return true;
+}
+
+void SpeechDetectorImpl::deinitFeatures()
+{
+	if (mFeatureUsers > 0 && --mFeatureUsers == 0) {
+		voice_features_deinit(&mFeatures);
+	}
+}
+
+void SpeechDetectorImpl::onFeatures(const voice_features_t *feat, void *arg)
+{
+	auto detector = static_cast<SpeechDetectorImpl *>(arg);
+	if (detector->mKeywordDetector) {
+		detector->mKeywordDetector->onFeatures(feat);
+	}
+	if (detector->mEndPointDetector) {
+		detector->mEndPointDetector->onFeatures(feat);
+	}
+}
+
 bool SpeechDetectorImpl::deinitKeywordDetect()
 {
 	if (mKeywordDetector) {
 		mKeywordDetector->deinit();
+		if (mKeywordUsesFeatures) {
+			deinitFeatures();
+			mKeywordUsesFeatures = false;
+		}
 		mKeywordDetector = nullptr;
 		return true;
 	} else {
@@ -129,6 +189,10 @@ bool SpeechDetectorImpl::deinitEndPointDetect()
 {
 	if (mEndPointDetector) {
 		mEndPointDetector->deinit();
+		if (mEndPointUsesFeatures) {
+			deinitFeatures();
+			mEndPointUsesFeatures = false;
+		}
 		mEndPointDetector = nullptr;
 		return true;
 	} else {
@@ -169,6 +233,11 @@ bool SpeechDetectorImpl::detectEndPoint(short *sample, int numSample)
 		return false;
 	}
 
+	/* Only while a detector reads the features, e.g. the voice gate of the software EPD */
+	if (mFeatureUsers > 0) {
+		voice_features_process(&mFeatures, sample, numSample, onFeatures, this);
+	}
+
 	return mEndPointDetector->detectEndPoint(sample, numSample);
 }
 
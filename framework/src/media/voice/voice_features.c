@@ -0,0 +1,322 @@
+/******************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <debug.h>
+#include "voice_features.h"
+
+#if VOICE_FEATURE_MEL_BANDS > 0
+/* speexdsp from external/swepd */
+#include "config.h"
+#include "arch.h"
+#include "fftwrap.h"
+#include "filterbank.h"
+#endif
+
+/* 10*log10(2) dB per log2 step of the energy, in Q8 log2 units */
+#define DB_TO_LOG2_Q8(db)       ((db) * 256 * 1000 / 3010)
+
+/* Frames quieter than about -54dBFS never open the gate */
+#define VOICE_ENERGY_MIN        (12 << 8)
+
+/* Noisy frames with this many sign changes are treated as unvoiced speech (fricatives) */
+#define VOICE_ZCR_FRICATIVE     (32768 / 4)
+
+/* Q15 fraction */
+#define VOICE_Q15_ONE           32768
+
+uint64_t voice_sum_squares(const int16_t *x, int n)
+{
+	uint64_t acc = 0;
+	int i = 0;
+
+#if defined(__ARM_FEATURE_DSP) && __ARM_FEATURE_DSP
+	int64_t acc64 = 0;
+	for (; i + 1 < n; i += 2) {
+		uint32_t pair;
+		memcpy(&pair, &x[i], sizeof(pair));
+		/* two 16x16 multiplies accumulated into 64 bits in one instruction */
+		__asm__("smlald %Q0, %R0, %1, %1" : "+r"(acc64) : "r"(pair));
+	}
+	acc = (uint64_t)acc64;
+#else
+	for (; i + 1 < n; i += 2) {
+		/* each square is at most 2^30, so a pair fits in 32 bits */
+		acc += (uint32_t)(x[i] * x[i]) + (uint32_t)(x[i + 1] * x[i + 1]);
+	}
+#endif
+
+	for (; i < n; i++) {
+		acc += (uint32_t)(x[i] * x[i]);
+	}
+
+	return acc;
+}
+
+int voice_zero_crossings(const int16_t *x, int n)
+{
+	int count = 0;
+	int i;
+
+	/* branchless: the sign bit of a ^ b is set when the signs differ */
+	for (i = 1; i < n; i++) {
+		count += ((x[i] ^ x[i - 1]) < 0);
+	}
+
+	return count;
+}
+
+int32_t voice_log2_q8(uint64_t v)
+{
+	int msb;
+	uint32_t frac;
+
+	if (v == 0) {
+		return 0;
+	}
+
+	msb = 63 - __builtin_clzll(v);
+	if (msb >= 8) {
+		frac = (uint32_t)(v >> (msb - 8)) & 0xff;
+	} else {
+		frac = (uint32_t)(v << (8 - msb)) & 0xff;
+	}
+
+	/* log2(1 + f) ~= f + 0.34 * f * (1 - f), within 0.01 */
+	frac += (frac * (256 - frac) * 87) >> 16;
+
+	return (msb << 8) + (int32_t)frac;
+}
+
+#if VOICE_FEATURE_MEL_BANDS > 0
+static bool logmel_init(voice_feature_extractor_t *ext)
+{
+	int n = ext->framesize;
+	int i;
+
+	ext->fft = spx_fft_init(n);
+	ext->bank = filterbank_new(VOICE_FEATURE_MEL_BANDS, ext->samprate, n / 2, 1);
+	ext->window = (int16_t *)malloc(n * sizeof(int16_t));
+	ext->fft_in = (int16_t *)malloc(n * sizeof(int16_t));
+	ext->fft_out = (int16_t *)malloc(n * sizeof(int16_t));
+	ext->ps = (int32_t *)malloc(n / 2 * sizeof(int32_t));
+	ext->mel = (int32_t *)malloc(VOICE_FEATURE_MEL_BANDS * sizeof(int32_t));
+	if (!ext->fft || !ext->bank || !ext->window || !ext->fft_in || !ext->fft_out || !ext->ps || !ext->mel) {
+		return false;
+	}
+
+	/* Hann window, Q15 */
+	for (i = 0; i < n; i++) {
+		ext->window[i] = (int16_t)(16383.5f * (1.0f - cosf(2.0f * (float)M_PI * i / n)));
+	}
+
+	return true;
+}
+
+static void logmel_deinit(voice_feature_extractor_t *ext)
+{
+	if (ext->fft) {
+		spx_fft_destroy(ext->fft);
+	}
+	if (ext->bank) {
+		filterbank_destroy((FilterBank *)ext->bank);
+	}
+	free(ext->window);
+	free(ext->fft_in);
+	free(ext->fft_out);
+	free(ext->ps);
+	free(ext->mel);
+	ext->fft = NULL;
+	ext->bank = NULL;
+	ext->window = NULL;
+	ext->fft_in = NULL;
+	ext->fft_out = NULL;
+	ext->ps = NULL;
+	ext->mel = NULL;
+}
+
+static void logmel_compute(voice_feature_extractor_t *ext, voice_features_t *feat)
+{
+	int n = ext->framesize;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		ext->fft_in[i] = (int16_t)((ext->frame[i] * ext->window[i]) >> 15);
+	}
+
+	spx_fft(ext->fft, ext->fft_in, ext->fft_out);
+
+	/*
+	 * Output is packed as DC, (re, im) pairs, Nyquist. Power is scaled down,
+	 * so that the sum over the widest band can't overflow; it's only an
+	 * offset in the log domain.
+	 */
+	ext->ps[0] = (ext->fft_out[0] * ext->fft_out[0]) >> 6;
+	for (i = 1; i < n / 2; i++) {
+		uint32_t re2 = (uint32_t)(ext->fft_out[2 * i - 1] * ext->fft_out[2 * i - 1]);
+		uint32_t im2 = (uint32_t)(ext->fft_out[2 * i] * ext->fft_out[2 * i]);
+		ext->ps[i] = (int32_t)((re2 + im2) >> 6);
+	}
+
+	filterbank_compute_bank32((FilterBank *)ext->bank, ext->ps, ext->mel);
+
+	for (i = 0; i < VOICE_FEATURE_MEL_BANDS; i++) {
+		feat->logmel[i] = (int16_t)voice_log2_q8(ext->mel[i] > 0 ? (uint64_t)ext->mel[i] : 0);
+	}
+}
+#endif
+
+static void features_compute(voice_feature_extractor_t *ext, voice_features_t *feat)
+{
+	int32_t margin = DB_TO_LOG2_Q8(CONFIG_MEDIA_VOICE_FEATURE_GATE_MARGIN_DB);
+	uint64_t sum = voice_sum_squares(ext->frame, ext->framesize);
+	int32_t energy = 0;
+	bool voice;
+
+	if (sum > 0) {
+		energy = voice_log2_q8(sum) - ext->log2_framesize;
+		if (energy < 0) {
+			energy = 0;
+		}
+	}
+
+	feat->position = ext->position;
+	feat->energy = energy;
+	feat->zcr = (uint16_t)((uint32_t)voice_zero_crossings(ext->frame, ext->framesize) * (VOICE_Q15_ONE - 1) / (ext->framesize - 1));
+
+	if (!ext->primed) {
+		ext->noise_floor = energy;
+		ext->primed = true;
+	}
+
+	voice = (energy > VOICE_ENERGY_MIN) &&
+			((energy > ext->noise_floor + margin) ||
+			 (energy > ext->noise_floor + margin / 2 && feat->zcr > VOICE_ZCR_FRICATIVE));
+
+	if (voice) {
+		ext->hold = ext->hangover;
+	} else if (ext->hold > 0) {
+		ext->hold--;
+	}
+
+	/* Follow the background down quickly and up slowly, so that speech doesn't lift it */
+	if (energy < ext->noise_floor) {
+		ext->noise_floor += (energy - ext->noise_floor) >> 1;
+	} else if (!voice) {
+		ext->noise_floor += (energy - ext->noise_floor) >> 5;
+	} else {
+		ext->noise_floor += (energy - ext->noise_floor) >> 9;
+	}
+
+	feat->noise_floor = ext->noise_floor;
+	feat->is_voice = voice || ext->hold > 0;
+
+#if VOICE_FEATURE_MEL_BANDS > 0
+	logmel_compute(ext, feat);
+#endif
+}
+
+bool voice_features_init(voice_feature_extractor_t *ext, int samprate, int framesize, int hopsize)
+{
+	if (ext == NULL || samprate <= 0 || framesize < 2 || hopsize <= 0 || hopsize > framesize) {
+		meddbg("invalid parameter, samprate %d framesize %d hopsize %d\n", samprate, framesize, hopsize);
+		return false;
+	}
+
+	memset(ext, 0, sizeof(*ext));
+	ext->samprate = samprate;
+	ext->framesize = framesize;
+	ext->hopsize = hopsize;
+	ext->log2_framesize = voice_log2_q8((uint64_t)framesize);
+	ext->hangover = CONFIG_MEDIA_VOICE_FEATURE_GATE_HANGOVER_MS * samprate / 1000 / hopsize;
+
+	ext->frame = (int16_t *)calloc(framesize, sizeof(int16_t));
+	if (ext->frame == NULL) {
+		meddbg("out of memory, framesize %d\n", framesize);
+		return false;
+	}
+
+#if VOICE_FEATURE_MEL_BANDS > 0
+	if (!logmel_init(ext)) {
+		meddbg("log-mel init failed\n");
+		voice_features_deinit(ext);
+		return false;
+	}
+#endif
+
+	return true;
+}
+
+void voice_features_deinit(voice_feature_extractor_t *ext)
+{
+	if (ext == NULL) {
+		return;
+	}
+
+#if VOICE_FEATURE_MEL_BANDS > 0
+	logmel_deinit(ext);
+#endif
+	free(ext->frame);
+	ext->frame = NULL;
+}
+
+void voice_features_reset(voice_feature_extractor_t *ext)
+{
+	ext->fill = 0;
+	ext->position = 0;
+	ext->noise_floor = 0;
+	ext->hold = 0;
+	ext->primed = false;
+}
+
+int voice_features_process(voice_feature_extractor_t *ext, const int16_t *samples, int nsamples, voice_features_cb_t cb, void *arg)
+{
+	voice_features_t feat;
+	int count = 0;
+
+	while (nsamples > 0) {
+		int take = ext->framesize - ext->fill;
+		if (take > nsamples) {
+			take = nsamples;
+		}
+
+		memcpy(&ext->frame[ext->fill], samples, take * sizeof(int16_t));
+		ext->fill += take;
+		ext->position += take;
+		samples += take;
+		nsamples -= take;
+
+		if (ext->fill < ext->framesize) {
+			break;
+		}
+
+		features_compute(ext, &feat);
+		if (cb) {
+			cb(&feat, arg);
+		}
+		count++;
+
+		/* Slide the window by one hop */
+		ext->fill = ext->framesize - ext->hopsize;
+		memmove(ext->frame, &ext->frame[ext->hopsize], ext->fill * sizeof(int16_t));
+	}
+
+	return count;
+}
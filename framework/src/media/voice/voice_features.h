@@ -0,0 +1,132 @@
+/******************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#ifndef __MEDIA_VOICE_FEATURES_H
+#define __MEDIA_VOICE_FEATURES_H
+
+#include <tinyara/config.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CONFIG_MEDIA_VOICE_FEATURE_FRAMESIZE
+#define CONFIG_MEDIA_VOICE_FEATURE_FRAMESIZE 256
+#endif
+
+#ifndef CONFIG_MEDIA_VOICE_FEATURE_HOPSIZE
+#define CONFIG_MEDIA_VOICE_FEATURE_HOPSIZE 160
+#endif
+
+#ifndef CONFIG_MEDIA_VOICE_FEATURE_GATE_MARGIN_DB
+#define CONFIG_MEDIA_VOICE_FEATURE_GATE_MARGIN_DB 9
+#endif
+
+#ifndef CONFIG_MEDIA_VOICE_FEATURE_GATE_HANGOVER_MS
+#define CONFIG_MEDIA_VOICE_FEATURE_GATE_HANGOVER_MS 300
+#endif
+
+#ifdef CONFIG_MEDIA_VOICE_FEATURE_LOGMEL
+#ifndef CONFIG_MEDIA_VOICE_FEATURE_MEL_BANDS
+#define CONFIG_MEDIA_VOICE_FEATURE_MEL_BANDS 24
+#endif
+#define VOICE_FEATURE_MEL_BANDS CONFIG_MEDIA_VOICE_FEATURE_MEL_BANDS
+#else
+#define VOICE_FEATURE_MEL_BANDS 0
+#endif
+
+/* Features of one analysis frame, computed once and shared by the software detectors */
+struct voice_features_s {
+	uint32_t position;          /* stream position (in samples) of the end of the frame */
+	int32_t energy;             /* log2 of the mean square of the frame, Q8 */
+	int32_t noise_floor;        /* tracked background energy, log2 Q8 */
+	uint16_t zcr;               /* zero-crossing rate, Q15 fraction of the sample pairs */
+	bool is_voice;              /* energy/ZCR gate decision, including hangover */
+#if VOICE_FEATURE_MEL_BANDS > 0
+	int16_t logmel[VOICE_FEATURE_MEL_BANDS];        /* log2 band energies, Q8 */
+#endif
+};
+
+typedef struct voice_features_s voice_features_t;
+
+typedef void (*voice_features_cb_t)(const voice_features_t *feat, void *arg);
+
+/* Streaming feature extractor, input can be delivered in any chunk size */
+struct voice_feature_extractor_s {
+	int samprate;
+	int framesize;
+	int hopsize;
+	int16_t *frame;             /* sliding analysis window */
+	int fill;                   /* valid samples in frame */
+	uint32_t position;
+	int32_t log2_framesize;     /* log2 Q8 of framesize, turns energy sums into means */
+	int32_t noise_floor;
+	int hangover;               /* gate hangover in hops */
+	int hold;                   /* hops left in the current hangover */
+	bool primed;
+#if VOICE_FEATURE_MEL_BANDS > 0
+	void *fft;
+	void *bank;
+	int16_t *window;
+	int16_t *fft_in;
+	int16_t *fft_out;
+	int32_t *ps;
+	int32_t *mel;
+#endif
+};
+
+typedef struct voice_feature_extractor_s voice_feature_extractor_t;
+
+/**
+ * @brief  Initialize the feature extractor
+ * @param  ext: Extractor object
+ * @param  samprate: Sample rate of the mono 16-bit input
+ * @param  framesize: Analysis frame length in samples
+ * @param  hopsize: Samples between two analysis frames, at most framesize
+ * @return true on success, false on failure.
+ */
+bool voice_features_init(voice_feature_extractor_t *ext, int samprate, int framesize, int hopsize);
+
+/**
+ * @brief  Release memory of the feature extractor
+ */
+void voice_features_deinit(voice_feature_extractor_t *ext);
+
+/**
+ * @brief  Drop buffered samples and the noise floor estimate
+ */
+void voice_features_reset(voice_feature_extractor_t *ext);
+
+/**
+ * @brief  Push samples, cb is called once for every completed hop
+ * @return Number of feature frames delivered
+ */
+int voice_features_process(voice_feature_extractor_t *ext, const int16_t *samples, int nsamples, voice_features_cb_t cb, void *arg);
+
+/* Kernels, with ARM DSP extension variants where available */
+uint64_t voice_sum_squares(const int16_t *x, int n);
+int voice_zero_crossings(const int16_t *x, int n);
+int32_t voice_log2_q8(uint64_t v);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __MEDIA_VOICE_FEATURES_H */
@@ -39,6 +39,9 @@
 #include <tinyara/fs/ioctl.h>
 #include <tinyara/clock.h>
 #include <tinyara/task_manager_drv.h>
+#ifdef CONFIG_EVENT_FD
+#include <sys/eventfd.h>
+#endif
 #include <task_manager/task_manager.h>
 #ifdef CONFIG_TASK_MANAGER_USER_SPECIFIC_BROADCAST
 #include <task_manager/task_manager_broadcast_list.h>
@@ -50,6 +53,9 @@
 static int g_taskmgr_fd;
 static uint32_t g_lasthandle;
 static mqd_t g_tm_recv_mqfd;
+#ifdef CONFIG_EVENT_FD
+static int g_tm_eventfd;
+#endif
 static int handle_cnt;
 static int task_cnt;
 #ifndef CONFIG_DISABLE_PTHREAD
@@ -400,11 +406,9 @@ static int taskmgr_start(int handle, int caller_pid)
 	return OK;
 }
 
-void taskmgr_update_stop_status(int signo, siginfo_t *data)
+static void taskmgr_stop_done(int handle)
 {
 	int ret;
-	int handle;
-	handle = taskmgr_get_handle_by_pid(data->si_value.sival_int);
 
 	/* Terminate based on task type */
 	ret = taskmgr_handle_tcb(TMIOC_TERMINATE, TM_PID(handle));
@@ -423,6 +427,38 @@ void taskmgr_update_stop_status(int signo, siginfo_t *data)
 	TM_STOP_CB_INFO(handle) = NULL;
 }
 
+#ifdef CONFIG_EVENT_FD
+/* Wait until a request is sent or a task has run its stop callback */
+
+static void taskmgr_wait_event(void)
+{
+	int handle;
+	eventfd_t events;
+
+	if (eventfd_read(g_tm_eventfd, &events) != OK) {
+		return;
+	}
+
+	if ((events & TM_EVENT_STOPPED) == 0) {
+		return;
+	}
+
+	sched_lock();
+	for (handle = 0; handle < CONFIG_TASK_MANAGER_MAX_TASKS; handle++) {
+		if (TM_LIST_ADDR(handle) != NULL && TM_STATUS(handle) == TM_APP_STATE_CANCELLING && TM_STOPPED(handle)) {
+			TM_STOPPED(handle) = false;
+			taskmgr_stop_done(handle);
+		}
+	}
+	sched_unlock();
+}
+#else
+void taskmgr_update_stop_status(int signo, siginfo_t *data)
+{
+	taskmgr_stop_done(taskmgr_get_handle_by_pid(data->si_value.sival_int));
+}
+#endif
+
 static int taskmgr_stop(int handle, int caller_pid)
 {
 	int ret;
@@ -444,6 +480,9 @@ static int taskmgr_stop(int handle, int caller_pid)
 
 	/* Call stop callback */
 	TM_STATUS(handle) = TM_APP_STATE_CANCELLING;
+#ifdef CONFIG_EVENT_FD
+	TM_STOPPED(handle) = false;
+#endif
 
 	if (TM_STOP_CB_INFO(handle) != NULL) {
 		cb_info = (tm_termination_info_t *)TM_ALLOC(sizeof(tm_termination_info_t));
@@ -853,6 +892,10 @@ static void taskmgr_termination_callback(void)
 	(void)close(g_taskmgr_fd);
 	mq_close(g_tm_recv_mqfd);
 	mq_unlink(TM_PUBLIC_MQ);
+#ifdef CONFIG_EVENT_FD
+	(void)close(g_tm_eventfd);
+	(void)unlink(TM_EVENT_FD);
+#endif
 }
 
 int taskmgr_get_handle_by_pid(int pid)
@@ -1374,7 +1417,9 @@ int task_manager(int argc, char *argv[])
 	tm_request_t request_msg;
 	tm_response_t response_msg;
 	struct mq_attr attr;
+#ifndef CONFIG_EVENT_FD
 	struct sigaction act;
+#endif
 #ifdef CONFIG_SCHED_HAVE_PARENT
 	sigignore(SIGCHLD);
 #endif
@@ -1391,7 +1436,24 @@ int task_manager(int argc, char *argv[])
 		return 0;
 	}
 
+#ifdef CONFIG_EVENT_FD
+	/* Requests and stopped tasks set the event flags, and the queue is only
+	 * read until it is empty.
+	 */
+	if (mkeventfd(TM_EVENT_FD, 0666) != OK) {
+		return 0;
+	}
+
+	g_tm_eventfd = open(TM_EVENT_FD, O_RDONLY);
+	if (g_tm_eventfd < 0) {
+		(void)unlink(TM_EVENT_FD);
+		return 0;
+	}
+
+	g_tm_recv_mqfd = mq_open(TM_PUBLIC_MQ, O_RDONLY | O_CREAT | O_NONBLOCK, 0666, &attr);
+#else
 	g_tm_recv_mqfd = mq_open(TM_PUBLIC_MQ, O_RDONLY | O_CREAT, 0666, &attr);
+#endif
 	if (g_tm_recv_mqfd < 0) {
 		return 0;
 	}
@@ -1401,6 +1463,7 @@ int task_manager(int argc, char *argv[])
 		return 0;
 	}
 
+#ifndef CONFIG_EVENT_FD
 	act.sa_sigaction = (_sa_sigaction_t)taskmgr_update_stop_status;
 	act.sa_flags = 0;
 	(void)sigemptyset(&act.sa_mask);
@@ -1416,12 +1479,18 @@ int task_manager(int argc, char *argv[])
 		tmdbg("sigaction Failed\n");
 		return TM_OPERATION_FAIL;
 	}
+#endif
 
 	while (1) {
 		ret = ERROR;
 
 		nbytes = mq_receive(g_tm_recv_mqfd, (char *)&request_msg, sizeof(tm_request_t), NULL);
 		if (nbytes <= 0) {
+#ifdef CONFIG_EVENT_FD
+			if (errno == EAGAIN) {
+				taskmgr_wait_event();
+			}
+#endif
 			continue;
 		}
 
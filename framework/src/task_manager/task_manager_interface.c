@@ -61,9 +61,38 @@ int taskmgr_send_request(tm_request_t *request_msg)
 
 	mq_close(g_tm_send_mqfd);
 
+#ifdef CONFIG_EVENT_FD
+	/* Task Manager waits for the event flags, not for the queue */
+	if (taskmgr_notify(TM_EVENT_REQUEST) != OK) {
+		return TM_COMMUCATION_FAIL;
+	}
+#endif
+
 	return OK;
 }
 
+#ifdef CONFIG_EVENT_FD
+int taskmgr_notify(eventfd_t event)
+{
+	int fd;
+	int ret;
+
+	fd = open(TM_EVENT_FD, O_WRONLY);
+	if (fd < 0) {
+		tmdbg("open %s failed! %d\n", TM_EVENT_FD, errno);
+		return ERROR;
+	}
+
+	ret = eventfd_write(fd, event);
+	if (ret != OK) {
+		tmdbg("eventfd_write failed! %d\n", errno);
+	}
+	close(fd);
+
+	return ret;
+}
+#endif
+
 int taskmgr_send_response(char *q_name, tm_response_t *response_msg)
 {
 	int status;
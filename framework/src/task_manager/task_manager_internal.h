@@ -29,6 +29,9 @@
 #endif
 #include <queue.h>
 #include <sys/types.h>
+#ifdef CONFIG_EVENT_FD
+#include <sys/eventfd.h>
+#endif
 #include <task_manager/task_manager.h>
 
 /* Command Types */
@@ -70,6 +73,13 @@
 #define TM_PRIVATE_MQ "tm_priv_mq"
 #define TM_UNICAST_MQ "tm_unicast_mq"
 
+#ifdef CONFIG_EVENT_FD
+/* The event flags which wake up the Task Manager */
+#define TM_EVENT_FD         "/dev/tm_event"
+#define TM_EVENT_REQUEST    (1 << 0)	/* A request is in TM_PUBLIC_MQ */
+#define TM_EVENT_STOPPED    (1 << 1)	/* A task ran its stop callback */
+#endif
+
 /* Wrapper of allocation APIs */
 #define TM_ALLOC(a)  malloc(a)
 #define TM_FREE(a)   free(a)
@@ -125,6 +135,9 @@ struct app_list_data_s {
 	sq_queue_t broadcast_info_list;
 	tm_termination_info_t *stop_cb_info;
 	tm_termination_info_t *exit_cb_info;
+#ifdef CONFIG_EVENT_FD
+	volatile bool stopped;
+#endif
 };
 typedef struct app_list_data_s app_list_data_t;
 
@@ -198,12 +211,18 @@ typedef struct tm_broadcast_internal_msg_s tm_broadcast_internal_msg_t;
 #define TM_BROADCAST_INFO_LIST(handle)  TM_LIST_ADDR(handle)->broadcast_info_list
 #define TM_STOP_CB_INFO(handle)         TM_LIST_ADDR(handle)->stop_cb_info
 #define TM_EXIT_CB_INFO(handle)         TM_LIST_ADDR(handle)->exit_cb_info
+#ifdef CONFIG_EVENT_FD
+#define TM_STOPPED(handle)              TM_LIST_ADDR(handle)->stopped
+#endif
 
 extern app_list_t tm_app_list[CONFIG_TASK_MANAGER_MAX_TASKS];
 
 int taskmgr_send_request(tm_request_t *request_msg);
 int taskmgr_send_response(char *q_name, tm_response_t *response_msg);
 int taskmgr_receive_response(char *q_name, tm_response_t *response_msg, int timeout);
+#ifdef CONFIG_EVENT_FD
+int taskmgr_notify(eventfd_t event);
+#endif
 
 bool taskmgr_is_permitted(int handle, pid_t pid);
 int taskmgr_get_task_state(int handle);
@@ -113,7 +113,11 @@ void taskmgr_msg_cb(int signo, siginfo_t *data)
 void taskmgr_stop_cb(int signo, siginfo_t *data)
 {
 	int taskmgr_pid;
+#ifdef CONFIG_EVENT_FD
+	int handle;
+#else
 	union sigval msg;
+#endif
 	tm_termination_info_t *cb_info;
 	cb_info = (tm_termination_info_t *)data->si_value.sival_ptr;
 
@@ -137,9 +141,19 @@ void taskmgr_stop_cb(int signo, siginfo_t *data)
 		tmdbg("Task Manager is not alive\n");
 		return;
 	}
+#ifdef CONFIG_EVENT_FD
+	handle = taskmgr_get_handle_by_pid(getpid());
+	if (handle == TM_UNREGISTERED_APP) {
+		return;
+	}
+	TM_STOPPED(handle) = true;
+
+	(void)taskmgr_notify(TM_EVENT_STOPPED);
+#else
 	msg.sival_int = getpid();
 
 	(void)sigqueue(taskmgr_pid, SIGTM_TERMINATION, msg);
+#endif
 }
 
 /****************************************************************************
@@ -0,0 +1,111 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * libc/misc/lib_eventfd.c
+ *
+ * The helpers of the event flags file descriptors, over read(), write()
+ * and ioctl().
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <tinyara/eventfd.h>
+
+#ifdef CONFIG_EVENT_FD
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: eventfd_read
+ *
+ * Description:
+ *   Wait for any event flag, return them all and clear them.
+ *
+ ****************************************************************************/
+
+int eventfd_read(int fd, FAR eventfd_t *value)
+{
+	return read(fd, value, sizeof(eventfd_t)) == sizeof(eventfd_t) ? OK : ERROR;
+}
+
+/****************************************************************************
+ * Name: eventfd_write
+ *
+ * Description:
+ *   Set event flags.
+ *
+ ****************************************************************************/
+
+int eventfd_write(int fd, eventfd_t value)
+{
+	return write(fd, &value, sizeof(eventfd_t)) == sizeof(eventfd_t) ? OK : ERROR;
+}
+
+/****************************************************************************
+ * Name: eventfd_wait
+ *
+ * Description:
+ *   Wait for any or all of the event flags of mask, for timeout
+ *   milliseconds or forever if it is negative.
+ *
+ ****************************************************************************/
+
+int eventfd_wait(int fd, eventfd_t mask, int options, int timeout, FAR eventfd_t *value)
+{
+	struct eventfd_wait_s wait;
+
+	wait.mask = mask;
+	wait.options = (uint8_t)options;
+	wait.timeout = timeout;
+	wait.value = 0;
+
+	if (ioctl(fd, EFDIOC_WAIT, (unsigned long)&wait) < 0) {
+		return ERROR;
+	}
+
+	if (value) {
+		*value = wait.value;
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: eventfd_clear
+ *
+ * Description:
+ *   Clear the event flags of mask.
+ *
+ ****************************************************************************/
+
+int eventfd_clear(int fd, eventfd_t mask)
+{
+	return ioctl(fd, EFDIOC_CLEAR, (unsigned long)mask) < 0 ? ERROR : OK;
+}
+
+#endif							/* CONFIG_EVENT_FD */
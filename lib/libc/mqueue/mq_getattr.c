@@ -111,6 +111,11 @@ int mq_getattr(mqd_t mqdes, struct mq_attr *mq_stat)
 		mq_stat->mq_maxmsg = mqdes->msgq->maxmsgs;
 		mq_stat->mq_msgsize = mqdes->msgq->maxmsgsize;
 		mq_stat->mq_flags = mqdes->oflags;
+#ifdef CONFIG_MQ_ZEROCOPY
+		if (mqdes->msgq->zerocopy) {
+			mq_stat->mq_flags |= MQ_ZEROCOPY;
+		}
+#endif
 		mq_stat->mq_curmsgs = (size_t)mqdes->msgq->nmsgs;
 
 		ret = OK;
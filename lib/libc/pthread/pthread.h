@@ -0,0 +1,142 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * lib/libc/pthread/pthread.h
+ *
+ * The fast path of the pthread mutexes of the user space with
+ * CONFIG_PTHREAD_MUTEX_FASTPATH.  The pid of the mutex is the owner word:
+ *
+ * - _PTHREAD_MPID_FREE: the mutex is free, a thread locks it by setting it
+ *   to its owner word, with an atomic compare-and-swap, and unlocks it by
+ *   setting it back.
+ * - owner word, with _PTHREAD_MPID_FAST: the thread holds the mutex and the
+ *   kernel doesn't know it.  Any other thread makes the system call,
+ *   where the kernel takes the mutex over: it replaces the owner word by
+ *   the pid and records the thread as the holder of the semaphore, which boosts
+ *   it when a thread of higher priority waits for the mutex.
+ * - anything else: the kernel holds the mutex for a thread, or for a
+ *   woken waiter with _PTHREAD_MPID_HANDOFF, and the mutex is locked and
+ *   unlocked with the system calls.
+ *
+ * The owner word of the running thread is g_curowner: its pid with
+ * _PTHREAD_MPID_FAST and the generation of the pid, set by the kernel on
+ * each context switch once task_startup() registered it.  The kernel only updates the pid of a mutex after an
+ * exception, which clears the exclusive monitor, so a compare-and-swap
+ * racing with it fails.
+ *
+ ****************************************************************************/
+
+#ifndef __LIBC_PTHREAD_PTHREAD_H
+#define __LIBC_PTHREAD_PTHREAD_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include <tinyara/userspace.h>
+
+#if defined(CONFIG_PTHREAD_MUTEX_FASTPATH) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_mutex_fasttake
+ *
+ * Description:
+ *   Lock a free mutex, or lock again a recursive mutex the caller locked
+ *   in the user space.
+ *
+ * Return Value:
+ *   true if the mutex was locked, false if the caller must make the system
+ *   call.
+ *
+ ****************************************************************************/
+
+static inline bool pthread_mutex_fasttake(FAR pthread_mutex_t *mutex)
+{
+	int mine = g_curowner;
+	int pid = _PTHREAD_MPID_FREE;
+
+	/* g_curowner is 0 until the kernel sets it */
+
+	if (mine == 0) {
+		return false;
+	}
+
+	if (__atomic_compare_exchange_n(&mutex->pid, &pid, mine, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+		mutex->nlocks = 1;
+#endif
+		return true;
+	}
+
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+	/* Only the holder changes the count of locks */
+
+	if (pid == mine && mutex->type == PTHREAD_MUTEX_RECURSIVE && mutex->nlocks < INT16_MAX) {
+		mutex->nlocks++;
+		return true;
+	}
+#endif
+	return false;
+}
+
+/****************************************************************************
+ * Name: pthread_mutex_fastgive
+ *
+ * Description:
+ *   Unlock a mutex the caller locked in the user space.
+ *
+ * Return Value:
+ *   true if the mutex was unlocked, false if the caller must make the
+ *   system call, as the kernel holds the mutex or the caller doesn't.
+ *
+ ****************************************************************************/
+
+static inline bool pthread_mutex_fastgive(FAR pthread_mutex_t *mutex)
+{
+	int mine = g_curowner;
+
+	if (mine == 0 || mutex->pid != mine) {
+		return false;
+	}
+
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+	if (mutex->type == PTHREAD_MUTEX_RECURSIVE && mutex->nlocks > 1) {
+		mutex->nlocks--;
+		return true;
+	}
+
+	/* The system call unlocks it all if the kernel took the mutex over */
+
+	mutex->nlocks = 0;
+#endif
+	return __atomic_compare_exchange_n(&mutex->pid, &mine, _PTHREAD_MPID_FREE, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+}
+
+#endif							/* CONFIG_PTHREAD_MUTEX_FASTPATH && !__KERNEL__ */
+#endif							/* __LIBC_PTHREAD_PTHREAD_H */
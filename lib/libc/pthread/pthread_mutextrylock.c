@@ -0,0 +1,60 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * lib/libc/pthread/pthread_mutextrylock.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <syscall.h>
+
+#include "pthread/pthread.h"
+
+#if defined(CONFIG_PTHREAD_MUTEX_FASTPATH) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_mutex_trylock
+ *
+ * Description:
+ *   The pthread_mutex_trylock() of the user space with
+ *   CONFIG_PTHREAD_MUTEX_FASTPATH: a free mutex is locked without the system
+ *   call, which reports why another one can't be.
+ *
+ ****************************************************************************/
+
+int pthread_mutex_trylock(FAR pthread_mutex_t *mutex)
+{
+	if (mutex != NULL && pthread_mutex_fasttake(mutex)) {
+		return OK;
+	}
+
+	return (int)sys_call1((unsigned int)SYS_pthread_mutex_trylock, (uintptr_t)mutex);
+}
+
+#endif							/* CONFIG_PTHREAD_MUTEX_FASTPATH && !__KERNEL__ */
@@ -0,0 +1,61 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * lib/libc/pthread/pthread_mutexunlock.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <syscall.h>
+
+#include "pthread/pthread.h"
+
+#if defined(CONFIG_PTHREAD_MUTEX_FASTPATH) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_mutex_unlock
+ *
+ * Description:
+ *   The pthread_mutex_unlock() of the user space with
+ *   CONFIG_PTHREAD_MUTEX_FASTPATH: a mutex locked without the system call
+ *   is unlocked without it too, unless the kernel took it over for a
+ *   waiting thread, which it then wakes up.
+ *
+ ****************************************************************************/
+
+int pthread_mutex_unlock(FAR pthread_mutex_t *mutex)
+{
+	if (mutex != NULL && pthread_mutex_fastgive(mutex)) {
+		return OK;
+	}
+
+	return (int)sys_call1((unsigned int)SYS_pthread_mutex_unlock, (uintptr_t)mutex);
+}
+
+#endif							/* CONFIG_PTHREAD_MUTEX_FASTPATH && !__KERNEL__ */
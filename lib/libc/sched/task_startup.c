@@ -58,6 +58,9 @@
 
 #include <stdlib.h>
 #include <assert.h>
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+#include <sys/prctl.h>
+#endif
 
 #include <tinyara/userspace.h>
 
@@ -111,6 +114,17 @@ void task_startup(main_t entrypt, int argc, FAR char *argv[])
 {
 	DEBUGASSERT(entrypt);
 
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+	/* The first task of the user space registers the word where the kernel
+	 * publishes the owner word of the running thread for the fast path of
+	 * the pthread mutexes.  The mutexes make the system calls until then.
+	 */
+
+	if (g_curowner == 0) {
+		(void)prctl(PR_SET_MUTEX_OWNER, &g_curowner);
+	}
+#endif
+
 	/* Call the 'main' entry point passing argc and argv, calling exit()
 	 * if/when the task returns.
 	 */
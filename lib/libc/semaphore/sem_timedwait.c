@@ -0,0 +1,62 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * lib/libc/semaphore/sem_timedwait.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <semaphore.h>
+#include <syscall.h>
+
+#include "semaphore/semaphore.h"
+
+#if defined(CONFIG_SEM_FASTPATH) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sem_timedwait
+ *
+ * Description:
+ *   The sem_timedwait() of the user space with CONFIG_SEM_FASTPATH: a
+ *   free count is taken without the system call, which only waits for one.
+ *   As in the kernel, abstime isn't checked when a count is free.
+ *
+ ****************************************************************************/
+
+int sem_timedwait(FAR sem_t *sem, FAR const struct timespec *abstime)
+{
+#ifndef CONFIG_CANCELLATION_POINTS
+	if (SEM_ISFAST(sem) && sem_fasttake(sem)) {
+		return OK;
+	}
+#endif
+
+	return (int)sys_call2((unsigned int)SYS_sem_timedwait, (uintptr_t)sem, (uintptr_t)abstime);
+}
+
+#endif							/* CONFIG_SEM_FASTPATH && !__KERNEL__ */
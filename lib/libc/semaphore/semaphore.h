@@ -0,0 +1,128 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * lib/libc/semaphore/semaphore.h
+ *
+ * The fast path of the semaphores of the user space with
+ * CONFIG_SEM_FASTPATH.  A count is taken or given with an atomic
+ * compare-and-swap of semcount, and the system call is only made when the
+ * caller must wait or a waiting thread must be woken up:
+ *
+ * - semcount > 0: counts are free, a count is taken by decrementing it.
+ * - semcount <= 0: -semcount threads are waiting in the kernel, a count
+ *   can only be given by sem_post() in the kernel, which wakes one up.
+ *
+ * The kernel only updates semcount after an exception, which clears the
+ * exclusive monitor (CONFIG_ARCH_HAVE_ATOMICS), so a compare-and-swap
+ * racing with it fails and is retried.
+ *
+ ****************************************************************************/
+
+#ifndef __LIBC_SEMAPHORE_SEMAPHORE_H
+#define __LIBC_SEMAPHORE_SEMAPHORE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <limits.h>
+#include <semaphore.h>
+
+#if defined(CONFIG_SEM_FASTPATH) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Whether a semaphore may take the fast path.  The holders of a semaphore
+ * with priority inheritance are recorded by the kernel, so it always makes
+ * the system call: a count has no owner the kernel could record later, as
+ * the owner word of a pthread mutex is (pthread/pthread.h).  An invalid
+ * semaphore is left to the kernel to report.
+ */
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+#define SEM_FASTPATH_FLAGS (FLAGS_INITIALIZED | PRIOINHERIT_FLAGS_DISABLE)
+#else
+#define SEM_FASTPATH_FLAGS FLAGS_INITIALIZED
+#endif
+
+#define SEM_ISFAST(s) \
+	((s) != NULL && ((s)->flags & SEM_FASTPATH_FLAGS) == SEM_FASTPATH_FLAGS)
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sem_fasttake
+ *
+ * Description:
+ *   Take a count of a semaphore if one is free.
+ *
+ * Return Value:
+ *   true if a count was taken, false if the caller must make the system
+ *   call.
+ *
+ ****************************************************************************/
+
+static inline bool sem_fasttake(FAR sem_t *sem)
+{
+	int16_t count = __atomic_load_n(&sem->semcount, __ATOMIC_RELAXED);
+
+	while (count > 0) {
+		if (__atomic_compare_exchange_n(&sem->semcount, &count, count - 1, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/****************************************************************************
+ * Name: sem_fastgive
+ *
+ * Description:
+ *   Give a count to a semaphore if no thread waits for it.
+ *
+ * Return Value:
+ *   true if the count was given, false if the caller must make the system
+ *   call to wake up a waiting thread.
+ *
+ ****************************************************************************/
+
+static inline bool sem_fastgive(FAR sem_t *sem)
+{
+	int16_t count = __atomic_load_n(&sem->semcount, __ATOMIC_RELAXED);
+
+	/* An overflow is left to the kernel to assert */
+
+	while (count >= 0 && count < SEM_VALUE_MAX) {
+		if (__atomic_compare_exchange_n(&sem->semcount, &count, count + 1, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+#endif							/* CONFIG_SEM_FASTPATH && !__KERNEL__ */
+#endif							/* __LIBC_SEMAPHORE_SEMAPHORE_H */
@@ -275,6 +275,11 @@ static inline irqstate_t irqsave(void)
 
 	uint8_t basepri = getbasepri();
 	setbasepri(NVIC_SYSH_DISABLE_PRIORITY);
+#ifdef HAVE_IRQOFF_STATS
+	if (basepri == 0) {
+		sched_stats_irqoff();
+	}
+#endif
 	return (irqstate_t)basepri;
 
 #else
@@ -294,6 +299,11 @@ static inline irqstate_t irqsave(void)
 		: "memory"
 	);
 
+#ifdef HAVE_IRQOFF_STATS
+	if ((primask & 1) == 0) {
+		sched_stats_irqoff();
+	}
+#endif
 	return primask;
 #endif
 }
@@ -313,12 +323,23 @@ static inline void irqrestore(irqstate_t flags) inline_function;
 static inline void irqrestore(irqstate_t flags)
 {
 #ifdef CONFIG_ARMV7M_USEBASEPRI
+#ifdef HAVE_IRQOFF_STATS
+	if (flags == 0) {
+		sched_stats_irqon();
+	}
+#endif
 	setbasepri((uint32_t)flags);
 #else
 	/* If bit 0 of the primask is 0, then we need to restore
 	 * interrupts.
 	 */
 
+#ifdef HAVE_IRQOFF_STATS
+	if ((flags & 1) == 0) {
+		sched_stats_irqon();
+	}
+#endif
+
 	__asm__ __volatile__
 	(
 		"\ttst    %0, #1\n"
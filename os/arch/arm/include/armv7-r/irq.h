@@ -408,6 +408,13 @@ static inline irqstate_t irqsave(void)
 		: "memory"
 	);
 
+#ifdef HAVE_IRQOFF_STATS
+	/* Bit 7 of the CPSR is the IRQ mask bit */
+
+	if ((cpsr & (1 << 7)) == 0) {
+		sched_stats_irqoff();
+	}
+#endif
 	return cpsr;
 }
 
@@ -436,6 +443,11 @@ static inline irqstate_t irqenable(void)
 
 static inline void irqrestore(irqstate_t flags)
 {
+#ifdef HAVE_IRQOFF_STATS
+	if ((flags & (1 << 7)) == 0) {
+		sched_stats_irqon();
+	}
+#endif
 	__asm__ __volatile__
 	(
 		"msr    cpsr_c, %0"
@@ -151,6 +151,7 @@ void up_block_task(struct tcb_s *tcb, tstate_t task_state)
 			 * of the g_readytorun task list.
 			 */
 
+			sched_switch_hook(rtcb, this_task());
 			rtcb = this_task();
 
 #ifdef CONFIG_TASK_SCHED_HISTORY
@@ -175,6 +176,7 @@ void up_block_task(struct tcb_s *tcb, tstate_t task_state)
 			/* Save the task name which will be scheduled */
 			save_task_scheduling_status(nexttcb);
 #endif
+			sched_switch_hook(rtcb, nexttcb);
 			up_switchcontext(rtcb->xcp.regs, nexttcb->xcp.regs);
 
 			/* up_switchcontext forces a context switch to the task at the
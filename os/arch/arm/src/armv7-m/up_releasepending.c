@@ -119,6 +119,7 @@ void up_release_pending(void)
 			 * of the g_readytorun task list.
 			 */
 
+			sched_switch_hook(rtcb, this_task());
 			rtcb = this_task();
 			sllvdbg("New Active Task TCB=%p\n", rtcb);
 
@@ -143,6 +144,7 @@ void up_release_pending(void)
 			/* Save the task name which will be scheduled */
 			save_task_scheduling_status(nexttcb);
 #endif
+			sched_switch_hook(rtcb, nexttcb);
 			up_switchcontext(rtcb->xcp.regs, nexttcb->xcp.regs);
 
 			/* up_switchcontext forces a context switch to the task at the
@@ -141,6 +141,7 @@ void up_block_task(struct tcb_s *tcb, tstate_t task_state)
 			 * of the g_readytorun task list.
 			 */
 
+			sched_switch_hook(rtcb, this_task());
 			rtcb = this_task();
 
 #ifdef CONFIG_TASK_SCHED_HISTORY
@@ -162,6 +163,7 @@ void up_block_task(struct tcb_s *tcb, tstate_t task_state)
 			 * of the g_readytorun task list.
 			 */
 
+			sched_switch_hook(rtcb, this_task());
 			rtcb = this_task();
 
 #ifdef CONFIG_TASK_SCHED_HISTORY
@@ -110,6 +110,7 @@ void up_release_pending(void)
 			 * of the g_readytorun task list.
 			 */
 
+			sched_switch_hook(rtcb, this_task());
 			rtcb = this_task();
 
 #ifdef CONFIG_TASK_SCHED_HISTORY
@@ -134,6 +135,7 @@ void up_release_pending(void)
 			 * of the g_readytorun task list.
 			 */
 
+			sched_switch_hook(rtcb, this_task());
 			rtcb = this_task();
 
 #ifdef CONFIG_TASK_SCHED_HISTORY
@@ -159,6 +159,7 @@ void up_reprioritize_rtr(struct tcb_s *tcb, uint8_t priority)
 				 * of the g_readytorun task list.
 				 */
 
+				sched_switch_hook(rtcb, this_task());
 				rtcb = this_task();
 
 				/* Then switch contexts.  Any necessary address environment
@@ -181,6 +182,7 @@ void up_reprioritize_rtr(struct tcb_s *tcb, uint8_t priority)
 				 * of the g_readytorun task list.
 				 */
 
+				sched_switch_hook(rtcb, this_task());
 				rtcb = this_task();
 
 				/* Then switch contexts */
@@ -137,6 +137,7 @@ void up_unblock_task(struct tcb_s *tcb)
 			 * of the g_readytorun task list.
 			 */
 
+			sched_switch_hook(rtcb, this_task());
 			rtcb = this_task();
 
 			trace_sched(NULL, rtcb);
@@ -165,6 +166,7 @@ void up_unblock_task(struct tcb_s *tcb)
 			 * g_readytorun task list.
 			 */
 
+			sched_switch_hook(rtcb, this_task());
 			rtcb = this_task();
 			trace_sched(NULL, rtcb);
 
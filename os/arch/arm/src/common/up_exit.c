@@ -176,6 +176,7 @@ void _exit(int status)
 	 */
 
 	tcb = this_task();
+	sched_switch_hook(NULL, tcb);
 
 #ifdef CONFIG_ARCH_ADDRENV
 	/* Make sure that the address environment for the previously running
@@ -67,6 +67,7 @@ void up_schedyield(struct tcb_s *rtcb)
 		 * of the g_readytorun task list.
 		 */
 
+		sched_switch_hook(rtcb, this_task());
 		rtcb = this_task();
 		/* Then switch contexts.  Any necessary address environment
 		 * changes will be made when the interrupt returns.
@@ -85,6 +86,7 @@ void up_schedyield(struct tcb_s *rtcb)
 		 * of the g_readytorun task list.
 		 */
 
+		sched_switch_hook(rtcb, this_task());
 		rtcb = this_task();
 		/* Then switch contexts */
 
@@ -139,6 +139,7 @@ void up_block_task(struct tcb_s *tcb, tstate_t task_state)
 			 * of the ready-to-run task list.
 			 */
 
+			sched_switch_hook(rtcb, this_task());
 			rtcb = this_task();
 			rtcb->timeslice = MSEC2TICK(CONFIG_RR_INTERVAL);
 
@@ -167,6 +168,7 @@ void up_block_task(struct tcb_s *tcb, tstate_t task_state)
 			 * of the ready-to-run task list.
 			 */
 
+			sched_switch_hook(rtcb, this_task());
 			rtcb = this_task();
 
 #if XCHAL_CP_NUM > 0
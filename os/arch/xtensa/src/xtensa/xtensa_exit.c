@@ -185,6 +185,7 @@ void _exit(int status)
 	 */
 
 	tcb = this_task();
+	sched_switch_hook(NULL, tcb);
 
 #if XCHAL_CP_NUM > 0
 	/* Set up the co-processor state for the newly started thread. */
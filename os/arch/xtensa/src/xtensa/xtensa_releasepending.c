@@ -109,6 +109,7 @@ void up_release_pending(void)
 			 * of the ready-to-run task list.
 			 */
 
+			sched_switch_hook(rtcb, this_task());
 			rtcb = this_task();
 
 			/* Update scheduler parameters */
@@ -138,6 +139,7 @@ void up_release_pending(void)
 			 * of the ready-to-run task list.
 			 */
 
+			sched_switch_hook(rtcb, this_task());
 			rtcb = this_task();
 
 #if XCHAL_CP_NUM > 0
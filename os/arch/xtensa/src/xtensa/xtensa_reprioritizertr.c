@@ -155,6 +155,7 @@ void up_reprioritize_rtr(struct tcb_s *tcb, uint8_t priority)
 				 * of the ready-to-run task list.
 				 */
 
+				sched_switch_hook(rtcb, this_task());
 				rtcb = this_task();
 
 				/* Then switch contexts.  Any necessary address environment
@@ -181,6 +182,7 @@ void up_reprioritize_rtr(struct tcb_s *tcb, uint8_t priority)
 				 * of the ready-to-run task list.
 				 */
 
+				sched_switch_hook(rtcb, this_task());
 				rtcb = this_task();
 
 #if XCHAL_CP_NUM > 0
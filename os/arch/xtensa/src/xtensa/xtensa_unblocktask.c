@@ -124,6 +124,7 @@ void up_unblock_task(struct tcb_s *tcb)
 			 * of the ready-to-run task list.
 			 */
 
+			sched_switch_hook(rtcb, this_task());
 			rtcb = this_task();
 
 			/* Update scheduler parameters */
@@ -158,6 +159,7 @@ void up_unblock_task(struct tcb_s *tcb)
 			 * ready-to-run task list.
 			 */
 
+			sched_switch_hook(rtcb, this_task());
 			rtcb = this_task();
 
 #if XCHAL_CP_NUM > 0
@@ -0,0 +1,593 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * drivers/eventfd.c
+ *
+ * Event flags file descriptors: 32 flags which tasks set by write() and
+ * wait for by read(), poll() or the EFDIOC_WAIT ioctl. The flags are only
+ * touched with interrupts disabled, and setting them allocates nothing.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <poll.h>
+#include <time.h>
+#include <errno.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/clock.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/eventfd.h>
+#include <tinyara/fs/fs.h>
+
+#ifdef CONFIG_EVENT_FD
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EVENT_FD_NPOLLWAITERS
+#define CONFIG_EVENT_FD_NPOLLWAITERS 2
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct eventfd_dev_s {
+	eventfd_t flags;			/* The flags set */
+	sem_t waitsem;				/* The tasks waiting for flags */
+	uint8_t crefs;				/* The number of open references */
+	bool unlinked;				/* Free on the last close */
+#ifndef CONFIG_DISABLE_POLL
+	FAR struct pollfd *fds[CONFIG_EVENT_FD_NPOLLWAITERS];
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int eventfd_open(FAR struct file *filep);
+static int eventfd_close(FAR struct file *filep);
+static ssize_t eventfd_fread(FAR struct file *filep, FAR char *buffer, size_t len);
+static ssize_t eventfd_fwrite(FAR struct file *filep, FAR const char *buffer, size_t len);
+static int eventfd_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
+#ifndef CONFIG_DISABLE_POLL
+static int eventfd_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
+#endif
+static int eventfd_unlink(FAR struct inode *inode);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations eventfd_fops = {
+	eventfd_open,				/* open */
+	eventfd_close,				/* close */
+	eventfd_fread,				/* read */
+	eventfd_fwrite,				/* write */
+	0,							/* seek */
+	eventfd_ioctl,				/* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+	eventfd_poll,				/* poll */
+#endif
+	eventfd_unlink				/* unlink */
+};
+
+/* Serializes the creation of the anonymous event flags, numbered so that
+ * their transient paths never collide.
+ */
+
+static sem_t g_efdsem = SEM_INITIALIZER(1);
+static uint32_t g_efdno;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: eventfd_allocdev
+ ****************************************************************************/
+
+static FAR struct eventfd_dev_s *eventfd_allocdev(void)
+{
+	FAR struct eventfd_dev_s *dev;
+
+	dev = (FAR struct eventfd_dev_s *)kmm_zalloc(sizeof(struct eventfd_dev_s));
+	if (dev) {
+		/* The semaphore is only used to wait, so no priority inheritance */
+
+		sem_init(&dev->waitsem, 0, 0);
+#ifdef CONFIG_PRIORITY_INHERITANCE
+		sem_setprotocol(&dev->waitsem, SEM_PRIO_NONE);
+#endif
+	}
+
+	return dev;
+}
+
+/****************************************************************************
+ * Name: eventfd_freedev
+ ****************************************************************************/
+
+static void eventfd_freedev(FAR struct eventfd_dev_s *dev)
+{
+	sem_destroy(&dev->waitsem);
+	kmm_free(dev);
+}
+
+/****************************************************************************
+ * Name: eventfd_pollnotify
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static void eventfd_pollnotify(FAR struct eventfd_dev_s *dev, pollevent_t eventset)
+{
+	FAR struct pollfd *fds;
+	int i;
+
+	for (i = 0; i < CONFIG_EVENT_FD_NPOLLWAITERS; i++) {
+		fds = dev->fds[i];
+		if (fds) {
+			fds->revents |= (fds->events & eventset);
+			if (fds->revents != 0) {
+				sem_post(fds->sem);
+			}
+		}
+	}
+}
+#else
+#define eventfd_pollnotify(dev, eventset)
+#endif
+
+/****************************************************************************
+ * Name: eventfd_waitflags
+ *
+ * Description:
+ *   Wait until any of the flags of mask are set, or all of them with
+ *   EFD_WAIT_ALL, and clear them with EFD_CLEAR.
+ *
+ * Input Parameters:
+ *   dev     - The event flags
+ *   mask    - The flags to wait for
+ *   options - EFD_WAIT_ALL, EFD_CLEAR
+ *   timeout - The time to wait in milliseconds, 0 not to wait, or -1 to
+ *             wait forever
+ *   value   - The location to return the flags set when the wait was over
+ *
+ * Returned Value:
+ *   OK on success, -ETIMEDOUT after the timeout, -EINTR if a signal was
+ *   received.
+ *
+ ****************************************************************************/
+
+static int eventfd_waitflags(FAR struct eventfd_dev_s *dev, eventfd_t mask, uint8_t options, int timeout, FAR eventfd_t *value)
+{
+	struct timespec abstime;
+	irqstate_t flags;
+	eventfd_t set;
+	int ret = OK;
+
+	if (timeout > 0) {
+		clock_gettime(CLOCK_REALTIME, &abstime);
+		abstime.tv_sec += timeout / MSEC_PER_SEC;
+		abstime.tv_nsec += (timeout % MSEC_PER_SEC) * NSEC_PER_MSEC;
+		if (abstime.tv_nsec >= NSEC_PER_SEC) {
+			abstime.tv_sec++;
+			abstime.tv_nsec -= NSEC_PER_SEC;
+		}
+	}
+
+	/* Setting the flags wakes up all the waiters, which check them again */
+
+	flags = irqsave();
+	for (;;) {
+		set = dev->flags & mask;
+		if ((options & EFD_WAIT_ALL) != 0 ? set == mask : set != 0) {
+			break;
+		}
+
+		if (timeout == 0) {
+			ret = -ETIMEDOUT;
+			goto errout;
+		}
+
+		if (timeout < 0) {
+			ret = sem_wait(&dev->waitsem);
+		} else {
+			ret = sem_timedwait(&dev->waitsem, &abstime);
+		}
+
+		if (ret < 0) {
+			ret = -get_errno();
+			goto errout;
+		}
+	}
+
+	*value = dev->flags;
+	if ((options & EFD_CLEAR) != 0) {
+		dev->flags &= ~mask;
+	}
+
+errout:
+	irqrestore(flags);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: eventfd_setflags
+ ****************************************************************************/
+
+static void eventfd_setflags(FAR struct eventfd_dev_s *dev, eventfd_t value)
+{
+	irqstate_t flags;
+	int sval;
+
+	/* The waiters run once all of them are woken up */
+
+	sched_lock();
+	flags = irqsave();
+
+	dev->flags |= value;
+	if (dev->flags != 0) {
+		if (sem_getvalue(&dev->waitsem, &sval) == 0) {
+			while (sval++ < 0) {
+				sem_post(&dev->waitsem);
+			}
+		}
+
+		eventfd_pollnotify(dev, POLLIN);
+	}
+
+	irqrestore(flags);
+	sched_unlock();
+}
+
+/****************************************************************************
+ * Name: eventfd_open
+ ****************************************************************************/
+
+static int eventfd_open(FAR struct file *filep)
+{
+	FAR struct eventfd_dev_s *dev = filep->f_inode->i_private;
+	irqstate_t flags;
+
+	DEBUGASSERT(dev);
+
+	flags = irqsave();
+	if (dev->crefs == UINT8_MAX) {
+		irqrestore(flags);
+		return -EMFILE;
+	}
+	dev->crefs++;
+	irqrestore(flags);
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: eventfd_close
+ ****************************************************************************/
+
+static int eventfd_close(FAR struct file *filep)
+{
+	FAR struct inode *inode = filep->f_inode;
+	FAR struct eventfd_dev_s *dev = inode->i_private;
+	irqstate_t flags;
+	bool release;
+
+	DEBUGASSERT(dev && dev->crefs > 0);
+
+	flags = irqsave();
+	release = (--dev->crefs == 0 && dev->unlinked);
+	irqrestore(flags);
+
+	if (release) {
+		eventfd_freedev(dev);
+		inode->i_private = NULL;
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: eventfd_fread
+ *
+ * Description:
+ *   Wait for any flag, return them all in an eventfd_t and clear them.
+ *
+ ****************************************************************************/
+
+static ssize_t eventfd_fread(FAR struct file *filep, FAR char *buffer, size_t len)
+{
+	FAR struct eventfd_dev_s *dev = filep->f_inode->i_private;
+	eventfd_t value;
+	int ret;
+
+	if (len < sizeof(eventfd_t)) {
+		return -EINVAL;
+	}
+
+	ret = eventfd_waitflags(dev, (eventfd_t)-1, EFD_CLEAR, (filep->f_oflags & O_NONBLOCK) != 0 ? 0 : -1, &value);
+	if (ret < 0) {
+		return ret == -ETIMEDOUT ? -EAGAIN : ret;
+	}
+
+	memcpy(buffer, &value, sizeof(eventfd_t));
+	return sizeof(eventfd_t);
+}
+
+/****************************************************************************
+ * Name: eventfd_fwrite
+ *
+ * Description:
+ *   Set the flags of an eventfd_t.
+ *
+ ****************************************************************************/
+
+static ssize_t eventfd_fwrite(FAR struct file *filep, FAR const char *buffer, size_t len)
+{
+	FAR struct eventfd_dev_s *dev = filep->f_inode->i_private;
+	eventfd_t value;
+
+	if (len < sizeof(eventfd_t)) {
+		return -EINVAL;
+	}
+
+	memcpy(&value, buffer, sizeof(eventfd_t));
+	eventfd_setflags(dev, value);
+	return sizeof(eventfd_t);
+}
+
+/****************************************************************************
+ * Name: eventfd_ioctl
+ ****************************************************************************/
+
+static int eventfd_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+	FAR struct eventfd_dev_s *dev = filep->f_inode->i_private;
+	FAR struct eventfd_wait_s *wait;
+	irqstate_t flags;
+
+	switch (cmd) {
+	case EFDIOC_WAIT:
+		wait = (FAR struct eventfd_wait_s *)arg;
+		if (!wait || wait->mask == 0) {
+			return -EINVAL;
+		}
+		return eventfd_waitflags(dev, wait->mask, wait->options, wait->timeout, &wait->value);
+
+	case EFDIOC_CLEAR:
+		flags = irqsave();
+		dev->flags &= ~(eventfd_t)arg;
+		irqrestore(flags);
+		return OK;
+
+	default:
+		break;
+	}
+
+	return -ENOTTY;
+}
+
+/****************************************************************************
+ * Name: eventfd_poll
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static int eventfd_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
+{
+	FAR struct eventfd_dev_s *dev = filep->f_inode->i_private;
+	FAR struct pollfd **slot;
+	pollevent_t eventset;
+	irqstate_t flags;
+	int ret = OK;
+	int i;
+
+	flags = irqsave();
+	if (setup) {
+		for (i = 0; i < CONFIG_EVENT_FD_NPOLLWAITERS; i++) {
+			if (!dev->fds[i]) {
+				dev->fds[i] = fds;
+				fds->priv = &dev->fds[i];
+				break;
+			}
+		}
+
+		if (i >= CONFIG_EVENT_FD_NPOLLWAITERS) {
+			fds->priv = NULL;
+			ret = -EBUSY;
+			goto errout;
+		}
+
+		/* Flags can always be set, and are read once one is */
+
+		eventset = POLLOUT;
+		if (dev->flags != 0) {
+			eventset |= POLLIN;
+		}
+
+		eventfd_pollnotify(dev, eventset);
+	} else {
+		slot = (FAR struct pollfd **)fds->priv;
+		if (slot) {
+			*slot = NULL;
+			fds->priv = NULL;
+		}
+	}
+
+errout:
+	irqrestore(flags);
+	return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: eventfd_unlink
+ ****************************************************************************/
+
+static int eventfd_unlink(FAR struct inode *inode)
+{
+	FAR struct eventfd_dev_s *dev = inode->i_private;
+	irqstate_t flags;
+	bool release;
+
+	DEBUGASSERT(dev);
+
+	flags = irqsave();
+	dev->unlinked = true;
+	release = (dev->crefs == 0);
+	irqrestore(flags);
+
+	if (release) {
+		eventfd_freedev(dev);
+		inode->i_private = NULL;
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mkeventfd
+ *
+ * Description:
+ *   Register event flags at 'pathname', which any task can then open.
+ *
+ * Input Parameters:
+ *   pathname - The path of the event flags
+ *   mode     - The permissions
+ *
+ * Returned Value:
+ *   OK on success; otherwise, ERROR with errno set appropriately.
+ *
+ ****************************************************************************/
+
+int mkeventfd(FAR const char *pathname, mode_t mode)
+{
+	FAR struct eventfd_dev_s *dev;
+	int ret;
+
+	dev = eventfd_allocdev();
+	if (!dev) {
+		set_errno(ENOMEM);
+		return ERROR;
+	}
+
+	ret = register_driver(pathname, &eventfd_fops, mode, (FAR void *)dev);
+	if (ret < 0) {
+		eventfd_freedev(dev);
+		set_errno(-ret);
+		return ERROR;
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: eventfd
+ *
+ * Description:
+ *   Create event flags only known by the file descriptor returned: they
+ *   are registered, opened and unregistered at once, and freed on the last
+ *   close.
+ *
+ * Input Parameters:
+ *   initval - The flags initially set
+ *   flags   - 0 or EFD_NONBLOCK
+ *
+ * Returned Value:
+ *   The file descriptor on success; otherwise, ERROR with errno set
+ *   appropriately.
+ *
+ ****************************************************************************/
+
+int eventfd(eventfd_t initval, int flags)
+{
+	FAR struct eventfd_dev_s *dev;
+	char devname[16];
+	int err;
+	int ret;
+	int fd;
+
+	dev = eventfd_allocdev();
+	if (!dev) {
+		set_errno(ENOMEM);
+		return ERROR;
+	}
+
+	dev->flags = initval;
+
+	ret = sem_wait(&g_efdsem);
+	if (ret < 0) {
+		/* sem_wait() will have already set errno */
+
+		eventfd_freedev(dev);
+		return ERROR;
+	}
+
+	snprintf(devname, sizeof(devname), "/dev/efd%u", (unsigned)g_efdno++);
+	ret = register_driver(devname, &eventfd_fops, 0666, (FAR void *)dev);
+	if (ret < 0) {
+		(void)sem_post(&g_efdsem);
+		eventfd_freedev(dev);
+		set_errno(-ret);
+		return ERROR;
+	}
+
+	fd = open(devname, O_RDWR | (flags & EFD_NONBLOCK));
+	err = get_errno();
+
+	/* From now on, the flags are only reached through the descriptor */
+
+	dev->unlinked = true;
+	(void)unregister_driver(devname);
+	(void)sem_post(&g_efdsem);
+
+	if (fd < 0) {
+		/* Nothing holds the flags any more */
+
+		eventfd_freedev(dev);
+		set_errno(err);
+		return ERROR;
+	}
+
+	return fd;
+}
+
+#endif							/* CONFIG_EVENT_FD */
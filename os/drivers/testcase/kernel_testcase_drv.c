@@ -27,10 +27,39 @@
 #include <tinyara/fs/fs.h>
 #include <tinyara/testcase_drv.h>
 #include <tinyara/sched.h>
+#include <semaphore.h>
+#include <tinyara/clock.h>
+#include <tinyara/wdog.h>
+#ifdef CONFIG_HRTIMER
+#include <tinyara/hrtimer.h>
+#endif
 #include "clock/clock.h"
+#include "sched/sched.h"
 #include "signal/signal.h"
 #include "timer/timer.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* How long TESTIOC_HRTIMER_EXPIRY and TESTIOC_WDOG_EXPIRY wait for the
+ * timers after the last expiration
+ */
+
+#define TIMER_TEST_MARGIN_MS 10
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+struct hrtimer_test_s {
+	struct hrtimer_s timer;
+	uint64_t called;			/* hrtimer_gettime() time of the call */
+	int seq;					/* Rank of the call, -1 if not called */
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -54,10 +83,219 @@ static const struct file_operations kernel_test_drv_fops = {
 #endif
 };
 
+static struct wdog_s g_wdog_test[TESTIOC_WDOG_NWDOGS];
+static clock_t g_wdog_testcalled[TESTIOC_WDOG_NWDOGS];
+static volatile uint32_t g_wdog_testmask;
+static sem_t g_wdog_testsem;
+
+#ifdef CONFIG_HRTIMER
+static struct hrtimer_test_s g_hrtimer_test[TESTIOC_HRTIMER_NTIMERS];
+static sem_t g_hrtimer_testsem;
+static int g_hrtimer_ncalled;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: kernel_test_drv_wdog_expired
+ ****************************************************************************/
+
+static void kernel_test_drv_wdog_expired(int argc, uint32_t index, ...)
+{
+	g_wdog_testcalled[index] = clock_systimer();
+	g_wdog_testmask |= (uint32_t)1 << index;
+	sem_post(&g_wdog_testsem);
+}
+
+/****************************************************************************
+ * Name: kernel_test_drv_wdog
+ *
+ * Description:
+ *   Start the watchdogs of TESTIOC_WDOG_EXPIRY in the same tick, then wait
+ *   until they have all been called, or until a while after the last
+ *   expiration if one of them is cancelled or a call is missing.
+ *
+ ****************************************************************************/
+
+static int kernel_test_drv_wdog(FAR struct testioc_wdog_s *arg)
+{
+	struct timespec abstime;
+	irqstate_t flags;
+	uint32_t started = 0;
+	clock_t start;
+	int32_t last = 0;
+	int ret = OK;
+	int i;
+
+	if (!arg) {
+		return -EINVAL;
+	}
+
+	sem_init(&g_wdog_testsem, 0, 0);
+#ifdef CONFIG_PRIORITY_INHERITANCE
+	sem_setprotocol(&g_wdog_testsem, SEM_PRIO_NONE);
+#endif
+	g_wdog_testmask = 0;
+
+	flags = irqsave();
+	start = clock_systimer();
+	for (i = 0; i < TESTIOC_WDOG_NWDOGS; i++) {
+		wd_static(&g_wdog_test[i]);
+		if (arg->delay[i] <= 0) {
+			continue;
+		}
+
+		if (wd_start(&g_wdog_test[i], arg->delay[i], (wdentry_t)kernel_test_drv_wdog_expired, 1, (uint32_t)i) != OK) {
+			irqrestore(flags);
+			ret = -EINVAL;
+			goto out;
+		}
+
+		started |= (uint32_t)1 << i;
+		if (arg->delay[i] > last) {
+			last = arg->delay[i];
+		}
+	}
+	irqrestore(flags);
+
+	if (arg->cancel >= 0 && arg->cancel < TESTIOC_WDOG_NWDOGS && (started & ((uint32_t)1 << arg->cancel)) != 0) {
+		/* It fails if the watchdog has already expired */
+
+		if (wd_cancel(&g_wdog_test[arg->cancel]) != OK) {
+			ret = -ENOENT;
+			goto out;
+		}
+		started &= ~((uint32_t)1 << arg->cancel);
+	}
+
+	clock_gettime(CLOCK_REALTIME, &abstime);
+	abstime.tv_nsec += (long)((uint64_t)last * USEC_PER_TICK % USEC_PER_SEC) * NSEC_PER_USEC + TIMER_TEST_MARGIN_MS * NSEC_PER_MSEC;
+	abstime.tv_sec += (time_t)((uint64_t)last * USEC_PER_TICK / USEC_PER_SEC) + abstime.tv_nsec / NSEC_PER_SEC;
+	abstime.tv_nsec %= NSEC_PER_SEC;
+
+	while (arg->cancel >= 0 || (g_wdog_testmask & started) != started) {
+		if (sem_timedwait(&g_wdog_testsem, &abstime) < 0 && get_errno() == ETIMEDOUT) {
+			break;
+		}
+	}
+
+out:
+	for (i = 0; i < TESTIOC_WDOG_NWDOGS; i++) {
+		(void)wd_cancel(&g_wdog_test[i]);
+
+		arg->called[i] = (g_wdog_testmask & ((uint32_t)1 << i)) != 0;
+		arg->late[i] = arg->called[i] ? (int32_t)(g_wdog_testcalled[i] - (start + arg->delay[i])) : 0;
+	}
+
+	sem_destroy(&g_wdog_testsem);
+	return ret;
+}
+
+#ifdef CONFIG_HRTIMER
+/****************************************************************************
+ * Name: kernel_test_drv_hrtimer_expired
+ ****************************************************************************/
+
+static void kernel_test_drv_hrtimer_expired(FAR struct hrtimer_s *timer, FAR void *arg)
+{
+	FAR struct hrtimer_test_s *test = (FAR struct hrtimer_test_s *)arg;
+
+	test->called = hrtimer_gettime();
+	test->seq = g_hrtimer_ncalled++;
+	sem_post(&g_hrtimer_testsem);
+}
+
+/****************************************************************************
+ * Name: kernel_test_drv_hrtimer
+ *
+ * Description:
+ *   Start the timers of TESTIOC_HRTIMER_EXPIRY, then wait until they have
+ *   all been called, or until a while after the last expiration if one of
+ *   them is cancelled or a call is missing.
+ *
+ ****************************************************************************/
+
+static int kernel_test_drv_hrtimer(FAR struct testioc_hrtimer_s *arg)
+{
+	FAR struct hrtimer_test_s *test;
+	struct timespec abstime;
+	uint64_t start;
+	uint32_t last = 0;
+	int nstarted = 0;
+	int ret = OK;
+	int i;
+
+	if (!arg) {
+		return -EINVAL;
+	}
+
+	sem_init(&g_hrtimer_testsem, 0, 0);
+#ifdef CONFIG_PRIORITY_INHERITANCE
+	sem_setprotocol(&g_hrtimer_testsem, SEM_PRIO_NONE);
+#endif
+	g_hrtimer_ncalled = 0;
+
+	/* Start them all from the same time, so that their expirations are in
+	 * the order of their delays
+	 */
+
+	start = hrtimer_gettime();
+	for (i = 0; i < TESTIOC_HRTIMER_NTIMERS; i++) {
+		test = &g_hrtimer_test[i];
+		hrtimer_init(&test->timer);
+		test->called = 0;
+		test->seq = -1;
+
+		if (arg->delay[i] == 0) {
+			continue;
+		}
+
+		ret = hrtimer_start(&test->timer, start + arg->delay[i], kernel_test_drv_hrtimer_expired, test, HRTIMER_ABSTIME | (arg->flags & HRTIMER_THREAD));
+		if (ret < 0) {
+			goto out;
+		}
+
+		nstarted++;
+		if (arg->delay[i] > last) {
+			last = arg->delay[i];
+		}
+	}
+
+	if (arg->cancel && arg->delay[0] != 0) {
+		ret = hrtimer_cancel(&g_hrtimer_test[0].timer);
+		if (ret < 0) {
+			goto out;
+		}
+	}
+
+	clock_gettime(CLOCK_REALTIME, &abstime);
+	abstime.tv_nsec += (last % NSEC_PER_SEC) + TIMER_TEST_MARGIN_MS * NSEC_PER_MSEC;
+	abstime.tv_sec += last / NSEC_PER_SEC + abstime.tv_nsec / NSEC_PER_SEC;
+	abstime.tv_nsec %= NSEC_PER_SEC;
+
+	while (arg->cancel || g_hrtimer_ncalled < nstarted) {
+		if (sem_timedwait(&g_hrtimer_testsem, &abstime) < 0 && get_errno() == ETIMEDOUT) {
+			break;
+		}
+	}
+
+out:
+	for (i = 0; i < TESTIOC_HRTIMER_NTIMERS; i++) {
+		test = &g_hrtimer_test[i];
+		(void)hrtimer_cancel(&test->timer);
+
+		arg->seq[i] = test->seq;
+		arg->late[i] = test->seq < 0 ? 0 : (int32_t)(test->called - (start + arg->delay[i]));
+	}
+
+	sem_destroy(&g_hrtimer_testsem);
+	return ret;
+}
+#endif
+
+
 /************************************************************************************
  * Name: kernel_test_drv_ioctl
  *
@@ -170,6 +408,46 @@ static int kernel_test_drv_ioctl(FAR struct file *filep, int cmd, unsigned long
 	}
 	break;
 
+#ifdef CONFIG_TASK_POOL
+	/* TESTIOC_TASK_POOL_MEMBER - Whether the TCB of the thread is a TCB of
+	 * the pool of sched_taskpool.c
+	 *
+	 *   ioctl argument:  The pid of the thread
+	 */
+
+	case TESTIOC_TASK_POOL_MEMBER: {
+		tcb = sched_gettcb((pid_t)arg);
+		if (tcb == NULL) {
+			ret = ERROR;
+			break;
+		}
+		ret = sched_taskpool_member(tcb) ? 1 : 0;
+	}
+	break;
+#endif
+
+	/* TESTIOC_WDOG_EXPIRY - Start watchdogs and report when they expire
+	 *
+	 *   ioctl argument:  A struct testioc_wdog_s
+	 */
+
+	case TESTIOC_WDOG_EXPIRY: {
+		ret = kernel_test_drv_wdog((FAR struct testioc_wdog_s *)arg);
+	}
+	break;
+
+#ifdef CONFIG_HRTIMER
+	/* TESTIOC_HRTIMER_EXPIRY - Start hrtimers and report when they expire
+	 *
+	 *   ioctl argument:  A struct testioc_hrtimer_s
+	 */
+
+	case TESTIOC_HRTIMER_EXPIRY: {
+		ret = kernel_test_drv_hrtimer((FAR struct testioc_hrtimer_s *)arg);
+	}
+	break;
+#endif
+
 	default: {
 		vdbg("Unrecognized cmd: %d arg: %ld\n", cmd, arg);
 	}
@@ -81,7 +81,7 @@
 #include <tinyara/fs/procfs.h>
 #include <tinyara/fs/dirent.h>
 
-#ifdef CONFIG_SCHED_CPULOAD
+#if defined(CONFIG_SCHED_CPULOAD) || defined(CONFIG_SCHED_STATS)
 #include <tinyara/clock.h>
 #endif
 
@@ -100,6 +100,19 @@ extern const uint32_t g_idle_topstack;
 
 #define STATUS_LINELEN 64
 
+/* The lines of the 'schedstat' entry:  the counters, then a heading and a
+ * line for each bucket of the wake-up latency histogram.
+ */
+
+#ifdef CONFIG_SCHED_STATS
+#ifdef CONFIG_SCHED_STATS_IRQOFF
+#define PROC_SCHEDSTAT_NCOUNTERS 7
+#else
+#define PROC_SCHEDSTAT_NCOUNTERS 6
+#endif
+#define PROC_SCHEDSTAT_NLINES (PROC_SCHEDSTAT_NCOUNTERS + 1 + SCHED_STATS_NHIST)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -122,6 +135,9 @@ enum proc_node_e {
 	PROC_CMDLINE,				/* Task command line */
 #ifdef CONFIG_SCHED_CPULOAD
 	PROC_LOADAVG,				/* Average CPU utilization */
+#endif
+#ifdef CONFIG_SCHED_STATS
+	PROC_SCHEDSTAT,				/* Scheduling statistics */
 #endif
 	PROC_STACK,					/* Task stack info */
 	PROC_GROUP,					/* Group directory */
@@ -169,6 +185,9 @@ static ssize_t proc_entry_cmdline(FAR struct proc_file_s *procfile, FAR struct t
 #ifdef CONFIG_SCHED_CPULOAD
 static ssize_t proc_entry_loadavg(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
 #endif
+#ifdef CONFIG_SCHED_STATS
+static ssize_t proc_entry_schedstat(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
+#endif
 static ssize_t proc_entry_stack(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
 static ssize_t proc_entry_groupstatus(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
 static ssize_t proc_entry_groupfd(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
@@ -241,6 +260,12 @@ static const struct proc_node_s g_loadavg = {
 };
 #endif
 
+#ifdef CONFIG_SCHED_STATS
+static const struct proc_node_s g_schedstat = {
+	"schedstat", "schedstat", (uint8_t)PROC_SCHEDSTAT, DTYPE_FILE	/* Scheduling statistics */
+};
+#endif
+
 static const struct proc_node_s g_stack = {
 	"stack", "stack", (uint8_t)PROC_STACK, DTYPE_FILE	/* Task stack info */
 };
@@ -265,6 +290,9 @@ static FAR const struct proc_node_s *const g_nodeinfo[] = {
 	&g_cmdline,					/* Task command line */
 #ifdef CONFIG_SCHED_CPULOAD
 	&g_loadavg,					/* Average CPU utilization */
+#endif
+#ifdef CONFIG_SCHED_STATS
+	&g_schedstat,				/* Scheduling statistics */
 #endif
 	&g_stack,					/* Task stack info */
 	&g_group,					/* Group directory */
@@ -282,6 +310,9 @@ static const struct proc_node_s *const g_level0info[] = {
 	&g_cmdline,					/* Task command line */
 #ifdef CONFIG_SCHED_CPULOAD
 	&g_loadavg,					/* Average CPU utilization */
+#endif
+#ifdef CONFIG_SCHED_STATS
+	&g_schedstat,				/* Scheduling statistics */
 #endif
 	&g_stack,					/* Task stack info */
 	&g_group,					/* Group directory */
@@ -642,6 +673,95 @@ static ssize_t proc_entry_loadavg(FAR struct proc_file_s *procfile, FAR struct t
 }
 #endif
 
+/****************************************************************************
+ * Name: proc_schedstat_line
+ ****************************************************************************/
+#ifdef CONFIG_SCHED_STATS
+static size_t proc_schedstat_line(FAR char *line, int index, FAR const struct sched_stats_s *stats, uint64_t runtime)
+{
+	int bucket;
+
+	switch (index) {
+	case 0:
+		return snprintf(line, STATUS_LINELEN, "%-12s%lu\n", "Voluntary:", (unsigned long)stats->nvcsw);
+	case 1:
+		return snprintf(line, STATUS_LINELEN, "%-12s%lu\n", "Involuntary:", (unsigned long)stats->nivcsw);
+	case 2:
+		return snprintf(line, STATUS_LINELEN, "%-12s%lu.%06lu s\n", "RunTime:", (unsigned long)(runtime / NSEC_PER_SEC), (unsigned long)(runtime % NSEC_PER_SEC) / NSEC_PER_USEC);
+	case 3:
+		return snprintf(line, STATUS_LINELEN, "%-12s%lu\n", "PiBoosts:", (unsigned long)stats->nboost);
+	case 4:
+		return snprintf(line, STATUS_LINELEN, "%-12s%lu us\n", "MaxLatency:", (unsigned long)stats->maxlatency / NSEC_PER_USEC);
+	case 5:
+		return snprintf(line, STATUS_LINELEN, "%-12s%lu us\n", "MaxLock:", (unsigned long)stats->maxlock / NSEC_PER_USEC);
+#ifdef CONFIG_SCHED_STATS_IRQOFF
+	case 6:
+		return snprintf(line, STATUS_LINELEN, "%-12s%lu us\n", "MaxIrqOff:", (unsigned long)stats->maxirqoff / NSEC_PER_USEC);
+#endif
+	case PROC_SCHEDSTAT_NCOUNTERS:
+		return snprintf(line, STATUS_LINELEN, "Latency:\n");
+	}
+
+	/* The wake-up latency histogram, see struct sched_stats_s */
+
+	bucket = index - PROC_SCHEDSTAT_NCOUNTERS - 1;
+	if (bucket == 0) {
+		return snprintf(line, STATUS_LINELEN, "  %10s %lu\n", "<1us:", (unsigned long)stats->latency[bucket]);
+	} else if (bucket < SCHED_STATS_NHIST - 1) {
+		return snprintf(line, STATUS_LINELEN, "  <%6uus: %lu\n", 1u << bucket, (unsigned long)stats->latency[bucket]);
+	} else {
+		return snprintf(line, STATUS_LINELEN, "  >=%5uus: %lu\n", 1u << (bucket - 1), (unsigned long)stats->latency[bucket]);
+	}
+}
+
+/****************************************************************************
+ * Name: proc_schedstat
+ ****************************************************************************/
+
+static ssize_t proc_entry_schedstat(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset)
+{
+	struct sched_stats_s stats;
+	irqstate_t flags;
+	uint64_t runtime;
+	size_t remaining;
+	size_t linesize;
+	size_t copysize;
+	size_t totalsize;
+	int index;
+
+	/* Take a copy of the statistics, which the context switches update.
+	 * The run time of the running thread, the reader itself, goes on until
+	 * now.
+	 */
+
+	flags = irqsave();
+	stats = tcb->stats;
+	runtime = stats.runtime;
+	if (tcb == sched_self()) {
+		runtime += sched_stats_clock() - stats.switchtime;
+	}
+	irqrestore(flags);
+
+	remaining = buflen;
+	totalsize = 0;
+
+	for (index = 0; index < PROC_SCHEDSTAT_NLINES; index++) {
+		linesize = proc_schedstat_line(procfile->line, index, &stats, runtime);
+		copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+		totalsize += copysize;
+		buffer += copysize;
+		remaining -= copysize;
+
+		if (totalsize >= buflen) {
+			break;
+		}
+	}
+
+	return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: proc_stack
  ****************************************************************************/
@@ -1065,6 +1185,11 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 	case PROC_LOADAVG:			/* Average CPU utilization */
 		ret = proc_entry_loadavg(procfile, tcb, buffer, buflen, filep->f_pos);
 		break;
+#endif
+#ifdef CONFIG_SCHED_STATS
+	case PROC_SCHEDSTAT:		/* Scheduling statistics */
+		ret = proc_entry_schedstat(procfile, tcb, buffer, buflen, filep->f_pos);
+		break;
 #endif
 	case PROC_STACK:			/* Task stack info */
 		ret = proc_entry_stack(procfile, tcb, buffer, buflen, filep->f_pos);
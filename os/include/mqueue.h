@@ -67,6 +67,8 @@
  * Included Files
  ********************************************************************************/
 
+#include <tinyara/config.h>
+
 #include <sys/types.h>
 #include <signal.h>
 #include "queue.h"
@@ -77,6 +79,12 @@
 
 #define MQ_NONBLOCK O_NONBLOCK
 
+/* mq_flags of mq_open() creating a zero-copy queue (non-standard), above
+ * the open flags
+ */
+
+#define MQ_ZEROCOPY (1 << 9)
+
 /********************************************************************************
  * Global Type Declarations
  ********************************************************************************/
@@ -189,6 +197,41 @@ int mq_setattr(mqd_t mqdes, FAR const struct mq_attr *mq_stat, FAR struct mq_att
  */
 int mq_getattr(mqd_t mqdes, FAR struct mq_attr *mq_stat);
 
+#ifdef CONFIG_MQ_ZEROCOPY
+/**
+ * @brief send a buffer to a zero-copy message queue
+ * @details @b #include <mqueue.h> \n
+ * SYSTEM CALL API \n
+ * Non-standard API. The buffer itself is queued, and belongs to the
+ * receiver once mq_receivebuf() returns it. The buffer must be a block
+ * returned by malloc(), which the sender no longer uses once it is sent:
+ * the receiver frees it, or the queue does if it is destroyed with the
+ * buffer still queued. A buffer outside the user heap fails with EFAULT;
+ * the kernel doesn't check more than that, e.g. a pointer inside a block.
+ * @param[in] mqdes a message queue created with MQ_ZEROCOPY
+ * @param[in] buf the buffer, allocated with malloc()
+ * @param[in] buflen its length, at most mq_msgsize
+ * @param[in] prio the priority of the message
+ * @return On success, OK is returned. On failure, ERROR is returned and errno is set appropriately.
+ * @since TizenRT v3.0
+ */
+int mq_sendbuf(mqd_t mqdes, FAR void *buf, size_t buflen, int prio);
+/**
+ * @brief receive a buffer from a zero-copy message queue
+ * @details @b #include <mqueue.h> \n
+ * SYSTEM CALL API \n
+ * Non-standard API. The receiver gets the buffer passed to mq_sendbuf()
+ * and owns it: it must free() it once done with it. The buffer is the one
+ * of the sender, which is trusted to have followed mq_sendbuf().
+ * @param[in] mqdes a message queue created with MQ_ZEROCOPY
+ * @param[out] buf the location to store the address of the buffer
+ * @param[out] prio if not NULL, the location to store the priority of the message
+ * @return On success, the length of the buffer is returned. On failure, ERROR is returned and errno is set appropriately.
+ * @since TizenRT v3.0
+ */
+ssize_t mq_receivebuf(mqd_t mqdes, FAR void **buf, FAR int *prio);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
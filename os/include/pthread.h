@@ -204,6 +204,21 @@
 #define _PTHREAD_MFLAGS_INCONSISTENT  (1 << 1)	/* Mutex is in an inconsistent state */
 #define _PTHREAD_MFLAGS_NRECOVERABLE  (1 << 2)	/* Inconsistent mutex has been unlocked */
 
+/*
+ * Values for struct pthread_mutex_s pid, besides the pid of the holder.
+ * With CONFIG_PTHREAD_MUTEX_FASTPATH, the user space locks a free mutex by
+ * setting it to its owner word: its pid with _PTHREAD_MPID_FAST and the
+ * generation of the pid, which tells apart the threads getting the same
+ * pid.  The kernel replaces it by the plain pid when it takes the mutex
+ * over.
+ */
+#define _PTHREAD_MPID_FREE            (-1)	/* Mutex is not held */
+#define _PTHREAD_MPID_HANDOFF         (-2)	/* Mutex is given to a waiter which hasn't run yet */
+#define _PTHREAD_MPID_FAST            (1 << 16)	/* Mutex is held without the kernel knowing */
+#define _PTHREAD_MPID_PIDMASK         0xffff	/* Pid of the owner word */
+#define _PTHREAD_MPID_GENSHIFT        17	/* Generation of the pid of the owner word */
+#define _PTHREAD_MPID_GENMASK         0x3fff
+
 /*
  * Maximum values of pthread key operation
  */
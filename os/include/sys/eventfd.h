@@ -0,0 +1,168 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**
+ * @defgroup EVENTFD_KERNEL EVENTFD
+ * @brief Provides APIs for event flags file descriptors
+ * @ingroup KERNEL
+ *
+ * @{
+ */
+
+/// @file sys/eventfd.h
+/// @brief Event flags file descriptor APIs (non-standard)
+
+#ifndef __INCLUDE_SYS_EVENTFD_H
+#define __INCLUDE_SYS_EVENTFD_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <fcntl.h>
+
+#ifdef CONFIG_EVENT_FD
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+/* Flags of eventfd() */
+
+#define EFD_NONBLOCK   O_NONBLOCK
+
+/* Options of eventfd_wait() */
+
+#define EFD_WAIT_ANY   0		/* Wait for any of the flags */
+#define EFD_WAIT_ALL   (1 << 0)	/* Wait for all of the flags */
+#define EFD_CLEAR      (1 << 1)	/* Clear the flags waited for */
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* A set of 32 event flags */
+
+typedef uint32_t eventfd_t;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/**
+ * @ingroup EVENTFD_KERNEL
+ * @brief create an event flags file descriptor
+ * @details @b #include <sys/eventfd.h> \n
+ * SYSTEM CALL API \n
+ * The descriptor holds 32 event flags, initially initval. write() of an
+ * eventfd_t sets flags and wakes up the tasks waiting for them, read()
+ * waits for any flag and clears them all, poll() reports POLLIN while a
+ * flag is set. Nothing is allocated to set flags.
+ * @param[in] initval the flags initially set
+ * @param[in] flags 0 or EFD_NONBLOCK
+ * @return On success, the file descriptor is returned. On failure, ERROR is returned and errno is set appropriately.
+ * @since TizenRT v3.0
+ */
+EXTERN int eventfd(eventfd_t initval, int flags);
+
+/**
+ * @ingroup EVENTFD_KERNEL
+ * @brief create named event flags
+ * @details @b #include <sys/eventfd.h> \n
+ * SYSTEM CALL API \n
+ * Like mkfifo(), registers event flags at pathname that any task can
+ * open(), so that a task can set the flags another one waits for.
+ * unlink() removes them once they are closed.
+ * @param[in] pathname the path of the event flags
+ * @param[in] mode the permissions
+ * @return On success, OK is returned. On failure, ERROR is returned and errno is set appropriately.
+ * @since TizenRT v3.0
+ */
+EXTERN int mkeventfd(FAR const char *pathname, mode_t mode);
+
+/**
+ * @ingroup EVENTFD_KERNEL
+ * @brief wait for any event flag, then clear them all
+ * @details @b #include <sys/eventfd.h> \n
+ * @param[in] fd an event flags file descriptor
+ * @param[out] value the flags which were set
+ * @return On success, OK is returned. On failure, ERROR is returned and errno is set appropriately.
+ * @since TizenRT v3.0
+ */
+EXTERN int eventfd_read(int fd, FAR eventfd_t *value);
+
+/**
+ * @ingroup EVENTFD_KERNEL
+ * @brief set event flags
+ * @details @b #include <sys/eventfd.h> \n
+ * @param[in] fd an event flags file descriptor
+ * @param[in] value the flags to set
+ * @return On success, OK is returned. On failure, ERROR is returned and errno is set appropriately.
+ * @since TizenRT v3.0
+ */
+EXTERN int eventfd_write(int fd, eventfd_t value);
+
+/**
+ * @ingroup EVENTFD_KERNEL
+ * @brief wait for some of the event flags
+ * @details @b #include <sys/eventfd.h> \n
+ * Waits for any of the flags of mask, or all of them with EFD_WAIT_ALL.
+ * With EFD_CLEAR, the flags of mask are cleared when the wait is over,
+ * otherwise none is.
+ * @param[in] fd an event flags file descriptor
+ * @param[in] mask the flags to wait for
+ * @param[in] options EFD_WAIT_ANY or EFD_WAIT_ALL, and EFD_CLEAR
+ * @param[in] timeout the time to wait in milliseconds, or -1 to wait forever
+ * @param[out] value if not NULL, the flags set when the wait was over
+ * @return On success, OK is returned. On failure, ERROR is returned and errno is set appropriately, to ETIMEDOUT after the timeout.
+ * @since TizenRT v3.0
+ */
+EXTERN int eventfd_wait(int fd, eventfd_t mask, int options, int timeout, FAR eventfd_t *value);
+
+/**
+ * @ingroup EVENTFD_KERNEL
+ * @brief clear event flags
+ * @details @b #include <sys/eventfd.h> \n
+ * @param[in] fd an event flags file descriptor
+ * @param[in] mask the flags to clear
+ * @return On success, OK is returned. On failure, ERROR is returned and errno is set appropriately.
+ * @since TizenRT v3.0
+ */
+EXTERN int eventfd_clear(int fd, eventfd_t mask);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif							/* CONFIG_EVENT_FD */
+
+#endif							/* __INCLUDE_SYS_EVENTFD_H */
+/**
+ * @} */
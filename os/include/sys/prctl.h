@@ -80,6 +80,15 @@
  *
  *      char myname[CONFIG_TASK_NAME_SIZE];
  *      prctl(PR_GET_NAME, myname, 0);
+ *
+ *  PR_SET_MUTEX_OWNER
+ *    With CONFIG_PTHREAD_MUTEX_FASTPATH, register the int of the user space
+ *    pointed to by required arg1 (volatile int *), where the kernel then
+ *    writes the owner word of the running thread on each context switch.
+ *    The libc registers its own at the start of the first task, and the
+ *    word can't be changed once registered. As an example:
+ *
+ *      prctl(PR_SET_MUTEX_OWNER, &g_curowner);
  */
 
 /**
@@ -90,6 +99,10 @@
  * @ingroup SCHED_KERNEL
  */
 #define PR_GET_NAME 2
+/**
+ * @ingroup SCHED_KERNEL
+ */
+#define PR_SET_MUTEX_OWNER 3
 
 /****************************************************************************
  * Public Type Definitions
@@ -121,6 +134,7 @@ extern "C" {
  *
  *     EINVAL The value of 'option' is not recognized.
  *     EFAULT optional arg1 is not a valid address.
+ *     EBUSY  Another word was registered by PR_SET_MUTEX_OWNER.
  *     ESRCH  No task/thread can be found corresponding to that specified
  *       by optional arg1.
  * @since TizenRT v1.0
@@ -306,12 +306,20 @@
 #define SYS_statfs                     (__SYS_filedesc + 16)
 #define SYS_telldir                    (__SYS_filedesc + 17)
 
+#ifdef CONFIG_EVENT_FD
+#define SYS_eventfd                    (__SYS_filedesc + 18)
+#define SYS_mkeventfd                  (__SYS_filedesc + 19)
+#define __SYS_streams                  (__SYS_filedesc + 20)
+#else
+#define __SYS_streams                  (__SYS_filedesc + 18)
+#endif
+
 #if CONFIG_NFILE_STREAMS > 0
-#define SYS_fs_fdopen                  (__SYS_filedesc + 18)
-#define SYS_sched_getstreams           (__SYS_filedesc + 19)
-#define __SYS_mountpoint               (__SYS_filedesc + 20)
+#define SYS_fs_fdopen                  (__SYS_streams + 0)
+#define SYS_sched_getstreams           (__SYS_streams + 1)
+#define __SYS_mountpoint               (__SYS_streams + 2)
 #else
-#define __SYS_mountpoint               (__SYS_filedesc + 18)
+#define __SYS_mountpoint               __SYS_streams
 #endif
 
 #if !defined(CONFIG_DISABLE_MOUNTPOINT)
@@ -403,7 +411,13 @@
 #define SYS_mq_timedreceive            (__SYS_mqueue + 7)
 #define SYS_mq_timedsend               (__SYS_mqueue + 8)
 #define SYS_mq_unlink                  (__SYS_mqueue + 9)
+#ifdef CONFIG_MQ_ZEROCOPY
+#define SYS_mq_receivebuf              (__SYS_mqueue + 10)
+#define SYS_mq_sendbuf                 (__SYS_mqueue + 11)
+#define __SYS_environ                  (__SYS_mqueue + 12)
+#else
 #define __SYS_environ                  (__SYS_mqueue + 10)
+#endif
 #else
 #define __SYS_environ                  __SYS_mqueue
 #endif
@@ -444,9 +458,11 @@
 #define SYS_nnetsocket                 __SYS_network
 #endif
 
-/* The following is defined only if CONFIG_TASK_NAME_SIZE > 0 */
+/* The following is defined only if CONFIG_TASK_NAME_SIZE > 0 or
+ * CONFIG_PTHREAD_MUTEX_FASTPATH is enabled
+ */
 
-#if CONFIG_TASK_NAME_SIZE > 0
+#if CONFIG_TASK_NAME_SIZE > 0 || defined(CONFIG_PTHREAD_MUTEX_FASTPATH)
 #define SYS_prctl                      (SYS_nnetsocket + 0)
 #define SYS_maxsyscall                 (SYS_nnetsocket + 1)
 #else
@@ -0,0 +1,47 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_TINYARA_EVENTFD_H
+#define __INCLUDE_TINYARA_EVENTFD_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/eventfd.h>
+#include <tinyara/fs/ioctl.h>
+
+#ifdef CONFIG_EVENT_FD
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The argument of EFDIOC_WAIT, see eventfd_wait() */
+
+struct eventfd_wait_s {
+	eventfd_t mask;				/* IN: The flags to wait for */
+	uint8_t options;			/* IN: EFD_WAIT_ALL, EFD_CLEAR */
+	int timeout;				/* IN: Milliseconds, or -1 for no timeout */
+	eventfd_t value;			/* OUT: The flags set when the wait was over */
+};
+
+#endif							/* CONFIG_EVENT_FD */
+#endif							/* __INCLUDE_TINYARA_EVENTFD_H */
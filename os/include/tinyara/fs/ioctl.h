@@ -95,6 +95,7 @@
 #define _GPIOBASE       (0x2000)	/* GPIO ioctl commands */
 #define _TMBASE         (0x2100)	/* Task Management ioctl commands */
 #define _HEAPINFOBASE   (0x2200)	/* Heapinfo ioctl commands */
+#define _EFDIOCBASE     (0x2300)	/* Event flags ioctl commands */
 #define _TESTIOCBASE (0xfe00)	/* KERNEL TEST DRV module ioctl commands */
 
 /* boardctl() commands share the same number space */
@@ -381,6 +382,19 @@
 #define HEAPINFOIOC_TASKNAME          _HEAPINFOIOC(0x0005)
 #define HEAPINFOIOC_INIT_KHEAP        _HEAPINFOIOC(0x0006)
 
+/* Event flags ioctl definitions ********************************************/
+/* (see tinyara/eventfd.h) */
+
+#define _EFDIOCVALID(c)   (_IOC_TYPE(c) == _EFDIOCBASE)
+#define _EFDIOC(nr)       _IOC(_EFDIOCBASE, nr)
+
+#define EFDIOC_WAIT       _EFDIOC(0x0001)	/* Wait for flags
+											 * IN:  struct eventfd_wait_s *
+											 * OUT: value set */
+#define EFDIOC_CLEAR      _EFDIOC(0x0002)	/* Clear flags
+											 * IN:  eventfd_t mask
+											 * OUT: None */
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -0,0 +1,177 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * include/tinyara/hrtimer.h
+ *
+ * High resolution timers, which expire at a time in nanoseconds instead of
+ * a number of system ticks.  They are timed by the interval timer or the
+ * alarm of the tickless OS, along with the watchdogs.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_TINYARA_HRTIMER_H
+#define __INCLUDE_TINYARA_HRTIMER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+
+#include <tinyara/compiler.h>
+
+#ifdef CONFIG_SCHED_HPWORK
+#include <tinyara/wqueue.h>
+#endif
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Flags of hrtimer_start() */
+
+#define HRTIMER_ABSTIME  (1 << 0)	/* The time is an hrtimer_gettime() time */
+#define HRTIMER_THREAD   (1 << 1)	/* Call the function on the HPWORK thread */
+
+/* Flags of struct hrtimer_s, along with HRTIMER_THREAD */
+
+#define HRTIMERF_ACTIVE  (1 << 7)	/* The timer is started */
+
+#define HRTIMER_ISACTIVE(t) (((t)->flags & HRTIMERF_ACTIVE) != 0)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct hrtimer_s;
+
+/* The function called when a timer expires, from the timer interrupt or
+ * with HRTIMER_THREAD from the HPWORK thread.  It may start the timer
+ * again.
+ */
+
+typedef CODE void (*hrtimer_func_t)(FAR struct hrtimer_s *timer, FAR void *arg);
+
+/* A timer, which its user allocates.  It is initialized by hrtimer_init()
+ * and its fields are only handled by the hrtimer functions.
+ */
+
+struct hrtimer_s {
+	FAR struct hrtimer_s *flink;	/* Links of the list of started timers */
+	FAR struct hrtimer_s *blink;
+	uint64_t expiry;			/* hrtimer_gettime() time of the expiration */
+	hrtimer_func_t func;		/* Function to call on expiration */
+	FAR void *arg;				/* Its argument */
+	uint8_t flags;				/* See HRTIMERF_* definitions above */
+#ifdef CONFIG_SCHED_HPWORK
+	struct work_s work;			/* Queues the call with HRTIMER_THREAD */
+#endif
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: hrtimer_init
+ *
+ * Description:
+ *   Initialize a timer, which is then not started.
+ *
+ ****************************************************************************/
+
+void hrtimer_init(FAR struct hrtimer_s *timer);
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   Start a timer, or restart it if it is started.  The function is called
+ *   once the time has passed, at the earliest.
+ *
+ * Parameters:
+ *   timer - The timer
+ *   nsec - Nanoseconds from now, or with HRTIMER_ABSTIME the
+ *     hrtimer_gettime() time of the expiration
+ *   func - The function to call when the timer expires
+ *   arg - Its argument
+ *   flags - HRTIMER_ABSTIME and HRTIMER_THREAD
+ *
+ * Return Value:
+ *   OK, or -ENOSYS for HRTIMER_THREAD without CONFIG_SCHED_HPWORK.
+ *
+ * Assumptions:
+ *   May be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *timer, uint64_t nsec, hrtimer_func_t func, FAR void *arg, uint8_t flags);
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Stop a timer.  With HRTIMER_THREAD, a call already queued for the
+ *   HPWORK thread is cancelled as well.
+ *
+ * Return Value:
+ *   OK, or -EINVAL if the timer was not started.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *timer);
+
+/****************************************************************************
+ * Name: hrtimer_gettime
+ *
+ * Description:
+ *   Return the time in nanoseconds since power up, from up_timer_gettime().
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_gettime(void);
+
+/****************************************************************************
+ * Name: hrtimer_remaining
+ *
+ * Description:
+ *   Return the nanoseconds until a timer expires, zero if it is not
+ *   started.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_remaining(FAR struct hrtimer_s *timer);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif							/* CONFIG_HRTIMER */
+#endif							/* __INCLUDE_TINYARA_HRTIMER_H */
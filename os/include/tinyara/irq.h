@@ -75,6 +75,21 @@
 #define irq_detach(irq) irq_attach(irq, NULL, NULL)
 #endif
 #endif
+
+#ifdef CONFIG_IRQ_THREADED
+/* The top half of a threaded interrupt returns IRQ_WAKE_THREAD to run the
+ * bottom half in its thread, or OK if there is nothing more to do.
+ */
+
+#define IRQ_WAKE_THREAD 1
+
+#ifndef __ASSEMBLY__
+#ifdef CONFIG_DEBUG_IRQ_INFO
+#define irq_attach_thread(irq, isr, thread, arg, prio, stacksize) \
+	irq_attach_thread_withname(irq, isr, thread, arg, prio, stacksize, #thread)
+#endif
+#endif
+#endif
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -85,6 +100,27 @@
 typedef int (*xcpt_t)(int irq, FAR void *context, FAR void *arg);
 #endif
 
+/* With CONFIG_SCHED_STATS_IRQOFF, irqsave() and irqrestore() of the
+ * architecture report when they disable and enable the interrupts to the
+ * scheduling statistics.  User space cannot call them in the protected
+ * build.
+ */
+
+#if defined(CONFIG_SCHED_STATS_IRQOFF) && (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#define HAVE_IRQOFF_STATS 1
+
+#ifndef __ASSEMBLY__
+#ifdef __cplusplus
+extern "C" {
+#endif
+void sched_stats_irqoff(void);
+void sched_stats_irqon(void);
+#ifdef __cplusplus
+}
+#endif
+#endif
+#endif
+
 /* Now include architecture-specific types */
 
 #include <arch/irq.h>
@@ -120,6 +156,55 @@ int irq_attach_withname(int irq, xcpt_t isr, FAR void *arg, const char *name);
 int irq_attach(int irq, xcpt_t isr, FAR void *arg);
 #endif
 
+#ifdef CONFIG_IRQ_THREADED
+/****************************************************************************
+ * Name: irq_attach_thread
+ *
+ * Description:
+ *   Attach a threaded handler to IRQ number 'irq':  the top half 'isr' is
+ *   called in the interrupt handler and the bottom half 'thread' is called
+ *   in a kernel thread of its own, whenever the top half returns
+ *   IRQ_WAKE_THREAD.  Both are given 'arg'; the bottom half is given a
+ *   NULL context.  The bottom half runs once for any number of top halves
+ *   returning IRQ_WAKE_THREAD before it starts.
+ *
+ *   If 'isr' is NULL, the interrupt is disabled by up_disable_irq() until
+ *   the bottom half has run, after which it is enabled again:  the bottom
+ *   half then does all the work, including clearing the interrupt.
+ *
+ * Input Parameters:
+ *   irq - The IRQ number
+ *   isr - The top half, or NULL
+ *   thread - The bottom half
+ *   arg - The argument of both
+ *   prio - The priority of the thread
+ *   stacksize - The stack size of the thread
+ *
+ * Returned Value:
+ *   OK, or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEBUG_IRQ_INFO
+int irq_attach_thread_withname(int irq, xcpt_t isr, xcpt_t thread, FAR void *arg, int prio, int stacksize, FAR const char *name);
+#else
+int irq_attach_thread(int irq, xcpt_t isr, xcpt_t thread, FAR void *arg, int prio, int stacksize);
+#endif
+
+/****************************************************************************
+ * Name: irq_detach_thread
+ *
+ * Description:
+ *   Detach a threaded handler of irq_attach_thread() and delete its thread.
+ *
+ * Returned Value:
+ *   OK, or -EINVAL if the IRQ has no threaded handler.
+ *
+ ****************************************************************************/
+
+int irq_detach_thread(int irq);
+#endif
+
 #ifdef CONFIG_DEBUG_IRQ_INFO
 
 /****************************************************************************
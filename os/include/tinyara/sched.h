@@ -472,6 +472,37 @@ struct task_group_s {
 };
 #endif
 
+/* struct sched_stats_s **********************************************************/
+
+#ifdef CONFIG_SCHED_STATS
+/* The wake-up latencies are counted in SCHED_STATS_NHIST buckets:  bucket 0
+ * holds those under 1 usec, bucket n those from 2^(n-1) up to 2^n usec and
+ * the last bucket all the longer ones.
+ */
+
+#define SCHED_STATS_NHIST 16
+
+/** @brief The scheduling statistics of a thread, reported in /proc/<pid>/schedstat.
+ * The times are in nanoseconds, measured by sched_stats_clock().
+ */
+struct sched_stats_s {
+	uint32_t nvcsw;				/* Switches out to wait for something  */
+	uint32_t nivcsw;			/* Switches out while ready to run     */
+	uint32_t nboost;			/* Priority inheritance boosts         */
+	uint32_t maxlatency;		/* Longest wake-up latency             */
+	uint32_t maxlock;			/* Longest sched_lock() section        */
+#ifdef CONFIG_SCHED_STATS_IRQOFF
+	uint32_t maxirqoff;			/* Longest interrupt-disabled section  */
+#endif
+	uint64_t runtime;			/* Total time running                  */
+	uint64_t switchtime;		/* Time it last started running        */
+	uint64_t readytime;			/* Time it was woken up                */
+	uint64_t locktime;			/* Time of the outer sched_lock()      */
+	uint8_t waking;			/* Woken up and not yet running        */
+	uint32_t latency[SCHED_STATS_NHIST];	/* Wake-up latency histogram  */
+};
+#endif
+
 /* struct tcb_s ******************************************************************/
 
 FAR struct wdog_s;				/* Forward reference                   */
@@ -494,6 +525,10 @@ struct tcb_s {
 	/* Task Management Fields **************************************************** */
 
 	pid_t pid;					/* This is the ID of the thread        */
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+	int mowner;					/* Owner word of the mutexes it locks  */
+	/* in the user space (see pthread.h)   */
+#endif
 
 	start_t start;				/* Thread start function               */
 	entry_t entry;				/* Entry Point into the thread         */
@@ -518,6 +553,12 @@ struct tcb_s {
 	int timeslice;				/* RR timeslice interval remaining     */
 #endif
 	FAR struct wdog_s *waitdog;	/* All timed waits used this wdog      */
+#ifdef CONFIG_HRTIMER
+	FAR struct hrtimer_s *waittimer;	/* Or this hrtimer, in sigtimedwait()  */
+#endif
+#ifdef CONFIG_SCHED_STATS
+	struct sched_stats_s stats;	/* Scheduling statistics               */
+#endif
 
 	/* Stack-Related Fields ****************************************************** */
 
@@ -723,6 +764,19 @@ void sched_foreach(sched_foreach_t handler, FAR void *arg);
  */
 FAR struct tcb_s *sched_gettcb(pid_t pid);
 
+#ifdef CONFIG_SCHED_STATS
+/**
+ * @cond
+ * @internal
+ * Return the time of the scheduling statistics in nanoseconds: the time of
+ * up_timer_gettime() with CONFIG_SCHED_TICKLESS, the system ticks otherwise.
+ */
+uint64_t sched_stats_clock(void);
+/**
+ * @endcond
+ */
+#endif
+
 /* File system helpers **********************************************************/
 /* These functions all extract lists from the group structure assocated with the
  * currently executing task.
@@ -29,6 +29,8 @@
 
 #include <tinyara/config.h>
 #include <tinyara/fs/ioctl.h>
+#include <stdint.h>
+#include <stdbool.h>
 
 #ifdef CONFIG_KERNEL_TEST_DRV
 
@@ -63,9 +65,49 @@
 #define TESTIOC_SCHED_FOREACH                  _TESTIOC(9)
 #define TESTIOC_SIGNAL_PAUSE                   _TESTIOC(10)
 #define TESTIOC_TIMER_INITIALIZE               _TESTIOC(11)
+#define TESTIOC_TASK_POOL_MEMBER               _TESTIOC(12)
+#define TESTIOC_HRTIMER_EXPIRY                 _TESTIOC(13)
+#define TESTIOC_WDOG_EXPIRY                    _TESTIOC(14)
 
 #define KERNEL_TC_DRVPATH                       "/dev/testcase"
 
+/* The timers started by TESTIOC_HRTIMER_EXPIRY */
+
+#define TESTIOC_HRTIMER_NTIMERS                3
+
+/* The watchdogs started by TESTIOC_WDOG_EXPIRY */
+
+#define TESTIOC_WDOG_NWDOGS                    8
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The argument of TESTIOC_HRTIMER_EXPIRY, which starts a timer for each
+ * delay, waits for them to expire and reports when their functions were
+ * called.
+ */
+
+struct testioc_hrtimer_s {
+	uint32_t delay[TESTIOC_HRTIMER_NTIMERS];	/* In: nanoseconds before each expiration, 0 for no timer */
+	uint8_t flags;				/* In: 0 or HRTIMER_THREAD */
+	bool cancel;				/* In: cancel the first timer once they are all started */
+	int32_t late[TESTIOC_HRTIMER_NTIMERS];	/* Out: nanoseconds from each expiration to the call */
+	int8_t seq[TESTIOC_HRTIMER_NTIMERS];	/* Out: the rank of each call, -1 if not called */
+};
+
+/* The argument of TESTIOC_WDOG_EXPIRY, which starts a watchdog for each
+ * delay in the same tick, waits for them to expire and reports in which
+ * tick they were called.
+ */
+
+struct testioc_wdog_s {
+	int32_t delay[TESTIOC_WDOG_NWDOGS];	/* In: ticks before each expiration, 0 for no watchdog */
+	int8_t cancel;				/* In: the watchdog to cancel once they are all started, or -1 */
+	bool called[TESTIOC_WDOG_NWDOGS];	/* Out: whether each watchdog was called */
+	int32_t late[TESTIOC_WDOG_NWDOGS];	/* Out: ticks from each expiration to the call */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -176,6 +176,15 @@ extern "C" {
 #define EXTERN extern
 #endif
 
+/* The owner word of the running thread for the fast path of the pthread
+ * mutexes, written by the kernel on each context switch once task_startup()
+ * registered it with prctl(PR_SET_MUTEX_OWNER)
+ */
+
+#if defined(CONFIG_PTHREAD_MUTEX_FASTPATH) && !defined(__KERNEL__)
+EXTERN volatile int g_curowner;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
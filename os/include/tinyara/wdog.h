@@ -152,7 +152,13 @@ struct wdog_s {
 	int lag;					/* Timer associated with the delay */
 	uint8_t flags;				/* See WDOGF_* definitions above */
 	uint8_t argc;				/* The number of parameters to pass */
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+	uint8_t slot;				/* Slot of the timer wheel holding it */
+#endif
 	uint32_t parm[CONFIG_MAX_WDOGPARMS];
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+	FAR struct wdog_s **pprev;	/* The link to it in its slot */
+#endif
 };
 
 /* Watchdog 'handle' */
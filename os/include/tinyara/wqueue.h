@@ -64,6 +64,10 @@
 #include <semaphore.h>
 #include <queue.h>
 
+#ifdef CONFIG_SCHED_WORKPOOL
+#include <tinyara/wdog.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -106,6 +110,12 @@
  *  checks for work in units of microseconds.  Default: 50*1000 (50 MS).
  * CONFIG_SCHED_LPWORKSTACKSIZE - The stack size allocated for the lower
  *   priority worker thread.  Default: 2048.
+ * CONFIG_SCHED_WORKPOOL - The low priority work queue is a pool of
+ *   CONFIG_SCHED_LPNTHREADS workers with a run queue per priority.  Each
+ *   work runs at the priority of the task which queued it, and a delayed
+ *   work waits in a watchdog instead of being polled.
+ * CONFIG_SCHED_WORKPOOL_STATS - Count the latency and the run time of the
+ *   work of the pool, for each worker callback, in /proc/workpool.
  *
  * The user-mode work queue is only available in the protected or kernel
  * builds.  This those configurations, the user-mode work queue provides the
@@ -308,6 +318,13 @@ struct work_s {
 	FAR void *arg;				/* Callback argument */
 	clock_t qtime;			/* Time work queued */
 	clock_t delay;			/* Delay until work performed */
+#if defined(CONFIG_SCHED_LPWORK) && defined(CONFIG_SCHED_WORKPOOL)
+	struct wdog_s timer;		/* Times the delay of LPWORK work */
+	uint8_t prio;				/* Priority the LPWORK work runs at */
+#ifdef CONFIG_SCHED_WORKPOOL_STATS
+	uint32_t ready;				/* Time it was ready to run, in microseconds */
+#endif
+#endif
 };
 
 /****************************************************************************
@@ -448,7 +465,7 @@ int work_signal(int qid);
  *
  ****************************************************************************/
 
-#if defined(CONFIG_SCHED_LPWORK) && defined(CONFIG_PRIORITY_INHERITANCE)
+#if defined(CONFIG_SCHED_LPWORK) && defined(CONFIG_PRIORITY_INHERITANCE) && !defined(CONFIG_SCHED_WORKPOOL)
 void lpwork_boostpriority(uint8_t reqprio);
 #endif
 
@@ -470,10 +487,19 @@ void lpwork_boostpriority(uint8_t reqprio);
  *
  ****************************************************************************/
 
-#if defined(CONFIG_SCHED_LPWORK) && defined(CONFIG_PRIORITY_INHERITANCE)
+#if defined(CONFIG_SCHED_LPWORK) && defined(CONFIG_PRIORITY_INHERITANCE) && !defined(CONFIG_SCHED_WORKPOOL)
 void lpwork_restorepriority(uint8_t reqprio);
 #endif
 
+/* With CONFIG_SCHED_WORKPOOL, the work of the low priority queue already
+ * runs at the priority of the task which queued it.
+ */
+
+#if defined(CONFIG_SCHED_LPWORK) && defined(CONFIG_PRIORITY_INHERITANCE) && defined(CONFIG_SCHED_WORKPOOL)
+#define lpwork_boostpriority(reqprio)   ((void)(reqprio))
+#define lpwork_restorepriority(reqprio) ((void)(reqprio))
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
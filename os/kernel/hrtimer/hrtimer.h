@@ -0,0 +1,87 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/hrtimer/hrtimer.h
+ ****************************************************************************/
+
+#ifndef __KERNEL_HRTIMER_HRTIMER_H
+#define __KERNEL_HRTIMER_HRTIMER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <queue.h>
+
+#include <tinyara/hrtimer.h>
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The started timers, ordered by expiration */
+
+extern dq_queue_t g_hrtimerlist;
+
+/* True while hrtimer_process() calls the functions of the expired timers,
+ * which then need not reassess the interval timer when they start a timer.
+ */
+
+extern bool g_hrtimerprocessing;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_process
+ *
+ * Description:
+ *   Remove the timers which have expired from g_hrtimerlist and call their
+ *   functions, or queue them for the HPWORK thread.  Called by the tickless
+ *   OS along with wd_timer().
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void hrtimer_process(void);
+
+/****************************************************************************
+ * Name: hrtimer_next
+ *
+ * Description:
+ *   Return the hrtimer_gettime() time of the next expiration, or zero if no
+ *   timer is started.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_next(void);
+
+#endif							/* CONFIG_HRTIMER */
+#endif							/* __KERNEL_HRTIMER_HRTIMER_H */
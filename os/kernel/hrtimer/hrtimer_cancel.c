@@ -0,0 +1,82 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/hrtimer/hrtimer_cancel.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <queue.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <arch/irq.h>
+#include <tinyara/hrtimer.h>
+#ifdef CONFIG_SCHED_HPWORK
+#include <tinyara/wqueue.h>
+#endif
+
+#include "hrtimer/hrtimer.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Stop a timer.  With HRTIMER_THREAD, a call already queued for the
+ *   HPWORK thread is cancelled as well.
+ *
+ *   The interval timer or alarm isn't reassessed when the first timer is
+ *   cancelled: it then expires for nothing, which costs less than setting
+ *   it up again here.
+ *
+ * Return Value:
+ *   OK, or -EINVAL if the timer was not started.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *timer)
+{
+	irqstate_t state;
+	int ret = -EINVAL;
+
+	DEBUGASSERT(timer);
+
+	state = irqsave();
+
+	if (HRTIMER_ISACTIVE(timer)) {
+		dq_rem((FAR dq_entry_t *)timer, &g_hrtimerlist);
+		timer->flags &= ~HRTIMERF_ACTIVE;
+		ret = OK;
+	}
+#ifdef CONFIG_SCHED_HPWORK
+	else if ((timer->flags & HRTIMER_THREAD) != 0 && work_cancel(HPWORK, &timer->work) == OK) {
+		ret = OK;
+	}
+#endif
+
+	irqrestore(state);
+	return ret;
+}
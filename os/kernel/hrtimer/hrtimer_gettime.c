@@ -0,0 +1,83 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/hrtimer/hrtimer_gettime.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <time.h>
+
+#include <arch/irq.h>
+#include <tinyara/arch.h>
+#include <tinyara/clock.h>
+#include <tinyara/hrtimer.h>
+
+#include "hrtimer/hrtimer.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_gettime
+ *
+ * Description:
+ *   Return the time in nanoseconds since power up, from up_timer_gettime().
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_gettime(void)
+{
+	struct timespec ts;
+
+	(void)up_timer_gettime(&ts);
+	return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: hrtimer_remaining
+ *
+ * Description:
+ *   Return the nanoseconds until a timer expires, zero if it is not
+ *   started.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_remaining(FAR struct hrtimer_s *timer)
+{
+	irqstate_t flags;
+	uint64_t remaining = 0;
+	uint64_t now;
+
+	flags = irqsave();
+	if (HRTIMER_ISACTIVE(timer)) {
+		now = hrtimer_gettime();
+		if (timer->expiry > now) {
+			remaining = timer->expiry - now;
+		}
+	}
+	irqrestore(flags);
+
+	return remaining;
+}
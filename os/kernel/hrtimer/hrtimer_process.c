@@ -0,0 +1,121 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/hrtimer/hrtimer_process.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <queue.h>
+#include <debug.h>
+
+#include <tinyara/hrtimer.h>
+#ifdef CONFIG_SCHED_HPWORK
+#include <tinyara/wqueue.h>
+#endif
+
+#include "hrtimer/hrtimer.h"
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+dq_queue_t g_hrtimerlist;
+bool g_hrtimerprocessing;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK
+static void hrtimer_worker(FAR void *arg)
+{
+	FAR struct hrtimer_s *timer = (FAR struct hrtimer_s *)arg;
+
+	timer->func(timer, timer->arg);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_process
+ *
+ * Description:
+ *   Remove the timers which have expired from g_hrtimerlist and call their
+ *   functions, or queue them for the HPWORK thread.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void hrtimer_process(void)
+{
+	FAR struct hrtimer_s *timer;
+	uint64_t now = hrtimer_gettime();
+
+	g_hrtimerprocessing = true;
+
+	/* A function may start its timer again, at a time which has already
+	 * passed in which case it is called again.
+	 */
+
+	while ((timer = (FAR struct hrtimer_s *)g_hrtimerlist.head) != NULL && timer->expiry <= now) {
+		dq_rem((FAR dq_entry_t *)timer, &g_hrtimerlist);
+		timer->flags &= ~HRTIMERF_ACTIVE;
+
+#ifdef CONFIG_SCHED_HPWORK
+		if ((timer->flags & HRTIMER_THREAD) != 0) {
+			int ret = work_queue(HPWORK, &timer->work, hrtimer_worker, timer, 0);
+			if (ret < 0) {
+				slldbg("ERROR: work_queue failed: %d\n", ret);
+			}
+			continue;
+		}
+#endif
+
+		timer->func(timer, timer->arg);
+	}
+
+	g_hrtimerprocessing = false;
+}
+
+/****************************************************************************
+ * Name: hrtimer_next
+ *
+ * Description:
+ *   Return the hrtimer_gettime() time of the next expiration, or zero if no
+ *   timer is started.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_next(void)
+{
+	FAR struct hrtimer_s *timer = (FAR struct hrtimer_s *)g_hrtimerlist.head;
+
+	return timer ? timer->expiry : 0;
+}
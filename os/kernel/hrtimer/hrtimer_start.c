@@ -0,0 +1,135 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/hrtimer/hrtimer_start.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <queue.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <arch/irq.h>
+#include <tinyara/hrtimer.h>
+
+#include "sched/sched.h"
+#include "hrtimer/hrtimer.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_init
+ *
+ * Description:
+ *   Initialize a timer, which is then not started.
+ *
+ ****************************************************************************/
+
+void hrtimer_init(FAR struct hrtimer_s *timer)
+{
+	timer->flink = NULL;
+	timer->blink = NULL;
+	timer->expiry = 0;
+	timer->func = NULL;
+	timer->arg = NULL;
+	timer->flags = 0;
+#ifdef CONFIG_SCHED_HPWORK
+	timer->work.worker = NULL;
+#endif
+}
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   Start a timer, or restart it if it is started.  The function is called
+ *   once the time has passed, at the earliest.
+ *
+ * Parameters:
+ *   timer - The timer
+ *   nsec - Nanoseconds from now, or with HRTIMER_ABSTIME the
+ *     hrtimer_gettime() time of the expiration
+ *   func - The function to call when the timer expires
+ *   arg - Its argument
+ *   flags - HRTIMER_ABSTIME and HRTIMER_THREAD
+ *
+ * Return Value:
+ *   OK, or -ENOSYS for HRTIMER_THREAD without CONFIG_SCHED_HPWORK.
+ *
+ * Assumptions:
+ *   May be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *timer, uint64_t nsec, hrtimer_func_t func, FAR void *arg, uint8_t flags)
+{
+	FAR struct hrtimer_s *curr;
+	irqstate_t state;
+
+	DEBUGASSERT(timer && func);
+
+#ifndef CONFIG_SCHED_HPWORK
+	if ((flags & HRTIMER_THREAD) != 0) {
+		return -ENOSYS;
+	}
+#endif
+
+	state = irqsave();
+
+	if (HRTIMER_ISACTIVE(timer)) {
+		dq_rem((FAR dq_entry_t *)timer, &g_hrtimerlist);
+	}
+
+	timer->expiry = (flags & HRTIMER_ABSTIME) != 0 ? nsec : hrtimer_gettime() + nsec;
+	timer->func = func;
+	timer->arg = arg;
+	timer->flags = (flags & HRTIMER_THREAD) | HRTIMERF_ACTIVE;
+
+	/* Insert it after the timers expiring at the same time or before.  The
+	 * list is searched from its tail, where periodic timers restarted for
+	 * their next period usually go.
+	 */
+
+	for (curr = (FAR struct hrtimer_s *)g_hrtimerlist.tail; curr && curr->expiry > timer->expiry; curr = curr->blink) ;
+
+	if (curr) {
+		dq_addafter((FAR dq_entry_t *)curr, (FAR dq_entry_t *)timer, &g_hrtimerlist);
+	} else {
+		dq_addfirst((FAR dq_entry_t *)timer, &g_hrtimerlist);
+
+		/* It expires first: the interval timer or alarm may have to expire
+		 * sooner.  hrtimer_process() reassesses it anyway once the functions
+		 * of the expired timers return.
+		 */
+
+		if (!g_hrtimerprocessing) {
+			sched_timer_reassess();
+		}
+	}
+
+	irqrestore(state);
+	return OK;
+}
@@ -134,6 +134,13 @@ volatile dq_queue_t g_readytorun;
 
 volatile dq_queue_t g_pendingtasks;
 
+/* The indexes of the g_readytorun and g_pendingtasks lists by priority */
+
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+struct sched_prioindex_s g_readytorun_index;
+struct sched_prioindex_s g_pendingtasks_index;
+#endif
+
 /* This is the list of all tasks that are blocked waiting for a semaphore */
 
 volatile dq_queue_t g_waitingforsemaphore;
@@ -195,6 +202,20 @@ volatile uint8_t g_alive_taskcount;
 
 volatile pid_t g_lastpid;
 
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+/* The number of times g_lastpid wrapped around, which tells apart the
+ * threads getting the same pid in the owner word of the mutexes.
+ */
+
+volatile uint16_t g_pidgen;
+
+/* The word of the user space where the owner word of the running thread
+ * is published, registered by prctl(PR_SET_MUTEX_OWNER)
+ */
+
+FAR volatile int *g_curowner;
+#endif
+
 /* The following hash table is used for two things:
  *
  * 1. This hash table greatly speeds the determination of
@@ -427,6 +448,14 @@ void os_start(void)
 	}
 #endif
 
+#ifdef CONFIG_TASK_POOL
+	/* Allocate the TCBs and stacks of the task pool while the heaps are
+	 * still empty.
+	 */
+
+	sched_taskpool_initialize();
+#endif
+
 	/* Initialize the interrupt handling subsystem (if included) */
 
 #ifdef CONFIG_HAVE_WEAKFUNCTIONS
@@ -522,6 +551,12 @@ void os_start(void)
 
 	up_initialize();
 
+#ifdef CONFIG_SCHED_STATS
+	/* Start the scheduling statistics, now that the timer is running */
+
+	sched_stats_initialize();
+#endif
+
 	/* Auto-mount Arch-independent File Sysytems */
 
 	fs_auto_mount();
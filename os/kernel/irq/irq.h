@@ -59,7 +59,11 @@
 
 #include <tinyara/config.h>
 
+#include <stdint.h>
+#include <time.h>
+
 #include <tinyara/arch.h>
+#include <tinyara/clock.h>
 #include <tinyara/irq.h>
 #include <tinyara/compiler.h>
 
@@ -80,6 +84,15 @@ struct irq {
 #ifdef CONFIG_DEBUG_IRQ_INFO
 	char irq_name[MAX_IRQNAME_SIZE + 1]; /* Includes the terminating Null */
 	size_t count;
+#ifdef CONFIG_IRQ_THREADED
+	size_t threadcount;			/* Runs of the bottom half */
+#endif
+#ifdef CONFIG_DEBUG_IRQ_TIMING
+	uint32_t maxtop;			/* Longest handler, in nanoseconds */
+#ifdef CONFIG_IRQ_THREADED
+	uint32_t maxlatency;		/* Longest wait of the bottom half */
+#endif
+#endif
 #endif
 };
 
@@ -103,6 +116,41 @@ extern "C" {
 void weak_function irq_initialize(void);
 int irq_unexpected_isr(int irq, FAR void *context, FAR void *arg);
 
+#ifdef CONFIG_DEBUG_IRQ_TIMING
+/****************************************************************************
+ * Name: irq_gettime
+ *
+ * Description:
+ *   Return the time in nanoseconds of the handler timing, from the
+ *   free-running timer of the tickless OS.
+ *
+ ****************************************************************************/
+
+static inline uint64_t irq_gettime(void)
+{
+	struct timespec ts;
+
+	(void)up_timer_gettime(&ts);
+	return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: irq_elapsed
+ *
+ * Description:
+ *   Return the nanoseconds since a time of irq_gettime(), saturated to 32
+ *   bits.
+ *
+ ****************************************************************************/
+
+static inline uint32_t irq_elapsed(uint64_t start)
+{
+	uint64_t elapsed = irq_gettime() - start;
+
+	return elapsed > UINT32_MAX ? UINT32_MAX : (uint32_t)elapsed;
+}
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -140,6 +140,15 @@ int irq_attach(int irq, xcpt_t isr, FAR void *arg)
 #ifdef CONFIG_DEBUG_IRQ_INFO
 		/* Reset the irq counter to 0 and it's applicable for both irq_attach and irq_detach */
 		g_irqvector[irq].count   = 0;
+#ifdef CONFIG_IRQ_THREADED
+		g_irqvector[irq].threadcount = 0;
+#endif
+#ifdef CONFIG_DEBUG_IRQ_TIMING
+		g_irqvector[irq].maxtop  = 0;
+#ifdef CONFIG_IRQ_THREADED
+		g_irqvector[irq].maxlatency = 0;
+#endif
+#endif
 		if (name != NULL) {
 			strncpy(g_irqvector[irq].irq_name, name, MAX_IRQNAME_SIZE);
 			g_irqvector[irq].irq_name[MAX_IRQNAME_SIZE] = '\0';
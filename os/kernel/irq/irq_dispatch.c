@@ -103,6 +103,10 @@ void irq_dispatch(int irq, FAR void *context)
 {
 	xcpt_t vector;
 	FAR void *arg;
+#ifdef CONFIG_DEBUG_IRQ_TIMING
+	uint64_t start;
+	uint32_t elapsed;
+#endif
 
 	/* Perform some sanity checks */
 
@@ -128,5 +132,18 @@ void irq_dispatch(int irq, FAR void *context)
 
 	/* Then dispatch to the interrupt handler */
 
+#ifdef CONFIG_DEBUG_IRQ_TIMING
+	start = irq_gettime();
+#endif
+
 	vector(irq, context, arg);
+
+#if defined(CONFIG_DEBUG_IRQ_TIMING) && NR_IRQS > 0
+	/* The time of the handler, which is the top half of a threaded one */
+
+	elapsed = irq_elapsed(start);
+	if ((unsigned)irq < NR_IRQS && elapsed > g_irqvector[irq].maxtop) {
+		g_irqvector[irq].maxtop = elapsed;
+	}
+#endif
 }
@@ -85,12 +85,31 @@
  * to handle the longest line generated by this logic.
  */
 
-#define IRQS_LINELEN 64
+#define IRQS_LINELEN 96
 
+/* With the threaded interrupts, the runs of the bottom half.  With the
+ * handler timing, the longest handler (the top half of a threaded one) and
+ * the longest wait of the bottom half, in microseconds.
+ */
+
+#if defined(CONFIG_IRQ_THREADED) && defined(CONFIG_DEBUG_IRQ_TIMING)
+#define IRQS_INFO_TITLE_FMT " %8s | %9s | %9s | %7s | %7s | %3s \n"
+#define IRQS_INFO_LINE " ---------|-----------|-----------|---------|---------|--------------\n"
+#define IRQS_INFO_TITLE "IRQ_NUM", "INT_COUNT", "THR_COUNT", "TOP_US", "LAT_US", "ISR_NAME"
+#elif defined(CONFIG_IRQ_THREADED)
+#define IRQS_INFO_TITLE_FMT " %8s | %9s | %9s | %3s \n"
+#define IRQS_INFO_LINE " ---------|-----------|-----------|--------------\n"
+#define IRQS_INFO_TITLE "IRQ_NUM", "INT_COUNT", "THR_COUNT", "ISR_NAME"
+#elif defined(CONFIG_DEBUG_IRQ_TIMING)
+#define IRQS_INFO_TITLE_FMT " %8s | %9s | %7s | %3s \n"
+#define IRQS_INFO_LINE " ---------|-----------|---------|--------------\n"
+#define IRQS_INFO_TITLE "IRQ_NUM", "INT_COUNT", "TOP_US", "ISR_NAME"
+#else
 #define IRQS_INFO_TITLE_FMT " %8s | %9s | %3s \n"
 #define IRQS_INFO_LINE " ---------|-----------|--------------\n"
 #define IRQS_INFO_TITLE "IRQ_NUM", "INT_COUNT", "ISR_NAME"
 #define IRQS_INFO_FMT " %8d | %9d | %s \n"
+#endif
 
 /****************************************************************************
  * Private Types
@@ -213,6 +232,25 @@ static int irqs_close(FAR struct file *filep)
 	return OK;
 }
 
+/****************************************************************************
+ * Name: irqs_line
+ ****************************************************************************/
+
+static size_t irqs_line(FAR char *line, int irq)
+{
+	FAR struct irq *vector = &g_irqvector[irq];
+
+#if defined(CONFIG_IRQ_THREADED) && defined(CONFIG_DEBUG_IRQ_TIMING)
+	return snprintf(line, IRQS_LINELEN, " %8d | %9d | %9d | %7lu | %7lu | %s \n", irq, vector->count, vector->threadcount, (unsigned long)vector->maxtop / NSEC_PER_USEC, (unsigned long)vector->maxlatency / NSEC_PER_USEC, vector->irq_name);
+#elif defined(CONFIG_IRQ_THREADED)
+	return snprintf(line, IRQS_LINELEN, " %8d | %9d | %9d | %s \n", irq, vector->count, vector->threadcount, vector->irq_name);
+#elif defined(CONFIG_DEBUG_IRQ_TIMING)
+	return snprintf(line, IRQS_LINELEN, " %8d | %9d | %7lu | %s \n", irq, vector->count, (unsigned long)vector->maxtop / NSEC_PER_USEC, vector->irq_name);
+#else
+	return snprintf(line, IRQS_LINELEN, IRQS_INFO_FMT, irq, vector->count, vector->irq_name);
+#endif
+}
+
 /****************************************************************************
  * Name: irqs_read
  ****************************************************************************/
@@ -255,7 +293,7 @@ static ssize_t irqs_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 
 	for (irq_idx = 0; irq_idx < NR_IRQS; irq_idx++) {
 		if (g_irqvector[irq_idx].handler != NULL && g_irqvector[irq_idx].handler != irq_unexpected_isr) {			
-			linesize = snprintf(attr->line, IRQS_LINELEN, IRQS_INFO_FMT, irq_idx, g_irqvector[irq_idx].count, g_irqvector[irq_idx].irq_name);
+			linesize = irqs_line(attr->line, irq_idx);
 			copysize = procfs_memcpy(attr->line, linesize, buffer, buflen - totalsize, &offset);			
 			totalsize += copysize;
 			buffer += copysize;
@@ -0,0 +1,265 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/irq/irq_thread.c
+ *
+ * Threaded interrupt handlers with CONFIG_IRQ_THREADED.  The interrupt is
+ * attached to irq_thread_isr(), which calls the top half of the driver and,
+ * if it returns IRQ_WAKE_THREAD, wakes up a kernel thread of the IRQ to
+ * call the bottom half.  The bottom half may then block, and runs at the
+ * priority chosen for it instead of before any thread.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <semaphore.h>
+#include <sched.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/irq.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/kthread.h>
+#include <tinyara/semaphore.h>
+
+#include "irq/irq.h"
+
+#ifdef CONFIG_IRQ_THREADED
+
+/****************************************************************************
+ * Private Type Declarations
+ ****************************************************************************/
+
+/* A threaded handler, the argument of irq_thread_isr() */
+
+struct irq_thread_s {
+	xcpt_t isr;					/* Top half, or NULL */
+	xcpt_t thread;				/* Bottom half */
+	FAR void *arg;				/* Their argument */
+	sem_t sem;					/* Wakes up the thread */
+	pid_t pid;					/* The thread */
+	volatile bool pending;		/* The bottom half has to run */
+#ifdef CONFIG_DEBUG_IRQ_TIMING
+	uint64_t waketime;			/* When it was woken up */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_thread_isr
+ *
+ * Description:
+ *   The interrupt handler of a threaded IRQ.
+ *
+ ****************************************************************************/
+
+static int irq_thread_isr(int irq, FAR void *context, FAR void *arg)
+{
+	FAR struct irq_thread_s *desc = (FAR struct irq_thread_s *)arg;
+
+	if (desc->isr) {
+		if (desc->isr(irq, context, desc->arg) != IRQ_WAKE_THREAD) {
+			return OK;
+		}
+	} else {
+		/* Keep the interrupt off until the bottom half has served it */
+
+		up_disable_irq(irq);
+	}
+
+	if (!desc->pending) {
+		desc->pending = true;
+#ifdef CONFIG_DEBUG_IRQ_TIMING
+		desc->waketime = irq_gettime();
+#endif
+		sem_post(&desc->sem);
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: irq_thread_main
+ *
+ * Description:
+ *   The kernel thread of a threaded IRQ, whose number is argv[1].
+ *
+ ****************************************************************************/
+
+static int irq_thread_main(int argc, char *argv[])
+{
+	FAR struct irq_thread_s *desc;
+	irqstate_t flags;
+	int irq;
+#ifdef CONFIG_DEBUG_IRQ_TIMING
+	uint32_t latency;
+#endif
+
+	DEBUGASSERT(argc == 2);
+	irq = atoi(argv[1]);
+	desc = (FAR struct irq_thread_s *)g_irqvector[irq].arg;
+
+	for (;;) {
+		while (sem_wait(&desc->sem) != OK) {
+			DEBUGASSERT(get_errno() == EINTR);
+		}
+
+		/* A top half from now on wakes the thread up again */
+
+		flags = irqsave();
+		desc->pending = false;
+#ifdef CONFIG_DEBUG_IRQ_INFO
+		g_irqvector[irq].threadcount++;
+#endif
+#ifdef CONFIG_DEBUG_IRQ_TIMING
+		latency = irq_elapsed(desc->waketime);
+		if (latency > g_irqvector[irq].maxlatency) {
+			g_irqvector[irq].maxlatency = latency;
+		}
+#endif
+		irqrestore(flags);
+
+		desc->thread(irq, NULL, desc->arg);
+
+		if (!desc->isr) {
+			up_enable_irq(irq);
+		}
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_attach_thread
+ *
+ * Description:
+ *   Attach a threaded handler, see include/tinyara/irq.h.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEBUG_IRQ_INFO
+int irq_attach_thread_withname(int irq, xcpt_t isr, xcpt_t thread, FAR void *arg, int prio, int stacksize, FAR const char *name)
+#else
+int irq_attach_thread(int irq, xcpt_t isr, xcpt_t thread, FAR void *arg, int prio, int stacksize)
+#endif
+{
+	FAR struct irq_thread_s *desc;
+	FAR char *argv[2];
+	char tname[12];
+	char arg1[8];
+	int ret;
+
+	if ((unsigned)irq >= NR_IRQS || thread == NULL) {
+		return -EINVAL;
+	}
+
+	desc = (FAR struct irq_thread_s *)kmm_zalloc(sizeof(struct irq_thread_s));
+	if (!desc) {
+		return -ENOMEM;
+	}
+
+	desc->isr = isr;
+	desc->thread = thread;
+	desc->arg = arg;
+
+	/* The semaphore is only used for signaling */
+
+	sem_init(&desc->sem, 0, 0);
+#ifdef CONFIG_PRIORITY_INHERITANCE
+	sem_setprotocol(&desc->sem, SEM_PRIO_NONE);
+#endif
+
+	/* The thread must find the handler attached when it starts */
+
+	sched_lock();
+
+#ifdef CONFIG_DEBUG_IRQ_INFO
+	ret = irq_attach_withname(irq, irq_thread_isr, desc, name);
+#else
+	ret = irq_attach(irq, irq_thread_isr, desc);
+#endif
+	if (ret != OK) {
+		ret = -EINVAL;
+		goto errout;
+	}
+
+	snprintf(tname, sizeof(tname), "irq%d", irq);
+	snprintf(arg1, sizeof(arg1), "%d", irq);
+	argv[0] = arg1;
+	argv[1] = NULL;
+
+	ret = kernel_thread(tname, prio, stacksize, (main_t)irq_thread_main, (FAR char *const *)argv);
+	if (ret < 0) {
+		ret = -get_errno();
+		irq_detach(irq);
+		goto errout;
+	}
+
+	desc->pid = (pid_t)ret;
+	sched_unlock();
+	return OK;
+
+errout:
+	sched_unlock();
+	sem_destroy(&desc->sem);
+	kmm_free(desc);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: irq_detach_thread
+ *
+ * Description:
+ *   Detach a threaded handler, see include/tinyara/irq.h.
+ *
+ ****************************************************************************/
+
+int irq_detach_thread(int irq)
+{
+	FAR struct irq_thread_s *desc;
+
+	if ((unsigned)irq >= NR_IRQS || g_irqvector[irq].handler != irq_thread_isr) {
+		return -EINVAL;
+	}
+
+	desc = (FAR struct irq_thread_s *)g_irqvector[irq].arg;
+	irq_detach(irq);
+
+	task_delete(desc->pid);
+	sem_destroy(&desc->sem);
+	kmm_free(desc);
+	return OK;
+}
+
+#endif							/* CONFIG_IRQ_THREADED */
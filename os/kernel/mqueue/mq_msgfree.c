@@ -96,6 +96,7 @@
  *   allocated dynamically it will be deallocated.
  *
  * Inputs:
+ *   msgq - The message queue of the message
  *   mqmsg - message to free
  *
  * Return Value:
@@ -103,7 +104,7 @@
  *
  ************************************************************************/
 
-void mq_msgfree(FAR struct mqueue_msg_s *mqmsg)
+void mq_msgfree(FAR struct mqueue_inode_s *msgq, FAR struct mqueue_msg_s *mqmsg)
 {
 	irqstate_t saved_state;
 
@@ -142,7 +143,17 @@ void mq_msgfree(FAR struct mqueue_msg_s *mqmsg)
 
 	else if (mqmsg->type == MQ_ALLOC_DYN) {
 		sched_kfree(mqmsg);
-	} else {
+	}
+#ifdef CONFIG_MQ_MSGPOOL
+	/* A message of the pool of its queue goes back to the pool */
+
+	else if (mqmsg->type == MQ_ALLOC_QUEUE) {
+		saved_state = irqsave();
+		sq_addlast((FAR sq_entry_t *)mqmsg, &msgq->msgfree);
+		irqrestore(saved_state);
+	}
+#endif
+	else {
 		PANIC();
 	}
 }
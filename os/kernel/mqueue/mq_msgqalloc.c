@@ -56,8 +56,10 @@
 
 #include <tinyara/config.h>
 
+#include <stdint.h>
 #include <mqueue.h>
 #include <assert.h>
+#include <errno.h>
 
 #include <tinyara/kmalloc.h>
 #include <tinyara/sched.h>
@@ -86,6 +88,47 @@
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_MQ_MSGPOOL
+/****************************************************************************
+ * Name: mq_msgpoolalloc
+ *
+ * Description:
+ *   Allocate the pool of a message queue: one message for each message the
+ *   queue can hold, of the size of its messages, in one block.
+ *
+ * Return Value:
+ *   OK, or -ENOMEM.
+ *
+ ****************************************************************************/
+
+static int mq_msgpoolalloc(FAR struct mqueue_inode_s *msgq)
+{
+	FAR struct mqueue_msg_s *mqmsg;
+	FAR uint8_t *pool;
+	size_t msgsize = MQ_POOL_MSGSIZE(MQ_MSGBYTES(msgq));
+	int i;
+
+	sq_init(&msgq->msgfree);
+	if (msgq->maxmsgs <= 0) {
+		return OK;
+	}
+
+	pool = (FAR uint8_t *)kmm_malloc(msgsize * msgq->maxmsgs);
+	if (!pool) {
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < msgq->maxmsgs; i++) {
+		mqmsg = (FAR struct mqueue_msg_s *)(pool + i * msgsize);
+		mqmsg->type = MQ_ALLOC_QUEUE;
+		sq_addlast((FAR sq_entry_t *)mqmsg, &msgq->msgfree);
+	}
+
+	msgq->msgpool = pool;
+	return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -101,7 +144,10 @@
  *   mode   - mode_t value is ignored
  *   attr   - The mq_maxmsg attribute is used at the time that the message
  *            queue is created to determine the maximum number of
- *            messages that may be placed in the message queue.
+ *            messages that may be placed in the message queue.  With
+ *            CONFIG_MQ_MSGPOOL, they are allocated here, and with
+ *            CONFIG_MQ_ZEROCOPY, MQ_ZEROCOPY in mq_flags creates a
+ *            zero-copy queue.
  *
  * Return Value:
  *   The allocated and initialized message queue structure or NULL in the
@@ -117,10 +163,18 @@ FAR struct mqueue_inode_s *mq_msgqalloc(mode_t mode, FAR struct mq_attr *attr)
 	 * larger than the configured maximum message size.
 	 */
 
+#ifdef CONFIG_MQ_MSGPOOL
+	/* The messages are allocated here, of the size of the queue */
+
+	if (attr && attr->mq_msgsize > MQ_POOL_MAX_BYTES) {
+		return NULL;
+	}
+#else
 	DEBUGASSERT(!attr || attr->mq_msgsize <= MQ_MAX_BYTES);
 	if (attr && attr->mq_msgsize > MQ_MAX_BYTES) {
 		return NULL;
 	}
+#endif
 
 	/* Allocate memory for the new message queue. */
 
@@ -138,6 +192,16 @@ FAR struct mqueue_inode_s *mq_msgqalloc(mode_t mode, FAR struct mq_attr *attr)
 			msgq->maxmsgsize = MQ_MAX_BYTES;
 		}
 
+#ifdef CONFIG_MQ_ZEROCOPY
+		msgq->zerocopy = (attr && (attr->mq_flags & MQ_ZEROCOPY) != 0);
+#endif
+#ifdef CONFIG_MQ_MSGPOOL
+		if (mq_msgpoolalloc(msgq) != OK) {
+			kmm_free(msgq);
+			return NULL;
+		}
+#endif
+
 #ifndef CONFIG_DISABLE_SIGNALS
 		msgq->ntpid = INVALID_PROCESS_ID;
 #endif
@@ -56,6 +56,7 @@
 
 #include <tinyara/config.h>
 
+#include <string.h>
 #include <debug.h>
 #include <tinyara/kmalloc.h>
 #include "mqueue/mqueue.h"
@@ -111,13 +112,34 @@ void mq_msgqfree(FAR struct mqueue_inode_s *msgq)
 
 	curr = (FAR struct mqueue_msg_s *)msgq->msglist.head;
 	while (curr) {
+#ifdef CONFIG_MQ_ZEROCOPY
+		/* Nobody received the buffer of a message of a zero-copy queue, the
+		 * queue owns it and frees it in the user heap, see mq_sendbuf().
+		 */
+
+		if (msgq->zerocopy) {
+			FAR void *buf;
+
+			memcpy(&buf, (FAR const void *)curr->mail, sizeof(buf));
+			sched_ufree(buf);
+		}
+#endif
+
 		/* Deallocate the message structure. */
 
 		next = curr->next;
-		mq_msgfree(curr);
+		mq_msgfree(msgq, curr);
 		curr = next;
 	}
 
+#ifdef CONFIG_MQ_MSGPOOL
+	/* The messages of the pool are freed with it */
+
+	if (msgq->msgpool) {
+		sched_kfree(msgq->msgpool);
+	}
+#endif
+
 	/* Then deallocate the message queue itself */
 
 	sched_kfree(msgq);
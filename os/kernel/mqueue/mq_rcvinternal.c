@@ -116,7 +116,7 @@
  *   EPERM    Message queue opened not opened for reading.
  *   EMSGSIZE 'msglen' was less than the maxmsgsize attribute of the message
  *            queue.
- *   EINVAL   Invalid 'msg' or 'mqdes'
+ *   EINVAL   Invalid 'msg' or 'mqdes', or a zero-copy message queue
  *
  * Assumptions:
  *
@@ -141,6 +141,15 @@ int mq_verifyreceive(mqd_t mqdes, FAR char *msg, size_t msglen)
 		return ERROR;
 	}
 
+#ifdef CONFIG_MQ_ZEROCOPY
+	/* The messages of a zero-copy queue are received with mq_receivebuf() */
+
+	if (mqdes->msgq->zerocopy) {
+		set_errno(EINVAL);
+		return ERROR;
+	}
+#endif
+
 	return OK;
 }
 
@@ -280,11 +289,21 @@ ssize_t mq_doreceive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR char *ubuf
 
 	/* Get the length of the message (also the return value) */
 
+	msgq = mqdes->msgq;
 	rcvmsglen = mqmsg->msglen;
 
-	/* Copy the message into the caller's buffer */
+	/* Copy the message into the caller's buffer.  The message of a zero-copy
+	 * queue is the address of the buffer, which is returned in ubuffer.
+	 */
 
-	memcpy(ubuffer, (const void *)mqmsg->mail, rcvmsglen);
+#ifdef CONFIG_MQ_ZEROCOPY
+	if (msgq->zerocopy) {
+		memcpy(ubuffer, (const void *)mqmsg->mail, sizeof(FAR void *));
+	} else
+#endif
+	{
+		memcpy(ubuffer, (const void *)mqmsg->mail, rcvmsglen);
+	}
 
 	/* Copy the message priority as well (if a buffer is provided) */
 
@@ -294,11 +313,10 @@ ssize_t mq_doreceive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR char *ubuf
 
 	/* We are done with the message.  Deallocate it now. */
 
-	mq_msgfree(mqmsg);
+	mq_msgfree(msgq, mqmsg);
 
 	/* Check if any tasks are waiting for the MQ not full event. */
 
-	msgq = mqdes->msgq;
 	if (msgq->nwaitnotfull > 0) {
 		/* Find the highest priority task that is waiting for
 		 * this queue to be not-full in g_waitingformqnotfull list.
@@ -0,0 +1,187 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/mqueue/mq_sendbuf.c
+ *
+ * The send of a zero-copy message queue, which passes the address of a
+ * buffer instead of copying the message.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <errno.h>
+#include <sched.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/cancelpt.h>
+#include <tinyara/mm/mm.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_ZEROCOPY
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mq_verifysendbuf
+ *
+ * Description:
+ *   Verify the parameters of mq_sendbuf(), as mq_verifysend() does for
+ *   mq_send().
+ *
+ * Return Value:
+ *   OK, or ERROR with errno set.
+ *
+ ****************************************************************************/
+
+static int mq_verifysendbuf(mqd_t mqdes, FAR void *buf, size_t buflen, int prio)
+{
+	if (!buf || !mqdes || prio < 0 || prio > MQ_PRIO_MAX) {
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	if ((mqdes->oflags & O_WROK) == 0) {
+		set_errno(EPERM);
+		return ERROR;
+	}
+
+	if (!mqdes->msgq->zerocopy) {
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	if (buflen > (size_t)mqdes->msgq->maxmsgsize) {
+		set_errno(EMSGSIZE);
+		return ERROR;
+	}
+
+	/* The queue frees a buffer nobody received in the user heap, so the
+	 * buffer must not come from anywhere else.
+	 */
+
+#if (defined(CONFIG_BUILD_PROTECTED) || defined(CONFIG_BUILD_KERNEL)) && \
+	 defined(CONFIG_MM_KERNEL_HEAP)
+	if (kmm_heapmember(buf)) {
+		set_errno(EFAULT);
+		return ERROR;
+	}
+#elif !defined(CONFIG_BUILD_PROTECTED) && !defined(CONFIG_BUILD_KERNEL)
+	if (mm_get_heapindex(buf) == INVALID_HEAP_IDX) {
+		set_errno(EFAULT);
+		return ERROR;
+	}
+#endif
+
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mq_sendbuf
+ *
+ * Description:
+ *   This function sends a buffer to a zero-copy message queue.  Only the
+ *   address of the buffer is queued, the ownership of the buffer goes to
+ *   the task which receives it with mq_receivebuf(), or to the queue
+ *   which frees it if it is destroyed first.  The sender must not use the
+ *   buffer any more once it is sent.
+ *
+ *   It blocks while the queue is full as mq_send() does.
+ *
+ * Parameters:
+ *   mqdes - Message queue descriptor
+ *   buf - The buffer to send
+ *   buflen - The length of the message in the buffer, at most the
+ *     mq_msgsize attribute of the queue
+ *   prio - The priority of the message
+ *
+ * Return Value:
+ *   On success, mq_sendbuf() returns 0 (OK); on error, -1 (ERROR)
+ *   is returned, with errno set to indicate the error:
+ *
+ *   EAGAIN   The queue was full, and the O_NONBLOCK flag was set for the
+ *            message queue description referred to by mqdes.
+ *   EINVAL   Either buf or mqdes is NULL, the value of prio is invalid or
+ *            the message queue isn't a zero-copy queue.
+ *   EPERM    Message queue opened not opened for writing.
+ *   EMSGSIZE 'buflen' was greater than the maxmsgsize attribute of the
+ *            message queue.
+ *   EFAULT   The buffer is not in the user heap.
+ *   EINTR    The call was interrupted by a signal handler.
+ *
+ * Assumptions/restrictions:
+ *   The buffer must be a block allocated with malloc() in the user heap,
+ *   as it may be freed by the receiver or by the queue.  Only the heap it
+ *   lies in is checked, not that it is the start of a block.
+ *
+ ****************************************************************************/
+
+int mq_sendbuf(mqd_t mqdes, FAR void *buf, size_t buflen, int prio)
+{
+	FAR struct mqueue_inode_s *msgq;
+	FAR struct mqueue_msg_s *mqmsg = NULL;
+	irqstate_t saved_state;
+	int ret = ERROR;
+
+	/* mq_sendbuf() is a cancellation point */
+
+	(void)enter_cancellation_point();
+
+	if (mq_verifysendbuf(mqdes, buf, buflen, prio) != OK) {
+		leave_cancellation_point();
+		return ERROR;
+	}
+
+	sched_lock();
+	msgq = mqdes->msgq;
+
+	/* Take a message of the queue once it isn't full, as mq_send() does */
+
+	saved_state = irqsave();
+	if (up_interrupt_context() || msgq->nmsgs < msgq->maxmsgs || mq_waitsend(mqdes) == OK) {
+		irqrestore(saved_state);
+		mqmsg = mq_msgalloc(msgq);
+	} else {
+		irqrestore(saved_state);
+	}
+
+	if (mqmsg) {
+		ret = mq_dosend(mqdes, mqmsg, (FAR const char *)buf, buflen, prio);
+	}
+
+	sched_unlock();
+	leave_cancellation_point();
+	return ret;
+}
+
+#endif							/* CONFIG_MQ_ZEROCOPY */
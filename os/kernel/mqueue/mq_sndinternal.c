@@ -118,7 +118,8 @@
  *   One success, 0 (OK) is returned. On failure, -1 (ERROR) is returned and
  *   the errno is set appropriately:
  *
- *   EINVAL   Either msg or mqdes is NULL or the value of prio is invalid.
+ *   EINVAL   Either msg or mqdes is NULL or the value of prio is invalid,
+ *            or the message queue is a zero-copy queue.
  *   EPERM    Message queue opened not opened for writing.
  *   EMSGSIZE 'msglen' was greater than the maxmsgsize attribute of the
  *             message queue.
@@ -146,6 +147,15 @@ int mq_verifysend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio)
 		return ERROR;
 	}
 
+#ifdef CONFIG_MQ_ZEROCOPY
+	/* The messages of a zero-copy queue are sent with mq_sendbuf() */
+
+	if (mqdes->msgq->zerocopy) {
+		set_errno(EINVAL);
+		return ERROR;
+	}
+#endif
+
 	return OK;
 }
 
@@ -154,8 +164,9 @@ int mq_verifysend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio)
  *
  * Description:
  *   The mq_msgalloc function will get a free message for use by the
- *   operating system.  The message will be allocated from the g_msgfree
- *   list.
+ *   operating system.  With CONFIG_MQ_MSGPOOL, the message is taken from
+ *   the pool of the message queue first.  Otherwise, or if the pool is
+ *   empty, the message will be allocated from the g_msgfree list.
  *
  *   If the list is empty AND the message is NOT being allocated from the
  *   interrupt level, then the message will be allocated.  If a message
@@ -167,19 +178,49 @@ int mq_verifysend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio)
  *   the g_msgfreeirq list.  If this is unsuccessful, the calling interrupt
  *   handler will be notified.
  *
+ *   The messages of the lists only hold MQ_MAX_BYTES bytes, a larger
+ *   message of a queue whose pool is empty is always allocated.
+ *
  * Inputs:
- *   None
+ *   msgq - The message queue the message is sent to
  *
  * Return Value:
- *   A reference to the allocated msg structure.  On a failure to allocate,
- *   this function PANICs.
+ *   A reference to the allocated msg structure, or NULL if none is left for
+ *   an interrupt handler.  On a failure to allocate, this function PANICs.
  *
  ****************************************************************************/
 
-FAR struct mqueue_msg_s *mq_msgalloc(void)
+FAR struct mqueue_msg_s *mq_msgalloc(FAR struct mqueue_inode_s *msgq)
 {
 	FAR struct mqueue_msg_s *mqmsg;
 	irqstate_t saved_state;
+#ifdef CONFIG_MQ_MSGPOOL
+	size_t msgbytes = MQ_MSGBYTES(msgq);
+
+	/* A task only sends to a queue which isn't full, so the pool of the queue
+	 * is only empty when interrupt handlers have sent beyond its limit or
+	 * while a received message hasn't been freed yet.
+	 */
+
+	saved_state = irqsave();
+	mqmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&msgq->msgfree);
+	irqrestore(saved_state);
+
+	if (mqmsg) {
+		return mqmsg;
+	}
+
+	if (msgbytes > MQ_MAX_BYTES) {
+		if (up_interrupt_context()) {
+			return NULL;
+		}
+
+		mqmsg = (FAR struct mqueue_msg_s *)kmm_malloc(MQ_POOL_MSGSIZE(msgbytes));
+		ASSERT(mqmsg);
+		mqmsg->type = MQ_ALLOC_DYN;
+		return mqmsg;
+	}
+#endif
 
 	/* If we were called from an interrupt handler, then try to get the message
 	 * from generally available list of messages. If this fails, then try the
@@ -366,9 +407,18 @@ int mq_dosend(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR const char *msg,
 	mqmsg->priority = prio;
 	mqmsg->msglen = msglen;
 
-	/* Copy the message data into the message */
+	/* Copy the message data into the message.  A zero-copy message only
+	 * holds the address of the buffer, whose ownership goes to the receiver.
+	 */
 
-	memcpy((void *)mqmsg->mail, (FAR const void *)msg, msglen);
+#ifdef CONFIG_MQ_ZEROCOPY
+	if (msgq->zerocopy) {
+		memcpy((void *)mqmsg->mail, (FAR const void *)&msg, sizeof(msg));
+	} else
+#endif
+	{
+		memcpy((void *)mqmsg->mail, (FAR const void *)msg, msglen);
+	}
 
 	/* Insert the new message in the message queue */
 
@@ -61,6 +61,7 @@
 #include <tinyara/compiler.h>
 
 #include <sys/types.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <limits.h>
@@ -99,7 +100,8 @@
 enum mqalloc_e {
 	MQ_ALLOC_FIXED = 0,			/* pre-allocated; never freed */
 	MQ_ALLOC_DYN,				/* dynamically allocated; free when unused */
-	MQ_ALLOC_IRQ				/* Preallocated, reserved for interrupt handling */
+	MQ_ALLOC_IRQ,				/* Preallocated, reserved for interrupt handling */
+	MQ_ALLOC_QUEUE				/* In the pool of its queue; freed with the queue */
 };
 
 /* This structure describes one buffered POSIX message. */
@@ -108,7 +110,7 @@ struct mqueue_msg_s {
 	FAR struct mqueue_msg_s *next;	/* Forward link to next message */
 	uint8_t type;					/* (Used to manage allocations) */
 	uint8_t priority;				/* priority of message */
-#if MQ_MAX_BYTES < 256
+#if MQ_MAX_BYTES < 256 && !defined(CONFIG_MQ_MSGPOOL)
 	uint8_t msglen;					/* Message data length */
 #else
 	uint16_t msglen;				/* Message data length */
@@ -116,6 +118,29 @@ struct mqueue_msg_s {
 	char mail[MQ_MAX_BYTES];		/* Message data */
 };
 
+#ifdef CONFIG_MQ_MSGPOOL
+/* The largest message of a queue with its own pool */
+
+#define MQ_POOL_MAX_BYTES UINT16_MAX
+
+/* The size of a message of the pool of a queue, with a payload of n
+ * bytes instead of MQ_MAX_BYTES.
+ */
+
+#define MQ_POOL_MSGSIZE(n) \
+	((offsetof(struct mqueue_msg_s, mail) + (n) + sizeof(uintptr_t) - 1) & ~(sizeof(uintptr_t) - 1))
+#endif
+
+/* The bytes of a message of a queue: the message, or the address of the
+ * buffer for a zero-copy queue.
+ */
+
+#ifdef CONFIG_MQ_ZEROCOPY
+#define MQ_MSGBYTES(q) ((q)->zerocopy ? sizeof(FAR void *) : (size_t)(q)->maxmsgsize)
+#else
+#define MQ_MSGBYTES(q) ((size_t)(q)->maxmsgsize)
+#endif
+
 /****************************************************************************
  * Public Variables
  ****************************************************************************/
@@ -156,7 +181,7 @@ void weak_function mq_initialize(void);
 void mq_desblockalloc(void);
 
 FAR struct mqueue_inode_s *mq_findnamed(FAR const char *mq_name);
-void mq_msgfree(FAR struct mqueue_msg_s *mqmsg);
+void mq_msgfree(FAR struct mqueue_inode_s *msgq, FAR struct mqueue_msg_s *mqmsg);
 
 /* mq_waitirq.c ************************************************************/
 
@@ -171,7 +196,7 @@ ssize_t mq_doreceive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR char *ubuf
 /* mq_sndinternal.c ********************************************************/
 
 int mq_verifysend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio);
-FAR struct mqueue_msg_s *mq_msgalloc(void);
+FAR struct mqueue_msg_s *mq_msgalloc(FAR struct mqueue_inode_s *msgq);
 int mq_waitsend(mqd_t mqdes);
 int mq_dosend(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR const char *msg, size_t msglen, int prio);
 
@@ -138,6 +138,24 @@ void pthread_mutex_inconsistent(FAR struct pthread_tcb_s *tcb);
 #define pthread_mutex_give(m)   pthread_sem_give(&(m)->sem)
 #endif
 
+/* With CONFIG_PTHREAD_MUTEX_FASTPATH, a mutex locked by the user space is
+ * taken over before the kernel looks at it, and a mutex given up by its
+ * holder to a waiter isn't free for the user space until the waiter runs.
+ */
+
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+void pthread_mutex_adopt(FAR struct pthread_mutex_s *mutex);
+#define pthread_mutex_handoff(m) \
+	do { \
+		if ((m)->pid == _PTHREAD_MPID_FREE && (m)->sem.semcount < 1) { \
+			(m)->pid = _PTHREAD_MPID_HANDOFF; \
+		} \
+	} while (0)
+#else
+#define pthread_mutex_adopt(m)
+#define pthread_mutex_handoff(m)
+#endif
+
 #if defined(CONFIG_CANCELLATION_POINTS) && !defined(CONFIG_PTHREAD_MUTEX_UNSAFE)
 uint16_t pthread_disable_cancel(void);
 void pthread_enable_cancel(uint16_t oldstate);
@@ -212,6 +212,12 @@ int pthread_cond_timedwait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex,
 	/* pthread_cond_timedwait() is a cancellation point */
 	(void)enter_cancellation_point();
 
+	/* A mutex the caller locked in the user space is held by its pid only
+	 * once taken over.
+	 */
+
+	pthread_mutex_adopt(mutex);
+
 	/* Make sure that non-NULL references were provided. */
 
 	if (!cond || !mutex) {
@@ -279,6 +285,7 @@ int pthread_cond_timedwait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex,
 
 					mutex->pid = -1;
 					ret = pthread_mutex_give(mutex);
+					pthread_mutex_handoff(mutex);
 					if (ret != 0) {
 						/* Restore interrupts  (pre-emption will be enabled when
 						 * we fall through the if/then/else)
@@ -96,6 +96,12 @@ int pthread_cond_wait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex)
 	/* pthread_cond_wait() is a cancellation point */
 	(void)enter_cancellation_point();
 
+	/* A mutex the caller locked in the user space is held by its pid only
+	 * once taken over.
+	 */
+
+	pthread_mutex_adopt(mutex);
+
 	/* Make sure that non-NULL references were provided. */
 
 	if (cond == NULL || mutex == NULL) {
@@ -116,6 +122,7 @@ int pthread_cond_wait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex)
 		sched_lock();
 		mutex->pid = -1;
 		ret = pthread_mutex_give(mutex);
+		pthread_mutex_handoff(mutex);
 
 		/* Take the semaphore */
 
@@ -265,7 +265,15 @@ int pthread_create(FAR pthread_t *thread, FAR const pthread_attr_t *attr, pthrea
 
 	/* Allocate a TCB for the new task. */
 
-	ptcb = (FAR struct pthread_tcb_s *)kmm_zalloc(sizeof(struct pthread_tcb_s));
+#ifdef CONFIG_TASK_POOL
+	/* From the pool first, with its stack */
+
+	ptcb = (FAR struct pthread_tcb_s *)sched_taskpool_alloc(TCB_FLAG_TTYPE_PTHREAD, attr->stacksize);
+	if (!ptcb)
+#endif
+	{
+		ptcb = (FAR struct pthread_tcb_s *)kmm_zalloc(sizeof(struct pthread_tcb_s));
+	}
 	if (!ptcb) {
 		sdbg("ERROR: Failed to allocate TCB\n");
 		return ENOMEM;
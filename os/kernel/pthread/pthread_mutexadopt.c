@@ -0,0 +1,120 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <pthread.h>
+#include <sched.h>
+#include <assert.h>
+
+#include <tinyara/irq.h>
+#include <tinyara/sched.h>
+
+#include "sched/sched.h"
+#include "semaphore/semaphore.h"
+#include "pthread/pthread.h"
+
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_mutex_adopt
+ *
+ * Description:
+ *   Take over a mutex locked by the fast path of the user space, which
+ *   holds it by the owner word of its holder and no count of the
+ *   semaphore.  The holder gets the count of the semaphore, is recorded as
+ *   its holder for priority inheritance and gets the mutex in its list of
+ *   mutexes held, as if it had locked the mutex with the system call.  It
+ *   then unlocks the mutex with the system call, as its owner word no
+ *   longer matches.  A holder which has exited leaves the mutex
+ *   inconsistent, as pthread_mutex_inconsistent() does, even if its pid
+ *   was given to another thread since: the owner word of that thread has
+ *   another generation of the pid.
+ *
+ * Parameters:
+ *   mutex - The mutex to be taken over if the user space holds it, or NULL
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller locks the scheduler if it looks at a mutex it doesn't hold,
+ *   so the user space doesn't run until the kernel is done with it.
+ *
+ ****************************************************************************/
+
+void pthread_mutex_adopt(FAR struct pthread_mutex_s *mutex)
+{
+	FAR struct tcb_s *htcb;
+	irqstate_t flags;
+	int owner;
+	int pid;
+
+	if (mutex == NULL) {
+		return;
+	}
+
+	/* The holder can't unlock the mutex while we take it over */
+
+	flags = irqsave();
+	owner = mutex->pid;
+	if (owner < 0 || (owner & _PTHREAD_MPID_FAST) == 0) {
+		irqrestore(flags);
+		return;
+	}
+
+	pid = owner & _PTHREAD_MPID_PIDMASK;
+	DEBUGASSERT(pid > 0 && mutex->sem.semcount == 1);
+
+	/* The thread with the pid now must be the one which locked the mutex */
+
+	htcb = sched_gettcb((pid_t)pid);
+	if (htcb != NULL && htcb->mowner == owner) {
+		mutex->sem.semcount = 0;
+		sem_addholder_tcb(htcb, &mutex->sem);
+#ifndef CONFIG_PTHREAD_MUTEX_UNSAFE
+		DEBUGASSERT(mutex->flink == NULL);
+		mutex->flink = ((FAR struct pthread_tcb_s *)htcb)->mhead;
+		((FAR struct pthread_tcb_s *)htcb)->mhead = mutex;
+#endif
+	} else {
+#ifndef CONFIG_PTHREAD_MUTEX_UNSAFE
+		mutex->flags |= _PTHREAD_MFLAGS_INCONSISTENT;
+#else
+		/* Nobody unlocks the mutex, as if the holder had locked it with
+		 * the system call.
+		 */
+
+		mutex->sem.semcount = 0;
+#endif
+	}
+
+	mutex->pid = pid;
+	irqrestore(flags);
+}
+
+#endif							/* CONFIG_PTHREAD_MUTEX_FASTPATH */
@@ -114,6 +114,7 @@ int pthread_mutex_consistent(FAR pthread_mutex_t *mutex)
 		/* Make sure the mutex is stable while we make the following checks. */
 
 		sched_lock();
+		pthread_mutex_adopt(mutex);
 
 		/* Is the mutex available? */
 
@@ -143,6 +144,7 @@ int pthread_mutex_consistent(FAR pthread_mutex_t *mutex)
 				 */
 
 				status = sem_reset((FAR sem_t *)&mutex->sem, 1);
+				pthread_mutex_handoff(mutex);
 				ret = (status != OK) ? get_errno() : OK;
 			}
 
@@ -124,6 +124,7 @@ int pthread_mutex_destroy(FAR pthread_mutex_t *mutex)
 		/* Make sure the semaphore is stable while we make the following checks */
 
 		sched_lock();
+		pthread_mutex_adopt(mutex);
 
 		/* Is the semaphore available? */
 
@@ -169,6 +170,7 @@ int pthread_mutex_destroy(FAR pthread_mutex_t *mutex)
 				 */
 
 				status = sem_reset((FAR sem_t *)&mutex->sem, 1);
+				pthread_mutex_handoff(mutex);
 				if (status < 0) {
 					ret = -status;
 				}
@@ -156,6 +156,7 @@ int pthread_mutex_lock(FAR pthread_mutex_t *mutex)
 		 */
 
 		sched_lock();
+		pthread_mutex_adopt(mutex);
 
 #ifdef CONFIG_PTHREAD_MUTEX_TYPES
 		/* All mutex types except for NORMAL (and DEFAULT) will return
@@ -136,6 +136,7 @@ int pthread_mutex_trylock(FAR pthread_mutex_t *mutex)
 		 */
 
 		sched_lock();
+		pthread_mutex_adopt(mutex);
 
 		/* Try to get the semaphore. */
 
@@ -159,6 +159,7 @@ int pthread_mutex_unlock(FAR pthread_mutex_t *mutex)
 	 * This all needs to be one atomic action.
 	 */
 	sched_lock();
+	pthread_mutex_adopt(mutex);
 
 	/* The unlock operation is only performed if the mutex is actually locked.
 	 * EPERM *must* be returned if the mutex type is PTHREAD_MUTEX_ERRORCHECK
@@ -244,6 +245,7 @@ int pthread_mutex_unlock(FAR pthread_mutex_t *mutex)
 				mutex->nlocks = 0;
 #endif
 				ret = pthread_mutex_give(mutex);
+				pthread_mutex_handoff(mutex);
 			}
 	}
 
@@ -127,6 +127,23 @@ struct tasklist_s {
 	bool prioritized;			/* true if the list is prioritized */
 };
 
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+/* This structure indexes a prioritized task list by priority.  The bit of
+ * a priority is set when the list holds tasks of that priority, and tail[]
+ * is then the last of them.  Priority p is bit (31 - p % 32) of
+ * bitmap[p / 32], so that counting the leading zeros of a word finds the
+ * lowest priority present at or above p.
+ */
+
+#define SCHED_PRIOBITMAP_WORDS ((SCHED_PRIORITY_MAX >> 5) + 1)
+#define SCHED_PRIOBIT(prio)    (0x80000000 >> ((prio) & 31))
+
+struct sched_prioindex_s {
+	uint32_t bitmap[SCHED_PRIOBITMAP_WORDS];	/* Priorities in the list */
+	FAR struct tcb_s *tail[SCHED_PRIORITY_MAX + 1];	/* Last task of each priority */
+};
+#endif
+
 /****************************************************************************
  * Global Variables
  ****************************************************************************/
@@ -156,6 +173,13 @@ extern volatile dq_queue_t g_readytorun;
 
 extern volatile dq_queue_t g_pendingtasks;
 
+/* The indexes of the g_readytorun and g_pendingtasks lists by priority */
+
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+extern struct sched_prioindex_s g_readytorun_index;
+extern struct sched_prioindex_s g_pendingtasks_index;
+#endif
+
 /* This is the list of all tasks that are blocked waiting for a semaphore */
 
 extern volatile dq_queue_t g_waitingforsemaphore;
@@ -217,6 +241,16 @@ extern volatile sq_queue_t g_delayed_kfree;
 
 extern volatile pid_t g_lastpid;
 
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+/* The number of times g_lastpid wrapped around */
+
+extern volatile uint16_t g_pidgen;
+
+/* The word of the user space getting the owner word of the running thread */
+
+extern FAR volatile int *g_curowner;
+#endif
+
 /* The following hash table is used for two things:
  *
  * 1. This hash table greatly speeds the determination of a new unique
@@ -252,6 +286,17 @@ extern volatile uint32_t g_cpuload_total[SCHED_NCPULOAD];
 bool sched_addreadytorun(FAR struct tcb_s *rtrtcb);
 bool sched_removereadytorun(FAR struct tcb_s *rtrtcb);
 bool sched_addprioritized(FAR struct tcb_s *newTcb, DSEG dq_queue_t *list);
+
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+#define sched_prioindex(list) \
+	((list) == (FAR dq_queue_t *)&g_readytorun ? &g_readytorun_index : \
+	 (list) == (FAR dq_queue_t *)&g_pendingtasks ? &g_pendingtasks_index : NULL)
+
+void sched_removeprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list);
+#else
+#define sched_removeprioritized(tcb, list) \
+		dq_rem((FAR dq_entry_t *)(tcb), (list))
+#endif
 bool sched_mergepending(void);
 void sched_addblocked(FAR struct tcb_s *btcb, tstate_t task_state);
 void sched_removeblocked(FAR struct tcb_s *btcb);
@@ -278,6 +323,57 @@ void sched_timer_reassess(void);
 void weak_function sched_process_cpuload(void);
 #endif
 
+/* The pool of TCBs and stacks, see sched_taskpool.c */
+
+#ifdef CONFIG_TASK_POOL
+void sched_taskpool_initialize(void);
+FAR struct tcb_s *sched_taskpool_alloc(uint8_t ttype, size_t stack_size);
+bool sched_taskpool_member(FAR struct tcb_s *tcb);
+void sched_taskpool_free(FAR struct tcb_s *tcb);
+#else
+#define sched_taskpool_member(tcb) (false)
+#endif
+
+/* The hooks of the scheduling statistics, see sched_stats.c */
+
+#ifdef CONFIG_SCHED_STATS
+void sched_stats_initialize(void);
+void sched_stats_switch(FAR struct tcb_s *from, FAR struct tcb_s *to);
+void sched_stats_wakeup(FAR struct tcb_s *tcb);
+void sched_stats_lock(FAR struct tcb_s *tcb);
+void sched_stats_unlock(FAR struct tcb_s *tcb);
+#define sched_stats_boost(tcb) ((tcb)->stats.nboost++)
+#else
+#define sched_stats_switch(from, to)
+#define sched_stats_wakeup(tcb)
+#define sched_stats_lock(tcb)
+#define sched_stats_unlock(tcb)
+#define sched_stats_boost(tcb)
+#endif
+
+/* The hook of a context switch, called by the architecture with the TCB
+ * giving up the CPU (NULL if it exited) and the one getting it.  With
+ * CONFIG_PTHREAD_MUTEX_FASTPATH, the owner word of the thread getting the
+ * CPU is published to the user space.
+ */
+
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+#define sched_publishowner(tcb) \
+	do { \
+		if (g_curowner != NULL) { \
+			*g_curowner = (tcb)->mowner; \
+		} \
+	} while (0)
+#else
+#define sched_publishowner(tcb)
+#endif
+
+#define sched_switch_hook(from, to) \
+	do { \
+		sched_stats_switch(from, to); \
+		sched_publishowner(to); \
+	} while (0)
+
 bool sched_verifytcb(FAR struct tcb_s *tcb);
 int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype);
 
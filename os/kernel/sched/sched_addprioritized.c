@@ -83,6 +83,44 @@
  * Private Function Prototypes
  ************************************************************************/
 
+/************************************************************************
+ * Private Functions
+ ************************************************************************/
+
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+/************************************************************************
+ * Name: sched_nextprio
+ *
+ * Description:
+ *  Find the lowest priority at or above sched_priority which has tasks
+ *  in an indexed list.
+ *
+ * Inputs:
+ *   index - The index of the list
+ *   sched_priority - The priority to start from
+ *
+ * Return Value:
+ *   The priority found, or -1 if the list has no task of sched_priority
+ *   or higher.
+ *
+ ************************************************************************/
+
+static int sched_nextprio(FAR struct sched_prioindex_s *index, uint8_t sched_priority)
+{
+	int word = sched_priority >> 5;
+	uint32_t bits = index->bitmap[word] & (0xffffffff >> (sched_priority & 31));
+
+	while (bits == 0) {
+		if (++word >= SCHED_PRIOBITMAP_WORDS) {
+			return -1;
+		}
+		bits = index->bitmap[word];
+	}
+
+	return (word << 5) + __builtin_clz(bits);
+}
+#endif
+
 /************************************************************************
  * Public Functions
  ************************************************************************/
@@ -100,6 +138,10 @@
  * Return Value:
  *   true if the head of the list has changed.
  *
+ *   The g_readytorun and g_pendingtasks lists are indexed with
+ *   CONFIG_SCHED_PRIORITY_BITMAP, which finds the spot without walking
+ *   the list.
+ *
  * Assumptions:
  * - The caller has established a critical section before
  *   calling this function (calling sched_lock() first is NOT
@@ -118,16 +160,40 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
 	FAR struct tcb_s *prev;
 	uint8_t sched_priority = tcb->sched_priority;
 	bool ret = false;
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+	FAR struct sched_prioindex_s *index = sched_prioindex(list);
+	int prio;
+#endif
 
 	/* Lets do a sanity check before we get started. */
 
 	ASSERT(sched_priority >= SCHED_PRIORITY_MIN);
 
-	/* Search the list to find the location to insert the new Tcb.
-	 * Each is list is maintained in ascending sched_priority order.
-	 */
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+	if (index) {
+		/* The new Tcb goes after the last one of the lowest priority at or
+		 * above its own, or at the head if there is none.  It is then the
+		 * last Tcb of its priority.
+		 */
+
+		prio = sched_nextprio(index, sched_priority);
+		if (prio < 0) {
+			next = (FAR struct tcb_s *)list->head;
+		} else {
+			next = index->tail[prio]->flink;
+		}
+
+		index->bitmap[sched_priority >> 5] |= SCHED_PRIOBIT(sched_priority);
+		index->tail[sched_priority] = tcb;
+	} else
+#endif
+	{
+		/* Search the list to find the location to insert the new Tcb.
+		 * Each is list is maintained in ascending sched_priority order.
+		 */
 
-	for (next = (FAR struct tcb_s *)list->head; (next && sched_priority <= next->sched_priority); next = next->flink) ;
+		for (next = (FAR struct tcb_s *)list->head; (next && sched_priority <= next->sched_priority); next = next->flink) ;
+	}
 
 	/* Add the tcb to the spot found in the list.  Check if the tcb
 	 * goes at the end of the list. NOTE:  This could only happen if list
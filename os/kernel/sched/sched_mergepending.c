@@ -57,6 +57,7 @@
 #include <tinyara/config.h>
 
 #include <stdbool.h>
+#include <string.h>
 #include <sched.h>
 #include <queue.h>
 #include <assert.h>
@@ -114,9 +115,37 @@ bool sched_mergepending(void)
 	FAR struct tcb_s *pndtcb;
 	FAR struct tcb_s *pndnext;
 	FAR struct tcb_s *rtrtcb;
+#ifndef CONFIG_SCHED_PRIORITY_BITMAP
 	FAR struct tcb_s *rtrprev;
+#endif
 	bool ret = false;
 
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+	/* Each pndtcb goes after the ready-to-run tasks of its priority and
+	 * above, which the index finds without searching.
+	 */
+
+	for (pndtcb = (FAR struct tcb_s *)g_pendingtasks.head; pndtcb; pndtcb = pndnext) {
+		pndnext = pndtcb->flink;
+		rtrtcb = this_task();
+
+		if (sched_addprioritized(pndtcb, (FAR dq_queue_t *)&g_readytorun)) {
+			rtrtcb->task_state = TSTATE_TASK_READYTORUN;
+			pndtcb->task_state = TSTATE_TASK_RUNNING;
+			ret = true;
+		} else {
+			pndtcb->task_state = TSTATE_TASK_READYTORUN;
+		}
+	}
+
+	/* Mark the input list and its index empty */
+
+	g_pendingtasks.head = NULL;
+	g_pendingtasks.tail = NULL;
+	memset(g_pendingtasks_index.bitmap, 0, sizeof(g_pendingtasks_index.bitmap));
+
+	return ret;
+#else
 	/* Initialize the inner search loop */
 
 	rtrtcb = this_task();
@@ -176,4 +205,5 @@ bool sched_mergepending(void)
 	g_pendingtasks.tail = NULL;
 
 	return ret;
+#endif
 }
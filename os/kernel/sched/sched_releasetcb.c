@@ -195,9 +195,11 @@ int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype)
 			sched_releasepid(tcb->pid);
 		}
 
-		/* Delete the thread's stack if one has been allocated */
+		/* Delete the thread's stack if one has been allocated, unless it
+		 * is the stack of a TCB of the pool, which stays with the TCB.
+		 */
 
-		if (tcb->stack_alloc_ptr) {
+		if (tcb->stack_alloc_ptr && !sched_taskpool_member(tcb)) {
 #ifdef CONFIG_BUILD_KERNEL
 			/* If the exiting thread is not a kernel thread, then it has an
 			 * address environment.  Don't bother to release the stack memory
@@ -247,7 +249,14 @@ int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype)
 
 		/* And, finally, release the TCB itself */
 
-		sched_kfree(tcb);
+#ifdef CONFIG_TASK_POOL
+		if (sched_taskpool_member(tcb)) {
+			sched_taskpool_free(tcb);
+		} else
+#endif
+		{
+			sched_kfree(tcb);
+		}
 	}
 
 	return ret;
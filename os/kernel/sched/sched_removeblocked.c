@@ -123,4 +123,8 @@ void sched_removeblocked(FAR struct tcb_s *btcb)
 	 */
 
 	btcb->task_state = TSTATE_TASK_INVALID;
+
+	/* Its wake-up latency starts now */
+
+	sched_stats_wakeup(btcb);
 }
@@ -0,0 +1,80 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/************************************************************************
+ * kernel/sched/sched_removeprioritized.c
+ ************************************************************************/
+
+/************************************************************************
+ * Included Files
+ ************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <queue.h>
+
+#include "sched/sched.h"
+
+/************************************************************************
+ * Public Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name: sched_removeprioritized
+ *
+ * Description:
+ *  This function removes a TCB from a prioritized TCB list, keeping the
+ *  index of the g_readytorun and g_pendingtasks lists up to date.
+ *  Without CONFIG_SCHED_PRIORITY_BITMAP it is dq_rem().
+ *
+ * Inputs:
+ *   tcb - Points to the TCB to remove from the prioritized list
+ *   list - Points to the prioritized list holding tcb
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ * - The caller has established a critical section before
+ *   calling this function.
+ * - tcb->sched_priority is the priority tcb was added to the list
+ *   with.
+ ************************************************************************/
+
+void sched_removeprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
+{
+	FAR struct sched_prioindex_s *index = sched_prioindex(list);
+	FAR struct tcb_s *prev = (FAR struct tcb_s *)tcb->blink;
+	uint8_t sched_priority = tcb->sched_priority;
+
+	/* If tcb was the last of its priority, the one before it takes its
+	 * place, unless there is no other of that priority.  The IDLE task
+	 * isn't in the index.
+	 */
+
+	if (index && index->tail[sched_priority] == tcb) {
+		if (prev && prev->sched_priority == sched_priority) {
+			index->tail[sched_priority] = prev;
+		} else {
+			index->tail[sched_priority] = NULL;
+			index->bitmap[sched_priority >> 5] &= ~SCHED_PRIOBIT(sched_priority);
+		}
+	}
+
+	dq_rem((FAR dq_entry_t *)tcb, list);
+}
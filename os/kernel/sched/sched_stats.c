@@ -0,0 +1,272 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/sched/sched_stats.c
+ *
+ * The scheduling statistics of each thread with CONFIG_SCHED_STATS,
+ * reported in /proc/<pid>/schedstat.  They are updated by hooks in the
+ * context switches of the architecture, the wake-ups, sched_lock() and
+ * sched_unlock(), the priority inheritance and, with
+ * CONFIG_SCHED_STATS_IRQOFF, irqsave() and irqrestore().
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/clock.h>
+#include <tinyara/sched.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_STATS
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_STATS_IRQOFF
+/* The time interrupts were disabled, zero while they are enabled.  They are
+ * only measured once sched_stats_initialize() has been called.
+ */
+
+static uint64_t g_irqofftime;
+static bool g_irqoffstats;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline uint32_t sched_stats_elapsed(uint64_t start, uint64_t now)
+{
+	uint64_t elapsed = now - start;
+
+	return elapsed > UINT32_MAX ? UINT32_MAX : (uint32_t)elapsed;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_stats_clock
+ *
+ * Description:
+ *   Return the time of the scheduling statistics in nanoseconds.  With
+ *   CONFIG_SCHED_TICKLESS, it is the time of the free-running timer of
+ *   up_timer_gettime().  Otherwise, it only counts the system ticks, and
+ *   the times shorter than a tick are mostly counted as zero.
+ *
+ ****************************************************************************/
+
+uint64_t sched_stats_clock(void)
+{
+#ifdef CONFIG_SCHED_TICKLESS
+	struct timespec ts;
+
+	(void)up_timer_gettime(&ts);
+	return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+#else
+	return (uint64_t)clock_systimer() * NSEC_PER_TICK;
+#endif
+}
+
+/****************************************************************************
+ * Name: sched_stats_initialize
+ *
+ * Description:
+ *   Start the statistics once up_initialize() has started the timer.
+ *
+ ****************************************************************************/
+
+void sched_stats_initialize(void)
+{
+	this_task()->stats.switchtime = sched_stats_clock();
+#ifdef CONFIG_SCHED_STATS_IRQOFF
+	g_irqoffstats = true;
+#endif
+}
+
+/****************************************************************************
+ * Name: sched_stats_switch
+ *
+ * Description:
+ *   Account a context switch, called by sched_switch_hook() right before
+ *   the architecture restores the context of the new running thread.
+ *
+ * Parameters:
+ *   from - The thread which was running, or NULL if it has exited
+ *   to - The thread at the head of the ready-to-run list
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void sched_stats_switch(FAR struct tcb_s *from, FAR struct tcb_s *to)
+{
+	FAR struct sched_stats_s *stats;
+	uint64_t now = sched_stats_clock();
+	uint32_t latency;
+	uint32_t usec;
+	int bucket;
+
+	/* A thread still ready to run was preempted or yielded the CPU, any
+	 * other has blocked.
+	 */
+
+	if (from) {
+		stats = &from->stats;
+		stats->runtime += now - stats->switchtime;
+		if (from->task_state == TSTATE_TASK_READYTORUN || from->task_state == TSTATE_TASK_PENDING) {
+			stats->nivcsw++;
+		} else {
+			stats->nvcsw++;
+		}
+	}
+
+	stats = &to->stats;
+	stats->switchtime = now;
+
+	if (stats->waking) {
+		stats->waking = 0;
+		latency = sched_stats_elapsed(stats->readytime, now);
+		if (latency > stats->maxlatency) {
+			stats->maxlatency = latency;
+		}
+
+		usec = latency / NSEC_PER_USEC;
+		bucket = usec == 0 ? 0 : 32 - __builtin_clz(usec);
+		if (bucket >= SCHED_STATS_NHIST) {
+			bucket = SCHED_STATS_NHIST - 1;
+		}
+		stats->latency[bucket]++;
+	}
+}
+
+/****************************************************************************
+ * Name: sched_stats_wakeup
+ *
+ * Description:
+ *   Record the time a thread is taken out of a blocked list, from which
+ *   its wake-up latency is measured.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void sched_stats_wakeup(FAR struct tcb_s *tcb)
+{
+	tcb->stats.readytime = sched_stats_clock();
+	tcb->stats.waking = 1;
+}
+
+/****************************************************************************
+ * Name: sched_stats_lock
+ *
+ * Description:
+ *   Record the time the outer sched_lock() of a thread disables preemption.
+ *
+ ****************************************************************************/
+
+void sched_stats_lock(FAR struct tcb_s *tcb)
+{
+	tcb->stats.locktime = sched_stats_clock();
+}
+
+/****************************************************************************
+ * Name: sched_stats_unlock
+ *
+ * Description:
+ *   Account the sched_lock() section of a thread, when the outer
+ *   sched_unlock() enables preemption again.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void sched_stats_unlock(FAR struct tcb_s *tcb)
+{
+	uint32_t elapsed = sched_stats_elapsed(tcb->stats.locktime, sched_stats_clock());
+
+	if (elapsed > tcb->stats.maxlock) {
+		tcb->stats.maxlock = elapsed;
+	}
+}
+
+#ifdef CONFIG_SCHED_STATS_IRQOFF
+/****************************************************************************
+ * Name: sched_stats_irqoff
+ *
+ * Description:
+ *   Called by irqsave() when it disables the interrupts.
+ *
+ ****************************************************************************/
+
+void sched_stats_irqoff(void)
+{
+	if (g_irqoffstats) {
+		g_irqofftime = sched_stats_clock();
+	}
+}
+
+/****************************************************************************
+ * Name: sched_stats_irqon
+ *
+ * Description:
+ *   Called by irqrestore() right before it enables the interrupts again.
+ *   The section is charged to the running thread, which may not be the
+ *   one which disabled the interrupts if a context switch took place in
+ *   between.  The sections in interrupt handlers are not charged.
+ *
+ ****************************************************************************/
+
+void sched_stats_irqon(void)
+{
+	FAR struct tcb_s *rtcb;
+	uint32_t elapsed;
+
+	if (g_irqofftime == 0) {
+		return;
+	}
+
+	elapsed = sched_stats_elapsed(g_irqofftime, sched_stats_clock());
+	g_irqofftime = 0;
+
+	rtcb = this_task();
+	if (!up_interrupt_context() && elapsed > rtcb->stats.maxirqoff) {
+		rtcb->stats.maxirqoff = elapsed;
+	}
+}
+#endif
+
+#endif							/* CONFIG_SCHED_STATS */
@@ -0,0 +1,269 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/sched/sched_taskpool.c
+ *
+ * The pool of TCBs and stacks of CONFIG_TASK_POOL.  The TCBs and the stacks
+ * of three size classes are allocated once, at boot, and task_create(),
+ * kernel_thread() and pthread_create() take one of the smallest class large
+ * enough for the stack asked for, before falling back to the heap.
+ * sched_releasetcb() gives it back to the pool, at once and without the
+ * heap, even where a free would be deferred to sched_garbage.c.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/sched.h>
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+#include <tinyara/mm/mm.h>
+#endif
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_TASK_POOL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#undef HAVE_KERNEL_HEAP
+#if defined(CONFIG_BUILD_PROTECTED) && defined(CONFIG_MM_KERNEL_HEAP)
+#define HAVE_KERNEL_HEAP 1
+#endif
+
+#define TASK_POOL_NCLASSES 3
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A TCB of any type and its stack.  The TCB is first, for the address of
+ * the slot to be the address of the TCB.
+ */
+
+struct task_pool_slot_s {
+	union {
+		struct tcb_s cmn;
+		struct task_tcb_s task;
+#ifndef CONFIG_DISABLE_PTHREAD
+		struct pthread_tcb_s pthread;
+#endif
+	} tcb;
+	FAR struct task_pool_slot_s *flink;
+	FAR uint32_t *stack;
+	uint8_t class;
+};
+
+struct task_pool_class_s {
+	size_t stacksize;
+	int nslots;
+	FAR struct task_pool_slot_s *freelist;
+};
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+
+static struct task_pool_class_s g_task_pool[TASK_POOL_NCLASSES] = {
+	{CONFIG_TASK_POOL_SMALL_STACKSIZE, CONFIG_TASK_POOL_SMALL_NSLOTS, NULL},
+	{CONFIG_TASK_POOL_MEDIUM_STACKSIZE, CONFIG_TASK_POOL_MEDIUM_NSLOTS, NULL},
+	{CONFIG_TASK_POOL_LARGE_STACKSIZE, CONFIG_TASK_POOL_LARGE_NSLOTS, NULL},
+};
+
+/* All the slots, in one allocation */
+
+static FAR struct task_pool_slot_s *g_task_pool_slots;
+static int g_task_pool_nslots;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_taskpool_initialize
+ *
+ * Description:
+ *   Allocate the TCBs and the stacks of the pool.  Called once at boot,
+ *   after the heaps are initialized, so that they are at the start of the
+ *   heaps and never fragment them.  A class whose stacks can't all be
+ *   allocated keeps the ones that could be.
+ *
+ ****************************************************************************/
+
+void sched_taskpool_initialize(void)
+{
+	FAR struct task_pool_slot_s *slot;
+	int nslots = 0;
+	int i;
+	int j;
+
+	for (i = 0; i < TASK_POOL_NCLASSES; i++) {
+		nslots += g_task_pool[i].nslots;
+	}
+
+	if (nslots == 0) {
+		return;
+	}
+
+	g_task_pool_slots = (FAR struct task_pool_slot_s *)kmm_malloc(nslots * sizeof(struct task_pool_slot_s));
+	if (!g_task_pool_slots) {
+		sdbg("ERROR: Failed to allocate %d TCBs\n", nslots);
+		return;
+	}
+	g_task_pool_nslots = nslots;
+
+	/* Each stack is a heap allocation of its own, like the stacks of
+	 * up_create_stack(), for the heap information to find its node.
+	 */
+
+	slot = g_task_pool_slots;
+	for (i = 0; i < TASK_POOL_NCLASSES; i++) {
+		for (j = 0; j < g_task_pool[i].nslots; j++, slot++) {
+			slot->class = i;
+			slot->stack = (FAR uint32_t *)kumm_malloc(g_task_pool[i].stacksize);
+			if (!slot->stack) {
+				sdbg("ERROR: Failed to allocate a stack of %lu bytes\n", (unsigned long)g_task_pool[i].stacksize);
+				continue;
+			}
+
+			slot->flink = g_task_pool[i].freelist;
+			g_task_pool[i].freelist = slot;
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: sched_taskpool_alloc
+ *
+ * Description:
+ *   Take a TCB of the pool, with a stack of the smallest class of at least
+ *   stack_size bytes which has a free slot.
+ *
+ * Input Parameters:
+ *   ttype      - The type of the new thread
+ *   stack_size - The size of the stack of the new thread
+ *
+ * Returned Value:
+ *   A zeroed TCB whose stack_alloc_ptr is the stack of the slot and whose
+ *   adj_stack_size is stack_size, so that up_create_stack() of stack_size
+ *   keeps it; or NULL if no slot is free, for the caller to allocate a TCB
+ *   and a stack from the heap.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *sched_taskpool_alloc(uint8_t ttype, size_t stack_size)
+{
+	FAR struct task_pool_class_s *class = NULL;
+	FAR struct task_pool_slot_s *slot;
+	irqstate_t flags;
+	int i;
+
+#ifdef HAVE_KERNEL_HEAP
+	/* The stacks of kernel threads are in the kernel heap */
+
+	if (ttype == TCB_FLAG_TTYPE_KERNEL) {
+		return NULL;
+	}
+#endif
+
+	flags = irqsave();
+
+	for (i = 0; i < TASK_POOL_NCLASSES; i++) {
+		if (g_task_pool[i].freelist && g_task_pool[i].stacksize >= stack_size && (!class || g_task_pool[i].stacksize < class->stacksize)) {
+			class = &g_task_pool[i];
+		}
+	}
+
+	if (!class) {
+		irqrestore(flags);
+		return NULL;
+	}
+
+	slot = class->freelist;
+	class->freelist = slot->flink;
+
+	irqrestore(flags);
+
+	memset(&slot->tcb, 0, sizeof(slot->tcb));
+	slot->tcb.cmn.stack_alloc_ptr = slot->stack;
+	slot->tcb.cmn.adj_stack_size = stack_size;
+
+	return &slot->tcb.cmn;
+}
+
+/****************************************************************************
+ * Name: sched_taskpool_member
+ *
+ * Description:
+ *   Tell whether tcb is a TCB of the pool.
+ *
+ ****************************************************************************/
+
+bool sched_taskpool_member(FAR struct tcb_s *tcb)
+{
+	FAR struct task_pool_slot_s *slot = (FAR struct task_pool_slot_s *)tcb;
+
+	return slot >= g_task_pool_slots && slot < g_task_pool_slots + g_task_pool_nslots;
+}
+
+/****************************************************************************
+ * Name: sched_taskpool_free
+ *
+ * Description:
+ *   Give a TCB of the pool and its stack back to the pool.
+ *
+ * Assumptions:
+ *   sched_taskpool_member(tcb) is true.  May be called with interrupts
+ *   disabled.
+ *
+ ****************************************************************************/
+
+void sched_taskpool_free(FAR struct tcb_s *tcb)
+{
+	FAR struct task_pool_slot_s *slot = (FAR struct task_pool_slot_s *)tcb;
+	FAR struct task_pool_class_s *class = &g_task_pool[slot->class];
+	irqstate_t flags;
+
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+	/* The stack is the idle task's again, which allocated it */
+
+	struct mm_allocnode_s *node;
+
+	node = (struct mm_allocnode_s *)((FAR char *)slot->stack - SIZEOF_MM_ALLOCNODE);
+	node->pid = 0;
+#endif
+
+	flags = irqsave();
+	slot->flink = class->freelist;
+	class->freelist = slot;
+	irqrestore(flags);
+}
+
+#endif							/* CONFIG_TASK_POOL */
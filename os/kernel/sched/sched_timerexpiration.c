@@ -69,6 +69,9 @@
 #include "sched/sched.h"
 #include "wdog/wdog.h"
 #include "clock/clock.h"
+#ifdef CONFIG_HRTIMER
+#include "hrtimer/hrtimer.h"
+#endif
 
 #ifdef CONFIG_SCHED_TICKLESS
 
@@ -129,9 +132,19 @@ uint32_t g_oneshot_maxticks = UINT32_MAX;
  * that just expired.  The value zero means that no timer was active.
  */
 
+#ifdef CONFIG_HRTIMER
+/* With CONFIG_HRTIMER, the interval timer or alarm may expire between two
+ * ticks for a high resolution timer, so the ticks that have elapsed are
+ * counted from the time instead.  This is the hrtimer_gettime() time of
+ * the last tick processed.
+ */
+
+static uint64_t g_timer_base;
+#else
 static unsigned int g_timer_interval;
+#endif
 
-#ifdef CONFIG_SCHED_TICKLESS_ALARM
+#if defined(CONFIG_SCHED_TICKLESS_ALARM) && !defined(CONFIG_HRTIMER)
 /* This is the time that the timer was stopped.  All future times are
  * calculated against this time.  It must be valid at all times when
  * the timer is not running.
@@ -158,7 +171,7 @@ static struct timespec g_stop_time;
  *
  ************************************************************************/
 
-#ifdef CONFIG_SCHED_TICKLESS_ALARM
+#if defined(CONFIG_SCHED_TICKLESS_ALARM) && !defined(CONFIG_HRTIMER)
 static void sched_timespec_add(FAR const struct timespec *ts1, FAR const struct timespec *ts2, FAR struct timespec *ts3)
 {
 	time_t sec = ts1->tv_sec + ts2->tv_sec;
@@ -190,7 +203,7 @@ static void sched_timespec_add(FAR const struct timespec *ts1, FAR const struct
  *
  ************************************************************************/
 
-#ifdef CONFIG_SCHED_TICKLESS_ALARM
+#if defined(CONFIG_SCHED_TICKLESS_ALARM) && !defined(CONFIG_HRTIMER)
 static void sched_timespec_subtract(FAR const struct timespec *ts1, FAR const struct timespec *ts2, FAR struct timespec *ts3)
 {
 	time_t sec;
@@ -386,6 +399,14 @@ static unsigned int sched_timer_process(unsigned int ticks, bool noswitches)
 #endif
 		rettime = tmp;
 	}
+
+#ifdef CONFIG_HRTIMER
+	/* Process high resolution timers.  sched_timer_start() takes the next
+	 * one into account.
+	 */
+
+	hrtimer_process();
+#endif
 #if CONFIG_RR_INTERVAL > 0
 	/* Check if the currently executing task has exceeded its
 	 * timeslice.
@@ -400,11 +421,31 @@ static unsigned int sched_timer_process(unsigned int ticks, bool noswitches)
 	return rettime;
 }
 
+/****************************************************************************
+ * Name:  sched_timer_elapsed
+ *
+ * Description:
+ *   Return the number of ticks that have elapsed since the last tick
+ *   processed, which then becomes the last of them.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static unsigned int sched_timer_elapsed(void)
+{
+	uint64_t elapsed = (hrtimer_gettime() - g_timer_base) / NSEC_PER_TICK;
+
+	g_timer_base += elapsed * NSEC_PER_TICK;
+	return (unsigned int)elapsed;
+}
+#endif
+
 /****************************************************************************
  * Name:  sched_timer_start
  *
  * Description:
- *   Start the interval timer.
+ *   Start the interval timer.  With CONFIG_HRTIMER, it expires at the
+ *   first of that number of ticks and the next high resolution timer.
  *
  * Input Parameters:
  *   ticks - The number of ticks defining the timer interval to setup.
@@ -414,6 +455,51 @@ static unsigned int sched_timer_process(unsigned int ticks, bool noswitches)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_HRTIMER
+static void sched_timer_start(unsigned int ticks)
+{
+	struct timespec ts;
+	uint64_t deadline = 0;
+	uint64_t next;
+	int ret;
+
+	if (ticks > 0) {
+		deadline = g_timer_base + (uint64_t)ticks * NSEC_PER_TICK;
+	}
+
+	next = hrtimer_next();
+	if (next > 0 && (deadline == 0 || next < deadline)) {
+		deadline = next;
+	}
+
+	if (deadline == 0) {
+		return;
+	}
+
+#ifdef CONFIG_SCHED_TICKLESS_LIMIT_MAX_SLEEP
+	deadline = MIN(deadline, g_timer_base + (uint64_t)g_oneshot_maxticks * NSEC_PER_TICK);
+#endif
+
+#ifdef CONFIG_SCHED_TICKLESS_ALARM
+	/* The alarm may be set to a time which has passed */
+
+	ts.tv_sec = (time_t)(deadline / NSEC_PER_SEC);
+	ts.tv_nsec = (long)(deadline % NSEC_PER_SEC);
+	ret = up_alarm_start(&ts);
+#else
+	next = hrtimer_gettime();
+	deadline = deadline > next ? deadline - next : 1;
+
+	ts.tv_sec = (time_t)(deadline / NSEC_PER_SEC);
+	ts.tv_nsec = (long)(deadline % NSEC_PER_SEC);
+	ret = up_timer_start(&ts);
+#endif
+
+	if (ret < 0) {
+		slldbg("ERROR: up_timer_start/up_alarm_start failed: %d\n", ret);
+	}
+}
+#else
 static void sched_timer_start(unsigned int ticks)
 {
 #ifdef CONFIG_HAVE_LONG_LONG
@@ -480,6 +566,7 @@ static void sched_timer_start(unsigned int ticks)
 		}
 	}
 }
+#endif
 
 /************************************************************************
  * Public Functions
@@ -513,6 +600,11 @@ void sched_alarm_expiration(FAR const struct timespec *ts)
 
 	DEBUGASSERT(ts);
 
+#ifdef CONFIG_HRTIMER
+	/* Get the ticks elapsed up to now */
+
+	elapsed = sched_timer_elapsed();
+#else
 	/* Save the time that the alarm occurred */
 
 	g_stop_time.tv_sec = ts->tv_sec;
@@ -522,6 +614,7 @@ void sched_alarm_expiration(FAR const struct timespec *ts)
 
 	elapsed = g_timer_interval;
 	g_timer_interval = 0;
+#endif
 
 	/* Process the timer ticks and set up the next interval (or not) */
 
@@ -552,10 +645,16 @@ void sched_timer_expiration(void)
 	unsigned int elapsed;
 	unsigned int nexttime;
 
+#ifdef CONFIG_HRTIMER
+	/* Get the ticks elapsed up to now */
+
+	elapsed = sched_timer_elapsed();
+#else
 	/* Get the interval associated with last expiration */
 
 	elapsed = g_timer_interval;
 	g_timer_interval = 0;
+#endif
 
 	/* Process the timer ticks and set up the next interval (or not) */
 
@@ -587,7 +686,26 @@ void sched_timer_expiration(void)
  *
  ****************************************************************************/
 
+#if defined(CONFIG_HRTIMER)
+unsigned int sched_timer_cancel(void)
+{
+	struct timespec ts;
+
+	/* Cancel the alarm or interval timer, and get the ticks elapsed up to
+	 * now from the time instead.
+	 */
+
 #ifdef CONFIG_SCHED_TICKLESS_ALARM
+	(void)up_alarm_cancel(&ts);
+#else
+	(void)up_timer_cancel(&ts);
+#endif
+
+	/* Process the timer ticks and return the next interval */
+
+	return sched_timer_process(sched_timer_elapsed(), true);
+}
+#elif defined(CONFIG_SCHED_TICKLESS_ALARM)
 unsigned int sched_timer_cancel(void)
 {
 	struct timespec ts;
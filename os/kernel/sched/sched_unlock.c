@@ -128,6 +128,7 @@ int sched_unlock(void)
 
 		if (rtcb->lockcount <= 0) {
 			rtcb->lockcount = 0;
+			sched_stats_unlock(rtcb);
 
 			/* Release any ready-to-run tasks that have collected in
 			 * g_pendingtasks.
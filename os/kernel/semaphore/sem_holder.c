@@ -331,6 +331,7 @@ static int sem_boostholderprio(FAR struct semholder_s *pholder, FAR sem_t *sem,
 			 */
 
 			(void)sched_setpriority(htcb, rtcb->sched_priority);
+			sched_stats_boost(htcb);
 		} else {
 			/* The new priority is above the base priority of the holder,
 			 * but not as high as its current working priority.  Just put it
@@ -357,6 +358,7 @@ static int sem_boostholderprio(FAR struct semholder_s *pholder, FAR sem_t *sem,
 		 */
 
 		(void)sched_setpriority(htcb, rtcb->sched_priority);
+		sched_stats_boost(htcb);
 	}
 #endif
 
@@ -68,6 +68,7 @@
 
 #include <tinyara/arch.h>
 #include <tinyara/wdog.h>
+#include <tinyara/hrtimer.h>
 #include <tinyara/cancelpt.h>
 
 #include "sched/sched.h"
@@ -108,6 +109,27 @@
  *
  ****************************************************************************/
 
+#ifdef CONFIG_HRTIMER
+static void sig_timeout(FAR struct hrtimer_s *timer, FAR void *arg)
+{
+	FAR struct tcb_s *wtcb = (FAR struct tcb_s *)arg;
+
+	/* There may be a race condition -- make sure the task is
+	 * still waiting for a signal
+	 */
+
+	if (wtcb->task_state == TSTATE_WAIT_SIG) {
+		wtcb->sigunbinfo.si_signo = SIG_WAIT_TIMEOUT;
+		wtcb->sigunbinfo.si_code = SI_TIMER;
+		wtcb->sigunbinfo.si_value.sival_int = 0;
+#ifdef CONFIG_SCHED_HAVE_PARENT
+		wtcb->sigunbinfo.si_pid = 0;	/* Not applicable */
+		wtcb->sigunbinfo.si_status = OK;
+#endif
+		up_unblock_task(wtcb);
+	}
+}
+#else
 static void sig_timeout(int argc, uint32_t itcb)
 {
 	/* On many small machines, pointers are encoded and cannot be simply cast
@@ -139,6 +161,7 @@ static void sig_timeout(int argc, uint32_t itcb)
 		up_unblock_task(u.wtcb);
 	}
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -193,7 +216,11 @@ int sigtimedwait(FAR const sigset_t *set, FAR struct siginfo *info, FAR const st
 	sigset_t intersection;
 	FAR sigpendq_t *sigpend;
 	irqstate_t saved_state;
+#ifdef CONFIG_HRTIMER
+	struct hrtimer_s waittimer;
+#else
 	int32_t waitticks;
+#endif
 	int ret = ERROR;
 
 	DEBUGASSERT(rtcb->waitdog == NULL);
@@ -251,6 +278,22 @@ int sigtimedwait(FAR const sigset_t *set, FAR struct siginfo *info, FAR const st
 		/* Check if we should wait for the timeout */
 
 		if (timeout) {
+#ifdef CONFIG_HRTIMER
+			/* Time the wait to the nanosecond.  The timer is on our stack,
+			 * task_recover() cancels it if we are deleted while waiting.
+			 */
+
+			hrtimer_init(&waittimer);
+			rtcb->waittimer = &waittimer;
+			hrtimer_start(&waittimer, (uint64_t)timeout->tv_sec * NSEC_PER_SEC + timeout->tv_nsec, sig_timeout, rtcb, 0);
+
+			/* Now wait for either the signal or the timer */
+
+			up_block_task(rtcb, TSTATE_WAIT_SIG);
+
+			(void)hrtimer_cancel(&waittimer);
+			rtcb->waittimer = NULL;
+#else
 			/* Convert the timespec to system clock ticks, making sure that
 			 * the resulting delay is greater than or equal to the requested
 			 * time in nanoseconds.
@@ -299,6 +342,7 @@ int sigtimedwait(FAR const sigset_t *set, FAR struct siginfo *info, FAR const st
 			/* REVISIT: And do what if there are no watchdog timers?  The wait
 			 * will fail and we will return something bogus.
 			 */
+#endif
 		}
 
 		/* No timeout, just wait */
@@ -145,7 +145,15 @@ static int thread_create(FAR const char *name, uint8_t ttype, int priority, int
 
 	/* Allocate a TCB for the new task. */
 
-	tcb = (FAR struct task_tcb_s *)kmm_zalloc(sizeof(struct task_tcb_s));
+#ifdef CONFIG_TASK_POOL
+	/* From the pool first, with its stack */
+
+	tcb = (FAR struct task_tcb_s *)sched_taskpool_alloc(ttype, stack_size);
+	if (!tcb)
+#endif
+	{
+		tcb = (FAR struct task_tcb_s *)kmm_zalloc(sizeof(struct task_tcb_s));
+	}
 	if (!tcb) {
 		sdbg("ERROR: Failed to allocate TCB\n");
 		errcode = ENOMEM;
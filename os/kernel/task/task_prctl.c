@@ -57,6 +57,7 @@
 #include <tinyara/config.h>
 
 #include <sys/prctl.h>
+#include <stdint.h>
 #include <stdarg.h>
 #include <string.h>
 #include <errno.h>
@@ -64,6 +65,10 @@
 
 #include <tinyara/sched.h>
 #include <tinyara/ttrace.h>
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+#include <tinyara/irq.h>
+#include <tinyara/userspace.h>
+#endif
 
 #include "sched/sched.h"
 #include "task/task.h"
@@ -91,6 +96,7 @@
  *
  *     EINVAL The value of 'option' is not recognized.
  *     EFAULT optional arg1 is not a valid address.
+ *     EBUSY  Another word was registered by PR_SET_MUTEX_OWNER.
  *     ESRCH  No task/thread can be found corresponding to that specified
  *       by optional arg1.
  *
@@ -166,17 +172,54 @@ int prctl(int option, ...)
 	goto errout;
 #endif
 
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+	case PR_SET_MUTEX_OWNER: {
+		FAR volatile int *word = va_arg(ap, FAR volatile int *);
+		uintptr_t addr = (uintptr_t)word;
+		irqstate_t flags;
+
+		/* The kernel writes the word on each context switch, so it must be
+		 * an int of the .data or the .bss of the user space.
+		 */
+
+		if ((addr & (sizeof(int) - 1)) != 0 ||
+			!((addr >= USERSPACE->us_datastart && addr + sizeof(int) <= USERSPACE->us_dataend) ||
+			  (addr >= USERSPACE->us_bssstart && addr + sizeof(int) <= USERSPACE->us_bssend))) {
+			sdbg("Not a word of the user space: %p\n", word);
+			err = EFAULT;
+			goto errout;
+		}
+
+		/* Publish the owner word of this thread now, the next ones are
+		 * published by the context switches.
+		 */
+
+		flags = irqsave();
+		if (g_curowner != NULL && g_curowner != word) {
+			irqrestore(flags);
+			sdbg("Owner word already registered\n");
+			err = EBUSY;
+			goto errout;
+		}
+
+		g_curowner = word;
+		*word = this_task()->mowner;
+		irqrestore(flags);
+	}
+	break;
+#endif
+
 	default:
 		sdbg("Unrecognized option: %d\n", option);
 		err = EINVAL;
 		goto errout;
 	}
 
-	/* Not reachable unless CONFIG_TASK_NAME_SIZE is > 0.  NOTE: This might
-	 * change if additional commands are supported.
+	/* Not reachable unless CONFIG_TASK_NAME_SIZE is > 0 or
+	 * CONFIG_PTHREAD_MUTEX_FASTPATH is enabled.
 	 */
 
-#if CONFIG_TASK_NAME_SIZE > 0
+#if CONFIG_TASK_NAME_SIZE > 0 || defined(CONFIG_PTHREAD_MUTEX_FASTPATH)
 	va_end(ap);
 	trace_end(TTRACE_TAG_TASK);
 	return OK;
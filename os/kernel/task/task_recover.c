@@ -58,6 +58,7 @@
 
 #include <tinyara/arch.h>
 #include <tinyara/wdog.h>
+#include <tinyara/hrtimer.h>
 #include <tinyara/sched.h>
 
 #include "semaphore/semaphore.h"
@@ -118,6 +119,15 @@ void task_recover(FAR struct tcb_s *tcb)
 
 	wd_recover(tcb);
 
+#ifdef CONFIG_HRTIMER
+	/* Or the high resolution timer of sigtimedwait(), on its stack */
+
+	if (tcb->waittimer) {
+		(void)hrtimer_cancel(tcb->waittimer);
+		tcb->waittimer = NULL;
+	}
+#endif
+
 	/* If the thread holds semaphore counts or is waiting for a semaphore count,
 	 * then release the counts.
 	 */
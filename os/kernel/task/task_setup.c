@@ -152,11 +152,17 @@ static int task_assignpid(FAR struct tcb_s *tcb)
 		if (next_pid == (INT16_MAX - 1)) {
 			g_lastpid = 1;
 			next_pid = 1;
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+			g_pidgen++;
+#endif
 		}
 #else
 		if (next_pid <= 0) {
 			g_lastpid = 1;
 			next_pid = 1;
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+			g_pidgen++;
+#endif
 		}
 #endif
 
@@ -178,6 +184,9 @@ static int task_assignpid(FAR struct tcb_s *tcb)
 			}
 #endif
 			tcb->pid = next_pid;
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+			tcb->mowner = next_pid | _PTHREAD_MPID_FAST | ((g_pidgen & _PTHREAD_MPID_GENMASK) << _PTHREAD_MPID_GENSHIFT);
+#endif
 
 			/* Increment the task count */
 			g_alive_taskcount++;
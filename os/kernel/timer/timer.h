@@ -64,6 +64,7 @@
 
 #include <tinyara/compiler.h>
 #include <tinyara/wdog.h>
+#include <tinyara/hrtimer.h>
 
 /********************************************************************************
  * Definitions
@@ -89,9 +90,14 @@ struct posix_timer_s {
 	uint8_t pt_crefs;			/* Reference count */
 	uint8_t pt_signo;			/* Notification signal */
 	pid_t pt_owner;				/* Creator of timer */
+#ifdef CONFIG_HRTIMER
+	uint64_t pt_interval;		/* If non-zero, nanoseconds to reset repetitive timers */
+	struct hrtimer_s pt_hrtimer;	/* The hrtimer that provides the timing */
+#else
 	int pt_delay;				/* If non-zero, used to reset repetitive timers */
 	int pt_last;				/* Last value used to set watchdog */
 	WDOG_ID pt_wdog;			/* The watchdog that provides the timing */
+#endif
 	union sigval pt_value;		/* Data passed with notification */
 };
 
@@ -196,7 +196,9 @@ static struct posix_timer_s *timer_allocate(void)
 int timer_create(clockid_t clockid, FAR struct sigevent *evp, FAR timer_t *timerid)
 {
 	struct posix_timer_s *ret;
+#ifndef CONFIG_HRTIMER
 	WDOG_ID wdog;
+#endif
 
 	/* Sanity checks.  Also, we support only CLOCK_REALTIME */
 
@@ -205,6 +207,7 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp, FAR timer_t *timer
 		return ERROR;
 	}
 
+#ifndef CONFIG_HRTIMER
 	/* Allocate a watchdog to provide the underling CLOCK_REALTIME timer */
 
 	wdog = wd_create();
@@ -212,12 +215,15 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp, FAR timer_t *timer
 		set_errno(EAGAIN);
 		return ERROR;
 	}
+#endif
 
 	/* Allocate a timer instance to contain the watchdog */
 
 	ret = timer_allocate();
 	if (!ret) {
+#ifndef CONFIG_HRTIMER
 		wd_delete(wdog);
+#endif
 		set_errno(EAGAIN);
 		return ERROR;
 	}
@@ -226,8 +232,13 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp, FAR timer_t *timer
 
 	ret->pt_crefs = 1;
 	ret->pt_owner = getpid();
+#ifdef CONFIG_HRTIMER
+	ret->pt_interval = 0;
+	hrtimer_init(&ret->pt_hrtimer);
+#else
 	ret->pt_delay = 0;
 	ret->pt_wdog = wdog;
+#endif
 
 	if (evp) {
 		ret->pt_signo = evp->sigev_signo;
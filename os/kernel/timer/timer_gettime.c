@@ -118,13 +118,26 @@
 int timer_gettime(timer_t timerid, FAR struct itimerspec *value)
 {
 	FAR struct posix_timer_s *timer = (FAR struct posix_timer_s *)timerid;
+#ifdef CONFIG_HRTIMER
+	uint64_t nsec;
+#else
 	int ticks;
+#endif
 
 	if (!PT_ISVALID(timer) || !value) {
 		set_errno(EINVAL);
 		return ERROR;
 	}
 
+#ifdef CONFIG_HRTIMER
+	/* Get the time before the underlying hrtimer expires */
+
+	nsec = hrtimer_remaining(&timer->pt_hrtimer);
+	value->it_value.tv_sec = (time_t)(nsec / NSEC_PER_SEC);
+	value->it_value.tv_nsec = (long)(nsec % NSEC_PER_SEC);
+	value->it_interval.tv_sec = (time_t)(timer->pt_interval / NSEC_PER_SEC);
+	value->it_interval.tv_nsec = (long)(timer->pt_interval % NSEC_PER_SEC);
+#else
 	/* Get the number of ticks before the underlying watchdog expires */
 
 	ticks = wd_gettime(timer->pt_wdog);
@@ -133,6 +146,7 @@ int timer_gettime(timer_t timerid, FAR struct itimerspec *value)
 
 	(void)clock_ticks2time(ticks, &value->it_value);
 	(void)clock_ticks2time(timer->pt_last, &value->it_interval);
+#endif
 	return OK;
 }
 
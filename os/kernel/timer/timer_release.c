@@ -157,11 +157,17 @@ int timer_release(FAR struct posix_timer_s *timer)
 		return 1;
 	}
 
+#ifdef CONFIG_HRTIMER
+	/* Stop the underlying hrtimer */
+
+	(void)hrtimer_cancel(&timer->pt_hrtimer);
+#else
 	/* Free the underlying watchdog instance (the timer will be canceled by the
 	 * watchdog logic before it is actually deleted)
 	 */
 
 	(void)wd_delete(timer->pt_wdog);
+#endif
 
 	/* Mark this timer is not in use before releasing the timer.
 	 * This prevents returning some value when timer API is called after release
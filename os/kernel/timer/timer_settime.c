@@ -84,8 +84,12 @@
  ********************************************************************************/
 
 static inline void timer_sigqueue(FAR struct posix_timer_s *timer);
+#ifdef CONFIG_HRTIMER
+static void timer_timeout(FAR struct hrtimer_s *hrtimer, FAR void *arg);
+#else
 static inline void timer_restart(FAR struct posix_timer_s *timer, uint32_t itimer);
 static void timer_timeout(int argc, uint32_t itimer);
+#endif
 
 /********************************************************************************
  * Private Functions
@@ -132,6 +136,61 @@ static inline void timer_sigqueue(FAR struct posix_timer_s *timer)
 	(void)sig_dispatch(timer->pt_owner, &info);
 }
 
+/********************************************************************************
+ * Name: timer_nsec
+ *
+ * Description:
+ *   Convert a struct timespec to nanoseconds.
+ *
+ ********************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static inline uint64_t timer_nsec(FAR const struct timespec *ts)
+{
+	return (uint64_t)ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec;
+}
+
+/********************************************************************************
+ * Name: timer_timeout
+ *
+ * Description:
+ *   This function is called when the hrtimer of a POSIX timer expires.
+ *
+ * Parameters:
+ *   hrtimer - The hrtimer of the POSIX timer
+ *   arg     - A reference to the POSIX timer that just timed out
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   This function executes in the context of the timer interrupt.
+ *
+ ********************************************************************************/
+
+static void timer_timeout(FAR struct hrtimer_s *hrtimer, FAR void *arg)
+{
+	FAR struct posix_timer_s *timer = (FAR struct posix_timer_s *)arg;
+
+	/* Send the specified signal to the specified task.   Increment the reference
+	 * count on the timer first so that will not be deleted until after the
+	 * signal handler returns.
+	 */
+
+	timer->pt_crefs++;
+	timer_sigqueue(timer);
+
+	/* Release the reference.  timer_release will return nonzero if the timer
+	 * was not deleted.  A repetitive timer is restarted for one interval after
+	 * this expiration, so that the latency of the expirations doesn't add up.
+	 */
+
+	if (timer_release(timer) && timer->pt_interval) {
+		(void)hrtimer_start(hrtimer, hrtimer->expiry + timer->pt_interval, timer_timeout, timer, HRTIMER_ABSTIME);
+	}
+}
+#else
+
 /********************************************************************************
  * Name: timer_restart
  *
@@ -236,6 +295,7 @@ static void timer_timeout(int argc, uint32_t itimer)
 	}
 #endif
 }
+#endif							/* CONFIG_HRTIMER */
 
 /********************************************************************************
  * Public Functions
@@ -308,7 +368,12 @@ int timer_settime(timer_t timerid, int flags, FAR const struct itimerspec *value
 {
 	FAR struct posix_timer_s *timer = (FAR struct posix_timer_s *)timerid;
 	irqstate_t state;
+#ifdef CONFIG_HRTIMER
+	struct timespec now;
+	uint64_t nsec;
+#else
 	int delay;
+#endif
 	int ret = OK;
 
 	/* Some sanity checks */
@@ -322,7 +387,11 @@ int timer_settime(timer_t timerid, int flags, FAR const struct itimerspec *value
 	 * is called).
 	 */
 
+#ifdef CONFIG_HRTIMER
+	(void)hrtimer_cancel(&timer->pt_hrtimer);
+#else
 	(void)wd_cancel(timer->pt_wdog);
+#endif
 
 	/* If the it_value member of value is zero, the timer will not be re-armed */
 
@@ -330,6 +399,41 @@ int timer_settime(timer_t timerid, int flags, FAR const struct itimerspec *value
 		return OK;
 	}
 
+#ifdef CONFIG_HRTIMER
+	/* Setup up any repititive timer */
+
+	if (value->it_interval.tv_sec > 0 || value->it_interval.tv_nsec > 0) {
+		timer->pt_interval = timer_nsec(&value->it_interval);
+	} else {
+		timer->pt_interval = 0;
+	}
+
+	state = irqsave();
+
+	/* The hrtimer is started for a time in nanoseconds, which isn't rounded to
+	 * a tick.
+	 */
+
+	nsec = timer_nsec(&value->it_value);
+	if ((flags & TIMER_ABSTIME) != 0) {
+		/* Calculate a delay corresponding to the absolute time in 'value' */
+
+		(void)clock_gettime(CLOCK_REALTIME, &now);
+		nsec = nsec > timer_nsec(&now) ? nsec - timer_nsec(&now) : 0;
+	}
+
+	/* If the time is in the past or now, then set up the next interval
+	 * instead (assuming a repititive timer).
+	 */
+
+	if (nsec == 0) {
+		nsec = timer->pt_interval;
+	}
+
+	if (nsec > 0) {
+		ret = hrtimer_start(&timer->pt_hrtimer, nsec, timer_timeout, timer, 0);
+	}
+#else
 	/* Setup up any repititive timer */
 
 	if (value->it_interval.tv_sec > 0 || value->it_interval.tv_nsec > 0) {
@@ -376,6 +480,7 @@ int timer_settime(timer_t timerid, int flags, FAR const struct itimerspec *value
 		timer->pt_last = delay;
 		ret = wd_start(timer->pt_wdog, delay, (wdentry_t)timer_timeout, 1, (uint32_t)((uintptr_t)timer));
 	}
+#endif
 
 	irqrestore(state);
 	return ret;
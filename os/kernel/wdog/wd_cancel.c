@@ -108,8 +108,10 @@
 
 int wd_cancel(WDOG_ID wdog)
 {
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 	FAR struct wdog_s *curr;
 	FAR struct wdog_s *prev;
+#endif
 	irqstate_t state;
 	int ret = ERROR;
 
@@ -123,6 +125,28 @@ int wd_cancel(WDOG_ID wdog)
 	 * active.
 	 */
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+	if (wdog && WDOG_ISACTIVE(wdog)) {
+#ifdef CONFIG_SCHED_TICKLESS
+		/* Reassess the interval timer if it may have been set for this
+		 * watchdog.
+		 */
+
+		bool next = wd_wheel_remaining(wdog) == wd_wheel_next();
+#endif
+
+		wd_wheel_remove(wdog);
+
+#ifdef CONFIG_SCHED_TICKLESS
+		if (next) {
+			sched_timer_reassess();
+		}
+#endif
+
+		WDOG_CLRACTIVE(wdog);
+		ret = OK;
+	}
+#else
 	if (wdog && WDOG_ISACTIVE(wdog)) {
 		/* Search the g_wdactivelist for the target FCB.  We can't use sq_rem
 		 * to do this because there are additional operations that need to be
@@ -178,6 +202,7 @@ int wd_cancel(WDOG_ID wdog)
 
 		ret = OK;
 	}
+#endif
 
 	irqrestore(state);
 	return ret;
@@ -109,6 +109,14 @@ int wd_gettime(WDOG_ID wdog)
 	/* Verify the wdog */
 
 	flags = irqsave();
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+	if (wdog && WDOG_ISACTIVE(wdog)) {
+		int delay = wd_wheel_remaining(wdog);
+
+		irqrestore(flags);
+		return delay;
+	}
+#else
 	if (wdog && WDOG_ISACTIVE(wdog)) {
 		/* Traverse the watchdog list accumulating lag times until we find the wdog
 		 * that we are looking for
@@ -125,6 +133,7 @@ int wd_gettime(WDOG_ID wdog)
 			}
 		}
 	}
+#endif
 
 	irqrestore(flags);
 	return 0;
@@ -83,7 +83,9 @@ sq_queue_t g_wdfreelist;
  * this linked list are removed and the function is called.
  */
 
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 sq_queue_t g_wdactivelist;
+#endif
 
 /* This is the number of free, pre-allocated watchdog structures in the
  * g_wdfreelist.  This value is used to enforce a reserve for interrupt
@@ -137,7 +139,9 @@ void wd_initialize(void)
 	/* Initialize watchdog lists */
 
 	sq_init(&g_wdfreelist);
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 	sq_init(&g_wdactivelist);
+#endif
 
 	/* The g_wdfreelist must be loaded at initialization time to hold the
 	 * configured number of watchdogs.
@@ -111,12 +111,63 @@ typedef void (*wdentry4_t)(int argc, uint32_t arg1, uint32_t arg2, uint32_t arg3
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
+/****************************************************************************
+ * Name: wd_call
+ *
+ * Description:
+ *   Execute the function of a watchdog which has expired.
+ *
+ * Parameters:
+ *   wdog - The watchdog, which is no longer active
+ *
+ * Return Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static inline void wd_call(FAR struct wdog_s *wdog)
+{
+	up_setpicbase(wdog->picbase);
+	switch (wdog->argc) {
+	default:
+		DEBUGPANIC();
+		break;
+
+	case 0:
+		(*((wdentry0_t)(wdog->func)))(0);
+		break;
+
+#if CONFIG_MAX_WDOGPARMS > 0
+	case 1:
+		(*((wdentry1_t)(wdog->func)))(1, wdog->parm[0]);
+		break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 1
+	case 2:
+		(*((wdentry2_t)(wdog->func)))(2, wdog->parm[0], wdog->parm[1]);
+		break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 2
+	case 3:
+		(*((wdentry3_t)(wdog->func)))(3, wdog->parm[0], wdog->parm[1], wdog->parm[2]);
+		break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 3
+	case 4:
+		(*((wdentry4_t)(wdog->func)))(4, wdog->parm[0], wdog->parm[1], wdog->parm[2], wdog->parm[3]);
+		break;
+#endif
+	}
+}
+
 /****************************************************************************
  * Name: wd_expiration
  *
  * Description:
  *   Check if the timer for the watchdog at the head of list is ready to
- *   run.  If so, remove the watchdog from the list and execute it.
+ *   run.  If so, remove the watchdog from the list and execute it.  With
+ *   CONFIG_WDOG_TIMER_WHEEL, execute the watchdogs of the current tick of
+ *   the timer wheel.
  *
  * Parameters:
  *   None
@@ -128,6 +179,22 @@ typedef void (*wdentry4_t)(int argc, uint32_t arg1, uint32_t arg2, uint32_t arg3
  *
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+static inline void wd_expiration(void)
+{
+	FAR struct wdog_s *wdog;
+
+	while ((wdog = wd_wheel_expired()) != NULL) {
+		/* Indicate that the watchdog is no longer active. */
+
+		WDOG_CLRACTIVE(wdog);
+
+		/* Execute the watchdog function */
+
+		wd_call(wdog);
+	}
+}
+#else
 static inline void wd_expiration(void)
 {
 	FAR struct wdog_s *wdog;
@@ -158,40 +225,11 @@ static inline void wd_expiration(void)
 
 			/* Execute the watchdog function */
 
-			up_setpicbase(wdog->picbase);
-			switch (wdog->argc) {
-			default:
-				DEBUGPANIC();
-				break;
-
-			case 0:
-				(*((wdentry0_t)(wdog->func)))(0);
-				break;
-
-#if CONFIG_MAX_WDOGPARMS > 0
-			case 1:
-				(*((wdentry1_t)(wdog->func)))(1, wdog->parm[0]);
-				break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 1
-			case 2:
-				(*((wdentry2_t)(wdog->func)))(2, wdog->parm[0], wdog->parm[1]);
-				break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 2
-			case 3:
-				(*((wdentry3_t)(wdog->func)))(3, wdog->parm[0], wdog->parm[1], wdog->parm[2]);
-				break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 3
-			case 4:
-				(*((wdentry4_t)(wdog->func)))(4, wdog->parm[0], wdog->parm[1], wdog->parm[2], wdog->parm[3]);
-				break;
-#endif
-			}
+			wd_call(wdog);
 		}
 	}
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -233,10 +271,12 @@ static inline void wd_expiration(void)
 int wd_start(WDOG_ID wdog, int delay, wdentry_t wdentry, int argc, ...)
 {
 	va_list ap;
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 	FAR struct wdog_s *curr;
 	FAR struct wdog_s *prev;
 	FAR struct wdog_s *next;
 	int32_t now;
+#endif
 	irqstate_t state;
 	int i;
 
@@ -292,6 +332,11 @@ int wd_start(WDOG_ID wdog, int delay, wdentry_t wdentry, int argc, ...)
 	(void)sched_timer_cancel();
 #endif
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+	/* Put it in the slot of the timer wheel for its expiration tick */
+
+	wd_wheel_add(wdog, delay);
+#else
 	/* Do the easy case first -- when the watchdog timer queue is empty. */
 
 	if (g_wdactivelist.head == NULL) {
@@ -363,9 +408,13 @@ int wd_start(WDOG_ID wdog, int delay, wdentry_t wdentry, int argc, ...)
 		}
 	}
 
-	/* Put the lag into the watchdog structure and mark it as active. */
+	/* Put the lag into the watchdog structure */
 
 	wdog->lag = delay;
+#endif
+
+	/* Mark it as active. */
+
 	WDOG_SETACTIVE(wdog);
 
 #ifdef CONFIG_SCHED_TICKLESS
@@ -406,7 +455,39 @@ int wd_start(WDOG_ID wdog, int delay, wdentry_t wdentry, int argc, ...)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_SCHED_TICKLESS
+#if defined(CONFIG_WDOG_TIMER_WHEEL) && defined(CONFIG_SCHED_TICKLESS)
+unsigned int wd_timer(int ticks)
+{
+	unsigned int next;
+	int decr;
+
+	while (ticks > 0) {
+		/* Advance the timer wheel up to its next event at most */
+
+		next = wd_wheel_next();
+		decr = (next == 0 || next > (unsigned int)ticks) ? ticks : (int)next;
+
+		wd_wheel_advance(decr);
+		ticks -= decr;
+
+		/* Execute the watchdogs expiring at this tick */
+
+		wd_expiration();
+	}
+
+	/* Return the delay for the next event of the wheel */
+
+	return wd_wheel_next();
+}
+
+#elif defined(CONFIG_WDOG_TIMER_WHEEL)
+void wd_timer(void)
+{
+	wd_wheel_advance(1);
+	wd_expiration();
+}
+
+#elif defined(CONFIG_SCHED_TICKLESS)
 unsigned int wd_timer(int ticks)
 {
 	FAR struct wdog_s *wdog;
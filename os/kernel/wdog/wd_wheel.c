@@ -0,0 +1,298 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/wdog/wd_wheel.c
+ *
+ * The hierarchical timer wheel holding the active watchdogs with
+ * CONFIG_WDOG_TIMER_WHEEL.
+ *
+ * Level n of the wheel has WHEEL_SLOTS slots of 2^(n * WHEEL_BITS) ticks.
+ * A watchdog expiring within 2^((n + 1) * WHEEL_BITS) ticks is put in
+ * level n, in the slot of its expiration tick.  Whenever the ticks of a
+ * slot of level n + 1 begin, its watchdogs are cascaded down into the
+ * lower levels, so that the watchdogs of the current tick are all in its
+ * slot of level 0.  The lag of an active watchdog is its expiration tick.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+
+#include <tinyara/wdog.h>
+
+#include "wdog/wdog.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WHEEL_BITS   6
+#define WHEEL_SLOTS  (1 << WHEEL_BITS)
+#define WHEEL_MASK   (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS 4
+#define WHEEL_RANGE  ((uint32_t)1 << (WHEEL_BITS * WHEEL_LEVELS))
+
+#define WHEEL_SHIFT(level) ((level) * WHEEL_BITS)
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+
+/* The lists of watchdogs of each slot, linked through next and pprev */
+
+static FAR struct wdog_s *g_wdwheel[WHEEL_LEVELS][WHEEL_SLOTS];
+
+/* Bit n is set when slot n of the level is not empty */
+
+static uint64_t g_wdslots[WHEEL_LEVELS];
+
+/* The last tick processed by wd_wheel_advance() */
+
+static uint32_t g_wdtime;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void wd_wheel_insert(FAR struct wdog_s *wdog)
+{
+	FAR struct wdog_s **head;
+	uint32_t expiry = (uint32_t)wdog->lag;
+	uint32_t delay = expiry - g_wdtime;
+	int level;
+	int slot;
+
+	DEBUGASSERT((int32_t)delay >= 0);
+
+	/* A watchdog beyond the wheel waits in its farthest slot, and is
+	 * inserted again when that slot is cascaded.
+	 */
+
+	if (delay >= WHEEL_RANGE) {
+		delay = WHEEL_RANGE - 1;
+		expiry = g_wdtime + delay;
+	}
+
+	for (level = 0; level < WHEEL_LEVELS - 1 && delay >= ((uint32_t)1 << WHEEL_SHIFT(level + 1)); level++) ;
+	slot = (expiry >> WHEEL_SHIFT(level)) & WHEEL_MASK;
+
+	head = &g_wdwheel[level][slot];
+	wdog->next = *head;
+	if (*head) {
+		(*head)->pprev = &wdog->next;
+	}
+	wdog->pprev = head;
+	*head = wdog;
+
+	wdog->slot = (uint8_t)(level * WHEEL_SLOTS + slot);
+	g_wdslots[level] |= (uint64_t)1 << slot;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_add
+ *
+ * Description:
+ *   Add a watchdog to the timer wheel.
+ *
+ * Parameters:
+ *   wdog - The watchdog, which isn't active
+ *   delay - Ticks until it expires, at least one
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_add(FAR struct wdog_s *wdog, int delay)
+{
+	wdog->lag = (int)(g_wdtime + (uint32_t)delay);
+	wd_wheel_insert(wdog);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove a watchdog from the timer wheel.
+ *
+ * Parameters:
+ *   wdog - The watchdog, which is active
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+	int level = wdog->slot / WHEEL_SLOTS;
+	int slot = wdog->slot & WHEEL_MASK;
+
+	*wdog->pprev = wdog->next;
+	if (wdog->next) {
+		wdog->next->pprev = wdog->pprev;
+	}
+	wdog->next = NULL;
+	wdog->pprev = NULL;
+
+	if (!g_wdwheel[level][slot]) {
+		g_wdslots[level] &= ~((uint64_t)1 << slot);
+	}
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remaining
+ *
+ * Description:
+ *   Return the ticks until an active watchdog expires.
+ *
+ ****************************************************************************/
+
+int wd_wheel_remaining(FAR struct wdog_s *wdog)
+{
+	return (int)((uint32_t)wdog->lag - g_wdtime);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the ticks until the next event of the timer wheel: the
+ *   expiration of the next watchdog of level 0, or the cascade of the next
+ *   non-empty slot of a higher level, whichever comes first.  The
+ *   watchdogs of a cascaded slot expire at the earliest at its cascade.
+ *
+ * Return Value:
+ *   The number of ticks, or zero if there is no active watchdog.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+unsigned int wd_wheel_next(void)
+{
+	unsigned int next = 0;
+	uint32_t delay;
+	uint64_t slots;
+	int level;
+	int shift;
+	int first;
+
+	for (level = 0; level < WHEEL_LEVELS; level++) {
+		slots = g_wdslots[level];
+		if (slots == 0) {
+			continue;
+		}
+
+		/* Rotate the slots so that bit 0 is the one after the current slot.
+		 * The current slot of a level > 0 has already been cascaded, it only
+		 * holds watchdogs of the next turn of the level.
+		 */
+
+		shift = WHEEL_SHIFT(level);
+		first = ((g_wdtime >> shift) + 1) & WHEEL_MASK;
+		if (first != 0) {
+			slots = (slots >> first) | (slots << (WHEEL_SLOTS - first));
+		}
+
+		delay = (((g_wdtime >> shift) + 1 + __builtin_ctzll(slots)) << shift) - g_wdtime;
+		if (next == 0 || delay < next) {
+			next = delay;
+		}
+	}
+
+	return next;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_advance
+ *
+ * Description:
+ *   Advance the timer wheel to a later tick and cascade the slots which
+ *   begin at that tick.  The watchdogs expiring at that tick are then
+ *   returned by wd_wheel_expired().
+ *
+ * Parameters:
+ *   ticks - The number of ticks, at least one and at most
+ *     wd_wheel_next() if there are active watchdogs
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_advance(unsigned int ticks)
+{
+	FAR struct wdog_s *wdog;
+	int level;
+	int slot;
+
+	g_wdtime += ticks;
+
+	for (level = 1; level < WHEEL_LEVELS && (g_wdtime & (((uint32_t)1 << WHEEL_SHIFT(level)) - 1)) == 0; level++) {
+		slot = (g_wdtime >> WHEEL_SHIFT(level)) & WHEEL_MASK;
+		while ((wdog = g_wdwheel[level][slot]) != NULL) {
+			wd_wheel_remove(wdog);
+			wd_wheel_insert(wdog);
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: wd_wheel_expired
+ *
+ * Description:
+ *   Remove a watchdog expiring at the current tick from the timer wheel.
+ *
+ * Return Value:
+ *   The watchdog, or NULL if there are no more.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_expired(void)
+{
+	FAR struct wdog_s *wdog = g_wdwheel[0][g_wdtime & WHEEL_MASK];
+
+	if (wdog) {
+		wd_wheel_remove(wdog);
+	}
+	return wdog;
+}
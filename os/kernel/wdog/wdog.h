@@ -92,10 +92,14 @@ extern sq_queue_t g_wdfreelist;
 
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
- * this linked list are removed and the function is called.
+ * this linked list are removed and the function is called.  With
+ * CONFIG_WDOG_TIMER_WHEEL, the active watchdogs are in the timer wheel
+ * of wd_wheel.c instead.
  */
 
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 extern sq_queue_t g_wdactivelist;
+#endif
 
 /* This is the number of free, pre-allocated watchdog structures in the
  * g_wdfreelist.  This value is used to enforce a reserve for interrupt
@@ -182,6 +186,19 @@ void wd_timer(void);
 struct tcb_s;
 void wd_recover(FAR struct tcb_s *tcb);
 
+/****************************************************************************
+ * Timer wheel, see wd_wheel.c
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+void wd_wheel_add(FAR struct wdog_s *wdog, int delay);
+void wd_wheel_remove(FAR struct wdog_s *wdog);
+int wd_wheel_remaining(FAR struct wdog_s *wdog);
+unsigned int wd_wheel_next(void);
+void wd_wheel_advance(unsigned int ticks);
+FAR struct wdog_s *wd_wheel_expired(void);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
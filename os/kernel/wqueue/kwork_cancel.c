@@ -194,7 +194,11 @@ int work_cancel(int qid, FAR struct work_s *work)
 		if (qid == LPWORK) {
 			/* Cancel low priority work */
 
+#ifdef CONFIG_SCHED_WORKPOOL
+			return work_poolcancel(work);
+#else
 			return work_qcancel((FAR struct kwork_wqueue_s *)&g_lpwork, work);
+#endif
 		} else
 #endif
 		{
@@ -0,0 +1,436 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/wqueue/kwork_pool.c
+ *
+ * The low priority work queue with CONFIG_SCHED_WORKPOOL: a pool of
+ * CONFIG_SCHED_LPNTHREADS worker threads instead of workers polling one
+ * list.
+ *
+ * The work ready to run is kept in WORK_NLEVELS run queues, one for each
+ * band of priorities from CONFIG_SCHED_LPWORKPRIORITY to
+ * CONFIG_SCHED_LPWORKPRIOMAX.  A free worker takes the oldest work of the
+ * highest band and runs it at the priority of the task which queued it,
+ * so that a slow work only holds up its own worker.  A delayed work waits
+ * in the watchdog of its work structure and is moved to its run queue
+ * when the watchdog expires.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <semaphore.h>
+#include <sched.h>
+#include <time.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/clock.h>
+#include <tinyara/kthread.h>
+#include <tinyara/semaphore.h>
+#include <tinyara/wdog.h>
+#include <tinyara/wqueue.h>
+
+#include "sched/sched.h"
+#include "wqueue/wqueue.h"
+
+#ifdef CONFIG_SCHED_WORKPOOL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The run queues, one bit of runmap each */
+
+#define WORK_NLEVELS 8
+
+#define WORK_PRIORANGE (CONFIG_SCHED_LPWORKPRIOMAX - CONFIG_SCHED_LPWORKPRIORITY + 1)
+#define WORK_LEVEL(prio) \
+	((((prio) - CONFIG_SCHED_LPWORKPRIORITY) * WORK_NLEVELS) / WORK_PRIORANGE)
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+#define WORK_CLOCK CLOCK_MONOTONIC
+#else
+#define WORK_CLOCK CLOCK_REALTIME
+#endif
+
+/****************************************************************************
+ * Private Type Declarations
+ ****************************************************************************/
+
+struct work_pool_s {
+	struct dq_queue_s runq[WORK_NLEVELS];	/* The work ready to run */
+	uint8_t runmap;				/* Bit n is set when runq[n] isn't empty */
+	sem_t sem;					/* Counts the work ready and the signals */
+	pid_t pid[CONFIG_SCHED_LPNTHREADS];	/* The worker threads */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKPOOL_STATS
+struct work_stats_s g_workstats[CONFIG_SCHED_WORKPOOL_NSTATS];
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct work_pool_s g_workpool;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKPOOL_STATS
+static uint32_t work_poolusec(void)
+{
+	struct timespec ts;
+
+	(void)clock_gettime(WORK_CLOCK, &ts);
+	return (uint32_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+}
+
+/* Add a run of a worker callback to its statistics */
+
+static void work_poolstats(worker_t worker, uint32_t latency, uint32_t run)
+{
+	FAR struct work_stats_s *stats;
+	irqstate_t flags;
+	int i;
+
+	flags = irqsave();
+	for (i = 0; i < CONFIG_SCHED_WORKPOOL_NSTATS - 1; i++) {
+		stats = &g_workstats[i];
+		if (stats->worker == worker || stats->count == 0) {
+			break;
+		}
+	}
+
+	stats = &g_workstats[i];
+	if (stats->worker != worker) {
+		stats->worker = stats->count == 0 ? worker : NULL;
+	}
+
+	stats->count++;
+	stats->latency += latency;
+	stats->run += run;
+	if (latency > stats->maxlatency) {
+		stats->maxlatency = latency;
+	}
+	if (run > stats->maxrun) {
+		stats->maxrun = run;
+	}
+	irqrestore(flags);
+}
+#endif
+
+/****************************************************************************
+ * Name: work_poolready
+ *
+ * Description:
+ *   Add a work to the run queue of its priority and wake up a worker.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+static void work_poolready(FAR struct work_s *work)
+{
+	int level = WORK_LEVEL(work->prio);
+
+#ifdef CONFIG_SCHED_WORKPOOL_STATS
+	work->ready = work_poolusec();
+#endif
+	dq_addlast((FAR dq_entry_t *)work, &g_workpool.runq[level]);
+	g_workpool.runmap |= (uint8_t)(1 << level);
+	sem_post(&g_workpool.sem);
+}
+
+/****************************************************************************
+ * Name: work_pooltimeout
+ *
+ * Description:
+ *   The watchdog of a delayed work expired, from the timer interrupt.
+ *
+ ****************************************************************************/
+
+static void work_pooltimeout(int argc, uint32_t arg1, ...)
+{
+	work_poolready((FAR struct work_s *)arg1);
+}
+
+/****************************************************************************
+ * Name: work_poolthread
+ *
+ * Description:
+ *   A worker thread of the pool.  It waits for work, runs the oldest work
+ *   of the highest run queue at the priority of the work, and performs the
+ *   garbage collection which the other kernel worker threads perform
+ *   periodically.
+ *
+ ****************************************************************************/
+
+static int work_poolthread(int argc, char *argv[])
+{
+	FAR struct tcb_s *rtcb = this_task();
+	FAR struct work_s *work;
+	worker_t worker;
+	FAR void *arg;
+	irqstate_t flags;
+	uint8_t prio;
+	int level;
+#ifdef CONFIG_SCHED_WORKPOOL_STATS
+	uint32_t ready;
+	uint32_t start;
+#endif
+
+	for (;;) {
+		/* Back to the base priority while waiting for work, or for
+		 * work_signal() of garbage to collect.
+		 */
+
+		if (rtcb->sched_priority != CONFIG_SCHED_LPWORKPRIORITY) {
+			sched_setpriority(rtcb, CONFIG_SCHED_LPWORKPRIORITY);
+		}
+
+		while (sem_wait(&g_workpool.sem) != OK) {
+			DEBUGASSERT(get_errno() == EINTR);
+		}
+
+		sched_garbagecollection();
+
+		/* A work cancelled after it was ready leaves a count behind */
+
+		flags = irqsave();
+		if (g_workpool.runmap == 0) {
+			irqrestore(flags);
+			continue;
+		}
+
+		level = 31 - __builtin_clz(g_workpool.runmap);
+		work = (FAR struct work_s *)dq_remfirst(&g_workpool.runq[level]);
+		if (g_workpool.runq[level].head == NULL) {
+			g_workpool.runmap &= (uint8_t)~(1 << level);
+		}
+
+		/* Take the work description before the work may be queued again */
+
+		worker = work->worker;
+		arg = work->arg;
+		prio = work->prio;
+#ifdef CONFIG_SCHED_WORKPOOL_STATS
+		ready = work->ready;
+#endif
+		work->worker = NULL;
+		irqrestore(flags);
+
+		if (rtcb->sched_priority != prio) {
+			sched_setpriority(rtcb, prio);
+		}
+
+#ifdef CONFIG_SCHED_WORKPOOL_STATS
+		start = work_poolusec();
+		worker(arg);
+		work_poolstats(worker, start - ready, work_poolusec() - start);
+#else
+		worker(arg);
+#endif
+	}
+
+	return OK;					/* To keep some compilers happy */
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_poolqueue
+ *
+ * Description:
+ *   Queue work to the pool, see work_queue().  The work runs at the
+ *   priority of the caller, within CONFIG_SCHED_LPWORKPRIORITY and
+ *   CONFIG_SCHED_LPWORKPRIOMAX, or at CONFIG_SCHED_LPWORKPRIORITY if it is
+ *   queued by an interrupt handler.
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -EALREADY if the work is already queued.
+ *
+ ****************************************************************************/
+
+int work_poolqueue(FAR struct work_s *work, worker_t worker, FAR void *arg, uint32_t delay)
+{
+	irqstate_t flags;
+	int prio;
+
+	DEBUGASSERT(work != NULL && worker != NULL);
+
+	prio = CONFIG_SCHED_LPWORKPRIORITY;
+	if (!up_interrupt_context()) {
+		prio = this_task()->sched_priority;
+		if (prio < CONFIG_SCHED_LPWORKPRIORITY) {
+			prio = CONFIG_SCHED_LPWORKPRIORITY;
+		} else if (prio > CONFIG_SCHED_LPWORKPRIOMAX) {
+			prio = CONFIG_SCHED_LPWORKPRIOMAX;
+		}
+	}
+
+	flags = irqsave();
+	if (work->worker != NULL) {
+		irqrestore(flags);
+		return -EALREADY;
+	}
+
+	work->worker = worker;
+	work->arg = arg;
+	work->delay = delay;
+	work->qtime = clock_systimer();
+	work->prio = (uint8_t)prio;
+
+	if (delay == 0) {
+		work_poolready(work);
+	} else {
+		/* The watchdog of an unqueued work is never active */
+
+		wd_static(&work->timer);
+		wd_start(&work->timer, (int)delay, (wdentry_t)work_pooltimeout, 1, (uint32_t)work);
+	}
+
+	irqrestore(flags);
+	return OK;
+}
+
+/****************************************************************************
+ * Name: work_poolcancel
+ *
+ * Description:
+ *   Cancel work queued to the pool, see work_cancel().
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -ENOENT if the work is not queued.
+ *
+ ****************************************************************************/
+
+int work_poolcancel(FAR struct work_s *work)
+{
+	irqstate_t flags;
+	int level;
+
+	DEBUGASSERT(work != NULL);
+
+	flags = irqsave();
+	if (work->worker == NULL) {
+		irqrestore(flags);
+		return -ENOENT;
+	}
+
+	if (WDOG_ISACTIVE(&work->timer)) {
+		wd_cancel(&work->timer);
+	} else {
+		level = WORK_LEVEL(work->prio);
+		dq_rem((FAR dq_entry_t *)work, &g_workpool.runq[level]);
+		if (g_workpool.runq[level].head == NULL) {
+			g_workpool.runmap &= (uint8_t)~(1 << level);
+		}
+	}
+
+	work->worker = NULL;
+	irqrestore(flags);
+	return OK;
+}
+
+/****************************************************************************
+ * Name: work_poolsignal
+ *
+ * Description:
+ *   Wake up a worker, which performs the garbage collection.
+ *
+ ****************************************************************************/
+
+int work_poolsignal(void)
+{
+	return sem_post(&g_workpool.sem) == OK ? OK : -get_errno();
+}
+
+/****************************************************************************
+ * Name: work_lpstart
+ *
+ * Description:
+ *   Start the worker threads of the pool.
+ *
+ * Input parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The task ID of the first worker thread is returned on success.  A
+ *   negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+int work_lpstart(void)
+{
+	int pid;
+	int i;
+
+	for (i = 0; i < WORK_NLEVELS; i++) {
+		dq_init(&g_workpool.runq[i]);
+	}
+	g_workpool.runmap = 0;
+
+	/* The semaphore is only used for signaling */
+
+	sem_init(&g_workpool.sem, 0, 0);
+#ifdef CONFIG_PRIORITY_INHERITANCE
+	sem_setprotocol(&g_workpool.sem, SEM_PRIO_NONE);
+#endif
+
+	sched_lock();
+
+	svdbg("Starting %d low-priority kernel worker thread(s)\n", CONFIG_SCHED_LPNTHREADS);
+
+	for (i = 0; i < CONFIG_SCHED_LPNTHREADS; i++) {
+		pid = kernel_thread(LPWORKNAME, CONFIG_SCHED_LPWORKPRIORITY, CONFIG_SCHED_LPWORKSTACKSIZE, (main_t)work_poolthread, (FAR char *const *)NULL);
+
+		DEBUGASSERT(pid > 0);
+		if (pid < 0) {
+			int errcode = get_errno();
+
+			slldbg("kernel_thread %d failed: %d\n", i, errcode);
+			sched_unlock();
+			return -errcode;
+		}
+
+		g_workpool.pid[i] = (pid_t)pid;
+	}
+
+	sched_unlock();
+	return g_workpool.pid[0];
+}
+
+#endif							/* CONFIG_SCHED_WORKPOOL */
@@ -0,0 +1,332 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/wqueue/kwork_procfs.c
+ *
+ * /proc/workpool: the statistics of the work of the low priority work
+ * queue pool, one line for each worker callback.  The times are in
+ * microseconds.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/statfs.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/procfs.h>
+
+#include "wqueue/wqueue.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#if defined(CONFIG_SCHED_WORKPOOL_STATS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_WORKPOOL)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define WORKPOOL_LINELEN 80
+
+#define WORKPOOL_TITLE_FMT " %10s | %8s | %8s | %8s | %8s | %8s\n"
+#define WORKPOOL_TITLE "WORKER", "COUNT", "LAT_AVG", "LAT_MAX", "RUN_AVG", "RUN_MAX"
+#define WORKPOOL_LINE " -----------|----------|----------|----------|----------|---------\n"
+#define WORKPOOL_FMT " %10s | %8lu | %8lu | %8lu | %8lu | %8lu\n"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct workpool_file_s {
+	struct procfs_file_s base;	/* Base open file structure */
+	char line[WORKPOOL_LINELEN];	/* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int workpool_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
+static int workpool_close(FAR struct file *filep);
+static ssize_t workpool_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+
+static int workpool_dup(FAR const struct file *oldp, FAR struct file *newp);
+
+static int workpool_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations workpool_operations = {
+	workpool_open,				/* open */
+	workpool_close,				/* close */
+	workpool_read,				/* read */
+	NULL,						/* write */
+
+	workpool_dup,				/* dup */
+
+	NULL,						/* opendir */
+	NULL,						/* closedir */
+	NULL,						/* readdir */
+	NULL,						/* rewinddir */
+
+	workpool_stat				/* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: workpool_open
+ ****************************************************************************/
+
+static int workpool_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	FAR struct workpool_file_s *attr;
+
+	fvdbg("Open '%s'\n", relpath);
+
+	/* PROCFS is read-only.  Any attempt to open with any kind of write
+	 * access is not permitted.
+	 */
+
+	if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0) {
+		fdbg("ERROR: Only O_RDONLY supported\n");
+		return -EACCES;
+	}
+
+	/* "workpool" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "workpool") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* Allocate a container to hold the file attributes */
+
+	attr = (FAR struct workpool_file_s *)kmm_zalloc(sizeof(struct workpool_file_s));
+	if (!attr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* Save the attributes as the open-specific state in filep->f_priv */
+
+	filep->f_priv = (FAR void *)attr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: workpool_close
+ ****************************************************************************/
+
+static int workpool_close(FAR struct file *filep)
+{
+	FAR struct workpool_file_s *attr;
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct workpool_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	/* Release the file attributes structure */
+
+	kmm_free(attr);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: workpool_read
+ ****************************************************************************/
+
+static ssize_t workpool_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct workpool_file_s *attr;
+	struct work_stats_s stats;
+	irqstate_t flags;
+	char name[12];
+	size_t linesize;
+	size_t copysize;
+	size_t totalsize;
+	off_t offset;
+	int i;
+
+	fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct workpool_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	offset = filep->f_pos;
+	totalsize = 0;
+
+	linesize = snprintf(attr->line, WORKPOOL_LINELEN, WORKPOOL_TITLE_FMT, WORKPOOL_TITLE);
+	copysize = procfs_memcpy(attr->line, linesize, buffer, buflen - totalsize, &offset);
+	totalsize += copysize;
+	buffer += copysize;
+
+	if (totalsize >= buflen) {
+		goto end;
+	}
+
+	linesize = snprintf(attr->line, WORKPOOL_LINELEN, WORKPOOL_LINE);
+	copysize = procfs_memcpy(attr->line, linesize, buffer, buflen - totalsize, &offset);
+	totalsize += copysize;
+	buffer += copysize;
+
+	if (totalsize >= buflen) {
+		goto end;
+	}
+
+	for (i = 0; i < CONFIG_SCHED_WORKPOOL_NSTATS; i++) {
+		/* Take a consistent copy, the workers update the entries */
+
+		flags = irqsave();
+		stats = g_workstats[i];
+		irqrestore(flags);
+
+		if (stats.count == 0) {
+			continue;
+		}
+
+		if (stats.worker) {
+			snprintf(name, sizeof(name), "%p", stats.worker);
+		} else {
+			strncpy(name, "others", sizeof(name));
+		}
+
+		linesize = snprintf(attr->line, WORKPOOL_LINELEN, WORKPOOL_FMT, name, (unsigned long)stats.count,
+						(unsigned long)(stats.latency / stats.count), (unsigned long)stats.maxlatency,
+						(unsigned long)(stats.run / stats.count), (unsigned long)stats.maxrun);
+		copysize = procfs_memcpy(attr->line, linesize, buffer, buflen - totalsize, &offset);
+		totalsize += copysize;
+		buffer += copysize;
+
+		if (totalsize >= buflen) {
+			goto end;
+		}
+	}
+
+end:
+	/* Update the file position */
+
+	if (totalsize > 0) {
+		filep->f_pos += totalsize;
+	}
+
+	return totalsize;
+}
+
+/****************************************************************************
+ * Name: workpool_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int workpool_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+	FAR struct workpool_file_s *oldattr;
+	FAR struct workpool_file_s *newattr;
+
+	fvdbg("Dup %p->%p\n", oldp, newp);
+
+	/* Recover our private data from the old struct file instance */
+
+	oldattr = (FAR struct workpool_file_s *)oldp->f_priv;
+	DEBUGASSERT(oldattr);
+
+	/* Allocate a new container to hold the task and attribute selection */
+
+	newattr = (FAR struct workpool_file_s *)kmm_malloc(sizeof(struct workpool_file_s));
+	if (!newattr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* The copy the file attributes from the old attributes to the new */
+
+	memcpy(newattr, oldattr, sizeof(struct workpool_file_s));
+
+	/* Save the new attributes in the new file structure */
+
+	newp->f_priv = (FAR void *)newattr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: workpool_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int workpool_stat(const char *relpath, struct stat *buf)
+{
+	/* "workpool" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "workpool") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* "workpool" is the name for a read-only file */
+
+	buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+	buf->st_size = 0;
+	buf->st_blksize = 0;
+	buf->st_blocks = 0;
+	return OK;
+}
+
+#endif							/* CONFIG_SCHED_WORKPOOL_STATS && !CONFIG_FS_PROCFS_EXCLUDE_WORKPOOL */
+#endif							/* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
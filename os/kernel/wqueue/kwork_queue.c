@@ -215,6 +215,9 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker, FAR void *arg,
 #endif
 #ifdef CONFIG_SCHED_LPWORK
 		if (qid == LPWORK) {
+#ifdef CONFIG_SCHED_WORKPOOL
+			return work_poolqueue(work, worker, arg, delay);
+#else
 			/* Cancel low priority work */
 
 			result = work_qqueue((FAR struct kwork_wqueue_s *)&g_lpwork, work, worker, arg, delay);
@@ -222,6 +225,7 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker, FAR void *arg,
 				return result;
 			}
 			return work_signal(LPWORK);
+#endif
 		} else
 #endif
 		{
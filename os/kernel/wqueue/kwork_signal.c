@@ -98,6 +98,9 @@ int work_signal(int qid)
 #endif
 #ifdef CONFIG_SCHED_LPWORK
 		if (qid == LPWORK) {
+#ifdef CONFIG_SCHED_WORKPOOL
+			return work_poolsignal();
+#else
 			int wndx;
 			int i;
 
@@ -119,6 +122,7 @@ int work_signal(int qid)
 			 */
 
 			pid = g_lpwork.worker[wndx].pid;
+#endif
 		} else
 #endif
 		{
@@ -60,9 +60,12 @@
 #include <tinyara/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <stdbool.h>
 #include <queue.h>
 
+#include <tinyara/wqueue.h>
+
 #ifdef CONFIG_SCHED_WORKQUEUE
 
 /****************************************************************************
@@ -108,7 +111,7 @@ struct hp_wqueue_s {
  * structure must be cast compatible with kwork_wqueue_s
  */
 
-#ifdef CONFIG_SCHED_LPWORK
+#if defined(CONFIG_SCHED_LPWORK) && !defined(CONFIG_SCHED_WORKPOOL)
 struct lp_wqueue_s {
 	uint32_t delay;				/* Delay between polling cycles (ticks) */
 	struct dq_queue_s q;		/* The queue of pending work */
@@ -129,12 +132,30 @@ struct lp_wqueue_s {
 extern struct hp_wqueue_s g_hpwork;
 #endif
 
-#ifdef CONFIG_SCHED_LPWORK
+#if defined(CONFIG_SCHED_LPWORK) && !defined(CONFIG_SCHED_WORKPOOL)
 /* The state of the kernel mode, low priority work queue(s). */
 
 extern struct lp_wqueue_s g_lpwork;
 #endif
 
+#ifdef CONFIG_SCHED_WORKPOOL_STATS
+/* The statistics of the work of the pool, for each worker callback.  The
+ * last entry counts the work of all the callbacks which didn't find one,
+ * its worker is then NULL.  An entry is unused while its count is zero.
+ */
+
+struct work_stats_s {
+	worker_t worker;			/* The worker callback */
+	uint32_t count;				/* Number of times it ran */
+	uint32_t maxlatency;		/* Longest wait from ready to run (usec) */
+	uint32_t maxrun;			/* Longest run (usec) */
+	uint64_t latency;			/* Total of the waits (usec) */
+	uint64_t run;				/* Total of the runs (usec) */
+};
+
+extern struct work_stats_s g_workstats[CONFIG_SCHED_WORKPOOL_NSTATS];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -198,5 +219,20 @@ int work_lpstart(void);
 
 void work_process(FAR struct kwork_wqueue_s *wqueue, uint32_t period, int wndx);
 
+/****************************************************************************
+ * Name: work_poolqueue, work_poolcancel and work_poolsignal
+ *
+ * Description:
+ *   work_queue(), work_cancel() and work_signal() of LPWORK with
+ *   CONFIG_SCHED_WORKPOOL.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKPOOL
+int work_poolqueue(FAR struct work_s *work, worker_t worker, FAR void *arg, uint32_t delay);
+int work_poolcancel(FAR struct work_s *work);
+int work_poolsignal(void);
+#endif
+
 #endif							/* CONFIG_SCHED_WORKQUEUE */
 #endif							/* __SCHED_WQUEUE_WQUEUE_H */
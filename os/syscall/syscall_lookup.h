@@ -220,6 +220,10 @@ SYSCALL_LOOKUP(seekdir,                 2, STUB_seekdir)
 SYSCALL_LOOKUP(stat,                    2, STUB_stat)
 SYSCALL_LOOKUP(statfs,                  2, STUB_statfs)
 SYSCALL_LOOKUP(telldir,                 1, STUB_telldir)
+#  ifdef CONFIG_EVENT_FD
+SYSCALL_LOOKUP(eventfd,                 2, STUB_eventfd)
+SYSCALL_LOOKUP(mkeventfd,               2, STUB_mkeventfd)
+#  endif
 
 #  if CONFIG_NFILE_STREAMS > 0
 SYSCALL_LOOKUP(fdopen,                  3, STUB_fs_fdopen)
@@ -295,6 +299,10 @@ SYSCALL_LOOKUP(mq_setattr,              3, STUB_mq_setattr)
 SYSCALL_LOOKUP(mq_timedreceive,         5, STUB_mq_timedreceive)
 SYSCALL_LOOKUP(mq_timedsend,            5, STUB_mq_timedsend)
 SYSCALL_LOOKUP(mq_unlink,               1, STUB_mq_unlink)
+#ifdef CONFIG_MQ_ZEROCOPY
+SYSCALL_LOOKUP(mq_receivebuf,           3, STUB_mq_receivebuf)
+SYSCALL_LOOKUP(mq_sendbuf,              4, STUB_mq_sendbuf)
+#endif
 #endif
 
 /* The following are defined only if environment variables are supported */
@@ -327,9 +335,11 @@ SYSCALL_LOOKUP(shutdown,                2, STUB_shutdown)
 SYSCALL_LOOKUP(socket,                  3, STUB_socket)
 #endif
 
-/* The following is defined only if CONFIG_TASK_NAME_SIZE > 0 */
+/* The following is defined only if CONFIG_TASK_NAME_SIZE > 0 or
+ * CONFIG_PTHREAD_MUTEX_FASTPATH is enabled
+ */
 
-#if CONFIG_TASK_NAME_SIZE > 0
+#if CONFIG_TASK_NAME_SIZE > 0 || defined(CONFIG_PTHREAD_MUTEX_FASTPATH)
 SYSCALL_LOOKUP(prctl,                   5, STUB_prctl)
 #endif
 
@@ -353,7 +353,9 @@ uintptr_t STUB_shutdown(int nbr, uintptr_t parm1, uintptr_t parm2);
 uintptr_t STUB_socket(int nbr, uintptr_t parm1, uintptr_t parm2,
 					  uintptr_t parm3);
 
-/* The following is defined only if CONFIG_TASK_NAME_SIZE > 0 */
+/* The following is defined only if CONFIG_TASK_NAME_SIZE > 0 or
+ * CONFIG_PTHREAD_MUTEX_FASTPATH is enabled
+ */
 
 uintptr_t STUB_prctl(int nbr, uintptr_t parm1, uintptr_t parm2,
 					 uintptr_t parm3, uintptr_t parm4, uintptr_t parm5);